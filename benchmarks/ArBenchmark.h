@@ -0,0 +1,176 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARBENCHMARK_H
+#define ARBENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+  Small harness for the programs in benchmarks/.
+
+  Each call to run() times a function: it finds how many calls take at
+  least the minimum sample time, then takes several samples of that many
+  calls and reports the time per operation (the function says how many
+  operations one call does).  Results are printed to stdout as one JSON
+  object per program when the ArBenchmark is destroyed, progress goes to
+  stderr.  "make runBenchmarks" collects them into benchmarks/results.json.
+
+  Command line arguments:
+    -samples N   samples per benchmark (default 7)
+    -minMSecs N  minimum time for one sample (default 20)
+    -quick       1 sample of at least 1 ms, to check that everything runs
+    -filter S    only run benchmarks whose name contains S
+*/
+class ArBenchmark
+{
+public:
+  ArBenchmark(const char *suite, int argc, char **argv) :
+    mySuite(suite), myNumSamples(7), myMinSampleNSecs(20000000LL), mySink(0)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      if (strcmp(argv[i], "-samples") == 0 && i + 1 < argc)
+        myNumSamples = std::max(1, atoi(argv[++i]));
+      else if (strcmp(argv[i], "-minMSecs") == 0 && i + 1 < argc)
+        myMinSampleNSecs = 1000000LL * std::max(0, atoi(argv[++i]));
+      else if (strcmp(argv[i], "-quick") == 0)
+      {
+        myNumSamples = 1;
+        myMinSampleNSecs = 1000000LL;
+      }
+      else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc)
+        myFilter = argv[++i];
+      else
+        myArgs.push_back(argv[i]);
+    }
+  }
+
+  ~ArBenchmark()
+  {
+    printf("{\"suite\": \"%s\", \"samples\": %d, \"minSampleMSecs\": %g, \"results\": [",
+           mySuite.c_str(), myNumSamples, (double)myMinSampleNSecs / 1e6);
+    for (size_t i = 0; i < myResults.size(); i++)
+    {
+      const Result &r = myResults[i];
+      printf("%s\n  {\"name\": \"%s\", \"unit\": \"ns/op\", \"opsPerCall\": %lu, \"calls\": %llu, \"median\": %.3f, \"min\": %.3f, \"mean\": %.3f, \"max\": %.3f}",
+             i == 0 ? "" : ",", r.name.c_str(), (unsigned long)r.opsPerCall,
+             r.calls, r.median, r.min, r.mean, r.max);
+    }
+    // (a string, since the sum of everything kept can overflow to inf or
+    // become nan, which JSON can't hold as a number)
+    printf("\n], \"checksum\": \"%g\"}\n", mySink);
+    fflush(stdout);
+  }
+
+  /// Arguments other than the ones above, for the program's own use
+  const std::vector<const char *> &getArgs() const { return myArgs; }
+
+  /// Use a result so the compiler can't leave out the work that made it
+  void keep(double value) { mySink += value; }
+
+  /** Time @a func, which does @a opsPerCall operations each call.  @a name
+      should be unique within the program. */
+  template <class Func>
+  void run(const char *name, size_t opsPerCall, Func func)
+  {
+    if (!myFilter.empty() && strstr(name, myFilter.c_str()) == NULL)
+      return;
+
+    // find how many calls make a long enough sample
+    unsigned long long calls = 1;
+    long long nsecs;
+    while (true)
+    {
+      nsecs = timeCalls(calls, func);
+      if (nsecs >= myMinSampleNSecs || calls >= (1ULL << 40))
+        break;
+      if (nsecs <= 0)
+        calls *= 100;
+      else
+        calls = std::max(calls * 2, (unsigned long long)(
+              (double)calls * 1.2 * (double)myMinSampleNSecs / (double)nsecs));
+    }
+
+    std::vector<double> perOp;
+    for (int s = 0; s < myNumSamples; s++)
+      perOp.push_back((double)timeCalls(calls, func) /
+                      ((double)calls * (double)opsPerCall));
+    std::sort(perOp.begin(), perOp.end());
+    Result r;
+    r.name = name;
+    r.opsPerCall = opsPerCall;
+    r.calls = calls;
+    r.min = perOp.front();
+    r.max = perOp.back();
+    r.median = perOp.size() % 2 ? perOp[perOp.size() / 2] :
+      (perOp[perOp.size() / 2 - 1] + perOp[perOp.size() / 2]) / 2;
+    r.mean = 0;
+    for (size_t i = 0; i < perOp.size(); i++)
+      r.mean += perOp[i] / (double)perOp.size();
+    myResults.push_back(r);
+    fprintf(stderr, "%-48s %14.1f ns/op\n", (mySuite + "/" + name).c_str(), r.median);
+  }
+
+  /// Report a benchmark that couldn't run (e.g. missing data file), it's left out of the results
+  void skip(const char *name, const char *why)
+  {
+    fprintf(stderr, "%-48s skipped: %s\n", (mySuite + "/" + name).c_str(), why);
+  }
+
+protected:
+  template <class Func>
+  long long timeCalls(unsigned long long calls, Func &func)
+  {
+    const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    for (unsigned long long c = 0; c < calls; c++)
+      func();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  }
+
+  struct Result
+  {
+    std::string name;
+    size_t opsPerCall;
+    unsigned long long calls;
+    double median, min, mean, max;
+  };
+
+  std::string mySuite;
+  int myNumSamples;
+  long long myMinSampleNSecs;
+  std::string myFilter;
+  std::vector<const char *> myArgs;
+  std::vector<Result> myResults;
+  double mySink;
+};
+
+#endif // ARBENCHMARK_H
@@ -0,0 +1,96 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArPriorityResolver.h"
+#include "Aria/ArAction.h"
+#include "Aria/ArActionDesired.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdio.h>
+#include <vector>
+
+/*
+  ArPriorityResolver::resolve() without a robot: a typical set of
+  actions (avoidance and limiters at high priority, goals at low
+  priority, some at the same priority so they're averaged), and a large
+  set.  One operation is one resolve().
+*/
+
+class BenchAction : public ArAction
+{
+public:
+  BenchAction(const char *name, int n) : ArAction(name), myN(n) {}
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override
+  {
+    myDesired.reset();
+    // a limiter, a velocity, a heading or nothing
+    switch (myN % 4)
+    {
+    case 0:
+      myDesired.setMaxVel(300 + myN);
+      myDesired.setMaxRotVel(50);
+      break;
+    case 1:
+      myDesired.setVel(100 + myN + currentDesired.getVel() / 10, .5);
+      break;
+    case 2:
+      myDesired.setDeltaHeading(myN % 30 - 15, .5);
+      break;
+    default:
+      return NULL;
+    }
+    return &myDesired;
+  }
+  int myN;
+  ArActionDesired myDesired;
+};
+
+void runResolver(ArBenchmark &bench, const char *name, int numActions)
+{
+  std::vector<BenchAction *> actions;
+  ArResolver::ActionMap map;
+  char actionName[32];
+  for (int i = 0; i < numActions; i++)
+  {
+    snprintf(actionName, sizeof(actionName), "action%d", i);
+    actions.push_back(new BenchAction(actionName, i));
+    // pairs of actions share a priority
+    map.insert(ArResolver::ActionMap::value_type{100 - i / 2, actions.back()});
+  }
+  ArPriorityResolver resolver;
+  bench.run(name, 1, [&] {
+    ArActionDesired *desired = resolver.resolve(&map, NULL);
+    bench.keep(desired != NULL ? desired->getVel() : 0);
+  });
+  for (size_t i = 0; i < actions.size(); i++)
+    delete actions[i];
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("actionResolver", argc, argv);
+  runResolver(bench, "resolve/8actions", 8);
+  runResolver(bench, "resolve/64actions", 64);
+  return 0;
+}
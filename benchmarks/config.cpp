@@ -0,0 +1,124 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArConfig.h"
+#include "Aria/ArConfigArg.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+  ArConfig with a large config (3000 integer parameters in 60 sections,
+  like a fleet configuration): adding the parameters, parsing (and
+  applying) a file that sets all of them, and looking each one up by
+  section and name.  One operation is one parameter.  The config files
+  are written to the current directory and removed afterwards.
+*/
+
+static const int numParams = 3000;
+static const int perSection = 50;
+
+static void addParams(ArConfig &config, std::vector<int> &values)
+{
+  char sectionName[64];
+  char paramName[64];
+  for (int i = 0; i < numParams; ++i)
+  {
+    snprintf(sectionName, sizeof(sectionName), "Section%d", i / perSection);
+    snprintf(paramName, sizeof(paramName), "Param%dValue", i);
+    config.addParam(ArConfigArg(paramName, &values[(size_t)i], "a parameter"),
+                    sectionName);
+  }
+}
+
+static bool writeFile(const char *fileName, int offset)
+{
+  FILE *fp = ArUtil::fopen(fileName, "w");
+  if (fp == NULL)
+    return false;
+  for (int i = 0; i < numParams; ++i)
+  {
+    if (i % perSection == 0)
+      fprintf(fp, "Section Section%d\n", i / perSection);
+    fprintf(fp, "Param%dValue %d\n", i, i + offset);
+  }
+  fclose(fp);
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("config", argc, argv);
+  std::vector<int> values((size_t)numParams, 0);
+
+  bench.run("addParam", (size_t)numParams, [&] {
+    ArConfig config("./", false, false, false, false);
+    addParams(config, values);
+    bench.keep((double)config.getSections()->size());
+  });
+
+  ArConfig config("./", false, false, false, false);
+  addParams(config, values);
+
+  // every value changes from one file to the other, so alternating
+  // between them applies everything each time
+  const char *files[] = { "configBenchmark0.txt", "configBenchmark1.txt" };
+  if (!writeFile(files[0], 0) || !writeFile(files[1], 1))
+    bench.skip("parseFile", "could not write config files");
+  else
+  {
+    int f = 0;
+    bench.run("parseFile", (size_t)numParams, [&] {
+      bench.keep(config.parseFile(files[f], true, true) ? 1 : 0);
+      f = 1 - f;
+    });
+  }
+  remove(files[0]);
+  remove(files[1]);
+
+  // lookups are case insensitive, so do them in lower case
+  std::vector<std::string> sectionNames, paramNames;
+  char name[64];
+  for (int i = 0; i < numParams; ++i)
+  {
+    snprintf(name, sizeof(name), "section%d", i / perSection);
+    sectionNames.push_back(name);
+    snprintf(name, sizeof(name), "param%dvalue", i);
+    paramNames.push_back(name);
+  }
+  bench.run("findParam", (size_t)numParams, [&] {
+    int found = 0;
+    for (size_t i = 0; i < (size_t)numParams; ++i)
+    {
+      ArConfigSection *section = config.findSection(sectionNames[i].c_str());
+      if (section != NULL && section->findParam(paramNames[i].c_str()) != NULL)
+        ++found;
+    }
+    bench.keep(found);
+  });
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArFileParser.h"
+#include "Aria/ArArgumentBuilder.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <algorithm>
+#include <dirent.h>
+#include <set>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+  ArFileParser: parsing robot parameter files (../params/p3dx-sh.p and
+  ../params/pioneer-lx.p, from disk each time), every parameter file in
+  ../params with a handler for every keyword used in them (like ArConfig
+  has) both by file name (block reads) and through an open FILE (line by
+  line with fgets), and single lines (without file access).  One
+  operation is one line.
+*/
+
+static unsigned long lines = 0;
+static std::set<std::string> allKeywords;
+
+static bool handleLine(ArArgumentBuilder *builder)
+{
+  ++lines;
+  return builder->getArgc() < 1000;
+}
+
+static bool collectKeyword(ArArgumentBuilder *builder)
+{
+  if (builder->getArgc() > 0)
+  {
+    std::string keyword = builder->getArg(0);
+    std::transform(keyword.begin(), keyword.end(), keyword.begin(), ::tolower);
+    allKeywords.insert(keyword);
+  }
+  return true;
+}
+
+static void runAllParams(ArBenchmark &bench, const std::string &dir)
+{
+  std::vector<std::string> files;
+  DIR *d = opendir(dir.c_str());
+  if (d == NULL)
+  {
+    bench.skip("parseFile/allParams", "could not open params directory");
+    return;
+  }
+  struct dirent *ent;
+  while ((ent = readdir(d)) != NULL)
+  {
+    std::string name = ent->d_name;
+    if (name.size() > 2 && name.compare(name.size() - 2, 2, ".p") == 0)
+      files.push_back(dir + "/" + name);
+  }
+  closedir(d);
+  std::sort(files.begin(), files.end());
+
+  // find every keyword used so the parser gets as many handlers as a
+  // config would have
+  ArGlobalRetFunctor1<bool, ArArgumentBuilder *> collector(&collectKeyword);
+  ArFileParser collectParser("");
+  collectParser.setQuiet(true);
+  collectParser.addHandler(NULL, &collector);
+  for (size_t i = 0; i < files.size(); ++i)
+    collectParser.parseFile(files[i].c_str());
+
+  ArGlobalRetFunctor1<bool, ArArgumentBuilder *> handler(&handleLine);
+  ArFileParser parser("");
+  parser.setQuiet(true);
+  for (std::set<std::string>::const_iterator it = allKeywords.begin(); it != allKeywords.end(); ++it)
+    parser.addHandler(it->c_str(), &handler);
+  // sections and unknown lines
+  parser.addHandler(NULL, &handler);
+
+  lines = 0;
+  for (size_t i = 0; i < files.size(); ++i)
+    parser.parseFile(files[i].c_str());
+  if (lines == 0)
+  {
+    bench.skip("parseFile/allParams", "no parameter files");
+    return;
+  }
+  const size_t numLines = lines;
+
+  bench.run("parseFile/allParams", numLines, [&] {
+    for (size_t i = 0; i < files.size(); ++i)
+      bench.keep(parser.parseFile(files[i].c_str()) ? 1 : 0);
+  });
+
+  char buffer[10000];
+  bench.run("parseFILE/allParams", numLines, [&] {
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+      FILE *fp = ArUtil::fopen(files[i].c_str(), "r");
+      if (fp == NULL)
+        continue;
+      bench.keep(parser.parseFile(fp, buffer, sizeof(buffer)) ? 1 : 0);
+      fclose(fp);
+    }
+  });
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("fileParser", argc, argv);
+
+  ArGlobalRetFunctor1<bool, ArArgumentBuilder *> handler(&handleLine);
+  ArFileParser parser("");
+  parser.setQuiet(true);
+  const char *keywords[] = { "Class", "Subclass", "RobotRadius", "RobotWidth",
+    "RobotLength", "AbsoluteMaxTransVel", "AbsoluteMaxRotVel", "SonarUnit",
+    "LaserAutoConnect", "LaserType", "LaserPortType", "LaserPort" };
+  for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+    parser.addHandler(keywords[i], &handler);
+  // sections and everything else
+  parser.addHandler(NULL, &handler);
+
+  const char *files[] = { "../params/p3dx-sh.p", "../params/pioneer-lx.p" };
+  for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); f++)
+  {
+    lines = 0;
+    if (!parser.parseFile(files[f]) || lines == 0)
+    {
+      bench.skip(files[f], "could not parse file");
+      continue;
+    }
+    const size_t numLines = lines;
+    std::string name = std::string("parseFile/") + (strrchr(files[f], '/') + 1);
+    bench.run(name.c_str(), numLines, [&] {
+      bench.keep(parser.parseFile(files[f]) ? 1 : 0);
+    });
+  }
+
+  runAllParams(bench, "../params");
+
+  const char *sample[] = {
+    "RobotRadius 250 ; radius in mm",
+    "SonarUnit 0 69 136 90 ; sonar 0",
+    "LaserType lms2xx",
+    "Section Laser parameters",
+    "SomethingElse with several words of arguments 1 2 3 4"
+  };
+  const size_t numSample = sizeof(sample) / sizeof(sample[0]);
+  char line[256];
+  bench.run("parseLine", numSample, [&] {
+    for (size_t i = 0; i < numSample; i++)
+    {
+      strncpy(line, sample[i], sizeof(line) - 1);
+      line[sizeof(line) - 1] = '\0';
+      bench.keep(parser.parseLine(line) ? 1 : 0);
+    }
+  });
+  return 0;
+}
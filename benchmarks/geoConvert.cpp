@@ -0,0 +1,92 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArGPSCoords.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Converting points (like a georeferenced map or a long GPS track)
+  between LLA and map coordinates, one point at a time through
+  ArLLACoords, ArECEFCoords and ArENUCoords (what ArMapGPSCoords used to
+  do) against the ArMapGPSCoords array conversions.  One operation is
+  one point.
+*/
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("geoConvert", argc, argv);
+  const size_t num = 10000;
+
+  ArLLACoords origin(42.805464, -71.574738, 64.0);
+  ArMapGPSCoords coords(origin);
+  std::vector<double> lat(num), lon(num), alt(num);
+  std::vector<double> ea(num), no(num), up(num);
+  std::vector<double> lat2(num), lon2(num), alt2(num);
+
+  srand(42);
+  for (size_t i = 0; i < num; i++)
+  {
+    lat[i] = origin.getLatitude() + 0.1 * (rand() / (double)RAND_MAX - 0.5);
+    lon[i] = origin.getLongitude() + 0.1 * (rand() / (double)RAND_MAX - 0.5);
+    alt[i] = origin.getAltitude() + 50 * (rand() / (double)RAND_MAX - 0.5);
+  }
+
+  bench.run("LLA2Map/perPoint", num, [&] {
+    for (size_t i = 0; i < num; i++)
+    {
+      const ArENUCoords enu = ArLLACoords(lat[i], lon[i], alt[i]).LLA2ECEF().
+        ECEF2ENU(origin.LLA2ECEF());
+      ea[i] = enu.getEast();
+      no[i] = enu.getNorth();
+      up[i] = enu.getUp();
+    }
+    bench.keep(ea[0]);
+  });
+  bench.run("LLA2Map/arrays", num, [&] {
+    coords.convertLLA2MapCoords(&lat[0], &lon[0], &alt[0],
+                                &ea[0], &no[0], &up[0], num);
+    bench.keep(ea[0]);
+  });
+
+  bench.run("map2LLA/perPoint", num, [&] {
+    for (size_t i = 0; i < num; i++)
+    {
+      const ArLLACoords lla = ArENUCoords(ea[i], no[i], up[i]).
+        ENU2ECEF(origin).ECEF2LLA();
+      lat2[i] = lla.getLatitude();
+      lon2[i] = lla.getLongitude();
+      alt2[i] = lla.getAltitude();
+    }
+    bench.keep(lat2[0]);
+  });
+  bench.run("map2LLA/arrays", num, [&] {
+    coords.convertMap2LLACoords(&ea[0], &no[0], &up[0],
+                                &lat2[0], &lon2[0], &alt2[0], num);
+    bench.keep(lat2[0]);
+  });
+  return 0;
+}
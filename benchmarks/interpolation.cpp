@@ -0,0 +1,70 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArInterpolation.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+
+/*
+  ArInterpolation::getPose(): interpolating between readings in a full
+  history of 100 poses 10 ms apart (what lasers do for every scan to
+  find where the robot was), and predicting a little past the newest.
+*/
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("interpolation", argc, argv);
+
+  ArInterpolation interp(100);
+  ArTime base;
+  base.setSec(1000);
+  base.setMSec(0);
+  for (int i = 0; i < 100; i++)
+  {
+    ArTime t = base;
+    t.addMSec(10 * i);
+    interp.addReading(t, ArPose(i * 5.0, i * 2.0, i * 0.5));
+  }
+
+  // times spread through the history, between readings
+  ArTime times[64];
+  for (int i = 0; i < 64; i++)
+  {
+    times[i] = base;
+    times[i].addMSec(5 + (i * 157) % 985);
+  }
+  ArPose pose;
+  bench.run("getPose/interpolate", 64, [&] {
+    for (int i = 0; i < 64; i++)
+      bench.keep(interp.getPose(times[i], &pose) + pose.getX());
+  });
+
+  ArTime ahead = base;
+  ahead.addMSec(995);
+  bench.run("getPose/predict", 1, [&] {
+    bench.keep(interp.getPose(ahead, &pose) + pose.getX());
+  });
+  return 0;
+}
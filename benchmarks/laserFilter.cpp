@@ -0,0 +1,138 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArLaser.h"
+#include "Aria/ArLaserFilter.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  ArLaserFilter with no robot or laser attached, with no filtering (just
+  copying the readings) and with more and more of the filter stages on.
+  Scans are 1081 readings (270 degrees at 0.25 degree increments, like
+  an LMS1xx) of a noisy room with some spikes in it.  Each call gives
+  the laser the next scan and filters it, "setScan" is how long giving
+  it the scan takes on its own.  One operation is one scan.
+*/
+
+// Laser that just hands out whatever scan it was last given
+class BenchLaser : public ArLaser
+{
+public:
+  BenchLaser() : ArLaser(1, "bench", 30000, false, false)
+  {
+    myRawReadings = new std::list<ArSensorReading *>;
+    setCurrentDrawingData(new ArDrawingData("polyDots", ArColor(0, 0, 0), 80, 75), true);
+    setCumulativeDrawingData(new ArDrawingData("polyDots", ArColor(0, 0, 0), 100, 60), true);
+  }
+  virtual bool blockingConnect() override { return true; }
+  virtual bool asyncConnect() override { return true; }
+  virtual bool disconnect() override { return true; }
+  virtual bool isConnected() override { return true; }
+  virtual bool isTryingToConnect() override { return false; }
+  virtual void *runThread(void *) override { return NULL; }
+
+  void setScan(const std::vector<unsigned int> &ranges,
+               const std::vector<int> &intensities)
+  {
+    while (myRawReadings->size() < ranges.size())
+      myRawReadings->push_back(new ArSensorReading);
+    ArTransform trans;
+    ArTime now;
+    std::list<ArSensorReading *>::iterator it = myRawReadings->begin();
+    for (size_t i = 0; i < ranges.size(); i++, it++)
+    {
+      (*it)->resetSensorPosition(0, 0, -135 + 0.25 * (double)i);
+      (*it)->newData(ranges[i], ArPose(), ArPose(), trans, myCounter, now,
+                     false, intensities[i]);
+    }
+    myCounter++;
+  }
+protected:
+  unsigned int myCounter = 1;
+};
+
+// Lets us call processReadings directly instead of from a robot task
+class BenchLaserFilter : public ArLaserFilter
+{
+public:
+  BenchLaserFilter(ArLaser *laser) : ArLaserFilter(laser) {}
+  void process() { processReadings(); }
+};
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("laserFilter", argc, argv);
+
+  srand(1);
+  const size_t numReadings = 1081;
+  std::vector<std::vector<unsigned int> > scans(16);
+  std::vector<int> intensities(numReadings);
+  for (size_t s = 0; s < scans.size(); s++)
+  {
+    scans[s].resize(numReadings);
+    for (size_t i = 0; i < numReadings; i++)
+    {
+      scans[s][i] = (unsigned int)(3000 + 1000 * sin((double)i / 100.0) + rand() % 40);
+      if (rand() % 50 == 0)
+        scans[s][i] = (unsigned int)(rand() % 20000);
+    }
+  }
+  for (size_t i = 0; i < numReadings; i++)
+    intensities[i] = rand() % 256;
+
+  BenchLaser laser;
+  BenchLaserFilter filter(&laser);
+  size_t next = 0;
+  auto filterNext = [&] {
+    laser.setScan(scans[next++ % scans.size()], intensities);
+    filter.process();
+    bench.keep((double)filter.getRawReadings()->size());
+  };
+
+  bench.run("setScan", 1, [&] {
+    laser.setScan(scans[next++ % scans.size()], intensities);
+  });
+
+  bench.run("filter/copyOnly", 1, filterNext);
+
+  filter.setAngleToCheck(1);
+  filter.setAllFactor(1.5);
+  filter.setAnyFactor(1.2);
+  bench.run("filter/neighborFactors", 1, filterNext);
+
+  filter.setAnyMinRange(300);
+  filter.setAnyMinRangeAngles(-90, 90);
+  bench.run("filter/neighborFactorsAndMinRange", 1, filterNext);
+
+  filter.setClampRange(100, 15000);
+  filter.setMedian(2, 500);
+  filter.setMinIntensity(5);
+  bench.run("filter/allStages", 1, filterNext);
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArLMS1XX.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+  ArLMS1XXPacket: reading the hex text fields of SICK LMS1xx/5xx/TiM
+  telegrams.  "testPacket" reads the packet from tests/lms1xxPacket.cpp,
+  "scanPacket" a LMDscandata telegram with 541 readings (an LMS1xx scan
+  at 0.5 degrees) the way ArLMS1XX reads it.
+*/
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("lms1xxPacket", argc, argv);
+  ArLMS1XXPacket packet;
+
+  // same as in tests/lms1xxPacket.cpp
+  char test1[] = "x0 1 2 3 4 5 A B C D E F\003";
+  bench.run("testPacket", 12, [&] {
+    packet.setBuf(test1, 24);
+    packet.setLength(24);
+    packet.setReadLength(1);
+    unsigned long sum = 0;
+    for (int i = 0; i < 3; i++)
+      sum += packet.bufToUByte();
+    for (int i = 0; i < 3; i++)
+      sum += packet.bufToUByte2();
+    for (int i = 0; i < 6; i++)
+      sum += packet.bufToUByte4();
+    bench.keep((double)sum);
+  });
+
+  const int numReadings = 541;
+  std::string scan = "\002sSN LMDscandata 1 1 89A27F 0 0 343 347 27477BA9 "
+    "2747813B 0 0 7 0 0 1388 168 0 1 DIST1 3F800000 00000000 FFF92230 1388 21D";
+  char hex[16];
+  for (int i = 0; i < numReadings; i++)
+  {
+    snprintf(hex, sizeof(hex), " %X", 200 + (i * 37) % 8000);
+    scan += hex;
+  }
+  scan += " 0 0 0 0 0 0\003";
+  std::vector<char> buf(scan.begin(), scan.end());
+  bench.run("scanPacket", numReadings, [&] {
+    packet.setBuf(buf.data(), (uint16_t)buf.size());
+    packet.setLength((uint16_t)buf.size());
+    packet.resetRead();
+    // header fields, in the order ArLMS1XX::sensorInterp() reads them
+    packet.bufToUByte2(); // version
+    packet.bufToUByte2(); // device number
+    packet.bufToUByte4(); // serial number
+    packet.bufToUByte(); // device status
+    packet.bufToUByte();
+    packet.bufToUByte2(); // message counter
+    packet.bufToUByte2(); // scan counter
+    packet.bufToUByte4(); // power up duration
+    packet.bufToUByte4(); // transmission duration
+    for (int i = 0; i < 4; i++)
+      packet.bufToUByte(); // input and output status
+    packet.bufToUByte2(); // reserved
+    packet.bufToUByte4(); // scanning frequency
+    packet.bufToUByte4(); // measurement frequency
+    packet.bufToUByte2(); // number of encoders (0)
+    packet.bufToUByte2(); // number of 16 bit channels (1)
+    char channel[32];
+    packet.bufToStr(channel, sizeof(channel));
+    packet.bufToUByte4(); // scaling factor
+    packet.bufToUByte4(); // scaling offset
+    packet.bufToByte4(); // starting angle
+    packet.bufToUByte2(); // angular step
+    const int n = packet.bufToUByte2();
+    unsigned long sum = 0;
+    for (int i = 0; i < n; i++)
+      sum += packet.bufToUByte2();
+    bench.keep((double)sum);
+  });
+  return 0;
+}
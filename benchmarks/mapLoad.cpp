@@ -0,0 +1,65 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArMap.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+
+/*
+  ArMap::readFile() on the maps in ../maps: a small one, and a large one
+  with many points and lines.  One operation is one point or line read.
+  Give other map files as arguments to read those instead.
+*/
+
+void runMap(ArBenchmark &bench, const char *name, const char *file)
+{
+  ArMap map;
+  map.setIgnoreEmptyFileName(true);
+  if (!map.readFile(file))
+  {
+    bench.skip(name, "could not read map file");
+    return;
+  }
+  const size_t items = map.getNumPoints() + map.getNumLines() + 1;
+  bench.run(name, items, [&] {
+    bench.keep(map.readFile(file) ? (double)map.getNumPoints() : -1.0);
+  });
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("mapLoad", argc, argv);
+  if (bench.getArgs().empty())
+  {
+    runMap(bench, "readFile/triangle", "../maps/triangle.map");
+    runMap(bench, "readFile/columbia", "../maps/columbia.map");
+  }
+  for (size_t i = 0; i < bench.getArgs().size(); i++)
+  {
+    std::string name = std::string("readFile/") + bench.getArgs()[i];
+    runMap(bench, name.c_str(), bench.getArgs()[i]);
+  }
+  return 0;
+}
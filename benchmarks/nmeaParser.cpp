@@ -0,0 +1,122 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArNMEAParser.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+/*
+  ArNMEAParser on a log of NMEA data (nmeaLog.txt, 20 seconds of 20 Hz
+  RTK GGA, RMC, GST and HDT plus GSA, GSV and ZDA once a second, or the
+  file given as an argument), fed to the parser in chunks the size of
+  typical device reads, with the copying Message handlers and the in
+  place ViewMessage handlers.  One operation is one message.
+*/
+
+static const char *ids[] = { "GGA", "RMC", "GST", "HDT", "GSA", "GSV", "ZDA", NULL };
+
+static unsigned long messages = 0;
+static double sum = 0;
+
+// Handlers do about the same (small) amount of work with each kind of message
+static void handleMessage(ArNMEAParser::Message msg)
+{
+  ++messages;
+  if (msg.message->size() > 1)
+    sum += atof((*msg.message)[1].c_str());
+}
+
+static void handleViewMessage(const ArNMEAParser::ViewMessage *msg)
+{
+  ++messages;
+  if (msg->size() > 1)
+    sum += (*msg)[1].toDouble();
+}
+
+static void runParser(ArBenchmark &bench, const char *name,
+                      const std::string &log, size_t chunkSize, bool view)
+{
+  ArNMEAParser parser;
+  ArGlobalFunctor1<ArNMEAParser::Message> handler(&handleMessage);
+  ArGlobalFunctor1<const ArNMEAParser::ViewMessage *> viewHandler(&handleViewMessage);
+  for (int i = 0; ids[i] != NULL; ++i)
+  {
+    if (view)
+      parser.addViewHandler(ids[i], &viewHandler);
+    else
+      parser.addHandler(ids[i], &handler);
+  }
+
+  auto parseLog = [&] {
+    for (size_t i = 0; i < log.size(); i += chunkSize)
+    {
+      const size_t n = (i + chunkSize < log.size()) ? chunkSize : log.size() - i;
+      parser.parse(log.data() + i, n);
+    }
+  };
+  messages = 0;
+  parseLog();
+  if (messages == 0)
+  {
+    bench.skip(name, "no messages in the log");
+    return;
+  }
+  const size_t perLog = messages;
+  bench.run(name, perLog, [&] {
+    parseLog();
+    bench.keep(sum);
+  });
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("nmeaParser", argc, argv);
+  const char *fileName = "nmeaLog.txt";
+  if (!bench.getArgs().empty())
+    fileName = bench.getArgs()[0];
+
+  FILE *fp = ArUtil::fopen(fileName, "rb");
+  if (fp == NULL)
+  {
+    bench.skip("parse", "could not open the NMEA log");
+    return 0;
+  }
+  std::string log;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    log.append(buf, n);
+  fclose(fp);
+
+  runParser(bench, "parse/copying/64", log, 64, false);
+  runParser(bench, "parse/view/64", log, 64, true);
+  runParser(bench, "parse/copying/512", log, 512, false);
+  runParser(bench, "parse/view/512", log, 512, true);
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRangeBuffer.h"
+#include "Aria/ArTransform.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdlib.h>
+#include <vector>
+
+/*
+  ArRangeBuffer: adding readings to a full buffer, an invalidation sweep
+  (what range devices do every cycle to drop readings), redoing the
+  whole buffer, and the closest reading queries used by obstacle
+  avoidance actions, on the buffer, on arrays (for a caller that
+  already has them), and done one ArPose at a time with angles (what
+  they used to do, the "reference" results).
+*/
+
+double refClosestPolar(const std::list<ArPoseWithTime> &buffer,
+                       double startAngle, double endAngle,
+                       const ArPose &startPos, unsigned int maxRange)
+{
+  double closest = 0;
+  bool foundOne = false;
+  double dist;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it)
+  {
+    const double th = ArMath::subAngle(startPos.findAngleTo(*it),
+                                       startPos.getTh());
+    if (ArMath::angleBetween(th, startAngle, endAngle))
+    {
+      dist = it->findDistanceTo(startPos);
+      if (!foundOne || dist < closest)
+      {
+        closest = dist;
+        foundOne = true;
+      }
+    }
+  }
+  if (!foundOne)
+    return maxRange;
+  return closest > maxRange ? maxRange : closest;
+}
+
+double refClosestBox(const std::list<ArPoseWithTime> &buffer,
+                     double x1, double y1, double x2, double y2,
+                     const ArPose &startPos, unsigned int maxRange)
+{
+  double closest = maxRange;
+  ArTransform trans(startPos, ArPose(0, 0, 0));
+  for (auto it = buffer.begin(); it != buffer.end(); ++it)
+  {
+    const ArPoseWithTime pose = trans.doTransform(*it);
+    if (pose.getX() >= x1 && pose.getX() <= x2 &&
+        pose.getY() >= y1 && pose.getY() <= y2)
+    {
+      double dist = pose.findDistanceTo(ArPose(0, 0));
+      if (dist < closest)
+        closest = dist;
+    }
+  }
+  return closest > maxRange ? maxRange : closest;
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("rangeBuffer", argc, argv);
+  const size_t numReadings = 5000;
+
+  srand(42);
+  std::vector<ArPose> points(numReadings);
+  for (size_t i = 0; i < numReadings; i++)
+    points[i].setPose(-10000 + 20000.0 * rand() / RAND_MAX,
+                      -10000 + 20000.0 * rand() / RAND_MAX);
+
+  ArRangeBuffer buffer(numReadings);
+  size_t next = 0;
+  bench.run("addReading", numReadings, [&] {
+    for (size_t i = 0; i < numReadings; i++)
+    {
+      const ArPose &p = points[next++ % numReadings];
+      buffer.addReading(p.getX(), p.getY());
+    }
+  });
+
+  // drop every fourth reading, then put them back so every sweep is the same
+  bench.run("invalidationSweep", numReadings, [&] {
+    buffer.beginInvalidationSweep();
+    size_t i = 0;
+    for (auto it = buffer.getBegin(); it != buffer.getEnd(); ++it, ++i)
+      if (i % 4 == 0)
+        buffer.invalidateReading(it);
+    buffer.endInvalidationSweep();
+    for (i = 0; i < numReadings / 4; i++)
+      buffer.addReading(points[i].getX(), points[i].getY());
+  });
+
+  bench.run("redoBuffer", numReadings, [&] {
+    buffer.beginRedoBuffer();
+    for (size_t i = 0; i < numReadings; i++)
+      buffer.redoReading(points[i].getX(), points[i].getY());
+    buffer.endRedoBuffer();
+  });
+
+  const ArPose robot(1234, -567, 33);
+  int r = 0;
+  bench.run("getClosestPolar", 1, [&] {
+    bench.keep(buffer.getClosestPolar(-45 + r++ % 10, 45, robot, 30000));
+  });
+  bench.run("getClosestBox", 1, [&] {
+    bench.keep(buffer.getClosestBox(0, -300 - r++ % 10, 2000, 300, robot, 30000));
+  });
+
+  std::vector<double> xs, ys;
+  for (auto it = buffer.getBegin(); it != buffer.getEnd(); ++it)
+  {
+    xs.push_back(it->getX());
+    ys.push_back(it->getY());
+  }
+  bench.run("getClosestPolarInArrays", 1, [&] {
+    bench.keep(ArRangeBuffer::getClosestPolarInArrays(
+            xs.data(), ys.data(), xs.size(), -45 + r++ % 10, 45, robot, 30000));
+  });
+  bench.run("getClosestBoxInArrays", 1, [&] {
+    bench.keep(ArRangeBuffer::getClosestBoxInArrays(
+            xs.data(), ys.data(), xs.size(), 0, -300 - r++ % 10, 2000, 300,
+            robot, 30000));
+  });
+
+  bench.run("getClosestPolar/reference", 1, [&] {
+    bench.keep(refClosestPolar(buffer.getBuffer(), -45 + r++ % 10, 45, robot,
+                               30000));
+  });
+  bench.run("getClosestBox/reference", 1, [&] {
+    bench.keep(refClosestBox(buffer.getBuffer(), 0, -300 - r++ % 10, 2000, 300,
+                             robot, 30000));
+  });
+  return 0;
+}
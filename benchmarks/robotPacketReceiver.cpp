@@ -0,0 +1,99 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRobotPacketReceiver.h"
+#include "Aria/ArRobotPacket.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <string.h>
+#include <string>
+
+/*
+  ArRobotPacketReceiver: finding and checking packets in a byte stream
+  like the one from the robot, SIP sized packets with some noise between
+  them.
+*/
+
+/// Plays the same bytes over and over
+class LoopConnection : public ArDeviceConnection
+{
+public:
+  LoopConnection(const std::string &data) : myData(data), myPos(0)
+    { setPortName("loop"); }
+  virtual int read(const char *data, unsigned int size, unsigned int) override
+  {
+    unsigned int n = 0;
+    char *out = const_cast<char *>(data);
+    while (n < size)
+    {
+      const size_t chunk = std::min((size_t)(size - n), myData.size() - myPos);
+      memcpy(out + n, myData.data() + myPos, chunk);
+      n += (unsigned int)chunk;
+      myPos = (myPos + chunk) % myData.size();
+    }
+    return (int)n;
+  }
+  virtual int write(const char *, unsigned int size) override { return (int)size; }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+
+  std::string myData;
+  size_t myPos;
+};
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("robotPacketReceiver", argc, argv);
+
+  // ten packets of the size of a standard SIP, with junk before some of them
+  const int numPackets = 10;
+  std::string stream;
+  for (int p = 0; p < numPackets; p++)
+  {
+    ArRobotPacket packet;
+    packet.setID(0x32);
+    for (int i = 0; i < 40; i++)
+      packet.byte2ToBuf((int16_t)(i * 37 + p));
+    packet.finalizePacket();
+    if (p % 3 == 0)
+      stream += "\x01\x02\x03";
+    stream.append(packet.getBuf(), packet.getLength());
+  }
+
+  LoopConnection conn(stream);
+  ArRobotPacketReceiver receiver(&conn);
+  bench.run("receivePacket", numPackets, [&] {
+    for (int p = 0; p < numPackets; p++)
+    {
+      ArRobotPacket *packet = receiver.receivePacket(0);
+      bench.keep(packet != NULL ? packet->getID() : -1);
+    }
+  });
+  return 0;
+}
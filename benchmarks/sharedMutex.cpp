@@ -0,0 +1,130 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArSharedMutex.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ArThread.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include "ArBenchmark.h"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+  Reading a buffer protected by an ArMutex, against the same buffer
+  protected by an ArSharedMutex, while one writer thread replaces the
+  buffer every couple of milliseconds (like a laser's thread) and other
+  reader threads are reading it too.  One operation is one read (lock,
+  find the closest value, unlock) by the benchmark's thread.  The
+  writer's longest wait for the lock is printed to stderr, to show it
+  isn't starved.
+*/
+
+static const size_t ourBufferSize = 2000;
+
+// Lock and Unlock are what the readers use, the writer always locks
+// exclusively
+template <class Mutex, int (Mutex::*Lock)(), int (Mutex::*Unlock)()>
+void runReaders(ArBenchmark &bench, const char *mutexName, int numReaders)
+{
+  Mutex mutex;
+  std::vector<double> buffer(ourBufferSize, 1.0);
+  std::atomic<bool> stop{false};
+  std::atomic<long long> otherReads{0};
+  double maxWait = 0;
+  std::vector<std::thread> readers;
+
+  // find the closest reading, like currentReadingPolar() would
+  auto read = [&]() {
+    (mutex.*Lock)();
+    double closest = buffer[0];
+    for (size_t j = 1; j < buffer.size(); j++)
+      if (buffer[j] < closest)
+        closest = buffer[j];
+    (mutex.*Unlock)();
+    return closest;
+  };
+
+  // the benchmark's thread is one of the readers
+  for (int i = 1; i < numReaders; i++)
+    readers.push_back(std::thread([&]() {
+          long long myReads = 0;
+          double sum = 0;
+          while (!stop)
+          {
+            sum += read();
+            myReads++;
+          }
+          // (use sum so the search isn't optimized away)
+          otherReads += myReads + (sum < 0 ? 1 : 0);
+        }));
+
+  std::thread writer([&]() {
+      double value = 1;
+      while (!stop)
+      {
+        auto started = std::chrono::steady_clock::now();
+        mutex.lock();
+        const double wait = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - started).count();
+        if (wait > maxWait)
+          maxWait = wait;
+        for (size_t j = 0; j < buffer.size(); j++)
+          buffer[j] = value + (double)(j % 7);
+        value += 1;
+        mutex.unlock();
+        ArUtil::sleep(2);
+      }
+    });
+
+  const std::string name = std::string(mutexName) + "/" +
+    std::to_string(numReaders) + "readers";
+  bench.run(name.c_str(), 1, [&] { bench.keep(read()); });
+
+  stop = true;
+  writer.join();
+  for (size_t i = 0; i < readers.size(); i++)
+    readers[i].join();
+  bench.keep((double)otherReads);
+  fprintf(stderr, "%-48s longest writer wait %.2f ms\n",
+          ("sharedMutex/" + name).c_str(), maxWait);
+}
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArThread::init();
+  ArBenchmark bench("sharedMutex", argc, argv);
+  for (int numReaders = 1; numReaders <= 4; numReaders *= 2)
+  {
+    runReaders<ArMutex, &ArMutex::lock, &ArMutex::unlock>(
+            bench, "ArMutex", numReaders);
+    runReaders<ArSharedMutex, &ArSharedMutex::lockShared,
+               &ArSharedMutex::unlockShared>(bench, "ArSharedMutex", numReaders);
+  }
+  return 0;
+}
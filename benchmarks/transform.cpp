@@ -0,0 +1,91 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArTransform.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include "ArBenchmark.h"
+#include <stdlib.h>
+#include <list>
+#include <vector>
+
+/*
+  ArTransform: one pose at a time, a list of poses, and the array
+  version on a laser scan sized set of points, forward and inverse.
+*/
+
+int main(int argc, char **argv)
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse, "", false, false, false);
+  ArBenchmark bench("transform", argc, argv);
+  const size_t numPoints = 1000;
+
+  srand(42);
+  std::vector<ArPose> poses(numPoints);
+  std::vector<double> xs(numPoints), ys(numPoints);
+  std::vector<double> outXs(numPoints), outYs(numPoints);
+  for (size_t i = 0; i < numPoints; i++)
+  {
+    xs[i] = -10000 + 20000.0 * rand() / RAND_MAX;
+    ys[i] = -10000 + 20000.0 * rand() / RAND_MAX;
+    poses[i].setPose(xs[i], ys[i], 0);
+  }
+  ArTransform trans(ArPose(1234, -567, 33));
+
+  bench.run("doTransform/pose", numPoints, [&] {
+    double sum = 0;
+    for (size_t i = 0; i < numPoints; i++)
+      sum += trans.doTransform(poses[i]).getX();
+    bench.keep(sum);
+  });
+
+  bench.run("doInvTransform/pose", numPoints, [&] {
+    double sum = 0;
+    for (size_t i = 0; i < numPoints; i++)
+      sum += trans.doInvTransform(poses[i]).getX();
+    bench.keep(sum);
+  });
+
+  // the list version changes the poses in place, so go there and back
+  std::vector<ArPose> listPoses(poses);
+  std::list<ArPose *> poseList;
+  for (size_t i = 0; i < numPoints; i++)
+    poseList.push_back(&listPoses[i]);
+  ArTransform back(ArPose(1234, -567, 33), ArPose(0, 0, 0));
+  bench.run("doTransform/list", 2 * numPoints, [&] {
+    trans.doTransform(&poseList);
+    back.doTransform(&poseList);
+    bench.keep(listPoses[0].getX());
+  });
+
+  bench.run("doTransform/arrays", numPoints, [&] {
+    trans.doTransform(xs.data(), ys.data(), outXs.data(), outYs.data(), numPoints);
+    bench.keep(outXs[0]);
+  });
+
+  bench.run("doInvTransform/arrays", numPoints, [&] {
+    trans.doInvTransform(xs.data(), ys.data(), outXs.data(), outYs.data(), numPoints);
+    bench.keep(outXs[0]);
+  });
+  return 0;
+}
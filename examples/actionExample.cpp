@@ -68,7 +68,7 @@ public:
   // destructor. does not need to do anything
   virtual ~ActionGo() {};
   // called by the action resolver to obtain this action's requested behavior
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   // store the robot pointer, and it's ArSonarDevice object, or deactivate this action if there is no sonar.
   virtual void setRobot(ArRobot *robot);
 protected:
@@ -99,7 +99,7 @@ public:
   // destructor, its just empty, we don't need to do anything
   virtual ~ActionTurn() {};
   // fire, this is what the resolver calls to figure out what this action wants
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   // sets the robot pointer, also gets the sonar device, or deactivates this action if there is no sonar.
   virtual void setRobot(ArRobot *robot);
 protected:
@@ -159,7 +159,7 @@ void ActionGo::setRobot(ArRobot *robot)
   the pointer we returned would be invalid after this method
   returned.
 */
-ArActionDesired *ActionGo::fire([[maybe_unused]] ArActionDesired current)
+ArActionDesired *ActionGo::fire([[maybe_unused]] const ArActionDesired &current)
 {
   double range;
   double speed;
@@ -232,7 +232,7 @@ void ActionTurn::setRobot(ArRobot *robot)
 /*
   This is the guts of the Turn action.
 */
-ArActionDesired *ActionTurn::fire([[maybe_unused]] ArActionDesired currentDesired)
+ArActionDesired *ActionTurn::fire([[maybe_unused]] const ArActionDesired &currentDesired)
 {
   double leftRange, rightRange;
   // reset the actionDesired (must be done)
@@ -40,7 +40,7 @@ public:
   // empty destructor
   virtual ~JoydriveAction();
   //the fire which will actually tell the resolver what to do
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   // whether the joystick is initalized or not
   bool joystickInited();
 protected:
@@ -73,7 +73,7 @@ bool JoydriveAction::joystickInited()
 }
 
 // the guts of the thing
-ArActionDesired *JoydriveAction::fire([[maybe_unused]] ArActionDesired currentDesired)
+ArActionDesired *JoydriveAction::fire([[maybe_unused]] const ArActionDesired &currentDesired)
 {
   // print out some info about hte robot
   printf("\rx %6.1f  y %6.1f  tth  %6.1f vel %7.1f mpacs %3d", myRobot->getX(),
@@ -77,7 +77,9 @@ public:
       @param currentDesired this is the  current tentative result, based
       on the resolver's processing of previous, higher-priority actions.
       This is only for the purpose of giving information to the 
-      action, changing it has no effect. You do not need to use this parameter 
+      action, it is passed by const reference so the resolver does not
+      copy it for every action it fires (copy it if you need to modify
+      it). You do not need to use this parameter 
       in your fire() implementation if not needed.
       @return pointer to what this action wants to do, NULL if it wants to do 
       nothing. Common practice is to keep an ArActionDesired
@@ -88,7 +90,7 @@ public:
       Clear your stored ArActionDesired
       before modifying it with ArActionDesired::reset().
   */
-  AREXPORT virtual ArActionDesired *fire(UNUSED ArActionDesired currentDesired) = 0;
+  AREXPORT virtual ArActionDesired *fire(UNUSED const ArActionDesired &currentDesired) = 0;
   /// Sets the robot this action is driving
   AREXPORT virtual void setRobot(ArRobot *robot);
   /// Find the number of arguments this action takes
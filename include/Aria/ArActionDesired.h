@@ -57,7 +57,7 @@ public:
   bool getAllowOverride() const { return myAllowOverride; }
   void reset() 
     { myDesired = 0; myStrength = NO_STRENGTH; myAllowOverride = true; }
-  void merge(ArActionDesiredChannel *desiredChannel)
+  void merge(const ArActionDesiredChannel *desiredChannel)
     {
       double otherStrength = desiredChannel->getStrength();
       double oldStrength = myStrength;
@@ -97,7 +97,7 @@ public:
       myDesiredTotal = myDesired * myStrength;
       myStrengthTotal = myStrength;
     }
-  void addAverage(ArActionDesiredChannel *desiredChannel)
+  void addAverage(const ArActionDesiredChannel *desiredChannel)
     {
       myAllowOverride = myAllowOverride && desiredChannel->getAllowOverride();
       // if we're allowing override then myDesired is just the least
@@ -178,11 +178,13 @@ public:
 
 
 protected:
+  // doubles first then the flags, so each of the channels (and there
+  // are 17 of them in every ArActionDesired) packs without padding
   double myDesired = 0;
   double myStrength = NO_STRENGTH;
-  bool myAllowOverride = true;
   double myDesiredTotal = 0;
   double myStrengthTotal = NO_STRENGTH;
+  bool myAllowOverride = true;
   bool myOverrideDoesLessThan = true;
 };
 
@@ -686,7 +688,7 @@ public:
       for angle is done.
       @param actDesired the actionDesired to merge with this one
   */
-  void merge(ArActionDesired *actDesired)
+  void merge(const ArActionDesired *actDesired)
     {
       if (actDesired == NULL)
 	return;
@@ -757,7 +759,7 @@ public:
      For a description of how to use this, see startAverage.
      @param actDesired the actionDesired to add into the average
   */
-  void addAverage(ArActionDesired *actDesired)
+  void addAverage(const ArActionDesired *actDesired)
     {
       if (actDesired == NULL)
 	return;
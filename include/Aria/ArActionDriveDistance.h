@@ -76,7 +76,7 @@ public:
   double getDeceleration() { return myDeceleration; }
   /// Sets if we're printing or not
   void setPrinting(bool printing) { myPrinting = printing; }
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
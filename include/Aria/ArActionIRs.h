@@ -48,7 +48,7 @@ public:
 		       double backOffSpeed = 100, int backOffTime = 5000,
 		       int turnTime = 3000, bool setMaximums = false);
   //AREXPORT virtual ~ArActionIRs();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual void setRobot(ArRobot *robot) override;
   virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
@@ -56,7 +56,7 @@ public:
 			    bool stopIfNoButtonPressed = true,
 			    bool useOSCalForJoystick = true);
   //AREXPORT virtual ~ArActionJoydrive();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   /// Whether the joystick is initalized or not
   AREXPORT bool joystickInited();
   /// Set Speeds
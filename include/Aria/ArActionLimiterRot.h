@@ -48,7 +48,7 @@ public:
   /// Constructor
   AREXPORT ArActionLimiterRot(const char *name = "limitRot");
   //AREXPORT virtual ~ArActionLimiterRot();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
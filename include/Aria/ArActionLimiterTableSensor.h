@@ -41,7 +41,7 @@ public:
   /// Constructor
   AREXPORT ArActionLimiterTableSensor(const char *name = "TableSensorLimiter");
   //AREXPORT virtual ~ArActionLimiterTableSensor();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -41,7 +41,7 @@ public:
 				      bool overrideFaster = true, 
 				      bool addLatVelIfAvailable = true);
   //AREXPORT virtual ~ArActionMovementParameters();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -38,7 +38,7 @@ public:
   /// Constructor
   AREXPORT ArActionMovementParametersDebugging(const char *name = "MovementParametersDebugging");
   //AREXPORT virtual ~ArActionMovementParametersDebugging();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -106,7 +106,7 @@ public:
 			      double latAtStopped = 0);
   /// Adds to a section in a config
   AREXPORT void addToConfig(ArConfig *config, const char *section);
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
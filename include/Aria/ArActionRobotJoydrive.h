@@ -54,7 +54,7 @@ public:
   AREXPORT ArActionRobotJoydrive(const char * name = "robotJoyDrive", 
 				 bool requireDeadmanPushed = true);
   //AREXPORT virtual ~ArActionRobotJoydrive();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -38,7 +38,7 @@ public:
   /// Constructor
   AREXPORT ArActionStop(const char *name = "stop");
   //AREXPORT virtual ~ArActionStop();
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -166,7 +166,7 @@ public:
   AREXPORT virtual void activate() override;
   AREXPORT virtual void deactivate() override;
   AREXPORT virtual void setRobot(ArRobot *robot) override;
-  AREXPORT virtual ArActionDesired *fire(ArActionDesired currentDesired) override;
+  AREXPORT virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override;
   AREXPORT virtual ArActionDesired *getDesired() override { return &myDesired; }
 #ifndef SWIG
   AREXPORT virtual const ArActionDesired *getDesired() const override 
@@ -177,6 +177,8 @@ public:
   /// Delete a particular arg, you MUST finish adding before you can remove
   AREXPORT void removeArg(size_t which,
 									        bool isRebuildFullString = false);
+  /// Removes all arguments and strings so the builder can be refilled
+  AREXPORT void reset();
   /// Combines quoted arguments into one
   AREXPORT void compressQuoted(bool stripQuotationMarks = false);
 
@@ -234,6 +236,12 @@ protected:
   bool isSpace(char c);
 
   size_t getArgvLen() const { return myArgvLen; }
+  /// Allocates storage for an argument, from the arena if it has room
+  char *allocArg(size_t size);
+  /// Copies an argument into storage from allocArg()
+  char *dupArg(const char *str);
+  /// Releases storage from allocArg() (a no-op for arena storage)
+  void freeArg(char *arg);
   // how many arguments we had originally (so we can delete 'em)
   size_t myOrigArgc;
   // how many arguments we have
@@ -256,6 +264,12 @@ protected:
   bool myIsPreCompressQuotes;
 
   bool myIsQuiet;
+  // block that argument storage is carved from once reset() has been called
+  char *myArena;
+  size_t myArenaSize;
+  size_t myArenaUsed;
+  // how much argument storage has been asked for since the last reset
+  size_t myArenaWanted;
 };
 
 // ----------------------------------------------------------------------------
@@ -31,6 +31,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArArgumentParser.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArRobotConnector.h"
+#include "Aria/ArDeviceConnectGroup.h"
 
 class ArBatteryMTX;
 class ArRobot;
@@ -114,6 +115,15 @@ public:
 
   /// Internal function to replace the battery (only useful between parseArgs and connectBatteries) but not the battery data
   AREXPORT bool replaceBattery(ArBatteryMTX *battery, int batteryNumber);
+
+  /// Gets the group connectBatteries() uses to connect the batteries concurrently
+  /**
+     Use this to set retry and timeout policies for the batteries (by
+     battery number) or to connect them one at a time before
+     connectBatteries(), and afterwards to see which batteries came up
+     and how long it took.
+  */
+  ArDeviceConnectGroup *getConnectGroup() { return &myConnectGroup; }
   
 protected:
 /// Class that holds information about the battery data
@@ -167,6 +177,8 @@ class BatteryData
   AREXPORT void logBatteryOptions(BatteryData *batterydata, bool header = true, bool metaOpts = true) const;
   // Sets the battery parameters
   bool internalConfigureBattery(BatteryData *batteryData);
+  // Connects one battery (run by myConnectGroup)
+  bool internalConnectBattery(BatteryData *batteryData);
 
   std::string myBatteryTypes;
 
@@ -186,6 +198,8 @@ class BatteryData
 
   ArLog::LogLevel myInfoLogLevel;
 
+  ArDeviceConnectGroup myConnectGroup;
+
   ArRetFunctorC<bool, ArBatteryConnector> myParseArgsCB;
   ArConstFunctorC<ArBatteryConnector> myLogOptionsCB;
 };
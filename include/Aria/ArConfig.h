@@ -27,7 +27,10 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArConfigArg.h"
 #include "Aria/ArFileParser.h"
 //#include "Aria/ArHasFileName.h"
+#include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 class ArArgumentBuilder;
 class ArConfigSection;
@@ -251,6 +254,18 @@ public:
   /// Removes a processedFile callback
   AREXPORT void remProcessFileCB(
 	  ArRetFunctor2<bool, char *, size_t> *functor);
+  /// Makes a processFileCB run only when the given section or parameter changed
+  AREXPORT bool addProcessFileCBDependency(ArRetFunctor<bool> *functor,
+                                           const char *sectionName,
+                                           const char *paramName = NULL);
+  /// Makes a processFileCB run only when the given section or parameter changed
+  AREXPORT bool addProcessFileCBDependency(
+	  ArRetFunctor2<bool, char *, size_t> *functor,
+	  const char *sectionName,
+	  const char *paramName = NULL);
+  /// Returns whether a parameter (or any in a section) changed since the processFileCBs last ran
+  AREXPORT bool hasChangedSinceProcessFile(const char *sectionName,
+                                           const char *paramName = NULL) const;
   /// Call the processFileCBs
   AREXPORT bool callProcessFileCallBacks(bool continueOnError,
 					 char *errorBuffer = NULL,
@@ -421,11 +436,13 @@ protected:
     {
       myCallbackWithError = functor;
       myCallback = NULL;
+      myHasBeenCalled = false;
     }
     ProcessFileCBType(ArRetFunctor<bool> *functor)
     {
       myCallbackWithError = NULL;
       myCallback = functor;
+      myHasBeenCalled = false;
     }
     ~ProcessFileCBType() {}
     bool call(char *errorBuffer, size_t errorBufferLen) 
@@ -452,6 +469,11 @@ protected:
       else 
         return false; 
     }
+    /// Section and parameter (empty for any in the section) names this
+    /// callback depends on; if there are none it is always called
+    std::list<std::pair<std::string, std::string> > myDependencies;
+    /// Whether the callback has been called since its dependencies were set
+    bool myHasBeenCalled;
     const char *getName() 
     { 
       if (myCallbackWithError != NULL)
@@ -470,6 +492,12 @@ protected:
   void addParserHandlers();
   void remParserHandlers();
 
+  /// Adds a dependency to a processFileCB (callback may be NULL if it was not found)
+  bool addDependency(ProcessFileCBType *callback, const char *sectionName,
+                     const char *paramName);
+  /// Whether any of the callback's dependencies changed since it was last called
+  bool dependenciesChanged(const ProcessFileCBType *callback) const;
+
   /// Optional name of the robot with which the config is associated.
   std::string myRobotName;
   /// Optional name of the config instance.
@@ -523,6 +551,22 @@ protected:
 
   // our list of sections which has in it the argument list for each
   std::list<ArConfigSection *> mySections;
+  // mySections by lowercased name, caught up lazily by findSection
+  mutable std::unordered_map<std::string, ArConfigSection *> mySectionIndex;
+  // how many of mySections are in the index
+  mutable size_t mySectionIndexCount;
+  // set when sections may have been removed, so the index is rebuilt
+  mutable bool mySectionIndexDirty;
+  // section renames seen when the index was built, so it is rebuilt
+  // after any ArConfigSection::setName()
+  mutable unsigned long mySectionIndexRenames;
+  // findSection is const and may be called from any thread
+  mutable std::mutex mySectionIndexMutex;
+
+  // parameters (and the sections they are in) whose values changed
+  // since the processFileCBs were last called
+  std::set<const ArConfigArg *> myChangedParams;
+  std::set<const ArConfigSection *> myChangedSections;
 
   // callback for the file parser
   ArRetFunctor3C<bool, ArConfig, ArArgumentBuilder *, char *, size_t> myParserCB;
@@ -573,7 +617,9 @@ public:
   const char *getFlags() const { return myFlags->getFullString(); }
   AREXPORT bool hasFlag(const char *flag) const;
   
-  std::list<ArConfigArg> *getParams() { return &myParams; }
+  /// Gets the parameters (use only if you know what to do)
+  std::list<ArConfigArg> *getParams() 
+    { myParamIndexDirty = true; return &myParams; }
   
   AREXPORT void setName(const char *name);
 
@@ -586,6 +632,9 @@ public:
   AREXPORT ArConfigArg *findParam(const char *paramName,
                                   bool isAllowStringHolders = false);
 
+  /// Finds every parameter (including holders) in this section with the given name.  Returns NULL if there are none.
+  AREXPORT const std::vector<ArConfigArg *> *findParams(const char *paramName);
+
   /// Finds a list member parameter with the specified name path.  Returns NULL if not found.
   AREXPORT ArConfigArg *findParam(const std::list<std::string> &paramNamePath,
                                   bool isAllowHolders = false); 
@@ -613,6 +662,9 @@ protected:
   /// Sets the name of the category to which this section belongs.
   void setCategoryName(const char *categoryName);
 
+  /// Brings myParamIndex up to date with myParams
+  void updateParamIndex();
+
 protected:
 
   std::string myName;
@@ -623,6 +675,15 @@ protected:
   std::list<ArConfigArg> myParams;
   bool myIsQuiet;
 
+  // myParams by lowercased name (in the order they were added); the
+  // list never moves its elements so these stay valid until removed
+  std::unordered_map<std::string, std::vector<ArConfigArg *> > myParamIndex;
+  // how many of myParams are in the index
+  size_t myParamIndexCount;
+  // set whenever myParams may have been changed other than by appending
+  bool myParamIndexDirty;
+  std::string myParamIndexKey;
+
 }; // end class ArConfigSection
 
 #endif // ARCONFIG
@@ -139,11 +139,28 @@ public:
     return ArUtil::availableDiskSpaceMB(getLogFileName());
   }
 
+  /// Converts a log written with DataLogFormat Binary into text
+  AREXPORT static bool convertBinaryLog(FILE *in, FILE *out, char sep = ',');
+
+  /// Column types used in the schema blocks of the Binary log format
+  enum BinaryColumnType {
+    BINARY_DOUBLE = 'd', ///< 8 byte IEEE double
+    BINARY_INT32 = 'i', ///< 4 byte signed integer
+    BINARY_UINT8 = 'u', ///< 1 byte unsigned integer
+    BINARY_BITS8 = 'b', ///< 1 byte bit field, converted as 8 0/1 digits
+    BINARY_BITS16 = 'w', ///< 2 byte bit field, converted as 16 0/1 digits
+    BINARY_STRING = 's', ///< fixed length string, nul padded
+    BINARY_COMMAND = 'c' ///< 4 byte command argument, INT32_MIN if not sent
+  };
+
 protected:
   void connectCallback();
   bool processFile(char *errorBuffer, size_t errorBufferLen);
   void writeHeader();
   void userTask();
+  void writeBinaryHeader();
+  void writeBinaryRecord();
+  void flushBinary();
   ArRobot *myRobot;
   ArTime myLastLogged;
   ArConfig *myConfig;
@@ -226,8 +243,15 @@ protected:
   ArFunctorC<ArDataLogger> mySaveCopyFunctor;
 
   std::string myConfigLogFormat;
-  enum { TSV, CSV, Fixed } myLogFormat;
+  enum { TSV, CSV, Fixed, Binary } myLogFormat;
   char myLogSep;
+
+  // records for the Binary format are packed in here and written out
+  // in large blocks by flushBinary()
+  std::vector<unsigned char> myBinaryBuffer;
+  size_t myBinaryRecordSize;
+  int myBinaryNumBatteries;
+  ArTime myBinaryLastFlush;
 };
 
 #endif // ARDATALOGGER_H
@@ -0,0 +1,132 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARDEVICECONNECTGROUP_H
+#define ARDEVICECONNECTGROUP_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArLog.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/// Connects a group of devices at the same time and waits for all of them
+/**
+   ArLaserConnector, ArSonarConnector, ArBatteryConnector and
+   ArLCDConnector use this to connect all of their devices concurrently,
+   so that connecting takes about as long as the slowest device instead
+   of the sum of all of them.  Each connector has one you can get to
+   set up the connection policies before connecting (e.g.
+   ArLaserConnector::getConnectGroup()).
+
+   Each device is added with addDevice() along with a functor that
+   makes one blocking connection attempt.  connectAll() starts a thread
+   for each device, which makes the first attempt and then retries
+   according to the device's ConnectPolicy, and returns once every
+   device has connected or given up.  getResults() (or logResults())
+   then tells which devices came up, how many attempts they took and
+   how long.
+
+   A connection attempt that has started is never abandoned (each
+   device's blockingConnect() already has its own timeouts), the
+   timeout in the ConnectPolicy only stops new retries from being
+   started once it has passed.
+**/
+class ArDeviceConnectGroup
+{
+public:
+  /// How a device's connection is retried
+  struct ConnectPolicy
+  {
+    /// How many more attempts to make after the first one fails
+    int retries = 0;
+    /// How long to wait before each retry, in milliseconds
+    int retryDelayMSecs = 1000;
+    /// Don't start a retry after this many milliseconds (0 for no limit)
+    int timeoutMSecs = 0;
+  };
+  /// What happened when connecting one device
+  struct ConnectResult
+  {
+    /// The name given to addDevice()
+    std::string name;
+    /// The number given to addDevice()
+    int number = 0;
+    /// Whether the device connected
+    bool connected = false;
+    /// Whether retries were stopped by the policy's timeout
+    bool timedOut = false;
+    /// How many connection attempts were made
+    int attempts = 0;
+    /// How long it took to connect or give up, in milliseconds
+    long long mSecs = 0;
+  };
+  /// Constructor
+  AREXPORT ArDeviceConnectGroup(const char *name);
+  /// Destructor
+  AREXPORT ~ArDeviceConnectGroup();
+  ArDeviceConnectGroup(const ArDeviceConnectGroup &) = delete;
+  ArDeviceConnectGroup &operator=(const ArDeviceConnectGroup &) = delete;
+
+  /// Sets whether connectAll() connects the devices concurrently (the default) or one after another
+  void setConcurrent(bool concurrent) { myConcurrent = concurrent; }
+  /// Gets whether connectAll() connects the devices concurrently
+  bool getConcurrent() const { return myConcurrent; }
+  /// Sets the policy used for devices that don't have their own
+  void setDefaultPolicy(const ConnectPolicy &policy) 
+    { myDefaultPolicy = policy; }
+  /// Gets the policy used for devices that don't have their own
+  const ConnectPolicy &getDefaultPolicy() const { return myDefaultPolicy; }
+  /// Sets the policy for the device with this number
+  AREXPORT void setPolicy(int number, const ConnectPolicy &policy);
+  /// Gets the policy for the device with this number
+  AREXPORT const ConnectPolicy &getPolicy(int number) const;
+
+  /// Adds a device to connect, this takes ownership of the functor
+  AREXPORT void addDevice(const char *name, int number, 
+			  ArRetFunctor<bool> *connectFunctor);
+  /// Removes the devices and results (but not the policies)
+  AREXPORT void clear();
+  /// Connects all the devices added, returns true if they all connected
+  AREXPORT bool connectAll();
+  /// Gets the results of the last connectAll(), in the order the devices were added
+  const std::vector<ConnectResult> &getResults() const { return myResults; }
+  /// Gets whether the device with this number connected in the last connectAll()
+  AREXPORT bool wasConnected(int number) const;
+  /// Gets how long the last connectAll() took, in milliseconds
+  long long getElapsedMSecs() const { return myElapsedMSecs; }
+  /// Logs the results of the last connectAll()
+  AREXPORT void logResults(ArLog::LogLevel level = ArLog::Normal) const;
+protected:
+  class Job;
+  std::string myName;
+  bool myConcurrent = true;
+  ConnectPolicy myDefaultPolicy;
+  std::map<int, ConnectPolicy> myPolicies;
+  std::vector<Job *> myJobs;
+  std::vector<ConnectResult> myResults;
+  long long myElapsedMSecs = 0;
+};
+
+#endif // ARDEVICECONNECTGROUP_H
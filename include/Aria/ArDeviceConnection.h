@@ -135,6 +135,14 @@ class ArDeviceConnection
   /// sees if timestamping is really going on or not
   /** @return true if real timestamping is happening, false otherwise */
   AREXPORT virtual bool isTimeStamping() = 0;
+  /// Gets the file descriptor that becomes readable when there is data to read
+  /**
+     This is used by ArDeviceReactor to wait for data on many
+     connections at once.
+     @return the file descriptor, or -1 if the connection isn't open or
+     doesn't have one (the default)
+  */
+  virtual int getFD() const { return -1; }
 
   /// Gets the port name
   AREXPORT const char *getPortName() const;
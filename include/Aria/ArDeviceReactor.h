@@ -0,0 +1,147 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARDEVICEREACTOR_H
+#define ARDEVICEREACTOR_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ArLog.h"
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+class ArDeviceConnection;
+
+/// Waits for data on many device connections at once and calls their callbacks (Linux only)
+/**
+   Normally each device driver runs its own thread which sits in
+   blocking read() calls on its ArDeviceConnection.  On a robot with
+   many devices that is a lot of mostly idle threads.  Instead, drivers
+   (or programs) can add their connections to an ArDeviceReactor, which
+   waits for all of them at once with epoll from one (or a few) worker
+   threads, and when a connection has data calls that connection's
+   callback, which should read what is there without blocking (read()
+   with a wait of 0) and handle whatever it completes.
+
+   The connection must have a file descriptor (see
+   ArDeviceConnection::getFD(), ArSerialConnection and ArTcpConnection
+   do) and must be open when it's added.  A connection's callbacks are
+   never called from two threads at the same time, even with more than
+   one worker thread.  If a connection has an idle timeout its idle
+   callback is called when it hasn't had data for that long, so a
+   driver can notice that its device went quiet.  If a connection hangs
+   up or has an error its callback is called once more (its read() will
+   fail) and then it is no longer watched, remove it and add it again
+   after reopening it.
+
+   Drivers can opt in without changing their public API, for example
+   ArGPS::setReactor(), ArLMS1XX::setReactor() and
+   ArSonarMTX::setReactor().  The lasers and sonar boards then don't
+   need a thread each once they're connected.
+
+   @ingroup UtilityClasses
+*/
+class ArDeviceReactor
+{
+public:
+  /// Statistics for one connection, see getStats()
+  struct ConnectionStats
+  {
+    /// The connection's device name (or port name if it has none)
+    std::string name;
+    /// How many times its callback was called because there was data
+    unsigned long wakeups = 0;
+    /// How long its callback took in total, in microseconds
+    long long callbackUSecs = 0;
+    /// The longest its callback took, in microseconds
+    long long maxCallbackUSecs = 0;
+    /// How many times its idle callback was called
+    unsigned long idleCallbacks = 0;
+    /// Whether it hung up or had an error (and isn't watched anymore)
+    bool hungUp = false;
+  };
+
+  /// Constructor
+  AREXPORT ArDeviceReactor(const char *name = "ArDeviceReactor");
+  /// Destructor, stops the worker threads
+  AREXPORT ~ArDeviceReactor();
+  ArDeviceReactor(const ArDeviceReactor &) = delete;
+  ArDeviceReactor &operator=(const ArDeviceReactor &) = delete;
+
+  /// Starts the worker threads
+  AREXPORT bool start(int numThreads = 1);
+  /// Stops the worker threads (and waits for them)
+  AREXPORT void stop();
+  /// Gets whether the worker threads are running
+  AREXPORT bool isRunning() const;
+
+  /// Adds a connection, calling @a readableCB whenever it has data
+  /**
+     @param conn the connection, which must be open
+     @param readableCB called with @a conn from a worker thread when
+     there is data, this isn't owned by the reactor
+     @param idleTimeoutMSecs if not 0, call @a idleCB when there has been
+     no data for this long (and again each time this much longer passes)
+     @param idleCB the idle callback, this isn't owned by the reactor
+     @return false if the reactor couldn't be set up, the connection
+     has no file descriptor or was already added
+  */
+  AREXPORT bool addConnection(ArDeviceConnection *conn, 
+			      ArFunctor1<ArDeviceConnection *> *readableCB,
+			      unsigned int idleTimeoutMSecs = 0,
+			      ArFunctor1<ArDeviceConnection *> *idleCB = NULL);
+  /// Removes a connection, after this returns its callbacks won't be called
+  /**
+     This may be called from one of the connection's own callbacks.
+  */
+  AREXPORT bool remConnection(ArDeviceConnection *conn);
+  /// Gets how many connections have been added
+  AREXPORT size_t getNumConnections() const;
+  /// Gets the statistics for each connection
+  AREXPORT std::vector<ConnectionStats> getStats() const;
+  /// Logs the statistics for each connection
+  AREXPORT void logStats(ArLog::LogLevel level = ArLog::Normal) const;
+protected:
+  class Entry;
+  class Worker;
+  friend class Worker;
+  bool setup();
+  void dispatch(unsigned long long id, unsigned int events);
+  void checkIdle();
+  void rearm(Entry *entry);
+
+  std::string myName;
+  mutable ArMutex myMutex;
+  ArMutex myIdleCheckMutex;
+  int myEpollFD = -1;
+  int myWakeFD = -1;
+  unsigned long long myNextID = 1;
+  std::map<unsigned long long, Entry *> myEntries;
+  std::vector<Worker *> myWorkers;
+  std::atomic<int> myNumIdleTimeouts{0};
+};
+
+#endif // ARDEVICEREACTOR_H
@@ -0,0 +1,92 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARFASTHASH_H
+#define ARFASTHASH_H
+
+#include "Aria/ariaTypedefs.h"
+#include <stddef.h>
+
+/// Calculates a fast (non-cryptographic) 64 bit hash of file contents
+/**
+ * ArFastHash implements the xxHash64 algorithm.  It is several times
+ * faster than ArMD5Calculator, which makes it a better choice for just
+ * noticing whether a (large) file has changed, but it is not meant to
+ * resist deliberate collisions, and its result is not interchangeable
+ * with an MD5 checksum.  Data can be appended in blocks of any size;
+ * the result only depends on the bytes, not how they were split up.
+ *
+ * @see ArMapId::create()
+ * @ingroup UtilityClasses
+**/
+class ArFastHash {
+
+public:
+
+  enum : size_t {
+    DIGEST_LENGTH = 8U ///< Number of bytes getDigest() fills in
+  };
+
+  /// Calculates the hash of a buffer in one call
+  AREXPORT static unsigned long long hash(const void *data, size_t len,
+                                          unsigned long long seed = 0);
+
+  /// Calculates the hash for the specified file, as DIGEST_LENGTH bytes
+  /**
+   * @return bool true if the file was successfully opened and read
+   * @see getDigest
+  **/
+  AREXPORT static bool calculateChecksum(const char *fileName,
+                                         unsigned char *digestBuffer,
+                                         size_t digestBufferLen);
+
+  /// Creates a new hash with the given seed
+  AREXPORT ArFastHash(unsigned long long seed = 0);
+
+  /// Resets the hash so that a new one can be calculated
+  AREXPORT void reset();
+
+  /// Accumulates a block of data into the hash
+  AREXPORT void append(const void *data, size_t len);
+  /// Accumulates a text string (without its terminating null)
+  AREXPORT void append(const char *str);
+
+  /// Returns the hash of everything appended so far
+  AREXPORT unsigned long long getHash() const;
+  /// Writes the hash as DIGEST_LENGTH bytes, most significant first
+  AREXPORT void getDigest(unsigned char *digestBuffer,
+                          size_t digestBufferLen) const;
+
+private:
+
+  unsigned long long mySeed;
+  /// The four accumulator lanes
+  unsigned long long myAcc[4];
+  /// Bytes that don't yet fill a 32 byte stripe
+  unsigned char myBuffer[32];
+  size_t myBufferLen;
+  unsigned long long myTotalLen;
+
+}; // end class ArFastHash
+
+#endif // ARFASTHASH_H
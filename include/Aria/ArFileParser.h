@@ -27,6 +27,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaTypedefs.h"
 #include "Aria/ArFunctor.h"
 #include "Aria/ariaUtil.h"
+#include <unordered_map>
 
 class ArArgumentBuilder;
 
@@ -209,9 +210,18 @@ protected:
 
   ArFunctor1<const char *> *myPreParseFunctor;
 
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp> myMap;
+  // handlers by lowercased keyword
+  typedef std::unordered_map<std::string, HandlerCBType *> HandlerMap;
+  HandlerMap myMap;
   // handles that NULL case
   HandlerCBType *myRemainderHandler;
+  // builder refilled for each line parsed, and the argvLen it was made with
+  ArArgumentBuilder *myBuilder;
+  size_t myBuilderArgvLen;
+  // how many handlers are being called from parseLine right now
+  int myParseDepth;
+  // scratch for lowercased keyword lookups
+  std::string myKeyword;
   bool myIsQuiet;
   bool myIsPreCompressQuotes;
   bool myIsInterrupted;
@@ -27,16 +27,34 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaTypedefs.h"
 #include "Aria/ArASyncTask.h"
 #include "Aria/ArFunctor.h"
+#include "Aria/ArThreadPool.h"
 
 /// This is like ArASyncTask, but instead of runThread it uses a functor to run
+/**
+   Instead of starting a thread with runAsync() or create(), the functor
+   can be run on an ArThreadPool worker with runInPool().  The functor
+   still sees getRunning() (which goes false when stopRunning() is
+   called, or when the pool is stopped), but it holds a pool worker
+   until it returns, so it should not be a long blocking loop.
+*/
 class ArFunctorASyncTask final: public ArASyncTask
 {
 public:
   /// Constructor
   AREXPORT ArFunctorASyncTask(ArRetFunctor1<void *, void *> *functor);
-  // Destructor
-  //AREXPORT virtual ~ArFunctorASyncTask() = default;
+  /// Destructor, if running in a pool stops the functor and waits for it
+  AREXPORT virtual ~ArFunctorASyncTask();
+  /// Runs the functor (with a NULL argument) on a pool worker
+  /**
+     @param pool the pool to run in, if NULL then ArThreadPool::getShared()
+     @return true if the functor was given to the pool
+  */
+  AREXPORT bool runInPool(ArThreadPool *pool = NULL);
 private:
+  void runPooled();
+  ArThreadPool *myPool;
+  ArThreadPool::TaskId myPoolTask;
+  ArFunctorC<ArFunctorASyncTask> myPoolCB;
   /// Our reimplementation of runThread
   virtual void *runThread(void *arg) override;
   ArRetFunctor1<void *, void *> *myFunc;
@@ -31,11 +31,16 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArMutex.h"
 #include "Aria/ArNMEAParser.h"
 #include "Aria/ArGPSCoords.h"
+#include "Aria/ArSeqLock.h"
 #include <math.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <vector>
 
 class ArDeviceConnection; // for pointer in ArGPS
+class ArDeviceReactor;
 
 /** @brief GPS Device Interface 
  *
@@ -115,7 +120,7 @@ class ArGPS {
 public:
     AREXPORT ArGPS();
 
-    virtual ~ArGPS() = default;
+    AREXPORT virtual ~ArGPS();
 
     /** @brief Set device connection to use */
     void setDeviceConnection(ArDeviceConnection* deviceConn) { myDevice = deviceConn; }
@@ -179,6 +184,20 @@ public:
      * of time if @a maxTime is 0, so watch out for that. */
     int readWithLock(unsigned int maxTime) { lock(); int r = read(maxTime); unlock(); return r; }
 
+    /** @brief Read from the device connection whenever it has data, from
+     *  one of @a reactor's threads, instead of calling read() yourself.
+     *
+     *  The device connection must be set and open.  Each time it has data
+     *  readWithLock() is called from the reactor.  Pass NULL to stop.
+     *  (Not available on Windows.)
+     *
+     *  @return false if the connection couldn't be added to @a reactor
+     */
+    AREXPORT bool setReactor(ArDeviceReactor *reactor);
+
+    /** @brief Get the reactor set with setReactor(), or NULL */
+    ArDeviceReactor *getReactor() const { return myReactor; }
+
     /** Locks a mutex object contained by this class.
      *  No other method (except readWithLock()) in ArGPS locks or unlocks this
      *  mutex, it is provided for you to use when accessing ArGPS from multiple
@@ -471,7 +490,98 @@ public:
       myNMEAParser.addHandler(message, handler); 
     }
 
+    /** Set a handler for an NMEA message which is given the message fields in
+     * place, without copying them. 
+     * @sa ArNMEAParser::addViewHandler
+     * @sa ArNMEAParser::ViewMessage
+     */
+    void addNMEAViewHandler(const char *message, ArNMEAParser::ViewHandler *handler) { myNMEAParser.addViewHandler(message, handler); }
+    void removeNMEAViewHandler(const char *message) { myNMEAParser.removeViewHandler(message); }
+
+    /** @brief The main navigation data from one fix, see getLatestFix().
+     *
+     *  Unlike Data this is a plain copy that doesn't change after you get it.
+     */
+    struct Fix {
+        unsigned long long sequence = 0; ///< 1 for the first fix, one more for each new position after that. 0 if there hasn't been a fix.
+        long long receivedUSecs = 0; ///< When read() finished parsing the fix, in microseconds on a monotonic clock (std::chrono::steady_clock)
+        double latitude = 0.0; ///< Decimal degrees
+        double longitude = 0.0; ///< Decimal degrees
+        double altitude = 0.0; ///< Meters above sea level @see haveAltitude
+        double speed = 0.0; ///< Meters per second @see haveSpeed
+        double HDOP = 0.0; ///< @see haveHDOP
+        double VDOP = 0.0; ///< @see haveVDOP
+        double PDOP = 0.0; ///< @see havePDOP
+        double latitudeError = 0.0; ///< Std. deviation, meters @see haveLatLonError
+        double longitudeError = 0.0; ///< Std. deviation, meters @see haveLatLonError
+        double altitudeError = 0.0; ///< Std. deviation, meters @see haveAltitudeError
+        ArGPS::FixType fixType = NoFix;
+        unsigned short numSatellitesTracked = 0;
+        bool havePosition = false;
+        bool haveAltitude = false;
+        bool haveSpeed = false;
+        bool haveHDOP = false;
+        bool haveVDOP = false;
+        bool havePDOP = false;
+        bool haveLatLonError = false;
+        bool haveAltitudeError = false;
+        bool qualityFlag = false; ///< @see Data::qualityFlag
+    };
+
+    /** @brief Get the most recent fix without locking.
+     *
+     *  read() publishes a copy of the navigation data each time it
+     *  parses a new position (and refreshes it, with the same sequence
+     *  number, when other data such as fix type or DOP arrives), so
+     *  other threads can get a consistent fix at any time without
+     *  calling lock() or waiting for read() to finish.  (The accessors
+     *  like getLatitude() still read the data read() is updating, so
+     *  they need lock() for that.)
+     */
+    AREXPORT ArGPS::Fix getLatestFix() const;
+
+    /** @brief Wait for a fix newer than @a afterSequence.
+     *
+     *  Some other thread must be calling read() (or use setReactor()).
+     *  @param fix set to the new fix, if there is one
+     *  @param afterSequence a Fix::sequence you already have, or 0 for
+     *  any fix
+     *  @param timeoutMSecs how long to wait, 0 to not wait at all
+     *  @return false if there was no newer fix in time
+     */
+    AREXPORT bool waitForNextFix(ArGPS::Fix *fix, unsigned long long afterSequence, unsigned int timeoutMSecs);
+
+    /** @brief Statistics about fixes and parsing, see getFixStats() */
+    struct FixStats {
+        unsigned long long numFixes = 0; ///< New positions published
+        double meanFixIntervalMSecs = 0.0; ///< Mean time between fixes
+        double fixIntervalJitterMSecs = 0.0; ///< Standard deviation of the time between fixes
+        double minFixIntervalMSecs = 0.0; ///< Shortest time between fixes
+        double maxFixIntervalMSecs = 0.0; ///< Longest time between fixes
+        unsigned long numParses = 0; ///< Calls to read() that handled at least one sentence
+        double meanParseUSecs = 0.0; ///< Mean time those calls to read() took
+        long long maxParseUSecs = 0; ///< Longest time one of them took
+        unsigned long numSentences = 0; ///< NMEA sentences found (see ArNMEAParser::Stats)
+        unsigned long numHandledSentences = 0; ///< Sentences that had a handler
+        unsigned long numDroppedSentences = 0; ///< Sentences skipped for a bad checksum, syntax error etc.
+    };
+
+    /** @brief Get statistics about fixes and parsing since the GPS was created or resetFixStats() was called.
+        The sentence counts are as of the end of the last call to read(). */
+    AREXPORT ArGPS::FixStats getFixStats() const;
+    /** @brief Start the statistics over */
+    AREXPORT void resetFixStats();
+    /** @brief Log the statistics from getFixStats() */
+    AREXPORT void logFixStats(ArLog::LogLevel level = ArLog::Normal) const;
+
 protected:
+    /** Publish myData for getLatestFix() and waitForNextFix(), and update the
+        fix statistics.  read() calls this; subclasses that override read()
+        without calling ArGPS::read() should call it after updating myData.
+        @param parseUSecs how long parsing took, or -1 to not count it
+    */
+    AREXPORT void publishFix(long long parseUSecs = -1);
+
     /** Block until data is read from GPS.
         Waits by calling read() every 100 ms for @a timeout ms.
      */
@@ -535,6 +645,11 @@ protected:
     bool myCreatedOwnDeviceCon;
     ArRetFunctorC<bool, ArGPS> myParseArgsCallback; 
     ArArgumentParser* myArgParser;
+
+    /* Reactor reading for us, if any */
+    ArDeviceReactor *myReactor;
+    void reactorReadable(ArDeviceConnection *conn);
+    ArFunctor1C<ArGPS, ArDeviceConnection *> myReactorCB;
     
     /* NMEA Parser */
     ArNMEAParser myNMEAParser;
@@ -582,6 +697,27 @@ protected:
      */
     void parseGPRMC(const ArNMEAParser::Message &msg, double &latitudeResult, double &longitudeResult, bool &qualityFlagResult, bool &gotPosition, ArTime &timeGotPositionResult, ArTime &gpsTimestampResult, bool &gotSpeedResult, double &speedResult);
 
+    /* Latest fix, see getLatestFix() */
+    ArSeqLock<Fix> myLatestFix;
+    /* What the last published fix was made from, to tell a new position from a refresh */
+    Fix myLastFix;
+    ArTime myLastFixTimeGotPosition;
+    ArTime myLastFixGPSTimestamp;
+    /* For waitForNextFix(); publishFix() only takes the mutex when there are waiters */
+    std::mutex myFixWaitMutex;
+    std::condition_variable myFixWaitCond;
+    std::atomic<int> myNumFixWaiters;
+    /* Fix statistics; the sums are for the interval mean and standard deviation */
+    mutable std::mutex myFixStatsMutex;
+    FixStats myFixStats;
+    double myFixIntervalSum;
+    double myFixIntervalSumSq;
+    double myParseUSecsSum;
+    /* The parser's counts as of the end of the last read(), copied there so
+       that other threads never read the parser's own (unsynchronized) counts */
+    ArNMEAParser::Stats myParserStats;
+    ArNMEAParser::Stats myParserStatsAtReset;
+
 };
 
 
@@ -637,6 +773,7 @@ public:
     {
       myData.timeGotPosition.setToNow();
     }
+    publishFix();
     return ReadUpdated | ReadFinished;
   }
 private:
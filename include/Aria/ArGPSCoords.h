@@ -168,6 +168,15 @@ class ArENUCoords : public Ar3DPoint
 /**
  * Coordinates based on a map with origin in LLA coords with conversion
  * methods from LLA to ENU and from ENU to LLA coordinates.
+ *
+ * setOrigin() works out the origin's ECEF position and the rotation
+ * between ECEF and the map's east/north/up axes once, so each
+ * conversion only needs the trigonometry for the point itself.  To
+ * convert many points (a georeferenced map, a long GPS track) use the
+ * array versions of convertLLA2MapCoords() and convertMap2LLACoords(),
+ * which take separate arrays for each coordinate and run a simple loop
+ * the compiler can vectorize.  Map coordinates are in mm, latitude and
+ * longitude in degrees and altitude in m.
  * @ingroup UtilityClasses
  */
 class ArMapGPSCoords : public ArENUCoords
@@ -178,7 +187,7 @@ public:
     setOrigin(org);
   }
 
-  ArMapGPSCoords() : ArENUCoords(0, 0, 0), myOriginSet(false)
+  ArMapGPSCoords() : ArENUCoords(0, 0, 0), myOriginSet(false), myRot()
   {
   }
 
@@ -190,15 +199,36 @@ public:
 {
     return convertLLA2MapCoords(lla.getLatitude(), lla.getLongitude(), lla.getAltitude(), ea, no, up);
   }
-  void setOrigin(const ArLLACoords& org) {
-    myOriginSet = true;
-    myOriginLLA = org;
-    myOriginECEF = myOriginLLA.LLA2ECEF();
-  }
+  /// Converts @a count points from LLA to map coordinates
+  /**
+     The output arrays may be the same as the input arrays.
+     @return false if the origin isn't set
+  */
+  AREXPORT bool convertLLA2MapCoords(const double *lat, const double *lon, 
+				     const double *alt, double *ea, 
+				     double *no, double *up, 
+				     size_t count) const;
+  /// Converts @a count points from map to LLA coordinates
+  /**
+     The output arrays may be the same as the input arrays.
+     @return false if the origin isn't set
+  */
+  AREXPORT bool convertMap2LLACoords(const double *ea, const double *no, 
+				     const double *up, double *lat, 
+				     double *lon, double *alt, 
+				     size_t count) const;
+  /// Sets the origin and works out the rotation to and from ECEF
+  AREXPORT void setOrigin(const ArLLACoords& org);
+  /// Returns whether an origin has been set
+  bool isOriginSet() const { return myOriginSet; }
+  /// Gets the origin
+  const ArLLACoords &getOrigin() const { return myOriginLLA; }
 private:
   ArECEFCoords myOriginECEF;
   ArLLACoords myOriginLLA;
   bool myOriginSet;
+  /// Rows are the east, north and up axes in ECEF
+  double myRot[3][3];
 };
 
 
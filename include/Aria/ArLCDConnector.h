@@ -26,6 +26,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include "Aria/ariaTypedefs.h"
 #include "Aria/ariaUtil.h"
+#include "Aria/ArDeviceConnectGroup.h"
 
 class ArLCDMTX;
 class ArRobot;
@@ -115,6 +116,14 @@ public:
 	AREXPORT void turnOffPowerCB (int);
 
 	AREXPORT void setIdentifier(const char *identifier);
+
+  /// Gets the group connectLCDs() uses to connect the lcds concurrently
+  /**
+     Use this to set retry and timeout policies for the lcds (by lcd
+     number) or to connect them one at a time before connectLCDs(),
+     and afterwards to see which lcds came up and how long it took.
+  */
+  ArDeviceConnectGroup *getConnectGroup() { return &myConnectGroup; }
   
 protected:
 /// Class that holds information about the lcd data
@@ -174,6 +183,8 @@ class LCDData
   AREXPORT void logLCDOptions(LCDData *lcddata, bool header = true, bool metaOpts = true) const;
   // Sets the lcd parameters
   bool internalConfigureLCD(LCDData *lcdData);
+  // Connects one lcd (run by myConnectGroup)
+  bool internalConnectLCD(LCDData *lcdData);
 
   std::string myLCDTypes;
 
@@ -193,6 +204,8 @@ class LCDData
 
   ArLog::LogLevel myInfoLogLevel;
 
+  ArDeviceConnectGroup myConnectGroup;
+
   ArRetFunctor1<bool, const char *> *myTurnOnPowerOutputCB;
   ArRetFunctor1<bool, const char *> *myTurnOffPowerOutputCB;
 
@@ -31,6 +31,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include <string>
 
+class ArDeviceReactor;
+
 #ifndef ARIA_WRAPPER
 /** @internal 
   Constructs packets for LMS1xx ASCII protocol. 
@@ -244,6 +246,19 @@ public:
   /// Logs the information about the sensor
   AREXPORT void log();
 
+  /// Reads the scans from one of @a reactor's threads instead of the laser's own thread
+  /**
+     Call this before connecting.  Once the laser is connected its
+     connection is added to @a reactor, which calls the laser whenever
+     there is data, so the laser doesn't keep a thread of its own
+     (asyncConnect() still uses one for connecting, which exits once the
+     laser is connected).  Pass NULL to go back to the laser's own
+     thread.  (Not available on Windows.)
+     @return false if the laser is connected
+  */
+  AREXPORT bool setReactor(ArDeviceReactor *reactor);
+  /// Gets the reactor set with setReactor(), or NULL
+  ArDeviceReactor *getReactor() const { return myReactor; }
 
 protected:
   AREXPORT virtual void laserSetName(const char *name);
@@ -254,6 +269,11 @@ protected:
   void sensorInterp();
   void failedToConnect();
   void clear();
+  bool startReading();
+  void stopReactorReading();
+  void reactorReadable(ArDeviceConnection *conn);
+  void reactorIdle(ArDeviceConnection *conn);
+  void reactorCheckLostConnection();
 
   /// @return true if message contents matches checksum, false otherwise.
   bool validateCheckSum(ArLMS1XXPacket *packet);
@@ -292,7 +312,6 @@ protected:
   int myNumberEncoders;
   int myNumChans16Bit;
   int myNumChans8Bit;
-  int myFirstReadings;
   int myYear;
   int myMonth;
   int myMonthDay;
@@ -312,6 +331,12 @@ protected:
 
   ArFunctorC<ArLMS1XX> mySensorInterpTask;
   ArRetFunctorC<bool, ArLMS1XX> myAriaExitCB;
+
+  ArDeviceReactor *myReactor = NULL;
+  // the connection is in myReactor (so our own thread isn't reading)
+  bool myReactorReading = false;
+  ArFunctor1C<ArLMS1XX, ArDeviceConnection *> myReactorReadableCB;
+  ArFunctor1C<ArLMS1XX, ArDeviceConnection *> myReactorIdleCB;
 };
 
 #endif 
@@ -28,6 +28,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArRangeDeviceThreaded.h"
 
 class ArDeviceConnection;
+class ArMetricCounter;
+class ArMetricHistogram;
 
 
 
@@ -570,6 +572,15 @@ public:
   AREXPORT virtual void applyTransform(ArTransform trans,
                                         bool doCumulative = true);
 
+  /// Gets the closest current reading in the given polar region
+  AREXPORT virtual double currentReadingPolar(double startAngle, 
+					      double endAngle,
+					      double *angle = NULL) const override;
+
+  /// Gets how many times the polar index used by currentReadingPolar() has been built
+  unsigned long long getPolarIndexBuilds() const 
+    { return myPolarIndexBuilds; }
+
   /// Makes it so we'll apply simple naming to all the lasers
   AREXPORT static void useSimpleNamingForAllLasers();
 protected:
@@ -578,6 +589,22 @@ protected:
   /// by subclasses)
   AREXPORT void laserProcessReadings();
 
+  /// Makes sure there's a raw reading for each beam of a scan and sets
+  /// up the per beam table laserFillBeams() uses
+  AREXPORT bool laserSetBeams(size_t numBeams, double startAngle, 
+			      double increment);
+
+  /// Moves one beam's reading off the table's sensor position (for
+  /// interpolating motion across a scan), laserFillBeams() puts it back
+  AREXPORT void laserMoveBeam(size_t beam, double x, double y, double th);
+
+  /// Fills in raw readings from the ranges a subclass put in
+  /// myBeamRanges (and myBeamIgnore and myBeamExtraInts)
+  AREXPORT void laserFillBeams(const ArPose &robotPose, 
+			       const ArPose &encoderPose,
+			       const ArTransform &trans, unsigned int counter,
+			       const ArTime &timeTaken, size_t firstBeam = 0);
+
   /// Returns if the laser has lost connection so that the subclass
   /// can do something appropriate
   AREXPORT bool laserCheckLostConnection();
@@ -685,6 +712,10 @@ protected:
   ArTime myCumulativeLastClean;
   std::set<int> myIgnoreReadings;
 
+  // ArMetrics for laserProcessReadings(), registered on its first scan
+  ArMetricCounter *myScansMetric = nullptr;
+  ArMetricHistogram *myProcessTimeMetric = nullptr;
+
   unsigned int myAbsoluteMaxRange = 0;
   bool myMaxRangeSet = false;
 
@@ -773,6 +804,50 @@ protected:
   bool myRobotRunningAndConnected = false;
 
   static bool ourUseSimpleNaming;
+
+  // Per beam table set up by laserSetBeams(), with each beam's raw
+  // reading and direction, and the data a subclass fills in for
+  // laserFillBeams() each scan
+  std::vector<ArSensorReading *> myBeamReadings;
+  std::vector<double> myBeamCos;
+  std::vector<double> myBeamSin;
+  std::vector<unsigned int> myBeamRanges;
+  std::vector<unsigned char> myBeamIgnore;
+  std::vector<int> myBeamExtraInts;
+  double myBeamStart = 0;
+  double myBeamIncrement = 0;
+  int myBeamSensorX = 0;
+  int myBeamSensorY = 0;
+  // set when laserMoveBeam() moved readings off the table's geometry
+  bool myBeamsMoved = false;
+  // scratch for laserFillBeams()
+  std::vector<double> myBeamLocalXs;
+  std::vector<double> myBeamLocalYs;
+  std::vector<double> myBeamXs;
+  std::vector<double> myBeamYs;
+
+  // Index of the current buffer that currentReadingPolar() searches,
+  // built the first time it's needed after the buffer or robot pose
+  // changes.  Readings are sorted by their angle from the pose, with a
+  // sparse table over that order to find the closest reading in any
+  // run of angles.  Readers holding lockDeviceShared() can query at the
+  // same time, so the index has its own lock.
+  AREXPORT void buildPolarIndex(const ArPose &pose) const;
+  mutable ArMutex myPolarIndexMutex;
+  mutable bool myPolarIndexValid = false;
+  mutable unsigned long long myPolarIndexChangeCount = 0;
+  mutable ArPose myPolarIndexPose;
+  mutable unsigned long long myPolarIndexBuilds = 0;
+  // these are in buffer order
+  mutable std::vector<double> myPolarIndexXs;
+  mutable std::vector<double> myPolarIndexYs;
+  mutable std::vector<double> myPolarIndexDists;
+  // these are in angle order
+  mutable std::vector<double> myPolarIndexAngles;
+  mutable std::vector<unsigned int> myPolarIndexTable;
+  // buffer indices of readings too close to the pose to sort by angle
+  mutable std::vector<unsigned int> myPolarIndexNear;
+  mutable std::vector<std::pair<double, unsigned int> > myPolarIndexSort;
 };
 
 #endif // ARRANGEDEVICELASER_H
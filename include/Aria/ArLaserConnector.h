@@ -28,6 +28,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArArgumentParser.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArRobotConnector.h"
+#include "Aria/ArDeviceConnectGroup.h"
+#include "Aria/ArMutex.h"
 
 class ArLaser;
 class ArRobot;
@@ -119,6 +121,14 @@ public:
 
   /// Log all currently set parameter values
   AREXPORT void logLaserData();
+
+  /// Gets the group connectLasers() uses to connect the lasers concurrently
+  /**
+     Use this to set retry and timeout policies for the lasers (by laser
+     number) or to connect them one at a time before connectLasers(),
+     and afterwards to see which lasers came up and how long it took.
+  */
+  ArDeviceConnectGroup *getConnectGroup() { return &myConnectGroup; }
   
 protected:
   /// Class that holds information about the laser data
@@ -235,6 +245,9 @@ protected:
   AREXPORT void logLaserOptions(LaserData *laserdata, bool header = true, bool metaOpts = true) const;
   // Sets the laser parameters
   bool internalConfigureLaser(LaserData *laserData);
+  // Connects one laser, power cycling it if needed (run by myConnectGroup)
+  bool internalConnectLaser(LaserData *laserData, 
+			    bool powerCycleLaserOnFailedConnect);
 
   std::string myLaserTypes;
 
@@ -250,6 +263,9 @@ protected:
 
   ArLog::LogLevel myInfoLogLevel;
 
+  ArDeviceConnectGroup myConnectGroup;
+  ArMutex myPowerCycleMutex;
+
   ArRetFunctor1<bool, const char *> *myTurnOnPowerOutputCB;
   ArRetFunctor1<bool, const char *> *myTurnOffPowerOutputCB;
 
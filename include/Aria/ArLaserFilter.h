@@ -27,6 +27,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArLaser.h"
 #include "Aria/ArFunctor.h"
 
+#include <vector>
+
 class ArRobot;
 class ArConfig;
 
@@ -42,6 +44,17 @@ class ArConfig;
    probably should connect it too.  Then you should replace the
    original laser on ArRobot with this one, and replace the original
    laser as a range device too.
+
+   Each scan is copied once from the base laser, then indexed into a
+   set of contiguous arrays (see ArLaserFilter::Scan) which the filter
+   stages work on in place.  The built in stages run in this order,
+   each one disabled by a negative (or zero) parameter value: range
+   clamp (ClampMinRange, ClampMaxRange), angular neighbor outlier
+   tests (AngleSpread, AnyNeighborFactor, AllNeighborFactor,
+   AnyNeighborMinRange), median deviation (MedianWindow,
+   MedianMaxDeviation), and intensity threshold (MinIntensity).  Any
+   stages added with addStage() run after those.  Only the ignore
+   flags are written back to the readings at the end.
 **/
 class ArLaserFilter : public ArLaser
 {
@@ -79,6 +92,48 @@ public:
   
   /// Gets the base laser this is filtering
   ArLaser *getBaseLaser() { return myLaser; }
+
+  /// Contiguous per-scan arrays that the filter stages operate on
+  /**
+     All the arrays are the same length, indexed by reading in the
+     order the base laser returned them (which is sorted by angle).
+     Stages should only set entries in @a ignore, so that one stage's
+     decisions are visible to the next without copying anything.
+  **/
+  struct Scan {
+    std::vector<unsigned int> ranges; ///< range of each reading (mm)
+    std::vector<double> angles; ///< angle of each reading on the sensor (deg)
+    std::vector<int> intensities; ///< ArSensorReading::getExtraInt() of each reading
+    std::vector<unsigned char> ignore; ///< nonzero if the reading is to be ignored
+    /// Number of readings in the scan
+    size_t size() const { return ranges.size(); }
+  };
+
+  /// Adds a stage that will be run (in the order added) after the built in stages
+  AREXPORT void addStage(ArFunctor1<Scan *> *stage);
+  /// Removes a stage added with addStage()
+  AREXPORT void remStage(ArFunctor1<Scan *> *stage);
+
+  /// Sets the angle spread to check on either side of each reading (deg)
+  void setAngleToCheck(double angleToCheck) { myAngleToCheck = angleToCheck; }
+  /// Sets the any neighbor factor (negative to disable)
+  void setAnyFactor(double anyFactor) { myAnyFactor = anyFactor; }
+  /// Sets the all neighbor factor (negative to disable)
+  void setAllFactor(double allFactor) { myAllFactor = allFactor; }
+  /// Sets the any neighbor min range (mm, negative to disable)
+  void setAnyMinRange(double anyMinRange) { myAnyMinRange = anyMinRange; }
+  /// Sets the angles the any neighbor min range applies outside of (deg)
+  void setAnyMinRangeAngles(double lessThanAngle, double greaterThanAngle)
+    { myAnyMinRangeLessThanAngle = lessThanAngle; 
+      myAnyMinRangeGreaterThanAngle = greaterThanAngle; }
+  /// Sets the range clamp, readings outside of it are ignored (mm, negative to disable either end)
+  void setClampRange(double minRange, double maxRange)
+    { myClampMinRange = minRange; myClampMaxRange = maxRange; }
+  /// Sets the median stage (readings on each side, and max deviation in mm)
+  void setMedian(int window, double maxDeviation)
+    { myMedianWindow = window; myMedianMaxDeviation = maxDeviation; }
+  /// Sets the minimum intensity (negative to disable)
+  void setMinIntensity(int minIntensity) { myMinIntensity = minIntensity; }
 protected:
   AREXPORT int selfLockDevice();
   AREXPORT int selfTryLockDevice();
@@ -93,13 +148,31 @@ protected:
   double myAnyMinRange;
   double myAnyMinRangeLessThanAngle;
   double myAnyMinRangeGreaterThanAngle;
+  double myClampMinRange;
+  double myClampMaxRange;
+  int myMedianWindow;
+  double myMedianMaxDeviation;
+  int myMinIntensity;
 
   /// Does the check against all neighbor factor
-  bool checkRanges(unsigned int thisReading, unsigned int otherReading, double factor);
+  static bool checkRanges(unsigned int thisReading, unsigned int otherReading, double factor);
   
   // Callback to do the actual filtering
   void processReadings();
 
+  // The built in stages
+  void clampStage();
+  void neighborStage();
+  void medianStage();
+  void intensityStage();
+
+  // Readings of the current scan, indexed the same as myScan
+  std::vector<ArSensorReading *> myReadings;
+  Scan myScan;
+  // scratch space for the median stage
+  std::vector<unsigned int> myMedianWork;
+  std::vector<ArFunctor1<Scan *> *> myStages;
+
   ArFunctorC<ArLaserFilter> myProcessCB;
 };
 
@@ -34,6 +34,13 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include "Aria/md5.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+class ArThreadPool;
+
 /// Calculates the MD5 checksum when reading or writing a text file using ArFunctors.
 /**
  * ArMD5Calculator is a small helper class used to calculate MD5 checksums
@@ -46,6 +53,16 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
  * optional second functor is specified, then it will be invoked after the 
  * checksum functor. 
  *
+ * Data that is already in memory in large pieces (such as a file read
+ * a block at a time) should be given to appendBlock() instead.  The
+ * checksum only depends on the bytes, not on how they were split up.
+ *
+ * Hashing can be moved off the calling thread with setHashInBackground():
+ * appended text is then copied into blocks which are hashed on an
+ * ArThreadPool while the caller (for example the map parser) keeps
+ * going, and getDigest() waits for the last of them.
+ *
+ * @see ArFastHash for a faster checksum when MD5 compatibility isn't needed
  * @ingroup UtilityClasses
 **/
 class ArMD5Calculator {
@@ -54,7 +71,8 @@ public:
 
 	enum  : size_t {
 		DIGEST_LENGTH = 16U, ///< Number of bytes in the checksum buffer
-    DISPLAY_LENGTH = (DIGEST_LENGTH * 2) + 1 ///< Number of characters needed to display the checksum
+    DISPLAY_LENGTH = (DIGEST_LENGTH * 2) + 1, ///< Number of characters needed to display the checksum
+    BLOCK_SIZE = 65536U ///< Bytes read (or handed to the background) at a time
 	};
    
   // ---------------------------------------------------------------------------
@@ -110,6 +128,22 @@ public:
   /// Calculates the checksum for the given text line, and accumulates the results.
 	AREXPORT void append(const char *str);
 
+  /// Accumulates the checksum of a block of raw data.
+  /**
+   * Unlike append(), the second functor is not called.
+  **/
+	AREXPORT void appendBlock(const void *data, size_t len);
+
+  /// Sets whether to hash appended data on a thread pool instead of the caller's thread.
+  /**
+   * @param inBackground whether to hash in the background
+   * @param pool the pool to hash on, if NULL then ArThreadPool::getShared()
+  **/
+	AREXPORT void setHashInBackground(bool inBackground, 
+                                    ArThreadPool *pool = NULL);
+  /// Returns whether appended data is hashed in the background
+	bool getHashInBackground() const { return myPool != NULL; }
+
   /// Returns a pointer to the internal buffer that accumulates the checksum results.
 	AREXPORT unsigned char *getDigest();
 
@@ -142,6 +176,25 @@ private:
   /// Whether the calculator is finished, i.e. the md5_finish method has been called.
 	bool myIsFinished;
 
+  /// Queues myFilling to be hashed in the background
+  void queueFilling();
+  /// Hashes queued blocks, runs on myPool
+  void hashQueued();
+  /// Waits until every queued block has been hashed
+  void waitForQueued();
+
+  /// Pool that hashes in the background, NULL to hash in append()
+  ArThreadPool *myPool;
+  /// Text appended since the last block was queued
+  std::string myFilling;
+  /// Blocks waiting to be hashed, in order
+  std::deque<std::string> myQueued;
+  /// Whether a hashQueued() is queued or running on the pool
+  bool myIsHashing;
+  std::mutex myQueueMutex;
+  std::condition_variable myQueueCond;
+  ArFunctorC<ArMD5Calculator> myHashQueuedCB;
+
 }; // end class ArMD5Calculator
 
 #endif // ARMD5CALCULATOR_H
@@ -27,7 +27,10 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArFunctor.h"
 #include "Aria/ArMutex.h"
 #include "Aria/ariaTypedefs.h"
+#include "Aria/ariaUtil.h"
 #include <cassert>
+#include <mutex>
+#include <vector>
 
 /** @brief Interface to digital and analog I/O and switched power outputs on MTX
  * core (used in Pioneer LX and other MTX-based robots).
@@ -306,6 +309,87 @@ public:
   /// @param val Pointer to value to write value to. Values are in volts * 1000.
   AREXPORT bool setAnalogIOBlock2(unsigned short analog, unsigned short *val);
 
+  /// Number of registers that can be in a snapshot (the status and control
+  /// registers, below the analog IO blocks)
+  enum { SNAPSHOT_NUM_REGS = 0x50 };
+
+  /** @brief Register values read together by takeSnapshot()
+
+      Reading from a snapshot doesn't access the device.  The accessors
+      return false if the register wasn't in the snapshot (see
+      addSnapshotRegister()) or couldn't be read.
+   */
+  struct Snapshot
+  {
+    ArTime timeTaken; ///< When takeSnapshot() finished reading
+    unsigned long long number = 0; ///< 1 for the first snapshot, 0 if there hasn't been one
+    long long readUSecs = 0; ///< How long reading the registers took
+    unsigned int numReads = 0; ///< Device reads (ioctl calls) it took
+    bool complete = false; ///< True if every register in the snapshot was read
+    unsigned char values[SNAPSHOT_NUM_REGS] = {}; ///< Register values, indexed by register
+    bool have[SNAPSHOT_NUM_REGS] = {}; ///< Which entries of @a values were read
+
+    /// Raw register value
+    bool getRegValue(unsigned short reg, unsigned char *val) const
+    {
+      if (reg >= SNAPSHOT_NUM_REGS || !have[reg])
+        return false;
+      *val = values[reg];
+      return true;
+    }
+    /// @see ArMTXIO::getDigitalBankInputs()
+    AREXPORT bool getDigitalBankInputs(int bank, unsigned char *val) const;
+    /// @see ArMTXIO::getDigitalBankOutputs()
+    AREXPORT bool getDigitalBankOutputs(int bank, unsigned char *val) const;
+    /// @see ArMTXIO::getPeripheralPowerBankOutputs()
+    AREXPORT bool getPeripheralPowerBankOutputs(int bank, unsigned char *val) const;
+    /// Output monitoring register 1 or 2, @see ArMTXIO::getDigitalIOOutputMon1()
+    AREXPORT bool getDigitalIOOutputMon(int num, unsigned char *val) const;
+    /// @see ArMTXIO::getBumperInput()
+    AREXPORT bool getBumperInput(unsigned char *val) const;
+    /// Power status register 1 or 2, @see ArMTXIO::getPowerStatus1()
+    AREXPORT bool getPowerStatus(int num, unsigned char *val) const;
+    /// @see ArMTXIO::getLIDARSafety()
+    AREXPORT bool getLIDARSafety(unsigned char *val) const;
+    /// ESTOP status register 1 to 4, @see ArMTXIO::getESTOPStatus1()
+    AREXPORT bool getESTOPStatus(int num, unsigned char *val) const;
+    /// @see ArMTXIO::getMotionPowerStatus()
+    AREXPORT bool getMotionPowerStatus(unsigned char *val) const;
+    /// @see ArMTXIO::getLightPole()
+    AREXPORT bool getLightPole(unsigned char *val) const;
+  };
+
+  /** @brief Read all of the snapshot registers and keep the values for getSnapshot().
+
+      Each of the get functions above reads one register from the device.
+      If you poll many registers, call this once per cycle (or add
+      getTakeSnapshotCB() to a robot task) and read them from getSnapshot()
+      instead.  Registers next to each other are read together, up to 4
+      per device read.  By default the snapshot has the digital IO,
+      bumper, power, LIDAR, ESTOP and light pole registers.
+
+      Values written with the set functions won't be in the snapshot until
+      the next call to this.
+
+      @return false if the device isn't enabled or a register couldn't be
+      read (the registers that were read are still kept)
+   */
+  AREXPORT bool takeSnapshot();
+  /// Get a copy of the values from the last takeSnapshot()
+  AREXPORT ArMTXIO::Snapshot getSnapshot() const;
+  /// Functor for takeSnapshot()
+  ArRetFunctor<bool> *getTakeSnapshotCB() { return &myTakeSnapshotCB; }
+
+  /// Add a register to the snapshot. Returns false if it's not below SNAPSHOT_NUM_REGS.
+  AREXPORT bool addSnapshotRegister(unsigned short reg);
+  /// Remove a register from the snapshot
+  AREXPORT void remSnapshotRegister(unsigned short reg);
+  /// Remove all registers from the snapshot
+  AREXPORT void clearSnapshotRegisters();
+  /// Put back the default set of snapshot registers
+  AREXPORT void setDefaultSnapshotRegisters();
+  /// How many device reads takeSnapshot() does for the current registers
+  AREXPORT size_t getNumSnapshotReads() const;
 
 protected:
 
@@ -347,6 +431,23 @@ protected:
 
   ArRetFunctorC<bool, ArMTXIO> myDisconnectCB;
   ArRetFunctor1C<bool, ArMTXIO, uint32_t *> myLPCTimeUSecCB;
+
+  /// One device read in a snapshot, @a size consecutive registers
+  struct SnapshotRead
+  {
+    unsigned short reg;
+    unsigned short size;
+  };
+  /// Group the registers flagged in @a regs into as few reads as possible.
+  /// Reads are 4 or 2 registers when aligned to that size, otherwise 1.
+  AREXPORT static std::vector<SnapshotRead> planSnapshotReads(const bool *regs, size_t numRegs);
+
+  /// protects the snapshot registers, read plan and last snapshot
+  mutable std::mutex mySnapshotMutex;
+  bool mySnapshotRegs[SNAPSHOT_NUM_REGS];
+  std::vector<SnapshotRead> mySnapshotReads;
+  Snapshot mySnapshot;
+  ArRetFunctorC<bool, ArMTXIO> myTakeSnapshotCB;
 };
 
 //#endif // SWIG
@@ -91,6 +91,16 @@ class ArBasePacket;
 class ArMapId {
 
 public:
+
+  /// Kinds of checksum that create() can calculate
+  enum ChecksumType {
+    /// MD5 (ArMD5Calculator), the same as older map IDs and ArMap use
+    CHECKSUM_MD5,
+    /// ArFastHash, much faster on large maps, but a map ID with this
+    /// kind of checksum never equals one with an MD5 checksum
+    CHECKSUM_FAST
+  };
+
   // --------------------------------------------------------------------------
   // Static Methods
   // --------------------------------------------------------------------------
@@ -101,11 +111,15 @@ public:
    * @param fileName the const char * name of the file for which to create the 
    * map ID
    * @param mapIdOut a pointer to the map ID to be filled in with the results
+   * @param checksumType which checksum to calculate; use CHECKSUM_FAST
+   * when the ID is only compared with others made the same way (for
+   * example to notice that a local map file changed)
    * @return bool true if the file was found and the map ID created; false, 
    * otherwise.
   **/
   AREXPORT static bool create(const char *fileName,
-                              ArMapId *mapIdOut);
+                              ArMapId *mapIdOut,
+                              ChecksumType checksumType = CHECKSUM_MD5);
 
   /// Inserts the given map ID into a network packet
   /**
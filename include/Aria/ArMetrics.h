@@ -0,0 +1,333 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARMETRICS_H
+#define ARMETRICS_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArASyncTask.h"
+#include "Aria/ArSocket.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// A count that only goes up, which any thread can add to without locking
+/**
+   The count is split into several shards that are each on their own
+   cache line, and each thread adds to the shard it was given the first
+   time it added to any counter.  So threads that add to the same
+   counter at the same time (such as several device threads counting
+   readings) don't fight over one cache line.  get() adds the shards
+   up.
+
+   Get counters from ArMetrics::getCounter(), they aren't made directly.
+
+   @ingroup UtilityClasses
+*/
+class ArMetricCounter
+{
+public:
+  /// Adds @a n to the count
+  void add(unsigned long long n = 1)
+    { myShards[getThreadShard()].value.fetch_add(n, std::memory_order_relaxed); }
+  /// Gets the count (the sum of the shards)
+  AREXPORT unsigned long long get() const;
+  /// Sets the count back to 0
+  AREXPORT void reset();
+
+  ArMetricCounter() = default;
+  ArMetricCounter(const ArMetricCounter &) = delete;
+  ArMetricCounter &operator=(const ArMetricCounter &) = delete;
+
+  /// How many shards each counter has
+  static const size_t NUM_SHARDS = 8;
+  /// @internal Gets the shard the calling thread adds to
+  AREXPORT static size_t getThreadShard();
+protected:
+  struct Shard
+  {
+    std::atomic<unsigned long long> value{0};
+    char pad[64 - sizeof(std::atomic<unsigned long long>)];
+  };
+  Shard myShards[NUM_SHARDS];
+};
+
+/// A value that can go up and down, which any thread can set without locking
+/**
+   Get gauges from ArMetrics::getGauge(), they aren't made directly.
+   For a value that some object already keeps (such as the size of a
+   buffer) ArMetrics::addCallbackGauge() is usually simpler, since then
+   the value is only read when a snapshot is taken.
+
+   @ingroup UtilityClasses
+*/
+class ArMetricGauge
+{
+public:
+  /// Sets the value
+  void set(double value) { myValue.store(value, std::memory_order_relaxed); }
+  /// Adds @a delta (which may be negative) to the value
+  AREXPORT void add(double delta);
+  /// Gets the value
+  double get() const { return myValue.load(std::memory_order_relaxed); }
+
+  ArMetricGauge() = default;
+  ArMetricGauge(const ArMetricGauge &) = delete;
+  ArMetricGauge &operator=(const ArMetricGauge &) = delete;
+protected:
+  std::atomic<double> myValue{0};
+};
+
+/// Counts values (usually latencies) into fixed buckets, without locking
+/**
+   Each bucket has an upper bound and counts the values that are less
+   than or equal to it and greater than the bound before it; values
+   above the last bound go in one more overflow bucket.  The buckets
+   are fixed when the histogram is made, so observe() is a binary
+   search and two atomic adds.  The sum of all the values is kept too,
+   so the mean can be found.
+
+   Get histograms from ArMetrics::getHistogram(), they aren't made
+   directly.
+
+   @ingroup UtilityClasses
+*/
+class ArMetricHistogram
+{
+public:
+  /// Counts a value
+  AREXPORT void observe(double value);
+  /// Gets the upper bounds of the buckets (not including the overflow bucket)
+  const std::vector<double> &getBounds() const { return myBounds; }
+  /// Gets the count in each bucket, the last one is the overflow bucket
+  AREXPORT std::vector<unsigned long long> getBucketCounts() const;
+  /// Gets how many values have been counted (the sum of the buckets)
+  AREXPORT unsigned long long getCount() const;
+  /// Gets the sum of the values that have been counted
+  double getSum() const { return mySum.load(std::memory_order_relaxed); }
+  /// Clears the counts and the sum
+  AREXPORT void reset();
+
+  /// @internal Use ArMetrics::getHistogram()
+  AREXPORT explicit ArMetricHistogram(const std::vector<double> &bounds);
+  ArMetricHistogram(const ArMetricHistogram &) = delete;
+  ArMetricHistogram &operator=(const ArMetricHistogram &) = delete;
+protected:
+  std::vector<double> myBounds;
+  std::unique_ptr<std::atomic<unsigned long long>[]> myBuckets;
+  std::atomic<double> mySum{0};
+};
+
+/// A registry of the program's counters, gauges and histograms
+/**
+   Aria's own classes register metrics here about how they are doing,
+   and programs can register their own:
+
+   - aria_robot_cycle_msecs (histogram, label robot): how long each
+     ArRobot sync cycle took (ArSyncLoop)
+   - aria_robot_packets_received_total and
+     aria_robot_packets_dropped_total (counters, labels robot and
+     type): packets from the robot by packet ID, and the ones that were
+     ignored or that no packet handler wanted (ArRobot)
+   - aria_laser_scans_total (counter, label laser) and
+     aria_laser_process_usecs (histogram, label laser): scans processed
+     by each laser and how long laserProcessReadings() took for them
+     (ArLaser).  Scans per second is the rate of the counter.
+   - aria_range_device_current_readings and
+     aria_range_device_cumulative_readings (gauges, label device): the
+     number of readings in each range device's buffers (ArRangeDevice)
+   - aria_mutex_locks_total, aria_mutex_contended_locks_total and
+     aria_mutex_wait_usecs_total (counters, label mutex): from the
+     ArMutex contention profiler, only while it is on (see
+     ArMutex::setProfiling())
+
+   A metric is found by its name and its labels, which are given in
+   the Prometheus form (<code>robot="sim",type="0x90"</code>, see
+   makeLabels()).  Asking for a metric that is already registered
+   returns the same object, and metrics are never removed, so the
+   pointers that are returned can be kept and used from any thread for
+   as long as the program runs.  Registering a metric takes a lock, so
+   objects look theirs up once and keep the pointer; updating one
+   doesn't.
+
+   getSnapshot() gets all the metrics' values at once, which
+   getPrometheusText() and getJSON() put into text.  ArMetricsServer
+   serves that text over a local socket.
+
+   @ingroup UtilityClasses
+*/
+class ArMetrics
+{
+public:
+  /// The kinds of metrics
+  enum Type
+  {
+    COUNTER, ///< ArMetricCounter
+    GAUGE, ///< ArMetricGauge (or a callback gauge)
+    HISTOGRAM ///< ArMetricHistogram
+  };
+
+  /// The value of one metric when a snapshot was taken
+  struct Sample
+  {
+    std::string name;
+    std::string help;
+    /// The labels in Prometheus form, may be empty
+    std::string labels;
+    Type type = COUNTER;
+    /// The count for a counter or the value of a gauge (for a
+    /// histogram, the sum)
+    double value = 0;
+    /// For a histogram, the upper bounds of the buckets
+    std::vector<double> bounds;
+    /// For a histogram, the count in each bucket (one more than bounds)
+    std::vector<unsigned long long> bucketCounts;
+    /// For a histogram, how many values were counted
+    unsigned long long count = 0;
+  };
+
+  /// Gets (registering it the first time) a counter
+  /**
+     @param name the name of the metric (letters, digits and _), by
+     convention ending in _total
+     @param help a line describing the metric (shared by all the labels
+     of a name, the first one that isn't empty is kept)
+     @param labels the labels that tell this one apart from others with
+     the same name, see makeLabels()
+     @return the counter, or NULL if @a name is already registered as a
+     different type
+  */
+  AREXPORT static ArMetricCounter *getCounter(const char *name,
+					      const char *help = "",
+					      const std::string &labels = "");
+  /// Gets (registering it the first time) a gauge
+  AREXPORT static ArMetricGauge *getGauge(const char *name,
+					  const char *help = "",
+					  const std::string &labels = "");
+  /// Gets (registering it the first time) a histogram
+  /**
+     @param bounds the upper bounds of the buckets, in increasing order,
+     if empty then getDefaultMSecBounds().  Ignored if the histogram is
+     already registered.
+  */
+  AREXPORT static ArMetricHistogram *getHistogram(
+	  const char *name, const char *help = "",
+	  const std::string &labels = "",
+	  const std::vector<double> &bounds = std::vector<double>());
+
+  /// Adds a gauge whose value comes from calling a functor
+  /**
+     The functor is only called when a snapshot is taken, from the
+     thread taking it, so it should be quick and must do its own locking.
+     The functor is not owned, remove it with remCallbackGauge() before
+     deleting it.
+     @return false (and nothing is added) if a callback gauge with the
+     same name and labels is already registered, or the name is
+     registered as a different type
+  */
+  AREXPORT static bool addCallbackGauge(const char *name, const char *help,
+					const std::string &labels,
+					ArRetFunctor<double> *functor);
+  /// Removes a gauge added with addCallbackGauge()
+  /**
+     Once this returns the functor won't be called again (if a snapshot
+     is calling it right now, this waits for it).
+  */
+  AREXPORT static void remCallbackGauge(ArRetFunctor<double> *functor);
+
+  /// Gets the values of all the metrics, sorted by name and then labels
+  AREXPORT static std::vector<Sample> getSnapshot();
+  /// Sets all the counters, gauges and histograms back to 0
+  AREXPORT static void reset();
+
+  /// Puts a snapshot into the Prometheus text exposition format
+  AREXPORT static std::string toPrometheusText(const std::vector<Sample> &samples);
+  /// Puts a snapshot into JSON (an object with a "metrics" array)
+  AREXPORT static std::string toJSON(const std::vector<Sample> &samples);
+  /// Gets a snapshot in the Prometheus text exposition format
+  static std::string getPrometheusText() { return toPrometheusText(getSnapshot()); }
+  /// Gets a snapshot as JSON
+  static std::string getJSON() { return toJSON(getSnapshot()); }
+
+  /// Makes a label string (<code>key="value"</code>) with @a value escaped
+  AREXPORT static std::string makeLabels(const char *key, const std::string &value);
+  /// Makes a label string with two labels
+  AREXPORT static std::string makeLabels(const char *key1, const std::string &value1,
+					 const char *key2, const std::string &value2);
+  /// Gets bucket bounds for latencies in milliseconds (1 ms to 10 s)
+  AREXPORT static const std::vector<double> &getDefaultMSecBounds();
+  /// Gets bucket bounds for latencies in microseconds (10 us to 1 s)
+  AREXPORT static const std::vector<double> &getDefaultUSecBounds();
+};
+
+/// Serves ArMetrics snapshots over HTTP on a local socket
+/**
+   Answers <code>GET /metrics</code> with the Prometheus text format
+   and <code>GET /metrics.json</code> with JSON, so a Prometheus server
+   (or curl) can scrape a running program.  Only a bare-bones HTTP/1.0
+   is spoken: one request per connection, which is what scrapers do.
+   Connections are handled one at a time on the server's own thread.
+
+   By default it only listens on the loopback address, pass a different
+   address (or NULL for all of them) to open() to allow others to
+   connect.
+
+   @code
+   ArMetricsServer metricsServer;
+   if (metricsServer.open(9464))
+     metricsServer.runAsync();
+   @endcode
+
+   @ingroup UtilityClasses
+*/
+class ArMetricsServer : public ArASyncTask
+{
+public:
+  /// Constructor
+  AREXPORT ArMetricsServer();
+  /// Destructor, stops the thread and closes the socket
+  AREXPORT virtual ~ArMetricsServer();
+  /// Opens the server socket, then call runAsync() to start serving
+  /**
+     @param port the TCP port to listen on
+     @param openOnIP the address to listen on, NULL for all of them
+     @return true if the socket was opened, false otherwise (such as
+     when the port is in use)
+  */
+  AREXPORT bool open(int port, const char *openOnIP = "127.0.0.1");
+  /// Closes the server socket
+  AREXPORT void close();
+  /// Gets whether the server socket is open
+  bool isOpen() const { return myServerSocket.getFD() >= 0; }
+  /// Gets how many requests have been answered
+  unsigned long long getNumRequests() const { return myNumRequests.load(); }
+  AREXPORT virtual void *runThread(void *arg) override;
+protected:
+  void handleClient(ArSocket *client);
+  ArSocket myServerSocket;
+  std::atomic<unsigned long long> myNumRequests{0};
+};
+
+#endif // ARMETRICS_H
@@ -24,7 +24,9 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #ifndef ARMUTEX_H
 #define ARMUTEX_H
 
+#include <atomic>
 #include <string>
+#include <vector>
 #include "Aria/ariaTypedefs.h"
 
 #if !defined(_WIN32) || defined(MINGW)
@@ -69,6 +71,11 @@ other undesired effects of lock contention.
       long time.
     <li>Use setLogName() to name an ArMutex object for logging.
     <li>Use setLog() to enable logging of various events such as lock, unlock, errors.
+    <li>Use setProfiling() to count how often each mutex is locked, how often
+      a thread had to wait for it, and how long threads waited for and held it.
+      Mutexes are grouped by the name given with setLogName(), and 
+      logProfile() or getProfileStats() report the totals, most waited for
+      first. This shows which locks are serializing a program's threads.
   </ul>
 
   @ingroup UtilityClasses
@@ -157,7 +164,8 @@ public:
   */
   void setLog(bool log) { myLog = log; } 
   /// Sets a name we'll use to log with
-  void setLogName(const char *logName) { myLogName = logName; } 
+  void setLogName(const char *logName) 
+    { myLogName = logName; myProfile = NULL; } 
 #ifndef SWIG
   /// Sets a name we'll use to log with formatting
   /** @swigomit use setLogName() */
@@ -185,6 +193,57 @@ public:
   */
   static double getUnlockWarningTime()
     { return ourUnlockWarningMS/1000.0; }
+
+  /// Contention totals for the mutexes with one name, see setProfiling()
+  struct ProfileStats
+  {
+    /// The name given to the mutexes with setLogName()
+    std::string name;
+    /// How many times they were locked (including recursive locks)
+    unsigned long long locks = 0;
+    /// How many of those locks had to wait for another thread
+    unsigned long long contendedLocks = 0;
+    /// Total and longest time spent waiting to lock (usecs)
+    unsigned long long totalWaitUSecs = 0;
+    unsigned long long maxWaitUSecs = 0;
+    /// Total and longest time held, from first lock to last unlock (usecs)
+    unsigned long long totalHoldUSecs = 0;
+    unsigned long long maxHoldUSecs = 0;
+    /// The thread that held it the longest
+    std::string maxHoldThread;
+  };
+  /** Turns the contention profiler on or off for all mutexes. While it's
+      on, each lock first tries to take the mutex without blocking so it
+      can tell if it had to wait, and times the wait and how long the mutex
+      is held.  When it's off the only cost is checking the flag.
+      @param profiling whether to profile
+      @param logAtExit if true, log the report with logProfile() when the program exits
+  */
+  AREXPORT static void setProfiling(bool profiling, bool logAtExit = false);
+  /// Gets whether the contention profiler is on
+  static bool getProfiling() { return ourProfiling.load(std::memory_order_relaxed); }
+  /// Gets the profiler's totals for each mutex name, most total wait first
+  AREXPORT static std::vector<ProfileStats> getProfileStats();
+  /// Gets the profiler's totals as a table, most total wait first
+  AREXPORT static std::string getProfileReport();
+  /// Logs the profiler's totals (see getProfileReport())
+  AREXPORT static void logProfile();
+  /// Clears the profiler's totals
+  AREXPORT static void resetProfile();
+  /// @internal Where the profiler keeps the totals for a name
+  struct ProfileEntry;
+  /// @internal Whether the calling thread's lock should be profiled
+  AREXPORT static bool profileThisLock();
+  /// @internal The profiler's clock (usecs)
+  AREXPORT static long long profileNow();
+  /// @internal Gets the totals for a name, adding them the first time
+  /** ArSharedMutex records its locks here too. */
+  AREXPORT static ProfileEntry *getProfileEntry(const std::string &name);
+  /// @internal Adds a lock that got the mutex to the totals
+  AREXPORT static void profileAddLock(ProfileEntry *entry, bool contended,
+				      long long waitUSecs);
+  /// @internal Adds how long the mutex was held (by its last unlock) to the totals
+  AREXPORT static void profileAddHold(ProfileEntry *entry, long long holdUSecs);
 protected:
   
   bool myFailedInit;
@@ -220,6 +279,22 @@ protected:
 
 
   static ArFunctor *ourNonRecursiveDeadlockFunctor;
+
+  // Contention profiling (see setProfiling()).  The totals are kept per
+  // name in a ProfileEntry that lives as long as the program, so that
+  // mutexes can come and go.  The depth and lock time are only touched
+  // by the thread holding the mutex.
+  ProfileEntry *myProfile = NULL;
+  int myProfileDepth = 0;
+  long long myProfileLockedUSecs = 0;
+  AREXPORT static std::atomic<bool> ourProfiling;
+  // record a lock that got the mutex
+  void profileLocked(bool contended, long long waitUSecs);
+  // call before unlocking, returns how long it was held if this is
+  // the last unlock, or -1
+  long long profileUnlocking();
+  // call after unlocking with what profileUnlocking() returned
+  void profileUnlocked(long long holdUSecs);
 };
 
 
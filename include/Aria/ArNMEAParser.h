@@ -31,6 +31,10 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArDeviceConnection.h"
 #include <string>
 #include <vector>
+#include <map>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 
 /** @brief NMEA Parser
@@ -63,7 +67,10 @@ public:
      * skip messages with incorrect checksums, and log a warning mesage) */
     AREXPORT void setIgnoreChecksum(bool ignore) { ignoreChecksum = ignore; }
 
-    /** NMEA message, divided into parts. (TODO one possible performance improvement is that this is a vector of std::string_view's on a character buffer provided by the device connection, but we are probably only reading data from the GPS a few times a second, if even that fast, so not critical here.)    */
+    /** NMEA message, divided into parts. (The fields are copied into std::string objects
+     * which are reused for each message, so once they have grown large enough no
+     * memory is allocated while parsing. See ViewMessage and addViewHandler() for
+     * a way to get the fields without copying them at all.) */
     typedef std::vector<std::string> MessageVector;
 
     /** Message wrapper passed to handlers. It provides a pointer to the parts of the most recently parsed message and some useful metadata. 
@@ -86,11 +93,58 @@ public:
       std::string prefix;
 
     };
+
+    /** One field of a message, pointing directly into the text being parsed
+     *  (i.e. the buffer given to parse(), or the parser's own buffer
+     *  if the message was split across more than one call to parse()).  
+     *  The text is not null terminated. Only valid while the message is being handled.
+     *  (With C++17 or later this converts to a std::string_view.)
+     */
+    struct Field {
+      const char *data = nullptr;
+      size_t size = 0;
+
+      bool empty() const { return size == 0; }
+      /// Copy the field into a new std::string
+      std::string str() const { return std::string(data, size); }
+      /// Compare with a null terminated string
+      bool equals(const char *s) const { return strlen(s) == size && strncmp(s, data, size) == 0; }
+      /// Convert to a double as with atof() (0 if empty or invalid)
+      AREXPORT double toDouble() const;
+      /// Convert to an int as with atoi() (0 if empty or invalid)
+      AREXPORT int toInt() const;
+#if __cplusplus >= 201703L
+      operator std::string_view() const { return std::string_view(data, size); }
+#endif
+    };
+
+    /** Message passed to handlers added with addViewHandler().  Instead of
+     *  copying the message the fields point into the text being parsed.
+     *  This object and all the fields are only valid during the handler call.
+     */
+    struct ViewMessage {
+      /// The parts of the message, including initial message ID (but excluding checksum)
+      const ArNMEAParser::Field *fields;
+      /// Number of fields
+      size_t numFields;
+      /// Timestamp when the beginning of this message was received and parsing began. 
+      ArTime timeParseStarted;
+      /// Message ID (first word minus talker prefix)
+      ArNMEAParser::Field id;
+      /// Talker-ID prefix
+      ArNMEAParser::Field prefix;
+
+      size_t size() const { return numFields; }
+      const ArNMEAParser::Field& operator[](size_t i) const { return fields[i]; }
+    };
       
 
     /** NMEA message handler type.  */
     typedef ArFunctor1<ArNMEAParser::Message> Handler;
 
+    /** NMEA message handler type for handlers that take the fields in place. */
+    typedef ArFunctor1<const ArNMEAParser::ViewMessage *> ViewHandler;
+
 
     /** Set a handler for an NMEA message. Mostly for internal use or to be used
      * by related classes, but you could use for unusual or custom messages
@@ -102,6 +156,16 @@ public:
     AREXPORT void addHandler(const char *messageID, ArNMEAParser::Handler *handler);
     AREXPORT void removeHandler(const char *messageID);
 
+    /** Set a handler for an NMEA message that is given the message fields in
+     * place (see ViewMessage) instead of a copy of them.  A message ID may have 
+     * both a handler and a view handler, in which case both are called 
+     * (the view handler first).
+     * @param messageID ID of NMEA sentence/message, without two-letter "talker" prefix.
+     * @param handler Handler object
+     */
+    AREXPORT void addViewHandler(const char *messageID, ArNMEAParser::ViewHandler *handler);
+    AREXPORT void removeViewHandler(const char *messageID);
+
     /* Read a chunk of input text from the given device connection and 
      * parse with parse(char*, int).  The maximum amount of text read from the device
      * connection is determined by the internal buffer size in this class
@@ -118,6 +182,16 @@ public:
      * @return a result code from ParseFlags
      */
     AREXPORT int parse(const char *buf, size_t n);
+    /** Counts of the sentences seen by parse() */
+    struct Stats {
+      unsigned long sentences = 0; ///< Complete sentences found (including dropped ones)
+      unsigned long handled = 0; ///< Sentences given to a handler
+      unsigned long dropped = 0; ///< Sentences skipped because of a bad or missing checksum, a syntax error, too many or too long fields, or because they were cut off by the start of another
+    };
+    /** Get the sentence counts since the parser was created or resetStats() was called */
+    const ArNMEAParser::Stats& getStats() const { return myStats; }
+    /** Set the sentence counts back to 0 */
+    void resetStats() { myStats = Stats(); }
 
     
 
@@ -130,58 +204,71 @@ public:
         @sa getHandlersRef()
      */
     typedef std::map<std::string, ArNMEAParser::Handler*> HandlerMap;
+    /** Map of message identifiers to view handler functors. @sa getViewHandlersRef() */
+    typedef std::map<std::string, ArNMEAParser::ViewHandler*> ViewHandlerMap;
 
 private:
     /* NMEA message handlers used by ArNMEAParser */
     HandlerMap myHandlers;
+    ViewHandlerMap myViewHandlers;
 
-    std::map<std::string, std::string> myLastPrefix;
+    /* The handlers are looked up while parsing through this table, which is
+     * rebuilt from the maps above when handlers are added or removed. It's an
+     * open addressing hash table (linear probing, size a power of two at
+     * least twice the number of IDs), so finding a handler is a hash of the
+     * few ID characters and usually one compare.
+     */
+    struct HandlerSlot {
+      std::string id;
+      ArNMEAParser::Handler *handler = nullptr;
+      ArNMEAParser::ViewHandler *viewHandler = nullptr;
+      char lastPrefix[2] = {0, 0};
+    };
+    std::vector<HandlerSlot> myHandlerTable;
+    void rebuildHandlerTable();
+    HandlerSlot *findHandlerSlot(const char *id, size_t len);
+    static size_t hashID(const char *id, size_t len);
 
 public:
     /** Return a const reference to the set of message handlers.
         See HandlerMap type definition.
     */
     const ArNMEAParser::HandlerMap& getHandlersRef() const { return myHandlers; }
+    /** Return a const reference to the set of view message handlers. */
+    const ArNMEAParser::ViewHandlerMap& getViewHandlersRef() const { return myViewHandlers; }
 
 private:
 
     const char *myName;
 
     /*  NMEA scanner state.
-     *  There are possabilities for optimization here, such 
-     *  as just storing the read data in a buffer and handling
-     *  each field as it is found in the buffer, or building
-     *  a list of char* for each field pointing into the buffer
-     *  instead of copying each field into a std::string in the
-     *  currentMessage vector, etc. etc.
+     *  Complete messages are found in the text given to parse() and
+     *  split into fields in place, in one pass that also computes
+     *  the checksum.  Only a message that is split across calls to
+     *  parse() is copied (into myPartial) until the rest of it arrives.
      */
     const unsigned short MaxNumFields;
     const unsigned short MaxFieldSize; // bytes
     bool ignoreChecksum;
 
+    std::vector<char> myPartial;
+    size_t myPartialSize;
+    ArTime myPartialStarted;
+
+    std::vector<Field> myFields;
     MessageVector currentMessage;
-    ArTime currentMessageStarted;
-    std::string currentField;
-    char checksumBuf[3];
-    short checksumBufOffset;
-    bool inChecksum;
-    bool inMessage;
-    char currentChecksum;
-    bool gotCR;
-
-    // Tools to update state
-    void beginMessage();
-    void endMessage();
-    void nextField();
-    void beginChecksum();
+    Stats myStats;
+
+    // Frame one message, from '$' to '\n' inclusive, and call its handlers
+    int parseMessage(const char *msg, size_t len, const ArTime& started);
 
     /* Data buffer used by handleInput(ArDeviceConnection*).
      * This should be enough to hold several NMEA messages. 
-     * Most NMEA messages should be less than 50 bytes or so; 
-     * 256 then allows a minumum of 5 messages parsed per 
+     * Most NMEA messages should be less than 80 bytes or so; 
+     * 512 then allows a minumum of 6 messages parsed per 
      * call to parse(arDeviceConnection*).)
      */
-    char myReadBuffer[256]; //[512];
+    char myReadBuffer[512];
 
 };
 
@@ -33,6 +33,7 @@ class ArRobot;
 class ArBasePacket;
 class ArRobotPacket;
 class ArDeviceConnection;
+class ArThreadPool;
 
 
 /// Base class which handles the PTZ cameras
@@ -78,6 +79,13 @@ class ArDeviceConnection;
     read at all by default, and you're on your own for reading the
     data in (ie like your own thread).
 
+    Normally each command is written to the device as soon as it is
+    given, in the caller's thread.  A program that moves the camera
+    many times a second (like a tracking loop) can instead call
+    enableCommandPipeline(), which queues commands and writes them from
+    a thread pool, dropping moves that have been superseded by a newer
+    one before they went out.  See enableCommandPipeline().
+
   @ingroup OptionalClasses
    @ingroup DeviceClasses
 
@@ -110,24 +118,25 @@ public:
   /// Pans to the given degrees. 0 is straight ahead, - is to the left, + to the right
   virtual bool pan(double degrees) 
   {
+    CommandScope cmd(this, COMMAND_PAN);
     if(myInverted) {
-      return pan_i(-degrees);
+      return cmd.finish(pan_i(-degrees));
     } else {
-      return pan_i(degrees); 
+      return cmd.finish(pan_i(degrees)); 
     }
   }
   /// Pans relative to current position by given degrees
-  virtual bool panRel(double degrees) { if(myInverted) return panRel_i(-degrees); else return panRel_i(degrees); }
+  virtual bool panRel(double degrees) { CommandScope cmd(this, COMMAND_RELATIVE); if(myInverted) return cmd.finish(panRel_i(-degrees)); else return cmd.finish(panRel_i(degrees)); }
 
   /// Tilts to the given degrees. 0 is middle, - is downward, + is upwards.
-  virtual bool tilt(double degrees) { if(myInverted) return tilt_i(-degrees); else return tilt_i(degrees); }
+  virtual bool tilt(double degrees) { CommandScope cmd(this, COMMAND_TILT); if(myInverted) return cmd.finish(tilt_i(-degrees)); else return cmd.finish(tilt_i(degrees)); }
   /// Tilts relative to the current position by given degrees
-  virtual bool tiltRel(double degrees)  { if(myInverted)  return tiltRel_i(-degrees); else return tiltRel_i(degrees); }
+  virtual bool tiltRel(double degrees)  { CommandScope cmd(this, COMMAND_RELATIVE); if(myInverted)  return cmd.finish(tiltRel_i(-degrees)); else return cmd.finish(tiltRel_i(degrees)); }
 
   /// Pans and tilts to the given degrees
-  virtual bool panTilt(double degreesPan, double degreesTilt) { if(myInverted) return panTilt_i(-degreesPan, -degreesTilt); else return panTilt_i(degreesPan,  degreesTilt); }
+  virtual bool panTilt(double degreesPan, double degreesTilt) { CommandScope cmd(this, COMMAND_PANTILT); if(myInverted) return cmd.finish(panTilt_i(-degreesPan, -degreesTilt)); else return cmd.finish(panTilt_i(degreesPan,  degreesTilt)); }
   /// Pans and tilts relatives to the current position by the given degrees
-  virtual bool panTiltRel(double degreesPan, double degreesTilt) { if(myInverted) return panTiltRel_i(-degreesPan, -degreesTilt); else return panTiltRel_i(degreesPan,  degreesTilt); }
+  virtual bool panTiltRel(double degreesPan, double degreesTilt) { CommandScope cmd(this, COMMAND_RELATIVE); if(myInverted) return cmd.finish(panTiltRel_i(-degreesPan, -degreesTilt)); else return cmd.finish(panTiltRel_i(degreesPan,  degreesTilt)); }
 
   /// Returns true if camera can zoom and this class can control the zoom amount
   AREXPORT virtual bool canZoom() const = 0;
@@ -325,7 +334,156 @@ public:
   /// Set ArRobot object this PTZ is associated with. May be NULL
   void setRobot(ArRobot* r) { myRobot = r; }
 
+  /// What happened to a command given while the pipeline is enabled
+  enum CommandStatus {
+    COMMAND_DONE, ///< Written (and answered, if the driver tracks responses)
+    COMMAND_SUPERSEDED, ///< Replaced by a newer move of the same kind before it was written
+    COMMAND_DROPPED, ///< Not queued because the queue was full
+    COMMAND_FAILED, ///< The write failed or the device answered with an error
+    COMMAND_TIMED_OUT, ///< The device didn't answer in time
+    COMMAND_CANCELED ///< Still queued (or unanswered) when the pipeline was disabled
+  };
+  /// Identifies a command given while the pipeline is enabled, 0 is never used
+  typedef unsigned long CommandId;
+
+  /// Queues commands and writes them from a thread pool instead of the caller's thread
+  /**
+     Once this is called the pan, tilt and zoom calls (and anything
+     else the driver sends with sendPacket()) never wait on the
+     device, they put the command in a queue and return.  Commands are
+     written in order by a task on @a pool.  If a pan, tilt, pan/tilt
+     or zoom to an absolute position is given while an earlier one of
+     the same kind (or, for pan/tilt, a pan or tilt) is still in the
+     queue, the earlier one is dropped (COMMAND_SUPERSEDED) so the
+     device only goes to where it was last told; relative moves and
+     other commands are never dropped this way.
+
+     If the driver can match the device's answers to commands (see
+     canTrackCommandResponses(), ArRVisionPTZ does) up to @a
+     maxInFlight commands are written before their answers arrive, and
+     the next one goes out as soon as an answer comes in, so the link
+     stays busy without overrunning the device.  A command that hasn't
+     been answered after @a responseTimeoutMSecs fails with
+     COMMAND_TIMED_OUT.  Answers are read by readPacket() from the robot
+     loop (see setDeviceConnection()), or, if nothing else reads the
+     connection, by the pipeline itself while commands are waiting.
+     Drivers that can't track answers treat a command as done once it
+     is written.
+
+     Use setCommandCallback() to find out what happened to each command
+     and getLastCommandId() to get the id of the command just given.
+
+     This should be called before commands are given from other
+     threads, and not while another thread is giving commands.
+
+     @param maxQueued how many commands can wait to be written, further
+     ones (that don't supersede a queued one) are dropped and the call
+     that gave them returns false
+     @param maxInFlight how many commands can be waiting for an answer
+     @param responseTimeoutMSecs how long to wait for an answer
+     @param pool the pool to write from, if NULL ArThreadPool::getShared()
+     @return false if @a maxQueued or @a maxInFlight is 0
+  **/
+  AREXPORT bool enableCommandPipeline(size_t maxQueued = 8,
+				      unsigned int maxInFlight = 2,
+				      unsigned int responseTimeoutMSecs = 500,
+				      ArThreadPool *pool = NULL);
+  /// Stops queueing, commands that haven't been written or answered are canceled
+  AREXPORT void disableCommandPipeline();
+  /// Whether enableCommandPipeline() has been called
+  bool isCommandPipelineEnabled() const { return myPipeline != NULL; }
+  /// Sets a callback called with each command's id and what happened to it
+  /**
+     The callback is called once per command, from the thread pool, the
+     thread that read the device's answer, or (for superseded and
+     dropped commands) the thread giving the command, so it should
+     return quickly and not give PTZ commands itself.  It isn't owned.
+  **/
+  AREXPORT void setCommandCallback(ArFunctor2<CommandId, CommandStatus> *cb);
+  /// Gets the id of the command queued by the last call, 0 if it didn't queue one
+  AREXPORT CommandId getLastCommandId();
+  /// Gets how many commands are waiting to be written
+  AREXPORT size_t getNumQueuedCommands();
+  /// Gets how many commands have been written and are waiting for an answer
+  AREXPORT size_t getNumInFlightCommands();
+  /// Waits until every queued command has been written and answered (and its callback called)
+  /**
+     This is for shutting down and tests; normal code shouldn't need to
+     wait.
+     @return true if the queue emptied, false if @a msecs passed first
+     (or the pipeline isn't enabled)
+  **/
+  AREXPORT bool waitForCommands(unsigned int msecs);
+  /// Gets a name for a command status, for logging
+  AREXPORT static const char *commandStatusName(CommandStatus status);
+
 protected:
+  /// What a command does, so the pipeline knows which can be superseded
+  enum CommandKind {
+    COMMAND_OTHER, ///< Never superseded
+    COMMAND_RELATIVE, ///< A relative move, never superseded
+    COMMAND_PAN, ///< Absolute pan
+    COMMAND_TILT, ///< Absolute tilt
+    COMMAND_PANTILT, ///< Absolute pan and tilt
+    COMMAND_ZOOM ///< Absolute zoom
+  };
+
+  /// Groups everything sent by one call into one pipeline command
+  /**
+     The public pan/tilt calls use one of these around their _i
+     implementation, drivers that override zoom() (or add other
+     commands) can use one the same way.  Nested scopes are part of the
+     outer one.  This does nothing if the pipeline isn't enabled.
+  **/
+  class CommandScope
+  {
+  public:
+    CommandScope(ArPTZ *ptz, CommandKind kind, bool expectResponse = true) :
+      myPTZ(NULL)
+    {
+      if (ptz->myPipeline != NULL && ptz->beginCommand(kind, expectResponse))
+	myPTZ = ptz;
+    }
+    ~CommandScope() { finish(true); }
+    /// Ends the scope, returns @a ok if the command was queued and false otherwise
+    bool finish(bool ok)
+    {
+      if (myPTZ == NULL)
+	return ok;
+      ArPTZ *ptz = myPTZ;
+      myPTZ = NULL;
+      return ptz->endCommand() && ok;
+    }
+  private:
+    ArPTZ *myPTZ;
+  };
+  friend class CommandScope;
+
+  /// Whether the driver reports answers with commandAccepted() and commandCompleted()
+  virtual bool canTrackCommandResponses() const { return false; }
+  /// Called by the driver when the device acknowledges the oldest unacknowledged command
+  /**
+     @param responseKey what the device will use to refer to this
+     command when it completes (for instance a VISCA socket number)
+  **/
+  AREXPORT void commandAccepted(int responseKey);
+  /// Called by the driver when the device says a command is finished
+  /**
+     @param responseKey the key given to commandAccepted(), or -1 for
+     the oldest unacknowledged command
+     @param succeeded false if the device answered with an error
+  **/
+  AREXPORT void commandCompleted(int responseKey, bool succeeded);
+  /// Writes data straight to the camera (via robot or serial port), bypassing the pipeline
+  AREXPORT bool writeToDevice(const char *data, unsigned int length);
+  /// Internal, used by CommandScope
+  AREXPORT bool beginCommand(CommandKind kind, bool expectResponse);
+  /// Internal, used by CommandScope
+  AREXPORT bool endCommand();
+
+  class CommandPipeline;
+  friend class CommandPipeline;
+
   ArRobot *myRobot;
   ArDeviceConnection *myConn;
   ArFunctorC<ArPTZ> myConnectCB;
@@ -341,6 +499,8 @@ protected:
   double myMaxNegTilt;
   int myMaxZoom;
   int myMinZoom;
+  bool myReadFromRobotLoop;
+  CommandPipeline *myPipeline;
 
   /// Subclasses call this to set extents (limits) returned by getMaxPosPan(), getMaxNegPan(), getMaxPosTilt(), getMaxNegTilt(), getMaxZoom(), and getMinZoom().
   /// @since 2.7.6
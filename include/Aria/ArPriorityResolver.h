@@ -25,23 +25,89 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #define ARPRIORITYRESOLVER_H
 
 #include "Aria/ArResolver.h"
+#include "Aria/ArLog.h"
+#include <vector>
+#include <utility>
 
 /// (Default resolver), takes the action list and uses the priority to resolve
 /** 
     This is the default resolver for ArRobot, meaning if you don't do a 
     non-normal init on the robot, or a setResolver, you'll have one these.
+
+    The resolver keeps its own copy of the action list sorted from
+    highest to lowest priority in a contiguous array, which it only
+    rebuilds when ArRobot tells it the actions changed (see
+    ArResolver::actionsChanged()) or when the map it is handed doesn't
+    hold the same actions at the same priorities anymore (which also
+    catches edits made through ArRobot::getActionMap()), so the robot
+    cycle doesn't rebuild it every time.
+
+    Tracing can be turned on with setTracing(), after which every
+    resolve() records what each active action asked for and how long
+    its fire() took into a buffer that is preallocated by setTracing(),
+    so it can be left on in a running program to profile the actions.
+    Use getTrace() or logTrace() to see the last cycle.
 */
 class ArPriorityResolver final : public ArResolver
 {
 public:
+  /// What one action requested in one resolve(), see setTracing()
+  struct TraceEntry
+  {
+    /// The name of the action (owned by the action)
+    const char *actionName;
+    /// The priority it was added with
+    int priority;
+    /// Whether fire() returned anything
+    bool fired;
+    /// How long fire() took, in microseconds
+    long long usecs;
+    /// Requested translational velocity and its strength
+    double vel, velStrength;
+    /// Requested delta heading and its strength
+    double deltaHeading, deltaHeadingStrength;
+    /// Requested rotational velocity and its strength
+    double rotVel, rotVelStrength;
+    /// Requested lateral velocity and its strength
+    double latVel, latVelStrength;
+  };
   /// Constructor
   AREXPORT ArPriorityResolver();
   //AREXPORT virtual ~ArPriorityResolver();
   AREXPORT virtual ArActionDesired *resolve(ArResolver::ActionMap *actions,
 					    ArRobot *robot,
 					    bool logActions = false) override;
+  /// Rebuilds the sorted action array on the next resolve()
+  AREXPORT virtual void actionsChanged() override;
+  /// Turns the per action trace on or off
+  /**
+     @param tracing whether to record a trace in each resolve()
+     @param maxEntries how many actions to record per resolve(), the
+     buffer is allocated here and actions past this many are not traced
+  */
+  AREXPORT void setTracing(bool tracing, size_t maxEntries = 64);
+  /// Gets whether the per action trace is on
+  bool getTracing() const { return myTracing; }
+  /// Gets the trace from the last resolve() (empty if tracing is off)
+  const std::vector<TraceEntry> &getTrace() const { return myTrace; }
+  /// Gets how long the last resolve() took in microseconds (only measured while tracing)
+  long long getLastResolveUSecs() const { return myLastResolveUSecs; }
+  /// Logs the trace from the last resolve()
+  AREXPORT void logTrace(ArLog::LogLevel level = ArLog::Normal) const;
 protected:
+  AREXPORT void rebuildSortedActions(ArResolver::ActionMap *actions);
+  AREXPORT bool sortedActionsMatch(const ArResolver::ActionMap *actions) const;
   ArActionDesired myActionDesired;
+  ArActionDesired myAveraging;
+  // the actions from highest to lowest priority
+  std::vector<std::pair<int, ArAction *> > mySortedActions;
+  ArResolver::ActionMap *mySortedFrom = NULL;
+  bool myActionsChanged = true;
+
+  bool myTracing = false;
+  std::vector<TraceEntry> myTrace;
+  size_t myTraceMaxEntries = 0;
+  long long myLastResolveUSecs = 0;
 };
 
 #endif // ARPRIORITYRESOLVER_H
@@ -108,7 +108,8 @@ public:
   /// Gets the field of view at minimum zoom
   AREXPORT virtual double getFOVAtMinZoom() override { return 48.8; }
 
-  //virtual ArBasePacket* readPacket();
+  /// Reads the camera's acknowledgements and completions for the command pipeline
+  AREXPORT virtual ArBasePacket* readPacket() override;
   constexpr static double MAX_PAN = 180; ///< maximum degrees the unit can pan (clockwise from top)
   constexpr static double MIN_PAN = -180; ///< minimum degrees the unit can pan (counterclockwise from top)
   constexpr static double   MIN_TILT = -30; ///< minimum degrees the unit can tilt
@@ -126,6 +127,9 @@ public:
 #endif
 protected:
   void initializePackets();
+  void handleResponse();
+  /// VISCA acknowledges each command with a socket number and then completes it on that socket
+  virtual bool canTrackCommandResponses() const override { return true; }
   double myPan;
   double myTilt;
   int myZoom;
@@ -138,6 +142,9 @@ protected:
   ArRVisionPacket myPanTiltPacket;
   ArRVisionPacket myInquiryPacket;
   const char *mySerialPort;
+  // the reply being read by readPacket()
+  unsigned char myResponse[16];
+  size_t myResponseLength;
 
   ///@since 2.7.6
   static ArPTZ* create(size_t index, ArPTZParams params, ArArgumentParser *parser, ArRobot *robot);
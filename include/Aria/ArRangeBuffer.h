@@ -62,6 +62,13 @@ public:
   /// Gets the current number of readings stored in the buffer.
   size_t getCurrentSize() { return myBuffer.size(); }
 
+  /** Gets a counter that changes whenever readings are added, moved or
+   *  removed.  Something that caches a view of the buffer (such as
+   *  ArLaser's polar index) can compare this against the value it saw
+   *  when it built the cache to know when to rebuild it.
+   */
+  unsigned long long getChangeCount() const { return myChangeCount; }
+
   /// Sets the size (capacity) of the buffer
   [[deprecated]] void setSize(size_t size) { setCapacity(size); }
 
@@ -154,6 +161,7 @@ public:
   PUBLICDEPRECATED("Use ArRangeBuffer::getBuffer() or ArRangeBuffer::getBegin() and ArRangeBuffer::getEnd() instead") 
   std::list<ArPoseWithTime> *getBufferPtr()
   {
+    ++myChangeCount; // caller may modify the list through the pointer
     return &myBuffer;
   }
 
@@ -173,6 +181,33 @@ public:
 				ArPose *readingPos = NULL,
 				ArPose targetPose = ArPose(0, 0, 0)) const;
 
+  /// Gets the closest point, on a polar system, from arrays of x and y coordinates
+  /**
+     This is what getClosestPolar() uses, on plain arrays of global
+     coordinates instead of the buffer.  It compares each point against
+     the edges of the sector instead of finding each point's angle, so
+     the loop has no trig in it and can be vectorized.
+     @param index if not NULL, set to the index of the closest point
+     (only if one was found)
+  */
+  AREXPORT static double getClosestPolarInArrays(
+	  const double *xs, const double *ys, size_t num,
+	  double startAngle, double endAngle, const ArPose& position, 
+	  unsigned int maxRange, double *angle = NULL, size_t *index = NULL);
+  /// Gets the closest point in a box, in LOCAL coords, from arrays of x and y coordinates
+  /**
+     This is what getClosestBox() uses, on plain arrays of global
+     coordinates instead of the buffer.  The points are transformed in
+     blocks with the array ArTransform::doTransform().
+     @param index if not NULL, set to the index of the closest point
+     (only if one was found)
+  */
+  AREXPORT static double getClosestBoxInArrays(
+	  const double *xs, const double *ys, size_t num,
+	  double x1, double y1, double x2, double y2, const ArPose& position,
+	  unsigned int maxRange, ArPose *readingPos = NULL,
+	  ArPose targetPose = ArPose(0, 0, 0), size_t *index = NULL);
+
   /// For ArRangeDevice implementations: Applies a transform to all readings in the buffer
   AREXPORT void applyTransform(const ArTransform& trans);
 
@@ -235,6 +270,7 @@ protected:
   bool myHitEnd;
   
   size_t myCapacity;
+  unsigned long long myChangeCount = 0;
 
   std::vector<ArPoseWithTime> myVector; // copy of myBuffer, recreated whenever getBufferAsVector() is called.  TODO remove
 };
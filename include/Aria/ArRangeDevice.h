@@ -29,6 +29,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArSensorReading.h"
 #include "Aria/ArDrawingData.h"
 #include "Aria/ArMutex.h"
+#include "Aria/ArSharedMutex.h"
 #include <set>
 
 class ArRobot;
@@ -448,6 +449,20 @@ public:
   /// Unlock this device
   virtual int unlockDevice() {return(myDeviceMutex.unlock());}
 
+  /** Lock this device for reading.  Any number of threads can hold a
+      shared lock at once, so use this instead of lockDevice() around
+      code that only reads the buffers (with the const accessors), such
+      as currentReadingPolar() or looking through getCurrentBuffer().
+      The device's own thread still locks it with lockDevice() to
+      change the buffers, and gets it ahead of any new readers.
+      @see ArSharedMutex
+  */
+  virtual int lockDeviceShared() { return(myDeviceMutex.lockShared());}
+  /// Try to lock this device for reading, see lockDeviceShared()
+  virtual int tryLockDeviceShared() {return(myDeviceMutex.tryLockShared());}
+  /// Unlock this device after lockDeviceShared()
+  virtual int unlockDeviceShared() {return(myDeviceMutex.unlockShared());}
+
   /// Lock this device. Same as lockDevice().
   virtual int lock() { return(myDeviceMutex.lock());}
   /// Try to lock this device. Same as tryLockDevice().
@@ -480,6 +495,13 @@ protected:
   **/
   AREXPORT void adjustRawReadings(bool interlaced);
 
+  /// (Re)registers the buffer size gauges under the current name
+  AREXPORT void registerMetrics();
+  /// Gets the number of readings in the current buffer, for ArMetrics
+  AREXPORT double getCurrentBufferSizeMetric();
+  /// Gets the number of readings in the cumulative buffer, for ArMetrics
+  AREXPORT double getCumulativeBufferSizeMetric();
+
 
 
   ArRobot *myRobot = nullptr;
@@ -513,11 +535,13 @@ protected:
   std::string myName;
 
   ArFunctorC<ArRangeDevice> myFilterCB;
+  ArRetFunctorC<double, ArRangeDevice> myCurrentBufferSizeMetricCB;
+  ArRetFunctorC<double, ArRangeDevice> myCumulativeBufferSizeMetricCB;
 
   ArRangeBuffer myCurrentBuffer;
   ArRangeBuffer myCumulativeBuffer;
 
-  ArMutex myDeviceMutex;
+  ArSharedMutex myDeviceMutex;
 
   unsigned int myMaxRange; 
   int myMaxSecondsToKeepCurrent;
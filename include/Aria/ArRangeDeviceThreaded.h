@@ -34,6 +34,9 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
     multipleInheritance from both ArASyncTask and ArRangeDevice any
     more since JAVA doesn't support this and the wrapper software
     can't deal with it.  Its still functionally the same however.
+
+    The device is locked with the ArRangeDevice's lockDevice() and
+    lockDeviceShared(), not the thread's own mutex.
  **/
 class ArRangeDeviceThreaded : public ArRangeDevice
 {
@@ -62,9 +65,6 @@ public:
   AREXPORT virtual bool getRunningWithLock() 
     { return myTask.getRunningWithLock(); }
 
-  AREXPORT virtual int lockDevice() { return myTask.lock(); }
-  AREXPORT virtual int tryLockDevice() { return myTask.tryLock(); }
-  AREXPORT virtual int unlockDevice() { return myTask.unlock(); }
 protected:
   ArRetFunctor1C<void *, ArRangeDeviceThreaded, void *> myRunThreadCB;
   ArFunctorASyncTask myTask;
@@ -0,0 +1,111 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARRECORDINGDEVICECONNECTION_H
+#define ARRECORDINGDEVICECONNECTION_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ArMutex.h"
+#include <chrono>
+#include <stdio.h>
+#include <string>
+
+/// Passes everything through to another connection and records what was read and written
+/**
+   This wraps another ArDeviceConnection (which it does not own): use it
+   in place of that connection (e.g. give it to the ArRobot or ArLaser
+   instead) and everything read from and written to the device is also
+   saved in a recording file, with when it happened.  An
+   ArReplayDeviceConnection can then play the recording back, at the
+   original speed or as fast as it's read, for testing or benchmarking
+   without the device.
+
+   The recording is a compact binary file: a header (the
+   FileMagic string and FileVersion) followed by one record per read or
+   write.  Each record is a type byte (RecordRead, RecordWrite or
+   RecordReadError), the microseconds since the previous record and the
+   number of bytes (both as unsigned LEB128 varints), then the bytes.
+   Times are from a monotonic clock.  Reads that get no data are not
+   recorded.
+**/
+class ArRecordingDeviceConnection : public ArDeviceConnection
+{
+public:
+  /// Recording file header
+  static constexpr const char *FileMagic = "ARDEVREC";
+  /// Length of FileMagic
+  static constexpr size_t FileMagicLength = 8;
+  /// Version of the recording file, after FileMagic
+  static constexpr unsigned char FileVersion = 1;
+  /// Types of record in the file
+  enum RecordType {
+    RecordRead = 'R', ///< Bytes read from the device
+    RecordWrite = 'W', ///< Bytes written to the device
+    RecordReadError = 'E' ///< A read failed
+  };
+
+  /// Constructor
+  AREXPORT ArRecordingDeviceConnection(ArDeviceConnection *conn = NULL);
+  /// Destructor, finishes the recording (but doesn't close the connection)
+  AREXPORT virtual ~ArRecordingDeviceConnection();
+  ArRecordingDeviceConnection(const ArRecordingDeviceConnection &) = delete;
+  ArRecordingDeviceConnection &operator=(const ArRecordingDeviceConnection &) = delete;
+
+  /// Sets the connection to pass everything through to
+  AREXPORT void setConnection(ArDeviceConnection *conn);
+  /// Gets the connection everything is passed through to
+  ArDeviceConnection *getConnection() const { return myConn; }
+
+  /// Starts recording to a file (replacing it)
+  AREXPORT bool startRecording(const char *fileName);
+  /// Finishes the recording
+  AREXPORT void stopRecording();
+  /// Gets whether we're recording
+  AREXPORT bool isRecording() const;
+  /// Gets how many records have been written
+  AREXPORT unsigned long getNumRecords() const;
+
+  AREXPORT virtual int read(const char *data, unsigned int size, 
+			    unsigned int msWait = 0) override;
+  AREXPORT virtual int write(const char *data, unsigned int size) override;
+  AREXPORT virtual int getStatus() override;
+  AREXPORT virtual bool openSimple() override;
+  AREXPORT virtual bool close() override;
+  AREXPORT virtual const char *getOpenMessage(int messageNumber) override;
+  AREXPORT virtual ArTime getTimeRead(int index) override;
+  AREXPORT virtual bool isTimeStamping() override;
+  AREXPORT virtual int getFD() const override;
+protected:
+  void record(RecordType type, const char *data, unsigned int size);
+  void writeVarint(unsigned long long value);
+
+  ArDeviceConnection *myConn;
+  mutable ArMutex myMutex;
+  FILE *myFile;
+  std::string myFileName;
+  std::chrono::steady_clock::time_point myLastRecordTime;
+  unsigned long myNumRecords;
+};
+
+#endif // ARRECORDINGDEVICECONNECTION_H
@@ -30,6 +30,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArFunctor.h"
 #include "Aria/ArThread.h"
 #include "Aria/ArASyncTask.h"
+#include "Aria/ArThreadPool.h"
 
 /// Recurrent task (runs in its own thread)
 /**
@@ -50,6 +51,16 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
    kill() kills off the thread, shouldn't be used unless exiting the 
    async task permanently
 
+   If the task is constructed with an ArThreadPool it doesn't get a
+   thread of its own, instead each go() runs task() on one of the
+   pool's workers.  A task body running in a pool can't be interrupted,
+   so reset() and kill() only mark the task as canceled (done() returns
+   2) and the body finishes in the background; the destructor waits
+   for it (but by then the derived class is already destroyed, so its
+   destructor should wait for done() to be nonzero first if task() uses
+   its members).  task() implementations that loop for a long time should
+   check done() or getRunning() if they want to stop early.
+
    @ingroup UtilityClasses
 */
 class ArRecurrentTask : public ArASyncTask
@@ -57,6 +68,8 @@ class ArRecurrentTask : public ArASyncTask
 public:
   /// Constructor
   AREXPORT ArRecurrentTask();
+  /// Constructor for a task that runs on @a pool instead of its own thread
+  AREXPORT ArRecurrentTask(ArThreadPool *pool);
   /// Descructor
   AREXPORT ~ArRecurrentTask();	
   /// The main run loop
@@ -81,6 +94,12 @@ private:
   bool running;			// true if currently running
   bool go_req;			// run request
   bool killed;			// did we get killed by request?
+
+  void runPooled();		// one go() (or more) on a pool worker
+  ArThreadPool *myPool;		// pool we run in, or NULL for our own thread
+  ArThreadPool::TaskId myPoolTask; // our current run in the pool
+  bool myInPool;		// a run is queued or running in the pool
+  ArFunctorC<ArRecurrentTask> myPoolCB;
 };
 
 
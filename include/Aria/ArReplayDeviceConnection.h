@@ -0,0 +1,119 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARREPLAYDEVICECONNECTION_H
+#define ARREPLAYDEVICECONNECTION_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ArMutex.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+/// Plays back a recording made with ArRecordingDeviceConnection
+/**
+   Use this in place of a device's real connection (e.g. give it to an
+   ArRobot or an ArLaser) and reads return the data that was read from
+   the device when the recording was made, in the same chunks, so the
+   whole processing pipeline can be run again without the device.
+
+   With a speed of 1 (the default) data is returned no sooner than it
+   was originally read, relative to the first read() after opening (or
+   rewind()) which gets the first recorded data right away.  Other speeds scale that (2 is twice as fast), and a speed
+   of 0 returns everything as fast as it is read, for benchmarking.
+   Once all of the recording has been read, read() returns 0 and
+   atEnd() is true.
+
+   Writes aren't sent anywhere, but are compared with what was written
+   when the recording was made, so a regression test can check that
+   the same commands were sent (see getNumWriteMismatches()).
+**/
+class ArReplayDeviceConnection : public ArDeviceConnection
+{
+public:
+  /// Constructor
+  AREXPORT ArReplayDeviceConnection();
+  /// Destructor
+  AREXPORT virtual ~ArReplayDeviceConnection();
+
+  /// Loads a recording, returns 0 on success or an OpenError
+  AREXPORT int open(const char *fileName);
+  /// Errors from open()
+  enum OpenError {
+    OPEN_FILE_NOT_FOUND = 1, ///< Couldn't open the file
+    OPEN_BAD_FORMAT ///< Not a recording (or an unsupported version)
+  };
+  /// Sets the playback speed, 1 for the original timing, 0 for as fast as possible
+  AREXPORT void setSpeed(double speed);
+  /// Gets the playback speed
+  AREXPORT double getSpeed() const;
+  /// Starts playing back from the beginning again
+  AREXPORT void rewind();
+  /// Gets whether all of the recorded reads have been returned
+  AREXPORT bool atEnd() const;
+  /// Gets how many reads and writes were recorded
+  AREXPORT size_t getNumRecords() const;
+  /// Gets how long the recording is, in microseconds
+  AREXPORT long long getRecordingUSecs() const;
+  /// Gets how many writes have been compared with the recording
+  AREXPORT unsigned long getNumWrites() const;
+  /// Gets how many writes didn't match what was recorded
+  AREXPORT unsigned long getNumWriteMismatches() const;
+
+  AREXPORT virtual int read(const char *data, unsigned int size, 
+			    unsigned int msWait = 0) override;
+  AREXPORT virtual int write(const char *data, unsigned int size) override;
+  virtual int getStatus() override { return myStatus; }
+  virtual bool openSimple() override { return open(myFileName.c_str()) == 0; }
+  AREXPORT virtual bool close() override;
+  AREXPORT virtual const char *getOpenMessage(int messageNumber) override;
+  AREXPORT virtual ArTime getTimeRead(int index) override;
+  AREXPORT virtual bool isTimeStamping() override;
+protected:
+  struct Record
+  {
+    char type;
+    /// microseconds since the start of the recording
+    long long usecs;
+    size_t offset;
+    size_t size;
+  };
+  mutable ArMutex myMutex;
+  std::string myFileName;
+  int myStatus;
+  double mySpeed;
+  std::vector<Record> myRecords;
+  std::vector<char> myData;
+  size_t myReadIndex;
+  size_t myReadOffset;
+  size_t myWriteIndex;
+  bool myStarted;
+  std::chrono::steady_clock::time_point myStartTime;
+  /// when the first data was read in the recording
+  long long myFirstReadUSecs;
+  unsigned long myNumWrites;
+  unsigned long myNumWriteMismatches;
+};
+
+#endif // ARREPLAYDEVICECONNECTION_H
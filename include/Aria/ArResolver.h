@@ -52,6 +52,13 @@ public:
   /// Figure out a single ArActionDesired from a list of ArAction s
   virtual ArActionDesired *resolve(ActionMap *actions, ArRobot *robot,
 				   bool logActions = false) = 0;
+  /// Called when the action map given to resolve() has had actions added or removed
+  /**
+     ArRobot calls this from addAction() and remAction().  Resolvers
+     that keep their own copy of the action list (like
+     ArPriorityResolver) should rebuild it on the next resolve().
+  */
+  virtual void actionsChanged() {}
   /// Gets the name of the resolver
   virtual const char *getName() const { return myName.c_str(); }
   /// Gets the long description fo the resolver
@@ -31,6 +31,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArSyncTask.h"
 #include "Aria/ArSensorReading.h"
 #include "Aria/ArMutex.h"
+#include "Aria/ArSharedMutex.h"
 #include "Aria/ArCondition.h"
 #include "Aria/ArSyncLoop.h"
 #include "Aria/ArRobotPacketReaderThread.h"
@@ -40,8 +41,12 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArTransform.h"
 #include "Aria/ArInterpolation.h"
 #include "Aria/ArKeyHandler.h"
+#include "Aria/ArSeqLock.h"
 #include <list>
 #include <vector>
+#include <bitset>
+#include <string>
+#include <atomic>
 
 class ArAction;
 class ArRobotConfigPacketReader;
@@ -54,6 +59,7 @@ class ArLaser;
 class ArBatteryMTX;
 class ArSonarMTX;
 class ArLCDMTX;
+class ArMetricCounter;
 
 /// Central class for communicating with and operating the robot
 /** 
@@ -98,6 +104,38 @@ public:
     CHARGING_FLOAT = 3,
     CHARGING_BALANCE = 4
   };
+
+  /// A consistent copy of the robot's state from one SIP, see getStateSnapshot()
+  struct StateSnapshot
+  {
+    /// Increases by one each time a snapshot is published, 0 if none has been yet
+    unsigned long sequence;
+    /// When the SIP this state came from was received
+    ArTime time;
+    /// Global pose (see getPose())
+    ArPose pose;
+    /// Corrected encoder pose (see getEncoderPose())
+    ArPose encoderPose;
+    /// Raw encoder pose (see getRawEncoderPose())
+    ArPose rawEncoderPose;
+    double vel; ///< see getVel()
+    double rotVel; ///< see getRotVel()
+    double latVel; ///< see getLatVel()
+    double leftVel; ///< see getLeftVel()
+    double rightVel; ///< see getRightVel()
+    double batteryVoltage; ///< see getBatteryVoltage()
+    double realBatteryVoltage; ///< see getRealBatteryVoltage()
+    double stateOfCharge; ///< see getStateOfCharge()
+    ChargeState chargeState; ///< see getChargeState()
+    int stallValue; ///< see getStallValue()
+    bool leftMotorStalled; ///< see isLeftMotorStalled()
+    bool rightMotorStalled; ///< see isRightMotorStalled()
+    int flags; ///< see getFlags()
+    int faultFlags; ///< see getFaultFlags()
+    bool estopPressed; ///< see isEStopPressed()
+  };
+  static_assert(std::is_trivially_copyable<StateSnapshot>::value,
+		"StateSnapshot is kept in an ArSeqLock");
   /// Constructor.
   /// @param unused an old flag no longer used
   AREXPORT ArRobot(const char * name = NULL, UNUSED bool unused = true,
@@ -340,6 +378,13 @@ public:
    *
    */
   ArPose getPose() const { return myGlobalPose; }
+  /// Gets the robot state as of the last SIP, without locking the robot
+  AREXPORT StateSnapshot getStateSnapshot() const;
+  /// Gets the sequence number of the last published state snapshot
+  /** Cheap to poll from any thread to find out whether getStateSnapshot()
+      has new data. @sa getStateSnapshot() */
+  unsigned long getStateSnapshotSequence() const 
+    { return (unsigned long)myStateSnapshot.getNumWrites(); }
   /// Gets the global X position of the robot
   /** @sa getPose() 
       @ingroup easy
@@ -687,6 +732,8 @@ public:
   /// Returns the sonar reading for the given sonar
   /// @ingroup easy
   AREXPORT ArSensorReading *getSonarReading(int num) const;
+  /// Returns the sonar readings that got new data in this robot cycle, in sonar number order
+  AREXPORT const std::vector<ArSensorReading *> &getNewSonarReadings() const;
   /// Returns the closest of the current sonar reading in the given range
   /// @ingroup easy
   AREXPORT int getClosestSonarRange(double startAngle, double endAngle) const;
@@ -1112,11 +1159,36 @@ public:
   AREXPORT void addPacketHandler(
 	  ArRetFunctor1<bool, ArRobotPacket *> *functor, 
 	  ArListPos::Pos position = ArListPos::LAST);
+
+  /// Adds a packet handler that is only given packets with the given IDs
+  AREXPORT void addPacketHandler(
+	  ArRetFunctor1<bool, ArRobotPacket *> *functor, 
+	  const std::vector<unsigned char> &packetIDs,
+	  ArListPos::Pos position = ArListPos::LAST);
   
   /// Removes a packet handler from the list of packet handlers
   AREXPORT void remPacketHandler(
 	  ArRetFunctor1<bool, ArRobotPacket *> *functor);
 
+  /// How often a packet handler has been called and how long it took
+  struct PacketHandlerStats
+  {
+    /// Name of the handler functor (see ArFunctor::setName())
+    std::string name;
+    /// Number of packets the handler was given
+    unsigned long invoked;
+    /// Number of those packets the handler returned true for
+    unsigned long handled;
+    /// Total time spent in the handler (with the robot locked), in microseconds
+    long long usecs;
+  };
+  /// Gets invocation statistics for each packet handler, in handler order
+  AREXPORT std::vector<PacketHandlerStats> getPacketHandlerStats() const;
+  /// Resets the packet handler statistics to zero
+  AREXPORT void resetPacketHandlerStats();
+  /// Logs the packet handler statistics, most time consuming first
+  AREXPORT void logPacketHandlerStats(ArLog::LogLevel level = ArLog::Normal) const;
+
   /// Adds a connect callback
   AREXPORT void addConnectCB(ArFunctor *functor, 
 			     ArListPos::Pos position = ArListPos::LAST);
@@ -1443,12 +1515,24 @@ public:
   int tryLock() {return(myMutex.tryLock());}
   /// Unlock the robot instance
   int unlock() {return(myMutex.unlock());}
+  /** Lock the robot instance for reading.  Other threads that only read
+      the robot's state (with the const accessors, like getPose() or
+      getVel()) can hold it at the same time, while the robot's own
+      thread and anything calling lock() still get it to themselves.
+      A thread holding this must not call lock() until it unlocks.
+      @see ArSharedMutex
+  */
+  int lockShared() {return(myMutex.lockShared());}
+  /// Try to lock the robot instance for reading without blocking
+  int tryLockShared() {return(myMutex.tryLockShared());}
+  /// Unlock the robot instance after lockShared()
+  int unlockShared() {return(myMutex.unlockShared());}
   /// Turn on verbose locking of robot mutex
   void setMutexLogging(bool v) { myMutex.setLog(v); }
   /// Set robot lock warning time (see ArMutex::setLockWarningTime())
-  void setMutexLockWarningTime(double sec) { myMutex.setLockWarningTime(sec); }
+  void setMutexLockWarningTime(double sec) { ArMutex::setLockWarningTime(sec); }
   /// Set robot lock-unlock warning time (see ArMutex::setUnlockWarningTime())
-  void setMutexUnlockWarningTime(double sec) { myMutex.setUnlockWarningTime(sec); }
+  void setMutexUnlockWarningTime(double sec) { ArMutex::setUnlockWarningTime(sec); }
 
   /// This tells us if we're in the preconnection state
   bool isStabilizing() { return myIsStabilizing; }
@@ -1655,6 +1739,20 @@ public:
   /// returns true if handled, false otherwise
   /// @internal
   bool handlePacket(ArRobotPacket *packet);
+  /// Internal function, offers a packet to the packet handlers registered
+  /// for its ID until one handles it
+  /// @internal
+  bool dispatchPacket(ArRobotPacket *packet);
+  /// Internal function, counts a packet in the ArMetrics counters for its ID
+  /// @internal
+  void countPacketMetrics(ArRobotPacket *packet, bool dropped);
+  /// Internal function, copies the current state into the snapshot read
+  /// by getStateSnapshot()
+  /// @internal
+  void publishStateSnapshot();
+  /// Internal function, rebuilds myPacketHandlerTable from myPacketHandlerList
+  /// @internal
+  void rebuildPacketHandlerTable();
 
 #endif // SWIG
 
@@ -1795,9 +1893,34 @@ protected:
   long myPacketsReceivedTrackingCount;
   ArTime myPacketsReceivedTrackingStarted;
   bool myPacketsSentTracking;
-  ArMutex myMutex;
+  ArSharedMutex myMutex;
   ArSyncTask *mySyncTaskRoot;
-  std::vector<ArRetFunctor1<bool, ArRobotPacket *>*> myPacketHandlerList; 
+  struct PacketHandlerInfo
+  {
+    ArRetFunctor1<bool, ArRobotPacket *> *functor;
+    bool allIDs;
+    std::bitset<256> packetIDs;
+    unsigned long invoked;
+    unsigned long handled;
+    long long usecs;
+  };
+  std::vector<PacketHandlerInfo> myPacketHandlerList; 
+  // for each packet ID the handlers (from myPacketHandlerList, in order)
+  // that want it, so handlePacket doesn't offer every packet to everyone
+  std::vector<PacketHandlerInfo *> myPacketHandlerTable[256];
+  unsigned int myPacketHandlerTableChanges;
+  // the handlers dispatchPacket() has offered the current packet to, so
+  // if the table is rebuilt part way through none get it twice (kept
+  // here so it doesn't allocate for every packet)
+  std::vector<ArRetFunctor1<bool, ArRobotPacket *> *> myPacketHandlersTried;
+  // ArMetrics counters for each packet ID, registered when the first
+  // packet with that ID comes in
+  ArMetricCounter *myPacketsReceivedMetrics[256] = {};
+  ArMetricCounter *myPacketsDroppedMetrics[256] = {};
+
+  // only written by publishStateSnapshot(), which is always called with
+  // the robot locked, so there's never more than one writer
+  ArSeqLock<StateSnapshot> myStateSnapshot;
 
   ArSyncLoop mySyncLoop;
   ArRobotPacketReaderThread myPacketReader;
@@ -1838,6 +1961,10 @@ protected:
 
   std::map<int, ArSensorReading *> mySonars;
   int myNumSonar;
+  // the sonar that got new data in cycle myNewSonarsCounter, sorted by number
+  std::vector<int> myNewSonarNumbers;
+  std::vector<ArSensorReading *> myNewSonarReadings;
+  unsigned int myNewSonarsCounter = 0;
   
   unsigned int myCounter;
   bool myIsConnected;
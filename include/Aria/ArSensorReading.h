@@ -223,6 +223,30 @@ coordinate system.
 			bool ignoreThisReading = false,
 			int extraInt = 0);
 
+  /**
+    Update data, with the reading's position already worked out.  This is
+    for range devices that work out the positions of a whole scan at
+    once (see ArLaser::laserFillBeams()) rather than having newData()
+    transform each reading.
+    @param range Sensed distance.
+    @param localReading Position of the reading relative to the robot, as newData() would work it out from the sensor position and @a range.
+    @param reading Position of the reading in global coordinates (@a localReading transformed to the robot's global coordinate system).
+    @param robotPose Robot position in global coordinates space when the sensor data was received.
+    @param encoderPose Robot encoder-only position in global coordinate space when the sensor data was received.
+    @param counter an incrementing counter used to check for updated data
+    @param timeTaken System time when this measurement was taken or received.
+    @param ignoreThisReading Set the "ignore" flag for this reading.
+    @param extraInt extra device-specific data. @see getExtraInt()
+  */
+  AREXPORT void newDataPrecomputed(unsigned int range, 
+				   const ArPose& localReading,
+				   const ArPose& reading,
+				   const ArPose& robotPose,
+				   const ArPose& encoderPose,
+				   unsigned int counter,
+				   const ArTime& timeTaken,
+				   bool ignoreThisReading = false,
+				   int extraInt = 0);
   /// Resets the sensors idea of its physical location on the robot
   AREXPORT void resetSensorPosition(double xPos, double yPos, double thPos,
 				    bool forceComputation = false);
@@ -0,0 +1,117 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARSEQLOCK_H
+#define ARSEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+
+/// Holds a value that one thread writes and any number of threads read without locking
+/**
+   A sequence lock: a writer bumps a counter to an odd number, stores
+   the value and bumps the counter to the next even number.  A reader
+   copies the value and checks the counter was the same even number
+   before and after, and copies again if it wasn't.  The writer never
+   waits for readers, and readers never wait for each other (they only
+   retry if they overlap a write, which for a small value that's written
+   a few dozen times a second is rare).
+
+   The value is kept as an array of atomic words, so readers that
+   overlap a write don't race with it in the C++ memory model sense.
+   @a T must therefore be trivially copyable (plain data, no pointers
+   that own anything), and should be small, since readers copy all of
+   it.  Writes must not happen from two threads at once; serialize them
+   with a mutex if there can be more than one writer.
+
+   @ingroup UtilityClasses
+*/
+template <class T>
+class ArSeqLock
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+		"ArSeqLock can only hold trivially copyable types");
+public:
+  /// Constructor, holds a value initialized T
+  ArSeqLock() : mySeq(0) { write(T()); mySeq.store(0); }
+  ArSeqLock(const ArSeqLock &) = delete;
+  ArSeqLock &operator=(const ArSeqLock &) = delete;
+
+  /// Replaces the value (only one thread may write at a time)
+  void write(const T &value)
+  {
+    uint64_t buf[NUM_WORDS] = {};
+    const unsigned long long seq = mySeq.load(std::memory_order_relaxed);
+
+    memcpy(buf, &value, sizeof(T));
+    mySeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < NUM_WORDS; i++)
+      myWords[i].store(buf[i], std::memory_order_relaxed);
+    mySeq.store(seq + 2, std::memory_order_release);
+  }
+
+  /// Gets a copy of the value, never a half written one
+  T read() const
+  {
+    uint64_t buf[NUM_WORDS];
+    unsigned long long before;
+    unsigned long long after;
+    unsigned int tries = 0;
+    T ret;
+
+    while (true)
+    {
+      before = mySeq.load(std::memory_order_acquire);
+      if ((before & 1) == 0)
+      {
+	for (size_t i = 0; i < NUM_WORDS; i++)
+	  buf[i] = myWords[i].load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	after = mySeq.load(std::memory_order_relaxed);
+	if (before == after)
+	  break;
+      }
+      // the writer may have been preempted in the middle of a write
+      if (++tries % 64 == 0)
+	std::this_thread::yield();
+    }
+    memcpy(&ret, buf, sizeof(T));
+    return ret;
+  }
+
+  /// Gets how many times write() has been called
+  unsigned long long getNumWrites() const
+    { return mySeq.load(std::memory_order_acquire) / 2; }
+
+protected:
+  static constexpr size_t NUM_WORDS = 
+    (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  std::atomic<unsigned long long> mySeq;
+  std::atomic<uint64_t> myWords[NUM_WORDS];
+};
+
+#endif // ARSEQLOCK_H
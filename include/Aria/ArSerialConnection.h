@@ -104,6 +104,9 @@ class ArSerialConnection: public ArDeviceConnection
   };
   AREXPORT virtual ArTime getTimeRead(int index);
   AREXPORT virtual bool isTimeStamping();
+#ifndef _WIN32
+  AREXPORT virtual int getFD() const;
+#endif
 
  protected:
   void buildStrMap();
@@ -0,0 +1,177 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARSHAREDMUTEX_H
+#define ARSHAREDMUTEX_H
+
+#include <atomic>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArMutex.h"
+
+/// Mutex with shared (reader) and exclusive (writer) modes
+/**
+   ArSharedMutex is for data that many threads read but only a few
+   threads change, like a range device's buffers or the robot's state.
+   Any number of threads can hold it with lockShared() at the same time,
+   while lock() gives one thread exclusive access, like ArMutex::lock().
+   Readers then only wait for writers, not for each other.
+
+   Writers are preferred: once a thread is waiting in lock(), new
+   lockShared() calls wait until it has had its turn, so a stream of
+   readers can't keep a producer thread (the robot's packet thread, or a
+   laser's thread) from getting the lock.
+
+   Like ArMutex, the exclusive lock is recursive: the thread that holds
+   it may lock() again, and may also call lockShared() (which just
+   counts as another exclusive lock).  A thread holding a shared lock
+   may take another shared lock even while a writer is waiting, but it
+   may not call lock() until it releases its shared locks; that would
+   deadlock, so lock() logs an error and returns
+   ArMutex::STATUS_FAILED instead.
+
+   Methods return the same codes as ArMutex's.  Lock timing warnings
+   follow ArMutex::setLockWarningTime() and
+   ArMutex::setUnlockWarningTime(), and while ArMutex::setProfiling() is
+   on, locks (shared and exclusive) are counted in the same totals as
+   ArMutex's, under the name given with setLogName().
+
+   @ingroup UtilityClasses
+*/
+class ArSharedMutex
+{
+public:
+  /// Constructor
+  AREXPORT ArSharedMutex();
+  /// Destructor
+  AREXPORT ~ArSharedMutex();
+
+  /// Lock exclusively, blocking while other threads hold it
+  /** @return 0 if locked, ArMutex::STATUS_FAILED if this thread holds a
+      shared lock */
+  AREXPORT int lock();
+  /// Lock exclusively if that can be done without blocking
+  /** @return 0 if locked, ArMutex::STATUS_ALREADY_LOCKED if another
+      thread holds it or a writer is waiting, ArMutex::STATUS_FAILED if
+      this thread holds a shared lock */
+  AREXPORT int tryLock();
+  /// Unlock an exclusive lock
+  AREXPORT int unlock();
+
+  /// Lock shared, blocking while a writer holds it or is waiting for it
+  AREXPORT int lockShared();
+  /// Lock shared if that can be done without blocking
+  /** @return 0 if locked, ArMutex::STATUS_ALREADY_LOCKED if a writer holds
+      it or is waiting for it */
+  AREXPORT int tryLockShared();
+  /// Unlock a shared lock
+  AREXPORT int unlockShared();
+
+  /// Log when we lock and unlock
+  void setLog(bool log) { myLog = log; }
+  /// Sets a name we'll use to log with
+  void setLogName(const char *logName) 
+    { myLogName = logName; myProfile = NULL; }
+#ifndef SWIG
+  /// Sets a name we'll use to log with formatting
+  /** @swigomit use setLogName() */
+  AREXPORT void setLogNameVar(const char *logName, ...);
+#endif
+  /// Gets the name used to log with
+  const char *getLogName() const { return myLogName.c_str(); }
+
+  /// Gets how many shared locks are held (for debugging)
+  AREXPORT int getSharedCount();
+  /// Gets whether some thread holds the exclusive lock (for debugging)
+  AREXPORT bool isLockedExclusive();
+
+  /// @internal What a thread keeps about its shared locks on one mutex
+  struct SharedHeld;
+
+protected:
+  // gets how many shared locks this thread holds on this mutex, and
+  // when it took the first one
+  SharedHeld *threadSharedHeld(bool create);
+  // whether the current thread holds the exclusive lock, myStateMutex
+  // must be locked
+  bool isWriter() const
+    { return myWriting && myWriter == std::this_thread::get_id(); }
+  // takes the exclusive lock, myStateMutex must be locked
+  // (waited is set if it had to wait for another thread)
+  int internalLock(std::unique_lock<std::mutex> &state, bool block,
+		   bool profiling, bool *waited);
+  // takes a shared lock, myStateMutex must be locked
+  int internalLockShared(std::unique_lock<std::mutex> &state, bool block,
+			 bool profiling, bool *waited);
+  // releases the exclusive lock, myStateMutex must be locked, sets
+  // holdUSecs to how long it was held if this was the last unlock and
+  // the lock was profiled (otherwise -1)
+  int internalUnlock(long long *holdUSecs);
+  void logLockTime(const ArTime &started, const char *mode);
+  // adds a lock to the ArMutex profiler's totals for our name
+  void profileLocked(bool contended, long long waitUSecs);
+
+  std::mutex myStateMutex;
+  // readers wait on this for writers to finish
+  std::condition_variable myReadersCond;
+  // writers wait on this for readers and the other writer to finish
+  std::condition_variable myWritersCond;
+  int myReaders = 0;
+  int myWritersWaiting = 0;
+  bool myWriting = false;
+  std::thread::id myWriter;
+  int myWriteDepth = 0;
+  ArTime myWriteLocked;
+  // when the exclusive lock was taken if it was profiled, otherwise -1
+  long long myProfileWriteLockedUSecs = -1;
+  std::atomic<ArMutex::ProfileEntry *> myProfile{NULL};
+  bool myLog = false;
+  std::string myLogName;
+
+  ArSharedMutex(const ArSharedMutex &) = delete;
+  ArSharedMutex &operator=(const ArSharedMutex &) = delete;
+};
+
+/// Holds a shared lock on an ArSharedMutex for the scope it's in
+/** @see ArScopedLock
+    @ingroup UtilityClasses 
+*/
+class ArScopedSharedLock {
+private:
+  ArSharedMutex& mtx;
+public:
+  explicit ArScopedSharedLock(ArSharedMutex& m) : mtx(m) {
+    mtx.lockShared();
+  }
+  ~ArScopedSharedLock() {
+    mtx.unlockShared();
+  }
+  ArScopedSharedLock(const ArScopedSharedLock&) = delete;
+  ArScopedSharedLock& operator=(const ArScopedSharedLock&) = delete;
+};
+
+#endif // ARSHAREDMUTEX_H
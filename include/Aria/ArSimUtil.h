@@ -60,7 +60,7 @@ public:
     myTruePoseFunc(this, &ArSimUtil::getSimTruePose),
     myHaveOdomError(false)
   {
-    myRobot->addPacketHandler(&myPacketCB);
+    myRobot->addPacketHandler(&myPacketCB, {0x62});
     if(myRobot->isConnected())
       connectCB();
     else
@@ -28,6 +28,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArArgumentParser.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArRobotConnector.h"
+#include "Aria/ArDeviceConnectGroup.h"
 
 class ArSonarMTX;
 class ArRobot;
@@ -111,6 +112,13 @@ public:
   AREXPORT bool replaceSonar(ArSonarMTX *sonar, int sonarNumber);
   
   AREXPORT bool disconnectSonars();
+  /// Gets the group connectSonars() uses to connect the sonar boards concurrently
+  /**
+     Use this to set retry and timeout policies for the boards (by sonar
+     number) or to connect them one at a time before connectSonars(),
+     and afterwards to see which boards came up and how long it took.
+  */
+  ArDeviceConnectGroup *getConnectGroup() { return &myConnectGroup; }
 private:
 /// Class that holds information about the sonar data
 class SonarData
@@ -185,6 +193,8 @@ private:
   AREXPORT void logSonarOptions(SonarData *sonardata, bool header = true, bool metaOpts = true) const;
   // Sets the sonar parameters
   bool internalConfigureSonar(SonarData *sonarData);
+  // Connects one sonar board (run by myConnectGroup)
+  bool internalConnectSonar(SonarData *sonarData);
 
   std::string mySonarTypes;
 
@@ -204,6 +214,8 @@ private:
 
   ArLog::LogLevel myInfoLogLevel;
 
+  ArDeviceConnectGroup myConnectGroup;
+
   ArRetFunctor1<bool, const char *> *myTurnOnPowerOutputCB;
   ArRetFunctor1<bool, const char *> *myTurnOffPowerOutputCB;
 
@@ -29,6 +29,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArFunctor.h"
 
 #include "Aria/ArRobot.h"
+#include <vector>
 
 /// Keep track of recent sonar readings from a robot as an ArRangeDevice
 /** 
@@ -68,6 +69,32 @@ public:
   /// (This method is primarily for internal use.)
   AREXPORT virtual void addReading(double x, double y, bool *wasAdded = NULL) override;
 
+  /// Adds a batch of sonar readings to the current and cumulative buffers
+  /**
+     This ends up the same as calling addReading() for each reading in
+     turn, except that readings in an ignore region (see
+     addIgnoreRegion()) are skipped, but it only goes through the
+     cumulative buffer once for the whole batch instead of once per
+     reading.  processReadings() uses this for each robot cycle's new
+     readings.  (This method is primarily for internal use.)
+     @param xs the global x coordinates of the readings
+     @param ys the global y coordinates of the readings
+     @param num how many readings there are
+  */
+  AREXPORT void addReadings(const double *xs, const double *ys, size_t num);
+
+  /// Ignores readings in a rectangle, in global coordinates
+  /**
+     Readings from the robot in any of these are never added to the
+     buffers.  Unlike the ignore reading callback (setIgnoreReadingCB())
+     these are all checked for each cycle's readings at once.
+  */
+  AREXPORT void addIgnoreRegion(double x1, double y1, double x2, double y2);
+  /// Removes all the regions added with addIgnoreRegion()
+  AREXPORT void clearIgnoreRegions();
+  /// Gets how many regions have been added with addIgnoreRegion()
+  size_t getNumIgnoreRegions() const { return myIgnoreRegions.size(); }
+
   /// Sets a callback which if it returns true will ignore the reading
   AREXPORT void setIgnoreReadingCB(ArRetFunctor1<bool, ArPose> *ignoreReadingCB);
  
@@ -86,6 +113,20 @@ protected:
   double myFilterFarDist;	// throw out cumulative readings beyond this far from robot
 
   ArRetFunctor1<bool, ArPose> *myIgnoreReadingCB;
+
+  struct IgnoreRegion
+  {
+    double x1, y1, x2, y2;
+  };
+  std::vector<IgnoreRegion> myIgnoreRegions;
+
+  // scratch space for processReadings() and addReadings(), kept around
+  // so they don't allocate every cycle
+  std::vector<double> myBatchXs;
+  std::vector<double> myBatchYs;
+  std::vector<char> myBatchCurrent;
+  std::vector<char> myBatchCumulative;
+  std::vector<char> myBatchKeepCumulative;
 };
 
 
@@ -30,6 +30,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArRobot.h"
 #include "Aria/ArRobotPacket.h"
 
+class ArDeviceReactor;
+
 
 
 // Packets are in the format of 
@@ -211,6 +213,18 @@ public:
   // reading was received
   AREXPORT virtual void internalGotReading();
 
+  /// Reads the sonar packets from one of @a reactor's threads instead of our own thread
+  /**
+     Call this before connecting.  Once connected the sonar's connection
+     is added to @a reactor, which calls the sonar whenever there is
+     data, so the sonar doesn't need a thread of its own.  Pass NULL to
+     go back to using our own thread.  (Not available on Windows.)
+     @return false if the sonar is connected
+  */
+  AREXPORT bool setReactor(ArDeviceReactor *reactor);
+  /// Gets the reactor set with setReactor(), or NULL
+  ArDeviceReactor *getReactor() const { return myReactor; }
+
 protected:
   AREXPORT bool sendAlive();
   AREXPORT bool sendReset();
@@ -496,6 +510,11 @@ private:
   void sensorInterp();
   void failedToConnect();
   void clear();
+  void startReading();
+  void stopReactorReading();
+  void reactorReadable(ArDeviceConnection *conn);
+  void reactorIdle(ArDeviceConnection *conn);
+  void reactorCheckLostConnection();
   bool myIsConnected;
   bool myTryingToConnect;
   bool myStartConnect;
@@ -597,6 +616,12 @@ enum Commands  : uint8_t {
   ArFunctorC<ArSonarMTX> mySensorInterpTask;
   ArRetFunctorC<bool, ArSonarMTX> myAriaExitCB;
 
+  ArDeviceReactor *myReactor = NULL;
+  // the connection is in myReactor (so our own thread isn't running)
+  bool myReactorReading = false;
+  ArFunctor1C<ArSonarMTX, ArDeviceConnection *> myReactorReadableCB;
+  ArFunctor1C<ArSonarMTX, ArDeviceConnection *> myReactorIdleCB;
+
 };
 
 
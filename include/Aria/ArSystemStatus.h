@@ -29,10 +29,9 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArFunctor.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArMutex.h"
+#include "Aria/ArThreadPool.h"
 #include <string>
 
-class ArSystemStatusRefreshThread;
-
 /** @brief Utility to get statistics about the  host operating system
  *  (CPU usage, wireless link data, etc).
  *
@@ -53,17 +52,19 @@ class ArSystemStatusRefreshThread;
 class ArSystemStatus {
 public:
 
-  /** Create a new thread which periodically invalidates cached data,
+  /** Start a periodic task (on ArThreadPool::getShared()) which
+   *  periodically invalidates cached data,
    *  causing it to be recalculated when next accessed.  Starting
-   *  this thread is optional; start it if you 
+   *  this task is optional; start it if you 
    *  will be accessing the data frequently, so that is doesn't need to
    *  be re-read and re-calculated on each access. If you will only be 
    *  accessing the data occasionally, you do not need to start the update
-   *  thread, it will be updated each time you read a value.
+   *  task, it will be updated each time you read a value.
+   *  If it's already started this changes its refresh frequency.
    */
   AREXPORT static void startPeriodicUpdate(int refreshFrequency = 5000, ArLog::LogLevel logLevel = ArLog::Verbose);
 
-  /** Stop periodic update thread. Henceforth any access of data will
+  /** Stop periodic update task. Henceforth any access of data will
    *  cause it to be re-read and recalculated. */
   AREXPORT static void stopPeriodicUpdate();
 
@@ -207,7 +208,9 @@ private:
 	static void refreshMTXWireless(); ///< Refresh MTX Wireless stats, if neccesary
 
 
-	static ArSystemStatusRefreshThread* ourPeriodicUpdateThread;
+	static void periodicUpdate(); ///< Run by the periodic update task
+	static ArGlobalFunctor ourPeriodicUpdateCB;
+	static ArThreadPool::TaskId ourPeriodicUpdateTask;
 	static bool ourShouldRefreshWireless;
 	static bool ourShouldRefreshCPU;
 
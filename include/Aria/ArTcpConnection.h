@@ -56,6 +56,7 @@ class ArTcpConnection final : public ArDeviceConnection
   AREXPORT virtual const char * getOpenMessage(int messageNumber) override;
   AREXPORT virtual ArTime getTimeRead(int index) override;
   AREXPORT virtual bool isTimeStamping() override;
+  AREXPORT virtual int getFD() const override;
 
   /// Gets the name of the host connected to
   AREXPORT std::string getHost();
@@ -0,0 +1,202 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#ifndef ARTHREADPOOL_H
+#define ARTHREADPOOL_H
+
+#include "Aria/ariaTypedefs.h"
+#include "Aria/ArFunctor.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ArThread;
+
+/// A fixed set of worker threads that run queued and scheduled functors
+/**
+   Many Aria objects (ArRecurrentTask, ArFunctorASyncTask,
+   ArSystemStatus::startPeriodicUpdate()) used to get a thread each,
+   even though they spend nearly all their time asleep.  An
+   ArThreadPool instead runs short pieces of work on a small number of
+   worker threads: submit() runs a functor as soon as a worker is free,
+   schedule() runs it after a delay, and schedulePeriodic() runs it
+   over and over.  Each returns a TaskId that can be given to cancel().
+
+   Work is kept in one queue ordered by when it is due (and then by
+   the order it was added), so tasks that are due at the same time run
+   in the order they were submitted.  A periodic task is never run by
+   two workers at once; when it finishes it is due again one period
+   after it was due last time, or right away if it has fallen behind
+   (missed runs are skipped, not queued up).
+
+   Functors are not owned by the pool and must stay valid until they
+   have run (or, for periodic tasks, until they are canceled).  Tasks
+   should not block for long, since a blocked task holds a worker; code
+   that waits on a device should keep its own thread (or use
+   ArDeviceReactor).
+
+   getShared() returns a pool that is shared by the whole program
+   (with 2 worker threads, started the first time it's used), which is
+   what Aria's own classes use.  Make a pool of your own for work that
+   should use every processor.  The worker threads show up in ArThread's list of
+   threads, so ArThread::stopAll() (and so Aria::exit()) stops the pool
+   along with everything else.
+
+   @ingroup UtilityClasses
+*/
+class ArThreadPool
+{
+public:
+  /// Identifies a task given to the pool, 0 is never a valid id
+  typedef unsigned long long TaskId;
+
+  /// Constructor, starts the worker threads
+  /**
+     @param name used to name the worker threads and in log messages
+     @param numThreads how many worker threads to run, if 0 then the
+     number of processors (but at least 2)
+  */
+  AREXPORT ArThreadPool(const char *name = "ArThreadPool",
+			unsigned int numThreads = 0);
+  /// Destructor, stops the pool and waits for the workers to exit
+  AREXPORT ~ArThreadPool();
+  ArThreadPool(const ArThreadPool &) = delete;
+  ArThreadPool &operator=(const ArThreadPool &) = delete;
+
+  /// Gets the pool shared by the whole program (created on first use)
+  AREXPORT static ArThreadPool *getShared();
+
+  /// Runs a functor on a worker as soon as one is free
+  AREXPORT TaskId submit(ArFunctor *functor);
+  /// Runs a functor on a worker once, after a delay
+  AREXPORT TaskId schedule(ArFunctor *functor, unsigned int delayMSecs);
+  /// Runs a functor on a worker every @a periodMSecs until it is canceled
+  AREXPORT TaskId schedulePeriodic(ArFunctor *functor,
+				   unsigned int periodMSecs,
+				   unsigned int firstDelayMSecs = 0);
+  /// Cancels a task so that it won't run (again)
+  /**
+     @param id the task to cancel
+     @param waitIfRunning if the task is running right now, wait for it
+     to finish before returning (unless this is called from the task
+     itself)
+     @return true if the task was waiting to run or running, false if
+     it had already finished or was never given to this pool
+  */
+  AREXPORT bool cancel(TaskId id, bool waitIfRunning = true);
+  /// Returns true if the task hasn't finished (or been canceled) yet
+  AREXPORT bool isPending(TaskId id);
+
+  /// Stops the pool, tasks that haven't started won't be run
+  /**
+     Tasks that are running are allowed to finish.  The pool can't be
+     started again.
+  */
+  AREXPORT void stop();
+  /// Returns false once the pool has been stopped
+  AREXPORT bool isRunning();
+
+  /// Tells the pool about an ArThread object whose work runs on the pool
+  /**
+     Objects added here have stopRunning() called on them when the pool
+     is stopped (including by ArThread::stopAll()).  Used by
+     ArFunctorASyncTask::runInPool().
+  */
+  AREXPORT void addPooledThread(ArThread *thread);
+  /// Removes an object added with addPooledThread()
+  AREXPORT void remPooledThread(ArThread *thread);
+
+  /// Gets the name of the pool
+  const char *getName() const { return myName.c_str(); }
+  /// Gets the number of worker threads
+  unsigned int getNumThreads() const { return myNumThreads; }
+  /// Gets the number of tasks that are waiting to run or running
+  AREXPORT size_t getNumPending();
+  /// Gets the number of times a task has been run since the pool started
+  AREXPORT unsigned long long getNumRun();
+
+protected:
+  class Worker;
+  friend class Worker;
+  typedef std::chrono::steady_clock Clock;
+
+  // one entry in the queue
+  struct Entry
+  {
+    Clock::time_point due;
+    unsigned long long seq;
+    TaskId id;
+  };
+  // what we know about a task that hasn't finished
+  struct Task
+  {
+    ArFunctor *functor;
+    Clock::duration period;
+    bool running;
+    bool canceled;
+    std::thread::id runningIn;
+  };
+  // the queue is a min-heap on (due, seq), this orders it
+  struct Later
+  {
+    bool operator()(const Entry &a, const Entry &b) const
+    {
+      if (a.due != b.due)
+	return a.due > b.due;
+      return a.seq > b.seq;
+    }
+  };
+
+  TaskId add(ArFunctor *functor, Clock::duration delay,
+	     Clock::duration period);
+  void push(Clock::time_point due, TaskId id);
+  void workerLoop(Worker *worker);
+  void workerExited();
+  void stopFromThread();
+
+  std::string myName;
+  unsigned int myNumThreads;
+  std::mutex myMutex;
+  // signaled when there's new work or we're stopping
+  std::condition_variable myWorkCond;
+  // signaled when a task finishes or a worker exits
+  std::condition_variable myDoneCond;
+  bool myRunning;
+  std::vector<Entry> myQueue;
+  // tasks that haven't finished, canceled ones are erased from here
+  // and skipped when they come up in the queue
+  std::map<TaskId, Task> myTasks;
+  TaskId myLastId;
+  unsigned long long mySeq;
+  unsigned long long myNumRun;
+  std::vector<Worker *> myWorkers;
+  unsigned int myNumLiveWorkers;
+  std::set<ArThread *> myPooledThreads;
+};
+
+#endif // ARTHREADPOOL_H
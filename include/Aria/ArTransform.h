@@ -154,6 +154,27 @@ public:
   /// @deprecated use std::transform(poseList, t) where t is an ArTransform object or a lambda or function that captures an ArTransform object and makes the desired call to transform and replace the desired pose in the list. 
   /// Take a std::list of sensor readings and do the transform on it
   AREXPORT void doTransform(std::list<ArPoseWithTime *> *poseList);
+
+  /// Transforms arrays of points into abs coordinates
+  /**
+     Does the same as doTransform() on each point, without needing an
+     ArPose for each, on plain arrays that the compiler can vectorize.
+     The output arrays may be the same as the input arrays.
+     @param xIn the x coordinates of the points to transform
+     @param yIn the y coordinates of the points to transform
+     @param xOut where to put the transformed x coordinates
+     @param yOut where to put the transformed y coordinates
+     @param num how many points there are
+  */
+  AREXPORT void doTransform(const double *xIn, const double *yIn, 
+			    double *xOut, double *yOut, size_t num) const;
+  /// Transforms arrays of points from abs coordinates into local ones
+  /**
+     Does the same as doInvTransform() on each point, see the
+     array doTransform().
+  */
+  AREXPORT void doInvTransform(const double *xIn, const double *yIn, 
+			       double *xOut, double *yOut, size_t num) const;
   
   /// Sets the transform so points in this coord system transform to abs world coords
   ///   @param pose the coord system from which we transform to abs world coords
@@ -33,6 +33,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaTypedefs.h"
 #include "Aria/ArSerialConnection.h"
 #include "Aria/ArTcpConnection.h"
+#include "Aria/ArRecordingDeviceConnection.h"
+#include "Aria/ArReplayDeviceConnection.h"
 #include "Aria/ArLog.h"
 //#include "Aria/ArRobotPacket.h"
 //#include "Aria/ArRobotPacketSender.h"
@@ -40,6 +42,10 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 //#include "Aria/ArRobotConfigPacketReader.h"
 //#include "Aria/ArRobotTypes.h"
 #include "Aria/ariaUtil.h"
+#include "Aria/ArSharedMutex.h"
+#include "Aria/ArSeqLock.h"
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArMetrics.h"
 #include "Aria/ArArgumentBuilder.h"
 #include "Aria/ArArgumentParser.h"
 #include "Aria/ArFileParser.h"
@@ -96,6 +102,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArForbiddenRangeDevice.h"
 //#include "Aria/ArTCM2.h"
 #if !defined(WIN32) && !defined(SWIGWIN)
+#include "Aria/ArDeviceReactor.h"
 #include "Aria/ArMTXIO.h"
 #endif
 #include "Aria/ArActionGotoStraight.h"
@@ -124,6 +131,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArGPSCoords.h"
 #include "Aria/ArLaser.h"
 #include "Aria/ArRobotConnector.h"
+#include "Aria/ArDeviceConnectGroup.h"
 #include "Aria/ArLaserConnector.h"
 #include "Aria/ArSonarConnector.h"
 #include "Aria/ArBatteryConnector.h"
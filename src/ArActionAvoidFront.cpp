@@ -70,7 +70,7 @@ AREXPORT ArActionAvoidFront::ArActionAvoidFront(const char *name,
 
 } */
 
-AREXPORT ArActionDesired *ArActionAvoidFront::fire(ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionAvoidFront::fire(const ArActionDesired &currentDesired)
 {
   double dist, angle;
 
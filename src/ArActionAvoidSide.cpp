@@ -54,7 +54,7 @@ AREXPORT ArActionAvoidSide::ArActionAvoidSide(const char *name,
 } */
 
 AREXPORT ArActionDesired *ArActionAvoidSide::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   double leftDist, rightDist;
 
@@ -44,7 +44,7 @@ AREXPORT ArActionConstantVelocity::ArActionConstantVelocity(const char *name,
 } */
 
 AREXPORT ArActionDesired *ArActionConstantVelocity::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -190,7 +190,7 @@ AREXPORT void ArActionDeceleratingLimiter::addToConfig(ArConfig *config,
 }
 
 AREXPORT ArActionDesired *
-ArActionDeceleratingLimiter::fire(ArActionDesired currentDesired)
+ArActionDeceleratingLimiter::fire(const ArActionDesired &currentDesired)
 {
   double dist = 0.0;
   const ArRangeDevice *distRangeDevice = NULL;
@@ -76,7 +76,7 @@ AREXPORT void ArActionDriveDistance::setDistance(
 
 
 AREXPORT ArActionDesired *ArActionDriveDistance::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   double distToGo;
   double vel;
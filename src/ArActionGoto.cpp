@@ -83,7 +83,7 @@ AREXPORT void ArActionGoto::setGoal(ArPose goal)
   myOldGoal = myGoal;
 }
 
-AREXPORT ArActionDesired *ArActionGoto::fire(ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionGoto::fire(const ArActionDesired &currentDesired)
 {
   double angle;
   double dist;
@@ -77,7 +77,7 @@ AREXPORT void ArActionIRs::setRobot(ArRobot *robot)
     cycleCounters.push_back(1);
 }
 
-AREXPORT ArActionDesired *ArActionIRs::fire(UNUSED ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionIRs::fire(UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -69,7 +69,7 @@ AREXPORT void ArActionInput::clear()
 }
 
 AREXPORT ArActionDesired *ArActionInput::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
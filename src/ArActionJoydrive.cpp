@@ -140,7 +140,7 @@ AREXPORT void ArActionJoydrive::setThrottleParams(double lowSpeed, double highSp
   myHighThrottle = highSpeed;
 }
 
-AREXPORT ArActionDesired *ArActionJoydrive::fire(UNUSED ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionJoydrive::fire(UNUSED const ArActionDesired &currentDesired)
 {
   double rot, trans, throttle;
 
@@ -196,7 +196,7 @@ AREXPORT void ArActionKeydrive::deactivate()
   myTurnAmount = 0;
 }
 
-AREXPORT ArActionDesired *ArActionKeydrive::fire(ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionKeydrive::fire(const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -70,7 +70,7 @@ AREXPORT ArActionLimiterBackwards::ArActionLimiterBackwards(
 } */
 
 AREXPORT ArActionDesired *
-ArActionLimiterBackwards::fire(UNUSED ArActionDesired currentDesired)
+ArActionLimiterBackwards::fire(UNUSED const ArActionDesired &currentDesired)
 {
   double dist;
   double maxVel;
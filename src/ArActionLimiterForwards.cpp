@@ -86,7 +86,7 @@ AREXPORT void ArActionLimiterForwards::setParameters(double stopDistance,
 }
 
 AREXPORT ArActionDesired *
-ArActionLimiterForwards::fire(UNUSED ArActionDesired currentDesired)
+ArActionLimiterForwards::fire(UNUSED const ArActionDesired &currentDesired)
 {
   double dist;
   double maxVel;
@@ -91,7 +91,7 @@ AREXPORT void ArActionLimiterRot::addToConfig(ArConfig *config,
 }
 
 AREXPORT ArActionDesired *
-ArActionLimiterRot::fire(UNUSED ArActionDesired currentDesired)
+ArActionLimiterRot::fire(UNUSED const ArActionDesired &currentDesired)
 {
   bool printing = false;
 
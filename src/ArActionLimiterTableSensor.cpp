@@ -39,7 +39,7 @@ AREXPORT ArActionLimiterTableSensor::ArActionLimiterTableSensor(
 } */
 
 AREXPORT ArActionDesired *ArActionLimiterTableSensor::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
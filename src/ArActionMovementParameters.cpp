@@ -184,7 +184,7 @@ AREXPORT void ArActionMovementParameters::addToConfig(ArConfig *config,
 }
 
 AREXPORT ArActionDesired *ArActionMovementParameters::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -238,7 +238,7 @@ AREXPORT void ArActionMovementParametersDebugging::addToConfig(
 }
 
 AREXPORT ArActionDesired *ArActionMovementParametersDebugging::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -343,7 +343,7 @@ AREXPORT void ArActionRatioInput::deactivate()
 }
 
 AREXPORT ArActionDesired *ArActionRatioInput::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   std::multimap<int, ArFunctor *>::iterator it;
   //ArLog::log(ArLog::Normal, "Calling");
@@ -57,7 +57,7 @@ AREXPORT void ArActionRobotJoydrive::setRobot(ArRobot *robot)
   if (myRobot != NULL)
   {
     myRobot->addConnectCB(&myConnectCB);
-    myRobot->addPacketHandler(&myHandleJoystickPacketCB);
+    myRobot->addPacketHandler(&myHandleJoystickPacketCB, {0xF8});
     if (robot->isConnected())
       connectCallback();
   }
@@ -86,7 +86,7 @@ AREXPORT bool ArActionRobotJoydrive::handleJoystickPacket(
   return true;
 }
 
-AREXPORT ArActionDesired *ArActionRobotJoydrive::fire(UNUSED ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionRobotJoydrive::fire(UNUSED const ArActionDesired &currentDesired)
 {
   bool printing = false;
   myDesired.reset();
@@ -104,7 +104,7 @@ void ArActionStallRecover::addSequence(int sequence)
 }
 
 AREXPORT
-ArActionDesired *ArActionStallRecover::fire(ArActionDesired currentDesired)
+ArActionDesired *ArActionStallRecover::fire(const ArActionDesired &currentDesired)
 {
   std::string doingString;
 
@@ -39,7 +39,7 @@ AREXPORT ArActionStop::ArActionStop(const char *name) :
 } */
 
 AREXPORT ArActionDesired *ArActionStop::fire(
-	UNUSED ArActionDesired currentDesired)
+	UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
 
@@ -592,7 +592,7 @@ AREXPORT void ArActionTriangleDriveTo::findTriangle(bool initial,
 }
 
 AREXPORT ArActionDesired *ArActionTriangleDriveTo::fire(
-	ArActionDesired currentDesired)
+	const ArActionDesired &currentDesired)
 {
   myDesired.reset();
   double dist;
@@ -52,7 +52,7 @@ AREXPORT ArActionTurn::ArActionTurn(const char *name, double speedStartTurn,
 
 } */
 
-AREXPORT ArActionDesired *ArActionTurn::fire(UNUSED ArActionDesired currentDesired)
+AREXPORT ArActionDesired *ArActionTurn::fire(UNUSED const ArActionDesired &currentDesired)
 {
   myDesired.reset();
   double turnAmount;
@@ -88,7 +88,7 @@ void ArAnalogGyro::stabilizingCallback()
     myHaveGottenData = false;
     // moved these two here from above
     myRobot->setEncoderCorrectionCallback(&myEncoderCorrectCB);
-    myRobot->addPacketHandler(&myHandleGyroPacketCB);
+    myRobot->addPacketHandler(&myHandleGyroPacketCB, {0x98});
 
     myScalingFactor = myRobot->getRobotParams()->getGyroScaler();  
     
@@ -77,6 +77,10 @@ AREXPORT ArArgumentBuilder::ArArgumentBuilder(size_t argvLen,
   myIgnoreNormalSpaces = ignoreNormalSpaces;
   myIsPreCompressQuotes = isPreCompressQuotes;
   myIsQuiet = false;
+  myArena = NULL;
+  myArenaSize = 0;
+  myArenaUsed = 0;
+  myArenaWanted = 0;
 }
 
 AREXPORT ArArgumentBuilder::ArArgumentBuilder(const ArArgumentBuilder & builder)
@@ -88,6 +92,10 @@ AREXPORT ArArgumentBuilder::ArArgumentBuilder(const ArArgumentBuilder & builder)
   myArgvLen = builder.getArgvLen();
   myOrigArgc = myArgc;
   myArgv = new char *[myArgvLen];
+  myArena = NULL;
+  myArenaSize = 0;
+  myArenaUsed = 0;
+  myArenaWanted = 0;
   for (i = 0; i < myArgc; i++) {
     myArgv[i] = cppstrdup(builder.getArg(i));
     assert(myArgv[i]);
@@ -108,10 +116,11 @@ AREXPORT ArArgumentBuilder &ArArgumentBuilder::operator=(const ArArgumentBuilder
     if (myOrigArgc > 0)
     {
       for (i = 0; i < myOrigArgc; ++i)
-        //delete[] myArgv[i];
-        free(myArgv[i]); // allocated by strdup()
+        freeArg(myArgv[i]);
     }
     delete[] myArgv;
+    myArenaUsed = 0;
+    myArenaWanted = 0;
 
     // Then copy new stuff...
     myFullString = builder.myFullString;
@@ -139,9 +148,76 @@ AREXPORT ArArgumentBuilder::~ArArgumentBuilder()
   if (myOrigArgc > 0)
   {
     for (i = 0; i < myOrigArgc; ++i)
-      delete[] myArgv[i]; // allocated either by new[] or cppstrdup() which uses new[].
+      freeArg(myArgv[i]); // allocated either from the arena, by new[] or by cppstrdup() which uses new[].
   }
   delete[] myArgv;
+  delete[] myArena;
+}
+
+/**
+   Removes all arguments and the full and extra strings, so that the builder
+   can be reused for another line of input without being destroyed and
+   reconstructed.  Storage for arguments added after the first reset() is
+   carved out of a single block owned by the builder, which grows to the
+   largest size needed by any previous use, so that a builder that is reset
+   and refilled for every line (e.g. by ArFileParser) stops allocating once it
+   has seen the longest line.  Arguments already returned by getArg() or
+   getArgv() are invalid after reset().
+**/
+AREXPORT void ArArgumentBuilder::reset()
+{
+  size_t i;
+  for (i = 0; i < myOrigArgc; ++i)
+    freeArg(myArgv[i]);
+  myArgc = 0;
+  myOrigArgc = 0;
+  myFullString.clear();
+  myExtraString.clear();
+  myFirstAdd = true;
+
+  // grow the arena to hold everything the last use needed; nothing
+  // lives in it at this point
+  if (myArenaWanted > myArenaSize)
+  {
+    delete[] myArena;
+    myArenaSize = myArenaWanted;
+    myArena = new char[myArenaSize];
+  }
+  else if (myArena == NULL)
+  {
+    myArenaSize = 256;
+    myArena = new char[myArenaSize];
+  }
+  myArenaUsed = 0;
+  myArenaWanted = 0;
+}
+
+char *ArArgumentBuilder::allocArg(size_t size)
+{
+  myArenaWanted += size;
+  if (myArena != NULL && myArenaUsed + size <= myArenaSize)
+  {
+    char *ret = myArena + myArenaUsed;
+    myArenaUsed += size;
+    return ret;
+  }
+  return new char[size];
+}
+
+char *ArArgumentBuilder::dupArg(const char *str)
+{
+  size_t size = strlen(str) + 1;
+  char *ret = allocArg(size);
+  memcpy(ret, str, size);
+  return ret;
+}
+
+void ArArgumentBuilder::freeArg(char *arg)
+{
+  // arena storage is released all at once by reset() or the destructor
+  if (myArena != NULL && arg >= myArena && arg < myArena + myArenaSize)
+    return;
+  delete[] arg;
 }
 
 
@@ -375,7 +451,7 @@ AREXPORT void ArArgumentBuilder::internalAdd(const char *str, int position)
         // at the end if its too far out
         if (addAtEnd)
         {
-          myArgv[myArgc] = new char[i - curArgStartIndex + 1];
+          myArgv[myArgc] = allocArg(i - curArgStartIndex + 1);
           strncpy(myArgv[myArgc], &buf[curArgStartIndex], i - curArgStartIndex);
           myArgv[myArgc][i - curArgStartIndex] = '\0';
           // add to our full string
@@ -402,7 +478,7 @@ AREXPORT void ArArgumentBuilder::internalAdd(const char *str, int position)
           myArgc++;
           myOrigArgc = myArgc;
 
-          myArgv[position] = new char[i - curArgStartIndex + 1];
+          myArgv[position] = allocArg(i - curArgStartIndex + 1);
           strncpy(myArgv[position], &buf[curArgStartIndex], i - curArgStartIndex);
           myArgv[position][i - curArgStartIndex] = '\0';
           position++;
@@ -531,7 +607,7 @@ AREXPORT void ArArgumentBuilder::internalAddAsIs(const char *str, int position)
   if (addAtEnd)
   {
     size_t size = strlen(str) + 1;
-    myArgv[myArgc] = new char[size];
+    myArgv[myArgc] = allocArg(size);
     strncpy(myArgv[myArgc], str, size);
     myArgv[myArgc][size-1] = '\0';
     
@@ -559,7 +635,7 @@ AREXPORT void ArArgumentBuilder::internalAddAsIs(const char *str, int position)
     myOrigArgc = myArgc;
     
     size_t size = strlen(str) + 1;
-    myArgv[position] = new char[size];
+    myArgv[position] = allocArg(size);
     strncpy(myArgv[position], str, size);
     myArgv[position][size-1] = '\0';
     
@@ -949,8 +1025,8 @@ AREXPORT void ArArgumentBuilder::compressQuoted(bool stripQuotationMarks)
     {
       myNewArg = &myArgv[i][1];
       myNewArg[myNewArg.size() - 1] = '\0';
-      delete[] myArgv[i]; 
-      myArgv[i] = cppstrdup(myNewArg.c_str());
+      freeArg(myArgv[i]);
+      myArgv[i] = dupArg(myNewArg.c_str());
       assert(myArgv[i]);
       continue;
     }
@@ -990,10 +1066,10 @@ AREXPORT void ArArgumentBuilder::compressQuoted(bool stripQuotationMarks)
         removeArg(i+1);
 
         // and ourself
-        delete[] myArgv[i];
+        freeArg(myArgv[i]);
 
         // but replacing ourself with the new arg
-        myArgv[i] = cppstrdup(myNewArg.c_str());
+        myArgv[i] = dupArg(myNewArg.c_str());
         assert(myArgv[i]);
       }
     }
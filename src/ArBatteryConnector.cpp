@@ -45,6 +45,7 @@ AREXPORT ArBatteryConnector::ArBatteryConnector (
   ArArgumentParser *parser, ArRobot *robot,
   ArRobotConnector *robotConnector, bool autoParseArgs,
   ArLog::LogLevel infoLogLevel) :
+	myConnectGroup ("ArBatteryConnector"),
 	myParseArgsCB (this, &ArBatteryConnector::parseArgs),
 	myLogOptionsCB (this, &ArBatteryConnector::logOptions)
 {
@@ -645,6 +646,7 @@ AREXPORT bool ArBatteryConnector::connectBatteries (
 {
 	std::map<int, BatteryData *>::iterator it;
 	BatteryData *batteryData = NULL;
+	bool ret = true;
 	ArLog::log (myInfoLogLevel,
 	            "ArBatteryConnector::connectBatteries() Connecting batteries");
 	if (myAutoParseArgs && !myParsedArgs) {
@@ -673,6 +675,7 @@ AREXPORT bool ArBatteryConnector::connectBatteries (
 			return false;
 		}
 	}
+	myConnectGroup.clear();
 	for (it = myBatteries.begin(); it != myBatteries.end(); it++) {
 
 		batteryData = (*it).second;
@@ -685,46 +688,68 @@ AREXPORT bool ArBatteryConnector::connectBatteries (
 			            "ArBatteryConnector::connectBatteries: Connecting %s",
 			            batteryData->myBattery->getName());
 			batteryData->myBattery->setRobot (myRobot);
-			bool connected = false;
-			connected = batteryData->myBattery->blockingConnect(myBatteryLogPacketsSent, myBatteryLogPacketsReceived);
-			if (connected) {
-				if (!addAllBatteriesToRobot && addConnectedBatteriesToRobot) {
-					if (myRobot != NULL) {
-						myRobot->addBattery (batteryData->myBattery, batteryData->myNumber);
-						//myRobot->addRangeDevice(batteryData->myBattery);
-						ArLog::log (ArLog::Verbose,
-						            "ArBatteryConnector::connectBatteries: Added %s to robot",
-						            batteryData->myBattery->getName());
-					} else {
-						ArLog::log (ArLog::Normal,
-						            "ArBatteryConnector::connectBatteries: Could not add %s to robot, since there is no robot",
-						            batteryData->myBattery->getName());
-					}
-				} else if (addAllBatteriesToRobot && myRobot != NULL) {
-					ArLog::log (ArLog::Verbose,
-					            "ArBatteryConnector::connectBatteries: %s already added to robot)",
-					            batteryData->myBattery->getName());
-				} else if (myRobot != NULL) {
+			myConnectGroup.addDevice (batteryData->myBattery->getName(),
+			                          batteryData->myNumber,
+			                          new ArRetFunctor1C<bool, ArBatteryConnector, BatteryData *> (
+			                            this, &ArBatteryConnector::internalConnectBattery, batteryData));
+		}
+	}
+
+	// now connect them all at once (unless the group was set not to)
+	myConnectGroup.connectAll();
+	myConnectGroup.logResults (myInfoLogLevel);
+
+	for (const ArDeviceConnectGroup::ConnectResult &result :
+	     myConnectGroup.getResults()) {
+		batteryData = myBatteries[result.number];
+		if (result.connected) {
+			if (!addAllBatteriesToRobot && addConnectedBatteriesToRobot) {
+				if (myRobot != NULL) {
+					myRobot->addBattery (batteryData->myBattery, batteryData->myNumber);
+					//myRobot->addRangeDevice(batteryData->myBattery);
 					ArLog::log (ArLog::Verbose,
-					            "ArBatteryConnector::connectBatteries: Did not add %s to robot",
+					            "ArBatteryConnector::connectBatteries: Added %s to robot",
 					            batteryData->myBattery->getName());
-				}
-			} else {
-				if (!continueOnFailedConnect) {
-					ArLog::log (ArLog::Normal,
-					            "ArBatteryConnector::connectBatteries: Could not connect %s, stopping",
-					            batteryData->myBattery->getName());
-					return false;
-				} else
+				} else {
 					ArLog::log (ArLog::Normal,
-					            "ArBatteryConnector::connectBatteries: Could not connect %s, continuing with remainder of batteries",
+					            "ArBatteryConnector::connectBatteries: Could not add %s to robot, since there is no robot",
 					            batteryData->myBattery->getName());
+				}
+			} else if (addAllBatteriesToRobot && myRobot != NULL) {
+				ArLog::log (ArLog::Verbose,
+				            "ArBatteryConnector::connectBatteries: %s already added to robot)",
+				            batteryData->myBattery->getName());
+			} else if (myRobot != NULL) {
+				ArLog::log (ArLog::Verbose,
+				            "ArBatteryConnector::connectBatteries: Did not add %s to robot",
+				            batteryData->myBattery->getName());
 			}
+		} else {
+			if (!continueOnFailedConnect) {
+				ArLog::log (ArLog::Normal,
+				            "ArBatteryConnector::connectBatteries: Could not connect %s, failing",
+				            batteryData->myBattery->getName());
+				ret = false;
+			} else
+				ArLog::log (ArLog::Normal,
+				            "ArBatteryConnector::connectBatteries: Could not connect %s, continuing with remainder of batteries",
+				            batteryData->myBattery->getName());
 		}
 	}
 	ArLog::log (myInfoLogLevel,
 	            "ArBatteryConnector: Done connecting batteries");
-	return true;
+	return ret;
+}
+
+/**
+   Makes one connection attempt for a battery, this is what
+   connectBatteries() has myConnectGroup call for each battery, so it
+   is run in that battery's own thread.
+   @internal
+**/
+bool ArBatteryConnector::internalConnectBattery (BatteryData *batteryData)
+{
+	return batteryData->myBattery->blockingConnect(myBatteryLogPacketsSent, myBatteryLogPacketsReceived);
 }
 
 AREXPORT bool ArBatteryConnector::disconnectBatteries()
@@ -28,6 +28,9 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArLog.h"
 
 #include <string>
+#include <atomic>
+#include <iterator>
+#include <ctype.h>
 
 
 //#define ARDEBUG_CONFIG
@@ -52,6 +55,17 @@ AREXPORT const char *ArConfig::CATEGORY_FLEET     = "Enterprise";
 AREXPORT const char *ArConfig::CATEGORY_SECURITY  = "Security";
 AREXPORT const char *ArConfig::CATEGORY_DEBUG     = "Debug";
 
+/// Counts section renames (and copies over sections), so that each
+/// ArConfig knows when its section index is stale
+static std::atomic<unsigned long> ourSectionRenames(0);
+
+/// Lowercases a section or parameter name in place, for the name indexes
+static void lowerKey(std::string *key)
+{
+  for (std::string::iterator it = key->begin(); it != key->end(); ++it)
+    *it = (char)tolower(*it);
+}
+
 AREXPORT const char *ArConfig::toCategoryName(const char *categoryName)
 {
   if (categoryName == NULL) {
@@ -137,6 +151,13 @@ AREXPORT ArConfig::ArConfig(const char *baseDirectory,
 
   myCategoryToSectionsMap(),
   mySections(),
+  mySectionIndex(),
+  mySectionIndexCount(0),
+  mySectionIndexDirty(false),
+  mySectionIndexRenames(0),
+  mySectionIndexMutex(),
+  myChangedParams(),
+  myChangedSections(),
 
   myParserCB(this, &ArConfig::parseArgument),
   myVersionCB(this, &ArConfig::parseVersion),
@@ -231,6 +252,13 @@ AREXPORT ArConfig::ArConfig(const ArConfig &config) :
 
   myCategoryToSectionsMap(config.myCategoryToSectionsMap),
   mySections(),
+  mySectionIndex(),
+  mySectionIndexCount(0),
+  mySectionIndexDirty(false),
+  mySectionIndexRenames(0),
+  mySectionIndexMutex(),
+  myChangedParams(),
+  myChangedSections(),
 
   myParserCB(this, &ArConfig::parseArgument),
   myVersionCB(this, &ArConfig::parseVersion),
@@ -562,6 +590,12 @@ AREXPORT void ArConfig::clearSections()
     delete mySections.front();
     mySections.pop_front();
   }
+  {
+    std::lock_guard<std::mutex> lock(mySectionIndexMutex);
+    mySectionIndexDirty = true;
+  }
+  myChangedParams.clear();
+  myChangedSections.clear();
   // Clear this just in case...
   if (mySectionsToParse != NULL)
   {
@@ -919,7 +953,8 @@ AREXPORT bool ArConfig::addParam(const ArConfigArg &arg,
     mySections.push_back(section);
   }
    
-  std::list<ArConfigArg> *params = section->getParams();
+  // only appending, which the section's index keeps up with
+  std::list<ArConfigArg> *params = &section->myParams;
 
   if (params == NULL)
   {
@@ -1418,165 +1453,165 @@ AREXPORT bool ArConfig::parseArgument(ArArgumentBuilder *arg,
     // everything is generally in sections these days
 
     // KMC Note that duplicate parameter names can and do exist within 
-    // a section.  Therefore it is necessary to iterate through all of 
-    // the section contents and check each parameter against the extra
-    // string value.
-    std::list<ArConfigArg> *paramList = section->getParams();
-    if (paramList != NULL) {
+    // a section.  The section keeps an index of every parameter with
+    // each name (in the order they were added), so all of them are found
+    // without walking the whole section.
+    const std::vector<ArConfigArg *> *matches = NULL;
+    if (myParsingListNames.empty()) {
+      matches = section->findParams(arg->getExtraString());
+      if (matches != NULL) {
+        parseParamList.insert(parseParamList.end(), matches->begin(), matches->end());
+      }
+    }
+    else { // parameter is in a list
 
+      std::list<ArConfigArg> *paramList = &section->myParams;
       for (std::list<ArConfigArg>::iterator pIter = paramList->begin();
            pIter != paramList->end();
            ++pIter) {
     
         ArConfigArg *param = &(*pIter);
-        //ArConfigArg *parseParam = NULL;
-    
-        if (myParsingListNames.empty()) {
-          if (ArUtil::strcasecmp(param->getName(),arg->getExtraString()) != 0) {
-            continue;
-          }
-          parseParamList.push_back(param);
 
+        if (ArUtil::strcasecmp(param->getName(), myParsingListNames.front()) != 0) {
+          continue;
         }
-        else { // parameter is in a list
+        std::list<std::string>::iterator listIter = myParsingListNames.begin();
+        ++listIter; // skip the one already parsed
 
-          if (ArUtil::strcasecmp(param->getName(), myParsingListNames.front()) != 0) {
-            continue;
-          }
-          std::list<std::string>::iterator listIter = myParsingListNames.begin();
-          ++listIter; // skip the one already parsed
+        std::list<ArConfigArg*> matchParamList;
+        matchParamList.push_back(param);
 
-          std::list<ArConfigArg*> matchParamList;
-          matchParamList.push_back(param);
+        std::list<ArConfigArg*> tempParamList;
 
-          std::list<ArConfigArg*> tempParamList;
+        while (listIter != myParsingListNames.end()) {
 
-          while (listIter != myParsingListNames.end()) {
-
-            for (std::list<ArConfigArg*>::iterator mIter = matchParamList.begin();
-                 mIter != matchParamList.end();
-                 ++mIter) {
-              ArConfigArg *matchParam = *mIter;
-              if (matchParam == NULL) {
+          for (std::list<ArConfigArg*>::iterator mIter = matchParamList.begin();
+               mIter != matchParamList.end();
+               ++mIter) {
+            ArConfigArg *matchParam = *mIter;
+            if (matchParam == NULL) {
+              continue;
+            }
+            for (size_t i = 0; i < matchParam->getArgCount(); i++) {
+          
+              ArConfigArg *childArg = matchParam->getArg(i);
+              if (childArg == NULL) {
                 continue;
               }
-              for (size_t i = 0; i < matchParam->getArgCount(); i++) {
-            
-                ArConfigArg *childArg = matchParam->getArg(i);
-                if (childArg == NULL) {
-                  continue;
-                }
-                if (ArUtil::strcasecmp(childArg->getName(), *listIter) != 0) {
-                  continue;
-                }
-                tempParamList.push_back(childArg);
+              if (ArUtil::strcasecmp(childArg->getName(), *listIter) != 0) {
+                continue;
               }
-            } // end for each matching parameter list
+              tempParamList.push_back(childArg);
+            }
+          } // end for each matching parameter list
+
+          matchParamList.clear();
+          matchParamList = tempParamList;
+          tempParamList.clear();
+
+          ++listIter;
 
-            matchParamList.clear();
-            matchParamList = tempParamList;
-            tempParamList.clear();
+        } // end for each list level
+        
+        for (std::list<ArConfigArg*>::iterator matchIter = matchParamList.begin();
+             matchIter != matchParamList.end();
+             ++matchIter) {
 
-            ++listIter;
+           ArConfigArg *matchParam = *matchIter;
+           if (matchParam == NULL) {
+             continue;
+           }
 
-          } // end for each list level
+           for (size_t i = 0; i < matchParam->getArgCount(); i++) {
           
-          for (std::list<ArConfigArg*>::iterator matchIter = matchParamList.begin();
-               matchIter != matchParamList.end();
-               ++matchIter) {
-
-             ArConfigArg *matchParam = *matchIter;
-             if (matchParam == NULL) {
-               continue;
-             }
-
-             for (size_t i = 0; i < matchParam->getArgCount(); i++) {
-            
-                ArConfigArg *childArg = matchParam->getArg(i);
-                if (childArg == NULL) {
-                  continue;
-                }
-                if (ArUtil::strcasecmp(childArg->getName(), arg->getExtraString()) != 0) {
-                  continue;
-                }
-                parseParamList.push_back(childArg);
-              } // end for each child
-          } // end for each matching parameter 
-        } // end else parameter is in a list
-
-
-        for (std::list<ArConfigArg*>::iterator parseIter = parseParamList.begin();
-             parseIter != parseParamList.end();
-             ++parseIter) {
-
-          ArConfigArg *parseParam = *parseIter;
-          if (parseParam == NULL) {
-            continue;
-          }
+              ArConfigArg *childArg = matchParam->getArg(i);
+              if (childArg == NULL) {
+                continue;
+              }
+              if (ArUtil::strcasecmp(childArg->getName(), arg->getExtraString()) != 0) {
+                continue;
+              }
+              parseParamList.push_back(childArg);
+            } // end for each child
+        } // end for each matching parameter 
+      } // end for each parameter in section
+    } // end else parameter is in a list
 
-          found = true;
 
-          // Make sure that the parameter is within the specified priority range,
-          // primarily to avoid accidentally overwriting factory and calibration
-          // parameters.  Return true because it is not an error condition.
-          //
-          if ((parseParam->getConfigPriority() < myHighestPriorityToParse) ||
-              (parseParam->getConfigPriority() > myLowestPriorityToParse)) {
-            return true;
-          }
+    for (std::list<ArConfigArg*>::iterator parseIter = parseParamList.begin();
+         parseIter != parseParamList.end();
+         ++parseIter) {
 
-          // KMC 7/11/12 Changed this from an equality check to accomodate the new 
-          // calibration priority
-          if ((myPermissionAllowFactory) ||
-              (parseParam->getConfigPriority() < ArPriority::FACTORY)) {
-      
-	    bool changed = false;
-            if (!parseParam->parseArgument(arg, errorBuffer, errorBufferLen, myLogPrefix.c_str(), myIsQuiet, &changed)) {
+      ArConfigArg *parseParam = *parseIter;
+      if (parseParam == NULL) {
+        continue;
+      }
 
-              ArLog::log(ArLog::Normal,
-                         "ArConfig::parseArgument() error parsing %s",
-                         arg->getFullString());
-              ret = false;
-            }
-	    if (changed)
-	    {
-	      /*
-	      ArLog::log(ArLog::Normal, "%sParameter '%s' changed with restart level (%d)", 
-			 myLogPrefix.c_str(), 
-	      	 parseParam->getName(), parseParam->getRestartLevel());
-	      */
-	      if (parseParam->getRestartLevel() > myRestartLevelNeeded)
-	      {
-		myRestartLevelNeeded = parseParam->getRestartLevel();
-		// don't print out the warning if nothings checking for it
-		if (myCheckingForRestartLevel)
-		  ArLog::log(ArLog::Normal, 
-			     "%sParameter '%s' in section '%s' changed, bumping restart level needed to %s (%d)", 
-			     myLogPrefix.c_str(), parseParam->getName(),
-			     section->getName(),
-			     ArConfigArg::toString(myRestartLevelNeeded),
-			     myRestartLevelNeeded);
-	      }
-	    }
-	      
-	      
-          }
-          else { // factory parameter and no permission to change
-          
-            /// MPL we'll want to do something here, but kathleen and i still have to work out what...
-            /*
-            if (errorBuffer != NULL)
-            snprintf(errorBuffer, errorBufferLen, 
-            "%s is a factory level parameter but those are not allowed to be changed", 
-            param->getName());
-            */      
+      found = true;
 
-          } // end else factory parameter and no permission to change
-        } // end if parameter found
+      // Make sure that the parameter is within the specified priority range,
+      // primarily to avoid accidentally overwriting factory and calibration
+      // parameters.  Return true because it is not an error condition.
+      //
+      if ((parseParam->getConfigPriority() < myHighestPriorityToParse) ||
+          (parseParam->getConfigPriority() > myLowestPriorityToParse)) {
+        return true;
+      }
 
-      } // end for each parameter in section
+      // KMC 7/11/12 Changed this from an equality check to accomodate the new 
+      // calibration priority
+      if ((myPermissionAllowFactory) ||
+          (parseParam->getConfigPriority() < ArPriority::FACTORY)) {
+  
+        bool changed = false;
+        if (!parseParam->parseArgument(arg, errorBuffer, errorBufferLen, myLogPrefix.c_str(), myIsQuiet, &changed)) {
 
-    } // end if parameter list
+          ArLog::log(ArLog::Normal,
+                     "ArConfig::parseArgument() error parsing %s",
+                     arg->getFullString());
+          ret = false;
+        }
+        if (changed)
+        {
+          // note what changed so only the processFileCBs that care run
+          myChangedParams.insert(parseParam);
+          myChangedSections.insert(section);
+          if (!myParsingListNames.empty() &&
+              (matches = section->findParams(myParsingListNames.front().c_str())) != NULL)
+            myChangedParams.insert(matches->begin(), matches->end());
+          /*
+          ArLog::log(ArLog::Normal, "%sParameter '%s' changed with restart level (%d)", 
+                     myLogPrefix.c_str(), 
+                     parseParam->getName(), parseParam->getRestartLevel());
+          */
+          if (parseParam->getRestartLevel() > myRestartLevelNeeded)
+          {
+            myRestartLevelNeeded = parseParam->getRestartLevel();
+            // don't print out the warning if nothings checking for it
+            if (myCheckingForRestartLevel)
+              ArLog::log(ArLog::Normal, 
+                         "%sParameter '%s' in section '%s' changed, bumping restart level needed to %s (%d)", 
+                         myLogPrefix.c_str(), parseParam->getName(),
+                         section->getName(),
+                         ArConfigArg::toString(myRestartLevelNeeded),
+                         myRestartLevelNeeded);
+          }
+        }
+          
+          
+      }
+      else { // factory parameter and no permission to change
+      
+        /// MPL we'll want to do something here, but kathleen and i still have to work out what...
+        /*
+        if (errorBuffer != NULL)
+        snprintf(errorBuffer, errorBufferLen, 
+        "%s is a factory level parameter but those are not allowed to be changed", 
+        param->getName());
+        */      
+
+      } // end else factory parameter and no permission to change
+    } // end for each parameter found
   } // end if section found
 
   // if we didn't find this param its because its a parameter in another section, so pass this off to the parser for unknown things
@@ -2813,6 +2848,124 @@ AREXPORT void ArConfig::remProcessFileCB(
   }
 }
 
+/**
+   Once a processFileCB has dependencies, callProcessFileCallBacks()
+   (and so parseFile() and the other parse methods) only calls it when a
+   value it depends on has changed since the processFileCBs were last
+   called, instead of every time.  It is always called the first time.
+   This can be called more than once to add more dependencies.  Values
+   that are set other than by parsing (e.g. directly through a pointer
+   given to the ArConfigArg) are not noticed.
+
+   @param functor a functor already added with addProcessFileCB()
+
+   @param sectionName the section with the parameter(s) the callback uses
+
+   @param paramName the parameter the callback uses, or NULL if the
+   callback should be called when any parameter in the section changes
+
+   @return false if the functor isn't a processFileCB of this config
+**/
+AREXPORT bool ArConfig::addProcessFileCBDependency(
+	ArRetFunctor<bool> *functor,
+	const char *sectionName,
+	const char *paramName)
+{
+  std::multimap<int, ProcessFileCBType *>::iterator it;
+  for (it = myProcessFileCBList.begin(); it != myProcessFileCBList.end(); ++it)
+  {
+    if ((*it).second->haveFunctor(functor))
+      return addDependency((*it).second, sectionName, paramName);
+  }
+  return addDependency(NULL, sectionName, paramName);
+}
+
+/**
+   @copydoc addProcessFileCBDependency(ArRetFunctor<bool>*, const char*, const char*)
+**/
+AREXPORT bool ArConfig::addProcessFileCBDependency(
+	ArRetFunctor2<bool, char *, size_t> *functor,
+	const char *sectionName,
+	const char *paramName)
+{
+  std::multimap<int, ProcessFileCBType *>::iterator it;
+  for (it = myProcessFileCBList.begin(); it != myProcessFileCBList.end(); ++it)
+  {
+    if ((*it).second->haveFunctor(functor))
+      return addDependency((*it).second, sectionName, paramName);
+  }
+  return addDependency(NULL, sectionName, paramName);
+}
+
+bool ArConfig::addDependency(ProcessFileCBType *callback,
+                             const char *sectionName,
+                             const char *paramName)
+{
+  if (callback == NULL || sectionName == NULL)
+  {
+    ArLog::log(ArLog::Normal, 
+               "%sCannot add dependency on section '%s' to a process file callback that was not added",
+               myLogPrefix.c_str(), (sectionName != NULL) ? sectionName : "");
+    return false;
+  }
+  callback->myDependencies.push_back(
+          std::pair<std::string, std::string>(sectionName,
+                                              (paramName != NULL) ? paramName : ""));
+  // make sure it gets called with everything at least once
+  callback->myHasBeenCalled = false;
+  return true;
+}
+
+bool ArConfig::dependenciesChanged(const ProcessFileCBType *callback) const
+{
+  if (callback->myDependencies.empty() || !callback->myHasBeenCalled)
+    return true;
+  for (std::list<std::pair<std::string, std::string> >::const_iterator it =
+                                          callback->myDependencies.begin();
+       it != callback->myDependencies.end();
+       ++it)
+  {
+    if (hasChangedSinceProcessFile((*it).first.c_str(), 
+                                   (*it).second.empty() ? NULL : (*it).second.c_str()))
+      return true;
+  }
+  return false;
+}
+
+/**
+   Changes are noted as parameters are parsed (from a file, text or an
+   argument parser) and forgotten once callProcessFileCallBacks() has run,
+   so a processFileCB can use this to see which of its parameters changed.
+
+   @param sectionName the section to check
+
+   @param paramName the parameter to check, or NULL to check whether any
+   parameter in the section changed
+**/
+AREXPORT bool ArConfig::hasChangedSinceProcessFile(const char *sectionName,
+                                                   const char *paramName) const
+{
+  ArConfigSection *section = findSection(sectionName);
+  if (section == NULL)
+    return false;
+  if (paramName == NULL)
+    return (myChangedSections.find(section) != myChangedSections.end());
+  if (myChangedSections.find(section) == myChangedSections.end())
+    return false;
+
+  const std::vector<ArConfigArg *> *params = section->findParams(paramName);
+  if (params == NULL)
+    return false;
+  for (std::vector<ArConfigArg *>::const_iterator it = params->begin();
+       it != params->end();
+       ++it)
+  {
+    if (myChangedParams.find(*it) != myChangedParams.end())
+      return true;
+  }
+  return false;
+}
+
 AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
 						 char *errorBuffer,
 						 size_t errorBufferLen)
@@ -2821,6 +2974,9 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
   std::multimap<int, ProcessFileCBType *>::iterator it;
   ProcessFileCBType *callback;
   ArLog::LogLevel level = myProcessFileCallbacksLogLevel;
+  // where we stopped early, if we did
+  std::multimap<int, ProcessFileCBType *>::iterator stoppedIt = 
+                                                  myProcessFileCBList.end();
 
   // reset our section to nothing again
   mySection = "";
@@ -2842,8 +2998,22 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
     {
       ArLog::log(ArLog::Terse, "ArConfig: Encountered a null callback (%d)", -(it->first));
       ret = false;
+      stoppedIt = it;
       break;  
     }
+    if (!dependenciesChanged(callback))
+    {
+      if (callback->getName() != NULL && callback->getName()[0] != '\0')
+        ArLog::log(level, "%sSkipping functor '%s' (%d), nothing it depends on changed", 
+                   myLogPrefix.c_str(),
+                   callback->getName(), -(*it).first);
+      else
+        ArLog::log(level, "%sSkipping unnamed functor (%d), nothing it depends on changed", 
+                   myLogPrefix.c_str(),
+                   -(*it).first);
+      continue;
+    }
+    callback->myHasBeenCalled = true;
     if (callback->getName() != NULL && callback->getName()[0] != '\0')
       ArLog::log(level, "%sProcessing functor '%s' (%d)", 
                  myLogPrefix.c_str(),
@@ -2854,6 +3024,8 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
                  -(*it).first);
     if (!(*it).second->call(errorBuffer, errorBufferLen))
     {
+      // try it again next time even if nothing changes
+      callback->myHasBeenCalled = false;
       //printf("# %s\n", scratchBuffer); 
 
       // if there is an error buffer and it got filled get rid of our
@@ -2870,6 +3042,7 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
           ArLog::log(ArLog::Normal, "ArConfig: Failed, stopping because the '%s' process file callback failed", callback->getName());
         else
           ArLog::log(ArLog::Normal, "ArConfig: Failed, stopping because unnamed process file callback failed");
+        stoppedIt = it;
         break;
       }
       else
@@ -2882,6 +3055,18 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
 
     }
   }
+  // the changes are forgotten below, so if we stopped early the
+  // callbacks that didn't get a turn are treated as never called and
+  // run next time
+  if (stoppedIt != myProcessFileCBList.end())
+  {
+    for (++stoppedIt; stoppedIt != myProcessFileCBList.end(); ++stoppedIt)
+    {
+      if ((*stoppedIt).second != nullptr && 
+          dependenciesChanged((*stoppedIt).second))
+        (*stoppedIt).second->myHasBeenCalled = false;
+    }
+  }
   if (ret || continueOnErrors)
   {
     ArLog::log(level, "%sProcessing with own processFile",
@@ -2892,6 +3077,10 @@ AREXPORT bool ArConfig::callProcessFileCallBacks(bool continueOnErrors,
   ArLog::log(level, "%sDone processing file, ret is %s", myLogPrefix.c_str(),
 	     ArUtil::convertBool(ret));
 
+  // everything parsed so far has now been applied
+  myChangedParams.clear();
+  myChangedSections.clear();
+
   return ret;
 }
 
@@ -2972,6 +3161,9 @@ AREXPORT std::list<std::string> ArConfig::getSectionNames() const
 
 AREXPORT std::list<ArConfigSection *> *ArConfig::getSections()
 {
+  // the caller may remove sections, so don't trust the index after this
+  std::lock_guard<std::mutex> lock(mySectionIndexMutex);
+  mySectionIndexDirty = true;
   return &mySections;
 }
 
@@ -3113,6 +3305,46 @@ AREXPORT ArConfigSection *ArConfig::findSection(const char *sectionName) const
     return NULL;
   }
 
+  // Sections are looked up by lowercased name.  The index catches up
+  // with sections appended since the last lookup, and is rebuilt if
+  // sections may have been removed (clearSections() or getSections())
+  // or renamed.
+  std::lock_guard<std::mutex> lock(mySectionIndexMutex);
+  const unsigned long renames = ourSectionRenames.load();
+  if (mySectionIndexDirty || mySectionIndexCount > mySections.size() ||
+      mySectionIndexRenames != renames)
+  {
+    mySectionIndex.clear();
+    mySectionIndexCount = 0;
+    mySectionIndexDirty = false;
+    mySectionIndexRenames = renames;
+  }
+  if (mySectionIndexCount < mySections.size())
+  {
+    std::list<ArConfigSection *>::const_iterator it = mySections.end();
+    std::advance(it, -(long)(mySections.size() - mySectionIndexCount));
+    for (; it != mySections.end(); ++it)
+    {
+      if (*it == NULL)
+        continue;
+      std::string key = (*it)->getName();
+      lowerKey(&key);
+      // the first section with a name wins, as it does in the list
+      mySectionIndex.insert(std::make_pair(key, *it));
+    }
+    mySectionIndexCount = mySections.size();
+  }
+
+  std::string key = sectionName;
+  lowerKey(&key);
+  std::unordered_map<std::string, ArConfigSection *>::const_iterator found = 
+                                          mySectionIndex.find(key);
+  // make sure the name still matches in case the index is stale
+  if (found != mySectionIndex.end() && 
+      ArUtil::strcasecmp(found->second->getName(), sectionName) == 0)
+    return found->second;
+
+  // not in the index, so check the hard way in case it is stale
   ArConfigSection *section = NULL;
   ArConfigSection *tempSection = NULL;
 
@@ -3137,6 +3369,8 @@ AREXPORT ArConfigSection *ArConfig::findSection(const char *sectionName) const
       break;
     }
   }
+  if (section != NULL)
+    mySectionIndexDirty = true;
   return section;
 
 } // end method findSection
@@ -3334,7 +3568,11 @@ AREXPORT ArConfigSection::ArConfigSection(const char *name,
   myDisplayName(""),
   myFlags(NULL),
   myParams(),
-  myIsQuiet(isQuiet)
+  myIsQuiet(isQuiet),
+  myParamIndex(),
+  myParamIndexCount(0),
+  myParamIndexDirty(false),
+  myParamIndexKey()
 {
   myFlags = new ArArgumentBuilder(512, '|');
   myFlags->setQuiet(myIsQuiet);
@@ -3346,7 +3584,11 @@ AREXPORT ArConfigSection::~ArConfigSection()
 }
 
 
-AREXPORT ArConfigSection::ArConfigSection(const ArConfigSection &section) 
+AREXPORT ArConfigSection::ArConfigSection(const ArConfigSection &section) :
+  myParamIndex(),
+  myParamIndexCount(0),
+  myParamIndexDirty(false),
+  myParamIndexKey()
 {
   myName = section.myName;
   myComment = section.myComment;
@@ -3375,6 +3617,7 @@ AREXPORT ArConfigSection &ArConfigSection::operator=(const ArConfigSection &sect
   {
     
     myName = section.getName();
+    ++ourSectionRenames;
     myComment = section.getComment();
     myCategoryName = section.getCategoryName();
     myDisplayName = section.myDisplayName;
@@ -3390,6 +3633,7 @@ AREXPORT ArConfigSection &ArConfigSection::operator=(const ArConfigSection &sect
     {
       myParams.push_back(*it);
     }
+    myParamIndexDirty = true;
       
     myIsQuiet = section.myIsQuiet;
 
@@ -3404,6 +3648,7 @@ AREXPORT void ArConfigSection::copyAndDetach(const ArConfigSection &section)
   {
     
     myName = section.getName();
+    ++ourSectionRenames;
     myComment = section.getComment();
     myCategoryName = section.getCategoryName();
     myDisplayName = section.myDisplayName;
@@ -3422,6 +3667,7 @@ AREXPORT void ArConfigSection::copyAndDetach(const ArConfigSection &section)
       paramCopy.copyAndDetach(*it);
       myParams.push_back(paramCopy);
     }
+    myParamIndexDirty = true;
 
     myIsQuiet = section.myIsQuiet;
 
@@ -3435,28 +3681,80 @@ AREXPORT void ArConfigSection::copyAndDetach(const ArConfigSection &section)
 AREXPORT ArConfigArg *ArConfigSection::findParam(const char *paramName,
                                                  bool isAllowStringHolders)
 {
-  ArConfigArg *param = NULL;
-  ArConfigArg *tempParam = NULL;
+  const std::vector<ArConfigArg *> *params = findParams(paramName);
+  if (params == NULL)
+    return NULL;
 
-  for (std::list<ArConfigArg>::iterator pIter = myParams.begin(); 
-       pIter != myParams.end(); 
+  // the last one with this name wins
+  for (std::vector<ArConfigArg *>::const_reverse_iterator pIter = params->rbegin();
+       pIter != params->rend();
        ++pIter)
   {
-    tempParam = &(*pIter);
+    ArConfigArg *tempParam = *pIter;
     // ignore string holders 
     if (!isAllowStringHolders &&
         ((tempParam->getType() == ArConfigArg::STRING_HOLDER) || 
          (tempParam->getType() == ArConfigArg::LIST_HOLDER)))
       continue;
-    if (ArUtil::strcasecmp(tempParam->getName(), paramName) == 0)
-    {
-      param = tempParam;
-    }
+    return tempParam;
   }
-  return param;
+  return NULL;
 
 } // end method findParam
 
+/**
+ * Parameter names are not case sensitive.  The returned pointers (and
+ * the vector) remain valid until parameters are removed from the section
+ * or getParams() is called, so they may be kept as handles to the
+ * parameters while the section is unchanged.
+ *
+ * @return every parameter in the section with the given name, including
+ * string and list holders, in the order they were added; or NULL if there
+ * are none
+**/
+AREXPORT const std::vector<ArConfigArg *> *ArConfigSection::findParams(
+                                                       const char *paramName)
+{
+  if (paramName == NULL)
+    return NULL;
+
+  updateParamIndex();
+
+  myParamIndexKey = paramName;
+  lowerKey(&myParamIndexKey);
+  std::unordered_map<std::string, std::vector<ArConfigArg *> >::const_iterator it = 
+                                          myParamIndex.find(myParamIndexKey);
+  if (it == myParamIndex.end() || it->second.empty())
+    return NULL;
+  return &it->second;
+
+} // end method findParams
+
+
+void ArConfigSection::updateParamIndex()
+{
+  if (myParamIndexDirty || myParamIndexCount > myParams.size())
+  {
+    myParamIndex.clear();
+    myParamIndexCount = 0;
+    myParamIndexDirty = false;
+  }
+  if (myParamIndexCount == myParams.size())
+    return;
+
+  // index the parameters appended since last time
+  std::list<ArConfigArg>::iterator pIter = myParams.end();
+  std::advance(pIter, -(long)(myParams.size() - myParamIndexCount));
+  for (; pIter != myParams.end(); ++pIter)
+  {
+    myParamIndexKey = pIter->getName();
+    lowerKey(&myParamIndexKey);
+    myParamIndex[myParamIndexKey].push_back(&(*pIter));
+  }
+  myParamIndexCount = myParams.size();
+
+} // end method updateParamIndex
+
 /**
  * This method provides a shortcut for looking up child parameters 
  * in a list type parameter that is contained in the section.
@@ -3612,6 +3910,7 @@ AREXPORT bool ArConfigSection::remStringHolder(const char *paramName)
     if (ArUtil::strcasecmp(tempParam->getName(), paramName) == 0)
     {
       myParams.erase(pIter);
+      myParamIndexDirty = true;
       // Recurse to ensure that all occurrences of the string holder
       // are removed.
       remStringHolder(paramName);
@@ -3686,6 +3985,7 @@ AREXPORT void ArConfigSection::setQuiet(bool isQuiet)
 AREXPORT void ArConfigSection::setName(const char *name) 
 { 
   myName = ((name != NULL) ? name : "");
+  ++ourSectionRenames;
 }
  
 AREXPORT void ArConfigSection::setComment(const char *comment) 
@@ -34,6 +34,162 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include <string>
 #include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstring>
+
+/*
+  The Binary DataLogFormat writes a file that starts with the 8 byte magic
+  string below, followed by blocks that each start with a one byte tag:
+
+  'S' schema: uint16 column count, uint32 record size, then for each column
+      uint8 type (ArDataLogger::BinaryColumnType), uint8 precision (digits
+      after the decimal point when converting doubles), uint16 size and a
+      uint16 length followed by the column name.
+  'R' record: one value per column of the last schema block, record size
+      bytes in total.
+  'C' comment: int64 time, uint16 length, then the comment text.
+
+  All values are little endian.  A new schema block is written whenever the
+  set of logged channels is reconfigured.
+*/
+static const char binaryLogMagic[] = "ArDLBin1";
+static const size_t binaryLogMagicLen = 8;
+/// Packed records are written out once this much is buffered...
+static const size_t binaryFlushSize = 64 * 1024;
+/// ...or this many seconds have passed since the last write
+static const long binaryFlushSecs = 2;
+
+/// Whether @a fileName is empty (or missing) or already holds a log in
+/// the same (binary or text) format, so that more can be appended to it
+static bool logFileMatchesFormat(const char *fileName, bool binary)
+{
+  FILE *file = ArUtil::fopen(fileName, "rb");
+  if (file == NULL)
+    return true;
+  char magic[binaryLogMagicLen];
+  const size_t len = fread(magic, 1, binaryLogMagicLen, file);
+  fclose(file);
+  if (len == 0)
+    return true;
+  const bool isBinary = (len == binaryLogMagicLen &&
+			 memcmp(magic, binaryLogMagic, binaryLogMagicLen) == 0);
+  return isBinary == binary;
+}
+
+static const char *dataLogChargeStateName(ArRobot::ChargeState chargeState)
+{
+  if (chargeState == ArRobot::CHARGING_UNKNOWN)
+    return "Unknowable";
+  else if (chargeState == ArRobot::CHARGING_NOT)
+    return "Not";
+  else if (chargeState == ArRobot::CHARGING_BULK)
+    return "Bulk";
+  else if (chargeState == ArRobot::CHARGING_OVERCHARGE)
+    return "Overcharge";
+  else if (chargeState == ArRobot::CHARGING_FLOAT)
+    return "Float";
+  else if (chargeState == ArRobot::CHARGING_BALANCE)
+    return "Balance";
+  else
+    return "Unknown";
+}
+
+/// Accumulates the column descriptions of a Binary format schema block
+class ArDataLoggerBinarySchema
+{
+public:
+  ArDataLoggerBinarySchema() : myCount(0), myRecordSize(0) {}
+  void add(const char *name, ArDataLogger::BinaryColumnType type,
+	   size_t size, unsigned char precision = 0)
+  {
+    size_t nameLen = std::min(strlen(name), (size_t)USHRT_MAX);
+    myColumns.push_back((unsigned char)type);
+    myColumns.push_back(precision);
+    myColumns.push_back((unsigned char)(size & 0xff));
+    myColumns.push_back((unsigned char)((size >> 8) & 0xff));
+    myColumns.push_back((unsigned char)(nameLen & 0xff));
+    myColumns.push_back((unsigned char)((nameLen >> 8) & 0xff));
+    myColumns.insert(myColumns.end(), name, name + nameLen);
+    myCount++;
+    myRecordSize += size;
+  }
+  const std::vector<unsigned char> &getColumns() const { return myColumns; }
+  unsigned short getCount() const { return myCount; }
+  size_t getRecordSize() const { return myRecordSize; }
+protected:
+  std::vector<unsigned char> myColumns;
+  unsigned short myCount;
+  size_t myRecordSize;
+};
+
+/// Packs little endian values into one Binary format record
+class ArDataLoggerBinaryRecord
+{
+public:
+  ArDataLoggerBinaryRecord(unsigned char *buf, size_t size) :
+    myPos(buf), myEnd(buf + size), myOverrun(false) {}
+  void uByteToBuf(unsigned char val)
+  {
+    if (!room(1))
+      return;
+    *myPos++ = val;
+  }
+  void uByte2ToBuf(unsigned int val)
+  {
+    if (!room(2))
+      return;
+    *myPos++ = (unsigned char)(val & 0xff);
+    *myPos++ = (unsigned char)((val >> 8) & 0xff);
+  }
+  void byte4ToBuf(int val)
+  {
+    if (!room(4))
+      return;
+    unsigned int u = (unsigned int)val;
+    for (int i = 0; i < 4; ++i, u >>= 8)
+      *myPos++ = (unsigned char)(u & 0xff);
+  }
+  void doubleToBuf(double val)
+  {
+    if (!room(8))
+      return;
+    uint64_t u;
+    memcpy(&u, &val, sizeof(u));
+    for (int i = 0; i < 8; ++i, u >>= 8)
+      *myPos++ = (unsigned char)(u & 0xff);
+  }
+  /// Lets @a functor fill a nul padded string column directly
+  void stringToBuf(ArFunctor2<char *, size_t> *functor, size_t len)
+  {
+    if (!room(len))
+      return;
+    memset(myPos, 0, len);
+    functor->invoke((char *)myPos, len);
+    myPos += len;
+  }
+  void strToBuf(const char *str, size_t len)
+  {
+    if (!room(len))
+      return;
+    memset(myPos, 0, len);
+    strncpy((char *)myPos, str, len);
+    myPos += len;
+  }
+  bool isComplete() const { return !myOverrun && myPos == myEnd; }
+protected:
+  bool room(size_t len)
+  {
+    if (myOverrun || (size_t)(myEnd - myPos) < len)
+    {
+      myOverrun = true;
+      return false;
+    }
+    return true;
+  }
+  unsigned char *myPos;
+  unsigned char *myEnd;
+  bool myOverrun;
+};
 
 /**
    @param robot the robot to log information from
@@ -58,7 +214,8 @@ AREXPORT ArDataLogger::ArDataLogger(ArRobot *robot, const char *fileName) :
   myStopLogFunctor(this, &ArDataLogger::stopLogging),
   mySaveCopyWithArgsFunctor(this, &ArDataLogger::saveCopyArgs),
   mySaveCopyFunctor(this, &ArDataLogger::saveCopy),
-  myConfigLogFormat("TSV"), myLogFormat(TSV), myLogSep('\t')
+  myConfigLogFormat("TSV"), myLogFormat(TSV), myLogSep('\t'),
+  myBinaryRecordSize(0), myBinaryNumBatteries(0)
 {
   myMutex.setLogName("ArDataLogger::myMutex");
   myRobot = robot;
@@ -128,6 +285,16 @@ AREXPORT ArDataLogger::~ArDataLogger()
   if(myRobot && myRobot->getPacketSender())
     myRobot->getPacketSender()->setCommandMonitor(NULL);
     //myRobot->getPacketSender()->setPacketSentCallback(NULL);
+  myMutex.lock();
+  if (myFile != NULL)
+  {
+    // don't lose whatever binary records are still buffered
+    if (myLogFormat == Binary)
+      flushBinary();
+    fclose(myFile);
+    myFile = NULL;
+  }
+  myMutex.unlock();
 }
 
 AREXPORT void ArDataLogger::addToConfig(ArConfig *config)
@@ -170,8 +337,12 @@ AREXPORT void ArDataLogger::addToConfig(ArConfig *config)
       "If TSV or CSV, use simple tab or comma-separated-value format (best for import into "
       "plotting and analysis tools). If Fixed, format data in fixed size (but "
       "also tab-separated) text columns (best for viewing log file manually). "
-      "You may want to clear and restart the log after changing this.");
-  fmtArg.setDisplayHint("Choices:TSV;;CSV;;Fixed");
+      "If Binary, write compact fixed size binary records (least overhead "
+      "when logging every cycle, convert to text with ArDataLogger::convertBinaryLog() "
+      "or the convertDataLog utility). "
+      "Changing between Binary and the text formats starts the log file over "
+      "(or, for a fixed log file name, logs to the name with .1, .2, etc. added).");
+  fmtArg.setDisplayHint("Choices:TSV;;CSV;;Fixed;;Binary");
   myConfig->addParam(fmtArg, section.c_str(), ArPriority::DETAILED);
 
   for (size_t i = 0; i < myStringsCount; ++i)
@@ -378,6 +549,7 @@ bool ArDataLogger::processFile(char *errorBuffer,
 {
   myMutex.lock();
 
+  bool wasBinary = (myLogFormat == Binary);
 
   if(myConfigLogFormat == "TSV")
   {
@@ -397,16 +569,31 @@ bool ArDataLogger::processFile(char *errorBuffer,
     myLogFormat = Fixed;
     myLogSep = '\t';
   }
+  else if(myConfigLogFormat == "Binary")
+  {
+    if(myLogFormat != Binary) ArLog::log(ArLog::Normal, "ArDataLogger: Changing format to Binary");
+    myLogFormat = Binary;
+    myLogSep = ',';
+  }
   else
   {
-    ArLog::log(ArLog::Terse, "ArDataLogger: Error: Unrecognized log format type \"%s\", expected TSV, CSV or Fixed. Not changing. (Current format is %s)", myConfigLogFormat.c_str());
+    ArLog::log(ArLog::Terse, "ArDataLogger: Error: Unrecognized log format type \"%s\", expected TSV, CSV, Fixed or Binary. Not changing.", myConfigLogFormat.c_str());
   }
 
+  // write out records packed in the old format before anything else
+  if (wasBinary && myFile != NULL)
+    flushBinary();
+
+  // text and binary logs can't share a file, so changing between them
+  // starts the file over (or, for a permanent file, rolls to a new one)
+  const bool formatChanged = (wasBinary != (myLogFormat == Binary));
+
   // if our file name is different and we're not using a permanent
-  // file name or if we're disabled close the old one
+  // file name or if we're disabled or changed formats close the old one
   if ((myOpenedFileName != myConfigFileName && myFile != NULL && 
        myPermanentFileName.size() == 0) ||
-       (myFile != NULL && !myConfigLogging))
+       (myFile != NULL && !myConfigLogging) ||
+       (myFile != NULL && formatChanged))
   {
     ArLog::log(ArLog::Normal, "ArDataLogger: Closed data log file '%s'", myOpenedFileName.c_str());
     fclose(myFile);
@@ -424,14 +611,33 @@ bool ArDataLogger::processFile(char *errorBuffer,
     std::string fileName;
     if (myPermanentFileName.size() > 0)
     {
-      if ((myFile = ArUtil::fopen(myPermanentFileName.c_str(), "a")) != NULL)
+      // the permanent file is appended to, so if it already has a log in
+      // the other format in it use the first of name.1, name.2, ... that
+      // doesn't
+      fileName = myPermanentFileName;
+      for (int roll = 1; roll < 100 && 
+	     !logFileMatchesFormat(fileName.c_str(), myLogFormat == Binary);
+	   roll++)
+	fileName = myPermanentFileName + "." + std::to_string(roll);
+      if (fileName != myPermanentFileName)
+	ArLog::log(ArLog::Normal, "ArDataLogger: Data log file '%s' has a %s log in it, using '%s' instead", 
+		   myPermanentFileName.c_str(), 
+		   (myLogFormat == Binary) ? "text" : "binary", fileName.c_str());
+      if (!logFileMatchesFormat(fileName.c_str(), myLogFormat == Binary))
+      {
+        ArLog::log(ArLog::Normal, "ArDataLogger: Error: No data log file for '%s' without a log in another format in it", myPermanentFileName.c_str());
+        myMutex.unlock();
+        return true;
+      }
+      if ((myFile = ArUtil::fopen(fileName.c_str(), 
+                                  (myLogFormat == Binary) ? "ab" : "a")) != NULL)
       {
-        ArLog::log(ArLog::Normal, "ArDataLogger: Opened data log file '%s'", myPermanentFileName.c_str());
-        myOpenedFileName = myPermanentFileName;
+        ArLog::log(ArLog::Normal, "ArDataLogger: Opened data log file '%s'", fileName.c_str());
+        myOpenedFileName = fileName;
       }
       else
       {
-        ArLog::log(ArLog::Normal, "ArDataLogger: Error: Could not open data log file '%s'", myPermanentFileName.c_str());
+        ArLog::log(ArLog::Normal, "ArDataLogger: Error: Could not open data log file '%s'", fileName.c_str());
         myMutex.unlock();
         return true;
       }
@@ -439,7 +645,8 @@ bool ArDataLogger::processFile(char *errorBuffer,
     else
     {
       // if we couldn't open it fail
-      if ((myFile = ArUtil::fopen(myConfigFileName.c_str(), "w")) != NULL)
+      if ((myFile = ArUtil::fopen(myConfigFileName.c_str(), 
+                                  (myLogFormat == Binary) ? "wb" : "w")) != NULL)
       {
         myOpenedFileName = myConfigFileName;
         ArLog::log(ArLog::Normal, "ArDataLogger: Opened data log file '%s'", myOpenedFileName.c_str());
@@ -494,6 +701,11 @@ bool ArDataLogger::processFile(char *errorBuffer,
 
 void ArDataLogger::writeHeader()
 {
+  if (myLogFormat == Binary)
+  {
+    writeBinaryHeader();
+    return;
+  }
   fprintf(myFile, (myLogFormat == Fixed)?"; %-12s":";%s", "Time");
   std::map<std::string, bool *, ArStrCaseCmpOp>::iterator it;
   for (size_t i = 0; i < myStringsCount; ++i)
@@ -606,6 +818,14 @@ void ArDataLogger::userTask()
     return;
   }
 
+  if (myLogFormat == Binary)
+  {
+    writeBinaryRecord();
+    myLastLogged.setToNow();
+    myMutex.unlock();
+    return;
+  }
+
   fprintf(myFile, "%.4f", ArUtil::getTime()/1000.0);
 
   char *buf;
@@ -642,22 +862,7 @@ void ArDataLogger::userTask()
   if (myLogChargeState)
   {  
     ArRobot::ChargeState chargeState = myRobot->getChargeState();
-    std::string chargeString;
-    if (chargeState == ArRobot::CHARGING_UNKNOWN)
-      chargeString = "Unknowable";
-    else if (chargeState == ArRobot::CHARGING_NOT)
-      chargeString = "Not";
-    else if (chargeState == ArRobot::CHARGING_BULK)
-      chargeString = "Bulk";
-    else if (chargeState == ArRobot::CHARGING_OVERCHARGE)
-      chargeString = "Overcharge";
-    else if (chargeState == ArRobot::CHARGING_FLOAT)
-      chargeString = "Float";
-    else if (chargeState == ArRobot::CHARGING_BALANCE)
-      chargeString = "Balance";
-    else
-      chargeString = "Unknown";
-    fprintf(myFile, (myLogFormat != Fixed)?"%c%s%c%d":"%c%-15s%c%-5d", myLogSep, chargeString.c_str(), myLogSep, chargeState);
+    fprintf(myFile, (myLogFormat != Fixed)?"%c%s%c%d":"%c%-15s%c%-5d", myLogSep, dataLogChargeStateName(chargeState), myLogSep, chargeState);
   }
 
   if (myLogBatteryInfo && myRobot->getBatteryPacketReader() != NULL)
@@ -788,6 +993,291 @@ void ArDataLogger::userTask()
   myMutex.unlock();
 }
 
+/**
+   Writes (via the buffer) a schema block describing the channels that are
+   currently enabled, in the same order userTask() logs them in the text
+   formats.  Must be called with myMutex locked.
+**/
+void ArDataLogger::writeBinaryHeader()
+{
+  // anything already packed belongs to the previous schema
+  flushBinary();
+  fseek(myFile, 0, SEEK_END);
+  if (ftell(myFile) == 0)
+    fwrite(binaryLogMagic, 1, binaryLogMagicLen, myFile);
+
+  ArDataLoggerBinarySchema schema;
+  char name[64];
+  schema.add("Time", BINARY_DOUBLE, 8, 4);
+  for (size_t i = 0; i < myStringsCount; ++i)
+  {
+    if (*(myStringsEnabled[i]))
+      schema.add(myStrings[i]->getName(), BINARY_STRING, 
+		 myStrings[i]->getMaxLength());
+  }
+  if (myLogVoltage)
+    schema.add("Volt", BINARY_DOUBLE, 8, 2);
+  if (myLogStateOfCharge)
+    schema.add("SoC", BINARY_DOUBLE, 8, 1);
+  if (myLogChargeState)
+  {
+    schema.add("ChargeStateName", BINARY_STRING, 12);
+    schema.add("csNum", BINARY_UINT8, 1);
+  }
+  myBinaryNumBatteries = 0;
+  if (myLogBatteryInfo && myRobot->getBatteryPacketReader() != NULL)
+    myBinaryNumBatteries = myRobot->getBatteryPacketReader()->getNumBatteries();
+  for (int battery = 1; battery <= myBinaryNumBatteries; battery++)
+  {
+    snprintf(name, sizeof(name), "bat%02dflags1", battery);
+    schema.add(name, BINARY_BITS8, 1);
+    snprintf(name, sizeof(name), "bat%02dflags2", battery);
+    schema.add(name, BINARY_BITS8, 1);
+    snprintf(name, sizeof(name), "bat%02dflags3", battery);
+    schema.add(name, BINARY_BITS8, 1);
+    snprintf(name, sizeof(name), "bat%02drelsoc", battery);
+    schema.add(name, BINARY_INT32, 4);
+    snprintf(name, sizeof(name), "bat%02dabssoc", battery);
+    schema.add(name, BINARY_INT32, 4);
+  }
+  if (myLogPose)
+  {
+    schema.add("X", BINARY_DOUBLE, 8);
+    schema.add("Y", BINARY_DOUBLE, 8);
+    schema.add("Th", BINARY_DOUBLE, 8);
+  }
+  if (myLogEncoderPose)
+  {
+    schema.add("encX", BINARY_DOUBLE, 8);
+    schema.add("encY", BINARY_DOUBLE, 8);
+    schema.add("encTh", BINARY_DOUBLE, 8);
+  }
+  if (myLogCorrectedEncoderPose)
+  {
+    schema.add("corrEncX", BINARY_DOUBLE, 8);
+    schema.add("corrEncY", BINARY_DOUBLE, 8);
+    schema.add("corrEncTh", BINARY_DOUBLE, 8);
+  }
+  if (myLogEncoders)
+  {
+    schema.add("encL", BINARY_INT32, 4);
+    schema.add("encR", BINARY_INT32, 4);
+  }
+  if (myLogLeftVel)
+    schema.add("LeftV", BINARY_DOUBLE, 8);
+  if (myLogRightVel)
+    schema.add("RightV", BINARY_DOUBLE, 8);
+  if (myLogTransVel)
+    schema.add("TransV", BINARY_DOUBLE, 8);
+  if (myLogRotVel)
+    schema.add("RotV", BINARY_DOUBLE, 8);
+  if (myLogLatVel)
+    schema.add("LatV", BINARY_DOUBLE, 8);
+  if (myLogLeftStalled)
+    schema.add("LStall", BINARY_UINT8, 1);
+  if (myLogRightStalled)
+    schema.add("RStall", BINARY_UINT8, 1);
+  if (myLogStallBits)
+    schema.add("StllBts", BINARY_BITS16, 2);
+  if (myLogFlags)
+    schema.add("Flags", BINARY_BITS16, 2);
+  if (myLogFaultFlags)
+    schema.add("FaultFlags", BINARY_BITS16, 2);
+  for (int i = 0; i < myAnalogCount; ++i)
+  {
+    snprintf(name, sizeof(name), "An%d", i);
+    if (myAnalogEnabled[i])
+      schema.add(name, BINARY_INT32, 4);
+  }
+  for (int i = 0; i < myAnalogVoltageCount; ++i)
+  {
+    snprintf(name, sizeof(name), "AnV%d", i);
+    if (myAnalogVoltageEnabled[i])
+      schema.add(name, BINARY_DOUBLE, 8, 2);
+  }
+  for (int i = 0; i < myDigInCount; ++i)
+  {
+    snprintf(name, sizeof(name), "DigIn%d", i);
+    if (myDigInEnabled[i])
+      schema.add(name, BINARY_BITS8, 1);
+  }
+  for (int i = 0; i < myDigOutCount; ++i)
+  {
+    snprintf(name, sizeof(name), "DigOut%d", i);
+    if (myDigOutEnabled[i])
+      schema.add(name, BINARY_BITS8, 1);
+  }
+  if(myLogMovementSent)
+  { 
+    myMovementCommandsMutex.lock();
+    for(CmdMap::const_iterator i = myMovementCommands.begin(); i != myMovementCommands.end(); ++i)
+    {
+      snprintf(name, sizeof(name), "Cmd%s", (*i).second.name.c_str());
+      schema.add(name, BINARY_COMMAND, 4);
+    }
+    myMovementCommandsMutex.unlock();
+  }
+
+  myBinaryRecordSize = schema.getRecordSize();
+  const std::vector<unsigned char> &columns = schema.getColumns();
+  unsigned char block[7];
+  block[0] = 'S';
+  ArDataLoggerBinaryRecord header(&block[1], sizeof(block) - 1);
+  header.uByte2ToBuf(schema.getCount());
+  header.byte4ToBuf((int)myBinaryRecordSize);
+  fwrite(block, 1, sizeof(block), myFile);
+  fwrite(columns.data(), 1, columns.size(), myFile);
+  fflush(myFile);
+
+  // reserve enough that packing records never reallocates
+  myBinaryBuffer.reserve(binaryFlushSize + myBinaryRecordSize + 1);
+  myBinaryLastFlush.setToNow();
+}
+
+/**
+   Packs one record for the current schema onto the end of
+   myBinaryBuffer. Nothing is formatted and the file is only touched every
+   binaryFlushSize bytes, so this is cheap enough to do every robot
+   cycle. Must be called with myMutex locked.
+**/
+void ArDataLogger::writeBinaryRecord()
+{
+  size_t start = myBinaryBuffer.size();
+  myBinaryBuffer.resize(start + 1 + myBinaryRecordSize);
+  myBinaryBuffer[start] = 'R';
+  ArDataLoggerBinaryRecord rec(&myBinaryBuffer[start + 1], myBinaryRecordSize);
+
+  rec.doubleToBuf(ArUtil::getTime()/1000.0);
+  for (size_t i = 0; i < myStringsCount; ++i)
+  {
+    if (*(myStringsEnabled[i]))
+      rec.stringToBuf(myStrings[i]->getFunctor(), myStrings[i]->getMaxLength());
+  }
+  if (myLogVoltage)
+    rec.doubleToBuf(myRobot->getRealBatteryVoltageNow());
+  if (myLogStateOfCharge)
+    rec.doubleToBuf(myRobot->getStateOfCharge());
+  if (myLogChargeState)
+  {
+    ArRobot::ChargeState chargeState = myRobot->getChargeState();
+    rec.strToBuf(dataLogChargeStateName(chargeState), 12);
+    rec.uByteToBuf((unsigned char)chargeState);
+  }
+  for (int battery = 1; battery <= myBinaryNumBatteries; battery++)
+  {
+    ArRobotBatteryPacketReader *reader = myRobot->getBatteryPacketReader();
+    rec.uByteToBuf((unsigned char)reader->getFlags1(battery));
+    rec.uByteToBuf((unsigned char)reader->getFlags2(battery));
+    rec.uByteToBuf((unsigned char)reader->getFlags3(battery));
+    rec.byte4ToBuf(reader->getRelSOC(battery));
+    rec.byte4ToBuf(reader->getAbsSOC(battery));
+  }
+  if (myLogPose)
+  {
+    rec.doubleToBuf(myRobot->getX());
+    rec.doubleToBuf(myRobot->getY());
+    rec.doubleToBuf(myRobot->getTh());
+  }
+  if (myLogEncoderPose)
+  {
+    ArPose pose = myRobot->getRawEncoderPose();
+    rec.doubleToBuf(pose.getX());
+    rec.doubleToBuf(pose.getY());
+    rec.doubleToBuf(pose.getTh());
+  }
+  if (myLogCorrectedEncoderPose)
+  {
+    ArPose pose = myRobot->getEncoderPose();
+    rec.doubleToBuf(pose.getX());
+    rec.doubleToBuf(pose.getY());
+    rec.doubleToBuf(pose.getTh());
+  }
+  if (myLogEncoders)
+  {
+    rec.byte4ToBuf((int)myRobot->getLeftEncoder());
+    rec.byte4ToBuf((int)myRobot->getRightEncoder());
+  }
+  if (myLogLeftVel)
+    rec.doubleToBuf(myRobot->getLeftVel());
+  if (myLogRightVel)
+    rec.doubleToBuf(myRobot->getRightVel());
+  if (myLogTransVel)
+    rec.doubleToBuf(myRobot->getVel());
+  if (myLogRotVel)
+    rec.doubleToBuf(myRobot->getRotVel());
+  if (myLogLatVel)
+    rec.doubleToBuf(myRobot->getLatVel());
+  if (myLogLeftStalled)
+    rec.uByteToBuf(myRobot->isLeftMotorStalled() ? 1 : 0);
+  if (myLogRightStalled)
+    rec.uByteToBuf(myRobot->isRightMotorStalled() ? 1 : 0);
+  if (myLogStallBits)
+    rec.uByte2ToBuf((unsigned int)myRobot->getStallValue());
+  if (myLogFlags)
+    rec.uByte2ToBuf((unsigned int)myRobot->getFlags());
+  if (myLogFaultFlags)
+    rec.uByte2ToBuf((unsigned int)myRobot->getFaultFlags());
+  for (int i = 0; i < myAnalogCount; ++i)
+  {
+    if (myAnalogEnabled[i])
+      rec.byte4ToBuf(myRobot->getIOAnalog(i));
+  }
+  for (int i = 0; i < myAnalogVoltageCount; ++i)
+  {
+    if (myAnalogVoltageEnabled[i])
+      rec.doubleToBuf(myRobot->getIOAnalogVoltage(i));
+  }
+  for (int i = 0; i < myDigInCount; ++i)
+  {
+    if (myDigInEnabled[i])
+      rec.uByteToBuf((unsigned char)myRobot->getIODigIn(i));
+  }
+  for (int i = 0; i < myDigOutCount; ++i)
+  {
+    if (myDigOutEnabled[i])
+      rec.uByteToBuf((unsigned char)myRobot->getIODigOut(i));
+  }
+  if(myLogMovementSent)
+  {
+    myMovementCommandsMutex.lock();
+    for(CmdMap::iterator i = myMovementCommands.begin(); i != myMovementCommands.end(); ++i)
+    {
+      Cmd &c = (*i).second;
+      rec.byte4ToBuf(c.sent ? c.arg : INT_MIN);
+      c.sent = false; // reset for next iteration
+    }
+    myMovementCommandsMutex.unlock();
+  }
+
+  if (!rec.isComplete())
+  {
+    // the channels changed without a new schema, drop the record rather
+    // than write something that can't be read back
+    ArLog::log(ArLog::Normal, "ArDataLogger: Warning: Logged channels don't match binary log schema, dropping record");
+    myBinaryBuffer.resize(start);
+    return;
+  }
+
+  if (myBinaryBuffer.size() >= binaryFlushSize || 
+      myBinaryLastFlush.secSince() >= binaryFlushSecs)
+    flushBinary();
+}
+
+/// Writes out all buffered Binary format data. Must be called with myMutex locked.
+void ArDataLogger::flushBinary()
+{
+  myBinaryLastFlush.setToNow();
+  if (myBinaryBuffer.empty() || myFile == NULL)
+  {
+    myBinaryBuffer.clear();
+    return;
+  }
+  if (fwrite(myBinaryBuffer.data(), 1, myBinaryBuffer.size(), myFile) != myBinaryBuffer.size())
+    ArLog::logErrorFromOS(ArLog::Normal, "ArDataLogger: Error writing binary data to log file %s", myOpenedFileName.c_str());
+  fflush(myFile);
+  myBinaryBuffer.clear();
+}
+
 
 // todo omit units from config name? (ie separate name and units here, concat) 
 AREXPORT void ArDataLogger::addString(
@@ -866,6 +1356,21 @@ AREXPORT void ArDataLogger::writeComment(const char *str)
     return;
   }
   ArLog::log(ArLog::Normal, "ArDataLogger: User comment: %s", str);
+  if (myLogFormat == Binary)
+  {
+    size_t len = std::min(strlen(str), (size_t)USHRT_MAX);
+    size_t start = myBinaryBuffer.size();
+    myBinaryBuffer.resize(start + 11 + len);
+    myBinaryBuffer[start] = 'C';
+    ArDataLoggerBinaryRecord rec(&myBinaryBuffer[start + 1], 10 + len);
+    long long now = (long long) time(NULL);
+    rec.byte4ToBuf((int)(now & 0xffffffff));
+    rec.byte4ToBuf((int)(now >> 32));
+    rec.uByte2ToBuf((unsigned int)len);
+    memcpy(&myBinaryBuffer[start + 11], str, len);
+    myMutex.unlock();
+    return;
+  }
   fprintf(myFile, "; %ld %s\n", (long) time(NULL), str);
   fflush(myFile);
   myMutex.unlock();
@@ -887,8 +1392,9 @@ AREXPORT void ArDataLogger::clearLog()
   }
   ArLog::log(ArLog::Normal, "ArDataLogger: Warning: Clearing log file!");
   //rewind(myFile);
+  myBinaryBuffer.clear();
   if(myFile) fclose(myFile);
-  myFile = ArUtil::fopen(myOpenedFileName.c_str(), "w");
+  myFile = ArUtil::fopen(myOpenedFileName.c_str(), (myLogFormat == Binary) ? "wb" : "w");
   if(myFile)
     writeHeader();
   else
@@ -941,6 +1447,8 @@ AREXPORT void ArDataLogger::saveCopyAs(const char *name_s)
       filename.insert(dotpos, timesuffix);
   }
   myMutex.lock();
+  if (myLogFormat == Binary)
+    flushBinary();
   // TODO maybe sanitize filenames further (e.g. remove \", nonprintable characters, other special characters...
   ArLog::log(ArLog::Normal, "ArDataLogger: Making copy of log file \"%s\" as \"%s\" on system...", getOpenLogFileName(), filename.c_str());
   char cmd[512];
@@ -973,3 +1481,167 @@ AREXPORT void ArDataLogger::stopLogging()
   myConfigLogging = false;
   processFile(NULL, 0);
 }
+
+/// Reads a little endian unsigned value of @a len bytes
+static unsigned long long binaryLogGet(const unsigned char *buf, size_t len)
+{
+  unsigned long long val = 0;
+  for (size_t i = len; i > 0; --i)
+    val = (val << 8) | buf[i-1];
+  return val;
+}
+
+static void binaryLogPutBits(FILE *out, unsigned long long val, int bits)
+{
+  for (int i = 0; i < bits; ++i, val >>= 1)
+    fputc((val & 1) ? '1' : '0', out);
+}
+
+/**
+   Reads a data log written with the Binary DataLogFormat from @a in and
+   writes it to @a out as text with @a sep between columns, in the same
+   layout the CSV (or TSV) formats would have produced: a header line
+   starting with ";" for each schema in the file, one line per record,
+   and comments as "; time comment" lines.
+
+   @return true if the whole of @a in was converted, false if it is not a
+   binary data log or is corrupt (a record truncated at the end of the file,
+   e.g. by a crash while logging, is ignored)
+**/
+AREXPORT bool ArDataLogger::convertBinaryLog(FILE *in, FILE *out, char sep)
+{
+  char magic[binaryLogMagicLen];
+  if (fread(magic, 1, binaryLogMagicLen, in) != binaryLogMagicLen ||
+      memcmp(magic, binaryLogMagic, binaryLogMagicLen) != 0)
+  {
+    ArLog::log(ArLog::Terse, "ArDataLogger::convertBinaryLog: Error: Input is not a binary data log");
+    return false;
+  }
+
+  struct Column { char type; unsigned char precision; size_t size; };
+  std::vector<Column> columns;
+  std::vector<unsigned char> buf;
+  size_t recordSize = 0;
+  bool haveSchema = false;
+  int tag;
+  while ((tag = fgetc(in)) != EOF)
+  {
+    if (tag == 'S')
+    {
+      unsigned char head[6];
+      if (fread(head, 1, sizeof(head), in) != sizeof(head))
+        return true;
+      size_t count = binaryLogGet(&head[0], 2);
+      recordSize = binaryLogGet(&head[2], 4);
+      columns.clear();
+      size_t total = 0;
+      fputc(';', out);
+      for (size_t i = 0; i < count; ++i)
+      {
+	unsigned char desc[6];
+	if (fread(desc, 1, sizeof(desc), in) != sizeof(desc))
+	  return true;
+	Column col;
+	col.type = (char)desc[0];
+	col.precision = desc[1];
+	col.size = binaryLogGet(&desc[2], 2);
+	size_t nameLen = binaryLogGet(&desc[4], 2);
+	buf.resize(nameLen + 1);
+	if (fread(buf.data(), 1, nameLen, in) != nameLen)
+	  return true;
+	buf[nameLen] = '\0';
+	if (i > 0)
+	  fputc(sep, out);
+	fputs((const char *)buf.data(), out);
+	columns.push_back(col);
+	total += col.size;
+      }
+      fputc('\n', out);
+      if (total != recordSize)
+      {
+	ArLog::log(ArLog::Terse, "ArDataLogger::convertBinaryLog: Error: Schema columns add up to %lu bytes but record size is %lu", total, recordSize);
+	return false;
+      }
+      haveSchema = true;
+    }
+    else if (tag == 'R')
+    {
+      if (!haveSchema)
+      {
+	ArLog::log(ArLog::Terse, "ArDataLogger::convertBinaryLog: Error: Record before any schema");
+	return false;
+      }
+      buf.resize(recordSize);
+      if (fread(buf.data(), 1, recordSize, in) != recordSize)
+	return true;
+      const unsigned char *p = buf.data();
+      for (size_t i = 0; i < columns.size(); ++i)
+      {
+	const Column &col = columns[i];
+	if (i > 0)
+	  fputc(sep, out);
+	unsigned long long raw = (col.size <= 8) ? binaryLogGet(p, col.size) : 0;
+	switch (col.type)
+	{
+	case BINARY_DOUBLE:
+	{
+	  double d;
+	  uint64_t u = raw;
+	  memcpy(&d, &u, sizeof(d));
+	  fprintf(out, "%.*f", (int)col.precision, d);
+	  break;
+	}
+	case BINARY_INT32:
+	  fprintf(out, "%d", (int)(unsigned int)raw);
+	  break;
+	case BINARY_UINT8:
+	  fprintf(out, "%u", (unsigned int)raw);
+	  break;
+	case BINARY_BITS8:
+	  binaryLogPutBits(out, raw, 8);
+	  break;
+	case BINARY_BITS16:
+	  binaryLogPutBits(out, raw, 16);
+	  break;
+	case BINARY_COMMAND:
+	  if ((int)(unsigned int)raw == INT_MIN)
+	    fputs("na", out);
+	  else
+	    fprintf(out, "%d", (int)(unsigned int)raw);
+	  break;
+	case BINARY_STRING:
+	{
+	  // same as the text formats: the separator can't appear in a value
+	  for (size_t j = 0; j < col.size && p[j] != '\0'; ++j)
+	    fputc(((char)p[j] == sep) ? ' ' : (char)p[j], out);
+	  break;
+	}
+	default:
+	  ArLog::log(ArLog::Terse, "ArDataLogger::convertBinaryLog: Error: Unknown column type '%c'", col.type);
+	  return false;
+	}
+	p += col.size;
+      }
+      fputc('\n', out);
+    }
+    else if (tag == 'C')
+    {
+      unsigned char head[10];
+      if (fread(head, 1, sizeof(head), in) != sizeof(head))
+	return true;
+      long long when = (long long)binaryLogGet(&head[0], 8);
+      size_t len = binaryLogGet(&head[8], 2);
+      buf.resize(len + 1);
+      if (fread(buf.data(), 1, len, in) != len)
+	return true;
+      buf[len] = '\0';
+      fprintf(out, "; %lld %s\n", when, (const char *)buf.data());
+    }
+    else
+    {
+      ArLog::log(ArLog::Terse, "ArDataLogger::convertBinaryLog: Error: Unknown block type 0x%x", tag);
+      return false;
+    }
+  }
+  return true;
+}
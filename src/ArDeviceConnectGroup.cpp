@@ -0,0 +1,200 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArDeviceConnectGroup.h"
+#include "Aria/ArASyncTask.h"
+#include "Aria/ariaUtil.h"
+
+/// Connects one device of an ArDeviceConnectGroup, in its own thread or not
+class ArDeviceConnectGroup::Job : public ArASyncTask
+{
+public:
+  Job(const char *groupName, const char *name, int number,
+      ArRetFunctor<bool> *connectFunctor, 
+      const ArDeviceConnectGroup::ConnectPolicy &policy) :
+    myGroupName(groupName), myConnectFunctor(connectFunctor), 
+    myPolicy(policy)
+    {
+      myResult.name = name;
+      myResult.number = number;
+    }
+  virtual ~Job() { delete myConnectFunctor; }
+  virtual void *runThread(void *) override
+    {
+      connect();
+      return NULL;
+    }
+  void connect();
+
+  std::string myGroupName;
+  ArRetFunctor<bool> *myConnectFunctor;
+  ArDeviceConnectGroup::ConnectPolicy myPolicy;
+  ArDeviceConnectGroup::ConnectResult myResult;
+};
+
+void ArDeviceConnectGroup::Job::connect()
+{
+  ArTime started;
+
+  myResult.connected = false;
+  myResult.timedOut = false;
+  myResult.attempts = 0;
+  while (true)
+  {
+    myResult.attempts++;
+    if (myConnectFunctor->invokeR())
+    {
+      myResult.connected = true;
+      break;
+    }
+    if (myResult.attempts > myPolicy.retries)
+      break;
+    if (myPolicy.timeoutMSecs > 0 && 
+	started.mSecSinceLL() + myPolicy.retryDelayMSecs >= 
+	myPolicy.timeoutMSecs)
+    {
+      myResult.timedOut = true;
+      break;
+    }
+    ArLog::log(ArLog::Normal, 
+	       "%s: Could not connect %s, retrying in %d ms (attempt %d of %d)",
+	       myGroupName.c_str(), myResult.name.c_str(), 
+	       myPolicy.retryDelayMSecs, myResult.attempts + 1, 
+	       myPolicy.retries + 1);
+    ArUtil::sleep(myPolicy.retryDelayMSecs);
+  }
+  myResult.mSecs = started.mSecSinceLL();
+}
+
+AREXPORT ArDeviceConnectGroup::ArDeviceConnectGroup(const char *name) :
+  myName(name)
+{
+}
+
+AREXPORT ArDeviceConnectGroup::~ArDeviceConnectGroup()
+{
+  clear();
+}
+
+AREXPORT void ArDeviceConnectGroup::setPolicy(int number, 
+					      const ConnectPolicy &policy)
+{
+  myPolicies[number] = policy;
+}
+
+AREXPORT const ArDeviceConnectGroup::ConnectPolicy &
+ArDeviceConnectGroup::getPolicy(int number) const
+{
+  std::map<int, ConnectPolicy>::const_iterator it = myPolicies.find(number);
+  if (it != myPolicies.end())
+    return (*it).second;
+  return myDefaultPolicy;
+}
+
+AREXPORT void ArDeviceConnectGroup::addDevice(
+	const char *name, int number, ArRetFunctor<bool> *connectFunctor)
+{
+  myJobs.push_back(new Job(myName.c_str(), name, number, connectFunctor, 
+			   getPolicy(number)));
+}
+
+AREXPORT void ArDeviceConnectGroup::clear()
+{
+  for (Job *job : myJobs)
+    delete job;
+  myJobs.clear();
+  myResults.clear();
+  myElapsedMSecs = 0;
+}
+
+/**
+   If the group is concurrent (see setConcurrent()) and there is more
+   than one device, each device is connected in its own thread and this
+   waits for all of them, otherwise they are connected one after
+   another in the order they were added.  Either way each device gets
+   the retries its ConnectPolicy allows.
+
+   @return true if every device connected, see getResults() for which
+   ones did if not
+**/
+AREXPORT bool ArDeviceConnectGroup::connectAll()
+{
+  ArTime started;
+  std::vector<bool> threadStarted(myJobs.size(), false);
+  size_t i;
+  bool ret = true;
+
+  myResults.clear();
+  if (myConcurrent && myJobs.size() > 1)
+  {
+    for (i = 0; i < myJobs.size(); i++)
+    {
+      myJobs[i]->setThreadName(myJobs[i]->myResult.name.c_str());
+      // if we can't make the thread just connect it after the others start
+      threadStarted[i] = (myJobs[i]->create(true, false) == 0);
+    }
+    for (i = 0; i < myJobs.size(); i++)
+    {
+      if (threadStarted[i])
+	myJobs[i]->join();
+      else
+	myJobs[i]->connect();
+    }
+  }
+  else
+  {
+    for (Job *job : myJobs)
+      job->connect();
+  }
+
+  for (Job *job : myJobs)
+  {
+    myResults.push_back(job->myResult);
+    if (!job->myResult.connected)
+      ret = false;
+  }
+  myElapsedMSecs = started.mSecSinceLL();
+  return ret;
+}
+
+AREXPORT bool ArDeviceConnectGroup::wasConnected(int number) const
+{
+  for (const ConnectResult &result : myResults)
+    if (result.number == number)
+      return result.connected;
+  return false;
+}
+
+AREXPORT void ArDeviceConnectGroup::logResults(ArLog::LogLevel level) const
+{
+  ArLog::log(level, "%s: Connected devices %s in %lld ms", myName.c_str(), 
+	     myConcurrent ? "concurrently" : "one at a time", myElapsedMSecs);
+  for (const ConnectResult &result : myResults)
+    ArLog::log(level, "%s:   %s (%d) %s after %d attempt%s in %lld ms%s",
+	       myName.c_str(), result.name.c_str(), result.number, 
+	       result.connected ? "connected" : "failed", result.attempts, 
+	       result.attempts == 1 ? "" : "s", result.mSecs,
+	       result.timedOut ? " (timed out)" : "");
+}
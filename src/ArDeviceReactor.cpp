@@ -0,0 +1,483 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArDeviceReactor.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ArASyncTask.h"
+#include "Aria/ariaUtil.h"
+
+#include <chrono>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/// A connection added to an ArDeviceReactor
+class ArDeviceReactor::Entry
+{
+public:
+  unsigned long long myID = 0;
+  ArDeviceConnection *myConn = NULL;
+  int myFD = -1;
+  ArFunctor1<ArDeviceConnection *> *myReadableCB = NULL;
+  ArFunctor1<ArDeviceConnection *> *myIdleCB = NULL;
+  unsigned int myIdleTimeoutMSecs = 0;
+  ArTime myLastActivity;
+  ArDeviceReactor::ConnectionStats myStats;
+  // a callback is running (in myBusyThread), only touched with myMutex held
+  bool myBusy = false;
+  ArThread::ThreadType myBusyThread;
+  // an event came in while a callback was running
+  bool myNeedsRearm = false;
+  bool myRemoved = false;
+  // removed from its own callback, delete it once the callback returns
+  bool myDeleteWhenDone = false;
+};
+
+/// One of the threads waiting on the epoll set
+class ArDeviceReactor::Worker : public ArASyncTask
+{
+public:
+  Worker(ArDeviceReactor *reactor) : myReactor(reactor) {}
+  virtual void *runThread(void *) override;
+protected:
+  ArDeviceReactor *myReactor;
+};
+
+void *ArDeviceReactor::Worker::runThread(void *)
+{
+  struct epoll_event events[16];
+  int i;
+  int num;
+  bool idle;
+
+  while (getRunning())
+  {
+    // only wake up often if someone wants to hear about idle connections
+    idle = myReactor->myNumIdleTimeouts > 0;
+    num = epoll_wait(myReactor->myEpollFD, events, 16, idle ? 50 : 1000);
+    if (num < 0)
+    {
+      if (errno == EINTR)
+	continue;
+      ArLog::logErrorFromOS(ArLog::Terse, "%s: epoll_wait failed", 
+			    myReactor->myName.c_str());
+      break;
+    }
+    for (i = 0; i < num && getRunning(); i++)
+    {
+      // 0 is the wake up from stop()
+      if (events[i].data.u64 != 0)
+	myReactor->dispatch(events[i].data.u64, events[i].events);
+    }
+    if (idle)
+      myReactor->checkIdle();
+  }
+  return NULL;
+}
+
+AREXPORT ArDeviceReactor::ArDeviceReactor(const char *name) :
+  myName(name)
+{
+  myMutex.setLogName("ArDeviceReactor::myMutex");
+  myIdleCheckMutex.setLogName("ArDeviceReactor::myIdleCheckMutex");
+}
+
+AREXPORT ArDeviceReactor::~ArDeviceReactor()
+{
+  stop();
+  for (std::map<unsigned long long, Entry *>::iterator it = myEntries.begin();
+       it != myEntries.end(); ++it)
+    delete (*it).second;
+  myEntries.clear();
+  if (myEpollFD >= 0)
+    ::close(myEpollFD);
+  if (myWakeFD >= 0)
+    ::close(myWakeFD);
+}
+
+bool ArDeviceReactor::setup()
+{
+  struct epoll_event event;
+
+  if (myEpollFD >= 0)
+    return true;
+  if ((myEpollFD = epoll_create1(EPOLL_CLOEXEC)) < 0)
+  {
+    ArLog::logErrorFromOS(ArLog::Terse, "%s: Could not create epoll set",
+			  myName.c_str());
+    return false;
+  }
+  if ((myWakeFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+  {
+    ArLog::logErrorFromOS(ArLog::Terse, "%s: Could not create eventfd",
+			  myName.c_str());
+    ::close(myEpollFD);
+    myEpollFD = -1;
+    return false;
+  }
+  // this one isn't one shot, so that every worker wakes up on a stop
+  event.events = EPOLLIN;
+  event.data.u64 = 0;
+  epoll_ctl(myEpollFD, EPOLL_CTL_ADD, myWakeFD, &event);
+  return true;
+}
+
+AREXPORT bool ArDeviceReactor::start(int numThreads)
+{
+  int i;
+  Worker *worker;
+
+  myMutex.lock();
+  if (!myWorkers.empty())
+  {
+    myMutex.unlock();
+    return true;
+  }
+  if (!setup())
+  {
+    myMutex.unlock();
+    return false;
+  }
+  if (numThreads < 1)
+    numThreads = 1;
+  for (i = 0; i < numThreads; i++)
+  {
+    worker = new Worker(this);
+    worker->setThreadName(myName.c_str());
+    // device I/O shouldn't run at a lower priority than everything else
+    worker->create(true, false);
+    myWorkers.push_back(worker);
+  }
+  myMutex.unlock();
+  ArLog::log(ArLog::Verbose, "%s: Started %d threads", myName.c_str(), 
+	     numThreads);
+  return true;
+}
+
+AREXPORT void ArDeviceReactor::stop()
+{
+  std::vector<Worker *> workers;
+  uint64_t value = 1;
+  ssize_t ret;
+
+  myMutex.lock();
+  workers.swap(myWorkers);
+  myMutex.unlock();
+  if (workers.empty())
+    return;
+
+  for (Worker *worker : workers)
+    worker->stopRunning();
+  ret = ::write(myWakeFD, &value, sizeof(value));
+  for (Worker *worker : workers)
+  {
+    worker->join();
+    delete worker;
+  }
+  // and empty it again for the next start
+  if (ret > 0)
+    ret = ::read(myWakeFD, &value, sizeof(value));
+}
+
+AREXPORT bool ArDeviceReactor::isRunning() const
+{
+  bool ret;
+  myMutex.lock();
+  ret = !myWorkers.empty();
+  myMutex.unlock();
+  return ret;
+}
+
+void ArDeviceReactor::rearm(Entry *entry)
+{
+  struct epoll_event event;
+
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.u64 = entry->myID;
+  entry->myNeedsRearm = false;
+  if (epoll_ctl(myEpollFD, EPOLL_CTL_MOD, entry->myFD, &event) != 0)
+    ArLog::logErrorFromOS(ArLog::Normal, 
+			  "%s: Could not watch %s again", myName.c_str(), 
+			  entry->myStats.name.c_str());
+}
+
+AREXPORT bool ArDeviceReactor::addConnection(
+	ArDeviceConnection *conn, 
+	ArFunctor1<ArDeviceConnection *> *readableCB,
+	unsigned int idleTimeoutMSecs,
+	ArFunctor1<ArDeviceConnection *> *idleCB)
+{
+  struct epoll_event event;
+  Entry *entry;
+  int fd;
+
+  if (conn == NULL || readableCB == NULL)
+    return false;
+  if ((fd = conn->getFD()) < 0)
+  {
+    ArLog::log(ArLog::Normal, 
+	       "%s: Cannot add connection %s, it isn't open or has no file descriptor",
+	       myName.c_str(), conn->getPortName());
+    return false;
+  }
+
+  myMutex.lock();
+  if (!setup())
+  {
+    myMutex.unlock();
+    return false;
+  }
+  for (std::map<unsigned long long, Entry *>::iterator it = myEntries.begin();
+       it != myEntries.end(); ++it)
+  {
+    if ((*it).second->myConn == conn)
+    {
+      myMutex.unlock();
+      ArLog::log(ArLog::Normal, "%s: Connection %s was already added",
+		 myName.c_str(), conn->getPortName());
+      return false;
+    }
+  }
+
+  entry = new Entry;
+  entry->myID = myNextID++;
+  entry->myConn = conn;
+  entry->myFD = fd;
+  entry->myReadableCB = readableCB;
+  entry->myIdleCB = idleCB;
+  entry->myIdleTimeoutMSecs = idleCB != NULL ? idleTimeoutMSecs : 0;
+  entry->myLastActivity.setToNow();
+  if (conn->getDeviceName() != NULL && conn->getDeviceName()[0] != '\0')
+    entry->myStats.name = conn->getDeviceName();
+  else if (conn->getPortName() != NULL)
+    entry->myStats.name = conn->getPortName();
+
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.u64 = entry->myID;
+  if (epoll_ctl(myEpollFD, EPOLL_CTL_ADD, fd, &event) != 0)
+  {
+    myMutex.unlock();
+    ArLog::logErrorFromOS(ArLog::Normal, "%s: Could not watch %s", 
+			  myName.c_str(), entry->myStats.name.c_str());
+    delete entry;
+    return false;
+  }
+  myEntries[entry->myID] = entry;
+  if (entry->myIdleTimeoutMSecs > 0)
+    myNumIdleTimeouts++;
+  myMutex.unlock();
+  ArLog::log(ArLog::Verbose, "%s: Added %s", myName.c_str(), 
+	     entry->myStats.name.c_str());
+  return true;
+}
+
+AREXPORT bool ArDeviceReactor::remConnection(ArDeviceConnection *conn)
+{
+  std::map<unsigned long long, Entry *>::iterator it;
+  Entry *entry = NULL;
+
+  myMutex.lock();
+  for (it = myEntries.begin(); it != myEntries.end(); ++it)
+  {
+    if ((*it).second->myConn == conn)
+    {
+      entry = (*it).second;
+      myEntries.erase(it);
+      break;
+    }
+  }
+  if (entry == NULL)
+  {
+    myMutex.unlock();
+    return false;
+  }
+  entry->myRemoved = true;
+  if (entry->myIdleTimeoutMSecs > 0)
+    myNumIdleTimeouts--;
+  // this fails if the connection was closed already, which is fine
+  // since closing it took it out of the epoll set too
+  epoll_ctl(myEpollFD, EPOLL_CTL_DEL, entry->myFD, NULL);
+  if (!entry->myBusy)
+  {
+    delete entry;
+    myMutex.unlock();
+    return true;
+  }
+  // if we're being called from its callback let the callback finish
+  if (entry->myBusyThread == ArThread::osSelf())
+  {
+    entry->myDeleteWhenDone = true;
+    myMutex.unlock();
+    return true;
+  }
+  // otherwise wait for the callback to finish in the other thread
+  while (entry->myBusy)
+  {
+    myMutex.unlock();
+    ArUtil::sleep(1);
+    myMutex.lock();
+  }
+  delete entry;
+  myMutex.unlock();
+  return true;
+}
+
+AREXPORT size_t ArDeviceReactor::getNumConnections() const
+{
+  size_t ret;
+  myMutex.lock();
+  ret = myEntries.size();
+  myMutex.unlock();
+  return ret;
+}
+
+void ArDeviceReactor::dispatch(unsigned long long id, unsigned int events)
+{
+  std::map<unsigned long long, Entry *>::iterator it;
+  Entry *entry;
+  std::chrono::steady_clock::time_point started;
+  long long usecs;
+  bool hungUp = (events & (EPOLLHUP | EPOLLERR)) != 0;
+
+  myMutex.lock();
+  if ((it = myEntries.find(id)) == myEntries.end())
+  {
+    myMutex.unlock();
+    return;
+  }
+  entry = (*it).second;
+  // its idle callback is running, whoever finishes that will watch it again
+  if (entry->myBusy)
+  {
+    entry->myNeedsRearm = true;
+    myMutex.unlock();
+    return;
+  }
+  entry->myBusy = true;
+  entry->myBusyThread = ArThread::osSelf();
+  myMutex.unlock();
+
+  started = std::chrono::steady_clock::now();
+  entry->myReadableCB->invoke(entry->myConn);
+  usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+	  std::chrono::steady_clock::now() - started).count();
+
+  myMutex.lock();
+  entry->myBusy = false;
+  entry->myLastActivity.setToNow();
+  entry->myStats.wakeups++;
+  entry->myStats.callbackUSecs += usecs;
+  if (usecs > entry->myStats.maxCallbackUSecs)
+    entry->myStats.maxCallbackUSecs = usecs;
+  if (entry->myDeleteWhenDone)
+  {
+    delete entry;
+  }
+  else if (!entry->myRemoved)
+  {
+    if (hungUp)
+    {
+      entry->myStats.hungUp = true;
+      epoll_ctl(myEpollFD, EPOLL_CTL_DEL, entry->myFD, NULL);
+      ArLog::log(ArLog::Normal, "%s: %s hung up, no longer watching it",
+		 myName.c_str(), entry->myStats.name.c_str());
+    }
+    else
+    {
+      rearm(entry);
+    }
+  }
+  myMutex.unlock();
+}
+
+void ArDeviceReactor::checkIdle()
+{
+  std::vector<Entry *> idle;
+  std::map<unsigned long long, Entry *>::iterator it;
+  Entry *entry;
+
+  // one worker checking is plenty
+  if (myIdleCheckMutex.tryLock() != 0)
+    return;
+
+  myMutex.lock();
+  for (it = myEntries.begin(); it != myEntries.end(); ++it)
+  {
+    entry = (*it).second;
+    if (entry->myIdleTimeoutMSecs > 0 && !entry->myBusy && 
+	!entry->myStats.hungUp &&
+	entry->myLastActivity.mSecSinceLL() >= entry->myIdleTimeoutMSecs)
+    {
+      entry->myBusy = true;
+      entry->myBusyThread = ArThread::osSelf();
+      idle.push_back(entry);
+    }
+  }
+  myMutex.unlock();
+
+  for (Entry *idleEntry : idle)
+  {
+    idleEntry->myIdleCB->invoke(idleEntry->myConn);
+    myMutex.lock();
+    idleEntry->myBusy = false;
+    idleEntry->myLastActivity.setToNow();
+    idleEntry->myStats.idleCallbacks++;
+    if (idleEntry->myDeleteWhenDone)
+      delete idleEntry;
+    else if (!idleEntry->myRemoved && idleEntry->myNeedsRearm)
+      rearm(idleEntry);
+    myMutex.unlock();
+  }
+  myIdleCheckMutex.unlock();
+}
+
+AREXPORT std::vector<ArDeviceReactor::ConnectionStats> 
+ArDeviceReactor::getStats() const
+{
+  std::vector<ConnectionStats> ret;
+  myMutex.lock();
+  for (std::map<unsigned long long, Entry *>::const_iterator it = 
+	 myEntries.begin(); it != myEntries.end(); ++it)
+    ret.push_back((*it).second->myStats);
+  myMutex.unlock();
+  return ret;
+}
+
+AREXPORT void ArDeviceReactor::logStats(ArLog::LogLevel level) const
+{
+  std::vector<ConnectionStats> stats = getStats();
+
+  ArLog::log(level, "%s: %lu connections, %s", myName.c_str(), 
+	     (unsigned long)stats.size(), 
+	     isRunning() ? "running" : "not running");
+  for (const ConnectionStats &conn : stats)
+    ArLog::log(level, 
+	       "%s:   %s: %lu wakeups, %lld usecs in callbacks (max %lld), %lu idle%s",
+	       myName.c_str(), conn.name.c_str(), conn.wakeups, 
+	       conn.callbackUSecs, conn.maxCallbackUSecs, conn.idleCallbacks,
+	       conn.hungUp ? ", hung up" : "");
+}
@@ -0,0 +1,233 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ArFastHash.h"
+
+#include "Aria/ariaOSDef.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+
+#include <algorithm>
+#include <string.h>
+
+// The xxHash64 primes
+static const unsigned long long PRIME1 = 11400714785074694791ULL;
+static const unsigned long long PRIME2 = 14029467366897019727ULL;
+static const unsigned long long PRIME3 =  1609587929392839161ULL;
+static const unsigned long long PRIME4 =  9650029242287828579ULL;
+static const unsigned long long PRIME5 =  2870177450012600261ULL;
+
+static inline unsigned long long rotl64(unsigned long long x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+// little endian reads, byte by byte so alignment and host order don't matter
+static inline unsigned long long read64(const unsigned char *p)
+{
+  return ((unsigned long long)p[0]) | ((unsigned long long)p[1] << 8) |
+    ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24) |
+    ((unsigned long long)p[4] << 32) | ((unsigned long long)p[5] << 40) |
+    ((unsigned long long)p[6] << 48) | ((unsigned long long)p[7] << 56);
+}
+
+static inline unsigned long long read32(const unsigned char *p)
+{
+  return ((unsigned long long)p[0]) | ((unsigned long long)p[1] << 8) |
+    ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24);
+}
+
+static inline unsigned long long round64(unsigned long long acc,
+                                         unsigned long long input)
+{
+  acc += input * PRIME2;
+  acc = rotl64(acc, 31);
+  return acc * PRIME1;
+}
+
+static inline unsigned long long merge64(unsigned long long acc,
+                                         unsigned long long val)
+{
+  acc ^= round64(0, val);
+  return acc * PRIME1 + PRIME4;
+}
+
+AREXPORT unsigned long long ArFastHash::hash(const void *data, size_t len,
+                                             unsigned long long seed)
+{
+  ArFastHash fastHash(seed);
+  fastHash.append(data, len);
+  return fastHash.getHash();
+}
+
+AREXPORT bool ArFastHash::calculateChecksum(const char *fileName,
+                                            unsigned char *digestBuffer,
+                                            size_t digestBufferLen)
+{
+  if (ArUtil::isStrEmpty(fileName)) {
+    return false;
+  }
+  FILE *file = ArUtil::fopen(fileName, "r");
+  if (file == NULL) {
+    ArLog::log(ArLog::Normal,
+               "ArFastHash::calculateChecksum() cannot open %s", fileName);
+    return false;
+  }
+
+  ArFastHash fastHash;
+  char block[65536];
+  size_t len;
+
+  while ((len = fread(block, 1, sizeof(block), file)) > 0) {
+    fastHash.append(block, len);
+  }
+  fclose(file);
+
+  fastHash.getDigest(digestBuffer, digestBufferLen);
+  return true;
+
+} // end method calculateChecksum
+
+AREXPORT ArFastHash::ArFastHash(unsigned long long seed) :
+  mySeed(seed)
+{
+  reset();
+}
+
+AREXPORT void ArFastHash::reset()
+{
+  myAcc[0] = mySeed + PRIME1 + PRIME2;
+  myAcc[1] = mySeed + PRIME2;
+  myAcc[2] = mySeed;
+  myAcc[3] = mySeed - PRIME1;
+  myBufferLen = 0;
+  myTotalLen = 0;
+}
+
+AREXPORT void ArFastHash::append(const void *data, size_t len)
+{
+  const unsigned char *p = (const unsigned char *) data;
+  const unsigned char *end = p + len;
+  size_t fill;
+
+  if (data == NULL || len == 0) {
+    return;
+  }
+  myTotalLen += len;
+
+  // finish a stripe left over from last time
+  if (myBufferLen > 0) {
+    fill = std::min(len, sizeof(myBuffer) - myBufferLen);
+    memcpy(myBuffer + myBufferLen, p, fill);
+    myBufferLen += fill;
+    p += fill;
+    if (myBufferLen < sizeof(myBuffer)) {
+      return;
+    }
+    myAcc[0] = round64(myAcc[0], read64(myBuffer));
+    myAcc[1] = round64(myAcc[1], read64(myBuffer + 8));
+    myAcc[2] = round64(myAcc[2], read64(myBuffer + 16));
+    myAcc[3] = round64(myAcc[3], read64(myBuffer + 24));
+    myBufferLen = 0;
+  }
+
+  while (end - p >= 32) {
+    myAcc[0] = round64(myAcc[0], read64(p));
+    myAcc[1] = round64(myAcc[1], read64(p + 8));
+    myAcc[2] = round64(myAcc[2], read64(p + 16));
+    myAcc[3] = round64(myAcc[3], read64(p + 24));
+    p += 32;
+  }
+
+  if (p < end) {
+    myBufferLen = (size_t)(end - p);
+    memcpy(myBuffer, p, myBufferLen);
+  }
+} // end method append
+
+AREXPORT void ArFastHash::append(const char *str)
+{
+  if (str != NULL) {
+    append(str, strlen(str));
+  }
+}
+
+AREXPORT unsigned long long ArFastHash::getHash() const
+{
+  unsigned long long h;
+  const unsigned char *p = myBuffer;
+  const unsigned char *end = myBuffer + myBufferLen;
+
+  if (myTotalLen >= 32) {
+    h = rotl64(myAcc[0], 1) + rotl64(myAcc[1], 7) + 
+      rotl64(myAcc[2], 12) + rotl64(myAcc[3], 18);
+    h = merge64(h, myAcc[0]);
+    h = merge64(h, myAcc[1]);
+    h = merge64(h, myAcc[2]);
+    h = merge64(h, myAcc[3]);
+  }
+  else {
+    h = mySeed + PRIME5;
+  }
+  h += myTotalLen;
+
+  while (end - p >= 8) {
+    h ^= round64(0, read64(p));
+    h = rotl64(h, 27) * PRIME1 + PRIME4;
+    p += 8;
+  }
+  if (end - p >= 4) {
+    h ^= read32(p) * PRIME1;
+    h = rotl64(h, 23) * PRIME2 + PRIME3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= (*p) * PRIME5;
+    h = rotl64(h, 11) * PRIME1;
+    p++;
+  }
+
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+  return h;
+
+} // end method getHash
+
+AREXPORT void ArFastHash::getDigest(unsigned char *digestBuffer,
+                                    size_t digestBufferLen) const
+{
+  unsigned long long h = getHash();
+  size_t i;
+
+  if (digestBuffer == NULL) {
+    return;
+  }
+  memset(digestBuffer, 0, digestBufferLen);
+  for (i = 0; i < DIGEST_LENGTH && i < digestBufferLen; i++) {
+    digestBuffer[i] = (unsigned char)(h >> (8 * (DIGEST_LENGTH - 1 - i)));
+  }
+} // end method getDigest
@@ -29,6 +29,22 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArArgumentBuilder.h"
 #include <ctype.h>
 #include <assert.h>
+#include <string.h>
+#include <vector>
+
+/// Longest line handed to parseLine() by parseFile(); longer lines are
+/// split into pieces of this size, as fgets() into a 10000 byte buffer did
+static const size_t MAX_LINE_LENGTH = 9999;
+/// Size of the blocks parseFile() reads from disk
+static const size_t READ_BLOCK_SIZE = 65536;
+
+/// Lowercases @a keyword into @a folded, reusing its storage
+static void foldKeyword(const char *keyword, std::string *folded)
+{
+  folded->assign(keyword);
+  for (std::string::iterator it = folded->begin(); it != folded->end(); ++it)
+    *it = (char)tolower(*it);
+}
 
 /**
  * @param baseDirectory the char * name of the base directory; the file name
@@ -47,6 +63,9 @@ AREXPORT ArFileParser::ArFileParser(const char *baseDirectory,
   myPreParseFunctor(NULL),
   myMap(),
   myRemainderHandler(NULL),
+  myBuilder(NULL),
+  myBuilderArgvLen(0),
+  myParseDepth(0),
   myIsQuiet(false),
   myIsPreCompressQuotes(isPreCompressQuotes),
   myIsInterrupted(false),
@@ -70,13 +89,13 @@ AREXPORT ArFileParser::~ArFileParser()
   myMap.clear();
 
   delete myRemainderHandler;
-
+  delete myBuilder;
 }
 
 AREXPORT bool ArFileParser::addHandler(
 	const char *keyword, ArRetFunctor1<bool, ArArgumentBuilder *> *functor)
 {
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   if (keyword == NULL)
   {
     if (myRemainderHandler != NULL)
@@ -92,7 +111,8 @@ AREXPORT bool ArFileParser::addHandler(
     }
   }
 
-  if ((it = myMap.find(keyword)) != myMap.end())
+  foldKeyword(keyword, &myKeyword);
+  if ((it = myMap.find(myKeyword)) != myMap.end())
   {
     if (!myIsQuiet) {
       ArLog::log(ArLog::Verbose, "There is already a functor to handle keyword '%s'", keyword);
@@ -102,7 +122,7 @@ AREXPORT bool ArFileParser::addHandler(
   if (!myIsQuiet) {
     ArLog::log(ArLog::Verbose, "keyword '%s' handler added", keyword);
   }
-  myMap[keyword] = new HandlerCBType(functor);
+  myMap[myKeyword] = new HandlerCBType(functor);
   return true;
 }
 
@@ -116,7 +136,7 @@ AREXPORT bool ArFileParser::addHandlerWithError(
 	const char *keyword, 
 	ArRetFunctor3<bool, ArArgumentBuilder *, char *, size_t> *functor)
 {
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   if (keyword == NULL)
   {
     if (myRemainderHandler != NULL)
@@ -132,7 +152,8 @@ AREXPORT bool ArFileParser::addHandlerWithError(
     }
   }
 
-  if ((it = myMap.find(keyword)) != myMap.end())
+  foldKeyword(keyword, &myKeyword);
+  if ((it = myMap.find(myKeyword)) != myMap.end())
   {
     if (!myIsQuiet) {
       ArLog::log(ArLog::Verbose, "There is already a functor to handle keyword '%s'", keyword);
@@ -142,14 +163,14 @@ AREXPORT bool ArFileParser::addHandlerWithError(
   if (!myIsQuiet) {
     ArLog::log(ArLog::Verbose, "keyword '%s' handler added", keyword);
   }
-  myMap[keyword] = new HandlerCBType(functor);
+  myMap[myKeyword] = new HandlerCBType(functor);
   return true;
 }
 
 AREXPORT bool ArFileParser::remHandler(const char *keyword, 
 				       bool logIfCannotFind)
 {
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   HandlerCBType *handler;
 
   if (keyword == NULL) {
@@ -172,7 +193,8 @@ AREXPORT bool ArFileParser::remHandler(const char *keyword,
   } // end if keyword is null
 
 
-  if ((it = myMap.find(keyword)) == myMap.end())
+  foldKeyword(keyword, &myKeyword);
+  if ((it = myMap.find(myKeyword)) == myMap.end())
   {
     if (logIfCannotFind)
       ArLog::log(ArLog::Normal, "There is no keyword '%s' to remove.", 
@@ -193,7 +215,7 @@ AREXPORT bool ArFileParser::remHandler(const char *keyword,
 AREXPORT bool ArFileParser::remHandler(
 	ArRetFunctor1<bool, ArArgumentBuilder *> *functor)
 {
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   HandlerCBType *handler;
 
   if (myRemainderHandler != NULL && myRemainderHandler->haveFunctor(functor))
@@ -226,7 +248,7 @@ AREXPORT bool ArFileParser::remHandler(
 AREXPORT bool ArFileParser::remHandler(
 	ArRetFunctor3<bool, ArArgumentBuilder *, char *, size_t> *functor)
 {
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   HandlerCBType *handler;
 
   if (myRemainderHandler != NULL && myRemainderHandler->haveFunctor(functor))
@@ -338,7 +360,7 @@ AREXPORT bool ArFileParser::parseLine(char *line,
   size_t len;
   size_t i;
   bool noArgs;
-  std::map<std::string, HandlerCBType *, ArStrCaseCmpOp>::iterator it;
+  HandlerMap::iterator it;
   HandlerCBType *handler = NULL;
 
   myLineNumber++;
@@ -354,7 +376,7 @@ AREXPORT bool ArFileParser::parseLine(char *line,
   for (std::list<std::string>::iterator iter = myCommentDelimiterList.begin();
         iter != myCommentDelimiterList.end();
         iter++) {
-    std::string commentDel = *iter;
+    const std::string &commentDel = *iter;
     if ((choppingPos = strstr(line, commentDel.c_str())) != NULL) {
       line[choppingPos-line] = '\0';
     }
@@ -457,8 +479,10 @@ AREXPORT bool ArFileParser::parseLine(char *line,
   // do a test just because someone could set the remainder handler to
   // some other handler they're using)
   bool usingRemainder = false;
-  // see if we have a handler for the keyword
-  if ((it = myMap.find(keyword)) != myMap.end())
+  // see if we have a handler for the keyword (myKeyword keeps its
+  // storage between lines so this doesn't allocate)
+  myKeyword.assign(keyword);
+  if ((it = myMap.find(myKeyword)) != myMap.end())
   {
     //printf("have handler for keyword %s\n", keyword);
     // we have a handler, so pull that out
@@ -499,20 +523,45 @@ AREXPORT bool ArFileParser::parseLine(char *line,
   // now toss the rest of the argument into an argument builder then
   // form it up to send to the functor
   
-  ArArgumentBuilder builder(myMaxNumArguments,
-                            '\0',  // no special space character
-                            false, // do not ignore normal spaces
-                            myIsPreCompressQuotes); // whether to pre-compress quotes
+  // the same builder is refilled for every line so its storage is
+  // reused; a handler that parses lines with this same parser gets a
+  // builder of its own
+  ArArgumentBuilder *builder;
+  ArArgumentBuilder *nestedBuilder = NULL;
+  if (myParseDepth == 0)
+  {
+    if (myBuilder == NULL || myBuilderArgvLen != myMaxNumArguments)
+    {
+      delete myBuilder;
+      myBuilder = new ArArgumentBuilder(myMaxNumArguments,
+                                        '\0',  // no special space character
+                                        false, // do not ignore normal spaces
+                                        myIsPreCompressQuotes); // whether to pre-compress quotes
+      myBuilderArgvLen = myMaxNumArguments;
+    }
+    myBuilder->reset();
+    builder = myBuilder;
+  }
+  else
+  {
+    nestedBuilder = new ArArgumentBuilder(myMaxNumArguments, '\0', false,
+                                          myIsPreCompressQuotes);
+    builder = nestedBuilder;
+  }
   // if we have arguments add them
   if (!noArgs)
   {
-	  if (!valueStart) return false;
-	  builder.addPlain(valueStart);
+	  if (!valueStart) 
+    {
+      delete nestedBuilder;
+      return false;
+    }
+	  builder->addPlain(valueStart);
   }
   // if not we still set the name of whatever we parsed (unless we
   // didn't have a param of course)
   if (!usingRemainder)
-    builder.setExtraString(keyword);
+    builder->setExtraString(keyword);
 
   // make sure we don't overwrite any errors
   if (errorBuffer != NULL && errorBuffer[0] != '\0')
@@ -523,7 +572,11 @@ AREXPORT bool ArFileParser::parseLine(char *line,
     
   // call the functor and see if there are errors;
   // if we had an error and aren't continuing on errors then we keep going
-  if (!handler->call(&builder, errorBuffer, errorBufferLen))
+  myParseDepth++;
+  bool handled = handler->call(builder, errorBuffer, errorBufferLen);
+  myParseDepth--;
+  delete nestedBuilder;
+  if (!handled)
   {
     // put the line number in the error message (this won't overwrite
     // anything because of the check above
@@ -574,7 +627,6 @@ AREXPORT bool ArFileParser::parseFile(const char *fileName,
 
   FILE *file = NULL;
 
-  char line[10000];
   bool ret = true;
 
   if (errorBuffer)
@@ -612,11 +664,46 @@ AREXPORT bool ArFileParser::parseFile(const char *fileName,
 
   resetCounters();
 
-  // read until the end of the file
-  while (!isInterrupted() &&
-         (fgets(line, sizeof(line), file) != NULL)) 
+  // read the file in large blocks and hand each line to parseLine in
+  // place, instead of copying it out with fgets; the extra byte at the
+  // end leaves room to terminate a last line with no newline
+  std::vector<char> block(READ_BLOCK_SIZE + 1);
+  char *buf = &block[0];
+  size_t start = 0;
+  size_t end = 0;
+  bool atEOF = false;
+  while (!isInterrupted())
   {
-    if (!parseLine(line, errorBuffer, errorBufferLen))
+    char *newline = (char *)memchr(buf + start, '\n', end - start);
+    size_t lineLen;
+    if (newline != NULL)
+      lineLen = (size_t)(newline - (buf + start)) + 1;
+    else if (end - start >= MAX_LINE_LENGTH || (atEOF && end > start))
+      lineLen = end - start;
+    else if (atEOF)
+      break;
+    else
+    {
+      // move the partial line to the front and fill in behind it
+      memmove(buf, buf + start, end - start);
+      end -= start;
+      start = 0;
+      size_t numRead = fread(buf + end, 1, READ_BLOCK_SIZE - end, file);
+      if (numRead == 0)
+        atEOF = true;
+      end += numRead;
+      continue;
+    }
+    if (lineLen > MAX_LINE_LENGTH)
+      lineLen = MAX_LINE_LENGTH;
+
+    char *line = buf + start;
+    char saved = line[lineLen];
+    line[lineLen] = '\0';
+    bool parsed = parseLine(line, errorBuffer, errorBufferLen);
+    line[lineLen] = saved;
+    start += lineLen;
+    if (!parsed)
     {
       ArLog::log(ArLog::Terse, "## Last error on line %d of file '%s'", 
 		             myLineNumber, realFileName.c_str());
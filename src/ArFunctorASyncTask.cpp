@@ -24,13 +24,60 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArExport.h"
 #include "Aria/ariaOSDef.h"
 #include "Aria/ArFunctorASyncTask.h"
+#include "Aria/ArLog.h"
 
-AREXPORT ArFunctorASyncTask::ArFunctorASyncTask(ArRetFunctor1<void *, void *> *functor)
+AREXPORT ArFunctorASyncTask::ArFunctorASyncTask(ArRetFunctor1<void *, void *> *functor) :
+  myPool(NULL),
+  myPoolTask(0),
+  myPoolCB(this, &ArFunctorASyncTask::runPooled)
 {
   setThreadName(functor->getName());
+  myPoolCB.setName(functor->getName());
   myFunc = functor;
 }
 
+AREXPORT ArFunctorASyncTask::~ArFunctorASyncTask()
+{
+  if (myPool != NULL)
+  {
+    stopRunning();
+    myPool->cancel(myPoolTask, true);
+    myPool->remPooledThread(this);
+  }
+}
+
+AREXPORT bool ArFunctorASyncTask::runInPool(ArThreadPool *pool)
+{
+  if (pool == NULL)
+    pool = ArThreadPool::getShared();
+  if (myPool != NULL && myPool->isPending(myPoolTask))
+  {
+    ArLog::log(ArLog::Normal, "%s: Already running in pool %s", 
+	       getThreadName(), myPool->getName());
+    return false;
+  }
+  if (myPool != NULL && myPool != pool)
+    myPool->remPooledThread(this);
+  myPool = pool;
+  myRunning = true;
+  myFinished = false;
+  myPool->addPooledThread(this);
+  if ((myPoolTask = myPool->submit(&myPoolCB)) == 0)
+  {
+    myRunning = false;
+    return false;
+  }
+  return true;
+}
+
+void ArFunctorASyncTask::runPooled()
+{
+  threadStarted();
+  myFunc->invokeR(NULL);
+  myRunning = false;
+  threadFinished();
+}
+
 AREXPORT void *ArFunctorASyncTask::runThread(void* arg)
 {
   threadStarted();
@@ -26,12 +26,16 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaOSDef.h"
 #include "Aria/ArGPS.h"
 #include "Aria/ArDeviceConnection.h"
+#ifndef _WIN32
+#include "Aria/ArDeviceReactor.h"
+#endif
 #include "Aria/ArRobotPacket.h"
 #include "Aria/ArRobot.h"
 #include "Aria/ArCommands.h"
 #include "Aria/ariaInternal.h"
 
 #include <iostream>
+#include <chrono>
 
 
 //#define DEBUG_ARGPS 1
@@ -91,6 +95,8 @@ AREXPORT ArGPS::ArGPS() :
 
   // objects
   myDevice(NULL),
+  myReactor(NULL),
+  myReactorCB(this, &ArGPS::reactorReadable),
   myNMEAParser("GPS"),
 
   // handler functors
@@ -104,7 +110,11 @@ AREXPORT ArGPS::ArGPS() :
   mySNRSum(0),
   mySNRNum(0),
   myGPMSSHandler(this, &ArGPS::handleGPMSS),
-  myGPGSTHandler(this, &ArGPS::handleGPGST)
+  myGPGSTHandler(this, &ArGPS::handleGPGST),
+  myNumFixWaiters(0),
+  myFixIntervalSum(0),
+  myFixIntervalSumSq(0),
+  myParseUSecsSum(0)
 {
   addNMEAHandler("RMC", &myGPRMCHandler);
   addNMEAHandler("GGA", &myGPGGAHandler);
@@ -124,6 +134,42 @@ AREXPORT ArGPS::ArGPS() :
   myMutex.setLogName("ArGPS::myMutex");
 }
 
+AREXPORT ArGPS::~ArGPS()
+{
+  setReactor(NULL);
+}
+
+AREXPORT bool ArGPS::setReactor(ArDeviceReactor *reactor)
+{
+#ifndef _WIN32
+  if (myReactor != NULL && myDevice != NULL)
+    myReactor->remConnection(myDevice);
+  myReactor = NULL;
+  if (reactor == NULL)
+    return true;
+  if (myDevice == NULL)
+  {
+    ArLog::log(ArLog::Terse, "GPS Error: Cannot use a reactor without a device connection.");
+    return false;
+  }
+  if (!reactor->addConnection(myDevice, &myReactorCB))
+    return false;
+  myReactor = reactor;
+  return true;
+#else
+  if (reactor != NULL)
+    ArLog::log(ArLog::Terse, "GPS Error: ArDeviceReactor is not available on Windows.");
+  return reactor == NULL;
+#endif
+}
+
+void ArGPS::reactorReadable(ArDeviceConnection *)
+{
+  // bounded so that a chatty GPS can't hog a reactor thread, if there's
+  // still data the reactor calls us again right away
+  readWithLock(50);
+}
+
 
 
 
@@ -174,6 +220,7 @@ AREXPORT int ArGPS::read(unsigned long maxTime)
   if (!myDevice) return ReadError;
   ArTime startTime;
   startTime.setToNow();
+  const std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
   int result = 0;
   while(maxTime == 0 || startTime.mSecSince() < (long)maxTime) 
   {
@@ -183,17 +230,168 @@ AREXPORT int ArGPS::read(unsigned long maxTime)
 #ifdef DEBUG_ARGPS
       std::cerr << "ArGPS: finished reading all available data (or error reading).\n";
 #endif
-      return result;
+      break;
     }
   }
 #ifdef DEBUG_ARGPS
-  if(maxTime != 0)
+  if(maxTime != 0 && !(result & ReadError || result & ReadFinished))
     fprintf(stderr, "ArGPS::read() reached maxTime %lu (time=%lu), returning.\n", maxTime, startTime.mSecSince());
 #endif
-    
+  {
+    std::lock_guard<std::mutex> lock(myFixStatsMutex);
+    myParserStats = myNMEAParser.getStats();
+  }
+  if(result & ReadUpdated)
+    publishFix(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - parseStart).count());
   return result;
 }
 
+AREXPORT void ArGPS::publishFix(long long parseUSecs)
+{
+  Fix fix;
+  fix.receivedUSecs = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  fix.latitude = myData.latitude;
+  fix.longitude = myData.longitude;
+  fix.altitude = myData.altitude;
+  fix.speed = myData.speed;
+  fix.HDOP = myData.HDOP;
+  fix.VDOP = myData.VDOP;
+  fix.PDOP = myData.PDOP;
+  fix.latitudeError = myData.latLonError.getX();
+  fix.longitudeError = myData.latLonError.getY();
+  fix.altitudeError = myData.altitudeError;
+  fix.fixType = myData.fixType;
+  fix.numSatellitesTracked = myData.numSatellitesTracked;
+  fix.havePosition = myData.havePosition;
+  fix.haveAltitude = myData.haveAltitude;
+  fix.haveSpeed = myData.haveSpeed;
+  fix.haveHDOP = myData.haveHDOP;
+  fix.haveVDOP = myData.haveVDOP;
+  fix.havePDOP = myData.havePDOP;
+  fix.haveLatLonError = myData.haveLatLonError;
+  fix.haveAltitudeError = myData.haveAltitudeError;
+  fix.qualityFlag = myData.qualityFlag;
+
+  // A new position if the position message was received again, or (for
+  // devices whose handlers don't set timeGotPosition) the position changed.
+  // Anything else is a refresh of the same fix.
+  const bool newPosition = fix.havePosition && (
+    myLastFix.sequence == 0 ||
+    !myData.timeGotPosition.isAt(myLastFixTimeGotPosition) ||
+    !myData.GPSPositionTimestamp.isAt(myLastFixGPSTimestamp) ||
+    fix.latitude != myLastFix.latitude || fix.longitude != myLastFix.longitude);
+  fix.sequence = myLastFix.sequence + (newPosition ? 1 : 0);
+  if(!newPosition)
+    fix.receivedUSecs = myLastFix.receivedUSecs;
+
+  {
+    std::lock_guard<std::mutex> lock(myFixStatsMutex);
+    if(newPosition)
+    {
+      if(myFixStats.numFixes > 0)
+      {
+        const double interval = (double)(fix.receivedUSecs - myLastFix.receivedUSecs) / 1000.0;
+        const unsigned long long n = myFixStats.numFixes; // intervals after this one
+        myFixIntervalSum += interval;
+        myFixIntervalSumSq += interval * interval;
+        if(n == 1 || interval < myFixStats.minFixIntervalMSecs)
+          myFixStats.minFixIntervalMSecs = interval;
+        if(n == 1 || interval > myFixStats.maxFixIntervalMSecs)
+          myFixStats.maxFixIntervalMSecs = interval;
+        myFixStats.meanFixIntervalMSecs = myFixIntervalSum / (double)n;
+        const double var = myFixIntervalSumSq / (double)n -
+          myFixStats.meanFixIntervalMSecs * myFixStats.meanFixIntervalMSecs;
+        myFixStats.fixIntervalJitterMSecs = var > 0 ? sqrt(var) : 0.0;
+      }
+      ++myFixStats.numFixes;
+    }
+    if(parseUSecs >= 0)
+    {
+      ++myFixStats.numParses;
+      myParseUSecsSum += (double)parseUSecs;
+      myFixStats.meanParseUSecs = myParseUSecsSum / (double)myFixStats.numParses;
+      if(parseUSecs > myFixStats.maxParseUSecs)
+        myFixStats.maxParseUSecs = parseUSecs;
+    }
+  }
+
+  myLastFix = fix;
+  myLastFixTimeGotPosition = myData.timeGotPosition;
+  myLastFixGPSTimestamp = myData.GPSPositionTimestamp;
+  myLatestFix.write(fix);
+
+  // Pairs with the fence in waitForNextFix(): either the waiter sees the new
+  // sequence before sleeping, or we see the waiter and notify it.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if(newPosition && myNumFixWaiters.load(std::memory_order_relaxed) > 0)
+  {
+    { std::lock_guard<std::mutex> lock(myFixWaitMutex); }
+    myFixWaitCond.notify_all();
+  }
+}
+
+AREXPORT ArGPS::Fix ArGPS::getLatestFix() const
+{
+  return myLatestFix.read();
+}
+
+AREXPORT bool ArGPS::waitForNextFix(ArGPS::Fix *fix, unsigned long long afterSequence, unsigned int timeoutMSecs)
+{
+  Fix latest = myLatestFix.read();
+  if(latest.sequence <= afterSequence && timeoutMSecs > 0)
+  {
+    const std::chrono::steady_clock::time_point until =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMSecs);
+    std::unique_lock<std::mutex> lock(myFixWaitMutex);
+    myNumFixWaiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while((latest = myLatestFix.read()).sequence <= afterSequence)
+    {
+      if(myFixWaitCond.wait_until(lock, until) == std::cv_status::timeout)
+      {
+        latest = myLatestFix.read();
+        break;
+      }
+    }
+    myNumFixWaiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+  if(latest.sequence <= afterSequence)
+    return false;
+  if(fix)
+    *fix = latest;
+  return true;
+}
+
+AREXPORT ArGPS::FixStats ArGPS::getFixStats() const
+{
+  std::lock_guard<std::mutex> lock(myFixStatsMutex);
+  FixStats stats = myFixStats;
+  stats.numSentences = myParserStats.sentences - myParserStatsAtReset.sentences;
+  stats.numHandledSentences = myParserStats.handled - myParserStatsAtReset.handled;
+  stats.numDroppedSentences = myParserStats.dropped - myParserStatsAtReset.dropped;
+  return stats;
+}
+
+AREXPORT void ArGPS::resetFixStats()
+{
+  std::lock_guard<std::mutex> lock(myFixStatsMutex);
+  myFixStats = FixStats();
+  myFixIntervalSum = myFixIntervalSumSq = myParseUSecsSum = 0;
+  myParserStatsAtReset = myParserStats;
+}
+
+AREXPORT void ArGPS::logFixStats(ArLog::LogLevel level) const
+{
+  const FixStats stats = getFixStats();
+  ArLog::log(level, "ArGPS: %llu fixes, interval mean %.1f ms jitter %.1f ms (min %.1f max %.1f); %lu reads, parse mean %.0f us max %lld us; %lu sentences, %lu handled, %lu dropped",
+    stats.numFixes, stats.meanFixIntervalMSecs, stats.fixIntervalJitterMSecs,
+    stats.minFixIntervalMSecs, stats.maxFixIntervalMSecs, stats.numParses,
+    stats.meanParseUSecs, stats.maxParseUSecs, stats.numSentences,
+    stats.numHandledSentences, stats.numDroppedSentences);
+}
+
 // Key navigation data (position, etc.)
 void ArGPS::handleGPRMC(ArNMEAParser::Message msg)
 {
@@ -791,7 +989,7 @@ bool ArSimulatedGPS::connect(UNUSED unsigned long connectTimeout)
   */
   if(myRobot)
   {
-    myRobot->addPacketHandler(&mySimStatHandlerCB);
+    myRobot->addPacketHandler(&mySimStatHandlerCB, {0x62});
     ArLog::log(ArLog::Normal, "ArSimulatedGPS: Requesting data from the simulated robot.");
     myRobot->comInt(ArCommands::SIM_STAT, 2);
   }
@@ -262,21 +262,7 @@ AREXPORT bool
 ArMapGPSCoords::convertLLA2MapCoords(const double lat, const double lon, const double alt,
 				     double& ea, double& no, double& up) const
 {						    
-  if(!myOriginSet)
-    return false;
-
-  const ArLLACoords lla(lat, lon, alt);
-  const ArECEFCoords ecef = lla.LLA2ECEF();
-  const ArENUCoords enu = ecef.ECEF2ENU(myOriginECEF);
-//  ArLog::log(ArLog::Normal, "GPSLocaLog: convertLLA2MapCoords: ENU %g %g %g",
-//	     enu.getX(), enu.getY(), enu.getZ());
-  ea = enu.getX();//enu(0);
-  no = enu.getY();//enu(1);
-  up = enu.getZ();//enu(2);
-//  ArLog::log(ArLog::Normal, 
-//	     "GPSLocaLog: convertLLA2MapCoords: ENU + offset %g %g %g",
-//	     ea, no, up);
-  return true;
+  return convertLLA2MapCoords(&lat, &lon, &alt, &ea, &no, &up, 1);
 }
 /*!
  *  Actual function which does the conversion from ENU coords to LLA coords.
@@ -294,20 +280,150 @@ AREXPORT bool
 ArMapGPSCoords::convertMap2LLACoords(const double ea, const double no, const double up,
 				     double& lat, double& lon, double& alt) const
 {						    
+  return convertMap2LLACoords(&ea, &no, &up, &lat, &lon, &alt, 1);
+}
+
+/*!
+ * Sets the origin of the map, and the rotation from ECEF to the map's
+ * East North Up axes at the origin (the same one ECEF2ENU() and
+ * ENU2ECEF() work out each time, with geocentric latitude).
+ *
+ * @param org: The LLA coords of the origin.
+ */
+AREXPORT void
+ArMapGPSCoords::setOrigin(const ArLLACoords& org)
+{
+  myOriginSet = true;
+  myOriginLLA = org;
+  myOriginECEF = myOriginLLA.LLA2ECEF();
+
+  const double Xr = myOriginECEF.getX();
+  const double Yr = myOriginECEF.getY();
+  const double Zr = myOriginECEF.getZ();
+  const double phiP = atan2(Zr, sqrt(Xr*Xr + Yr*Yr));
+  const double lambda = atan2(Yr, Xr);
+  const double sinPhi = sin(phiP);
+  const double cosPhi = cos(phiP);
+  const double sinLambda = sin(lambda);
+  const double cosLambda = cos(lambda);
+
+  // east
+  myRot[0][0] = -sinLambda;
+  myRot[0][1] = cosLambda;
+  myRot[0][2] = 0;
+  // north
+  myRot[1][0] = -sinPhi*cosLambda;
+  myRot[1][1] = -sinPhi*sinLambda;
+  myRot[1][2] = cosPhi;
+  // up
+  myRot[2][0] = cosPhi*cosLambda;
+  myRot[2][1] = cosPhi*sinLambda;
+  myRot[2][2] = sinPhi;
+}
+
+/*!
+ * Converts arrays of LLA coords to map coords.  This is LLA2ECEF()
+ * followed by ECEF2ENU() for each point, with the origin's part of the
+ * work done once in setOrigin().
+ *
+ * @return true if conversion is possible else false.
+ */
+AREXPORT bool
+ArMapGPSCoords::convertLLA2MapCoords(const double *lat, const double *lon,
+				     const double *alt, double *ea,
+				     double *no, double *up, 
+				     size_t count) const
+{
   if(!myOriginSet)
     return false;
 
-  const ArENUCoords enu(ea, no, up);
-  const ArECEFCoords ecef = enu.ENU2ECEF(myOriginLLA);
-  const ArLLACoords lla = ecef.ECEF2LLA();
+  // the same WGS84 constants LLA2ECEF() uses
+  const double a = ArWGS84::A;
+  const double e2 = ArWGS84::E * ArWGS84::E;
+  const double Xr = myOriginECEF.getX();
+  const double Yr = myOriginECEF.getY();
+  const double Zr = myOriginECEF.getZ();
+  const double degToRad = M_PI/180.0;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    const double la = lat[i]*degToRad;
+    const double lo = lon[i]*degToRad;
+    const double h = alt[i];
+    const double sinLat = sin(la);
+    const double cosLat = cos(la);
+    const double N = a / sqrt(1 - e2*sinLat*sinLat);
+    const double dx = (N + h)*cosLat*cos(lo) - Xr;
+    const double dy = (N + h)*cosLat*sin(lo) - Yr;
+    const double dz = ((1 - e2)*N + h)*sinLat - Zr;
+
+    // in mm
+    ea[i] = (myRot[0][0]*dx + myRot[0][1]*dy) * 1000.0;
+    no[i] = (myRot[1][0]*dx + myRot[1][1]*dy + myRot[1][2]*dz) * 1000.0;
+    up[i] = (myRot[2][0]*dx + myRot[2][1]*dy + myRot[2][2]*dz) * 1000.0;
+  }
+  return true;
+}
 
-//  ArLog::log(ArLog::Normal, "GPSLocaLog: convertMap2LLACoords: ENU %g %g %g",
-//	     enu.getX(), enu.getY(), enu.getZ());  
-  lat = lla.getX();//lla(0);
-  lon = lla.getY();//lla(1);
-  alt = lla.getZ();//lla(2);
-  
-//  ArLog::log(ArLog::Normal, "GPSLocaLog: convertMap2LLACoords: %g %g %g",
-//	     lat, lon, alt);
+/*!
+ * Converts arrays of map coords to LLA coords.  This is ENU2ECEF()
+ * followed by ECEF2LLA() for each point, with the origin's part of the
+ * work done once in setOrigin().
+ *
+ * @return true if conversion is possible else false.
+ */
+AREXPORT bool
+ArMapGPSCoords::convertMap2LLACoords(const double *ea, const double *no,
+				     const double *up, double *lat,
+				     double *lon, double *alt, 
+				     size_t count) const
+{
+  if(!myOriginSet)
+    return false;
+
+  // the same WGS84 constants ECEF2LLA() uses
+  const double a = ArWGS84::A;
+  const double b = ArWGS84::B;
+  const double e2 = ArWGS84::E * ArWGS84::E;
+  const double ep2 = ArWGS84::EP * ArWGS84::EP;
+  const double Xr = myOriginECEF.getX();
+  const double Yr = myOriginECEF.getY();
+  const double Zr = myOriginECEF.getZ();
+  const double radToDeg = 180.0/M_PI;
+  size_t i;
+
+  for (i = 0; i < count; i++)
+  {
+    // from mm
+    const double e = ea[i]/1000.0;
+    const double n = no[i]/1000.0;
+    const double u = up[i]/1000.0;
+    // the transpose of the rotation takes ENU back to ECEF
+    const double x = myRot[0][0]*e + myRot[1][0]*n + myRot[2][0]*u + Xr;
+    const double y = myRot[0][1]*e + myRot[1][1]*n + myRot[2][1]*u + Yr;
+    const double z = myRot[1][2]*n + myRot[2][2]*u + Zr;
+
+    const double p = sqrt(x*x + y*y);
+    const double th = atan2(a*z, b*p);
+    const double sinTh = sin(th);
+    const double cosTh = cos(th);
+    double lo = atan2(y, x);
+    const double la = atan2(z + ep2*b*sinTh*sinTh*sinTh,
+			    p - e2*a*cosTh*cosTh*cosTh);
+    const double sinLat = sin(la);
+    const double N = a / sqrt(1 - e2*sinLat*sinLat);
+    double h = p / cos(la) - N;
+
+    if(lo < -M_PI)
+      lo += 2*M_PI;
+    // the same correction near the poles as ECEF2LLA()
+    if(fabs(x) < 1 && fabs(y) < 1)
+      h = -b;
+
+    lat[i] = la*radToDeg;
+    lon[i] = lo*radToDeg;
+    alt[i] = h;
+  }
   return true;
 }
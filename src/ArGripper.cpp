@@ -43,7 +43,7 @@ AREXPORT ArGripper::ArGripper(ArRobot *robot, ArGripper::Type gripperType) :
   myType = gripperType;
   if (myRobot != NULL) 
   {
-    myRobot->addPacketHandler(&myPacketHandlerCB, ArListPos::FIRST);
+    myRobot->addPacketHandler(&myPacketHandlerCB, {0xE0}, ArListPos::FIRST);
     myRobot->addConnectCB(&myConnectCB, ArListPos::LAST);
     if (myRobot->isConnected() && (myType == GRIPPAC || myType == QUERYTYPE))
       myRobot->comInt(ArCommands::GRIPPERPACREQUEST, 2);
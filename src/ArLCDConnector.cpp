@@ -64,6 +64,7 @@ AREXPORT ArLCDConnector::ArLCDConnector (
   ArLog::LogLevel infoLogLevel,
   ArRetFunctor1<bool, const char *> *turnOnPowerOutputCB,
   ArRetFunctor1<bool, const char *> *turnOffPowerOutputCB) :
+  myConnectGroup ("ArLCDConnector"),
   myParseArgsCB (this, &ArLCDConnector::parseArgs),
   myLogOptionsCB (this, &ArLCDConnector::logOptions),
 	myTurnOnPowerCB(this, &ArLCDConnector::turnOnPowerCB),
@@ -676,6 +677,7 @@ AREXPORT bool ArLCDConnector::connectLCDs (
 {
 	std::map<int, LCDData *>::iterator it;
 	LCDData *lcdData = NULL;
+	bool ret = true;
 	ArLog::log (myInfoLogLevel,
 	            "ArLCDConnector::connectLCDs() Connecting lcds");
 	if (myAutoParseArgs && !myParsedArgs) {
@@ -704,6 +706,7 @@ AREXPORT bool ArLCDConnector::connectLCDs (
 			return false;
 		}
 	}
+	myConnectGroup.clear();
 	for (it = myLCDs.begin(); it != myLCDs.end(); it++) {
 
 		lcdData = (*it).second;
@@ -722,48 +725,70 @@ AREXPORT bool ArLCDConnector::connectLCDs (
 			            "ArLCDConnector::connectLCDs: Connecting %s",
 			            lcdData->myLCD->getName());
 			lcdData->myLCD->setRobot (myRobot);
-			bool connected = false;
-			connected = lcdData->myLCD->blockingConnect(myLCDLogPacketsSent, 
-												myLCDLogPacketsReceived, lcdData->myNumber,
-												&myTurnOnPowerCB, &myTurnOffPowerCB);
-			if (connected) {
-				if (!addAllLCDsToRobot && addConnectedLCDsToRobot) {
-					if (myRobot != NULL) {
-						myRobot->addLCD (lcdData->myLCD, lcdData->myNumber);
-						//myRobot->addRangeDevice(lcdData->myLCD);
-						ArLog::log (ArLog::Verbose,
-						            "ArLCDConnector::connectLCDs: Added %s to robot",
-						            lcdData->myLCD->getName());
-					} else {
-						ArLog::log (ArLog::Normal,
-						            "ArLCDConnector::connectLCDs: Could not add %s to robot, since there is no robot",
-						            lcdData->myLCD->getName());
-					}
-				} else if (addAllLCDsToRobot && myRobot != NULL) {
-					ArLog::log (ArLog::Verbose,
-					            "ArLCDConnector::connectLCDs: %s already added to robot)",
-					            lcdData->myLCD->getName());
-				} else if (myRobot != NULL) {
+			myConnectGroup.addDevice (lcdData->myLCD->getName(),
+			                          lcdData->myNumber,
+			                          new ArRetFunctor1C<bool, ArLCDConnector, LCDData *> (
+			                            this, &ArLCDConnector::internalConnectLCD, lcdData));
+		}
+	}
+
+	// now connect them all at once (unless the group was set not to)
+	myConnectGroup.connectAll();
+	myConnectGroup.logResults (myInfoLogLevel);
+
+	for (const ArDeviceConnectGroup::ConnectResult &result :
+	     myConnectGroup.getResults()) {
+		lcdData = myLCDs[result.number];
+		if (result.connected) {
+			if (!addAllLCDsToRobot && addConnectedLCDsToRobot) {
+				if (myRobot != NULL) {
+					myRobot->addLCD (lcdData->myLCD, lcdData->myNumber);
+					//myRobot->addRangeDevice(lcdData->myLCD);
 					ArLog::log (ArLog::Verbose,
-					            "ArLCDConnector::connectLCDs: Did not add %s to robot",
+					            "ArLCDConnector::connectLCDs: Added %s to robot",
 					            lcdData->myLCD->getName());
-				}
-			} else {
-				if (!continueOnFailedConnect) {
-					ArLog::log (ArLog::Normal,
-					            "ArLCDConnector::connectLCDs: Could not connect %s, stopping",
-					            lcdData->myLCD->getName());
-					return false;
-				} else
+				} else {
 					ArLog::log (ArLog::Normal,
-					            "ArLCDConnector::connectLCDs: Could not connect %s, continuing with remainder of lcds",
+					            "ArLCDConnector::connectLCDs: Could not add %s to robot, since there is no robot",
 					            lcdData->myLCD->getName());
+				}
+			} else if (addAllLCDsToRobot && myRobot != NULL) {
+				ArLog::log (ArLog::Verbose,
+				            "ArLCDConnector::connectLCDs: %s already added to robot)",
+				            lcdData->myLCD->getName());
+			} else if (myRobot != NULL) {
+				ArLog::log (ArLog::Verbose,
+				            "ArLCDConnector::connectLCDs: Did not add %s to robot",
+				            lcdData->myLCD->getName());
 			}
+		} else {
+			if (!continueOnFailedConnect) {
+				ArLog::log (ArLog::Normal,
+				            "ArLCDConnector::connectLCDs: Could not connect %s, failing",
+				            lcdData->myLCD->getName());
+				ret = false;
+			} else
+				ArLog::log (ArLog::Normal,
+				            "ArLCDConnector::connectLCDs: Could not connect %s, continuing with remainder of lcds",
+				            lcdData->myLCD->getName());
 		}
 	}
 	ArLog::log (myInfoLogLevel,
 	            "ArLCDConnector: Done connecting lcds");
-	return true;
+	return ret;
+}
+
+/**
+   Makes one connection attempt for an lcd, this is what connectLCDs()
+   has myConnectGroup call for each lcd, so it is run in that lcd's own
+   thread.
+   @internal
+**/
+bool ArLCDConnector::internalConnectLCD (LCDData *lcdData)
+{
+	return lcdData->myLCD->blockingConnect(myLCDLogPacketsSent, 
+	                                      myLCDLogPacketsReceived, lcdData->myNumber,
+	                                      &myTurnOnPowerCB, &myTurnOffPowerCB);
 }
 
 AREXPORT bool ArLCDConnector::turnOnPower (LCDData *lcd)
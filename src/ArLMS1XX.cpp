@@ -26,6 +26,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArLMS1XX.h"
 #include "Aria/ArRobot.h"
 #include "Aria/ArSerialConnection.h"
+#include "Aria/ArDeviceReactor.h"
 #include "Aria/ariaInternal.h"
 #include <time.h>
 #include <cstddef>
@@ -851,7 +852,9 @@ AREXPORT ArLMS1XX::ArLMS1XX(int laserNumber,
 		const char *name, LaserModel laserModel) :
 		ArLaser(laserNumber, name, 20000),
 		mySensorInterpTask(this, &ArLMS1XX::sensorInterp),
-		myAriaExitCB(this, &ArLMS1XX::disconnect)
+		myAriaExitCB(this, &ArLMS1XX::disconnect),
+		myReactorReadableCB(this, &ArLMS1XX::reactorReadable),
+		myReactorIdleCB(this, &ArLMS1XX::reactorIdle)
 {
 
 	myLaserModel = laserModel;
@@ -1089,6 +1092,7 @@ AREXPORT ArLMS1XX::~ArLMS1XX()
 	if (isConnected())
 		disconnect();
 	unlockDevice();
+	stopReactorReading();
 }
 
 void ArLMS1XX::clear()
@@ -1116,7 +1120,6 @@ void ArLMS1XX::clear()
 	myNumberEncoders = 0;
 	myNumChans16Bit = 0;
 	myNumChans8Bit = 0;
-	myFirstReadings = true;
 }
 
 AREXPORT void ArLMS1XX::laserSetName(const char *name)
@@ -1165,10 +1168,106 @@ AREXPORT bool ArLMS1XX::disconnect()
 
 	ArLog::log(ArLog::Normal, "%s: Disconnecting", getName());
 
+	stopReactorReading();
 	laserDisconnectNormally();
 	return true;
 }
 
+AREXPORT bool ArLMS1XX::setReactor(ArDeviceReactor *reactor)
+{
+	if (isConnected())
+	{
+		ArLog::log(ArLog::Terse,
+				"%s::setReactor() Cannot change the reactor while connected",
+				getName());
+		return false;
+	}
+#ifndef _WIN32
+	myReactor = reactor;
+	return true;
+#else
+	if (reactor != NULL)
+		ArLog::log(ArLog::Terse,
+				"%s::setReactor() ArDeviceReactor is not available on Windows", getName());
+	return reactor == NULL;
+#endif
+}
+
+/**
+   Called once the laser is connected.  Without a reactor the laser's
+   own thread (which blockingConnect() started) reads the scans, with
+   one the connection is added to the reactor, or if that fails we fall
+   back to the thread.
+**/
+bool ArLMS1XX::startReading()
+{
+#ifndef _WIN32
+	if (myReactor != NULL)
+	{
+		if (myReactor->addConnection(myConn, &myReactorReadableCB, 500,
+					     &myReactorIdleCB))
+		{
+			myReactorReading = true;
+			return true;
+		}
+		ArLog::log(ArLog::Normal,
+				"%s::startReading() Could not add the connection to the reactor, reading from our own thread instead",
+				getName());
+	}
+#endif
+	if (!getRunning())
+		runAsync();
+	return true;
+}
+
+void ArLMS1XX::stopReactorReading()
+{
+#ifndef _WIN32
+	if (myReactorReading)
+		myReactor->remConnection(myConn);
+#endif
+	myReactorReading = false;
+}
+
+void ArLMS1XX::reactorReadable(ArDeviceConnection *)
+{
+	ArLMS1XXPacket *packet;
+
+	// the receiver keeps what it has of a packet between calls, so
+	// there's no need to wait for the rest, we'll be called when it comes
+	while (myIsConnected &&
+	       (packet = myReceiver.receivePacket(0, true, true)) != NULL)
+	{
+		myPacketsMutex.lock();
+		myPackets.push_back(packet);
+		myPacketsMutex.unlock();
+
+		if (myRobot == NULL)
+			sensorInterp();
+	}
+	reactorCheckLostConnection();
+}
+
+void ArLMS1XX::reactorIdle(ArDeviceConnection *)
+{
+	reactorCheckLostConnection();
+}
+
+/// Does what runThread() does when nothing has come in for too long
+void ArLMS1XX::reactorCheckLostConnection()
+{
+	if (!myIsConnected || !laserCheckLostConnection())
+		return;
+	ArLog::log(ArLog::Terse,
+			"%s::reactorCheckLostConnection()  Lost connection to the laser because of error.  Nothing received for %g seconds (greater than the timeout of %g).", getName(),
+			(double)myLastReading.mSecSince()/1000.0,
+			getConnectionTimeoutSeconds());
+	myIsConnected = false;
+	// we're in one of its callbacks, which it allows
+	stopReactorReading();
+	laserDisconnectOnError();
+}
+
 void ArLMS1XX::failedToConnect()
 {
 	lockDevice();
@@ -1436,12 +1535,9 @@ void ArLMS1XX::sensorInterp ()
 			eachStartingAngle, eachAngularStepWidth,
 			eachNumberData);
 			*/
-			// If we don't have any sensor readings created at all, make 'em all
-			if (myRawReadings->size() == 0)
-				for (size_t j = 0; j < eachNumberData; j++)
-					myRawReadings->push_back (new ArSensorReading);
-
-			if (eachNumberData > myRawReadings->size()) {
+			// the distances set up the readings (below), anything else has
+			// to fit in the readings they set up
+			if (!measuringDistance && eachNumberData > myRawReadings->size()) {
 				ArLog::log (ArLog::Terse, "%s::sensorInterp() Bad data, in theory have %d readings but can only have %d... skipping this packet\n",
 				            getName(), myRawReadings->size(), eachNumberData);
 				//printf("%s\n", packet->getBuf());
@@ -1484,6 +1580,10 @@ void ArLMS1XX::sensorInterp ()
 				}
 			}
 			startedProcessing = true;
+			// make sure there's a reading for each beam, this only does
+			// the sin/cos when the scan's geometry changes
+			if (measuringDistance)
+				laserSetBeams (eachNumberData, start, increment);
 			bool ignore;
 
 			for (atDeg = start,
@@ -1502,11 +1602,6 @@ void ArLMS1XX::sensorInterp ()
 
         ArSensorReading* reading = (*it);
 
-				if (myFirstReadings)
-					reading->resetSensorPosition (ArMath::roundInt (mySensorPose.getX()),
-					                              ArMath::roundInt (mySensorPose.getY()),
-					                              atDeg);
-
         // was configured to have restricted fov, set ignore flag. (Move to ArLaser or other shared class?)
         if (    (canSetDegrees()    && (atDegLocal < getStartDegrees()             || atDegLocal > getEndDegrees()))
              || (canChooseDegrees() && (atDegLocal < -getDegreesChoiceDouble()/2.0 || atDegLocal > getDegreesChoiceDouble()/2.0))
@@ -1557,8 +1652,9 @@ void ArLMS1XX::sensorInterp ()
 					  eachChanMeasured, dist);
 					  }
 					*/
-					reading->newData (dist, pose, encoderPose, transform, counter,
-					                  time, ignore, 0); // no reflector yet
+					myBeamRanges[onReading] = dist;
+					myBeamIgnore[onReading] = ignore;
+					myBeamExtraInts[onReading] = 0; // no reflector yet
 				} else if (measuringReflectance) {
 					const int refl = packet->bufToUByte2();
 					if (refl > 254 * 255) {
@@ -1571,6 +1667,8 @@ void ArLMS1XX::sensorInterp ()
 					}
 				}
 			}
+			if (measuringDistance)
+				laserFillBeams (pose, encoderPose, transform, counter, time);
 			/*
 			ArLog::log(ArLog::Normal,
 			"Received: %s %s scan %d numReadings %d",
@@ -1579,11 +1677,6 @@ void ArLMS1XX::sensorInterp ()
 			*/
 		} // end for 16bit
 
-		// if we processed the readings and they were our first ones set
-		// it so it's not our first ones anymore so that we only do the
-		// sin/cos once
-		if (startedProcessing && myFirstReadings)
-			myFirstReadings = false;
 		// read the 8 bit channels, that's just reflectance for now
 		myNumChans8Bit = packet->bufToUByte2();
 		//myLogLevel,
@@ -1780,7 +1873,8 @@ AREXPORT bool ArLMS1XX::blockingConnect()
 //	char buf[1024];
   ArSerialConnection *conn;
 
-	if (!getRunning())
+	// with a reactor there's no need for our thread once we're connected
+	if (myReactor == NULL && !getRunning())
 		runAsync();
 
 	myConnMutex.lock();
@@ -1862,7 +1956,7 @@ AREXPORT bool ArLMS1XX::blockingConnect()
 
 		case ArLMS1XX::LMS1XX:
 			if (lms1xxConnect())
-				return true;
+				return startReading();
 		break;
 
 		case ArLMS1XX::TiM3XX:
@@ -1870,12 +1964,12 @@ AREXPORT bool ArLMS1XX::blockingConnect()
     case TiM561:
     case TiM571:
 			if (timConnect())
-				return true;
+				return startReading();
 		break;
 
 		case ArLMS1XX::LMS5XX:
 			if (lms5xxConnect())
-				return true;
+				return startReading();
 		break;
 			
 
@@ -2895,6 +2989,12 @@ AREXPORT void * ArLMS1XX::runThread(void *)
       lockDevice();
       myTryingToConnect = false;
       unlockDevice();
+      // the reactor reads the scans now, so this thread is done
+      if (myReactorReading)
+      {
+	stopRunning();
+	break;
+      }
       continue;
     }
     unlockDevice();
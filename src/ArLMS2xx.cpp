@@ -173,7 +173,7 @@ AREXPORT void ArLMS2xx::setRobot(ArRobot *robot)
   myRobot = robot;
   if (myRobot != NULL)
   {
-    myRobot->addPacketHandler(&mySimPacketHandler, ArListPos::LAST);
+    myRobot->addPacketHandler(&mySimPacketHandler, {0x60, 0x61}, ArListPos::LAST);
     myRobot->addSensorInterpTask("sick", 90, &mySensorInterpCB);
   }
   ArRangeDevice::setRobot(robot);
@@ -26,6 +26,10 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArLaser.h"
 #include "Aria/ArRobot.h"
 #include "Aria/ArDeviceConnection.h"
+#include "Aria/ArMetrics.h"
+
+#include <algorithm>
+#include <chrono>
 
 bool ArLaser::ourUseSimpleNaming = false;
 
@@ -130,6 +134,7 @@ AREXPORT void ArLaser::laserSetName(const char *name)
 
 
   myTask.setThreadName(myName.c_str());
+  myPolarIndexMutex.setLogNameVar("%s::myPolarIndexMutex", myName.c_str());
 
   myConnectCBList.setNameVar("%s::myConnectCBList", myName.c_str());
   myFailedConnectCBList.setNameVar("%s::myFailedConnectCBList", myName.c_str());
@@ -139,6 +144,7 @@ AREXPORT void ArLaser::laserSetName(const char *name)
 	  "%s::myDisconnectNormallyCBList", myName.c_str());
   myDataCBList.setNameVar("%s::myDataCBList", myName.c_str());
   myDataCBList.setLogging(false); // supress debug logging since it drowns out all other logging 
+  registerMetrics();
 }
 
 AREXPORT void ArLaser::setMaxRange(unsigned int maxRange)
@@ -186,6 +192,19 @@ void ArLaser::laserProcessReadings()
   if (myRawReadings == NULL || myRawReadings->begin() == myRawReadings->end())
     return;
 
+  std::chrono::steady_clock::time_point processStarted = 
+    std::chrono::steady_clock::now();
+  if (myScansMetric == NULL || myProcessTimeMetric == NULL)
+  {
+    std::string labels = ArMetrics::makeLabels("laser", getName());
+    myScansMetric = ArMetrics::getCounter(
+	    "aria_laser_scans_total", "Scans processed by each laser", labels);
+    myProcessTimeMetric = ArMetrics::getHistogram(
+	    "aria_laser_process_usecs", 
+	    "How long each laser took to process a scan and call its reading callbacks (us)",
+	    labels, ArMetrics::getDefaultUSecBounds());
+  }
+
   //ArTime len;
 
   bool clean;
@@ -297,6 +316,13 @@ void ArLaser::laserProcessReadings()
     printf("### %ld %d\n", len.mSecSince(), myCumulativeBuffer.getBuffer()->size());
     */
   internalGotReading();
+
+  long long processUSecs = std::chrono::duration_cast<std::chrono::microseconds>(
+	  std::chrono::steady_clock::now() - processStarted).count();
+  if (myScansMetric != NULL)
+    myScansMetric->add();
+  if (myProcessTimeMetric != NULL)
+    myProcessTimeMetric->observe((double)processUSecs);
 }
 
 
@@ -1359,6 +1385,386 @@ AREXPORT void ArLaser::applyTransform(ArTransform trans,
     myCumulativeBuffer.applyTransform(trans);
 }
 
+/**
+   Laser subclasses call this with the geometry of each scan before
+   filling it in.  It makes sure there are exactly @a numBeams raw
+   readings, creating or deleting them as needed so that they don't
+   have to be allocated one at a time, and when the beam count, angles
+   or sensor position changed it works out each beam's direction once
+   and resets each reading's sensor position to match.  Otherwise it
+   does nothing, so it's cheap to call every scan.
+
+   @param numBeams how many beams (readings) are in the scan
+   @param startAngle the angle of the first beam on the robot, including the sensor's heading
+   @param increment how many degrees each beam is from the last
+
+   @return true if the table was rebuilt, false if nothing changed
+**/
+AREXPORT bool ArLaser::laserSetBeams(size_t numBeams, double startAngle, 
+				     double increment)
+{
+  const int sensorX = ArMath::roundInt(mySensorPose.getX());
+  const int sensorY = ArMath::roundInt(mySensorPose.getY());
+  bool rebuild = false;
+
+  if (myRawReadings == NULL)
+    myRawReadings = new std::list<ArSensorReading *>;
+  if (myRawReadings->size() != numBeams)
+  {
+    while (myRawReadings->size() < numBeams)
+      myRawReadings->push_back(new ArSensorReading);
+    while (myRawReadings->size() > numBeams)
+    {
+      delete myRawReadings->back();
+      myRawReadings->pop_back();
+    }
+    rebuild = true;
+  }
+  if (!rebuild && myBeamReadings.size() == numBeams &&
+      myBeamStart == startAngle && myBeamIncrement == increment &&
+      myBeamSensorX == sensorX && myBeamSensorY == sensorY)
+    return false;
+
+  myBeamReadings.resize(numBeams);
+  myBeamCos.resize(numBeams);
+  myBeamSin.resize(numBeams);
+  myBeamRanges.assign(numBeams, 0);
+  myBeamIgnore.assign(numBeams, 0);
+  myBeamExtraInts.assign(numBeams, 0);
+  myBeamLocalXs.resize(numBeams);
+  myBeamLocalYs.resize(numBeams);
+  myBeamXs.resize(numBeams);
+  myBeamYs.resize(numBeams);
+  size_t i = 0;
+  for (auto it = myRawReadings->begin(); it != myRawReadings->end(); ++it, ++i)
+  {
+    ArSensorReading *reading = (*it);
+    reading->resetSensorPosition(
+	    sensorX, sensorY, 
+	    ArMath::fixAngle(startAngle + increment * (double)i), true);
+    myBeamReadings[i] = reading;
+    myBeamCos[i] = reading->getSensorDX();
+    myBeamSin[i] = reading->getSensorDY();
+  }
+  myBeamStart = startAngle;
+  myBeamIncrement = increment;
+  myBeamSensorX = sensorX;
+  myBeamSensorY = sensorY;
+  myBeamsMoved = false;
+  ArLog::log(myInfoLogLevel, "%s: Set up %lu beams starting at %.2f every %.3f degrees", 
+	     getName(), (unsigned long)numBeams, startAngle, increment);
+  return true;
+}
+
+/**
+   Subclasses that interpolate the robot's motion across a scan use
+   this to move each reading's sensor position before calling
+   ArSensorReading::newData() on it themselves.  The table is kept, and
+   the next laserFillBeams() puts the moved readings back where the
+   table has them.
+
+   @param beam which beam (reading) to move
+   @param x the sensor's x position for this beam
+   @param y the sensor's y position for this beam
+   @param th the heading of this beam
+**/
+AREXPORT void ArLaser::laserMoveBeam(size_t beam, double x, double y, 
+				     double th)
+{
+  if (beam >= myBeamReadings.size())
+    return;
+  myBeamReadings[beam]->resetSensorPosition(x, y, th);
+  myBeamsMoved = true;
+}
+
+/**
+   This works out where every reading from @a firstBeam on is in one
+   pass over the per beam table set up by laserSetBeams(), then
+   transforms them all to global coordinates at once, instead of each
+   reading transforming itself in ArSensorReading::newData().  The
+   results are the same.
+
+   @param robotPose the robot's pose when the scan was taken
+   @param encoderPose the robot's encoder pose when the scan was taken
+   @param trans the transform from the robot to global coordinates (from @a robotPose)
+   @param counter the robot's counter when the scan was taken
+   @param timeTaken when the scan was taken
+   @param firstBeam the first beam to fill in, earlier ones are left as they were
+**/
+AREXPORT void ArLaser::laserFillBeams(const ArPose &robotPose, 
+				      const ArPose &encoderPose,
+				      const ArTransform &trans, 
+				      unsigned int counter,
+				      const ArTime &timeTaken, size_t firstBeam)
+{
+  const size_t numBeams = myBeamReadings.size();
+  if (firstBeam >= numBeams)
+    return;
+  const double sensorX = myBeamSensorX;
+  const double sensorY = myBeamSensorY;
+  const unsigned int *ranges = myBeamRanges.data();
+  const double *cosines = myBeamCos.data();
+  const double *sines = myBeamSin.data();
+  double *localXs = myBeamLocalXs.data();
+  double *localYs = myBeamLocalYs.data();
+  size_t i;
+
+  // put back any readings laserMoveBeam() moved, the ones that weren't
+  // moved are left alone by resetSensorPosition()
+  if (myBeamsMoved)
+  {
+    for (i = 0; i < numBeams; i++)
+      myBeamReadings[i]->resetSensorPosition(
+	      sensorX, sensorY, 
+	      ArMath::fixAngle(myBeamStart + myBeamIncrement * (double)i));
+    myBeamsMoved = false;
+  }
+
+  for (i = firstBeam; i < numBeams; i++)
+  {
+    localXs[i] = sensorX + ranges[i] * cosines[i];
+    localYs[i] = sensorY + ranges[i] * sines[i];
+  }
+  trans.doTransform(localXs + firstBeam, localYs + firstBeam,
+		    myBeamXs.data() + firstBeam, myBeamYs.data() + firstBeam, 
+		    numBeams - firstBeam);
+
+  // what ArTransform::doTransform() gives a reading's heading
+  const double th = ArMath::addAngle(0, trans.getTh());
+  for (i = firstBeam; i < numBeams; i++)
+    myBeamReadings[i]->newDataPrecomputed(
+	    ranges[i], ArPose(localXs[i], localYs[i]),
+	    ArPose(myBeamXs[i], myBeamYs[i], th), robotPose, encoderPose,
+	    counter, timeTaken, myBeamIgnore[i] != 0, myBeamExtraInts[i]);
+}
+
+// Readings closer than this (squared, in mm) to the pose don't get
+// sorted by angle, since the angle to them means very little
+static const double ourPolarIndexNearDist = 1e-6;
+// Readings within this many degrees of either edge of a sector get
+// checked the same way ArRangeBuffer::getClosestPolarInArrays() does,
+// so rounding in the angles can't make the two disagree
+static const double ourPolarIndexEdge = 1e-6;
+
+/**
+   Sorts the current buffer by angle from @a pose and builds the sparse
+   table over that order, where level k holds the closest reading in
+   each run of 2^k readings starting at that position.  Ties in
+   distance go to the reading earlier in the buffer, so that the result
+   is the same reading the buffer's own search would find.
+**/
+AREXPORT void ArLaser::buildPolarIndex(const ArPose &pose) const
+{
+  const std::list<ArPoseWithTime> &buffer = myCurrentBuffer.getBuffer();
+  const size_t num = buffer.size();
+  const double sx = pose.getX();
+  const double sy = pose.getY();
+  double dx, dy;
+  size_t i, k, m;
+
+  myPolarIndexXs.resize(num);
+  myPolarIndexYs.resize(num);
+  myPolarIndexDists.resize(num);
+  myPolarIndexNear.clear();
+  myPolarIndexSort.clear();
+  i = 0;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it, ++i)
+  {
+    myPolarIndexXs[i] = it->getX();
+    myPolarIndexYs[i] = it->getY();
+    dx = myPolarIndexXs[i] - sx;
+    dy = myPolarIndexYs[i] - sy;
+    myPolarIndexDists[i] = dx * dx + dy * dy;
+    if (myPolarIndexDists[i] < ourPolarIndexNearDist)
+      myPolarIndexNear.push_back((unsigned int)i);
+    else
+      myPolarIndexSort.push_back(std::make_pair(
+	      ArMath::subAngle(pose.findAngleTo(*it), pose.getTh()), 
+	      (unsigned int)i));
+  }
+  std::sort(myPolarIndexSort.begin(), myPolarIndexSort.end());
+
+  m = myPolarIndexSort.size();
+  myPolarIndexAngles.resize(m);
+  size_t levels = 1;
+  while (((size_t)1 << levels) <= m)
+    levels++;
+  myPolarIndexTable.resize(levels * m);
+  for (i = 0; i < m; i++)
+  {
+    myPolarIndexAngles[i] = myPolarIndexSort[i].first;
+    myPolarIndexTable[i] = myPolarIndexSort[i].second;
+  }
+  for (k = 1; k < levels; k++)
+  {
+    const unsigned int *prev = &myPolarIndexTable[(k - 1) * m];
+    unsigned int *cur = &myPolarIndexTable[k * m];
+    const size_t half = (size_t)1 << (k - 1);
+    for (i = 0; i + (half << 1) <= m; i++)
+    {
+      const unsigned int a = prev[i];
+      const unsigned int b = prev[i + half];
+      cur[i] = (myPolarIndexDists[b] < myPolarIndexDists[a] || 
+		(myPolarIndexDists[b] == myPolarIndexDists[a] && b < a)) ? b : a;
+    }
+  }
+
+  myPolarIndexPose = pose;
+  myPolarIndexChangeCount = myCurrentBuffer.getChangeCount();
+  myPolarIndexValid = true;
+  myPolarIndexBuilds++;
+}
+
+// Finds the positions in the polar index of the readings whose angles
+// are in the arc going counterclockwise from @a from for @a len
+// degrees (with or without the ends), as up to two [begin, end) runs.
+static int polarIndexArc(const std::vector<double> &angles, 
+			 double from, double len, bool closed,
+			 size_t begins[2], size_t ends[2])
+{
+  auto first = [&](double a) {
+    return (size_t)((closed ? 
+		     std::lower_bound(angles.begin(), angles.end(), a) :
+		     std::upper_bound(angles.begin(), angles.end(), a)) - 
+		    angles.begin()); };
+  auto last = [&](double a) {
+    return (size_t)((closed ? 
+		     std::upper_bound(angles.begin(), angles.end(), a) :
+		     std::lower_bound(angles.begin(), angles.end(), a)) - 
+		    angles.begin()); };
+  from = ArMath::fixAngle(from);
+  const double to = from + len;
+  begins[0] = first(from);
+  if (to <= 180)
+  {
+    ends[0] = last(to);
+    return 1;
+  }
+  ends[0] = angles.size();
+  begins[1] = 0;
+  ends[1] = last(to - 360);
+  return 2;
+}
+
+/**
+   This finds the same reading ArRangeDevice::currentReadingPolar()
+   does, but instead of checking every reading in the current buffer it
+   uses an index of them sorted by angle from the robot, so it only has
+   to look at the readings near the edges of the sector.  The index is
+   built the first time this is called after a new scan comes in or the
+   robot moves, so if something makes a lot of queries each cycle (like
+   a handful of avoidance actions) they share that cost.
+
+   Like the rest of the buffer accessors, lock the laser with
+   lockDevice() or lockDeviceShared() around this if the laser runs in
+   its own thread.
+**/
+AREXPORT double ArLaser::currentReadingPolar(double startAngle,
+					      double endAngle,
+					      double *angle) const
+{
+  ArScopedLock indexLock(myPolarIndexMutex);
+  ArPose pose;
+  if (myRobot != NULL)
+    pose = myRobot->getPose();
+  else
+  {
+    ArLog::log(ArLog::Normal, "ArRangeDevice %s: NULL robot, won't get polar reading correctly", getName());
+    pose.setPose(0, 0);
+  }
+
+  if (!myPolarIndexValid || 
+      myPolarIndexChangeCount != myCurrentBuffer.getChangeCount() ||
+      myPolarIndexPose.getX() != pose.getX() ||
+      myPolarIndexPose.getY() != pose.getY() ||
+      myPolarIndexPose.getTh() != pose.getTh())
+    buildPolarIndex(pose);
+
+  startAngle = ArMath::fixAngle(startAngle);
+  endAngle = ArMath::fixAngle(endAngle);
+  if (startAngle == endAngle)
+    return myMaxRange;
+  double span = endAngle - startAngle;
+  if (span < 0)
+    span += 360;
+
+  // the same test for being in the sector that the buffer uses, for
+  // readings that are near an edge or the pose
+  const double sx = pose.getX();
+  const double sy = pose.getY();
+  const bool wide = span > 180;
+  const double ax = ArMath::cos(pose.getTh() + startAngle);
+  const double ay = ArMath::sin(pose.getTh() + startAngle);
+  const double bx = ArMath::cos(pose.getTh() + endAngle);
+  const double by = ArMath::sin(pose.getTh() + endAngle);
+  const bool zeroIn = ArMath::angleBetween(-pose.getTh(), startAngle, 
+					   endAngle);
+  auto inSector = [&](size_t i) {
+    const double dx = myPolarIndexXs[i] - sx;
+    const double dy = myPolarIndexYs[i] - sy;
+    const double c1 = ax * dy - ay * dx;
+    const double c2 = dx * by - dy * bx;
+    if (dx * dx + dy * dy == 0)
+      return zeroIn;
+    return wide ? (c1 > 0 || c2 > 0) : (c1 > 0 && c2 > 0);
+  };
+
+  const size_t num = myPolarIndexDists.size();
+  const size_t m = myPolarIndexAngles.size();
+  size_t best = num;
+  auto consider = [&](size_t i) {
+    if (best == num || myPolarIndexDists[i] < myPolarIndexDists[best] ||
+	(myPolarIndexDists[i] == myPolarIndexDists[best] && i < best))
+      best = i;
+  };
+  size_t begins[2], ends[2];
+  size_t j, k, len;
+  int r, runs;
+
+  // readings well inside the sector come straight from the sparse table
+  if (span > 2 * ourPolarIndexEdge)
+  {
+    runs = polarIndexArc(myPolarIndexAngles, startAngle + ourPolarIndexEdge,
+			 span - 2 * ourPolarIndexEdge, false, begins, ends);
+    for (r = 0; r < runs; r++)
+    {
+      if (begins[r] >= ends[r])
+	continue;
+      len = ends[r] - begins[r];
+      for (k = 0; ((size_t)2 << k) <= len; k++)
+	;
+      consider(myPolarIndexTable[k * m + begins[r]]);
+      consider(myPolarIndexTable[k * m + ends[r] - ((size_t)1 << k)]);
+    }
+  }
+  // readings right at either edge
+  const double edges[2] = { startAngle, endAngle };
+  for (double edge : edges)
+  {
+    runs = polarIndexArc(myPolarIndexAngles, edge - ourPolarIndexEdge,
+			 2 * ourPolarIndexEdge, true, begins, ends);
+    for (r = 0; r < runs; r++)
+      for (j = begins[r]; j < ends[r]; j++)
+	if (inSector(myPolarIndexTable[j]))
+	  consider(myPolarIndexTable[j]);
+  }
+  for (unsigned int i : myPolarIndexNear)
+    if (inSector(i))
+      consider(i);
+
+  if (best == num)
+    return myMaxRange;
+  if (angle != NULL)
+    *angle = ArMath::subAngle(
+	    pose.findAngleTo(ArPose(myPolarIndexXs[best], myPolarIndexYs[best])),
+	    pose.getTh());
+  const double dist = sqrt(myPolarIndexDists[best]);
+  if (dist > myMaxRange)
+    return myMaxRange;
+  else
+    return dist;
+}
+
 /**
    This will check if the laser has lost connection.  If there is no
    robot it is a straightforward check of last reading time against
@@ -60,6 +60,7 @@ AREXPORT ArLaserConnector::ArLaserConnector(
 	ArLog::LogLevel infoLogLevel,
 	ArRetFunctor1<bool, const char *> *turnOnPowerOutputCB,
 	ArRetFunctor1<bool, const char *> *turnOffPowerOutputCB) :
+  myConnectGroup("ArLaserConnector"),
   myParseArgsCB(this, &ArLaserConnector::parseArgs),
   myLogOptionsCB(this, &ArLaserConnector::logOptions)
 {
@@ -1190,8 +1191,15 @@ AREXPORT bool ArLaserConnector::connectLaser(ArLaser *laser,
 }
 
 /**
+   The lasers are turned on one at a time, then connected all at the
+   same time, each in its own thread (see getConnectGroup() to change
+   that or to set retry policies), and this returns once they have all
+   connected or given up.
+
    @param continueOnFailedConnect whether to continue on a failed
-   connection or not
+   connection or not (since the lasers are connected at the same time,
+   the lasers that did connect are still added to the robot, but false
+   is returned)
 
    @param addConnectedLasersToRobot whether to add connected lasers to
    the list stored in ArRobot. Normally this should be left as true.
@@ -1220,6 +1228,7 @@ AREXPORT bool ArLaserConnector::connectLasers(
 {
   std::map<int, LaserData *>::iterator it;
   LaserData *laserData = NULL;
+  bool ret = true;
   
   ArLog::log(myInfoLogLevel, 
 	     "ArLaserConnector: Connecting lasers");
@@ -1260,6 +1269,7 @@ AREXPORT bool ArLaserConnector::connectLasers(
     }
   }
 
+  myConnectGroup.clear();
   for (it = myLasers.begin(); it != myLasers.end(); ++it)
   {
     laserData = (*it).second;
@@ -1377,204 +1387,252 @@ AREXPORT bool ArLaserConnector::connectLasers(
 		 laserData->myLaser->getName());
 
       laserData->myLaser->setRobot(myRobot);
-      
-      bool connected = false;
-
-      connected = laserData->myLaser->blockingConnect();
-      
-      // if we didn't connect and we can power cycle the lasers then
-      // do that and see if we can connect again
-      /// TODO see if this firmware can actually do the power cycling
-      if (!connected && powerCycleLaserOnFailedConnect)
-      {
-	if (laserData->myLaser->canSetPowerControlled())
-	  laserData->myLaser->setPowerControlled(true);
-
-  // XXX XXX TODO is the logic for checking if myTurnOnPowerOutputCB and myTurnOffPowerOutputCBs are NULL correct? 
-  // it uses myTurnOffPowerOutputCB in the else clause of != NULL check!  But it's been this way since ARIA 2.9.4 release so leaving it for now. Must not happen when these callbacks are both supplied or both NULL.
-	if (myTurnOnPowerOutputCB != NULL)
-	{
-	  if (myTurnOffPowerOutputCB != NULL)
-	  {
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Have no way to turn power off, so laser %s can't be power cycled (it's possible things will still work).",
-		       laserData->myLaser->getName());
-	  }
-	  else if (myRobot->getRobotParams()->getLaserPowerOutput(
-		      laserData->myNumber) == NULL ||
-	      myRobot->getRobotParams()->getLaserPowerOutput(
-		      laserData->myNumber)[0] == '\0')
-	  {
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Laser %s has no power output set so can't be power cycled (it's possible things will still work).",
-		       laserData->myLaser->getName());
-	  }
-	  else
-	  {
-      if(myTurnOffPowerOutputCB)
-      {
-        if (myTurnOffPowerOutputCB->invokeR(myRobot->getRobotParams()->getLaserPowerOutput(laserData->myNumber)))
-        {
-          ArLog::log(myInfoLogLevel, 
-         "ArLaserConnector::connectLasers: Cycled off power output %s for %s",
-         myRobot->getRobotParams()->getLaserPowerOutput(
-           laserData->myNumber),
-         laserData->myLaser->getName());
-        }
-        else
-        {
-          ArLog::log(ArLog::Normal, 
-         "ArLaserConnector::connectLasers: Could not cycle off power output %s for %s",
-         myRobot->getRobotParams()->getLaserPowerOutput(
-           laserData->myNumber),
-         laserData->myLaser->getName());
-        }
-        if(!myTurnOnPowerOutputCB)
-          ArLog::log(ArLog::Normal, "ArLaserConnector::conectLasers: Warning: turned off laser power but have no function to turn back on!");
-        ArUtil::sleep(1000);
-	    }
-      if(myTurnOnPowerOutputCB)
-      {
-        if (myTurnOnPowerOutputCB->invokeR(myRobot->getRobotParams()->getLaserPowerOutput(laserData->myNumber)))
-        {
-          ArLog::log(myInfoLogLevel, 
-         "ArLaserConnector::connectLasers: Cycled on power output %s for %s",
-         myRobot->getRobotParams()->getLaserPowerOutput(
-           laserData->myNumber),
-         laserData->myLaser->getName());
-        }
-        else
-        {
-          ArLog::log(ArLog::Normal, 
-         "ArLaserConnector::connectLasers: Could not cycle on power output %s for %s",
-         myRobot->getRobotParams()->getLaserPowerOutput(
-           laserData->myNumber),
-         laserData->myLaser->getName());
-        }
-      }
+      myConnectGroup.addDevice(
+	      laserData->myLaser->getName(), laserData->myNumber,
+	      new ArRetFunctor2C<bool, ArLaserConnector, LaserData *, bool>(
+		      this, &ArLaserConnector::internalConnectLaser, laserData, 
+		      powerCycleLaserOnFailedConnect));
     }
-	  ArUtil::sleep(1000);
-	  connected = laserData->myLaser->blockingConnect();
-	}
-	if (laserData->myNumber == 1)
-	{
-	  // see if the firmware supports the LRF command
-	  if (myRobot->getOrigRobotConfig() != NULL && 
-	      myRobot->getOrigRobotConfig()->hasPacketArrived() && 
-	      myRobot->getOrigRobotConfig()->getPowerBits() & ArUtil::BIT1)
-	  {
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Cycling LRF power for %s and trying to connect again",
-		       laserData->myLaser->getName());
-	    myRobot->comInt(ArCommands::POWER_LRF, 0);
-	    ArUtil::sleep(1000);
-	    myRobot->comInt(ArCommands::POWER_LRF, 1);
-	    ArUtil::sleep(1000);
-	    connected = laserData->myLaser->blockingConnect();
-	  }
-	  else
-	  {
+  }
 
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Using legacy method to cycle LRF power for %s since firmware or robot doesn't support new way",
-		       laserData->myLaser->getName());
-	    myRobot->com2Bytes(31, 11, 0);
-	    ArUtil::sleep(1000);
-	    myRobot->com2Bytes(31, 11, 1);
-	    ArUtil::sleep(1000);
-	    connected = laserData->myLaser->blockingConnect();
-	  }
-	}
-	else if (laserData->myNumber == 2)
-	{
-	  // see if the firmware supports the LRF2 command
-	  if (myRobot->getOrigRobotConfig() != NULL && 
-	      myRobot->getOrigRobotConfig()->hasPacketArrived() && 
-	      myRobot->getOrigRobotConfig()->getPowerBits() & ArUtil::BIT9)
-	  {
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Cycling LRF2 power for %s and trying to connect again",
-		       laserData->myLaser->getName());
-	    
-	    myRobot->comInt(ArCommands::POWER_LRF2, 0);
-	    ArUtil::sleep(1000);
-	    myRobot->comInt(ArCommands::POWER_LRF2, 1);
-	    ArUtil::sleep(1000);
-	    connected = laserData->myLaser->blockingConnect();
-	  }
-	  else
-	  {
-	    ArLog::log(myInfoLogLevel, 
-		       "ArLaserConnector::connectLasers: Cannot cycle LRF2 power for %s since firmware or robot doesn't support it",
-		       laserData->myLaser->getName());
-	    ArUtil::sleep(1000);
-	    ArUtil::sleep(1000);
-	  }
-	}
-	else
-	{
-	  ArLog::log(myInfoLogLevel, 
-	      "ArLaserConnector::connectLasers: Cannot cycle power for %s, since it is number %d (higher than 2)",
-		     laserData->myLaser->getName(), 
-		     laserData->myLaser->getLaserNumber());
-	}
-      }
+  // now connect them all at once (unless the group was set not to)
+  myConnectGroup.connectAll();
+  myConnectGroup.logResults(myInfoLogLevel);
 
-      if (connected)
+  for (const ArDeviceConnectGroup::ConnectResult &result : 
+	 myConnectGroup.getResults())
+  {
+    laserData = myLasers[result.number];
+    if (result.connected)
+    {
+      if (!addAllLasersToRobot && addConnectedLasersToRobot)
       {
-	if (!addAllLasersToRobot && addConnectedLasersToRobot)
-	{
-	  if (myRobot != NULL)
-	  {
-	    myRobot->addLaser(laserData->myLaser, laserData->myNumber);
-	    //myRobot->addRangeDevice(laserData->myLaser);
-	    ArLog::log(ArLog::Verbose, 
-		       "ArLaserConnector::connectLasers: Added %s to robot",
-		       laserData->myLaser->getName());
-	  }
-	  else
-	  {
-	    ArLog::log(ArLog::Normal, 
-		       "ArLaserConnector::connectLasers: Could not add %s to robot, since there is no robot",
-		       laserData->myLaser->getName());
-	  }
-
-	}
-	else if (addAllLasersToRobot && myRobot != NULL)
+	if (myRobot != NULL)
 	{
+	  myRobot->addLaser(laserData->myLaser, laserData->myNumber);
+	  //myRobot->addRangeDevice(laserData->myLaser);
 	  ArLog::log(ArLog::Verbose, 
-		     "ArLaserConnector::connectLasers: %s already added to robot)", 
+		     "ArLaserConnector::connectLasers: Added %s to robot",
 		     laserData->myLaser->getName());
 	}
-	else if (myRobot != NULL)
+	else
 	{
-	  ArLog::log(ArLog::Verbose, 
-	     "ArLaserConnector::connectLasers: Did not add %s to robot", 
+	  ArLog::log(ArLog::Normal, 
+		     "ArLaserConnector::connectLasers: Could not add %s to robot, since there is no robot",
 		     laserData->myLaser->getName());
 	}
+
       }
-      else
+      else if (addAllLasersToRobot && myRobot != NULL)
       {
-	if (!continueOnFailedConnect)
-	{
-	  ArLog::log(ArLog::Normal, 
-		     "ArLaserConnector::connectLasers: Could not connect %s, stopping", 
-		     laserData->myLaser->getName());
-	  if (failedOnLaser != NULL)
-	    *failedOnLaser = laserData->myNumber;
-	  return false;
-	}
-	else
-	  ArLog::log(ArLog::Normal, 
-		     "ArLaserConnector::connectLasers: Could not connect %s, continuing with remainder of lasers", 
-		     laserData->myLaser->getName());
+	ArLog::log(ArLog::Verbose, 
+		   "ArLaserConnector::connectLasers: %s already added to robot)", 
+		   laserData->myLaser->getName());
+      }
+      else if (myRobot != NULL)
+      {
+	ArLog::log(ArLog::Verbose, 
+	   "ArLaserConnector::connectLasers: Did not add %s to robot", 
+		   laserData->myLaser->getName());
       }
     }
+    else
+    {
+      if (!continueOnFailedConnect)
+      {
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Could not connect %s, failing", 
+		   laserData->myLaser->getName());
+	if (ret && failedOnLaser != NULL)
+	  *failedOnLaser = laserData->myNumber;
+	ret = false;
+      }
+      else
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Could not connect %s, continuing with remainder of lasers", 
+		   laserData->myLaser->getName());
+    }
   }
 
   ArLog::log(myInfoLogLevel, 
 	     "ArLaserConnector: Done connecting lasers");
-  return true;
+  return ret;
+}
+
+/**
+   Makes one connection attempt for a laser, if that fails and
+   powerCycleLaserOnFailedConnect is set this cycles the laser's power
+   and tries again.  This is what connectLasers() has myConnectGroup
+   call for each laser, so it is run in that laser's own thread.
+   
+   @internal
+**/
+bool ArLaserConnector::internalConnectLaser(
+	LaserData *laserData, bool powerCycleLaserOnFailedConnect)
+{
+  bool connected = false;
+
+  connected = laserData->myLaser->blockingConnect();
+
+  // if we didn't connect and we can power cycle the lasers then
+  // do that and see if we can connect again
+  /// TODO see if this firmware can actually do the power cycling
+  if (!connected && powerCycleLaserOnFailedConnect)
+  {
+    // the other lasers may be connecting right now too, so each power
+    // command to the robot is sent under myPowerCycleMutex, but it isn't
+    // held across the waits or the reconnect so they can overlap
+    if (laserData->myLaser->canSetPowerControlled())
+      laserData->myLaser->setPowerControlled(true);
+
+// XXX XXX TODO is the logic for checking if myTurnOnPowerOutputCB and myTurnOffPowerOutputCBs are NULL correct? 
+// it uses myTurnOffPowerOutputCB in the else clause of != NULL check!  But it's been this way since ARIA 2.9.4 release so leaving it for now. Must not happen when these callbacks are both supplied or both NULL.
+    if (myTurnOnPowerOutputCB != NULL)
+    {
+      if (myTurnOffPowerOutputCB != NULL)
+      {
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Have no way to turn power off, so laser %s can't be power cycled (it's possible things will still work).",
+		   laserData->myLaser->getName());
+      }
+      else if (myRobot->getRobotParams()->getLaserPowerOutput(
+		  laserData->myNumber) == NULL ||
+	  myRobot->getRobotParams()->getLaserPowerOutput(
+		  laserData->myNumber)[0] == '\0')
+      {
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Laser %s has no power output set so can't be power cycled (it's possible things will still work).",
+		   laserData->myLaser->getName());
+      }
+      else
+      {
+  if(myTurnOffPowerOutputCB)
+  {
+    myPowerCycleMutex.lock();
+    const bool turnedOff = myTurnOffPowerOutputCB->invokeR(myRobot->getRobotParams()->getLaserPowerOutput(laserData->myNumber));
+    myPowerCycleMutex.unlock();
+    if (turnedOff)
+    {
+      ArLog::log(myInfoLogLevel, 
+     "ArLaserConnector::connectLasers: Cycled off power output %s for %s",
+     myRobot->getRobotParams()->getLaserPowerOutput(
+       laserData->myNumber),
+     laserData->myLaser->getName());
+    }
+    else
+    {
+      ArLog::log(ArLog::Normal, 
+     "ArLaserConnector::connectLasers: Could not cycle off power output %s for %s",
+     myRobot->getRobotParams()->getLaserPowerOutput(
+       laserData->myNumber),
+     laserData->myLaser->getName());
+    }
+    if(!myTurnOnPowerOutputCB)
+      ArLog::log(ArLog::Normal, "ArLaserConnector::conectLasers: Warning: turned off laser power but have no function to turn back on!");
+    ArUtil::sleep(1000);
+	}
+  if(myTurnOnPowerOutputCB)
+  {
+    myPowerCycleMutex.lock();
+    const bool turnedOn = myTurnOnPowerOutputCB->invokeR(myRobot->getRobotParams()->getLaserPowerOutput(laserData->myNumber));
+    myPowerCycleMutex.unlock();
+    if (turnedOn)
+    {
+      ArLog::log(myInfoLogLevel, 
+     "ArLaserConnector::connectLasers: Cycled on power output %s for %s",
+     myRobot->getRobotParams()->getLaserPowerOutput(
+       laserData->myNumber),
+     laserData->myLaser->getName());
+    }
+    else
+    {
+      ArLog::log(ArLog::Normal, 
+     "ArLaserConnector::connectLasers: Could not cycle on power output %s for %s",
+     myRobot->getRobotParams()->getLaserPowerOutput(
+       laserData->myNumber),
+     laserData->myLaser->getName());
+    }
+  }
+}
+      ArUtil::sleep(1000);
+      connected = laserData->myLaser->blockingConnect();
+    }
+    if (laserData->myNumber == 1)
+    {
+      // see if the firmware supports the LRF command
+      if (myRobot->getOrigRobotConfig() != NULL && 
+	  myRobot->getOrigRobotConfig()->hasPacketArrived() && 
+	  myRobot->getOrigRobotConfig()->getPowerBits() & ArUtil::BIT1)
+      {
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Cycling LRF power for %s and trying to connect again",
+		   laserData->myLaser->getName());
+	myPowerCycleMutex.lock();
+	myRobot->comInt(ArCommands::POWER_LRF, 0);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	myPowerCycleMutex.lock();
+	myRobot->comInt(ArCommands::POWER_LRF, 1);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	connected = laserData->myLaser->blockingConnect();
+      }
+      else
+      {
+
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Using legacy method to cycle LRF power for %s since firmware or robot doesn't support new way",
+		   laserData->myLaser->getName());
+	myPowerCycleMutex.lock();
+	myRobot->com2Bytes(31, 11, 0);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	myPowerCycleMutex.lock();
+	myRobot->com2Bytes(31, 11, 1);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	connected = laserData->myLaser->blockingConnect();
+      }
+    }
+    else if (laserData->myNumber == 2)
+    {
+      // see if the firmware supports the LRF2 command
+      if (myRobot->getOrigRobotConfig() != NULL && 
+	  myRobot->getOrigRobotConfig()->hasPacketArrived() && 
+	  myRobot->getOrigRobotConfig()->getPowerBits() & ArUtil::BIT9)
+      {
+	ArLog::log(ArLog::Normal, 
+		   "ArLaserConnector::connectLasers: Cycling LRF2 power for %s and trying to connect again",
+		   laserData->myLaser->getName());
+	    
+	myPowerCycleMutex.lock();
+	myRobot->comInt(ArCommands::POWER_LRF2, 0);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	myPowerCycleMutex.lock();
+	myRobot->comInt(ArCommands::POWER_LRF2, 1);
+	myPowerCycleMutex.unlock();
+	ArUtil::sleep(1000);
+	connected = laserData->myLaser->blockingConnect();
+      }
+      else
+      {
+	ArLog::log(myInfoLogLevel, 
+		   "ArLaserConnector::connectLasers: Cannot cycle LRF2 power for %s since firmware or robot doesn't support it",
+		   laserData->myLaser->getName());
+	ArUtil::sleep(1000);
+	ArUtil::sleep(1000);
+      }
+    }
+    else
+    {
+      ArLog::log(myInfoLogLevel, 
+	  "ArLaserConnector::connectLasers: Cannot cycle power for %s, since it is number %d (higher than 2)",
+		 laserData->myLaser->getName(), 
+		 laserData->myLaser->getLaserNumber());
+    }
+  }
+  return connected;
 }
 
 AREXPORT void ArLaserConnector::logLaserData()
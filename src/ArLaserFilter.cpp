@@ -26,6 +26,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArRobot.h"
 #include "Aria/ArConfig.h"
 
+#include <algorithm>
+
 //#define DEBUGRANGEFILTER
 
 AREXPORT ArLaserFilter::ArLaserFilter(
@@ -59,6 +61,11 @@ AREXPORT ArLaserFilter::ArLaserFilter(
   myAnyMinRange = -1;
   myAnyMinRangeLessThanAngle = -180;
   myAnyMinRangeGreaterThanAngle = 180;
+  myClampMinRange = -1;
+  myClampMaxRange = -1;
+  myMedianWindow = 0;
+  myMedianMaxDeviation = -1;
+  myMinIntensity = -1;
   
   setCurrentDrawingData(
 	  new ArDrawingData(*(myLaser->getCurrentDrawingData())),
@@ -220,6 +227,62 @@ AREXPORT void ArLaserFilter::addToConfig(ArConfig *config,
   config->addParam(ArConfigArg(ArConfigArg::SEPARATOR), sectionName,
 		   ArPriority::FACTORY);
 
+  name = prefix;
+  name += "ClampMinRange";
+  config->addParam(
+	  ArConfigArg(name.c_str(), &myClampMinRange,
+	      "Filter settings.  Readings closer than this (in mm) are ignored... negative values means this won't be used"),
+	  sectionName, ArPriority::FACTORY);
+
+  name = prefix;
+  name += "ClampMaxRange";
+  config->addParam(
+	  ArConfigArg(name.c_str(), &myClampMaxRange,
+	      "Filter settings.  Readings further than this (in mm) are ignored... negative values means this won't be used"),
+	  sectionName, ArPriority::FACTORY);
+
+  config->addParam(ArConfigArg(ArConfigArg::SEPARATOR), sectionName,
+		   ArPriority::FACTORY);
+
+  name = prefix;
+  name += "MedianWindow";
+  config->addParam(
+	  ArConfigArg(name.c_str(), &myMedianWindow,
+	      "Filter settings.  The number of readings on either side of each reading to take the median of, 0 means the median filter won't be used",
+		      0),
+	  sectionName, ArPriority::FACTORY);
+
+  name = prefix;
+  name += "MedianMaxDeviation";
+  config->addParam(
+	  ArConfigArg(name.c_str(), &myMedianMaxDeviation,
+	      "Filter settings.  If a reading is further than this (in mm) from the median of the readings around it (decided by the MedianWindow), it is ignored... negative values means the median filter won't be used"),
+	  sectionName, ArPriority::FACTORY);
+
+  config->addParam(ArConfigArg(ArConfigArg::SEPARATOR), sectionName,
+		   ArPriority::FACTORY);
+
+  name = prefix;
+  name += "MinIntensity";
+  config->addParam(
+	  ArConfigArg(name.c_str(), &myMinIntensity,
+	      "Filter settings.  Readings with an intensity (reflectance) less than this are ignored... negative values means this won't be used (only use this with lasers that report intensity)"),
+	  sectionName, ArPriority::FACTORY);
+
+  config->addParam(ArConfigArg(ArConfigArg::SEPARATOR), sectionName,
+		   ArPriority::FACTORY);
+
+}
+
+AREXPORT void ArLaserFilter::addStage(ArFunctor1<Scan *> *stage)
+{
+  myStages.push_back(stage);
+}
+
+AREXPORT void ArLaserFilter::remStage(ArFunctor1<Scan *> *stage)
+{
+  myStages.erase(std::remove(myStages.begin(), myStages.end(), stage),
+		 myStages.end());
 }
 
 AREXPORT void ArLaserFilter::setRobot(ArRobot *robot)
@@ -235,7 +298,7 @@ AREXPORT void ArLaserFilter::setRobot(ArRobot *robot)
 
 void ArLaserFilter::processReadings()
 {
-  myLaser->lockDevice();
+  myLaser->lockDeviceShared();
   selfLockDevice();
 
   const std::list<ArSensorReading *> *rdRawReadings;
@@ -244,18 +307,18 @@ void ArLaserFilter::processReadings()
   if ((rdRawReadings = myLaser->getRawReadings()) == NULL)
   {
     selfUnlockDevice();
-    myLaser->unlockDevice();
+    myLaser->unlockDeviceShared();
     return;
   }
 
-  size_t rawSize = myRawReadings->size();
-  size_t rdRawSize = myLaser->getRawReadings()->size();
-  
-  while (rawSize < rdRawSize)
-  {
-    myRawReadings->push_back(new ArSensorReading);
-    rawSize++;
-  }
+  // keep one reading per beam of the laser we're filtering, so that a
+  // scan with fewer readings doesn't leave old ones on the end.  Only
+  // the table's sizing is used, not laserFillBeams(): the readings are
+  // copied whole from the other laser, since it may have moved beams off
+  // its own table (interpolating motion across the scan) or not use a
+  // table at all, and working them out again here would cost as much as
+  // the copy and could come out different from what it reported
+  laserSetBeams(rdRawReadings->size(), getStartDegrees(), getIncrement());
 
   // set where the pose was taken
   myCurrentBuffer.setPoseTaken(
@@ -265,224 +328,224 @@ void ArLaserFilter::processReadings()
 
 
   std::list<ArSensorReading *>::iterator it;
-  ArSensorReading *rdReading;
-  ArSensorReading *reading;
-
-#ifdef DEBUGRANGEFILTER
-  FILE *file = NULL;
-  //file = ArUtil::fopen("/mnt/rdsys/tmp/filter", "w");
-  file = ArUtil::fopen("/tmp/filter", "w");
-#endif
-
-  std::map<int, ArSensorReading *> readingMap;
-  int numReadings = 0;
 
-  // first pass to copy the readings and put them into a map
+  // first pass to copy the readings and index them (the vector keeps
+  // its capacity between scans so this doesn't allocate)
+  myReadings.clear();
   for (rdIt = rdRawReadings->begin(), it = myRawReadings->begin();
        rdIt != rdRawReadings->end() && it != myRawReadings->end();
        rdIt++, it++)
   {
-    rdReading = (*rdIt);
-    reading = (*it);
-    *reading = *rdReading;
-
-    readingMap[numReadings] = reading;
-    numReadings++;
+    *(*it) = *(*rdIt);
+    myReadings.push_back(*it);
   }
 
   // if we're not doing any filtering, just short circuit out now
-  if (myAllFactor <= 0 && myAnyFactor <= 0 && myAnyMinRange <= 0)
+  if (myAllFactor <= 0 && myAnyFactor <= 0 && myAnyMinRange <= 0 &&
+      myClampMinRange < 0 && myClampMaxRange < 0 &&
+      (myMedianWindow <= 0 || myMedianMaxDeviation < 0) &&
+      myMinIntensity < 0 && myStages.empty())
   {
     laserProcessReadings();
     copyReadingCount(myLaser);
 
     selfUnlockDevice();
-    myLaser->unlockDevice();
-#ifdef DEBUGRANGEFILTER
-    if (file != NULL)
-      fclose(file);
-#endif
+    myLaser->unlockDeviceShared();
     return;
   }
-  
-  int i;
-  int j;
-  //ArSensorReading *lastAddedReading = NULL;
-  
-  // now walk through the readings to filter them
-  for (i = 0; i < numReadings; i++)
+
+  // fill in the arrays the stages work on
+  const size_t numReadings = myReadings.size();
+  myScan.ranges.resize(numReadings);
+  myScan.angles.resize(numReadings);
+  myScan.intensities.resize(numReadings);
+  myScan.ignore.resize(numReadings);
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    const ArSensorReading *reading = myReadings[i];
+    myScan.ranges[i] = reading->getRange();
+    myScan.angles[i] = reading->getSensorTh();
+    myScan.intensities[i] = reading->getExtraInt();
+    myScan.ignore[i] = reading->getIgnoreThisReading() ? 1 : 0;
+  }
+
+  clampStage();
+  neighborStage();
+  medianStage();
+  intensityStage();
+
+  std::vector<ArFunctor1<Scan *> *>::iterator stageIt;
+  for (stageIt = myStages.begin(); stageIt != myStages.end(); ++stageIt)
+    (*stageIt)->invoke(&myScan);
+
+  // and put the results back on the readings
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    if (myScan.ignore[i] != 0)
+      myReadings[i]->setIgnoreThisReading(true);
+  }
+
+  laserProcessReadings();
+  copyReadingCount(myLaser);
+
+  selfUnlockDevice();
+  myLaser->unlockDeviceShared();
+}
+
+void ArLaserFilter::clampStage()
+{
+  if (myClampMinRange < 0 && myClampMaxRange < 0)
+    return;
+
+  const size_t numReadings = myScan.size();
+  const unsigned int *ranges = myScan.ranges.data();
+  unsigned char *ignore = myScan.ignore.data();
+
+  for (size_t i = 0; i < numReadings; i++)
   {
-    reading = readingMap[i];
+    if ((myClampMinRange >= 0 && ranges[i] < myClampMinRange) ||
+	(myClampMaxRange >= 0 && ranges[i] > myClampMaxRange))
+      ignore[i] = 1;
+  }
+}
+
+/**
+   This checks each reading against its neighbors within
+   myAngleToCheck on either side.  Since the readings are sorted by
+   angle that set of neighbors is a window of the arrays whose ends
+   only ever move forward, so it's found by sliding it along instead
+   of searching out from each reading.
+
+   Note that neighbors are used even if they're ignored, or you get
+   one sided filtering.
+**/
+void ArLaserFilter::neighborStage()
+{
+  if (myAllFactor <= 0 && myAnyFactor <= 0 && myAnyMinRange <= 0)
+    return;
+
+  const size_t numReadings = myScan.size();
+  const unsigned int *ranges = myScan.ranges.data();
+  const double *angles = myScan.angles.data();
+  unsigned char *ignore = myScan.ignore.data();
+
+  size_t lo = 0;
+  size_t hi = 0;
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    while (lo < i && 
+	   fabs(ArMath::subAngle(angles[lo], angles[i])) > myAngleToCheck)
+      lo++;
+    if (hi < i)
+      hi = i;
+    while (hi + 1 < numReadings &&
+	   fabs(ArMath::subAngle(angles[hi + 1], angles[i])) <= myAngleToCheck)
+      hi++;
 
     // if we're ignoring this reading then just get on with life
-    if (reading->getIgnoreThisReading())
+    if (ignore[i] != 0)
       continue;
 
-    /* Taking this check out since the base class does it now and if
-     * it gets marked ignore now it won't get used for clearing
-     * cumulative readings
+    const unsigned int range = ranges[i];
+    const bool inMinRangeAngles = (angles[i] < myAnyMinRangeLessThanAngle ||
+				   angles[i] > myAnyMinRangeGreaterThanAngle);
 
-    if (myMaxRange >= 0 && reading->getRange() > myMaxRange)
+    if (myAnyMinRange >= 0 && range < myAnyMinRange && inMinRangeAngles)
     {
 #ifdef DEBUGRANGEFILTER
-      if (file != NULL)
-	fprintf(file, "%.1f beyond max range at %d\n", 
-		reading->getSensorTh(), reading->getRange());
+      ArLog::log(ArLog::Normal, "%s: %.1f within min range at %u", 
+		 getName(), angles[i], range);
 #endif
-      reading->setIgnoreThisReading(true);
+      ignore[i] = 1;
       continue;
     }
-    */
-    if (myAnyMinRange >= 0 && reading->getRange() < myAnyMinRange &&
-	(reading->getSensorTh() < myAnyMinRangeLessThanAngle ||
-	 reading->getSensorTh() > myAnyMinRangeGreaterThanAngle))
-    {
-#ifdef DEBUGRANGEFILTER
-      if (file != NULL)
-	fprintf(file, "%.1f within min range at %d\n", 
-		reading->getSensorTh(), reading->getRange());
-#endif
-      reading->setIgnoreThisReading(true);
-      continue;
-    }
-
-    /*
-    if (lastAddedReading != NULL)
-    {
-
-      if (lastAddedReading->getPose().findDistanceTo(reading->getPose()) < 50)
-      {
-#ifdef DEBUGRANGEFILTER
-	if (file != NULL)
-	  fprintf(file, "%.1f too close from last %6.0f\n", 
-		  reading->getSensorTh(),
-		  lastAddedReading->getPose().findDistanceTo(
-			  reading->getPose()));
-#endif
-	reading->setIgnoreThisReading(true);
-	continue;
-      }
-#ifdef DEBUGRANGEFILTER
-      else if (file != NULL)
-	fprintf(file, "%.1f from last %6.0f\n", 
-		reading->getSensorTh(),
-		lastAddedReading->getPose().findDistanceTo(
-			reading->getPose()));
-#endif
-    }
-    */
-
-#ifdef DEBUGRANGEFILTER
-  char buf[1024];
-  buf[0] = '\0';
-#endif
 
     bool goodAll = true;
-    bool goodAny = false;
+    bool goodAny = (myAnyFactor <= 0);
     bool goodMinRange = true;
-    if (myAnyFactor <= 0)
-      goodAny = true;
-    for (j = i - 1; 
-	 (j >= 0 && //good && 
-	  fabs(ArMath::subAngle(readingMap[j]->getSensorTh(),
-				reading->getSensorTh())) <= myAngleToCheck);
-	 j--)
+    for (size_t j = lo; j <= hi; j++)
     {
-      /* You can't skip these, or you get onesided filtering
-      if (readingMap[j]->getIgnoreThisReading())
-      {
-#ifdef DEBUGRANGEFILTER
-	sprintf(buf, "%s %6s", buf, "i");
-#endif
+      if (j == i)
 	continue;
-      }
-      */
-#ifdef DEBUGRANGEFILTER
-      //sprintf(buf, "%s %6d", buf, readingMap[j]->getRange());
-      // append value to buf:
-      const size_t n = strlen(buf);
-      snprintf(buf+n, sizeof(buf) - n, " %6d", readingMap[j]->getRange());
-#endif
-      if (myAllFactor > 0 && 
-	  !checkRanges(reading->getRange(), 
-		       readingMap[j]->getRange(), myAllFactor))
+      if (myAllFactor > 0 && !checkRanges(range, ranges[j], myAllFactor))
 	goodAll = false;
-      if (myAnyFactor > 0 &&
-	  checkRanges(reading->getRange(), 
-		      readingMap[j]->getRange(), myAnyFactor))
+      if (myAnyFactor > 0 && checkRanges(range, ranges[j], myAnyFactor))
 	goodAny = true;
-      if (myAnyMinRange > 0 && 
-	  (reading->getSensorTh() < myAnyMinRangeLessThanAngle ||
-	   reading->getSensorTh() > myAnyMinRangeGreaterThanAngle) &&
-	  readingMap[j]->getRange() <= myAnyMinRange)
+      if (myAnyMinRange > 0 && inMinRangeAngles && 
+	  ranges[j] <= myAnyMinRange)
 	goodMinRange = false;
-	
     }
-#ifdef DEBUGRANGEFILTER
-    buf[0] = '\0';
-    snprintf(buf, sizeof(buf), "%6d*", buf, reading->getRange());
-#endif 
-    for (j = i + 1; 
-	 (j < numReadings && //good &&
-	  fabs(ArMath::subAngle(readingMap[j]->getSensorTh(),
-				reading->getSensorTh())) <= myAngleToCheck);
-	 j++)
-    {
-      // you can't ignore these or you get one sided filtering
-      /*
-      if (readingMap[j]->getIgnoreThisReading())
-      {
-#ifdef DEBUGRANGEFILTER
-	sprintf(buf, "%s %6s", buf, "i");
-#endif
-	continue;
-      }
-      */
-#ifdef DEBUGRANGEFILTER
-      sprintf(buf, "%s %6d", buf, readingMap[j]->getRange());
-#endif
-      if (myAllFactor > 0 && 
-	  !checkRanges(reading->getRange(), 
-		       readingMap[j]->getRange(), myAllFactor))
-	goodAll = false;
-      if (myAnyFactor > 0 &&
-	  checkRanges(reading->getRange(), 
-		       readingMap[j]->getRange(), myAnyFactor))
-	goodAny = true;
-      if (myAnyMinRange > 0 && 
-	  (reading->getSensorTh() < myAnyMinRangeLessThanAngle ||
-	   reading->getSensorTh() > myAnyMinRangeGreaterThanAngle) &&
-	  readingMap[j]->getRange() <= myAnyMinRange)
-	goodMinRange = false;
-    }
-    
 
     if (!goodAll || !goodAny || !goodMinRange)
-      reading->setIgnoreThisReading(true);
-    /*
-    else
-      lastAddedReading = reading;
-    */
+      ignore[i] = 1;
 #ifdef DEBUGRANGEFILTER
-    if (file != NULL)
-      fprintf(file, 
-	      "%5.1f %6d %c\t%s\n", reading->getSensorTh(), reading->getRange(),
-	      goodAll && goodAny && goodMinRange ? 'g' : 'b', buf);
+    ArLog::log(ArLog::Normal, "%s: %5.1f %6u %c (neighbors %lu to %lu)", 
+	       getName(), angles[i], range,
+	       goodAll && goodAny && goodMinRange ? 'g' : 'b', 
+	       (unsigned long)lo, (unsigned long)hi);
 #endif
-	    
   }
+}
 
+/**
+   Ignores readings that are further than myMedianMaxDeviation from
+   the median of the (not ignored) readings within myMedianWindow
+   readings on either side.  The decisions are all made from the
+   ignore flags as they were when the stage started, so the result
+   doesn't depend on the order the readings are walked in.
+**/
+void ArLaserFilter::medianStage()
+{
+  if (myMedianWindow <= 0 || myMedianMaxDeviation < 0)
+    return;
 
-#ifdef DEBUGRANGEFILTER
-  if (file != NULL)
-    fclose(file);
-#endif
+  const size_t numReadings = myScan.size();
+  const size_t window = (size_t)myMedianWindow;
+  const unsigned int *ranges = myScan.ranges.data();
+  unsigned char *ignore = myScan.ignore.data();
 
-  laserProcessReadings();
-  copyReadingCount(myLaser);
+  myMedianWork.reserve(2 * window + 1);
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    if (ignore[i] != 0)
+      continue;
+    const size_t lo = i > window ? i - window : 0;
+    const size_t hi = std::min(i + window, numReadings - 1);
+    myMedianWork.clear();
+    for (size_t j = lo; j <= hi; j++)
+    {
+      // 1 means ignored before this stage, 2 means ignored by this stage
+      if (ignore[j] != 1)
+	myMedianWork.push_back(ranges[j]);
+    }
+    std::vector<unsigned int>::iterator mid = 
+      myMedianWork.begin() + (long)(myMedianWork.size() / 2);
+    std::nth_element(myMedianWork.begin(), mid, myMedianWork.end());
+    if (fabs((double)ranges[i] - (double)*mid) > myMedianMaxDeviation)
+      ignore[i] = 2;
+  }
 
-  selfUnlockDevice();
-  myLaser->unlockDevice();
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    if (ignore[i] == 2)
+      ignore[i] = 1;
+  }
+}
+
+void ArLaserFilter::intensityStage()
+{
+  if (myMinIntensity < 0)
+    return;
+
+  const size_t numReadings = myScan.size();
+  const int *intensities = myScan.intensities.data();
+  unsigned char *ignore = myScan.ignore.data();
+
+  for (size_t i = 0; i < numReadings; i++)
+  {
+    if (intensities[i] < myMinIntensity)
+      ignore[i] = 1;
+  }
 }
 
 /**
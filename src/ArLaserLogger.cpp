@@ -314,7 +314,7 @@ AREXPORT ArLaserLogger::ArLaserLogger(
   myRobot->comStr(94, uCFileName);
 
   myLoopPacketHandlerCB.setName("ArLaserLogger");
-  myRobot->addPacketHandler(&myLoopPacketHandlerCB, ArListPos::FIRST);
+  myRobot->addPacketHandler(&myLoopPacketHandlerCB, {0x96}, ArListPos::FIRST);
 
   myAddGoals = addGoals;
   myJoyHandler = joyHandler;
@@ -633,7 +633,7 @@ void ArLaserLogger::internalTakeReading()
     for (laserIt = myLasers.begin(); laserIt != myLasers.end(); ++laserIt)
     {
       laser = (*laserIt);
-      laser->lockDevice();
+      laser->lockDeviceShared();
       if (laser->getRawReadings() != NULL && 
 	  !laser->getRawReadings()->empty())
 	lasersToLog.insert(
@@ -657,7 +657,7 @@ void ArLaserLogger::internalTakeReading()
     for (laserIt = myLasers.begin(); laserIt != myLasers.end(); ++laserIt)
     {
       laser = (*laserIt);
-      laser->unlockDevice();
+      laser->unlockDeviceShared();
     }
 
   }
@@ -105,7 +105,7 @@ AREXPORT void ArLineFinder::fillPointsFromLaser()
 
   myPoints = new std::map<int, ArPose>; // XXX TODO clear and resize myPoints instead of allocating
   
-  myRangeDevice->lockDevice();
+  myRangeDevice->lockDeviceShared();
   readings = myRangeDevice->getRawReadings();
 
   if (!myFlippedFound)
@@ -135,7 +135,7 @@ AREXPORT void ArLineFinder::fillPointsFromLaser()
 
   if (readings->begin() == readings->end())
   {
-    myRangeDevice->unlockDevice();
+    myRangeDevice->unlockDeviceShared();
     return;
   }
   myPoseTaken = (*readings->begin())->getPoseTaken();
@@ -163,7 +163,7 @@ AREXPORT void ArLineFinder::fillPointsFromLaser()
       pointCount++;
     }
   }
-  myRangeDevice->unlockDevice();
+  myRangeDevice->unlockDeviceShared();
 }
 
 AREXPORT void ArLineFinder::findLines()
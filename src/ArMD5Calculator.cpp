@@ -28,6 +28,19 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaInternal.h"
 
 #include "Aria/ArLog.h"
+#include "Aria/ArThreadPool.h"
+
+// md5_append takes an int length, so feed it big blocks in pieces
+static void appendToState(md5_state_t *state, const void *data, size_t len)
+{
+  const md5_byte_t *p = (const md5_byte_t *) data;
+  while (len > 0) {
+    const size_t chunk = std::min(len, (size_t) INT_MAX);
+    md5_append(state, p, (int)chunk);
+    p += chunk;
+    len -= chunk;
+  }
+}
 
 
 AREXPORT ArMD5Calculator::ArMD5Calculator(ArFunctor1<const char*> *secondFunctor) :
@@ -35,18 +48,25 @@ AREXPORT ArMD5Calculator::ArMD5Calculator(ArFunctor1<const char*> *secondFunctor
   mySecondFunctor(secondFunctor),
   myState(),
   myDigest(),
-  myIsFinished(false)
+  myIsFinished(false),
+  myPool(NULL),
+  myIsHashing(false),
+  myHashQueuedCB(this, &ArMD5Calculator::hashQueued)
 {
   myDigest[0] = '\0';
+  myHashQueuedCB.setName("ArMD5Calculator::hashQueued");
   md5_init(&myState);
 }
 
 AREXPORT ArMD5Calculator::~ArMD5Calculator()
 {
+  waitForQueued();
 }
   
 AREXPORT void ArMD5Calculator::reset()
 {
+  waitForQueued();
+  myFilling.clear();
   myDigest[0] = '\0';
   md5_init(&myState);
 
@@ -68,9 +88,29 @@ AREXPORT void ArMD5Calculator::setSecondFunctor(ArFunctor1<const char *> *second
   mySecondFunctor = secondFunctor;
 }
 
+AREXPORT void ArMD5Calculator::setHashInBackground(bool inBackground,
+                                                   ArThreadPool *pool)
+{
+  // anything already appended is hashed in order before switching
+  if (!myFilling.empty()) {
+    queueFilling();
+  }
+  waitForQueued();
+  if (!inBackground) {
+    myPool = NULL;
+  }
+  else {
+    myPool = (pool != NULL) ? pool : ArThreadPool::getShared();
+  }
+}
+
 AREXPORT unsigned char *ArMD5Calculator::getDigest()
 {
   if (!myIsFinished) {
+    if (!myFilling.empty()) {
+      queueFilling();
+    }
+    waitForQueued();
     md5_finish(&myState, myDigest);
     myIsFinished = true;
   }
@@ -138,16 +178,17 @@ AREXPORT bool ArMD5Calculator::calculateChecksum(const char *fileName,
 
   ArMD5Calculator calculator;
 
-  // TODO: Make this static and protect w/ mutex?
-  char line[10000];
-  //bool ret = true;
+  // Hash whole blocks rather than lines, the result is the same
+  char *block = new char[BLOCK_SIZE];
+  size_t len;
 
-  while (fgets(line, sizeof(line), file) != NULL)
+  while ((len = fread(block, 1, BLOCK_SIZE, file)) > 0)
   {
-    calculator.append(line);
+    calculator.appendBlock(block, len);
   }
   
   fclose(file);
+  delete [] block;
 
   if (md5DigestBuffer != NULL) {
     if (md5DigestBufferLen != ArMD5Calculator::DIGEST_LENGTH) {
@@ -175,11 +216,20 @@ AREXPORT void ArMD5Calculator::append(const char *str)
   if (str == NULL) {
     ArLog::log(ArLog::Terse,
                "ArMD5Calculator::append cannot append null string");
+    return;
   }
 
   const size_t len = strlen(str);
-  assert(len <= INT_MAX);
-  md5_append(&myState, (unsigned char *) str, (int)len);
+  if (myPool != NULL) {
+    myFilling.append(str, len);
+    if (myFilling.size() >= BLOCK_SIZE) {
+      queueFilling();
+    }
+  }
+  else {
+    assert(len <= INT_MAX);
+    md5_append(&myState, (unsigned char *) str, (int)len);
+  }
 
   if (mySecondFunctor != NULL) {
     mySecondFunctor->invoke(str);
@@ -187,3 +237,67 @@ AREXPORT void ArMD5Calculator::append(const char *str)
 
 } // end method append
 
+
+AREXPORT void ArMD5Calculator::appendBlock(const void *data, size_t len)
+{
+  if ((data == NULL) || (len == 0)) {
+    return;
+  }
+  if (myPool != NULL) {
+    myFilling.append((const char *) data, len);
+    if (myFilling.size() >= BLOCK_SIZE) {
+      queueFilling();
+    }
+    return;
+  }
+  appendToState(&myState, data, len);
+} // end method appendBlock
+
+
+void ArMD5Calculator::queueFilling()
+{
+  bool start = false;
+  {
+    std::lock_guard<std::mutex> lock(myQueueMutex);
+    myQueued.push_back(std::move(myFilling));
+    if (!myIsHashing) {
+      myIsHashing = true;
+      start = true;
+    }
+  }
+  myFilling.clear();
+  myFilling.reserve(BLOCK_SIZE);
+  // hash it here if the pool won't take it
+  if (start && (myPool == NULL || myPool->submit(&myHashQueuedCB) == 0)) {
+    hashQueued();
+  }
+} // end method queueFilling
+
+
+void ArMD5Calculator::hashQueued()
+{
+  std::string block;
+
+  // only one of these runs at a time, so blocks are hashed in order
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(myQueueMutex);
+      if (myQueued.empty()) {
+        myIsHashing = false;
+        myQueueCond.notify_all();
+        return;
+      }
+      block = std::move(myQueued.front());
+      myQueued.pop_front();
+    }
+    appendToState(&myState, block.data(), block.size());
+  }
+} // end method hashQueued
+
+
+void ArMD5Calculator::waitForQueued()
+{
+  std::unique_lock<std::mutex> lock(myQueueMutex);
+  myQueueCond.wait(lock, [this] { return !myIsHashing; });
+} // end method waitForQueued
+
@@ -26,6 +26,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArMTXIO.h"
 #include "Aria/ariaInternal.h"
 #include <errno.h>
+#include <chrono>
 
 #include <sys/ioctl.h>
 #include <fcntl.h>
@@ -106,9 +107,11 @@ ArMutex ArMTXIO::ourMutex;
 */
 AREXPORT ArMTXIO::ArMTXIO(const char * dev) :
   myDisconnectCB(this, &ArMTXIO::closeIO),
-  myLPCTimeUSecCB(this, &ArMTXIO::getLPCTimeUSec)
+  myLPCTimeUSecCB(this, &ArMTXIO::getLPCTimeUSec),
+  myTakeSnapshotCB(this, &ArMTXIO::takeSnapshot)
 {
   ourMutex.setLogName("ArMTXIO::ourMutex");
+  setDefaultSnapshotRegisters();
 
 	myFirmwareRevision = 0;
 	myFirmwareVersion = 0;
@@ -1497,3 +1500,224 @@ AREXPORT bool ArMTXIO::setAnalogIOBlock2(unsigned short analog, unsigned short *
 
 
 
+AREXPORT void ArMTXIO::setDefaultSnapshotRegisters()
+{
+  static const unsigned short defaultRegs[] = {
+    MTX_DIO_INPUT_MON1, MTX_DIO_INPUT_MON2, MTX_DIO_OUTPUT_MON1,
+    MTX_DIO_OUTPUT_MON2, MTX_BUMPER_INPUT_MON, MTX_PWR_STATUS1,
+    MTX_PWR_STATUS2, MTX_LIDAR_STATUS, MTX_ESTOP_STATUS1, MTX_ESTOP_STATUS2,
+    MTX_ESTOP_STATUS3, MTX_ESTOP_STATUS4, MTX_DIO_OUTPUT_CTRL1,
+    MTX_DIO_OUTPUT_CTRL2, MTX_LIGHTPOLE_OUTPUT_CTRL, MTX_PERIPH_PWR_CTRL1,
+    MTX_PERIPH_PWR_CTRL2, MTX_PERIPH_PWR_CTRL3, MTX_MOTION_PWR_STATUS
+  };
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  for (size_t i = 0; i < SNAPSHOT_NUM_REGS; i++)
+    mySnapshotRegs[i] = false;
+  for (size_t i = 0; i < sizeof(defaultRegs) / sizeof(defaultRegs[0]); i++)
+    mySnapshotRegs[defaultRegs[i]] = true;
+  mySnapshotReads = planSnapshotReads(mySnapshotRegs, SNAPSHOT_NUM_REGS);
+}
+
+AREXPORT bool ArMTXIO::addSnapshotRegister(unsigned short reg)
+{
+  if (reg >= SNAPSHOT_NUM_REGS)
+  {
+    ArLog::log(ArLog::Normal, "ArMTXIO::addSnapshotRegister() register %#x can't be in a snapshot", reg);
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  mySnapshotRegs[reg] = true;
+  mySnapshotReads = planSnapshotReads(mySnapshotRegs, SNAPSHOT_NUM_REGS);
+  return true;
+}
+
+AREXPORT void ArMTXIO::remSnapshotRegister(unsigned short reg)
+{
+  if (reg >= SNAPSHOT_NUM_REGS)
+    return;
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  mySnapshotRegs[reg] = false;
+  mySnapshotReads = planSnapshotReads(mySnapshotRegs, SNAPSHOT_NUM_REGS);
+}
+
+AREXPORT void ArMTXIO::clearSnapshotRegisters()
+{
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  for (size_t i = 0; i < SNAPSHOT_NUM_REGS; i++)
+    mySnapshotRegs[i] = false;
+  mySnapshotReads.clear();
+}
+
+AREXPORT size_t ArMTXIO::getNumSnapshotReads() const
+{
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  return mySnapshotReads.size();
+}
+
+AREXPORT std::vector<ArMTXIO::SnapshotRead> ArMTXIO::planSnapshotReads(
+	const bool *regs, size_t numRegs)
+{
+  std::vector<SnapshotRead> reads;
+  size_t reg = 0;
+  while (reg < numRegs)
+  {
+    if (!regs[reg])
+    {
+      reg++;
+      continue;
+    }
+    // length of this run of registers
+    size_t end = reg;
+    while (end < numRegs && regs[end])
+      end++;
+    // the driver reads 1, 2 or 4 registers (into myVal8, myVal16 or
+    // myVal32), like the version registers in the constructor; only use
+    // the wider reads when aligned
+    while (reg < end)
+    {
+      unsigned short size = 1;
+      if (reg % 4 == 0 && end - reg >= 4)
+	size = 4;
+      else if (reg % 2 == 0 && end - reg >= 2)
+	size = 2;
+      SnapshotRead read;
+      read.reg = (unsigned short)reg;
+      read.size = size;
+      reads.push_back(read);
+      reg += size;
+    }
+  }
+  return reads;
+}
+
+AREXPORT bool ArMTXIO::takeSnapshot()
+{
+  if (!myEnabled)
+    return false;
+
+  std::vector<SnapshotRead> reads;
+  {
+    std::lock_guard<std::mutex> lock(mySnapshotMutex);
+    reads = mySnapshotReads;
+  }
+
+  Snapshot snapshot;
+  snapshot.complete = true;
+  const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+  for (std::vector<SnapshotRead>::const_iterator it = reads.begin(); it != reads.end(); ++it)
+  {
+    MTX_IOREQ req;
+    req.myReg = it->reg;
+    req.mySize = it->size;
+    req.myData.myVal32 = 0;
+    snapshot.numReads++;
+    if (ioctl(myFD, MTX_READ_REG, &req) != 0)
+    {
+      ArLog::log(ArLog::Normal, "ArMTXIO::takeSnapshot() failed to read %d register(s) at %#x, errno %i", it->size, it->reg, errno);
+      snapshot.complete = false;
+      continue;
+    }
+    // the first register is in the low byte, like the version registers
+    for (unsigned short i = 0; i < it->size; i++)
+    {
+      snapshot.values[it->reg + i] = static_cast<unsigned char>((req.myData.myVal32 >> (8 * i)) & 0xff);
+      snapshot.have[it->reg + i] = true;
+    }
+  }
+  snapshot.readUSecs = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - started).count();
+  snapshot.timeTaken.setToNow();
+
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  snapshot.number = mySnapshot.number + 1;
+  mySnapshot = snapshot;
+  return snapshot.complete;
+}
+
+AREXPORT ArMTXIO::Snapshot ArMTXIO::getSnapshot() const
+{
+  std::lock_guard<std::mutex> lock(mySnapshotMutex);
+  return mySnapshot;
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getDigitalBankInputs(int bank, unsigned char *val) const
+{
+  switch (bank)
+  {
+    case 0:
+      return getRegValue(MTX_DIO_INPUT_MON1, val);
+    case 1:
+      return getRegValue(MTX_DIO_INPUT_MON2, val);
+    default:
+      return false;
+  }
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getDigitalBankOutputs(int bank, unsigned char *val) const
+{
+  switch (bank)
+  {
+    case 2:
+      return getRegValue(MTX_DIO_OUTPUT_CTRL1, val);
+    case 3:
+      return getRegValue(MTX_DIO_OUTPUT_CTRL2, val);
+    default:
+      return false;
+  }
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getPeripheralPowerBankOutputs(int bank, unsigned char *val) const
+{
+  switch (bank)
+  {
+    case 0:
+      return getRegValue(MTX_PERIPH_PWR_CTRL1, val);
+    case 1:
+      return getRegValue(MTX_PERIPH_PWR_CTRL2, val);
+    case 2:
+      return getRegValue(MTX_PERIPH_PWR_CTRL3, val);
+    default:
+      return false;
+  }
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getDigitalIOOutputMon(int num, unsigned char *val) const
+{
+  if (num < 1 || num > 2)
+    return false;
+  return getRegValue((unsigned short)(MTX_DIO_OUTPUT_MON1 + num - 1), val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getBumperInput(unsigned char *val) const
+{
+  return getRegValue(MTX_BUMPER_INPUT_MON, val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getPowerStatus(int num, unsigned char *val) const
+{
+  if (num < 1 || num > 2)
+    return false;
+  return getRegValue((unsigned short)(MTX_PWR_STATUS1 + num - 1), val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getLIDARSafety(unsigned char *val) const
+{
+  return getRegValue(MTX_LIDAR_STATUS, val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getESTOPStatus(int num, unsigned char *val) const
+{
+  if (num < 1 || num > 4)
+    return false;
+  return getRegValue((unsigned short)(MTX_ESTOP_STATUS1 + num - 1), val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getMotionPowerStatus(unsigned char *val) const
+{
+  return getRegValue(MTX_MOTION_PWR_STATUS, val);
+}
+
+AREXPORT bool ArMTXIO::Snapshot::getLightPole(unsigned char *val) const
+{
+  return getRegValue(MTX_LIGHTPOLE_OUTPUT_CTRL, val);
+}
@@ -26,6 +26,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include <algorithm>
 #include <iterator>
+#include <thread>
 #ifdef WIN32
 #include <process.h>
 #endif 
@@ -4314,6 +4315,9 @@ AREXPORT bool ArMapSimple::readFile(const char *fileName,
   if (myChecksumCalculator != NULL) {
       
     myChecksumCalculator->reset();
+    // With more than one core, hash on another one while we parse
+    myChecksumCalculator->setHashInBackground(
+            std::thread::hardware_concurrency() > 1);
 
     parseFunctor = myChecksumCalculator->getFunctor();
     myLoadingParser->setPreParseFunctor(parseFunctor);
@@ -4843,6 +4847,9 @@ AREXPORT bool ArMapSimple::writeFile(const char *fileName,
                "ArMapSimple::writeFile() recalculating checksum");
 
     myChecksumCalculator->reset();
+    // With more than one core, hash on another one while we write
+    myChecksumCalculator->setHashInBackground(
+            std::thread::hardware_concurrency() > 1);
 
     // Note that this is reset to NULL below before it leaves the scope
     // of this method.
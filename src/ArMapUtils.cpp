@@ -29,6 +29,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArBasePacket.h"
 #include "Aria/ArMapComponents.h"
 #include "Aria/ArMD5Calculator.h"
+#include "Aria/ArFastHash.h"
 
 #include <iterator>
 
@@ -529,7 +530,8 @@ AREXPORT bool ArMapId::toPacket(const ArMapId &mapId,
   
   
 AREXPORT bool ArMapId::create(const char *mapFileName,
-                              ArMapId *mapIdOut)
+                              ArMapId *mapIdOut,
+                              ChecksumType checksumType)
 {
   if (mapIdOut == NULL) {
     ArLog::log(ArLog::Normal,
@@ -553,9 +555,20 @@ AREXPORT bool ArMapId::create(const char *mapFileName,
   }
 
   unsigned char buffer[ArMD5Calculator::DIGEST_LENGTH];
-  bool isSuccess = ArMD5Calculator::calculateChecksum(mapFileName,
-                                                      buffer,
-                                                      sizeof(buffer));
+  size_t bufferLen = sizeof(buffer);
+  bool isSuccess = false;
+
+  if (checksumType == CHECKSUM_FAST) {
+    bufferLen = ArFastHash::DIGEST_LENGTH;
+    isSuccess = ArFastHash::calculateChecksum(mapFileName,
+                                              buffer,
+                                              bufferLen);
+  }
+  else {
+    isSuccess = ArMD5Calculator::calculateChecksum(mapFileName,
+                                                   buffer,
+                                                   bufferLen);
+  }
 
   if (!isSuccess) {
     ArLog::log(ArLog::Normal,
@@ -566,7 +579,7 @@ AREXPORT bool ArMapId::create(const char *mapFileName,
   }
 
   mapIdOut->setFileName(mapFileName);
-	mapIdOut->setChecksum(buffer, sizeof(buffer));
+	mapIdOut->setChecksum(buffer, bufferLen);
   assert(mapFileStat.st_size <= UINT_MAX);
   mapIdOut->setSize((size_t)mapFileStat.st_size);
   mapIdOut->setTimestamp(mapFileStat.st_mtime);
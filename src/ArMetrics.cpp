@@ -0,0 +1,746 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArMetrics.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+AREXPORT size_t ArMetricCounter::getThreadShard()
+{
+  static std::atomic<size_t> nextShard{0};
+  thread_local size_t shard = 
+    nextShard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+  return shard;
+}
+
+AREXPORT unsigned long long ArMetricCounter::get() const
+{
+  unsigned long long total = 0;
+  for (size_t i = 0; i < NUM_SHARDS; i++)
+    total += myShards[i].value.load(std::memory_order_relaxed);
+  return total;
+}
+
+AREXPORT void ArMetricCounter::reset()
+{
+  for (size_t i = 0; i < NUM_SHARDS; i++)
+    myShards[i].value.store(0, std::memory_order_relaxed);
+}
+
+AREXPORT void ArMetricGauge::add(double delta)
+{
+  double value = myValue.load(std::memory_order_relaxed);
+  while (!myValue.compare_exchange_weak(value, value + delta, 
+					std::memory_order_relaxed))
+    ;
+}
+
+AREXPORT ArMetricHistogram::ArMetricHistogram(const std::vector<double> &bounds) :
+  myBounds(bounds),
+  myBuckets(new std::atomic<unsigned long long>[bounds.size() + 1])
+{
+  std::sort(myBounds.begin(), myBounds.end());
+  myBounds.erase(std::unique(myBounds.begin(), myBounds.end()), myBounds.end());
+  for (size_t i = 0; i <= myBounds.size(); i++)
+    myBuckets[i].store(0, std::memory_order_relaxed);
+}
+
+AREXPORT void ArMetricHistogram::observe(double value)
+{
+  if (std::isnan(value))
+    return;
+  // the first bucket whose bound is >= value, or the overflow bucket
+  size_t bucket = (size_t)(std::lower_bound(myBounds.begin(), myBounds.end(), 
+					    value) - myBounds.begin());
+  myBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  double sum = mySum.load(std::memory_order_relaxed);
+  while (!mySum.compare_exchange_weak(sum, sum + value, 
+				      std::memory_order_relaxed))
+    ;
+}
+
+AREXPORT std::vector<unsigned long long> ArMetricHistogram::getBucketCounts() const
+{
+  std::vector<unsigned long long> counts(myBounds.size() + 1);
+  for (size_t i = 0; i < counts.size(); i++)
+    counts[i] = myBuckets[i].load(std::memory_order_relaxed);
+  return counts;
+}
+
+AREXPORT unsigned long long ArMetricHistogram::getCount() const
+{
+  unsigned long long count = 0;
+  for (size_t i = 0; i <= myBounds.size(); i++)
+    count += myBuckets[i].load(std::memory_order_relaxed);
+  return count;
+}
+
+AREXPORT void ArMetricHistogram::reset()
+{
+  for (size_t i = 0; i <= myBounds.size(); i++)
+    myBuckets[i].store(0, std::memory_order_relaxed);
+  mySum.store(0, std::memory_order_relaxed);
+}
+
+
+/**
+   Where ArMetrics keeps everything.  It is made on first use and never
+   deleted, so that metrics can still be updated by objects that are
+   destroyed while the program exits.
+
+   The callback gauges have their own mutex, which is held while they
+   are called, so that remCallbackGauge() can wait for a call that is
+   going on.  The functors often lock the object they belong to, and
+   those objects may register metrics while they are locked, so the
+   two mutexes are never held at the same time.
+**/
+struct ArMetricsRegistry
+{
+  struct Metric
+  {
+    ArMetrics::Type type;
+    std::unique_ptr<ArMetricCounter> counter;
+    std::unique_ptr<ArMetricGauge> gauge;
+    std::unique_ptr<ArMetricHistogram> histogram;
+  };
+  struct Name
+  {
+    ArMetrics::Type type;
+    std::string help;
+  };
+  struct CallbackGauge
+  {
+    std::string name;
+    std::string labels;
+    ArRetFunctor<double> *functor;
+  };
+
+  std::mutex mutex;
+  // keyed by name and then labels, so snapshots come out sorted
+  std::map<std::pair<std::string, std::string>, Metric> metrics;
+  // the type and help of each name, which are the same for all its labels
+  std::map<std::string, Name> names;
+
+  std::mutex callbackMutex;
+  std::vector<CallbackGauge> callbackGauges;
+
+  static ArMetricsRegistry *get()
+  {
+    static ArMetricsRegistry *registry = new ArMetricsRegistry;
+    return registry;
+  }
+
+  // Checks (with mutex locked) that name isn't registered as a different
+  // type, and keeps the first help given for it
+  bool checkName(const char *name, const char *help, ArMetrics::Type type)
+  {
+    auto it = names.find(name);
+    if (it == names.end())
+    {
+      Name &info = names[name];
+      info.type = type;
+      info.help = (help != NULL) ? help : "";
+      return true;
+    }
+    if (it->second.type == type)
+    {
+      if (it->second.help.empty() && help != NULL)
+	it->second.help = help;
+      return true;
+    }
+    ArLog::log(ArLog::Normal, 
+	       "ArMetrics: Metric %s is already registered as a different type", 
+	       name);
+    return false;
+  }
+
+  Metric *findOrAdd(const char *name, const char *help, 
+		    const std::string &labels, ArMetrics::Type type)
+  {
+    if (!checkName(name, help, type))
+      return NULL;
+    Metric &metric = metrics[std::make_pair(std::string(name), labels)];
+    metric.type = type;
+    return &metric;
+  }
+};
+
+AREXPORT ArMetricCounter *ArMetrics::getCounter(const char *name, 
+						const char *help,
+						const std::string &labels)
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  ArMetricsRegistry::Metric *metric = 
+    registry->findOrAdd(name, help, labels, COUNTER);
+  if (metric == NULL)
+    return NULL;
+  if (!metric->counter)
+    metric->counter.reset(new ArMetricCounter);
+  return metric->counter.get();
+}
+
+AREXPORT ArMetricGauge *ArMetrics::getGauge(const char *name, 
+					    const char *help,
+					    const std::string &labels)
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  ArMetricsRegistry::Metric *metric = 
+    registry->findOrAdd(name, help, labels, GAUGE);
+  if (metric == NULL)
+    return NULL;
+  if (!metric->gauge)
+    metric->gauge.reset(new ArMetricGauge);
+  return metric->gauge.get();
+}
+
+AREXPORT ArMetricHistogram *ArMetrics::getHistogram(
+	const char *name, const char *help, const std::string &labels,
+	const std::vector<double> &bounds)
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  ArMetricsRegistry::Metric *metric = 
+    registry->findOrAdd(name, help, labels, HISTOGRAM);
+  if (metric == NULL)
+    return NULL;
+  if (!metric->histogram)
+    metric->histogram.reset(new ArMetricHistogram(
+				    bounds.empty() ? getDefaultMSecBounds() : bounds));
+  return metric->histogram.get();
+}
+
+AREXPORT bool ArMetrics::addCallbackGauge(const char *name, const char *help,
+					  const std::string &labels,
+					  ArRetFunctor<double> *functor)
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  {
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    if (!registry->checkName(name, help, GAUGE))
+      return false;
+  }
+  std::lock_guard<std::mutex> lock(registry->callbackMutex);
+  for (const ArMetricsRegistry::CallbackGauge &gauge : 
+	 registry->callbackGauges)
+  {
+    if (gauge.name == name && gauge.labels == labels)
+    {
+      ArLog::log(ArLog::Normal, 
+		 "ArMetrics: Callback gauge %s{%s} is already registered", 
+		 name, labels.c_str());
+      return false;
+    }
+  }
+  ArMetricsRegistry::CallbackGauge gauge;
+  gauge.name = name;
+  gauge.labels = labels;
+  gauge.functor = functor;
+  registry->callbackGauges.push_back(gauge);
+  return true;
+}
+
+AREXPORT void ArMetrics::remCallbackGauge(ArRetFunctor<double> *functor)
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::lock_guard<std::mutex> lock(registry->callbackMutex);
+  std::vector<ArMetricsRegistry::CallbackGauge> &gauges = 
+    registry->callbackGauges;
+  gauges.erase(std::remove_if(gauges.begin(), gauges.end(), 
+			      [functor](const ArMetricsRegistry::CallbackGauge &g) 
+			      { return g.functor == functor; }),
+	       gauges.end());
+}
+
+AREXPORT std::vector<ArMetrics::Sample> ArMetrics::getSnapshot()
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::vector<Sample> samples;
+  std::map<std::string, ArMetricsRegistry::Name> names;
+  {
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    names = registry->names;
+    samples.reserve(registry->metrics.size());
+    for (const auto &entry : registry->metrics)
+    {
+      const ArMetricsRegistry::Metric &metric = entry.second;
+      Sample sample;
+      sample.name = entry.first.first;
+      sample.labels = entry.first.second;
+      sample.type = metric.type;
+      if (metric.counter)
+	sample.value = (double)metric.counter->get();
+      else if (metric.gauge)
+	sample.value = metric.gauge->get();
+      else if (metric.histogram)
+      {
+	sample.value = metric.histogram->getSum();
+	sample.bounds = metric.histogram->getBounds();
+	sample.bucketCounts = metric.histogram->getBucketCounts();
+	for (unsigned long long count : sample.bucketCounts)
+	  sample.count += count;
+      }
+      samples.push_back(sample);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(registry->callbackMutex);
+    for (const ArMetricsRegistry::CallbackGauge &gauge : 
+	   registry->callbackGauges)
+    {
+      Sample sample;
+      sample.name = gauge.name;
+      sample.labels = gauge.labels;
+      sample.type = GAUGE;
+      sample.value = gauge.functor->invokeR();
+      samples.push_back(sample);
+    }
+  }
+  for (Sample &sample : samples)
+  {
+    auto it = names.find(sample.name);
+    if (it != names.end())
+      sample.help = it->second.help;
+  }
+  if (ArMutex::getProfiling())
+  {
+    for (const ArMutex::ProfileStats &stats : ArMutex::getProfileStats())
+    {
+      Sample sample;
+      sample.type = COUNTER;
+      sample.labels = makeLabels("mutex", stats.name);
+      sample.name = "aria_mutex_locks_total";
+      sample.help = "Times each ArMutex was locked (while profiling)";
+      sample.value = (double)stats.locks;
+      samples.push_back(sample);
+      sample.name = "aria_mutex_contended_locks_total";
+      sample.help = "Times each ArMutex had to wait to be locked (while profiling)";
+      sample.value = (double)stats.contendedLocks;
+      samples.push_back(sample);
+      sample.name = "aria_mutex_wait_usecs_total";
+      sample.help = "Time spent waiting to lock each ArMutex (while profiling)";
+      sample.value = (double)stats.totalWaitUSecs;
+      samples.push_back(sample);
+    }
+  }
+  std::stable_sort(samples.begin(), samples.end(), 
+		   [](const Sample &a, const Sample &b) 
+		   { 
+		     if (a.name != b.name)
+		       return a.name < b.name;
+		     return a.labels < b.labels;
+		   });
+  return samples;
+}
+
+AREXPORT void ArMetrics::reset()
+{
+  ArMetricsRegistry *registry = ArMetricsRegistry::get();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  for (auto &entry : registry->metrics)
+  {
+    ArMetricsRegistry::Metric &metric = entry.second;
+    if (metric.counter)
+      metric.counter->reset();
+    if (metric.gauge)
+      metric.gauge->set(0);
+    if (metric.histogram)
+      metric.histogram->reset();
+  }
+}
+
+static const char *metricTypeName(ArMetrics::Type type)
+{
+  switch (type)
+  {
+  case ArMetrics::COUNTER:
+    return "counter";
+  case ArMetrics::GAUGE:
+    return "gauge";
+  case ArMetrics::HISTOGRAM:
+    return "histogram";
+  }
+  return "untyped";
+}
+
+// Whole numbers (like counts) come out without a decimal point
+static std::string formatMetricValue(double value)
+{
+  if (std::isnan(value))
+    return "NaN";
+  if (std::isinf(value))
+    return (value > 0) ? "+Inf" : "-Inf";
+  char buf[64];
+  if (value == std::floor(value) && std::fabs(value) < 1e15)
+    snprintf(buf, sizeof(buf), "%.0f", value);
+  else
+    snprintf(buf, sizeof(buf), "%.9g", value);
+  return buf;
+}
+
+static std::string escapeMetricHelp(const std::string &help)
+{
+  std::string ret;
+  for (char c : help)
+  {
+    if (c == '\\')
+      ret += "\\\\";
+    else if (c == '\n')
+      ret += "\\n";
+    else
+      ret += c;
+  }
+  return ret;
+}
+
+AREXPORT std::string ArMetrics::toPrometheusText(const std::vector<Sample> &samples)
+{
+  std::string text;
+  const std::string *lastName = NULL;
+  for (const Sample &sample : samples)
+  {
+    if (lastName == NULL || *lastName != sample.name)
+    {
+      if (!sample.help.empty())
+	text += "# HELP " + sample.name + " " + escapeMetricHelp(sample.help) + "\n";
+      text += "# TYPE " + sample.name + " " + metricTypeName(sample.type) + "\n";
+      lastName = &sample.name;
+    }
+    if (sample.type != HISTOGRAM)
+    {
+      text += sample.name;
+      if (!sample.labels.empty())
+	text += "{" + sample.labels + "}";
+      text += " " + formatMetricValue(sample.value) + "\n";
+      continue;
+    }
+    // buckets are cumulative in this format
+    std::string labelPrefix = sample.labels.empty() ? "" : sample.labels + ",";
+    unsigned long long cumulative = 0;
+    for (size_t i = 0; i < sample.bucketCounts.size(); i++)
+    {
+      cumulative += sample.bucketCounts[i];
+      std::string le = (i < sample.bounds.size()) ? 
+	formatMetricValue(sample.bounds[i]) : "+Inf";
+      text += sample.name + "_bucket{" + labelPrefix + "le=\"" + le + "\"} " + 
+	formatMetricValue((double)cumulative) + "\n";
+    }
+    std::string labels = sample.labels.empty() ? "" : "{" + sample.labels + "}";
+    text += sample.name + "_sum" + labels + " " + 
+      formatMetricValue(sample.value) + "\n";
+    text += sample.name + "_count" + labels + " " + 
+      formatMetricValue((double)sample.count) + "\n";
+  }
+  return text;
+}
+
+static std::string jsonMetricString(const std::string &str)
+{
+  std::string ret = "\"";
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      ret += '\\';
+      ret += c;
+    }
+    else if (c == '\n')
+      ret += "\\n";
+    else if ((unsigned char)c < 0x20)
+    {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)(unsigned char)c);
+      ret += buf;
+    }
+    else
+      ret += c;
+  }
+  return ret + "\"";
+}
+
+static std::string jsonMetricNumber(double value)
+{
+  // JSON has no NaN or infinity
+  if (std::isnan(value) || std::isinf(value))
+    return "null";
+  return formatMetricValue(value);
+}
+
+// Turns key="value",key2="value2" into a JSON object
+static std::string jsonMetricLabels(const std::string &labels)
+{
+  std::string ret = "{";
+  size_t i = 0;
+  bool first = true;
+  while (i < labels.size())
+  {
+    size_t eq = labels.find('=', i);
+    if (eq == std::string::npos || eq + 1 >= labels.size() || 
+	labels[eq + 1] != '"')
+      break;
+    std::string key = labels.substr(i, eq - i);
+    std::string value;
+    size_t j = eq + 2;
+    for (; j < labels.size() && labels[j] != '"'; j++)
+    {
+      if (labels[j] == '\\' && j + 1 < labels.size())
+      {
+	j++;
+	value += (labels[j] == 'n') ? '\n' : labels[j];
+      }
+      else
+	value += labels[j];
+    }
+    if (!first)
+      ret += ",";
+    first = false;
+    ret += jsonMetricString(key) + ":" + jsonMetricString(value);
+    // past the closing quote and the comma
+    i = j + 2;
+  }
+  return ret + "}";
+}
+
+AREXPORT std::string ArMetrics::toJSON(const std::vector<Sample> &samples)
+{
+  std::string json = "{\"metrics\":[";
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    const Sample &sample = samples[i];
+    if (i > 0)
+      json += ",";
+    json += "\n{\"name\":" + jsonMetricString(sample.name) + 
+      ",\"type\":\"" + metricTypeName(sample.type) + "\"" + 
+      ",\"labels\":" + jsonMetricLabels(sample.labels);
+    if (!sample.help.empty())
+      json += ",\"help\":" + jsonMetricString(sample.help);
+    if (sample.type != HISTOGRAM)
+    {
+      json += ",\"value\":" + jsonMetricNumber(sample.value) + "}";
+      continue;
+    }
+    json += ",\"count\":" + formatMetricValue((double)sample.count) + 
+      ",\"sum\":" + jsonMetricNumber(sample.value) + ",\"buckets\":[";
+    for (size_t b = 0; b < sample.bucketCounts.size(); b++)
+    {
+      if (b > 0)
+	json += ",";
+      // the overflow bucket has no bound
+      json += "{\"le\":" + ((b < sample.bounds.size()) ? 
+			    jsonMetricNumber(sample.bounds[b]) : "null") + 
+	",\"count\":" + formatMetricValue((double)sample.bucketCounts[b]) + "}";
+    }
+    json += "]}";
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+AREXPORT std::string ArMetrics::makeLabels(const char *key, const std::string &value)
+{
+  std::string ret = key;
+  ret += "=\"";
+  for (char c : value)
+  {
+    if (c == '\\' || c == '"')
+    {
+      ret += '\\';
+      ret += c;
+    }
+    else if (c == '\n')
+      ret += "\\n";
+    else
+      ret += c;
+  }
+  ret += "\"";
+  return ret;
+}
+
+AREXPORT std::string ArMetrics::makeLabels(const char *key1, const std::string &value1,
+					   const char *key2, const std::string &value2)
+{
+  return makeLabels(key1, value1) + "," + makeLabels(key2, value2);
+}
+
+AREXPORT const std::vector<double> &ArMetrics::getDefaultMSecBounds()
+{
+  static const std::vector<double> bounds = 
+    { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+  return bounds;
+}
+
+AREXPORT const std::vector<double> &ArMetrics::getDefaultUSecBounds()
+{
+  static const std::vector<double> bounds = 
+    { 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 
+      100000, 200000, 500000, 1000000 };
+  return bounds;
+}
+
+
+AREXPORT ArMetricsServer::ArMetricsServer()
+{
+  setThreadName("ArMetricsServer");
+  myServerSocket.setDoClose(true);
+}
+
+AREXPORT ArMetricsServer::~ArMetricsServer()
+{
+  if (getRunning())
+  {
+    stopRunning();
+    join();
+  }
+  close();
+}
+
+AREXPORT bool ArMetricsServer::open(int port, const char *openOnIP)
+{
+  close();
+  if (!myServerSocket.open(port, ArSocket::TCP, openOnIP))
+  {
+    ArLog::log(ArLog::Normal, 
+	       "ArMetricsServer: Could not open port %d: %s", port,
+	       myServerSocket.getErrorStr().c_str());
+    return false;
+  }
+  // so the thread can notice when it is told to stop
+  myServerSocket.setNonBlock();
+  ArLog::log(ArLog::Normal, "ArMetricsServer: Serving metrics on port %d", 
+	     port);
+  return true;
+}
+
+AREXPORT void ArMetricsServer::close()
+{
+  if (isOpen())
+    myServerSocket.close();
+}
+
+AREXPORT void *ArMetricsServer::runThread(void *)
+{
+  threadStarted();
+  while (getRunning())
+  {
+    if (!isOpen())
+    {
+      ArUtil::sleep(100);
+      continue;
+    }
+    ArSocket client;
+    if (!myServerSocket.accept(&client) || client.getFD() < 0)
+    {
+      ArUtil::sleep(50);
+      continue;
+    }
+    client.setDoClose(true);
+    handleClient(&client);
+    client.close();
+  }
+  threadFinished();
+  return NULL;
+}
+
+void ArMetricsServer::handleClient(ArSocket *client)
+{
+  // read until the end of the request headers (the body, if any, is ignored)
+  std::string request;
+  char buf[1024];
+  ArTime started;
+  while (request.find("\r\n\r\n") == std::string::npos && 
+	 request.find("\n\n") == std::string::npos &&
+	 request.size() < 8192 && started.mSecSince() < 2000)
+  {
+    ArTime readStarted;
+    int ret = client->read(buf, sizeof(buf), 100);
+    // read() returns 0 right away if the client closed the connection,
+    // and after the wait if there was just nothing to read yet
+    if (ret < 0 || (ret == 0 && readStarted.mSecSince() < 50))
+      break;
+    if (ret > 0)
+      request.append(buf, (size_t)ret);
+  }
+
+  // the first line is METHOD PATH VERSION
+  std::string line = request.substr(0, request.find_first_of("\r\n"));
+  std::string method = line.substr(0, line.find(' '));
+  std::string path;
+  size_t pathStart = line.find(' ');
+  if (pathStart != std::string::npos)
+  {
+    path = line.substr(pathStart + 1);
+    path = path.substr(0, path.find(' '));
+    path = path.substr(0, path.find('?'));
+  }
+
+  std::string status = "200 OK";
+  std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+  std::string body;
+  if (method != "GET" && method != "HEAD")
+  {
+    status = "405 Method Not Allowed";
+    contentType = "text/plain";
+    body = "Only GET is supported\n";
+  }
+  else if (path == "/metrics" || path == "/")
+    body = ArMetrics::getPrometheusText();
+  else if (path == "/metrics.json")
+  {
+    contentType = "application/json";
+    body = ArMetrics::getJSON();
+  }
+  else
+  {
+    status = "404 Not Found";
+    contentType = "text/plain";
+    body = "Try /metrics or /metrics.json\n";
+  }
+
+  std::string response = "HTTP/1.0 " + status + "\r\n" + 
+    "Content-Type: " + contentType + "\r\n" + 
+    "Content-Length: " + std::to_string(body.size()) + "\r\n" + 
+    "Connection: close\r\n\r\n";
+  if (method != "HEAD")
+    response += body;
+  size_t written = 0;
+  while (written < response.size())
+  {
+    int ret = client->write(response.data() + written, 
+			    response.size() - written);
+    if (ret <= 0)
+      break;
+    written += (size_t)ret;
+  }
+  myNumRequests++;
+}
@@ -29,11 +29,233 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArThread.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
 
 
 unsigned int ArMutex::ourLockWarningMS = 0;
 unsigned int ArMutex::ourUnlockWarningMS = 0;
 ArFunctor *ArMutex::ourNonRecursiveDeadlockFunctor = NULL;
+std::atomic<bool> ArMutex::ourProfiling{false};
+
+struct ArMutex::ProfileEntry
+{
+  std::string name;
+  std::atomic<unsigned long long> locks{0};
+  std::atomic<unsigned long long> contendedLocks{0};
+  std::atomic<unsigned long long> totalWaitUSecs{0};
+  std::atomic<unsigned long long> maxWaitUSecs{0};
+  std::atomic<unsigned long long> totalHoldUSecs{0};
+  std::atomic<unsigned long long> maxHoldUSecs{0};
+  std::mutex maxHoldThreadMutex;
+  std::string maxHoldThread;
+};
+
+// The profiler's own bookkeeping uses std::mutex rather than ArMutex so
+// it doesn't profile itself.  These are never deleted, so they're still
+// around for mutexes that are locked while the program exits.
+static std::mutex &profileRegistryMutex()
+{
+  static std::mutex *mutex = new std::mutex;
+  return *mutex;
+}
+
+static std::map<std::string, ArMutex::ProfileEntry *> &profileRegistry()
+{
+  static std::map<std::string, ArMutex::ProfileEntry *> *registry = 
+    new std::map<std::string, ArMutex::ProfileEntry *>;
+  return *registry;
+}
+
+// set while the profiler is doing something that might lock other
+// mutexes (like looking up the thread name), so those aren't profiled
+static thread_local bool ourInProfiler = false;
+
+static bool updateMax(std::atomic<unsigned long long> &max, 
+		      unsigned long long val)
+{
+  unsigned long long cur = max.load(std::memory_order_relaxed);
+  while (val > cur)
+  {
+    if (max.compare_exchange_weak(cur, val, std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+AREXPORT bool ArMutex::profileThisLock()
+{
+  return ourProfiling.load(std::memory_order_relaxed) && !ourInProfiler;
+}
+
+AREXPORT long long ArMutex::profileNow()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+	  std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AREXPORT ArMutex::ProfileEntry *ArMutex::getProfileEntry(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(profileRegistryMutex());
+  ProfileEntry *&entry = profileRegistry()[name];
+  if (entry == NULL)
+  {
+    entry = new ProfileEntry;
+    entry->name = name;
+  }
+  return entry;
+}
+
+AREXPORT void ArMutex::profileAddLock(ProfileEntry *entry, bool contended, 
+				      long long waitUSecs)
+{
+  entry->locks.fetch_add(1, std::memory_order_relaxed);
+  if (contended)
+  {
+    const unsigned long long wait = (unsigned long long)waitUSecs;
+    entry->contendedLocks.fetch_add(1, std::memory_order_relaxed);
+    entry->totalWaitUSecs.fetch_add(wait, std::memory_order_relaxed);
+    updateMax(entry->maxWaitUSecs, wait);
+  }
+}
+
+AREXPORT void ArMutex::profileAddHold(ProfileEntry *entry, long long holdUSecs)
+{
+  if (holdUSecs < 0 || entry == NULL)
+    return;
+  const unsigned long long hold = (unsigned long long)holdUSecs;
+  entry->totalHoldUSecs.fetch_add(hold, std::memory_order_relaxed);
+  if (updateMax(entry->maxHoldUSecs, hold))
+  {
+    ourInProfiler = true;
+    std::string thread = ArThread::getThisThreadName();
+    ourInProfiler = false;
+    std::lock_guard<std::mutex> lock(entry->maxHoldThreadMutex);
+    entry->maxHoldThread = thread;
+  }
+}
+
+void ArMutex::profileLocked(bool contended, long long waitUSecs)
+{
+  if (myProfile == NULL)
+    myProfile = getProfileEntry(myLogName);
+  if (myProfileDepth++ == 0)
+    myProfileLockedUSecs = profileNow();
+  profileAddLock(myProfile, contended, waitUSecs);
+}
+
+long long ArMutex::profileUnlocking()
+{
+  if (myProfileDepth <= 0 || --myProfileDepth > 0)
+    return -1;
+  return profileNow() - myProfileLockedUSecs;
+}
+
+void ArMutex::profileUnlocked(long long holdUSecs)
+{
+  profileAddHold(myProfile, holdUSecs);
+}
+
+static void logProfileAtExit()
+{
+  ArMutex::logProfile();
+}
+
+AREXPORT void ArMutex::setProfiling(bool profiling, bool logAtExit)
+{
+  static std::once_flag atExitOnce;
+  if (logAtExit)
+    std::call_once(atExitOnce, []() { atexit(logProfileAtExit); });
+  ourProfiling.store(profiling, std::memory_order_relaxed);
+}
+
+AREXPORT std::vector<ArMutex::ProfileStats> ArMutex::getProfileStats()
+{
+  std::vector<ProfileStats> ret;
+  std::lock_guard<std::mutex> lock(profileRegistryMutex());
+  for (auto it = profileRegistry().begin(); it != profileRegistry().end(); ++it)
+  {
+    ProfileEntry *entry = it->second;
+    ProfileStats stats;
+    stats.name = entry->name;
+    stats.locks = entry->locks.load(std::memory_order_relaxed);
+    stats.contendedLocks = entry->contendedLocks.load(std::memory_order_relaxed);
+    stats.totalWaitUSecs = entry->totalWaitUSecs.load(std::memory_order_relaxed);
+    stats.maxWaitUSecs = entry->maxWaitUSecs.load(std::memory_order_relaxed);
+    stats.totalHoldUSecs = entry->totalHoldUSecs.load(std::memory_order_relaxed);
+    stats.maxHoldUSecs = entry->maxHoldUSecs.load(std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> threadLock(entry->maxHoldThreadMutex);
+      stats.maxHoldThread = entry->maxHoldThread;
+    }
+    ret.push_back(stats);
+  }
+  std::stable_sort(ret.begin(), ret.end(), 
+		   [](const ProfileStats &a, const ProfileStats &b) {
+		     if (a.totalWaitUSecs != b.totalWaitUSecs)
+		       return a.totalWaitUSecs > b.totalWaitUSecs;
+		     return a.totalHoldUSecs > b.totalHoldUSecs; });
+  return ret;
+}
+
+AREXPORT std::string ArMutex::getProfileReport()
+{
+  std::vector<ProfileStats> stats = getProfileStats();
+  std::string ret;
+  char line[1024];
+  snprintf(line, sizeof(line), 
+	   "%-40s %10s %10s %6s %11s %10s %11s %10s  %s\n",
+	   "Mutex", "Locks", "Contended", "%", "WaitMS", "MaxWaitMS",
+	   "HoldMS", "MaxHoldMS", "MaxHoldThread");
+  ret += line;
+  for (auto it = stats.begin(); it != stats.end(); ++it)
+  {
+    snprintf(line, sizeof(line),
+	     "%-40s %10llu %10llu %6.2f %11.3f %10.3f %11.3f %10.3f  %s\n",
+	     it->name.c_str(), it->locks, it->contendedLocks,
+	     it->locks > 0 ? 
+	     100.0 * (double)it->contendedLocks / (double)it->locks : 0.0,
+	     (double)it->totalWaitUSecs / 1000.0, 
+	     (double)it->maxWaitUSecs / 1000.0,
+	     (double)it->totalHoldUSecs / 1000.0, 
+	     (double)it->maxHoldUSecs / 1000.0,
+	     it->maxHoldThread.c_str());
+    ret += line;
+  }
+  return ret;
+}
+
+AREXPORT void ArMutex::logProfile()
+{
+  std::string report = getProfileReport();
+  ArLog::log(ArLog::Normal, "ArMutex contention profile:");
+  size_t start = 0, end;
+  while ((end = report.find('\n', start)) != std::string::npos)
+  {
+    ArLog::log(ArLog::Normal, "%s", report.substr(start, end - start).c_str());
+    start = end + 1;
+  }
+}
+
+AREXPORT void ArMutex::resetProfile()
+{
+  std::lock_guard<std::mutex> lock(profileRegistryMutex());
+  for (auto it = profileRegistry().begin(); it != profileRegistry().end(); ++it)
+  {
+    ProfileEntry *entry = it->second;
+    entry->locks = 0;
+    entry->contendedLocks = 0;
+    entry->totalWaitUSecs = 0;
+    entry->maxWaitUSecs = 0;
+    entry->totalHoldUSecs = 0;
+    entry->maxHoldUSecs = 0;
+    std::lock_guard<std::mutex> threadLock(entry->maxHoldThreadMutex);
+    entry->maxHoldThread.clear();
+  }
+}
 
 
 AREXPORT void ArMutex::setLogNameVar(const char *logName, ...)
@@ -155,7 +155,19 @@ int ArMutex::lock()
   }
 
   int ret;
-  if ((ret = pthread_mutex_lock(&myMutex)) != 0)
+  // when profiling, see if we'd have to wait first
+  const bool profiling = profileThisLock();
+  bool contended = false;
+  long long waitStart = 0;
+  if (profiling && (ret = pthread_mutex_trylock(&myMutex)) == EBUSY)
+  {
+    contended = true;
+    waitStart = profileNow();
+    ret = pthread_mutex_lock(&myMutex);
+  }
+  else if (!profiling)
+    ret = pthread_mutex_lock(&myMutex);
+  if (ret != 0)
   {
     if (ret == EDEADLK)
     {
@@ -205,6 +217,8 @@ int ArMutex::lock()
     myWasAlreadyLocked = true;
   }
 
+  if (profiling)
+    profileLocked(contended, contended ? profileNow() - waitStart : 0);
   if(ourLockWarningMS > 0) checkLockTime();
   if(ourUnlockWarningMS > 0) startUnlockTimer();
 
@@ -284,6 +298,8 @@ int ArMutex::tryLock()
     myWasAlreadyLocked = true;
   }
 
+  if (profileThisLock())
+    profileLocked(false, 0);
   if (myLog)
     ArLog::logNoLock(ArLog::Terse, 
 		     "Try locked '%s' from thread '%s' %d pid %d", 
@@ -314,6 +330,7 @@ int ArMutex::unlock()
   }
 
   int ret;
+  const long long holdUSecs = profileUnlocking();
   if ((ret = pthread_mutex_unlock(&myMutex)) != 0)
   {
     if (ret == EPERM)
@@ -333,6 +350,7 @@ int ArMutex::unlock()
   }
   if (myNonRecursive)
     myWasAlreadyLocked = false;
+  profileUnlocked(holdUSecs);
   return(0);
 }
 
@@ -113,7 +113,18 @@ int ArMutex::lock()
   }
 
   if(ourLockWarningMS > 0) startLockTimer();
-  ret=WaitForSingleObject(myMutex, INFINITE);
+  // when profiling, see if we'd have to wait first
+  const bool profiling = profileThisLock();
+  bool contended = false;
+  long long waitStart = 0;
+  if (profiling && (ret = WaitForSingleObject(myMutex, 0)) == WAIT_TIMEOUT)
+  {
+    contended = true;
+    waitStart = profileNow();
+    ret = WaitForSingleObject(myMutex, INFINITE);
+  }
+  else if (!profiling)
+    ret = WaitForSingleObject(myMutex, INFINITE);
   if (ret == WAIT_ABANDONED)
   {
     ArLog::logNoLock(ArLog::Terse, "ArMutex::lock: Tried to lock a mutex %s which was locked by a different thread and never unlocked before that thread exited. This is a recoverable error", myLogName.c_str());
@@ -122,6 +133,8 @@ int ArMutex::lock()
   else if (ret == WAIT_OBJECT_0)
   {
     // locked
+    if (profiling)
+      profileLocked(contended, contended ? profileNow() - waitStart : 0);
 	if(ourLockWarningMS > 0) checkLockTime();
 	if(ourUnlockWarningMS > 0) startUnlockTimer();
     return(0);
@@ -191,7 +204,11 @@ int ArMutex::tryLock()
     return(STATUS_ALREADY_LOCKED);
   }
   else if (ret == WAIT_OBJECT_0)
+  {
+    if (profileThisLock())
+      profileLocked(false, 0);
     return(0);
+  }
   else
   {
     ArLog::logNoLock(ArLog::Terse, "ArMutex::lock: Failed to lock %s due to an unknown error", myLogName.c_str());
@@ -244,6 +261,7 @@ int ArMutex::unlock()
 
   if(ourUnlockWarningMS > 0) checkUnlockTime();
 
+  const long long holdUSecs = profileUnlocking();
   if (!ReleaseMutex(myMutex))
   {
     ArLog::logNoLock(ArLog::Terse, "ArMutex::unlock: Failed to unlock %s due to an unknown error", myLogName.c_str());
@@ -251,6 +269,7 @@ int ArMutex::unlock()
   }
   if (myNonRecursive)
     myWasAlreadyLocked = false;
+  profileUnlocked(holdUSecs);
   return(0);
 }
 
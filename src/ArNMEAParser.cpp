@@ -54,62 +54,130 @@ AREXPORT ArNMEAParser::ArNMEAParser(const char *name) :
   MaxNumFields(50),
   MaxFieldSize(128),
   ignoreChecksum(false),
-  checksumBufOffset(0),
-  inChecksum(false),
-  inMessage(false),
-  currentChecksum(0),
-  gotCR(false)
+  myPartialSize(0)
 {
-  memset(checksumBuf, 0, 3);
+  // big enough for the largest message we would accept
+  myPartial.resize((size_t)MaxNumFields * (MaxFieldSize + 1u) + 8u);
+  myFields.resize((size_t)MaxNumFields + 1u);
+  rebuildHandlerTable();
+}
+
+AREXPORT double ArNMEAParser::Field::toDouble() const
+{
+  char buf[64];
+  if (size == 0 || size >= sizeof(buf))
+    return 0;
+  memcpy(buf, data, size);
+  buf[size] = '\0';
+  return atof(buf);
+}
+
+AREXPORT int ArNMEAParser::Field::toInt() const
+{
+  char buf[32];
+  if (size == 0 || size >= sizeof(buf))
+    return 0;
+  memcpy(buf, data, size);
+  buf[size] = '\0';
+  return atoi(buf);
 }
 
 AREXPORT void ArNMEAParser::addHandler(const char *message, ArNMEAParser::Handler *handler)
 {
   myHandlers[message] = handler;
+  rebuildHandlerTable();
 }
 
 AREXPORT void ArNMEAParser::removeHandler(const char *message)
 {
   HandlerMap::iterator i = myHandlers.find(message);
   if(i != myHandlers.end()) myHandlers.erase(i);
+  rebuildHandlerTable();
 }
 
+AREXPORT void ArNMEAParser::addViewHandler(const char *message, ArNMEAParser::ViewHandler *handler)
+{
+  myViewHandlers[message] = handler;
+  rebuildHandlerTable();
+}
 
-void ArNMEAParser::nextField()
+AREXPORT void ArNMEAParser::removeViewHandler(const char *message)
 {
-  currentMessage.push_back(currentField);
-  currentField.clear();
-  if (currentMessage.size() > MaxNumFields)
-    endMessage();
+  ViewHandlerMap::iterator i = myViewHandlers.find(message);
+  if(i != myViewHandlers.end()) myViewHandlers.erase(i);
+  rebuildHandlerTable();
 }
 
-void ArNMEAParser::endMessage()
+// FNV-1a
+size_t ArNMEAParser::hashID(const char *id, size_t len)
 {
-  inMessage = false;
-  inChecksum = false;
-  currentField.clear();
-  gotCR = false;
-  currentMessage.clear();
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i)
+  {
+    h ^= (unsigned char)id[i];
+    h *= 16777619u;
+  }
+  return h;
 }
 
-void ArNMEAParser::beginChecksum()
+void ArNMEAParser::rebuildHandlerTable()
 {
-  checksumBufOffset = 0;
-  inChecksum = true;
+  // keep the last prefixes seen so we can still warn about changes
+  std::map<std::string, std::string> lastPrefixes;
+  for (std::vector<HandlerSlot>::const_iterator i = myHandlerTable.begin(); i != myHandlerTable.end(); ++i)
+    if (!i->id.empty() && i->lastPrefix[0] != '\0')
+      lastPrefixes[i->id] = std::string(i->lastPrefix, 2);
+
+  size_t size = 16;
+  while (size < 2 * (myHandlers.size() + myViewHandlers.size()))
+    size *= 2;
+  myHandlerTable.clear();
+  myHandlerTable.resize(size);
+
+  for (HandlerMap::const_iterator i = myHandlers.begin(); i != myHandlers.end(); ++i)
+  {
+    HandlerSlot *slot = findHandlerSlot(i->first.c_str(), i->first.size());
+    slot->id = i->first;
+    slot->handler = i->second;
+  }
+  for (ViewHandlerMap::const_iterator i = myViewHandlers.begin(); i != myViewHandlers.end(); ++i)
+  {
+    HandlerSlot *slot = findHandlerSlot(i->first.c_str(), i->first.size());
+    slot->id = i->first;
+    slot->viewHandler = i->second;
+  }
+  for (std::map<std::string, std::string>::const_iterator i = lastPrefixes.begin(); i != lastPrefixes.end(); ++i)
+  {
+    HandlerSlot *slot = findHandlerSlot(i->first.c_str(), i->first.size());
+    if (!slot->id.empty())
+      memcpy(slot->lastPrefix, i->second.data(), 2);
+  }
 }
 
-void ArNMEAParser::beginMessage()
+/* @return The slot with the given ID, or the empty slot where it would go. 
+   (There's always at least one empty slot since the table is at least twice
+   as large as the number of IDs.) */
+ArNMEAParser::HandlerSlot *ArNMEAParser::findHandlerSlot(const char *id, size_t len)
 {
-  currentMessageStarted.setToNow();
-  currentMessage.clear();
-  inChecksum = false;
-  inMessage = true;
-  currentField.clear();
-  gotCR = false;
-  currentChecksum = 0;
-  memset(checksumBuf, 0, sizeof(checksumBuf));
+  const size_t mask = myHandlerTable.size() - 1;
+  size_t i = hashID(id, len) & mask;
+  while (true)
+  {
+    HandlerSlot& slot = myHandlerTable[i];
+    if (slot.id.empty() || 
+        (slot.id.size() == len && memcmp(slot.id.data(), id, len) == 0))
+      return &slot;
+    i = (i + 1) & mask;
+  }
 }
 
+static int ArNMEAParser_hexValue(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
 
 AREXPORT int ArNMEAParser::parse(ArDeviceConnection *dev) 
 {
@@ -126,10 +194,6 @@ AREXPORT int ArNMEAParser::parse(ArDeviceConnection *dev)
 AREXPORT int ArNMEAParser::parse(const char *buf, size_t n)
 {
   int result = 0;
-/*   if (n < 0) 
-  {
-    return ParseError;
-  } */
 
   if (n == 0) 
   {
@@ -143,163 +207,204 @@ AREXPORT int ArNMEAParser::parse(const char *buf, size_t n)
   std::cerr << "\"]\n";
 #endif
 
+  ArTime now;
+  const char *p = buf;
+  const char *end = buf + n;
 
-  for (size_t i = 0; i < n; i++)
+  // First finish any message left over from the last call.  A '$' before the
+  // end of it means it was broken off, so just drop it and start over there.
+  if (myPartialSize > 0)
   {
-    // Check for message start
-    if (buf[i] == '$')
+    const char *nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+    const char *restart = (const char*)memchr(p, '$', (size_t)((nl != NULL ? nl : end) - p));
+    if (restart != NULL)
     {
-      beginMessage();
-      continue;
+      myStats.dropped++;
+      myPartialSize = 0;
+      p = restart;
     }
-
-    // Otherwise, we must be in a sentece to do anything
-    if (!inMessage)
-      continue;
-
-    // Reached the CR at the end?
-    if (buf[i] == '\r') 
+    else 
     {
-      gotCR = true;
-      continue;
-    }
-  
-    // Reached the Newline at the end?
-    if (buf[i] == '\n') 
-    {
-      if (gotCR) 
+      const size_t len = (size_t)((nl != NULL ? nl + 1 : end) - p);
+      if (myPartialSize + len > myPartial.size())
       {
-        // Got both CR and LF?-- then end of message
-
-        if(!inChecksum)
-        {
-          // checksum should have preceded.
-          ArLog::log(ArLog::Terse, "ArNMEAParser: Missing checksum.");
-          result |= ParseError;
-          endMessage();
-          continue;
-        }
-
-        // got CRLF but there was no data. Ignore.
-        if(currentMessage.size() == 0)
-        {
-          endMessage();
-          continue;
-        }
-        
-
-        // ok:
-        Message msg{ /*.message =*/ &currentMessage, /*.timeParseStarted =*/ currentMessageStarted, /*.id =*/ currentMessage[0].substr(2), /*.prefix =*/ currentMessage[0].substr(0, 2)};
-        // TODO should we check for an accepted set of prefixes? (e.g. GP, GN,
-        // GL, GB, BD, HC, PG, etc.)
-#ifdef DEBUG_ARNMEAPARSER
-        fprintf(stderr, "\t[ArNMEAPArser: Input message has system prefix %s with message ID %s]\n", msg.prefix.c_str(), msg.id.c_str());
-#endif
-        const std::string& lastprefix = myLastPrefix[msg.id];
-        if(lastprefix != "" && lastprefix != msg.prefix)
-        {
-          const char *id = msg.id.c_str();
-          const char *p = msg.prefix.c_str();
-          const char *lp = lastprefix.c_str();
-          ArLog::log(ArLog::Normal, "ArNMEAParser: Warning: Got duplicate %s message with prefix %s (previous prefix was %s).  Data from %s%s will replace %s%s.", id, p, lp, p, id, lp, id);
-        }
-        HandlerMap::iterator h = myHandlers.find(msg.id);
-        if (h != myHandlers.end()) 
-        {
-#ifdef DEBUG_ARNMEAPARSER
-          fprintf(stderr, "\t[ArNMEAParser: Got complete message, calling handler for %s...]\n", msg.id.c_str());
-#endif
-          if(h->second)
-          {
-            h->second->invoke(std::move(msg));
-            result |= ParseUpdated;
-          }
-          else
-          {
-            ArLog::log(ArLog::Terse, "ArNMEAParser Internal Error: NULL handler functor for message %s!\n", msg.id.c_str());
-          }
-        }
-#ifdef DEBUG_ARNMEAPARSER
-        else
-        {
-          fprintf(stderr, "\t[ArNMEAParser: Have no message handler for %s (%s).]\n", msg.id.c_str(), currentMessage[0].c_str());
-        }
-#endif
+        // too long to be a message we'd accept
+        myStats.dropped++;
+        myPartialSize = 0;
       }
       else
       {
-        ArLog::log(ArLog::Normal, "ArNMEAParser: syntax error, \\n without \\r.");
-        result |= ParseError;
+        memcpy(&myPartial[myPartialSize], p, len);
+        myPartialSize += len;
       }
+      if (nl == NULL)
+        return result;
+      if (myPartialSize > 0)
+        result |= parseMessage(&myPartial[0], myPartialSize, myPartialStarted);
+      myPartialSize = 0;
+      p = nl + 1;
+    }
+  }
 
-      endMessage();
+  // Then the complete messages in place
+  while (p < end)
+  {
+    const char *start = (const char*)memchr(p, '$', (size_t)(end - p));
+    if (start == NULL)
+      break;
+    const char *nl = (const char*)memchr(start + 1, '\n', (size_t)(end - start - 1));
+    const char *restart = (const char*)memchr(start + 1, '$', (size_t)((nl != NULL ? nl : end) - start - 1));
+    if (restart != NULL)
+    {
+      myStats.dropped++;
+      p = restart;
       continue;
     }
-
-    // Are we in the final checksum field?
-    if (inChecksum)
+    if (nl == NULL)
     {
-      checksumBuf[checksumBufOffset++] = buf[i];
-      if (checksumBufOffset > 1)   // two bytes of checksum
+      // keep the beginning of the message for next time
+      const size_t len = (size_t)(end - start);
+      if (len <= myPartial.size())
       {
-        int checksumRec = (int) strtol(checksumBuf, NULL, 16);
-        if (checksumRec != currentChecksum) 
-        {
-          ArLog::log(ArLog::Normal, "%s: Warning: Skipping message with incorrect checksum.", myName);
-
-          // reconstruct message to log:
-          std::string nmeaText = "";
-          for(MessageVector::const_iterator it = currentMessage.begin(); it != currentMessage.end(); ++it)
-          {
-            if(it != currentMessage.begin()) nmeaText += ",";
-            nmeaText += *it;
-          }
-          ArLog::log(ArLog::Normal, "%s: Message provided checksum \"%s\" = 0x%x (%d). Calculated checksum is 0x%x (%d).  NMEA message contents were: \"%s\"", myName, checksumBuf, checksumRec, checksumRec, currentChecksum, currentChecksum, nmeaText.c_str());
-
-          // abort the message and start looking for the next one.
-          result |= ParseError;
-          endMessage();
-        }
+        memcpy(&myPartial[0], start, len);
+        myPartialSize = len;
+        myPartialStarted = now;
       }
-      continue;
+      else
+        myStats.dropped++;
+      break;
     }
+    result |= parseMessage(start, (size_t)(nl - start + 1), now);
+    p = nl + 1;
+  }
 
+  return result;
+}
 
-    // Got to the checksum?
-    if (buf[i] == '*')
-    {
-      nextField();
-      if (!ignoreChecksum)
-        beginChecksum();
-      continue;
-    }
-
-    // Every byte in a message between $ and * XORs to form the
-    // checksum:
-    currentChecksum ^= buf[i];
+/* @param text Message text, beginning with '$' and ending with '\n' */
+int ArNMEAParser::parseMessage(const char *text, size_t len, const ArTime& started)
+{
+  myStats.sentences++;
+  if (len < 2 || text[len - 2] != '\r')
+  {
+    myStats.dropped++;
+    ArLog::log(ArLog::Normal, "ArNMEAParser: syntax error, \\n without \\r.");
+    return ParseError;
+  }
 
-    // Time to start a new field?
-    if (buf[i] == ',')
+  // Split into fields and compute the checksum, up to the '*' or CR. 
+  // Every byte in a message between $ and * XORs to form the checksum.
+  const char *p = text + 1;
+  const char *end = text + len - 2;
+  const char *fieldStart = p;
+  size_t numFields = 0;
+  unsigned char checksum = 0;
+  for (; p < end && *p != '*'; ++p)
+  {
+    checksum ^= (unsigned char)*p;
+    if (*p == ',')
     {
-      nextField();
-      continue;
+      if ((size_t)(p - fieldStart) > MaxFieldSize || numFields >= MaxNumFields)
+      {
+        myStats.dropped++;
+        return 0;
+      }
+      myFields[numFields].data = fieldStart;
+      myFields[numFields].size = (size_t)(p - fieldStart);
+      ++numFields;
+      fieldStart = p + 1;
     }
+  }
+  const bool haveChecksum = (p < end);
+  if (!haveChecksum && !ignoreChecksum)
+  {
+    // checksum should have preceded.
+    myStats.dropped++;
+    ArLog::log(ArLog::Terse, "ArNMEAParser: Missing checksum.");
+    return ParseError;
+  }
+  if ((size_t)(p - fieldStart) > MaxFieldSize || numFields >= MaxNumFields)
+  {
+    myStats.dropped++;
+    return 0;
+  }
+  myFields[numFields].data = fieldStart;
+  myFields[numFields].size = (size_t)(p - fieldStart);
+  ++numFields;
 
-
-    // Else, we must be in the middle of a field
-    // TODO we could use strchr to look ahead in the buf 
-    // for the end of the field (',' or '*') or end of the buf, and copy more
-    // than one byte at a time.
-    currentField += buf[i];
-    if (currentField.size() > MaxFieldSize)
+  if (haveChecksum && !ignoreChecksum)
+  {
+    const int hi = (end - p > 2) ? ArNMEAParser_hexValue(p[1]) : -1;
+    const int lo = (end - p > 2) ? ArNMEAParser_hexValue(p[2]) : -1;
+    const int checksumRec = (hi < 0 || lo < 0) ? -1 : (hi << 4 | lo);
+    if (checksumRec != checksum) 
     {
-      endMessage();
-      continue;
+      myStats.dropped++;
+      ArLog::log(ArLog::Normal, "%s: Warning: Skipping message with incorrect checksum.", myName);
+      ArLog::log(ArLog::Normal, "%s: Message provided checksum \"%.*s\" = 0x%x (%d). Calculated checksum is 0x%x (%d).  NMEA message contents were: \"%.*s\"", myName, (int)(end - p - 1), p + 1, checksumRec, checksumRec, checksum, checksum, (int)(p - text - 1), text + 1);
+      return ParseError;
     }
   }
 
-  return result;
-}
+  // First field is the talker prefix and message ID
+  const Field& first = myFields[0];
+  if (first.size < 3)
+  {
+    myStats.dropped++;
+    return 0;
+  }
+  HandlerSlot *slot = findHandlerSlot(first.data + 2, first.size - 2);
+  if (slot->id.empty())
+  {
+#ifdef DEBUG_ARNMEAPARSER
+    fprintf(stderr, "\t[ArNMEAParser: Have no message handler for %.*s.]\n", (int)first.size, first.data);
+#endif
+    return 0;
+  }
 
+  // TODO should we check for an accepted set of prefixes? (e.g. GP, GN,
+  // GL, GB, BD, HC, PG, etc.)
+  if(slot->lastPrefix[0] != '\0' && memcmp(slot->lastPrefix, first.data, 2) != 0)
+  {
+    const char *id = slot->id.c_str();
+    ArLog::log(ArLog::Normal, "ArNMEAParser: Warning: Got duplicate %s message with prefix %.2s (previous prefix was %.2s).  Data from %.2s%s will replace %.2s%s.", id, first.data, slot->lastPrefix, first.data, id, slot->lastPrefix, id);
+  }
+  memcpy(slot->lastPrefix, first.data, 2);
 
+  // a handler may add or remove handlers, which rebuilds the table that
+  // slot points into, so don't use slot once one has been called
+  ArNMEAParser::ViewHandler *viewHandler = slot->viewHandler;
+  ArNMEAParser::Handler *handler = slot->handler;
+  const std::string id = slot->id;
+  slot = NULL;
 
+  int result = 0;
+  myStats.handled++;
+  if (viewHandler != NULL)
+  {
+    ViewMessage vmsg;
+    vmsg.fields = &myFields[0];
+    vmsg.numFields = numFields;
+    vmsg.timeParseStarted = started;
+    vmsg.id.data = first.data + 2;
+    vmsg.id.size = first.size - 2;
+    vmsg.prefix.data = first.data;
+    vmsg.prefix.size = 2;
+    viewHandler->invoke(&vmsg);
+    result |= ParseUpdated;
+  }
+  if (handler != NULL)
+  {
+    // assign() into the existing strings so their storage is reused
+    currentMessage.resize(numFields);
+    for (size_t i = 0; i < numFields; ++i)
+      currentMessage[i].assign(myFields[i].data, myFields[i].size);
+    Message msg{ /*.message =*/ &currentMessage, /*.timeParseStarted =*/ started, /*.id =*/ id, /*.prefix =*/ std::string(first.data, 2)};
+#ifdef DEBUG_ARNMEAPARSER
+    fprintf(stderr, "\t[ArNMEAParser: Got complete message, calling handler for %s...]\n", msg.id.c_str());
+#endif
+    handler->invoke(std::move(msg));
+    result |= ParseUpdated;
+  }
+  return result;
+}
@@ -27,6 +27,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArNovatelGPS.h"
 #include "Aria/ArDeviceConnection.h"
 
+#include <set>
+
 
 AREXPORT ArNovatelGPS::ArNovatelGPS() :
   ArGPS(),
@@ -49,16 +51,22 @@ AREXPORT bool ArNovatelGPS::initDevice()
     return false;
 
   // Send a command to start sending data for each message type in the ArGPS
-  // handlers map:
+  // handlers map (and view handlers map):
+  std::set<std::string> messages;
   const ArNMEAParser::HandlerMap& handlers = myNMEAParser.getHandlersRef();
   for(ArNMEAParser::HandlerMap::const_iterator i = handlers.begin(); i != handlers.end(); ++i)
+    messages.insert((*i).first);
+  const ArNMEAParser::ViewHandlerMap& viewHandlers = myNMEAParser.getViewHandlersRef();
+  for(ArNMEAParser::ViewHandlerMap::const_iterator i = viewHandlers.begin(); i != viewHandlers.end(); ++i)
+    messages.insert((*i).first);
+  for(std::set<std::string>::const_iterator i = messages.begin(); i != messages.end(); ++i)
   {
     float interval = 1;
-    if( (*i).first == "RMC") interval = 0.25;  //special case, make this come faster
-    ArLog::log(ArLog::Verbose, "ArNovatelGPS: Requesting GP%s at %g sec interval", (*i).first.c_str(), interval);
+    if( (*i) == "RMC") interval = 0.25;  //special case, make this come faster
+    ArLog::log(ArLog::Verbose, "ArNovatelGPS: Requesting GP%s at %g sec interval", (*i).c_str(), interval);
     char cmd[40];
     memset(cmd, 0, 40);
-    snprintf(cmd, 40, "log thisport GP%s ontime %g\r\n", (*i).first.c_str(), interval);
+    snprintf(cmd, 40, "log thisport GP%s ontime %g\r\n", (*i).c_str(), interval);
         // XXX TODO don't just insert "GP" prefix here, store the expected
         // prefix, or, the expected prefixes for different GPS receiver types,
         // in the message/handler list?
@@ -28,6 +28,545 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArRobotPacket.h"
 #include "Aria/ArCommands.h"
 #include "Aria/ArDeviceConnection.h"
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArLog.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Internal, the queue behind ArPTZ::enableCommandPipeline()
+/**
+   Commands wait in myQueue until drain() (run on the thread pool)
+   writes them.  If the driver tracks responses, written commands that
+   want an answer move to myInFlight until commandCompleted() or their
+   timeout.  Any pool task that hasn't finished is kept in myTasks so
+   that the destructor can cancel (or wait for) it.
+**/
+class ArPTZ::CommandPipeline
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+  typedef std::vector<std::pair<CommandId, CommandStatus> > Completions;
+
+  struct Command
+  {
+    CommandId id = 0;
+    CommandKind kind = COMMAND_OTHER;
+    bool expectResponse = true;
+    std::string data;
+    int responseKey = -1;
+    Clock::time_point sent;
+  };
+
+  CommandPipeline(ArPTZ *ptz, size_t maxQueued, unsigned int maxInFlight,
+		  unsigned int responseTimeoutMSecs, ArThreadPool *pool) :
+    myPTZ(ptz),
+    myMaxQueued(maxQueued),
+    myMaxInFlight(maxInFlight),
+    myResponseTimeout(std::chrono::milliseconds(responseTimeoutMSecs)),
+    myPool(pool),
+    myDrainCB(this, &CommandPipeline::drain)
+  {
+    myDrainCB.setName("ArPTZ::CommandPipeline::drain");
+  }
+
+  bool add(Command &cmd, Completions *done, bool *drainNow);
+  bool kick();
+  void wakeAt(Clock::time_point when);
+  void drain();
+  void reporting(const Completions &done)
+    { if (!done.empty()) myNumReporting++; }
+  void report(const Completions &done);
+  static bool supersedes(CommandKind newer, CommandKind older)
+  {
+    return newer == older || 
+      (newer == COMMAND_PANTILT && 
+       (older == COMMAND_PAN || older == COMMAND_TILT));
+  }
+
+  // how often to read answers when nothing else reads the connection
+  static const unsigned int POLL_MSECS = 2;
+
+  ArPTZ *myPTZ;
+  size_t myMaxQueued;
+  unsigned int myMaxInFlight;
+  Clock::duration myResponseTimeout;
+  ArThreadPool *myPool;
+  ArFunctorC<CommandPipeline> myDrainCB;
+
+  std::mutex myMutex;
+  // signaled when a drain finishes or a command completes
+  std::condition_variable myChangedCond;
+  std::deque<Command> myQueue;
+  std::deque<Command> myInFlight;
+  ArFunctor2<CommandId, CommandStatus> *myCB = NULL;
+  CommandId myLastId = 0;
+  CommandId myLastQueuedId = 0;
+  // the command being put together by a CommandScope
+  Command myGroup;
+  int myGroupDepth = 0;
+  std::thread::id myGroupThread;
+  // pool tasks that haven't finished
+  std::vector<ArThreadPool::TaskId> myTasks;
+  ArThreadPool::TaskId mySoonTask = 0;
+  ArThreadPool::TaskId myWakeTask = 0;
+  Clock::time_point myWakeAt;
+  bool myDraining = false;
+  bool myStopping = false;
+  // how many report() calls are coming (see reporting())
+  int myNumReporting = 0;
+};
+
+/// Queues a command (superseding older ones), call with myMutex locked
+/**
+   @param drainNow set to true if the caller needs to call drain() once
+   it has unlocked myMutex (see kick())
+   @return false if the command was dropped
+**/
+bool ArPTZ::CommandPipeline::add(Command &cmd, Completions *done, 
+				 bool *drainNow)
+{
+  std::deque<Command>::iterator it;
+
+  cmd.id = ++myLastId;
+  myLastQueuedId = cmd.id;
+  if (myStopping)
+  {
+    done->push_back(std::make_pair(cmd.id, COMMAND_CANCELED));
+    return false;
+  }
+  if (cmd.kind >= COMMAND_PAN)
+  {
+    for (it = myQueue.begin(); it != myQueue.end(); )
+    {
+      if (supersedes(cmd.kind, (*it).kind))
+      {
+	done->push_back(std::make_pair((*it).id, COMMAND_SUPERSEDED));
+	it = myQueue.erase(it);
+      }
+      else
+	++it;
+    }
+  }
+  if (myQueue.size() >= myMaxQueued)
+  {
+    ArLog::log(ArLog::Verbose, 
+	       "%s: Command queue is full (%lu commands), dropping a command",
+	       myPTZ->getTypeName(), (unsigned long)myQueue.size());
+    done->push_back(std::make_pair(cmd.id, COMMAND_DROPPED));
+    return false;
+  }
+  myQueue.push_back(std::move(cmd));
+  *drainNow = !kick();
+  return true;
+}
+
+/// Makes sure drain() runs soon, call with myMutex locked
+/**
+   @return false if the pool wouldn't take the task, in which case the
+   caller should call drain() itself once it has unlocked myMutex
+**/
+bool ArPTZ::CommandPipeline::kick()
+{
+  std::vector<ArThreadPool::TaskId>::iterator it;
+
+  // a drain that's going now picks up whatever changed before it stops
+  if (myStopping || myDraining)
+    return true;
+  if (mySoonTask != 0 && myPool->isPending(mySoonTask))
+    return true;
+  for (it = myTasks.begin(); it != myTasks.end(); )
+  {
+    if (!myPool->isPending(*it))
+      it = myTasks.erase(it);
+    else
+      ++it;
+  }
+  mySoonTask = myPool->submit(&myDrainCB);
+  if (mySoonTask == 0)
+    return false;
+  myTasks.push_back(mySoonTask);
+  return true;
+}
+
+/// Makes sure drain() runs by @a when, call with myMutex locked
+void ArPTZ::CommandPipeline::wakeAt(Clock::time_point when)
+{
+  Clock::duration delay;
+  ArThreadPool::TaskId id;
+
+  if (myWakeTask != 0 && myWakeAt <= when && myPool->isPending(myWakeTask))
+    return;
+  delay = when - Clock::now();
+  if (delay < Clock::duration::zero())
+    delay = Clock::duration::zero();
+  // round up, so we don't wake just before it's time
+  id = myPool->schedule(&myDrainCB, (unsigned int)
+			std::chrono::duration_cast<std::chrono::milliseconds>(
+				delay + std::chrono::milliseconds(1) - 
+				Clock::duration(1)).count());
+  if (id == 0)
+    return;
+  myTasks.push_back(id);
+  myWakeTask = id;
+  myWakeAt = when;
+}
+
+void ArPTZ::CommandPipeline::drain()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  std::deque<Command>::iterator it;
+  Completions done;
+  Clock::time_point now;
+  Clock::time_point when;
+  Command cmd;
+  std::string data;
+  CommandId id;
+  bool waitForAnswer;
+  bool ok;
+
+  if (myDraining || myStopping)
+    return;
+  myDraining = true;
+  // this may be either of those tasks, which count as pending until
+  // they return, so forget them or kick() and wakeAt() would think
+  // another drain is still coming
+  mySoonTask = 0;
+  myWakeTask = 0;
+  const bool tracking = myPTZ->canTrackCommandResponses();
+  const bool poll = (tracking && myPTZ->myConn != NULL && 
+		     !myPTZ->myReadFromRobotLoop);
+  while (true)
+  {
+    // read any answers ourselves if nothing else will
+    if (poll && !myInFlight.empty())
+    {
+      lock.unlock();
+      myPTZ->sensorInterpHandler();
+      lock.lock();
+    }
+    now = Clock::now();
+    for (it = myInFlight.begin(); it != myInFlight.end(); )
+    {
+      if (now - (*it).sent >= myResponseTimeout)
+      {
+	ArLog::log(ArLog::Verbose, "%s: Command %lu timed out",
+		   myPTZ->getTypeName(), (*it).id);
+	done.push_back(std::make_pair((*it).id, COMMAND_TIMED_OUT));
+	it = myInFlight.erase(it);
+      }
+      else
+	++it;
+    }
+    if (myStopping || myQueue.empty() || 
+	(tracking && myInFlight.size() >= myMaxInFlight))
+      break;
+    cmd = std::move(myQueue.front());
+    myQueue.pop_front();
+    id = cmd.id;
+    data.swap(cmd.data);
+    waitForAnswer = tracking && cmd.expectResponse;
+    // put it in flight before writing, so a fast answer can find it
+    if (waitForAnswer)
+    {
+      cmd.sent = now;
+      myInFlight.push_back(std::move(cmd));
+    }
+    lock.unlock();
+    ok = myPTZ->writeToDevice(data.data(), (unsigned int)data.size());
+    lock.lock();
+    if (!ok)
+    {
+      ArLog::log(ArLog::Normal, "%s: Could not write command %lu",
+		 myPTZ->getTypeName(), id);
+      for (it = myInFlight.begin(); it != myInFlight.end(); ++it)
+      {
+	if ((*it).id == id)
+	{
+	  myInFlight.erase(it);
+	  break;
+	}
+      }
+      done.push_back(std::make_pair(id, COMMAND_FAILED));
+    }
+    else if (!waitForAnswer)
+      done.push_back(std::make_pair(id, COMMAND_DONE));
+  }
+  // come back to poll for answers or time out the oldest command
+  if (!myStopping && !myInFlight.empty())
+  {
+    when = myInFlight.front().sent;
+    for (it = myInFlight.begin(); it != myInFlight.end(); ++it)
+      if ((*it).sent < when)
+	when = (*it).sent;
+    when += myResponseTimeout;
+    if (poll && when > now + std::chrono::milliseconds(POLL_MSECS))
+      when = now + std::chrono::milliseconds(POLL_MSECS);
+    wakeAt(when);
+  }
+  myDraining = false;
+  myChangedCond.notify_all();
+  reporting(done);
+  lock.unlock();
+  report(done);
+}
+
+/// Calls the callback for each completion, call with myMutex unlocked
+/**
+   Whoever collected @a done must have called reporting() with it
+   before unlocking myMutex, so that waitForCommands() waits for this.
+**/
+void ArPTZ::CommandPipeline::report(const Completions &done)
+{
+  ArFunctor2<CommandId, CommandStatus> *cb;
+  Completions::const_iterator it;
+
+  if (done.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    cb = myCB;
+  }
+  if (cb != NULL)
+  {
+    for (it = done.begin(); it != done.end(); ++it)
+      cb->invoke((*it).first, (*it).second);
+  }
+  std::lock_guard<std::mutex> lock(myMutex);
+  myNumReporting--;
+  myChangedCond.notify_all();
+}
+
+AREXPORT bool ArPTZ::enableCommandPipeline(size_t maxQueued,
+					   unsigned int maxInFlight,
+					   unsigned int responseTimeoutMSecs,
+					   ArThreadPool *pool)
+{
+  if (maxQueued == 0 || maxInFlight == 0)
+  {
+    ArLog::log(ArLog::Terse, 
+	       "%s: Command pipeline needs room for at least one command",
+	       getTypeName());
+    return false;
+  }
+  disableCommandPipeline();
+  if (pool == NULL)
+    pool = ArThreadPool::getShared();
+  myPipeline = new CommandPipeline(this, maxQueued, maxInFlight, 
+				   responseTimeoutMSecs, pool);
+  ArLog::log(ArLog::Verbose, 
+	     "%s: Command pipeline enabled (%lu queued, %u in flight, %u ms timeout)",
+	     getTypeName(), (unsigned long)maxQueued, maxInFlight, 
+	     responseTimeoutMSecs);
+  return true;
+}
+
+AREXPORT void ArPTZ::disableCommandPipeline()
+{
+  CommandPipeline *p = myPipeline;
+  CommandPipeline::Completions done;
+  std::vector<ArThreadPool::TaskId> tasks;
+  std::vector<ArThreadPool::TaskId>::iterator tit;
+  std::deque<CommandPipeline::Command>::iterator it;
+
+  if (p == NULL)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(p->myMutex);
+    p->myStopping = true;
+    for (it = p->myInFlight.begin(); it != p->myInFlight.end(); ++it)
+      done.push_back(std::make_pair((*it).id, COMMAND_CANCELED));
+    for (it = p->myQueue.begin(); it != p->myQueue.end(); ++it)
+      done.push_back(std::make_pair((*it).id, COMMAND_CANCELED));
+    p->myInFlight.clear();
+    p->myQueue.clear();
+    tasks.swap(p->myTasks);
+    p->reporting(done);
+  }
+  // cancel the pool tasks, waiting for one that's running
+  for (tit = tasks.begin(); tit != tasks.end(); ++tit)
+    p->myPool->cancel(*tit, true);
+  {
+    std::unique_lock<std::mutex> lock(p->myMutex);
+    p->myChangedCond.wait(lock, [p] { return !p->myDraining; });
+  }
+  myPipeline = NULL;
+  p->report(done);
+  delete p;
+}
+
+AREXPORT void ArPTZ::setCommandCallback(
+	ArFunctor2<CommandId, CommandStatus> *cb)
+{
+  if (myPipeline == NULL)
+    return;
+  std::lock_guard<std::mutex> lock(myPipeline->myMutex);
+  myPipeline->myCB = cb;
+}
+
+AREXPORT ArPTZ::CommandId ArPTZ::getLastCommandId()
+{
+  if (myPipeline == NULL)
+    return 0;
+  std::lock_guard<std::mutex> lock(myPipeline->myMutex);
+  return myPipeline->myLastQueuedId;
+}
+
+AREXPORT size_t ArPTZ::getNumQueuedCommands()
+{
+  if (myPipeline == NULL)
+    return 0;
+  std::lock_guard<std::mutex> lock(myPipeline->myMutex);
+  return myPipeline->myQueue.size();
+}
+
+AREXPORT size_t ArPTZ::getNumInFlightCommands()
+{
+  if (myPipeline == NULL)
+    return 0;
+  std::lock_guard<std::mutex> lock(myPipeline->myMutex);
+  return myPipeline->myInFlight.size();
+}
+
+AREXPORT bool ArPTZ::waitForCommands(unsigned int msecs)
+{
+  CommandPipeline *p = myPipeline;
+
+  if (p == NULL)
+    return false;
+  std::unique_lock<std::mutex> lock(p->myMutex);
+  return p->myChangedCond.wait_for(lock, std::chrono::milliseconds(msecs),
+	   [p] { return p->myQueue.empty() && p->myInFlight.empty() && 
+		   !p->myDraining && p->myNumReporting == 0; });
+}
+
+AREXPORT const char *ArPTZ::commandStatusName(CommandStatus status)
+{
+  switch (status)
+  {
+  case COMMAND_DONE:
+    return "done";
+  case COMMAND_SUPERSEDED:
+    return "superseded";
+  case COMMAND_DROPPED:
+    return "dropped";
+  case COMMAND_FAILED:
+    return "failed";
+  case COMMAND_TIMED_OUT:
+    return "timed out";
+  case COMMAND_CANCELED:
+    return "canceled";
+  }
+  return "unknown";
+}
+
+/**
+   @return true if this call started (or joined) a command, false if
+   another thread is in the middle of one, in which case this call's
+   packets are queued on their own
+**/
+AREXPORT bool ArPTZ::beginCommand(CommandKind kind, bool expectResponse)
+{
+  CommandPipeline *p = myPipeline;
+  std::lock_guard<std::mutex> lock(p->myMutex);
+
+  if (p->myGroupDepth > 0)
+  {
+    if (p->myGroupThread != std::this_thread::get_id())
+      return false;
+    p->myGroupDepth++;
+    return true;
+  }
+  p->myGroupDepth = 1;
+  p->myGroupThread = std::this_thread::get_id();
+  p->myGroup = CommandPipeline::Command();
+  p->myGroup.kind = kind;
+  p->myGroup.expectResponse = expectResponse;
+  p->myLastQueuedId = 0;
+  return true;
+}
+
+/// @return false if the command couldn't be queued
+AREXPORT bool ArPTZ::endCommand()
+{
+  CommandPipeline *p = myPipeline;
+  CommandPipeline::Completions done;
+  bool ok;
+  bool drainNow = false;
+
+  if (p == NULL)
+    return false;
+  {
+    std::lock_guard<std::mutex> lock(p->myMutex);
+    if (--p->myGroupDepth > 0)
+      return true;
+    p->myGroupThread = std::thread::id();
+    // nothing was sent (say, the camera was already there)
+    if (p->myGroup.data.empty())
+      return true;
+    ok = p->add(p->myGroup, &done, &drainNow);
+    p->reporting(done);
+  }
+  if (drainNow)
+    p->drain();
+  p->report(done);
+  return ok;
+}
+
+AREXPORT void ArPTZ::commandAccepted(int responseKey)
+{
+  CommandPipeline *p = myPipeline;
+  std::deque<CommandPipeline::Command>::iterator it;
+
+  if (p == NULL)
+    return;
+  std::lock_guard<std::mutex> lock(p->myMutex);
+  for (it = p->myInFlight.begin(); it != p->myInFlight.end(); ++it)
+  {
+    if ((*it).responseKey < 0)
+    {
+      (*it).responseKey = responseKey;
+      return;
+    }
+  }
+}
+
+AREXPORT void ArPTZ::commandCompleted(int responseKey, bool succeeded)
+{
+  CommandPipeline *p = myPipeline;
+  CommandPipeline::Completions done;
+  std::deque<CommandPipeline::Command>::iterator it;
+  bool drainNow = false;
+
+  if (p == NULL)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(p->myMutex);
+    for (it = p->myInFlight.begin(); it != p->myInFlight.end(); ++it)
+    {
+      if ((*it).responseKey == responseKey)
+      {
+	done.push_back(std::make_pair((*it).id, succeeded ? COMMAND_DONE : 
+				      COMMAND_FAILED));
+	p->myInFlight.erase(it);
+	break;
+      }
+    }
+    if (!p->myQueue.empty())
+      drainNow = !p->kick();
+    p->myChangedCond.notify_all();
+    p->reporting(done);
+  }
+  if (drainNow)
+    p->drain();
+  p->report(done);
+}
 
 /**
    @param robot The robot this camera is attached to, can be NULL
@@ -47,18 +586,21 @@ AREXPORT ArPTZ::ArPTZ(ArRobot *robot) :
   myMaxPosTilt(90),
   myMaxNegTilt(0),
   myMaxZoom(100),
-  myMinZoom(0)
+  myMinZoom(0),
+  myReadFromRobotLoop(false),
+  myPipeline(NULL)
 {
   myRobotPacketHandlerCB.setName("ArPTZ");
   if (myRobot != NULL)
   {
     myRobot->addConnectCB(&myConnectCB, ArListPos::LAST);
-    myRobot->addPacketHandler(&myRobotPacketHandlerCB, ArListPos::FIRST);
+    myRobot->addPacketHandler(&myRobotPacketHandlerCB, {0xb0, 0xb8, 200}, ArListPos::FIRST);
   }
 }
 
 AREXPORT ArPTZ::~ArPTZ()
 {
+  disableCommandPipeline();
   if (myRobot != NULL)
   {
     myRobot->remConnectCB(&myConnectCB);
@@ -69,18 +611,54 @@ AREXPORT ArPTZ::~ArPTZ()
 }
 
 /**
+   If the command pipeline is enabled the packet is copied into the
+   queue instead of being written now.
+
    @param packet the packet to send
-   @return true if the packet could be sent, false otherwise
+   @return true if the packet could be sent (or queued), false otherwise
 **/
    
 AREXPORT bool ArPTZ::sendPacket(ArBasePacket *packet)
 {
+  CommandPipeline *p = myPipeline;
+  CommandPipeline::Command cmd;
+  CommandPipeline::Completions done;
+  bool ok;
+  bool drainNow = false;
+
   packet->finalizePacket();
+  if (p == NULL)
+    return writeToDevice(packet->getBuf(), packet->getLength());
+  {
+    std::lock_guard<std::mutex> lock(p->myMutex);
+    // part of a pan/tilt/zoom call, it's queued when that call ends
+    if (p->myGroupDepth > 0 && 
+	p->myGroupThread == std::this_thread::get_id())
+    {
+      p->myGroup.data.append(packet->getBuf(), packet->getLength());
+      return true;
+    }
+    cmd.data.assign(packet->getBuf(), packet->getLength());
+    ok = p->add(cmd, &done, &drainNow);
+    p->reporting(done);
+  }
+  if (drainNow)
+    p->drain();
+  p->report(done);
+  return ok;
+}
+
+/**
+   @param data the bytes to write
+   @param length how many bytes to write
+   @return true if the data could be written, false otherwise
+**/
+AREXPORT bool ArPTZ::writeToDevice(const char *data, unsigned int length)
+{
   if (myConn != NULL)
-    return myConn->write(packet->getBuf(), packet->getLength());
+    return myConn->write(data, length) == (int)length;
   else if (myRobot != NULL)
-    return myRobot->comStrN(myAuxTxCmd, packet->getBuf(), 
-			    packet->getLength());
+    return myRobot->comStrN(myAuxTxCmd, data, length);
   else
     return false;
 }
@@ -130,9 +708,13 @@ AREXPORT bool ArPTZ::setDeviceConnection(ArDeviceConnection *connection,
     myRobot->remSensorInterpTask(&mySensorInterpCB);
   }
   myConn = connection;
+  myReadFromRobotLoop = false;
   if(!myConn) return false;
   if (driveFromRobotLoop && myRobot != NULL && myConn != NULL)
+  {
     myRobot->addSensorInterpTask("ptz", 50, &mySensorInterpCB);
+    myReadFromRobotLoop = true;
+  }
   if (myConn->getStatus() != ArDeviceConnection::STATUS_OPEN)
     return myConn->openSimple();
   else
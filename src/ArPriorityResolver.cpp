@@ -27,6 +27,8 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArAction.h"
 #include "Aria/ArRobot.h"
 
+#include <chrono>
+
 AREXPORT ArPriorityResolver::ArPriorityResolver() :
   ArResolver("ArPriorityResolver", "Resolves strictly by using priority, the highest priority action to act is the one that gets to go.  Does no mixing of any variety.")
 {
@@ -37,53 +39,165 @@ AREXPORT ArPriorityResolver::ArPriorityResolver() :
 {
 } */
 
+AREXPORT void ArPriorityResolver::actionsChanged()
+{
+  myActionsChanged = true;
+}
+
+AREXPORT void ArPriorityResolver::rebuildSortedActions(
+	ArResolver::ActionMap *actions)
+{
+  ArResolver::ActionMap::reverse_iterator it;
+
+  mySortedActions.clear();
+  mySortedActions.reserve(actions->size());
+  for (it = actions->rbegin(); it != actions->rend(); ++it)
+    mySortedActions.push_back(*it);
+  mySortedFrom = actions;
+  myActionsChanged = false;
+}
+
+/**
+   Walks the map alongside the sorted array, which is cheap next to
+   firing the actions, so that actions added, removed or moved to a
+   different priority without ArRobot knowing are still noticed.
+**/
+AREXPORT bool ArPriorityResolver::sortedActionsMatch(
+	const ArResolver::ActionMap *actions) const
+{
+  if (actions->size() != mySortedActions.size())
+    return false;
+  ArResolver::ActionMap::const_reverse_iterator it = actions->rbegin();
+  for (const std::pair<int, ArAction *> &sorted : mySortedActions)
+  {
+    if (it->first != sorted.first || it->second != sorted.second)
+      return false;
+    ++it;
+  }
+  return true;
+}
+
+AREXPORT void ArPriorityResolver::setTracing(bool tracing, size_t maxEntries)
+{
+  myTracing = tracing;
+  myTrace.clear();
+  myLastResolveUSecs = 0;
+  if (tracing)
+  {
+    myTraceMaxEntries = maxEntries;
+    myTrace.reserve(maxEntries);
+  }
+  else
+  {
+    myTraceMaxEntries = 0;
+    myTrace.shrink_to_fit();
+  }
+}
+
+AREXPORT void ArPriorityResolver::logTrace(ArLog::LogLevel level) const
+{
+  ArLog::log(level, "%s: %lu actions traced, resolve took %lld usecs",
+	     getName(), (unsigned long)myTrace.size(), myLastResolveUSecs);
+  for (const TraceEntry &entry : myTrace)
+  {
+    if (!entry.fired)
+    {
+      ArLog::log(level, "  %d %s: nothing (%lld usecs)", entry.priority,
+		 entry.actionName, entry.usecs);
+      continue;
+    }
+    ArLog::log(level, 
+       "  %d %s: vel %.0f (%.2f) deltaHeading %.0f (%.2f) rotVel %.0f (%.2f) latVel %.0f (%.2f) (%lld usecs)",
+	       entry.priority, entry.actionName, 
+	       entry.vel, entry.velStrength,
+	       entry.deltaHeading, entry.deltaHeadingStrength,
+	       entry.rotVel, entry.rotVelStrength,
+	       entry.latVel, entry.latVelStrength, entry.usecs);
+  }
+}
+
 AREXPORT ArActionDesired *ArPriorityResolver::resolve(
 	ArResolver::ActionMap *actions, ArRobot *robot, bool logActions)
 {
-  ArResolver::ActionMap::reverse_iterator it;
   ArAction *action;
   ArActionDesired *act;
-  ArActionDesired averaging;
   bool first = true;
-  int lastPriority;
+  int lastPriority = 0;
+  int priority;
   bool printedFirst = true;
   int printedLast = -1;
+  std::chrono::steady_clock::time_point resolveStart;
+  std::chrono::steady_clock::time_point fireStart;
 
   if (actions == NULL)
     return NULL;
 
+  // the robot tells us when its actions change, but check the map
+  // too in case we're handed some other one or it was edited directly
+  if (myActionsChanged || actions != mySortedFrom || 
+      !sortedActionsMatch(actions))
+    rebuildSortedActions(actions);
+
+  if (myTracing)
+  {
+    myTrace.clear();
+    resolveStart = std::chrono::steady_clock::now();
+  }
+
   myActionDesired.reset();
-  averaging.reset();
-  averaging.startAverage();
-  for (it = actions->rbegin(); it != actions->rend(); ++it)
+  myAveraging.reset();
+  myAveraging.startAverage();
+  for (const std::pair<int, ArAction *> &sorted : mySortedActions)
   {
-    action = (*it).second;
+    priority = sorted.first;
+    action = sorted.second;
     if (action != NULL && action->isActive())
     {
       /// MPL jan 7 '12 moved this next code block up 'from here'
-      if (first || (*it).first != lastPriority)
+      if (first || priority != lastPriority)
       {
-	averaging.endAverage();
-	myActionDesired.merge(&averaging);
+	myAveraging.endAverage();
+	myActionDesired.merge(&myAveraging);
 	
-	averaging.reset();
-	averaging.startAverage();
+	myAveraging.reset();
+	myAveraging.startAverage();
 	first = false;
-	lastPriority = (*it).first;
+	lastPriority = priority;
       }
+      if (myTracing)
+	fireStart = std::chrono::steady_clock::now();
       act = action->fire(myActionDesired);
       if (robot != NULL && act != NULL)
 	act->accountForRobotHeading(robot->getTh());
       if (act != NULL)
 	act->sanityCheck(action->getName());
+      if (myTracing && myTrace.size() < myTraceMaxEntries)
+      {
+	TraceEntry entry;
+	entry.actionName = action->getName();
+	entry.priority = priority;
+	entry.fired = (act != NULL);
+	entry.usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - fireStart).count();
+	entry.vel = act != NULL ? act->getVel() : 0;
+	entry.velStrength = act != NULL ? act->getVelStrength() : 0;
+	entry.deltaHeading = act != NULL ? act->getDeltaHeading() : 0;
+	entry.deltaHeadingStrength = 
+	  act != NULL ? act->getDeltaHeadingStrength() : 0;
+	entry.rotVel = act != NULL ? act->getRotVel() : 0;
+	entry.rotVelStrength = act != NULL ? act->getRotVelStrength() : 0;
+	entry.latVel = act != NULL ? act->getLatVel() : 0;
+	entry.latVelStrength = act != NULL ? act->getLatVelStrength() : 0;
+	myTrace.push_back(entry);
+      }
       // from here
-      averaging.addAverage(act);
+      myAveraging.addAverage(act);
       if (logActions && act != NULL && act->isAnythingDesired())
       {
-	if (printedFirst || printedLast != (*it).first)
+	if (printedFirst || printedLast != priority)
 	{
-	  ArLog::log(ArLog::Terse, "Priority %d:", (*it).first);
-	  printedLast = (*it).first;
+	  ArLog::log(ArLog::Terse, "Priority %d:", priority);
+	  printedLast = priority;
 	  printedFirst = false;
 	}
 	ArLog::log(ArLog::Terse, "Action: %s", action->getName());
@@ -93,13 +207,17 @@ AREXPORT ArActionDesired *ArPriorityResolver::resolve(
 	
     }
   }
-  averaging.endAverage();
-  myActionDesired.merge(&averaging);
+  myAveraging.endAverage();
+  myActionDesired.merge(&myAveraging);
   /*
   printf(
       "desired delta %.0f strength %.3f, desired speed %.0f strength %.3f\n",
       myActionDesired.getDeltaHeading(), myActionDesired.getHeadingStrength(), 
       myActionDesired.getVel(), myActionDesired.getVelStrength());
   */
+  if (myTracing)
+    myLastResolveUSecs = 
+      std::chrono::duration_cast<std::chrono::microseconds>(
+	      std::chrono::steady_clock::now() - resolveStart).count();
   return &myActionDesired;
 }
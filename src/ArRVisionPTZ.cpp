@@ -95,7 +95,8 @@ AREXPORT ArRVisionPTZ::ArRVisionPTZ(UNUSED ArRobot *robot) :
   ArPTZ(NULL),
   myPacket(255), 
   myZoomPacket(9),
-  mySerialPort(ArUtil::COM4)
+  mySerialPort(ArUtil::COM4),
+  myResponseLength(0)
 {
   //myRobot = robot;
   initializePackets();
@@ -191,7 +192,9 @@ AREXPORT bool ArRVisionPTZ::init()
   myPacket.uByteToBuf(0x01);
   myPacket.uByteToBuf(0xff);
 
-  if (!sendPacket(&myPacket))
+  // these are broadcasts, so they don't get the usual acknowledgement
+  CommandScope cmd(this, COMMAND_OTHER, false);
+  if (!cmd.finish(sendPacket(&myPacket)))
   {
     ArLog::log(ArLog::Terse, "ArRVisionPTZ: Error sending initialization packet to RVision camera!");
     return false;
@@ -253,6 +256,7 @@ AREXPORT bool ArRVisionPTZ::tiltRel_i(double degrees)
 
 AREXPORT bool ArRVisionPTZ::zoom(int zoomValue)
 {
+  CommandScope cmd(this, COMMAND_ZOOM);
   //printf("ArRVision::zoom(%d)\n", zoomValue);
   if (zoomValue > MAX_ZOOM)
     zoomValue = MAX_ZOOM;
@@ -263,7 +267,7 @@ AREXPORT bool ArRVisionPTZ::zoom(int zoomValue)
   const int z = ArMath::roundInt(myZoom);
   assert(z <= INT16_MAX);
   myZoomPacket.byte2ToBufAtPos((int16_t)z, 4);
-  return sendPacket(&myZoomPacket);
+  return cmd.finish(sendPacket(&myZoomPacket));
 }
 
 AREXPORT bool ArRVisionPTZ::zoomRel(int zoomValue)
@@ -271,6 +275,68 @@ AREXPORT bool ArRVisionPTZ::zoomRel(int zoomValue)
   return zoom(myZoom + zoomValue);
 }
 
+/**
+   This doesn't block, it reads whatever has arrived and passes each
+   complete reply to handleResponse(), it never returns a packet.
+**/
+AREXPORT ArBasePacket *ArRVisionPTZ::readPacket()
+{
+  char c;
+
+  if (myConn == NULL)
+    return NULL;
+  while (myConn->read(&c, 1, 0) > 0)
+  {
+    const unsigned char byte = (unsigned char) c;
+    // replies from the camera start with 0x90, skip anything else
+    if (myResponseLength == 0 && byte != 0x90)
+      continue;
+    if (myResponseLength >= sizeof(myResponse))
+    {
+      myResponseLength = 0;
+      continue;
+    }
+    myResponse[myResponseLength++] = byte;
+    if (byte == 0xff)
+    {
+      handleResponse();
+      myResponseLength = 0;
+    }
+  }
+  return NULL;
+}
+
+/**
+   The second byte of a reply is 0x4y for an acknowledgement, 0x5y for
+   a completion and 0x6y for an error, where y is the socket the camera
+   put the command in (0 if the command never got one).
+**/
+void ArRVisionPTZ::handleResponse()
+{
+  if (myResponseLength < 3)
+    return;
+  const int socket = myResponse[1] & 0x0f;
+  const int key = (socket == 0) ? -1 : socket;
+  switch (myResponse[1] & 0xf0)
+  {
+  case 0x40:
+    commandAccepted(socket);
+    break;
+  case 0x50:
+    // longer ones are answers to inquiries, which we don't send
+    if (myResponseLength == 3)
+      commandCompleted(key, true);
+    break;
+  case 0x60:
+    ArLog::log(ArLog::Verbose, "ArRVisionPTZ: Camera returned error 0x%x on socket %d",
+	       myResponse[2], socket);
+    commandCompleted(key, false);
+    break;
+  default:
+    break;
+  }
+}
+
 /*
 AREXPORT bool ArRVisionPTZ::packetHandler(ArRobotPacket *packet)
 {
@@ -28,6 +28,31 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include <algorithm>
 
+// Scratch arrays that getClosestPolar() and getClosestBox() copy the
+// buffer into, so that the searches can run over contiguous arrays.
+// They're per thread so that the const methods stay safe to call from
+// more than one thread at once.
+static thread_local std::vector<double> ourScratchXs;
+static thread_local std::vector<double> ourScratchYs;
+static thread_local std::vector<const ArPoseWithTime *> ourScratchPoses;
+
+static void gatherCoords(const std::list<ArPoseWithTime> &buffer,
+			 std::vector<const ArPoseWithTime *> *poses)
+{
+  ourScratchXs.resize(buffer.size());
+  ourScratchYs.resize(buffer.size());
+  if (poses != NULL)
+    poses->resize(buffer.size());
+  size_t i = 0;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it, ++i)
+  {
+    ourScratchXs[i] = it->getX();
+    ourScratchYs[i] = it->getY();
+    if (poses != NULL)
+      (*poses)[i] = &(*it);
+  }
+}
+
 
 
 /** @class ArRangeBuffer
@@ -51,7 +76,10 @@ AREXPORT void ArRangeBuffer::setCapacity(size_t size)
 {
   myCapacity = size;
   if(myCapacity < myBuffer.size())
+  {
     myBuffer.resize(myCapacity);
+    ++myChangeCount;
+  }
 }
 
 
@@ -81,40 +109,94 @@ AREXPORT double ArRangeBuffer::getClosestPolar(double startAngle,
 					       unsigned int maxRange,
 					       double *angle) const
 {
-  double closest = 0;
-  bool foundOne = false;
-  double closeTh = 0;
-  double dist = 0;
+  gatherCoords(myBuffer, NULL);
+  return getClosestPolarInArrays(ourScratchXs.data(), ourScratchYs.data(),
+				 ourScratchXs.size(), startAngle, endAngle,
+				 startPos, maxRange, angle);
+}
+
+/**
+   Points at exactly @a position count as being at an angle of 0 (in
+   global coordinates), like ArPose::findAngleTo() says.
+*/
+AREXPORT double ArRangeBuffer::getClosestPolarInArrays(
+	const double *xs, const double *ys, size_t num,
+	double startAngle, double endAngle, const ArPose& position, 
+	unsigned int maxRange, double *angle, size_t *index)
+{
+  // the search is done a block at a time, first working out the
+  // squared distance of every point in the block (or infinity if it's
+  // not in the sector) in a loop with no branches that can be
+  // vectorized, then finding the smallest of those
+  const size_t blockSize = 256;
+  double dists[blockSize];
+  const double sx = position.getX();
+  const double sy = position.getY();
+  const double notIn = HUGE_VAL;
+  double span;
+  double zeroDist;
+  double dx, dy, d2, c1, c2;
+  double best = notIn;
+  size_t bestIndex = num;
+  size_t block, n, i;
 
   startAngle = ArMath::fixAngle(startAngle);
   endAngle = ArMath::fixAngle(endAngle);
-
-  for (auto it = myBuffer.begin(); it != myBuffer.end(); ++it)
+  if (startAngle == endAngle)
+    return maxRange;
+  // how far it is counterclockwise from the start to the end of the sector
+  span = endAngle - startAngle;
+  if (span < 0)
+    span += 360;
+  const bool wide = span > 180;
+  // unit vectors along the edges of the sector, in global coords
+  const double ax = ArMath::cos(position.getTh() + startAngle);
+  const double ay = ArMath::sin(position.getTh() + startAngle);
+  const double bx = ArMath::cos(position.getTh() + endAngle);
+  const double by = ArMath::sin(position.getTh() + endAngle);
+  zeroDist = ArMath::angleBetween(-position.getTh(), startAngle, endAngle) ?
+    0 : notIn;
+
+  for (block = 0; block < num; block += blockSize)
   {
-    const double angle1=startPos.findAngleTo(*it);
-    const double angle2=startPos.getTh();
-    const double th = ArMath::subAngle(angle1, angle2);
-    if (ArMath::angleBetween(th, startAngle, endAngle))
+    n = std::min(blockSize, num - block);
+    // a point is in the sector if it's counterclockwise of the start
+    // edge (c1 > 0) and clockwise of the end edge (c2 > 0), or for
+    // sectors wider than 180 degrees if it's either
+    for (i = 0; i < n; i++)
     {
-      if (!foundOne || (dist = it->findDistanceTo(startPos)) < closest)
+      dx = xs[block + i] - sx;
+      dy = ys[block + i] - sy;
+      d2 = dx * dx + dy * dy;
+      c1 = ax * dy - ay * dx;
+      c2 = dx * by - dy * bx;
+      dists[i] = ((wide ? ((c1 > 0) | (c2 > 0)) : ((c1 > 0) & (c2 > 0))) ? 
+		  d2 : notIn);
+      dists[i] = (d2 == 0 ? zeroDist : dists[i]);
+    }
+    for (i = 0; i < n; i++)
+    {
+      if (dists[i] < best)
       {
-        closeTh = th;	
-        if (!foundOne)
-          closest = it->findDistanceTo(startPos);
-        else
-          closest = dist;
-        foundOne = true;
+	best = dists[i];
+	bestIndex = block + i;
       }
     }
   }
-  if (!foundOne)
+
+  if (bestIndex == num)
     return maxRange;
   if (angle != NULL)
-    *angle = closeTh;
-  if (closest > maxRange)
+    *angle = ArMath::subAngle(
+	    position.findAngleTo(ArPose(xs[bestIndex], ys[bestIndex])), 
+	    position.getTh());
+  if (index != NULL)
+    *index = bestIndex;
+  best = sqrt(best);
+  if (best > maxRange)
     return maxRange;
   else
-    return closest;  
+    return best;
 }
 
 
@@ -146,51 +228,85 @@ AREXPORT double ArRangeBuffer::getClosestBox(
 	unsigned int maxRange, ArPose *readingPos, ArPose targetPose) const
 
 {
+  size_t index;
+  double closest;
+
+  gatherCoords(myBuffer, &ourScratchPoses);
+  closest = getClosestBoxInArrays(ourScratchXs.data(), ourScratchYs.data(),
+				  ourScratchXs.size(), x1, y1, x2, y2, 
+				  startPos, maxRange, readingPos, targetPose, 
+				  &index);
+  // the arrays don't have the angles of the readings, so fix that up
+  if (readingPos != NULL && closest < maxRange)
+    readingPos->setTh(ArMath::addAngle(
+			      ourScratchPoses[index]->getTh(),
+			      ArMath::subAngle(0, startPos.getTh())));
+  return closest;
+}
+
+AREXPORT double ArRangeBuffer::getClosestBoxInArrays(
+	const double *xs, const double *ys, size_t num,
+	double x1, double y1, double x2, double y2, const ArPose& position,
+	unsigned int maxRange, ArPose *readingPos, ArPose targetPose, 
+	size_t *index)
+{
+  // transform a block at a time, so the local coords stay in the cache,
+  // then find the distances and then the closest, as in
+  // getClosestPolarInArrays()
+  const size_t blockSize = 256;
+  double localXs[blockSize];
+  double localYs[blockSize];
+  const ArTransform trans(position, ArPose(0, 0, 0));
+  const double tx = targetPose.getX();
+  const double ty = targetPose.getY();
   double closest = maxRange;
+  double closestSquared = closest * closest;
+  size_t closestIndex = num;
   double dist;
-  ArPose closestPos;
-  //ArPoseWithTime pose;
-  ArPose zeroPos(0, 0, 0);;
-  ArTransform trans(startPos, zeroPos);
-
-  // double temp;
-
+  size_t block, n, i;
 
   if (x1 >= x2)
-  {
     std::swap(x1, x2);
-/*     temp = x1, 
-    x1 = x2;
-    x2 = temp; */
-  }
   if (y1 >= y2)
-  {
     std::swap(y1, y2);
-/*     temp = y1, 
-    y1 = y2;
-    y2 = temp; */
-  }
-  
-  for (auto it = myBuffer.begin(); it != myBuffer.end(); ++it)
-  {
-    const ArPoseWithTime pose = trans.doTransform(*it);
 
-    // see if its in the box
-    if (pose.getX() >= x1 && pose.getX() <= x2 &&
-	      pose.getY() >= y1 && pose.getY() <= y2)
+  for (block = 0; block < num; block += blockSize)
+  {
+    n = std::min(blockSize, num - block);
+    trans.doTransform(xs + block, ys + block, localXs, localYs, n);
+    // the squared distance to each point in the box, or infinity if
+    // it's not in the box (reusing localXs), without branches so it
+    // vectorizes
+    for (i = 0; i < n; i++)
+    {
+      dist = ArMath::squaredDistanceBetween(localXs[i], localYs[i], tx, ty);
+      // (& rather than && so there are no branches)
+      localXs[i] = ((localXs[i] >= x1) & (localXs[i] <= x2) &
+		    (localYs[i] >= y1) & (localYs[i] <= y2)) ? dist : HUGE_VAL;
+    }
+    for (i = 0; i < n; i++)
     {
-      dist = pose.findDistanceTo(targetPose);
-      //pose.log();
-      if (dist < closest)
+      if (localXs[i] < closestSquared)
       {
-        closest = dist;
-        closestPos = pose;
+	closestSquared = localXs[i];
+	closestIndex = block + i;
       }
     }
   }
 
-  if (readingPos != NULL)
-    *readingPos = closestPos;
+  if (closestIndex < num)
+  {
+    closest = sqrt(closestSquared);
+    if (readingPos != NULL)
+      *readingPos = trans.doTransform(ArPose(xs[closestIndex], 
+					     ys[closestIndex]));
+    if (index != NULL)
+      *index = closestIndex;
+  }
+  else if (readingPos != NULL)
+  {
+    *readingPos = ArPose();
+  }
   if (closest > maxRange)
     return maxRange;
   else
@@ -205,6 +321,7 @@ AREXPORT double ArRangeBuffer::getClosestBox(
 AREXPORT void ArRangeBuffer::applyTransform(const ArTransform &trans)
 {
   std::for_each(myBuffer.begin(), myBuffer.end(), [&](ArPoseWithTime &p) { p = trans.doTransform(p); } );
+  ++myChangeCount;
 }
 
 AREXPORT void ArRangeBuffer::clear()
@@ -266,6 +383,7 @@ AREXPORT void ArRangeBuffer::redoReading(double x, double y)
     myRedoIt->setPose(x, y);
     // TODO sholud we update timestamp?
     ++myRedoIt;
+    ++myChangeCount;
   }
   // We re-used as many items in myBuffer as we could, we have reached the end of myBuffer. Just append them now.
   else
@@ -353,6 +471,7 @@ AREXPORT void ArRangeBuffer::addReading(const ArPoseWithTime& p)
     else
       myBuffer.emplace_front(p);
   }
+  ++myChangeCount;
 
   /* another Naive solution
   myBuffer.emplace_front(ArPoseWithTime(x, y));
@@ -405,6 +524,8 @@ void ArRangeBuffer::endInvalidationSweep()
     // naive implementation, just remove myBuffer.remove(*i);
     myReserved.splice(myReserved.cend(), myBuffer, *i); // reserve item for future reuse. (*i) is an iterator into myBuffer.
   }
+  if (!myInvalidSweepList.empty())
+    ++myChangeCount;
   myInvalidSweepList.clear();
 }
 
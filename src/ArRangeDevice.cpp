@@ -25,6 +25,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaOSDef.h"
 #include "Aria/ArRangeDevice.h"
 #include "Aria/ArRobot.h"
+#include "Aria/ArMetrics.h"
 
 /**
    @param currentBufferSize number of readings to store in the current
@@ -75,12 +76,15 @@ AREXPORT ArRangeDevice::ArRangeDevice(size_t currentBufferSize,
 				      bool locationDependent) :
   myName(name),
   myFilterCB(this, &ArRangeDevice::filterCallback),
+  myCurrentBufferSizeMetricCB(this, &ArRangeDevice::getCurrentBufferSizeMetric),
+  myCumulativeBufferSizeMetricCB(this, 
+				 &ArRangeDevice::getCumulativeBufferSizeMetric),
   myCurrentBuffer(currentBufferSize),
   myCumulativeBuffer(cumulativeBufferSize),
   myMaxRange(maxRange),
   myIsLocationDependent(locationDependent)
 {
-  myDeviceMutex.setLogName("ArRangeDevice::myDeviceMutex");
+  myDeviceMutex.setLogNameVar("ArRangeDevice(%s)::myDeviceMutex", name);
   //myRobot = NULL;
   //myName = name;
   //myMaxRange = maxRange;
@@ -101,6 +105,8 @@ AREXPORT ArRangeDevice::ArRangeDevice(size_t currentBufferSize,
   setMinDistBetweenCumulative(0);
   setMaxInsertDistCumulative(0);
 
+  registerMetrics();
+
   //myCurrentDrawingData = NULL;
   //myOwnCurrentDrawingData = false;
   //myCumulativeDrawingData = NULL;
@@ -109,8 +115,29 @@ AREXPORT ArRangeDevice::ArRangeDevice(size_t currentBufferSize,
 
 }
 
+/**
+   Registers the gauges for the buffer sizes, labeled with the device's
+   name.  Subclasses that change myName after construction call this
+   again so that the labels match the new name.
+**/
+AREXPORT void ArRangeDevice::registerMetrics()
+{
+  ArMetrics::remCallbackGauge(&myCurrentBufferSizeMetricCB);
+  ArMetrics::remCallbackGauge(&myCumulativeBufferSizeMetricCB);
+  std::string labels = ArMetrics::makeLabels("device", myName);
+  ArMetrics::addCallbackGauge("aria_range_device_current_readings", 
+			      "Readings in each range device's current buffer",
+			      labels, &myCurrentBufferSizeMetricCB);
+  ArMetrics::addCallbackGauge("aria_range_device_cumulative_readings", 
+			      "Readings in each range device's cumulative buffer",
+			      labels, &myCumulativeBufferSizeMetricCB);
+}
+
 AREXPORT ArRangeDevice::~ArRangeDevice()
 {
+  ArMetrics::remCallbackGauge(&myCurrentBufferSizeMetricCB);
+  ArMetrics::remCallbackGauge(&myCumulativeBufferSizeMetricCB);
+
   if (myRobot != NULL)
     myRobot->remSensorInterpTask(&myFilterCB);
 
@@ -697,4 +724,30 @@ AREXPORT void ArRangeDevice::logData(ArLog::LogLevel level, const char *prefix)
   }
 }
 
+/**
+   Called by ArMetrics (from the thread taking a snapshot) for the
+   aria_range_device_current_readings gauge.
+**/
+AREXPORT double ArRangeDevice::getCurrentBufferSizeMetric()
+{
+  // not the virtual lockDeviceShared(), since this can be called while
+  // a subclass is being constructed or destroyed
+  myDeviceMutex.lockShared();
+  double size = (double)myCurrentBuffer.getCurrentSize();
+  myDeviceMutex.unlockShared();
+  return size;
+}
+
+/**
+   Called by ArMetrics (from the thread taking a snapshot) for the
+   aria_range_device_cumulative_readings gauge.
+**/
+AREXPORT double ArRangeDevice::getCumulativeBufferSizeMetric()
+{
+  myDeviceMutex.lockShared();
+  double size = (double)myCumulativeBuffer.getCurrentSize();
+  myDeviceMutex.unlockShared();
+  return size;
+}
+
 
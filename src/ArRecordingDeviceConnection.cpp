@@ -0,0 +1,213 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArRecordingDeviceConnection.h"
+#include "Aria/ArLog.h"
+
+constexpr const char *ArRecordingDeviceConnection::FileMagic;
+constexpr size_t ArRecordingDeviceConnection::FileMagicLength;
+constexpr unsigned char ArRecordingDeviceConnection::FileVersion;
+
+AREXPORT ArRecordingDeviceConnection::ArRecordingDeviceConnection(
+	ArDeviceConnection *conn) :
+  myConn(NULL),
+  myFile(NULL),
+  myNumRecords(0)
+{
+  myMutex.setLogName("ArRecordingDeviceConnection::myMutex");
+  setPortType("recording");
+  setConnection(conn);
+}
+
+AREXPORT ArRecordingDeviceConnection::~ArRecordingDeviceConnection()
+{
+  stopRecording();
+}
+
+AREXPORT void ArRecordingDeviceConnection::setConnection(
+	ArDeviceConnection *conn)
+{
+  myConn = conn;
+  if (myConn != NULL)
+  {
+    setPortName(myConn->getPortName());
+    setDeviceName(myConn->getDeviceName());
+  }
+}
+
+AREXPORT bool ArRecordingDeviceConnection::startRecording(const char *fileName)
+{
+  ArScopedLock lock(myMutex);
+
+  if (myFile != NULL)
+    fclose(myFile);
+  myNumRecords = 0;
+  myFileName = fileName;
+  if ((myFile = ArUtil::fopen(fileName, "wb")) == NULL)
+  {
+    ArLog::logErrorFromOS(ArLog::Terse, 
+		    "ArRecordingDeviceConnection: Could not open %s to record %s",
+			  fileName, getPortName());
+    return false;
+  }
+  fwrite(FileMagic, 1, FileMagicLength, myFile);
+  fputc(FileVersion, myFile);
+  myLastRecordTime = std::chrono::steady_clock::now();
+  ArLog::log(ArLog::Normal, "ArRecordingDeviceConnection: Recording %s to %s",
+	     getPortName(), fileName);
+  return true;
+}
+
+AREXPORT void ArRecordingDeviceConnection::stopRecording()
+{
+  ArScopedLock lock(myMutex);
+
+  if (myFile == NULL)
+    return;
+  fclose(myFile);
+  myFile = NULL;
+  ArLog::log(ArLog::Normal, 
+	     "ArRecordingDeviceConnection: Recorded %lu reads and writes of %s to %s",
+	     myNumRecords, getPortName(), myFileName.c_str());
+}
+
+AREXPORT bool ArRecordingDeviceConnection::isRecording() const
+{
+  ArScopedLock lock(myMutex);
+  return myFile != NULL;
+}
+
+AREXPORT unsigned long ArRecordingDeviceConnection::getNumRecords() const
+{
+  ArScopedLock lock(myMutex);
+  return myNumRecords;
+}
+
+void ArRecordingDeviceConnection::writeVarint(unsigned long long value)
+{
+  while (value >= 0x80)
+  {
+    fputc((int)((value & 0x7f) | 0x80), myFile);
+    value >>= 7;
+  }
+  fputc((int)value, myFile);
+}
+
+void ArRecordingDeviceConnection::record(RecordType type, const char *data, 
+					 unsigned int size)
+{
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  ArScopedLock lock(myMutex);
+
+  if (myFile == NULL)
+    return;
+  fputc(type, myFile);
+  writeVarint((unsigned long long)
+	      std::chrono::duration_cast<std::chrono::microseconds>(
+		      now - myLastRecordTime).count());
+  writeVarint(size);
+  if (size > 0)
+    fwrite(data, 1, size, myFile);
+  myLastRecordTime = now;
+  myNumRecords++;
+}
+
+AREXPORT int ArRecordingDeviceConnection::read(const char *data, 
+					       unsigned int size, 
+					       unsigned int msWait)
+{
+  if (myConn == NULL)
+    return -1;
+  int ret = myConn->read(data, size, msWait);
+  if (ret > 0)
+    record(RecordRead, data, (unsigned int)ret);
+  else if (ret < 0)
+    record(RecordReadError, NULL, 0);
+  return ret;
+}
+
+AREXPORT int ArRecordingDeviceConnection::write(const char *data, 
+						unsigned int size)
+{
+  if (myConn == NULL)
+    return -1;
+  int ret = myConn->write(data, size);
+  if (ret > 0)
+    record(RecordWrite, data, (unsigned int)ret);
+  return ret;
+}
+
+AREXPORT int ArRecordingDeviceConnection::getStatus()
+{
+  if (myConn == NULL)
+    return STATUS_NEVER_OPENED;
+  return myConn->getStatus();
+}
+
+AREXPORT bool ArRecordingDeviceConnection::openSimple()
+{
+  if (myConn == NULL)
+    return false;
+  return myConn->openSimple();
+}
+
+AREXPORT bool ArRecordingDeviceConnection::close()
+{
+  if (myConn == NULL)
+    return false;
+  return myConn->close();
+}
+
+AREXPORT const char *ArRecordingDeviceConnection::getOpenMessage(
+	int messageNumber)
+{
+  if (myConn == NULL)
+    return "No connection to record";
+  return myConn->getOpenMessage(messageNumber);
+}
+
+AREXPORT ArTime ArRecordingDeviceConnection::getTimeRead(int index)
+{
+  if (myConn == NULL)
+  {
+    ArTime now;
+    return now;
+  }
+  return myConn->getTimeRead(index);
+}
+
+AREXPORT bool ArRecordingDeviceConnection::isTimeStamping()
+{
+  if (myConn == NULL)
+    return false;
+  return myConn->isTimeStamping();
+}
+
+AREXPORT int ArRecordingDeviceConnection::getFD() const
+{
+  if (myConn == NULL)
+    return -1;
+  return myConn->getFD();
+}
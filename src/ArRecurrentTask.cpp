@@ -47,18 +47,39 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 // constructor: start up thread, leave it ready for go()
 
 AREXPORT 
-ArRecurrentTask::ArRecurrentTask()
+ArRecurrentTask::ArRecurrentTask() :
+  myPool(NULL),
+  myPoolTask(0),
+  myInPool(false),
+  myPoolCB(this, &ArRecurrentTask::runPooled)
 {
   setThreadName("ArRecurrentTask");
   running = go_req = killed = false;
   create();			// create the thread
 }
 
+// constructor for running in a pool: no thread, go() submits to the pool
+
+AREXPORT 
+ArRecurrentTask::ArRecurrentTask(ArThreadPool *pool) :
+  myPool(pool),
+  myPoolTask(0),
+  myInPool(false),
+  myPoolCB(this, &ArRecurrentTask::runPooled)
+{
+  setThreadName("ArRecurrentTask");
+  myPoolCB.setName("ArRecurrentTask");
+  running = go_req = killed = false;
+}
+
 
 AREXPORT 
 ArRecurrentTask::~ArRecurrentTask()
 {
   kill();
+  // can't interrupt a run in the pool, so wait for it
+  if (myPool != NULL)
+    myPool->cancel(myPoolTask, true);
 }
 
 // Entry to the thread's main process
@@ -109,12 +130,54 @@ ArRecurrentTask::runThread(void *)
   return NULL;
 }
 
+// Runs task() on a pool worker, again if go() was called while it ran
+
+void ArRecurrentTask::runPooled()
+{
+  while (true)
+  {
+    task();
+    lock();
+    if (!go_req)
+    {
+      running = false;
+      myInPool = false;
+      unlock();
+      return;
+    }
+    go_req = false;
+    running = true;
+    unlock();
+  }
+}
+
 AREXPORT void ArRecurrentTask::go()
 {
   lock();
-  go_req = true;
   running = true;
   killed = false;
+  if (myPool == NULL)
+  {
+    go_req = true;
+    unlock();
+    return;
+  }
+  // already queued or running, so just have it run once more after
+  if (myInPool)
+  {
+    go_req = true;
+    unlock();
+    return;
+  }
+  go_req = false;
+  myInPool = true;
+  myPoolTask = myPool->submit(&myPoolCB);
+  if (myPoolTask == 0)
+  {
+    running = false;
+    killed = true;
+    myInPool = false;
+  }
   unlock();
 }
 
@@ -133,7 +196,13 @@ AREXPORT void ArRecurrentTask::reset()
 {
   lock();
   go_req = false;
-  if (running)			// async task is going, kill and restart
+  if (running && myPool != NULL) // can't interrupt a pool run, just drop it
+    {
+      killed = true;
+      running = false;
+      unlock();
+    }
+  else if (running)		// async task is going, kill and restart
     {
       killed = true;
       running = false;
@@ -152,5 +221,6 @@ AREXPORT void ArRecurrentTask::kill()
   killed = true;
   running = false;
   unlock();
-  cancel();
+  if (myPool == NULL)
+    cancel();
 }
@@ -0,0 +1,339 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArReplayDeviceConnection.h"
+#include "Aria/ArRecordingDeviceConnection.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <string.h>
+#include <thread>
+
+AREXPORT ArReplayDeviceConnection::ArReplayDeviceConnection() :
+  myStatus(STATUS_NEVER_OPENED),
+  mySpeed(1),
+  myReadIndex(0),
+  myReadOffset(0),
+  myWriteIndex(0),
+  myStarted(false),
+  myFirstReadUSecs(0),
+  myNumWrites(0),
+  myNumWriteMismatches(0)
+{
+  myMutex.setLogName("ArReplayDeviceConnection::myMutex");
+  setPortType("replay");
+}
+
+AREXPORT ArReplayDeviceConnection::~ArReplayDeviceConnection()
+{
+}
+
+static bool readVarint(FILE *file, unsigned long long *value)
+{
+  int c;
+  int shift = 0;
+  
+  *value = 0;
+  do
+  {
+    if ((c = fgetc(file)) == EOF || shift > 63)
+      return false;
+    *value |= (unsigned long long)(c & 0x7f) << shift;
+    shift += 7;
+  } while (c & 0x80);
+  return true;
+}
+
+/**
+   The whole recording is read into memory, so that playing it back
+   doesn't wait on the disk.
+**/
+AREXPORT int ArReplayDeviceConnection::open(const char *fileName)
+{
+  ArScopedLock lock(myMutex);
+  FILE *file;
+  char magic[ArRecordingDeviceConnection::FileMagicLength];
+  unsigned long long delta;
+  unsigned long long size;
+  long long usecs = 0;
+  Record record;
+  int c;
+
+  myFileName = fileName;
+  myRecords.clear();
+  myData.clear();
+  myStatus = STATUS_OPEN_FAILED;
+  setPortName(fileName);
+
+  if ((file = ArUtil::fopen(fileName, "rb")) == NULL)
+  {
+    ArLog::logErrorFromOS(ArLog::Terse, 
+			  "ArReplayDeviceConnection: Could not open %s", fileName);
+    return OPEN_FILE_NOT_FOUND;
+  }
+  if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+      memcmp(magic, ArRecordingDeviceConnection::FileMagic, 
+	     sizeof(magic)) != 0 ||
+      fgetc(file) != ArRecordingDeviceConnection::FileVersion)
+  {
+    ArLog::log(ArLog::Terse, 
+	       "ArReplayDeviceConnection: %s is not a device recording (or is from a different version)", 
+	       fileName);
+    fclose(file);
+    return OPEN_BAD_FORMAT;
+  }
+  while ((c = fgetc(file)) != EOF)
+  {
+    if (!readVarint(file, &delta) || !readVarint(file, &size))
+      break;
+    usecs += (long long)delta;
+    record.type = (char)c;
+    record.usecs = usecs;
+    record.offset = myData.size();
+    record.size = (size_t)size;
+    myData.resize(record.offset + record.size);
+    if (record.size > 0 && 
+	fread(&myData[record.offset], 1, record.size, file) != record.size)
+    {
+      myData.resize(record.offset);
+      break;
+    }
+    myRecords.push_back(record);
+  }
+  if (!feof(file))
+    ArLog::log(ArLog::Normal, 
+	       "ArReplayDeviceConnection: %s is truncated, using the first %lu records",
+	       fileName, (unsigned long)myRecords.size());
+  fclose(file);
+
+  myFirstReadUSecs = 0;
+  for (const Record &read : myRecords)
+  {
+    if (read.type != ArRecordingDeviceConnection::RecordWrite)
+    {
+      myFirstReadUSecs = read.usecs;
+      break;
+    }
+  }
+  myReadIndex = 0;
+  myReadOffset = 0;
+  myWriteIndex = 0;
+  myStarted = false;
+  myNumWrites = 0;
+  myNumWriteMismatches = 0;
+  myStatus = STATUS_OPEN;
+  ArLog::log(ArLog::Normal, 
+	     "ArReplayDeviceConnection: Loaded %lu records (%lu bytes, %.3f seconds) from %s",
+	     (unsigned long)myRecords.size(), (unsigned long)myData.size(),
+	     (double)usecs / 1000000.0, fileName);
+  return 0;
+}
+
+AREXPORT bool ArReplayDeviceConnection::close()
+{
+  ArScopedLock lock(myMutex);
+  myStatus = STATUS_CLOSED_NORMALLY;
+  return true;
+}
+
+AREXPORT void ArReplayDeviceConnection::setSpeed(double speed)
+{
+  ArScopedLock lock(myMutex);
+  mySpeed = speed > 0 ? speed : 0;
+}
+
+AREXPORT double ArReplayDeviceConnection::getSpeed() const
+{
+  ArScopedLock lock(myMutex);
+  return mySpeed;
+}
+
+AREXPORT void ArReplayDeviceConnection::rewind()
+{
+  ArScopedLock lock(myMutex);
+  myReadIndex = 0;
+  myReadOffset = 0;
+  myWriteIndex = 0;
+  myStarted = false;
+}
+
+AREXPORT bool ArReplayDeviceConnection::atEnd() const
+{
+  ArScopedLock lock(myMutex);
+  size_t i;
+  for (i = myReadIndex; i < myRecords.size(); i++)
+    if (myRecords[i].type != ArRecordingDeviceConnection::RecordWrite)
+      return false;
+  return true;
+}
+
+AREXPORT size_t ArReplayDeviceConnection::getNumRecords() const
+{
+  ArScopedLock lock(myMutex);
+  return myRecords.size();
+}
+
+AREXPORT long long ArReplayDeviceConnection::getRecordingUSecs() const
+{
+  ArScopedLock lock(myMutex);
+  if (myRecords.empty())
+    return 0;
+  return myRecords.back().usecs;
+}
+
+AREXPORT unsigned long ArReplayDeviceConnection::getNumWrites() const
+{
+  ArScopedLock lock(myMutex);
+  return myNumWrites;
+}
+
+AREXPORT unsigned long ArReplayDeviceConnection::getNumWriteMismatches() const
+{
+  ArScopedLock lock(myMutex);
+  return myNumWriteMismatches;
+}
+
+AREXPORT int ArReplayDeviceConnection::read(const char *data, 
+					    unsigned int size, 
+					    unsigned int msWait)
+{
+  std::chrono::steady_clock::time_point now;
+  std::chrono::steady_clock::time_point due;
+  const Record *record;
+  size_t num;
+  bool waited = false;
+
+  myMutex.lock();
+  if (myStatus != STATUS_OPEN)
+  {
+    myMutex.unlock();
+    return -1;
+  }
+  if (!myStarted)
+  {
+    myStartTime = std::chrono::steady_clock::now();
+    myStarted = true;
+  }
+  while (myReadIndex < myRecords.size() && 
+	 myRecords[myReadIndex].type == ArRecordingDeviceConnection::RecordWrite)
+    myReadIndex++;
+  if (myReadIndex >= myRecords.size())
+  {
+    myMutex.unlock();
+    return 0;
+  }
+  record = &myRecords[myReadIndex];
+
+  // wait until it's time for this data, if we're keeping the timing
+  while (mySpeed > 0)
+  {
+    due = myStartTime + std::chrono::microseconds(
+	    (long long)((double)(record->usecs - myFirstReadUSecs) / mySpeed));
+    now = std::chrono::steady_clock::now();
+    if (now >= due)
+      break;
+    if (waited || msWait == 0)
+    {
+      myMutex.unlock();
+      return 0;
+    }
+    myMutex.unlock();
+    std::this_thread::sleep_for(
+	    std::min<std::chrono::steady_clock::duration>(
+		    due - now, std::chrono::milliseconds(msWait)));
+    waited = true;
+    myMutex.lock();
+    // rewound or reopened while we slept
+    if (myReadIndex >= myRecords.size())
+    {
+      myMutex.unlock();
+      return 0;
+    }
+    record = &myRecords[myReadIndex];
+  }
+
+  if (record->type == ArRecordingDeviceConnection::RecordReadError)
+  {
+    myReadIndex++;
+    myMutex.unlock();
+    return -1;
+  }
+  num = record->size - myReadOffset;
+  if (num > size)
+    num = size;
+  memcpy(const_cast<char *>(data), &myData[record->offset + myReadOffset], num);
+  myReadOffset += num;
+  if (myReadOffset >= record->size)
+  {
+    myReadIndex++;
+    myReadOffset = 0;
+  }
+  myMutex.unlock();
+  return (int)num;
+}
+
+AREXPORT int ArReplayDeviceConnection::write(const char *data, 
+					     unsigned int size)
+{
+  ArScopedLock lock(myMutex);
+  
+  if (myStatus != STATUS_OPEN)
+    return -1;
+  while (myWriteIndex < myRecords.size() && 
+	 myRecords[myWriteIndex].type != ArRecordingDeviceConnection::RecordWrite)
+    myWriteIndex++;
+  myNumWrites++;
+  if (myWriteIndex >= myRecords.size() ||
+      myRecords[myWriteIndex].size != size ||
+      memcmp(&myData[myRecords[myWriteIndex].offset], data, size) != 0)
+    myNumWriteMismatches++;
+  if (myWriteIndex < myRecords.size())
+    myWriteIndex++;
+  return (int)size;
+}
+
+AREXPORT const char *ArReplayDeviceConnection::getOpenMessage(
+	int messageNumber)
+{
+  switch (messageNumber)
+  {
+  case OPEN_FILE_NOT_FOUND:
+    return "Could not open the recording";
+  case OPEN_BAD_FORMAT:
+    return "Not a device recording";
+  default:
+    return "No error";
+  }
+}
+
+AREXPORT ArTime ArReplayDeviceConnection::getTimeRead(int)
+{
+  ArTime now;
+  return now;
+}
+
+AREXPORT bool ArReplayDeviceConnection::isTimeStamping()
+{
+  return false;
+}
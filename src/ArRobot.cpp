@@ -29,6 +29,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 
 #include "Aria/ArRobot.h"
 #include "Aria/ArLog.h"
@@ -50,6 +51,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArBatteryMTX.h"
 #include "Aria/ArSonarMTX.h"
 #include "Aria/ArLCDMTX.h"
+#include "Aria/ArMetrics.h"
 
 
 /**
@@ -150,6 +152,7 @@ AREXPORT ArRobot::ArRobot(const char *name, UNUSED bool unused,
 
   myPacketsSentTracking = false;
   myPacketsReceivedTracking = false;
+  myPacketHandlerTableChanges = 0;
   myPacketsReceivedTrackingCount = false;
   myPacketsReceivedTrackingStarted.setToNow();
 
@@ -377,9 +380,9 @@ void ArRobot::setUpSyncList()
 
 void ArRobot::setUpPacketHandlers()
 {
-  addPacketHandler(&myMotorPacketCB, ArListPos::FIRST);
-  addPacketHandler(&myEncoderPacketCB, ArListPos::LAST);
-  addPacketHandler(&myIOPacketCB, ArListPos::LAST);
+  addPacketHandler(&myMotorPacketCB, {0x32, 0x33}, ArListPos::FIRST);
+  addPacketHandler(&myEncoderPacketCB, {0x90}, ArListPos::LAST);
+  addPacketHandler(&myIOPacketCB, {0xf0}, ArListPos::LAST);
 }
 
 void ArRobot::reset()
@@ -1044,19 +1047,10 @@ int ArRobot::asyncConnectHandler(bool tryHarderToConnect)
 
   if (myAsyncConnectState >= 3)
   {
-    bool handled = false;
-    //std::list<ArRetFunctor1<bool, ArRobotPacket *> *>::iterator it;
     while ((packet = myReceiver.receivePacket(0)) != NULL)
     {
       //printf("0x%x\n", packet->getID());
-      handled = false;
-      for (auto it = myPacketHandlerList.begin(); it != myPacketHandlerList.end() && handled == false; ++it)
-      {
-        if ((*it) != NULL && (*it)->invokeR(packet)) 
-          handled = true;
-        else
-          packet->resetRead();
-      }
+      dispatchPacket(packet);
     }
   }
 
@@ -2705,6 +2699,10 @@ AREXPORT const ArRobotConfigPacketReader *ArRobot::getOrigRobotConfig() const
    cannot interpret the packet, it should leave it unmodified and return
    false to allow other handlers a chance to receive it.
 
+   If your handler only wants packets with particular IDs, use the
+   addPacketHandler() overload that takes a list of packet IDs instead; then it
+   won't be invoked at all for other packets.
+
    @param functor the functor to call when the packet comes in
    @param position whether to place the functor first or last in the packet handler list
    @see remPacketHandler
@@ -2713,14 +2711,50 @@ AREXPORT void ArRobot::addPacketHandler(
 	ArRetFunctor1<bool, ArRobotPacket *> *functor, 
 	ArListPos::Pos position) 
 {
+  addPacketHandler(functor, std::vector<unsigned char>(), position);
+}
+
+/**
+   Adds a packet handler like addPacketHandler(ArRetFunctor1<bool, ArRobotPacket*>*, ArListPos::Pos),
+   except that it is only invoked with packets whose ID (see
+   ArRobotPacket::getID()) is one of @a packetIDs. ArRobot keeps a table of
+   handlers for each packet ID, so handlers interested in other packets cost
+   nothing when a packet arrives. Handlers are still tried in the order they
+   are in the handler list, whether or not they were given packet IDs.
+
+   E.g. <code>robot.addPacketHandler(&myHandlerCB, {0x90});</code>
+
+   @param functor the functor to call when the packet comes in
+   @param packetIDs the packet IDs to call @a functor for. If empty, @a functor
+   is called for all packets, the same as the other addPacketHandler().
+   @param position whether to place the functor first or last in the packet handler list
+   @see remPacketHandler
+**/
+AREXPORT void ArRobot::addPacketHandler(
+	ArRetFunctor1<bool, ArRobotPacket *> *functor, 
+	const std::vector<unsigned char> &packetIDs,
+	ArListPos::Pos position) 
+{
+  PacketHandlerInfo info;
+  info.functor = functor;
+  info.allIDs = packetIDs.empty();
+  for (std::vector<unsigned char>::const_iterator it = packetIDs.begin();
+       it != packetIDs.end(); ++it)
+    info.packetIDs.set(*it);
+  info.invoked = 0;
+  info.handled = 0;
+  info.usecs = 0;
+
   if (position == ArListPos::FIRST)
-    //myPacketHandlerList.push_front(functor);
-    myPacketHandlerList.insert(myPacketHandlerList.begin(), functor);
+    myPacketHandlerList.insert(myPacketHandlerList.begin(), info);
   else if (position == ArListPos::LAST)
-    myPacketHandlerList.push_back(functor);
+    myPacketHandlerList.push_back(info);
   else
+  {
     ArLog::log(ArLog::Terse, "ArRobot::addPacketHandler: Invalid position.");
-
+    return;
+  }
+  rebuildPacketHandlerTable();
 }
 
 /**
@@ -2730,9 +2764,88 @@ AREXPORT void ArRobot::addPacketHandler(
 AREXPORT void ArRobot::remPacketHandler(
 	ArRetFunctor1<bool, ArRobotPacket *> *functor)
 {
-  auto f = std::find(myPacketHandlerList.begin(), myPacketHandlerList.end(), functor);
-  if(f != myPacketHandlerList.end())
-    myPacketHandlerList.erase(f);
+  for (std::vector<PacketHandlerInfo>::iterator it = myPacketHandlerList.begin();
+       it != myPacketHandlerList.end(); ++it)
+  {
+    if ((*it).functor == functor)
+    {
+      myPacketHandlerList.erase(it);
+      rebuildPacketHandlerTable();
+      return;
+    }
+  }
+}
+
+void ArRobot::rebuildPacketHandlerTable()
+{
+  myPacketHandlerTableChanges++;
+  for (int id = 0; id < 256; ++id)
+    myPacketHandlerTable[id].clear();
+  for (std::vector<PacketHandlerInfo>::iterator it = myPacketHandlerList.begin();
+       it != myPacketHandlerList.end(); ++it)
+  {
+    if ((*it).functor == NULL)
+      continue;
+    for (size_t id = 0; id < 256; ++id)
+    {
+      if ((*it).allIDs || (*it).packetIDs.test(id))
+	myPacketHandlerTable[id].push_back(&(*it));
+    }
+  }
+}
+
+/**
+   Statistics are collected for every packet handler while packets are
+   handled; the robot should be locked while calling this.
+   @see logPacketHandlerStats()
+**/
+AREXPORT std::vector<ArRobot::PacketHandlerStats> ArRobot::getPacketHandlerStats() const
+{
+  std::vector<PacketHandlerStats> stats;
+  for (std::vector<PacketHandlerInfo>::const_iterator it = myPacketHandlerList.begin();
+       it != myPacketHandlerList.end(); ++it)
+  {
+    PacketHandlerStats s;
+    if ((*it).functor != NULL && (*it).functor->getName() != NULL)
+      s.name = (*it).functor->getName();
+    s.invoked = (*it).invoked;
+    s.handled = (*it).handled;
+    s.usecs = (*it).usecs;
+    stats.push_back(s);
+  }
+  return stats;
+}
+
+AREXPORT void ArRobot::resetPacketHandlerStats()
+{
+  for (std::vector<PacketHandlerInfo>::iterator it = myPacketHandlerList.begin();
+       it != myPacketHandlerList.end(); ++it)
+  {
+    (*it).invoked = 0;
+    (*it).handled = 0;
+    (*it).usecs = 0;
+  }
+}
+
+static bool comparePacketHandlerStatsTime(const ArRobot::PacketHandlerStats &a, 
+					  const ArRobot::PacketHandlerStats &b)
+{
+  return a.usecs > b.usecs;
+}
+
+/** The robot should be locked while calling this. */
+AREXPORT void ArRobot::logPacketHandlerStats(ArLog::LogLevel level) const
+{
+  std::vector<PacketHandlerStats> stats = getPacketHandlerStats();
+  std::stable_sort(stats.begin(), stats.end(), comparePacketHandlerStatsTime);
+  ArLog::log(level, "%s: Packet handler statistics (%lu handlers):", getName(),
+	     (unsigned long) stats.size());
+  for (std::vector<PacketHandlerStats>::const_iterator it = stats.begin();
+       it != stats.end(); ++it)
+    ArLog::log(level, "  %-40s invoked %8lu handled %8lu time %10.3f ms (%.1f us avg)",
+	       (*it).name.empty() ? "(unnamed)" : (*it).name.c_str(),
+	       (*it).invoked, (*it).handled, (double)(*it).usecs / 1000.0,
+	       ((*it).invoked > 0) ? (double)(*it).usecs / (double)(*it).invoked : 0.0);
 }
 
 /**
@@ -3409,6 +3522,8 @@ AREXPORT bool ArRobot::addAction(ArAction *action, int priority)
   action->setRobot(this);
   //myActions.insert(std::pair<int, ArAction *>(priority, action));
   myActions.insert(ArResolver::ActionMap::value_type{priority, action});
+  if (myResolver != NULL)
+    myResolver->actionsChanged();
   return true;
 }
 
@@ -3436,6 +3551,8 @@ AREXPORT bool ArRobot::remAction(const char *actionName)
   if (it != myActions.end())
   {
     myActions.erase(it);
+    if (myResolver != NULL)
+      myResolver->actionsChanged();
     return true;
   }
   return false;
@@ -3466,6 +3583,8 @@ AREXPORT bool ArRobot::remAction(ArAction *action)
   if (it != myActions.end())
   {
     myActions.erase(it);
+    if (myResolver != NULL)
+      myResolver->actionsChanged();
     return true;
   }
   return false;
@@ -4522,6 +4641,8 @@ bool ArRobot::handlePacket(ArRobotPacket *packet)
 
   lock();
 
+  countPacketMetrics(packet, false);
+
   if (myIgnoreNextPacket)
   {
     if ((packet->getID() == 0x32 || packet->getID() == 0x33))    
@@ -4534,6 +4655,7 @@ bool ArRobot::handlePacket(ArRobotPacket *packet)
     {
       ArLog::log(ArLog::Normal, "ArRobot: Ignoring packet of type 0x%x",		 packet->getID());
     }
+    countPacketMetrics(packet, true);
     unlock();
     return false;
   }
@@ -4589,30 +4711,120 @@ bool ArRobot::handlePacket(ArRobotPacket *packet)
     return false;
   }
 
-  bool handled = false;
-  for (auto it = myPacketHandlerList.begin(); 
-       it != myPacketHandlerList.end() && handled == false; 
-       ++it)
-  {
-    if ((*it) != NULL && (*it)->invokeR(packet)) 
-    {
-      if (myPacketsReceivedTracking)
-	      ArLog::log(ArLog::Normal, "Handled by %s", (*it)->getName());
-      handled = true;
-    }
-    else
-    {
-      packet->resetRead();
-    }
-  }
+  bool handled = dispatchPacket(packet);
   if (!handled)
+  {
     ArLog::log(ArLog::Normal, 
 	       "No packet handler wanted packet with ID: 0x%x", 
 	       packet->getID());
+    countPacketMetrics(packet, true);
+  }
   unlock();
   return handled;
 }
 
+/**
+   Adds one to the aria_robot_packets_received_total counter (or
+   aria_robot_packets_dropped_total if @a dropped) for the packet's ID,
+   registering it with ArMetrics the first time that ID comes in.  The
+   robot should be locked.
+**/
+void ArRobot::countPacketMetrics(ArRobotPacket *packet, bool dropped)
+{
+  ArMetricCounter *&metric = dropped ? 
+    myPacketsDroppedMetrics[packet->getID()] : 
+    myPacketsReceivedMetrics[packet->getID()];
+  if (metric == NULL)
+  {
+    char type[8];
+    snprintf(type, sizeof(type), "0x%02x", packet->getID());
+    std::string labels = ArMetrics::makeLabels("robot", getName(), "type", type);
+    if (dropped)
+      metric = ArMetrics::getCounter(
+	      "aria_robot_packets_dropped_total", 
+	      "Packets from the robot that were ignored or that no packet handler wanted",
+	      labels);
+    else
+      metric = ArMetrics::getCounter("aria_robot_packets_received_total", 
+				     "Packets received from the robot", labels);
+    if (metric == NULL)
+      return;
+  }
+  metric->add();
+}
+
+
+/**
+   Offers @a packet to each handler registered for its ID (in handler list
+   order) until one returns true, keeping count of the calls and the time
+   spent in each.
+**/
+bool ArRobot::dispatchPacket(ArRobotPacket *packet)
+{
+  const std::vector<PacketHandlerInfo *> &handlers = myPacketHandlerTable[packet->getID()];
+  // a handler may add or remove handlers, which rebuilds the table; then
+  // start over on the new table, skipping the handlers already tried
+  myPacketHandlersTried.clear();
+  bool rebuilt = false;
+  size_t i = 0;
+  while (i < handlers.size())
+  {
+    PacketHandlerInfo *info = handlers[i];
+    ArRetFunctor1<bool, ArRobotPacket *> *functor = info->functor;
+    if (rebuilt && std::find(myPacketHandlersTried.begin(), 
+			     myPacketHandlersTried.end(), functor) != 
+	myPacketHandlersTried.end())
+    {
+      ++i;
+      continue;
+    }
+    myPacketHandlersTried.push_back(functor);
+    unsigned int changes = myPacketHandlerTableChanges;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool handled = functor->invokeR(packet);
+    const long long usecs = 
+      std::chrono::duration_cast<std::chrono::microseconds>(
+	      std::chrono::steady_clock::now() - start).count();
+    // info may not be this handler's any more if the table was rebuilt,
+    // then find it again (unless it removed itself)
+    if (changes != myPacketHandlerTableChanges)
+    {
+      info = NULL;
+      for (std::vector<PacketHandlerInfo>::iterator it = 
+	     myPacketHandlerList.begin(); 
+	   it != myPacketHandlerList.end(); ++it)
+      {
+	if ((*it).functor == functor)
+	{
+	  info = &(*it);
+	  break;
+	}
+      }
+    }
+    if (info != NULL)
+    {
+      info->usecs += usecs;
+      info->invoked++;
+      if (handled)
+	info->handled++;
+    }
+    if (changes == myPacketHandlerTableChanges)
+      ++i;
+    else
+    {
+      rebuilt = true;
+      i = 0;
+    }
+    if (handled)
+    {
+      if (myPacketsReceivedTracking)
+	      ArLog::log(ArLog::Normal, "Handled by %s", functor->getName());
+      return true;
+    }
+    packet->resetRead();
+  }
+  return false;
+}
 
 /** @note You must first start the encoder packet stream by calling
  * requestEncoderPackets() before this function will return encoder values.
@@ -5644,9 +5856,57 @@ bool ArRobot::processMotorPacket(ArRobotPacket *packet)
   myInterpolation.addReading(packetTime, myGlobalPose);
   myEncoderInterpolation.addReading(myEncoderPose);
 
+  publishStateSnapshot();
+
   return true;
 }
 
+/**
+   Called at the end of processing each SIP (and by moveTo()). Readers in
+   other threads never block this, at worst they retry their copy.
+**/
+void ArRobot::publishStateSnapshot()
+{
+  StateSnapshot snapshot;
+  snapshot.sequence = (unsigned long)myStateSnapshot.getNumWrites() + 1;
+  snapshot.time = myRawEncoderPose.getTime();
+  snapshot.pose = myGlobalPose;
+  snapshot.encoderPose = myEncoderPose;
+  snapshot.rawEncoderPose = myRawEncoderPose;
+  snapshot.vel = myVel;
+  snapshot.rotVel = myRotVel;
+  snapshot.latVel = myLatVel;
+  snapshot.leftVel = myLeftVel;
+  snapshot.rightVel = myRightVel;
+  snapshot.batteryVoltage = getBatteryVoltage();
+  snapshot.realBatteryVoltage = getRealBatteryVoltage();
+  snapshot.stateOfCharge = getStateOfCharge();
+  snapshot.chargeState = getChargeState();
+  snapshot.stallValue = myStallValue;
+  snapshot.leftMotorStalled = isLeftMotorStalled();
+  snapshot.rightMotorStalled = isRightMotorStalled();
+  snapshot.flags = myFlags;
+  snapshot.faultFlags = myFaultFlags;
+  snapshot.estopPressed = isEStopPressed();
+  myStateSnapshot.write(snapshot);
+}
+
+/**
+   Returns a copy of the robot's pose, velocities, battery, charge and stall
+   state as they were at the end of processing the last SIP (or the last
+   moveTo()), all from the same cycle. Unlike getPose(), getVel() etc. this
+   may be called from any thread without locking the robot, and never
+   waits for the robot's sync loop (nor makes it wait).
+
+   Compare StateSnapshot::sequence (or poll getStateSnapshotSequence()) to
+   tell whether new data has arrived since the last call. If no SIP has been
+   processed yet the returned sequence is 0.
+**/
+AREXPORT ArRobot::StateSnapshot ArRobot::getStateSnapshot() const
+{
+  return myStateSnapshot.read();
+}
+
 void ArRobot::processNewSonar(int number, unsigned int range,
 				       ArTime timeReceived)
 {
@@ -5668,6 +5928,22 @@ void ArRobot::processNewSonar(int number, unsigned int range,
     sonar = (*it).second;
     sonar->newData(range, getPose(), getEncoderPose(), getToGlobalTransform(), 
 		   getCounter(), timeReceived); 
+
+    // remember which ones are new this cycle for getNewSonarReadings()
+    if (myNewSonarsCounter != getCounter())
+    {
+      myNewSonarNumbers.clear();
+      myNewSonarReadings.clear();
+      myNewSonarsCounter = getCounter();
+    }
+    std::vector<int>::iterator numIt = std::lower_bound(
+	    myNewSonarNumbers.begin(), myNewSonarNumbers.end(), number);
+    if (numIt == myNewSonarNumbers.end() || *numIt != number)
+    {
+      myNewSonarReadings.insert(myNewSonarReadings.begin() + 
+				(numIt - myNewSonarNumbers.begin()), sonar);
+      myNewSonarNumbers.insert(numIt, number);
+    }
 		 
     if (myTimeLastSonarPacket != time(NULL)) 
     {
@@ -5785,6 +6061,20 @@ AREXPORT ArSensorReading *ArRobot::getSonarReading(int num) const
     return NULL;
 }
 
+/**
+   This is the same as checking isSonarNew() for each of getNumSonar()
+   sonar, but only looks at the ones that got data, so it's cheaper on
+   robots with lots of sonar (ArSonarDevice uses it).  The same
+   ownership rules as getSonarReading() apply.
+**/
+AREXPORT const std::vector<ArSensorReading *> &ArRobot::getNewSonarReadings() const
+{
+  static const std::vector<ArSensorReading *> none;
+  if (myNewSonarsCounter != getCounter())
+    return none;
+  return myNewSonarReadings;
+}
+
 
 /**
    @param command the command number to send
@@ -6052,9 +6342,9 @@ AREXPORT bool ArRobot::hasRangeDevice(ArRangeDevice *device) const
  *  Find the closest reading from any range device's set of current readings
  *  within a polar region or "slice" defined by the given angle range.
  *  This function iterates through each registered range device (see 
- *  addRangeDevice()), calls ArRangeDevice::lockDevice(), uses
+ *  addRangeDevice()), calls ArRangeDevice::lockDeviceShared(), uses
  *  ArRangeDevice::currentReadingPolar() to find a reading, then calls
- *  ArRangeDevice::unlockDevice().
+ *  ArRangeDevice::unlockDeviceShared().
  *
  *  @copydoc ArRangeDevice::currentReadingPolar()
  *  @param rangeDevice If not null, then a pointer to the ArRangeDevice 
@@ -6078,10 +6368,10 @@ AREXPORT double ArRobot::checkRangeDevicesCurrentPolar(
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
     device = (*it);
-    device->lockDevice();
+    device->lockDeviceShared();
     if (!useLocationDependentDevices && device->isLocationDependent())
     {
-      device->unlockDevice();
+      device->unlockDeviceShared();
       continue;
     }
     if (!foundOne || 
@@ -6102,7 +6392,7 @@ AREXPORT double ArRobot::checkRangeDevicesCurrentPolar(
       }
       foundOne = true;
     }
-    device->unlockDevice();
+    device->unlockDeviceShared();
   }
   if (!foundOne)
     return -1;
@@ -6119,9 +6409,9 @@ AREXPORT double ArRobot::checkRangeDevicesCurrentPolar(
  *  Find the closest reading from any range device's set of cumulative readings
  *  within a polar region or "slice" defined by the given angle range.
  *  This function iterates through each registered range device (see 
- *  addRangeDevice()), calls ArRangeDevice::lockDevice(), uses
+ *  addRangeDevice()), calls ArRangeDevice::lockDeviceShared(), uses
  *  ArRangeDevice::cumulativeReadingPolar() to find a reading, then calls
- *  ArRangeDevice::unlockDevice().
+ *  ArRangeDevice::unlockDeviceShared().
  *
  *  @copydoc ArRangeDevice::cumulativeReadingPolar()
  *  @param rangeDevice If not null, then a pointer to the ArRangeDevice 
@@ -6143,10 +6433,10 @@ AREXPORT double ArRobot::checkRangeDevicesCumulativePolar(
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
     device = (*it);
-    device->lockDevice();
+    device->lockDeviceShared();
     if (!useLocationDependentDevices && device->isLocationDependent())
     {
-      device->unlockDevice();
+      device->unlockDeviceShared();
       continue;
     }
     if (!foundOne || 
@@ -6167,7 +6457,7 @@ AREXPORT double ArRobot::checkRangeDevicesCumulativePolar(
       }
       foundOne = true;
     }
-    device->unlockDevice();
+    device->unlockDeviceShared();
   }
   if (!foundOne)
     return -1;
@@ -6215,10 +6505,10 @@ AREXPORT double ArRobot::checkRangeDevicesCurrentBox(
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
     device = (*it);
-    device->lockDevice();
+    device->lockDeviceShared();
     if (!useLocationDependentDevices && device->isLocationDependent())
     {
-      device->unlockDevice();
+      device->unlockDeviceShared();
       continue;
     }
     if (!foundOne || 
@@ -6237,7 +6527,7 @@ AREXPORT double ArRobot::checkRangeDevicesCurrentBox(
       }
       foundOne = true;
     }
-    device->unlockDevice();
+    device->unlockDeviceShared();
   }
   if (!foundOne)
     return -1;
@@ -6285,10 +6575,10 @@ AREXPORT double ArRobot::checkRangeDevicesCumulativeBox(
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
     device = (*it);
-    device->lockDevice();
+    device->lockDeviceShared();
     if (!useLocationDependentDevices && device->isLocationDependent())
     {
-      device->unlockDevice();
+      device->unlockDeviceShared();
       continue;
     }
     if (!foundOne || 
@@ -6307,7 +6597,7 @@ AREXPORT double ArRobot::checkRangeDevicesCumulativeBox(
       }
       foundOne = true;
     }
-    device->unlockDevice();
+    device->unlockDeviceShared();
   }
   if (!foundOne)
     return -1;
@@ -6344,6 +6634,7 @@ AREXPORT void ArRobot::moveTo(ArPose pose, bool doCumulative)
   myEncoderTransform.setTransform(myEncoderPose, pose);
   myGlobalPose = myEncoderTransform.doTransform(myEncoderPose);
   mySetEncoderTransformCBList.invoke();
+  publishStateSnapshot();
 
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
@@ -6398,6 +6689,7 @@ AREXPORT void ArRobot::moveTo(ArPose poseTo, ArPose poseFrom,
   myEncoderTransform.setTransform(result, poseTo);
   myGlobalPose = myEncoderTransform.doTransform(myEncoderPose);
   mySetEncoderTransformCBList.invoke();
+  publishStateSnapshot();
 
   for (auto it = myRangeDeviceVector.begin(); it != myRangeDeviceVector.end(); ++it)
   {
@@ -40,7 +40,7 @@ AREXPORT ArRobotBatteryPacketReader::ArRobotBatteryPacketReader(
   myRequestedBatteryPackets = false;
   myPacketHandlerCB.setName("ArRobotBatteryPacketReader");
   myConnectCB.setName("ArRobotBatteryPacketReader");
-  myRobot->addPacketHandler(&myPacketHandlerCB);
+  myRobot->addPacketHandler(&myPacketHandlerCB, {0xfa});
   myRobot->addConnectCB(&myConnectCB);
 }
 
@@ -45,7 +45,7 @@ AREXPORT ArRobotConfigPacketReader::ArRobotConfigPacketReader(
 {
   myRobot = robot;
   myPacketHandlerCB.setName("ArRobotConfigPacketReader");
-  myRobot->addPacketHandler(&myPacketHandlerCB);
+  myRobot->addPacketHandler(&myPacketHandlerCB, {0x20});
   myRobot->addConnectCB(&myConnectedCB);
   myOnlyOneRequest = onlyOneRequest;
   myPacketRequested = false;
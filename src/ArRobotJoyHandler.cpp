@@ -38,7 +38,7 @@ AREXPORT ArRobotJoyHandler::ArRobotJoyHandler(ArRobot *robot) :
 
   myHandleJoystickPacketCB.setName("ArRobotJoyHandler");
   myRobot->addConnectCB(&myConnectCB);
-  myRobot->addPacketHandler(&myHandleJoystickPacketCB, ArListPos::FIRST);
+  myRobot->addPacketHandler(&myHandleJoystickPacketCB, {0xF8}, ArListPos::FIRST);
   if (myRobot->isConnected())
     connectCallback();
 
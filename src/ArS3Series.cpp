@@ -714,7 +714,7 @@ void ArS3Series::setRobot(ArRobot *robot) {
 		myRobot->remSensorInterpTask(&mySensorInterpTask);
 		myRobot->addSensorInterpTask("S3Series", 90, &mySensorInterpTask);
 		myRobot->remPacketHandler(&myPacketHandlerCB);
-		myRobot->addPacketHandler(&myPacketHandlerCB);
+		myRobot->addPacketHandler(&myPacketHandlerCB, {0xd9});
 	}
 	ArLaser::setRobot(robot);
 }
@@ -936,26 +936,6 @@ void ArS3Series::sensorInterp() {
 			continue;
 		}
 
-		// If we don't have any sensor readings created at all, make 'em all
-		if (myRawReadings->size() == 0)
-			for (size_t j = 0; j < eachNumberData; j++)
-				myRawReadings->push_back(new ArSensorReading);
-
-		if (eachNumberData > myRawReadings->size())
-		{
-			ArLog::log(ArLog::Terse,
-					"%s::sensorInterp() Bad data, in theory have %d readings but can only have 541... skipping this packet",
-					getName(), eachNumberData);
-
-			// PS 12/6/12 - need to unlock and delete packet
-			myDataMutex.unlock();
-			/// MPL 2013_07_24 testing (commented out)
-			//unlockDevice();
-			delete packet;
-
-			continue;
-		}
-
 		std::list<ArSensorReading *>::iterator it;
 		double atDeg;
 		size_t onReading;
@@ -978,6 +958,11 @@ void ArS3Series::sensorInterp() {
 			increment = eachAngularStepWidth;
 		}
 
+		// make sure there's a reading for each beam, this only does the
+		// sin/cos when the scan's geometry changes (the interpolating
+		// below moves each reading off it with laserMoveBeam())
+		laserSetBeams(eachNumberData, start, increment);
+
 		int readingIndex;
 		bool ignore = false;
 
@@ -1036,7 +1021,7 @@ void ArS3Series::sensorInterp() {
 			    packet->getNumReadings());
 		  */
 
-		  ArLog::log(ArLog::Normal, 
+		  ArLog::log(ArLog::Verbose, 
    "%s:InterpolateReadings: diffAll of %d mSec, x %g y %g th %g (incr x %g y %g th %g) start x %g y %g th %g end x %g y %g th %g",
 			     getName(), 
 			     timeEnd.mSecSince(time), 
@@ -1051,7 +1036,7 @@ void ArS3Series::sensorInterp() {
 			     encoderPoseEnd.getTh());
 
 		  
-		  ArLog::log(ArLog::Normal, 
+		  ArLog::log(ArLog::Verbose, 
    "%s:InterpolateReadings: diffTh of %d mSec, th %g (%g) start th %g end th %g",
 			     getName(), 
 			     timeEnd.mSecSince(time), 
@@ -1101,23 +1086,23 @@ void ArS3Series::sensorInterp() {
 				     interpolateDelta.getTh());
 			  */
 
-			  reading->resetSensorPosition(
+			  laserMoveBeam(
+				  onReading,
 				  ArMath::roundInt(mySensorPose.getX() + 
 						   interpolateDelta.getX()),
 				  ArMath::roundInt(mySensorPose.getY() + 
 						   interpolateDelta.getY()),
 				  ArMath::addAngle(atDeg,
 						   interpolateDelta.getTh()));
+			  reading->newData(dist, pose, encoderPose, transform, counter, 
+					   time, ignore, 0); // no reflector yet
 			}
 			else
 			{
-			  reading->resetSensorPosition(
-				  ArMath::roundInt(mySensorPose.getX()),
-				  ArMath::roundInt(mySensorPose.getY()), 
-				  atDeg);
+			  myBeamRanges[onReading] = dist;
+			  myBeamIgnore[onReading] = ignore;
+			  myBeamExtraInts[onReading] = 0; // no reflector yet
 			}
-			reading->newData(dist, pose, encoderPose, transform, counter, time,
-					ignore, 0); // no reflector yet
 
 			//printf("dist = %d, pose = %d, encoderPose = %d, transform = %d, counter = %d, time = %d, ignore = %d",
 			//		dist, pose, encoderPose, transform, counter,
@@ -1129,6 +1114,8 @@ void ArS3Series::sensorInterp() {
 		 packet->getCommandType(), packet->getCommandName(), 
 		 myScanCounter, onReading);
 		 */
+		if (!interpolateReadings)
+		  laserFillBeams(pose, encoderPose, transform, counter, time);
 
 		myDataMutex.unlock();
 
@@ -678,9 +678,6 @@ void ArSZSeries::sensorInterp() {
 		lockDevice();
 		myDataMutex.lock();
 
-		//std::list<ArSensorReading *>::reverse_iterator it;
-		ArSensorReading *reading;
-
 		myNumChans = packet->getNumReadings();
 
 		size_t eachNumberData = 0;
@@ -705,28 +702,6 @@ void ArSZSeries::sensorInterp() {
 			continue;
 		}
 
-		// If we don't have any sensor readings created at all, make 'em all
-		if (myRawReadings->size() == 0) {
-			for (size_t j = 0; j < eachNumberData; j++) {
-				myRawReadings->push_back(new ArSensorReading);
-			}
-		}
-
-		if (eachNumberData > myRawReadings->size())
-		{
-			ArLog::log(ArLog::Terse,
-					"%s::sensorInterp() Bad data, in theory have %d readings but can only have 751... skipping this packet",
-					getName(), eachNumberData);
-
-			// PS 12/6/12 - unlock and delete before continuing
-
-			delete packet;
-			myDataMutex.unlock();
-			unlockDevice();
-			continue;
-		}
-
-
 		double start;
 		double increment;
 
@@ -740,24 +715,20 @@ void ArSZSeries::sensorInterp() {
 			increment = eachAngularStepWidth;
 		}
 
+		// make sure there's a reading for each beam, this only does the
+		// sin/cos when the scan's geometry changes
+		laserSetBeams(eachNumberData, start, increment);
+
 		const bool ignore = false;
-		double atDeg = start;
-		std::list<ArSensorReading *>::const_iterator it = myRawReadings->begin();
 		int readingIndex = 0;
 		size_t onReading = 0;
 		for (;
 
 				onReading < eachNumberData;
 
-				atDeg += increment,
-				++it,
 				++readingIndex,
 				++onReading)
 		{
-
-
-			reading = (*it);
-
 			dist = (unsigned int) (((buf[readingIndex * 2] & 0x3f)<< 8) | (buf[(readingIndex * 2) + 1]));
 
 			// note max distance is 16383 mm, if the measurement
@@ -768,10 +739,9 @@ void ArSZSeries::sensorInterp() {
 			readingIndex, buf[(readingIndex *2)+1], buf[readingIndex], dist);
             */
 
-			reading->resetSensorPosition(ArMath::roundInt(mySensorPose.getX()),
-					ArMath::roundInt(mySensorPose.getY()), atDeg);
-			reading->newData(dist, pose, encoderPose, transform, counter, time,
-					ignore, 0); // no reflector yet
+			myBeamRanges[onReading] = dist;
+			myBeamIgnore[onReading] = ignore;
+			myBeamExtraInts[onReading] = 0; // no reflector yet
 
 			//printf("dist = %d, pose = %d, encoderPose = %d, transform = %d, counter = %d, time = %d, igore = %d",
 			//		dist, pose, encoderPose, transform, counter,
@@ -783,6 +753,7 @@ void ArSZSeries::sensorInterp() {
 		 packet->getCommandType(), packet->getCommandName(), 
 		 myScanCounter, onReading);
 */
+		laserFillBeams(pose, encoderPose, transform, counter, time);
 
 		myDataMutex.unlock();
 
@@ -42,7 +42,7 @@ AREXPORT ArSeekurIMU::ArSeekurIMU(ArRobot *robot) :
   myPos[X] = myPos[Y] = myPos[Z] = 0.0;
 
   myHandleIMUPacketCB.setName("ArSeekurIMU");
-  myRobot->addPacketHandler(&myHandleIMUPacketCB);
+  myRobot->addPacketHandler(&myHandleIMUPacketCB, {0x9A});
   myRobot->addStabilizingCB(&myStabilizingCB);
 
   if (myRobot->isConnected())
@@ -82,6 +82,24 @@ AREXPORT void ArSensorReading::newData(int sx, int sy, const ArPose& robotPose,
 }
 
 
+AREXPORT void ArSensorReading::newDataPrecomputed(
+	unsigned int range, const ArPose& localReading, const ArPose& reading,
+	const ArPose& robotPose, const ArPose& encoderPose, 
+	unsigned int counter, const ArTime& timeTaken, 
+	bool ignoreThisReading, int extraInt)
+{
+  myRange = range;
+  myCounterTaken = counter;
+  myReadingTaken = robotPose;
+  myEncoderPoseTaken = encoderPose;
+  myLocalReading = localReading;
+  myReading = reading;
+  myTimeTaken = timeTaken;
+  myIgnoreThisReading = ignoreThisReading;
+  myExtraInt = extraInt;
+  myAdjusted = false;
+}
+
 /**
    @param xPos the x position of the sensor on the robot (mm)
    @param yPos the y position of the sensor on the robot (mm)
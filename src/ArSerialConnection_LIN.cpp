@@ -595,6 +595,11 @@ AREXPORT ArTime ArSerialConnection::getTimeRead(int index)
   return ret;
 }
 
+AREXPORT int ArSerialConnection::getFD() const
+{
+  return myPort;
+}
+
 AREXPORT bool ArSerialConnection::isTimeStamping()
 {
   return myTakingTimeStamps;
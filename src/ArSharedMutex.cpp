@@ -0,0 +1,331 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArSharedMutex.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ArLog.h"
+#include "Aria/ArThread.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+
+// How many shared locks this thread holds on an ArSharedMutex, and when
+// (on the profiler's clock) it took the first one, or -1 if that lock
+// wasn't profiled
+struct ArSharedMutex::SharedHeld
+{
+  const ArSharedMutex *mutex;
+  int depth;
+  long long lockedUSecs;
+};
+
+// The shared locks this thread holds.  A thread rarely holds more than a
+// couple, so this is just searched.
+static thread_local std::vector<ArSharedMutex::SharedHeld> ourSharedHeld;
+
+AREXPORT ArSharedMutex::ArSharedMutex() :
+  myLogName("(unnamed)")
+{
+}
+
+AREXPORT ArSharedMutex::~ArSharedMutex()
+{
+}
+
+AREXPORT void ArSharedMutex::setLogNameVar(const char *logName, ...)
+{
+  char arg[2048];
+  va_list ptr;
+  va_start(ptr, logName);
+  vsnprintf(arg, sizeof(arg), logName, ptr);
+  arg[sizeof(arg) - 1] = '\0';
+  va_end(ptr);
+  setLogName(arg);
+}
+
+ArSharedMutex::SharedHeld *ArSharedMutex::threadSharedHeld(bool create)
+{
+  for (auto &held : ourSharedHeld)
+    if (held.mutex == this)
+      return &held;
+  if (!create)
+    return NULL;
+  SharedHeld held = { this, 0, -1 };
+  ourSharedHeld.push_back(held);
+  return &ourSharedHeld.back();
+}
+
+void ArSharedMutex::logLockTime(const ArTime &started, const char *mode)
+{
+  const unsigned int warningMS = 
+    (unsigned int)(ArMutex::getLockWarningTime() * 1000.0);
+  if (warningMS > 0 && started.mSecSince() >= warningMS)
+    ArLog::logNoLock(ArLog::Normal, 
+		     "LockWarning: locking '%s' %s from thread '%s' took %.3f sec",
+		     myLogName.c_str(), mode, ArThread::getThisThreadName(),
+		     (double) started.mSecSince() / 1000.0);
+}
+
+void ArSharedMutex::profileLocked(bool contended, long long waitUSecs)
+{
+  ArMutex::ProfileEntry *entry = myProfile.load(std::memory_order_relaxed);
+  if (entry == NULL)
+  {
+    entry = ArMutex::getProfileEntry(myLogName);
+    myProfile.store(entry, std::memory_order_relaxed);
+  }
+  ArMutex::profileAddLock(entry, contended, waitUSecs);
+}
+
+int ArSharedMutex::internalLock(std::unique_lock<std::mutex> &state, 
+				bool block, bool profiling, bool *waited)
+{
+  if (isWriter())
+  {
+    myWriteDepth++;
+    return 0;
+  }
+  SharedHeld *held = threadSharedHeld(false);
+  if (held != NULL && held->depth > 0)
+  {
+    ArLog::logNoLock(ArLog::Terse, 
+		     "ArSharedMutex: '%s' can't be locked exclusively by thread '%s' while it holds a shared lock, that would deadlock", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+    return ArMutex::STATUS_FAILED;
+  }
+  if (myWriting || myReaders > 0)
+  {
+    if (!block)
+      return ArMutex::STATUS_ALREADY_LOCKED;
+    *waited = true;
+    myWritersWaiting++;
+    myWritersCond.wait(state, [this] { return !myWriting && myReaders == 0; });
+    myWritersWaiting--;
+  }
+  myWriting = true;
+  myWriter = std::this_thread::get_id();
+  myWriteDepth = 1;
+  myProfileWriteLockedUSecs = profiling ? ArMutex::profileNow() : -1;
+  if (ArMutex::getUnlockWarningTime() > 0)
+    myWriteLocked.setToNow();
+  return 0;
+}
+
+int ArSharedMutex::internalUnlock(long long *holdUSecs)
+{
+  *holdUSecs = -1;
+  if (!isWriter())
+  {
+    ArLog::logNoLock(ArLog::Terse, 
+		     "ArSharedMutex: '%s' unlocked by thread '%s' which does not hold its exclusive lock", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+    return ArMutex::STATUS_FAILED;
+  }
+  if (--myWriteDepth > 0)
+    return 0;
+  const unsigned int warningMS = 
+    (unsigned int)(ArMutex::getUnlockWarningTime() * 1000.0);
+  if (warningMS > 0 && myWriteLocked.mSecSince() >= warningMS)
+    ArLog::logNoLock(ArLog::Normal, 
+		     "LockWarning: unlocking '%s' from thread '%s' was locked for %.3f sec",
+		     myLogName.c_str(), ArThread::getThisThreadName(),
+		     (double) myWriteLocked.mSecSince() / 1000.0);
+  if (myProfileWriteLockedUSecs >= 0)
+    *holdUSecs = ArMutex::profileNow() - myProfileWriteLockedUSecs;
+  myWriting = false;
+  myWriter = std::thread::id();
+  // another writer goes next if there is one, otherwise all the readers
+  if (myWritersWaiting > 0)
+    myWritersCond.notify_one();
+  else
+    myReadersCond.notify_all();
+  return 0;
+}
+
+int ArSharedMutex::internalLockShared(std::unique_lock<std::mutex> &state,
+				      bool block, bool profiling, bool *waited)
+{
+  // the writer can read too
+  if (isWriter())
+  {
+    myWriteDepth++;
+    return 0;
+  }
+  SharedHeld *held = threadSharedHeld(false);
+  // a thread that already has a shared lock doesn't wait for writers,
+  // since they're waiting for it
+  if (held == NULL || held->depth == 0)
+  {
+    if (myWriting || myWritersWaiting > 0)
+    {
+      if (!block)
+	return ArMutex::STATUS_ALREADY_LOCKED;
+      *waited = true;
+      myReadersCond.wait(state, 
+		     [this] { return !myWriting && myWritersWaiting == 0; });
+    }
+    held = threadSharedHeld(true);
+    held->lockedUSecs = profiling ? ArMutex::profileNow() : -1;
+  }
+  held->depth++;
+  myReaders++;
+  return 0;
+}
+
+AREXPORT int ArSharedMutex::lock()
+{
+  if (myLog)
+    ArLog::logNoLock(ArLog::Terse, "Locking '%s' from thread '%s'", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+  const bool profiling = ArMutex::profileThisLock();
+  const long long waitStart = profiling ? ArMutex::profileNow() : 0;
+  bool waited = false;
+  std::unique_lock<std::mutex> state(myStateMutex);
+  if (ArMutex::getLockWarningTime() <= 0 && !profiling)
+    return internalLock(state, true, false, &waited);
+  ArTime started;
+  int ret = internalLock(state, true, profiling, &waited);
+  state.unlock();
+  logLockTime(started, "exclusively");
+  if (profiling && ret == 0)
+    profileLocked(waited, waited ? ArMutex::profileNow() - waitStart : 0);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::tryLock()
+{
+  const bool profiling = ArMutex::profileThisLock();
+  bool waited = false;
+  std::unique_lock<std::mutex> state(myStateMutex);
+  int ret = internalLock(state, false, profiling, &waited);
+  state.unlock();
+  if (profiling && ret == 0)
+    profileLocked(false, 0);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::unlock()
+{
+  if (myLog)
+    ArLog::logNoLock(ArLog::Terse, "Unlocking '%s' from thread '%s'", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+  long long holdUSecs;
+  int ret;
+  {
+    std::lock_guard<std::mutex> state(myStateMutex);
+    ret = internalUnlock(&holdUSecs);
+  }
+  if (holdUSecs >= 0)
+    ArMutex::profileAddHold(myProfile.load(std::memory_order_relaxed), 
+			    holdUSecs);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::lockShared()
+{
+  if (myLog)
+    ArLog::logNoLock(ArLog::Terse, "Locking '%s' shared from thread '%s'", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+  const bool profiling = ArMutex::profileThisLock();
+  const long long waitStart = profiling ? ArMutex::profileNow() : 0;
+  bool waited = false;
+  std::unique_lock<std::mutex> state(myStateMutex);
+  if (ArMutex::getLockWarningTime() <= 0 && !profiling)
+    return internalLockShared(state, true, false, &waited);
+  ArTime started;
+  int ret = internalLockShared(state, true, profiling, &waited);
+  state.unlock();
+  logLockTime(started, "shared");
+  if (profiling && ret == 0)
+    profileLocked(waited, waited ? ArMutex::profileNow() - waitStart : 0);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::tryLockShared()
+{
+  const bool profiling = ArMutex::profileThisLock();
+  bool waited = false;
+  std::unique_lock<std::mutex> state(myStateMutex);
+  int ret = internalLockShared(state, false, profiling, &waited);
+  state.unlock();
+  if (profiling && ret == 0)
+    profileLocked(false, 0);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::unlockShared()
+{
+  if (myLog)
+    ArLog::logNoLock(ArLog::Terse, "Unlocking '%s' shared from thread '%s'", 
+		     myLogName.c_str(), ArThread::getThisThreadName());
+  long long holdUSecs = -1;
+  int ret = 0;
+  {
+    std::lock_guard<std::mutex> state(myStateMutex);
+    // the writer's shared locks were counted as exclusive ones
+    if (isWriter())
+      ret = internalUnlock(&holdUSecs);
+    else
+    {
+      SharedHeld *held = threadSharedHeld(false);
+      if (held == NULL || held->depth == 0)
+      {
+	ArLog::logNoLock(ArLog::Terse, 
+			 "ArSharedMutex: '%s' unlocked shared by thread '%s' which does not hold a shared lock", 
+			 myLogName.c_str(), ArThread::getThisThreadName());
+	return ArMutex::STATUS_FAILED;
+      }
+      if (--held->depth == 0)
+      {
+	if (held->lockedUSecs >= 0)
+	  holdUSecs = ArMutex::profileNow() - held->lockedUSecs;
+	for (auto it = ourSharedHeld.begin(); it != ourSharedHeld.end(); ++it)
+	  if ((*it).mutex == this)
+	  {
+	    ourSharedHeld.erase(it);
+	    break;
+	  }
+      }
+      if (--myReaders == 0 && myWritersWaiting > 0)
+	myWritersCond.notify_one();
+    }
+  }
+  if (holdUSecs >= 0)
+    ArMutex::profileAddHold(myProfile.load(std::memory_order_relaxed), 
+			    holdUSecs);
+  return ret;
+}
+
+AREXPORT int ArSharedMutex::getSharedCount()
+{
+  std::lock_guard<std::mutex> state(myStateMutex);
+  return myReaders;
+}
+
+AREXPORT bool ArSharedMutex::isLockedExclusive()
+{
+  std::lock_guard<std::mutex> state(myStateMutex);
+  return myWriting;
+}
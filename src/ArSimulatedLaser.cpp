@@ -194,7 +194,7 @@ AREXPORT bool ArSimulatedLaser::blockingConnect()
 
   mySimPacketHandler.setName(getName());
   myRobot->remPacketHandler(&mySimPacketHandler);
-  myRobot->addPacketHandler(&mySimPacketHandler, ArListPos::LAST);
+  myRobot->addPacketHandler(&mySimPacketHandler, {0x60, 0x61}, ArListPos::LAST);
 
   bool failed = false;
   bool robotIsRunning = myRobot->isRunning();
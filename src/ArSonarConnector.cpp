@@ -52,6 +52,7 @@ AREXPORT ArSonarConnector::ArSonarConnector (
   ArLog::LogLevel infoLogLevel,
   ArRetFunctor1<bool, const char *> *turnOnPowerOutputCB,
   ArRetFunctor1<bool, const char *> *turnOffPowerOutputCB) :
+	myConnectGroup ("ArSonarConnector"),
 	myParseArgsCB (this, &ArSonarConnector::parseArgs),
 	myLogOptionsCB (this, &ArSonarConnector::logOptions)
 {
@@ -672,6 +673,7 @@ AREXPORT bool ArSonarConnector::connectSonars (
 {
 	std::map<int, SonarData *>::iterator it;
 	SonarData *sonarData = NULL;
+	bool ret = true;
 	ArLog::log (myInfoLogLevel,
 	            "ArSonarConnector::connectSonars() Connecting sonars... myAutoParseArgs=%d myParsedArgs=%d addAllSonarsToRobot=%d", myAutoParseArgs, myParsedArgs, addAllSonarsToRobot);
 
@@ -701,6 +703,7 @@ AREXPORT bool ArSonarConnector::connectSonars (
 	}
 
   ArLog::log(myInfoLogLevel, "ArSonarConnector::connectSonars(), finally connecting to each sonar...");
+	myConnectGroup.clear();
 	for (it = mySonars.begin(); it != mySonars.end(); ++it) {
 		sonarData = (*it).second;
 		if ( (sonarData == NULL) || (myRobot == NULL))
@@ -719,8 +722,6 @@ AREXPORT bool ArSonarConnector::connectSonars (
     );
 //}
 
-		bool connected = false;
-
 		if (sonarData->myConnectReallySet && sonarData->myConnect) {
 
 			if(turnOnSonars)
@@ -731,12 +732,21 @@ AREXPORT bool ArSonarConnector::connectSonars (
 			            "ArSonarConnector::connectSonars() Connecting %s",
 			            sonarData->mySonar->getName());
 			sonarData->mySonar->setRobot (myRobot);
-			// to turn on packet tracing - uncomment
-			//connected = sonarData->mySonar->blockingConnect(true, true);
-			connected = sonarData->mySonar->blockingConnect (mySonarLogPacketsSent, mySonarLogPacketsReceived);
-		
+			myConnectGroup.addDevice (sonarData->mySonar->getName(),
+			                          sonarData->myNumber,
+			                          new ArRetFunctor1C<bool, ArSonarConnector, SonarData *> (
+			                            this, &ArSonarConnector::internalConnectSonar, sonarData));
+		}
+	}
 
-		if (connected) {
+	// now connect them all at once (unless the group was set not to)
+	myConnectGroup.connectAll();
+	myConnectGroup.logResults (myInfoLogLevel);
+
+	for (const ArDeviceConnectGroup::ConnectResult &result :
+	     myConnectGroup.getResults()) {
+		sonarData = mySonars[result.number];
+		if (result.connected) {
 			if (!addAllSonarsToRobot && addConnectedSonarsToRobot) {
 				if (myRobot != NULL) {
 					myRobot->addSonar (sonarData->mySonar, sonarData->myNumber);
@@ -764,20 +774,31 @@ AREXPORT bool ArSonarConnector::connectSonars (
 		} else {
 			if (!continueOnFailedConnect) {
 				ArLog::log (ArLog::Normal,
-				            "ArSonarConnector::connectSonars() Could not connect %s, stopping",
+				            "ArSonarConnector::connectSonars() Could not connect %s, failing",
 				            sonarData->mySonar->getName());
-				return false;
+				ret = false;
 			} else
 				ArLog::log (ArLog::Normal,
 				            "ArSonarConnector::connectSonars() Could not connect %s, continuing with remainder of sonars",
 				            sonarData->mySonar->getName());
 		}
 	}
-	}
 
 	ArLog::log (myInfoLogLevel,
             "ArSonarConnector() Done connecting sonars");
-	return true;
+	return ret;
+}
+
+/**
+   Makes one connection attempt for a sonar board, this is what
+   connectSonars() has myConnectGroup call for each board, so it is
+   run in that board's own thread.
+   @internal
+**/
+bool ArSonarConnector::internalConnectSonar (SonarData *sonarData)
+{
+	// to turn on packet tracing - pass true, true
+	return sonarData->mySonar->blockingConnect (mySonarLogPacketsSent, mySonarLogPacketsReceived);
 }
 
 AREXPORT bool ArSonarConnector::turnOnPower(SonarData *sonarData)
@@ -77,28 +77,31 @@ AREXPORT void ArSonarDevice::setRobot(ArRobot *robot)
 
 AREXPORT void ArSonarDevice::processReadings()
 {
-  int i;
-  ArSensorReading *reading;
   lockDevice();
 
-  for (i = 0; i < myRobot->getNumSonar(); i++)
+  // ArRobot keeps track of which sonar got new readings this cycle (see
+  // ArRobot::processNewSonar()), so we only look at those.  Each
+  // ArSensorReading has the X,Y position of the obstacle that sonar
+  // most recently saw, worked out from its range and the position of
+  // the sonar on the robot.  We collect them all and then add them to
+  // the buffers at once.
+  const std::vector<ArSensorReading *> &newReadings = 
+    myRobot->getNewSonarReadings();
+  myBatchXs.clear();
+  myBatchYs.clear();
+  for (ArSensorReading *reading : newReadings)
   {
-    // Get a reference to the ArSensorReading object for sonar sensor #i, which
-    // will provide an X,Y position and timestamp for the most recently received
-    // obstacle detected by that sonar sensor. ArRobot created a set of 
-    // ArSensorReading objects for each sonar sensor  when it connected to the 
-    // robot, configured them with the position of the sonar sensor relative to the
-    // center of the robot. It calls ArSensorReading::newData() when new sonar
-    // data is received to cause the ArSensorReading object to update the X,Y
-    // position based on the range value received from the sonar sensor.
-
-    reading = myRobot->getSonarReading(i);
     if (reading == NULL || !reading->isNew(myRobot->getCounter()))
       continue;
     // make sure we don't want to ignore the reading
-    if (myIgnoreReadingCB == NULL || !myIgnoreReadingCB->invokeR(reading->getPose()))
-      addReading(reading->getX(), reading->getY());
+    if (myIgnoreReadingCB != NULL && 
+	myIgnoreReadingCB->invokeR(reading->getPose()))
+      continue;
+    myBatchXs.push_back(reading->getX());
+    myBatchYs.push_back(reading->getY());
   }
+  if (!myBatchXs.empty())
+    addReadings(myBatchXs.data(), myBatchYs.data(), myBatchXs.size());
 
   // delete too-far readings
   myCumulativeBuffer.beginInvalidationSweep();
@@ -164,6 +167,106 @@ AREXPORT void ArSonarDevice::addReading(double x, double y, bool *wasAdded)
 }
 
 
+AREXPORT void ArSonarDevice::addReadings(const double *xs, 
+					 const double *ys, size_t num)
+{
+  const double rx = myRobot->getX();
+  const double ry = myRobot->getY();
+  const double maxRange2 = (double)myMaxRange * (double)myMaxRange;
+  const double cumulative2 = myMaxDistToKeepCumulative * 
+    myMaxDistToKeepCumulative;
+  const double near2 = myFilterNearDist * myFilterNearDist;
+  double dx, dy, d2;
+  bool anyCumulative = false;
+  size_t i, j;
+
+  myBatchCurrent.assign(num, 1);
+  myBatchCumulative.resize(num);
+  myBatchKeepCumulative.resize(num);
+
+  // take out the ones in ignore regions, one pass per region
+  for (const IgnoreRegion &region : myIgnoreRegions)
+    for (i = 0; i < num; i++)
+      myBatchCurrent[i] &= (char)!((xs[i] >= region.x1) & (xs[i] <= region.x2) &
+				   (ys[i] >= region.y1) & (ys[i] <= region.y2));
+
+  // which ones are close enough to the robot for each buffer
+  for (i = 0; i < num; i++)
+  {
+    dx = xs[i] - rx;
+    dy = ys[i] - ry;
+    d2 = dx * dx + dy * dy;
+    myBatchCumulative[i] = (char)(myBatchCurrent[i] & (d2 < cumulative2));
+    myBatchCurrent[i] &= (char)(d2 < maxRange2);
+  }
+
+  for (i = 0; i < num; i++)
+    if (myBatchCurrent[i])
+      myCurrentBuffer.addReading(xs[i], ys[i]);
+
+  // adding a reading to the cumulative buffer throws out the ones that
+  // are already there close to it, so a reading in this batch is
+  // thrown out by a later one close to it...
+  for (i = 0; i < num; i++)
+  {
+    myBatchKeepCumulative[i] = myBatchCumulative[i];
+    if (!myBatchCumulative[i])
+      continue;
+    anyCumulative = true;
+    for (j = i + 1; j < num && myBatchKeepCumulative[i]; j++)
+    {
+      dx = xs[j] - xs[i];
+      dy = ys[j] - ys[i];
+      if (myBatchCumulative[j] && dx * dx + dy * dy < near2)
+	myBatchKeepCumulative[i] = 0;
+    }
+  }
+  if (!anyCumulative)
+    return;
+
+  // ...and the old readings are thrown out if they're close to any of them
+  myCumulativeBuffer.beginInvalidationSweep();
+  const std::list<ArPoseWithTime>& readingList = myCumulativeBuffer.getBuffer();
+  for (auto it = readingList.begin(); it != readingList.end(); ++it)
+  {
+    for (i = 0; i < num; i++)
+    {
+      dx = it->getX() - xs[i];
+      dy = it->getY() - ys[i];
+      if (myBatchCumulative[i] && dx * dx + dy * dy < near2)
+      {
+	myCumulativeBuffer.invalidateReading(it);
+	break;
+      }
+    }
+  }
+  myCumulativeBuffer.endInvalidationSweep();
+
+  for (i = 0; i < num; i++)
+    if (myBatchKeepCumulative[i])
+      myCumulativeBuffer.addReading(xs[i], ys[i]);
+}
+
+AREXPORT void ArSonarDevice::addIgnoreRegion(double x1, double y1, 
+					     double x2, double y2)
+{
+  IgnoreRegion region;
+  region.x1 = ArUtil::findMin(x1, x2);
+  region.x2 = ArUtil::findMax(x1, x2);
+  region.y1 = ArUtil::findMin(y1, y2);
+  region.y2 = ArUtil::findMax(y1, y2);
+  lockDevice();
+  myIgnoreRegions.push_back(region);
+  unlockDevice();
+}
+
+AREXPORT void ArSonarDevice::clearIgnoreRegions()
+{
+  lockDevice();
+  myIgnoreRegions.clear();
+  unlockDevice();
+}
+
 AREXPORT void ArSonarDevice::setIgnoreReadingCB(
 	ArRetFunctor1<bool, ArPose> *ignoreReadingCB)
 {
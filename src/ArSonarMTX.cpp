@@ -29,6 +29,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 #include "Aria/ariaOSDef.h"
 #include "Aria/ArSerialConnection.h"
+#include "Aria/ArDeviceReactor.h"
 #include "Aria/ariaInternal.h"
 #include <time.h>
 #include <assert.h>
@@ -61,7 +62,9 @@ AREXPORT ArSonarMTX::ArSonarMTX (int sonarBoardNum,
 	mySender(NULL),
 	myFirmwareVersion(0),
 	mySensorInterpTask (this, &ArSonarMTX::sensorInterp),
-	myAriaExitCB (this, &ArSonarMTX::disconnect)
+	myAriaExitCB (this, &ArSonarMTX::disconnect),
+	myReactorReadableCB (this, &ArSonarMTX::reactorReadable),
+	myReactorIdleCB (this, &ArSonarMTX::reactorIdle)
 {
 
 	mySonarMap.clear();
@@ -92,6 +95,7 @@ AREXPORT ArSonarMTX::~ArSonarMTX()
 		myRobot->remSensorInterpTask (&myProcessCB);
 	}
   Aria::remExitCallback(&myAriaExitCB);
+  stopReactorReading();
 }
 
 
@@ -331,12 +335,101 @@ AREXPORT bool ArSonarMTX::disconnect ()
 
 	ArLog::log (ArLog::Normal, "%s: Disconnecting", getNameWithBoard());
 
+  stopReactorReading();
   if(myConn)
     myConn->close();
 
 	return true;
 }
 
+AREXPORT bool ArSonarMTX::setReactor (ArDeviceReactor *reactor)
+{
+	if (isConnected()) {
+		ArLog::log (ArLog::Terse,
+		            "%s::setReactor() Cannot change the reactor while connected",
+		            getNameWithBoard());
+		return false;
+	}
+#ifndef _WIN32
+	myReactor = reactor;
+	return true;
+#else
+	if (reactor != NULL)
+		ArLog::log (ArLog::Terse,
+		            "%s::setReactor() ArDeviceReactor is not available on Windows",
+		            getNameWithBoard());
+	return reactor == NULL;
+#endif
+}
+
+/**
+   Called once connected, starts our thread reading the packets, or
+   with a reactor adds the connection to it (falling back to the thread
+   if that fails).
+**/
+void ArSonarMTX::startReading ()
+{
+#ifndef _WIN32
+	if (myReactor != NULL) {
+		if (myReactor->addConnection (myConn, &myReactorReadableCB, 400,
+		                              &myReactorIdleCB)) {
+			myReactorReading = true;
+			return;
+		}
+		ArLog::log (ArLog::Normal,
+		            "%s::startReading() Could not add the connection to the reactor, reading from our own thread instead",
+		            getNameWithBoard());
+	}
+#endif
+	runAsync();
+}
+
+void ArSonarMTX::stopReactorReading ()
+{
+#ifndef _WIN32
+	if (myReactorReading)
+		myReactor->remConnection (myConn);
+#endif
+	myReactorReading = false;
+}
+
+void ArSonarMTX::reactorReadable (ArDeviceConnection *)
+{
+	ArRobotPacket *packet;
+
+	// don't wait for more, we'll be called again when it comes in
+	while (myIsConnected &&
+	       ((packet = myReceiver->receivePacket (0)) != NULL)) {
+		myPacketsMutex.lock();
+		myPackets.push_back (packet);
+		myPacketsMutex.unlock();
+		if (myRobot == NULL) // same as in runThread()
+			sensorInterp();
+	}
+	reactorCheckLostConnection();
+}
+
+void ArSonarMTX::reactorIdle (ArDeviceConnection *)
+{
+	reactorCheckLostConnection();
+}
+
+/// Does what runThread() does when nothing has come in for too long
+void ArSonarMTX::reactorCheckLostConnection ()
+{
+	// only disconnect if transducers are on - if they are off we'll get no packets
+	if (!myIsConnected || !checkLostConnection() || !myTransducersAreOn)
+		return;
+	ArLog::log (ArLog::Terse,
+	            "%s::reactorCheckLostConnection()  Lost connection to the MTX sonar because of error.  Nothing received for %g seconds (greater than the timeout of %g).", getNameWithBoard(),
+	            myLastReading.secSince(),
+	            getConnectionTimeoutSeconds() );
+	myIsConnected = false;
+	// we're in one of its callbacks, which it allows
+	stopReactorReading();
+	disconnectOnError();
+}
+
 void ArSonarMTX::failedToConnect ()
 {
 
@@ -817,7 +910,7 @@ AREXPORT bool ArSonarMTX::blockingConnect (bool sendTracking, bool recvTracking
 
 				myLastReading.setToNow();
 
-				runAsync();
+				startReading();
 
 				return true;
 
@@ -906,7 +999,7 @@ AREXPORT bool ArSonarMTX::fakeConnect ()
 
 	myLastReading.setToNow();
 
-	runAsync();
+	startReading();
 
 	return true;
 
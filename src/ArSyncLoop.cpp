@@ -27,6 +27,7 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ArLog.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArRobot.h"
+#include "Aria/ArMetrics.h"
 
 
 AREXPORT ArSyncLoop::ArSyncLoop() :
@@ -74,6 +75,10 @@ AREXPORT void * ArSyncLoop::runThread(void *)
     return(0);
   }
 
+  ArMetricHistogram *cycleTimeMetric = ArMetrics::getHistogram(
+	  "aria_robot_cycle_msecs", "How long each ArRobot sync cycle took (ms)",
+	  ArMetrics::makeLabels("robot", myRobot->getName()));
+
   while (myRunning)
   {
 
@@ -109,6 +114,8 @@ AREXPORT void * ArSyncLoop::runThread(void *)
     myInRun = true;
     myRobot->getSyncTaskRoot()->run();
     myInRun = false;
+    if (cycleTimeMetric != NULL)
+      cycleTimeMetric->observe((double)lastLoop.mSecSince());
     if (myStopRunIfNotConnected && !myRobot->isConnected())
     {
       if (myRunning)
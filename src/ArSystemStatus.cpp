@@ -26,7 +26,6 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 #include "Aria/ariaOSDef.h"
 #include "Aria/ariaUtil.h"
 #include "Aria/ArSystemStatus.h"
-#include "Aria/ArASyncTask.h"
 #include <stdio.h>
 
 
@@ -61,7 +60,8 @@ ArGlobalRetFunctor<int> ArSystemStatus::ourGetWirelessLinkNoiseCallback(&ArSyste
 ArGlobalRetFunctor<int> ArSystemStatus::ourGetWirelessLinkSignalCallback(&ArSystemStatus::getWirelessLinkSignal);
 ArGlobalRetFunctor<int> ArSystemStatus::ourGetMTXWirelessLinkCallback(&ArSystemStatus::getMTXWirelessLink);
 ArGlobalRetFunctor<int> ArSystemStatus::ourGetMTXWirelessQualityCallback(&ArSystemStatus::getMTXWirelessQuality);
-ArSystemStatusRefreshThread* ArSystemStatus::ourPeriodicUpdateThread = 0;
+ArGlobalFunctor ArSystemStatus::ourPeriodicUpdateCB(&ArSystemStatus::periodicUpdate);
+ArThreadPool::TaskId ArSystemStatus::ourPeriodicUpdateTask = 0;
 bool ArSystemStatus::ourShouldRefreshWireless = true;
 bool ArSystemStatus::ourShouldRefreshMTXWireless = true;
 bool ArSystemStatus::ourShouldRefreshCPU = true;
@@ -71,7 +71,7 @@ bool ArSystemStatus::ourShouldRefreshCPU = true;
 void ArSystemStatus::refreshCPU()
 {
 #ifndef _WIN32
-	if (ourPeriodicUpdateThread && !ourShouldRefreshCPU) return;
+	if (ourPeriodicUpdateTask != 0 && !ourShouldRefreshCPU) return;
 	const long interval = ourLastCPURefreshTime.mSecSince();
 	FILE* statfp = ArUtil::fopen("/proc/stat", "r");
 	FILE* uptimefp = ArUtil::fopen("/proc/uptime", "r");
@@ -141,58 +141,33 @@ void ArSystemStatus::refreshCPU()
 
 
 
-/** @cond INTERNAL_CLASSES */
-class ArSystemStatusRefreshThread : public virtual ArASyncTask {
-public:
-	ArSystemStatusRefreshThread(unsigned int refreshFrequency) :
-		myRefreshFrequency(refreshFrequency)
-	{
-		setThreadName("ArSystemStatusRefreshThread");
-	}
-	void runAsync() { create(false); }
-	void setRefreshFreq(unsigned int freq) { myRefreshFrequency = freq; }
-private:
-	unsigned int myRefreshFrequency;
-	virtual void* runThread(void*)
-	{
-		threadStarted();
-		while (Aria::getRunning() && getRunning())
-		{
-			ArSystemStatus::invalidate();
-			ArUtil::sleep(myRefreshFrequency);
-		}
-		threadFinished();
-		return NULL;
-	}
-};
-/** @endcond INTERNAL_CLASSES */
-
+void ArSystemStatus::periodicUpdate()
+{
+	if (Aria::getRunning())
+		invalidate();
+}
 
 AREXPORT void ArSystemStatus::startPeriodicUpdate(int refreshFrequency, ArLog::LogLevel logLevel)
 {
-	ourCPUMutex.setLogName("ArSystemStatusRefreshThread::ourCPUMutex");
-	ourWirelessMutex.setLogName("ArSystemStatusRefreshThread::ourWirelessMutex");
-
-	if (ourPeriodicUpdateThread) {
-		// If we already have a thread, just change its refresh frequency
-		assert(refreshFrequency > 0);
-		ourPeriodicUpdateThread->setRefreshFreq((unsigned int) refreshFrequency);
-		ourPeriodicUpdateThread->setLogLevel(logLevel);
-		return;
-	}
-	// Otherwise, start a new thread, with the desired refresh frequency
+	ourCPUMutex.setLogName("ArSystemStatus::ourCPUMutex");
+	ourWirelessMutex.setLogName("ArSystemStatus::ourWirelessMutex");
+	ourPeriodicUpdateCB.setName("ArSystemStatus::periodicUpdate");
+
 	assert(refreshFrequency > 0);
-	ourPeriodicUpdateThread = new ArSystemStatusRefreshThread((unsigned int)refreshFrequency);
-	ourPeriodicUpdateThread->setLogLevel(logLevel);
-	ourPeriodicUpdateThread->runAsync();
+	// If we already have a task, replace it to change its refresh frequency
+	if (ourPeriodicUpdateTask != 0)
+		ArThreadPool::getShared()->cancel(ourPeriodicUpdateTask);
+	ourPeriodicUpdateTask = ArThreadPool::getShared()->schedulePeriodic(
+		&ourPeriodicUpdateCB, (unsigned int)refreshFrequency);
+	ArLog::log(logLevel, "ArSystemStatus: Refreshing every %d ms",
+		refreshFrequency);
 }
 
 AREXPORT void ArSystemStatus::stopPeriodicUpdate()
 {
-	if (!ourPeriodicUpdateThread) return;
-	ourPeriodicUpdateThread->stopRunning();
-	delete ourPeriodicUpdateThread;
-	ourPeriodicUpdateThread = 0;
+	if (ourPeriodicUpdateTask == 0) return;
+	ArThreadPool::getShared()->cancel(ourPeriodicUpdateTask);
+	ourPeriodicUpdateTask = 0;
 }
 
 
@@ -300,7 +275,7 @@ AREXPORT ArRetFunctor<int>* ArSystemStatus::getMTXWirelessQualityFunctor() {
 void ArSystemStatus::refreshWireless()
 {
 #ifndef _WIN32
-	if (ourPeriodicUpdateThread && !ourShouldRefreshWireless) return;
+	if (ourPeriodicUpdateTask != 0 && !ourShouldRefreshWireless) return;
 	FILE* fp = ArUtil::fopen("/proc/net/wireless", "r");
 	if (!fp)
 	{
@@ -349,7 +324,7 @@ void ArSystemStatus::refreshWireless()
 void ArSystemStatus::refreshMTXWireless()
 {
 #ifndef _WIN32
-	if (ourPeriodicUpdateThread && !ourShouldRefreshMTXWireless) return;
+	if (ourPeriodicUpdateTask != 0 && !ourShouldRefreshMTXWireless) return;
 	FILE* fpIp = ArUtil::fopen("/mnt/status/network/wireless/ip", "r");
 	FILE* fpLink = ArUtil::fopen("/mnt/status/network/wireless/link", "r");
 	FILE* fpQuality = ArUtil::fopen("/mnt/status/network/wireless/quality", "r");
@@ -63,6 +63,13 @@ AREXPORT ArSocket *ArTcpConnection::getSocket()
   return mySocket;
 }
 
+AREXPORT int ArTcpConnection::getFD() const
+{
+  if (myStatus != STATUS_OPEN || mySocket == NULL)
+    return -1;
+  return mySocket->getFD();
+}
+
 AREXPORT void ArTcpConnection::setStatus(int status)
 {
   myStatus = status;
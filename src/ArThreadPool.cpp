@@ -0,0 +1,361 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArExport.h"
+#include "Aria/ariaOSDef.h"
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArASyncTask.h"
+#include "Aria/ArLog.h"
+
+#include <algorithm>
+
+/// One of the pool's worker threads
+class ArThreadPool::Worker : public ArASyncTask
+{
+public:
+  Worker(ArThreadPool *pool) : myPool(pool) {}
+  virtual void *runThread(void *) override;
+  /// Stopping any worker (e.g. from ArThread::stopAll()) stops the pool
+  virtual void stopRunning() override;
+  virtual std::string getThreadActivity() override;
+  // what we're running, only touched with the pool's mutex held
+  std::string myActivity;
+protected:
+  /// Joined by the pool's destructor or ArThread::joinAll(), whichever
+  /// comes first, the other one does nothing
+  virtual int doJoin(void **ret = NULL) override;
+  ArThreadPool *myPool;
+  std::mutex myJoinMutex;
+  bool myJoined = false;
+};
+
+void *ArThreadPool::Worker::runThread(void *)
+{
+  threadStarted();
+  myPool->workerLoop(this);
+  threadFinished();
+  myPool->workerExited();
+  return NULL;
+}
+
+int ArThreadPool::Worker::doJoin(void **ret)
+{
+  std::lock_guard<std::mutex> lock(myJoinMutex);
+  if (myJoined)
+    return 0;
+  int err = ArASyncTask::doJoin(ret);
+  if (err == 0)
+    myJoined = true;
+  return err;
+}
+
+void ArThreadPool::Worker::stopRunning()
+{
+  ArASyncTask::stopRunning();
+  myPool->stopFromThread();
+}
+
+std::string ArThreadPool::Worker::getThreadActivity()
+{
+  std::lock_guard<std::mutex> lock(myPool->myMutex);
+  if (myActivity.empty())
+    return getThreadName() + std::string(" (idle)");
+  return getThreadName() + std::string(" (running ") + myActivity + ")";
+}
+
+// Aria's own uses of the shared pool are short periodic and one shot
+// tasks, so it only needs a couple of threads whatever the machine
+static const unsigned int ourSharedNumThreads = 2;
+
+AREXPORT ArThreadPool::ArThreadPool(const char *name, 
+				    unsigned int numThreads) :
+  myName(name),
+  myNumThreads(numThreads),
+  myRunning(true),
+  myLastId(0),
+  mySeq(0),
+  myNumRun(0),
+  myNumLiveWorkers(0)
+{
+  unsigned int i;
+  Worker *worker;
+
+  if (myNumThreads == 0)
+    myNumThreads = std::max(2u, std::thread::hardware_concurrency());
+  for (i = 0; i < myNumThreads; i++)
+  {
+    worker = new Worker(this);
+    worker->setThreadName((myName + " worker " + 
+			   std::to_string(i + 1)).c_str());
+    myNumLiveWorkers++;
+    // joinable, so the destructor can wait until the threads are gone
+    if (worker->create(true) != 0)
+    {
+      ArLog::log(ArLog::Terse, "%s: Could not create worker thread %u",
+		 myName.c_str(), i + 1);
+      myNumLiveWorkers--;
+      delete worker;
+      continue;
+    }
+    myWorkers.push_back(worker);
+  }
+  ArLog::log(ArLog::Verbose, "%s: Started %u worker threads",
+	     myName.c_str(), myNumLiveWorkers);
+}
+
+AREXPORT ArThreadPool::~ArThreadPool()
+{
+  stop();
+  // the workers' threads have really ended once they're joined, so they
+  // can be deleted
+  for (std::vector<Worker *>::iterator it = myWorkers.begin();
+       it != myWorkers.end(); ++it)
+  {
+    (*it)->join();
+    delete (*it);
+  }
+  myWorkers.clear();
+}
+
+AREXPORT ArThreadPool *ArThreadPool::getShared()
+{
+  // never deleted, its workers may be running until the program exits
+  static ArThreadPool *shared = new ArThreadPool("ArThreadPool::shared", 
+						 ourSharedNumThreads);
+  return shared;
+}
+
+AREXPORT ArThreadPool::TaskId ArThreadPool::submit(ArFunctor *functor)
+{
+  return add(functor, Clock::duration::zero(), Clock::duration::zero());
+}
+
+AREXPORT ArThreadPool::TaskId ArThreadPool::schedule(ArFunctor *functor, 
+						     unsigned int delayMSecs)
+{
+  return add(functor, std::chrono::milliseconds(delayMSecs), 
+	     Clock::duration::zero());
+}
+
+AREXPORT ArThreadPool::TaskId ArThreadPool::schedulePeriodic(
+	ArFunctor *functor, unsigned int periodMSecs, 
+	unsigned int firstDelayMSecs)
+{
+  if (periodMSecs == 0)
+  {
+    ArLog::log(ArLog::Normal, "%s: Can't schedule a periodic task with a period of 0", 
+	       myName.c_str());
+    return 0;
+  }
+  return add(functor, std::chrono::milliseconds(firstDelayMSecs), 
+	     std::chrono::milliseconds(periodMSecs));
+}
+
+ArThreadPool::TaskId ArThreadPool::add(ArFunctor *functor, 
+				       Clock::duration delay,
+				       Clock::duration period)
+{
+  Task task;
+  TaskId id;
+
+  if (functor == NULL)
+    return 0;
+  std::lock_guard<std::mutex> lock(myMutex);
+  if (!myRunning)
+  {
+    ArLog::log(ArLog::Normal, "%s: Not running %s since the pool is stopped",
+	       myName.c_str(), functor->getName());
+    return 0;
+  }
+  id = ++myLastId;
+  task.functor = functor;
+  task.period = period;
+  task.running = false;
+  task.canceled = false;
+  myTasks[id] = task;
+  push(Clock::now() + delay, id);
+  return id;
+}
+
+// call with myMutex held
+void ArThreadPool::push(Clock::time_point due, TaskId id)
+{
+  Entry entry;
+  entry.due = due;
+  entry.seq = ++mySeq;
+  entry.id = id;
+  myQueue.push_back(entry);
+  std::push_heap(myQueue.begin(), myQueue.end(), Later());
+  myWorkCond.notify_one();
+}
+
+AREXPORT bool ArThreadPool::cancel(TaskId id, bool waitIfRunning)
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  std::map<TaskId, Task>::iterator it = myTasks.find(id);
+
+  if (it == myTasks.end())
+    return false;
+  // not running, so forget it, the queue entry is skipped when it comes up
+  if (!(*it).second.running)
+  {
+    myTasks.erase(it);
+    return true;
+  }
+  // running, so the worker erases it when it's done
+  (*it).second.canceled = true;
+  if (waitIfRunning && (*it).second.runningIn != std::this_thread::get_id())
+    myDoneCond.wait(lock, [this, id] { 
+	return myTasks.find(id) == myTasks.end(); });
+  return true;
+}
+
+AREXPORT bool ArThreadPool::isPending(TaskId id)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  std::map<TaskId, Task>::iterator it = myTasks.find(id);
+  return it != myTasks.end() && !(*it).second.canceled;
+}
+
+void ArThreadPool::workerLoop(Worker *worker)
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  std::map<TaskId, Task>::iterator it;
+  Clock::time_point now;
+  Entry entry;
+  ArFunctor *functor;
+
+  while (myRunning && worker->getRunning())
+  {
+    if (myQueue.empty())
+    {
+      myWorkCond.wait(lock);
+      continue;
+    }
+    now = Clock::now();
+    if (myQueue.front().due > now)
+    {
+      myWorkCond.wait_until(lock, myQueue.front().due);
+      continue;
+    }
+    std::pop_heap(myQueue.begin(), myQueue.end(), Later());
+    entry = myQueue.back();
+    myQueue.pop_back();
+    // canceled while it was waiting
+    if ((it = myTasks.find(entry.id)) == myTasks.end())
+      continue;
+    (*it).second.running = true;
+    (*it).second.runningIn = std::this_thread::get_id();
+    functor = (*it).second.functor;
+    worker->myActivity = functor->getName();
+    lock.unlock();
+    functor->invoke();
+    lock.lock();
+    worker->myActivity.clear();
+    myNumRun++;
+    // cancel() leaves running tasks in the map, so it's still there
+    it = myTasks.find(entry.id);
+    (*it).second.running = false;
+    if ((*it).second.canceled || 
+	(*it).second.period == Clock::duration::zero() || !myRunning)
+    {
+      myTasks.erase(it);
+    }
+    else
+    {
+      // skip runs we're too late for rather than running them back to back
+      now = Clock::now();
+      entry.due += (*it).second.period;
+      push(std::max(entry.due, now), entry.id);
+    }
+    myDoneCond.notify_all();
+  }
+}
+
+void ArThreadPool::workerExited()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  myNumLiveWorkers--;
+}
+
+void ArThreadPool::stopFromThread()
+{
+  std::set<ArThread *> pooled;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    if (!myRunning)
+      return;
+    myRunning = false;
+    myQueue.clear();
+    // forget tasks that aren't running, running ones finish normally
+    for (std::map<TaskId, Task>::iterator it = myTasks.begin();
+	 it != myTasks.end(); )
+    {
+      if (!(*it).second.running)
+	it = myTasks.erase(it);
+      else
+	++it;
+    }
+    pooled = myPooledThreads;
+    myWorkCond.notify_all();
+    myDoneCond.notify_all();
+  }
+  for (std::set<ArThread *>::iterator it = pooled.begin(); 
+       it != pooled.end(); ++it)
+    (*it)->stopRunning();
+}
+
+AREXPORT void ArThreadPool::stop()
+{
+  stopFromThread();
+}
+
+AREXPORT bool ArThreadPool::isRunning()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  return myRunning;
+}
+
+AREXPORT void ArThreadPool::addPooledThread(ArThread *thread)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  myPooledThreads.insert(thread);
+}
+
+AREXPORT void ArThreadPool::remPooledThread(ArThread *thread)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  myPooledThreads.erase(thread);
+}
+
+AREXPORT size_t ArThreadPool::getNumPending()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  return myTasks.size();
+}
+
+AREXPORT unsigned long long ArThreadPool::getNumRun()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  return myNumRun;
+}
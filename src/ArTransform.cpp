@@ -51,3 +51,45 @@ AREXPORT void ArTransform::doTransform(std::list<ArPoseWithTime *> *poseList)
   }
 
 }
+
+AREXPORT void ArTransform::doTransform(const double *xIn, const double *yIn,
+				       double *xOut, double *yOut, 
+				       size_t num) const
+{
+  // copies so that the compiler knows they don't change as we write
+  const double x = myX;
+  const double y = myY;
+  const double c = myCos;
+  const double s = mySin;
+  double sx, sy;
+  size_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    sx = xIn[i];
+    sy = yIn[i];
+    xOut[i] = x + c * sx + s * sy;
+    yOut[i] = y + c * sy - s * sx;
+  }
+}
+
+AREXPORT void ArTransform::doInvTransform(const double *xIn, 
+					  const double *yIn,
+					  double *xOut, double *yOut, 
+					  size_t num) const
+{
+  const double x = myX;
+  const double y = myY;
+  const double c = myCos;
+  const double s = mySin;
+  double tx, ty;
+  size_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    tx = xIn[i] - x;
+    ty = yIn[i] - y;
+    xOut[i] = c * tx - s * ty;
+    yOut[i] = c * ty + s * tx;
+  }
+}
@@ -187,31 +187,33 @@ AREXPORT bool ArUrg::setParamsBySteps(int startingStep, int endingStep,
 
   myRawReadings = new std::list<ArSensorReading *>;
   
-
-  ArSensorReading *reading;
+  // one reading for each cluster of steps, going from the starting step
+  size_t numBeams = 0;
   int onStep;
-  double angle;
-
   for (onStep = myStartingStep; 
        onStep < myEndingStep; 
        onStep += myClusterCount)
+    numBeams++;
+
+  double start;
+  double increment;
+  /// FLIPPED
+  if (!myFlipped)
   {
-    /// FLIPPED
-    if (!myFlipped)
-      angle = ArMath::subAngle(ArMath::subAngle(135, onStep * 0.3515625),
-			       myClusterMiddleAngle);
-    else
-      angle = ArMath::addAngle(ArMath::addAngle(-135, onStep * 0.3515625), 
-			       myClusterMiddleAngle);
-			       
-    reading = new ArSensorReading;
-    reading->resetSensorPosition(ArMath::roundInt(mySensorPose.getX()),
-				 ArMath::roundInt(mySensorPose.getY()),
-				 ArMath::addAngle(angle, 
-						  mySensorPose.getTh()));
-    myRawReadings->push_back(reading);
-    //printf("%.1f ", reading->getSensorTh());
+    start = ArMath::subAngle(ArMath::subAngle(135, 
+					      myStartingStep * 0.3515625),
+			     myClusterMiddleAngle);
+    increment = -myClusterCount * 0.3515625;
+  }
+  else
+  {
+    start = ArMath::addAngle(ArMath::addAngle(-135, 
+					      myStartingStep * 0.3515625), 
+			     myClusterMiddleAngle);
+    increment = myClusterCount * 0.3515625;
   }
+  laserSetBeams(numBeams, ArMath::addAngle(start, mySensorPose.getTh()),
+		increment);
 
 
   myDataMutex.unlock();
@@ -657,12 +659,13 @@ void ArUrg::sensorInterp()
   //double angle;
   //int onStep;
 
+  // the ranges come in from the last beam to the first
   const size_t len = reading.size();
-  std::list<ArSensorReading *>::reverse_iterator it;
+  size_t beam = myBeamReadings.size();
   size_t i;
-  for (it = myRawReadings->rbegin(), i = 0; 
-       it != myRawReadings->rend() && i < len - 1; 
-       ++it, i += 2)
+  for (i = 0; 
+       beam > 0 && i < len - 1; 
+       i += 2)
   {
     const bool ignore = false;
     int big = reading[i] - 0x30;
@@ -679,10 +682,12 @@ void ArUrg::sensorInterp()
       */
       range = 4096;
     }
-    ArSensorReading *sReading = (*it);
-    sReading->newData(range, pose, encoderPose, transform, counter, 
-		      time, ignore, 0);
+    --beam;
+    myBeamRanges[beam] = range;
+    myBeamIgnore[beam] = ignore;
+    myBeamExtraInts[beam] = 0;
   }
+  laserFillBeams(pose, encoderPose, transform, counter, time, beam);
 
   myDataMutex.unlock();
 
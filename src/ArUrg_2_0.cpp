@@ -230,37 +230,33 @@ AREXPORT bool ArUrg_2_0::setParamsBySteps(int startingStep, int endingStep,
 
   myRawReadings = new std::list<ArSensorReading *>;
   
-
-  ArSensorReading *reading;
+  // one reading for each cluster of steps, going from the starting step
+  size_t numBeams = 0;
   int onStep;
-  double angle;
-
   for (onStep = myStartingStep; 
        onStep < myEndingStep; 
        onStep += myClusterCount)
+    numBeams++;
+
+  double start;
+  double increment;
+  /// FLIPPED
+  if (!myFlipped)
   {
-    /// FLIPPED
-    if (!myFlipped)
-      //angle = ArMath::subAngle(ArMath::subAngle(135, 
-      //                                          onStep * 0.3515625),
-      angle = ArMath::subAngle(ArMath::subAngle(myStepFirst, 
-						onStep * myStepSize),
-			       myClusterMiddleAngle);
-    else
-      //angle = ArMath::addAngle(ArMath::addAngle(-135, 
-      //                                          onStep * 0.3515625), 
-      angle = ArMath::addAngle(ArMath::addAngle(-myStepFirst, 
-						onStep * myStepSize), 
-			       myClusterMiddleAngle);
-			       
-    reading = new ArSensorReading;
-    reading->resetSensorPosition(ArMath::roundInt(mySensorPose.getX()),
-				 ArMath::roundInt(mySensorPose.getY()),
-				 ArMath::addAngle(angle, 
-						  mySensorPose.getTh()));
-    myRawReadings->push_back(reading);
-    //printf("%.1f ", reading->getSensorTh());
+    start = ArMath::subAngle(ArMath::subAngle(myStepFirst, 
+					      myStartingStep * myStepSize),
+			     myClusterMiddleAngle);
+    increment = -myClusterCount * myStepSize;
+  }
+  else
+  {
+    start = ArMath::addAngle(ArMath::addAngle(-myStepFirst, 
+					      myStartingStep * myStepSize), 
+			     myClusterMiddleAngle);
+    increment = myClusterCount * myStepSize;
   }
+  laserSetBeams(numBeams, ArMath::addAngle(start, mySensorPose.getTh()),
+		increment);
 
 
   myDataMutex.unlock();
@@ -895,11 +891,12 @@ void ArUrg_2_0::sensorInterp()
     iIncr = 2;
   }
 
-  std::list<ArSensorReading *>::reverse_iterator it;
+  // the ranges come in from the last beam to the first
+  size_t beam = myBeamReadings.size();
   size_t i = 0;
-  for (it = myRawReadings->rbegin(), i = 0; 
-       it != myRawReadings->rend() && i < iMax; //len - 2; 
-       ++it, i += iIncr) //3)
+  for (i = 0; 
+       beam > 0 && i < iMax; //len - 2; 
+       i += iIncr) //3)
   {
     unsigned int range;
     if (myUseThreeDataBytes)
@@ -921,11 +918,13 @@ void ArUrg_2_0::sensorInterp()
     if (range < myDMin)
       range = myDMax+1;
 
-    ArSensorReading *sReading = (*it);
     constexpr bool ignore = false;
-    sReading->newData(range, pose, encoderPose, transform, counter, 
-		      time, ignore, 0);
+    --beam;
+    myBeamRanges[beam] = range;
+    myBeamIgnore[beam] = ignore;
+    myBeamExtraInts[beam] = 0;
   }
+  laserFillBeams(pose, encoderPose, transform, counter, time, beam);
 
   myDataMutex.unlock();
 
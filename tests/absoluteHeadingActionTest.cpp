@@ -29,7 +29,7 @@ class ActionTurnToHeading : public ArAction
 public:
   ActionTurnToHeading(double heading = 0);
   virtual ~ActionTurnToHeading() {}
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   void setHeading(double heading);
 protected:
   ArActionDesired myDesired;
@@ -48,7 +48,7 @@ void ActionTurnToHeading::setHeading(double heading)
   myHeading = heading;
 }
 
-ArActionDesired *ActionTurnToHeading::fire(ArActionDesired currentDesired)
+ArActionDesired *ActionTurnToHeading::fire(const ArActionDesired &currentDesired)
 {
   myDesired.reset();
   
@@ -33,7 +33,7 @@ class Tester : public ArAction
 public:
   Tester(ArRobot *robot);
   virtual ~Tester() {}
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   void setRotVelMax(int rotVelMax) { myRotVelMax = rotVelMax; }
   void setRotAcc(int rotAccel) { myRotAcc = rotAccel; }
   void setRotDecel(int rotDecel) { myRotDecel = rotDecel; }
@@ -93,7 +93,7 @@ Tester::Tester(ArRobot *robot) :
 
 }
 
-ArActionDesired *Tester::fire(ArActionDesired currDes)
+ArActionDesired *Tester::fire(const ArActionDesired &currDes)
 {
   printf("%4.0f %4.0f Rot max: %3d acc: %3d dec: %3d Trans max: %3d acc: %3d dec %3d\n",
 	 myRobot->getVel(), myRobot->getRotVel(),
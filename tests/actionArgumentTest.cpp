@@ -29,7 +29,7 @@ public:
   TestAction0(const char *name) : ArAction(name) 
     {}; 
   virtual ~TestAction0() {}
-  ArActionDesired *fire(ArActionDesired currentDesired) { return NULL; }
+  ArActionDesired *fire(const ArActionDesired &currentDesired) { return NULL; }
 };
 
 class TestAction1 : public ArAction
@@ -42,7 +42,7 @@ public:
       myDouble = 1;
     }; 
   virtual ~TestAction1() {}
-  ArActionDesired *fire(ArActionDesired currentDesired) { return NULL; }
+  ArActionDesired *fire(const ArActionDesired &currentDesired) { return NULL; }
   double myDouble;
 };
 
@@ -61,7 +61,7 @@ public:
       strcpy(myString, "3");
     }; 
   virtual ~TestAction3() {}
-  ArActionDesired *fire(ArActionDesired currentDesired) { return NULL; }
+  ArActionDesired *fire(const ArActionDesired &currentDesired) { return NULL; }
   double myDouble;
   int myInt; 
   char myString[512];
@@ -29,7 +29,7 @@ public:
   TestAction(const char * name, const char * description = "") :
     ArAction(name, description) {}
   virtual ~TestAction() {}
-  ArActionDesired *fire(ArActionDesired currentDesired) { return NULL; }
+  ArActionDesired *fire(const ArActionDesired &currentDesired) { return NULL; }
 };
 
 int main()
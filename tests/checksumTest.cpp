@@ -0,0 +1,182 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArMD5Calculator.h"
+#include "Aria/ArFastHash.h"
+#include "Aria/ArMapUtils.h"
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/*
+  Tests the checksums used for maps: that ArMD5Calculator gives the same
+  digest whether it's fed lines, blocks, or hashes in the background,
+  that ArFastHash matches the reference xxHash64 values however its
+  input is split, and ArMapId::create() with both kinds of checksum.
+*/
+
+std::string md5Display(ArMD5Calculator &calculator)
+{
+  char display[ArMD5Calculator::DISPLAY_LENGTH];
+  ArMD5Calculator::toDisplay(calculator.getDigest(), 
+			     ArMD5Calculator::DIGEST_LENGTH,
+			     display, sizeof(display));
+  return display;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+
+  // 1000 bytes of 0, 1, ... 250, 0, 1, ...
+  unsigned char pattern[1000];
+  for (int i = 0; i < 1000; i++)
+    pattern[i] = (unsigned char)(i % 251);
+
+  puts("ArFastHash reference values...");
+  {
+    assert(ArFastHash::hash("", 0) == 0xef46db3751d8e999ULL);
+    assert(ArFastHash::hash("abc", 3) == 0x44bc2cf5ad770999ULL);
+    assert(ArFastHash::hash("abc", 3, 1) == 0xbea9ca8199328908ULL);
+    assert(ArFastHash::hash(pattern, sizeof(pattern)) == 0xf306f04aa88b54d3ULL);
+
+    // split up every which way
+    size_t pieces[] = { 1, 3, 7, 8, 31, 32, 33, 100 };
+    for (size_t piece : pieces)
+    {
+      ArFastHash fastHash;
+      for (size_t i = 0; i < sizeof(pattern); i += piece)
+	fastHash.append(pattern + i, std::min(piece, sizeof(pattern) - i));
+      assert(fastHash.getHash() == 0xf306f04aa88b54d3ULL);
+    }
+    ArFastHash fastHash;
+    fastHash.append("abc");
+    unsigned char digest[ArFastHash::DIGEST_LENGTH];
+    fastHash.getDigest(digest, sizeof(digest));
+    assert(digest[0] == 0x44 && digest[7] == 0x99);
+    fastHash.reset();
+    assert(fastHash.getHash() == 0xef46db3751d8e999ULL);
+  }
+
+  puts("ArMD5Calculator lines, blocks and background...");
+  {
+    ArMD5Calculator calculator;
+    calculator.append("abc");
+    assert(md5Display(calculator) == "900150983cd24fb0d6963f7d28e17f72");
+    calculator.reset();
+    calculator.appendBlock(pattern, sizeof(pattern));
+    assert(md5Display(calculator) == "a24f1e3ef66950e1327f210e3997ba2c");
+
+    // a few MB of map-like lines, several blocks worth
+    std::string text;
+    char line[128];
+    for (int i = 0; i < 200000; i++)
+    {
+      snprintf(line, sizeof(line), "%d %d\n", i * 7 % 10000, -i % 5000);
+      text += line;
+    }
+    assert(text.size() > 2 * ArMD5Calculator::BLOCK_SIZE);
+
+    calculator.reset();
+    calculator.appendBlock(text.data(), text.size());
+    std::string whole = md5Display(calculator);
+
+    ArMD5Calculator lines;
+    ArMD5Calculator background;
+    ArThreadPool pool("checksumPool", 2);
+    background.setHashInBackground(true, &pool);
+    assert(background.getHashInBackground());
+    size_t start = 0, end;
+    while ((end = text.find('\n', start)) != std::string::npos)
+    {
+      std::string oneLine = text.substr(start, end - start + 1);
+      lines.append(oneLine.c_str());
+      background.append(oneLine.c_str());
+      start = end + 1;
+    }
+    assert(md5Display(lines) == whole);
+    assert(md5Display(background) == whole);
+    assert(pool.getNumRun() > 0);
+
+    // and again after a reset, mixing lines and blocks
+    background.reset();
+    background.append("ab");
+    background.appendBlock("c", 1);
+    assert(md5Display(background) == "900150983cd24fb0d6963f7d28e17f72");
+    background.setHashInBackground(false);
+    assert(!background.getHashInBackground());
+  }
+
+  puts("Files and ArMapId...");
+  {
+    const char *fileName = "checksumTest.map";
+    FILE *file = fopen(fileName, "w");
+    assert(file != NULL);
+    for (int i = 0; i < 50000; i++)
+      fprintf(file, "%d %d\n", i, i * 3);
+    fclose(file);
+
+    std::string contents;
+    file = fopen(fileName, "r");
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+      contents.append(buf, len);
+    fclose(file);
+
+    unsigned char md5[ArMD5Calculator::DIGEST_LENGTH];
+    assert(ArMD5Calculator::calculateChecksum(fileName, md5, sizeof(md5)));
+    ArMD5Calculator calculator;
+    calculator.appendBlock(contents.data(), contents.size());
+    assert(memcmp(md5, calculator.getDigest(), sizeof(md5)) == 0);
+
+    unsigned char fast[ArFastHash::DIGEST_LENGTH];
+    assert(ArFastHash::calculateChecksum(fileName, fast, sizeof(fast)));
+    unsigned long long h = ArFastHash::hash(contents.data(), contents.size());
+    for (size_t i = 0; i < sizeof(fast); i++)
+      assert(fast[i] == (unsigned char)(h >> (8 * (7 - i))));
+
+    ArMapId md5Id, fastId, fastId2;
+    assert(ArMapId::create(fileName, &md5Id));
+    assert(md5Id.getChecksumLength() == ArMD5Calculator::DIGEST_LENGTH);
+    assert(memcmp(md5Id.getChecksum(), md5, sizeof(md5)) == 0);
+    assert(ArMapId::create(fileName, &fastId, ArMapId::CHECKSUM_FAST));
+    assert(fastId.getChecksumLength() == ArFastHash::DIGEST_LENGTH);
+    assert(memcmp(fastId.getChecksum(), fast, sizeof(fast)) == 0);
+    assert(strlen(fastId.getDisplayChecksum()) == 2 * ArFastHash::DIGEST_LENGTH);
+    assert(ArMapId::create(fileName, &fastId2, ArMapId::CHECKSUM_FAST));
+    assert(fastId == fastId2);
+    assert(fastId != md5Id);
+    assert(!fastId.isSameFile(md5Id));
+
+    assert(!ArFastHash::calculateChecksum("checksumTestMissing.map", fast, 
+					  sizeof(fast)));
+    remove(fileName);
+  }
+
+  puts("All tests passed.");
+  return 0;
+}
@@ -0,0 +1,217 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArConfig.h"
+#include "Aria/ArConfigArg.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string>
+#include <list>
+#include <thread>
+#include <vector>
+
+/*
+  Tests ArConfig's indexed section and parameter lookup and its tracking
+  of which parameters changed, so that processFileCBs with dependencies
+  are only called when something they depend on changed.
+*/
+
+ArConfig *theConfig = NULL;
+bool twoAChanged = false;
+int oneCalls = 0;
+int twoCalls = 0;
+int anyCalls = 0;
+int alwaysCalls = 0;
+
+bool oneChanged() { ++oneCalls; return true; }
+bool twoChanged() { ++twoCalls; return true; }
+bool anyChanged() 
+{ 
+  ++anyCalls; 
+  twoAChanged = theConfig->hasChangedSinceProcessFile("Two", "A");
+  return true; 
+}
+bool always() { ++alwaysCalls; return true; }
+bool failOne = false;
+int failCalls = 0;
+bool mayFail() { ++failCalls; return !failOne; }
+
+bool parse(const char *text, bool continueOnErrors = true)
+{
+  std::list<std::string> lines;
+  std::string s = text;
+  size_t start = 0;
+  size_t end;
+  while ((end = s.find('\n', start)) != std::string::npos)
+  {
+    lines.push_back(s.substr(start, end - start));
+    start = end + 1;
+  }
+  if (start < s.size())
+    lines.push_back(s.substr(start));
+  return theConfig->parseText(lines, continueOnErrors);
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Terse);
+
+  ArConfig config;
+  theConfig = &config;
+  int oneA = 1, oneB = 2, twoA = 3;
+  double twoB = 4;
+  config.addParam(ArConfigArg("A", &oneA, "first in one"), "One");
+  config.addParam(ArConfigArg("B", &oneB, "second in one"), "One");
+  config.addParam(ArConfigArg("A", &twoA, "first in two"), "Two");
+  config.addParam(ArConfigArg("B", &twoB, "second in two"), "Two");
+
+  // lookups are not case sensitive and give stable handles
+  ArConfigSection *one = config.findSection("one");
+  assert(one != NULL);
+  assert(config.findSection("ONE") == one);
+  assert(config.findSection("Three") == NULL);
+  ArConfigArg *oneAArg = one->findParam("a");
+  assert(oneAArg != NULL);
+  assert(oneAArg->getInt() == 1);
+  assert(one->findParam("A") == oneAArg);
+  assert(one->findParam("C") == NULL);
+  const std::vector<ArConfigArg *> *found = one->findParams("b");
+  assert(found != NULL && found->size() == 1);
+  assert((*found)[0]->getInt() == 2);
+
+  // adding parameters doesn't move the ones already there
+  int oneC = 5;
+  config.addParam(ArConfigArg("C", &oneC, "third in one"), "One");
+  assert(one->findParam("A") == oneAArg);
+  assert(one->findParam("C")->getInt() == 5);
+
+  // a section added later is found too
+  int threeA = 6;
+  config.addParam(ArConfigArg("A", &threeA, "first in three"), "Three");
+  assert(config.findSection("three") != NULL);
+  assert(config.findSection("three")->findParam("a")->getInt() == 6);
+
+  // a renamed section is found under its new name only
+  ArConfigSection *three = config.findSection("three");
+  three->setName("Four");
+  assert(config.findSection("four") == three);
+  assert(config.findSection("three") == NULL);
+  three->setName("Three");
+  assert(config.findSection("Three") == three);
+  assert(config.findSection("Four") == NULL);
+
+  // lookups from several threads at once, with a section not yet indexed
+  int laterA = 7;
+  config.addParam(ArConfigArg("A", &laterA, "first in later"), "Later");
+  std::vector<std::thread> lookers;
+  for (int i = 0; i < 4; i++)
+    lookers.push_back(std::thread([&config, one, three]() {
+      for (int j = 0; j < 1000; j++)
+      {
+        assert(config.findSection("one") == one);
+        assert(config.findSection("THREE") == three);
+        assert(config.findSection("later") != NULL);
+      }
+    }));
+  for (size_t i = 0; i < lookers.size(); i++)
+    lookers[i].join();
+
+  ArGlobalRetFunctor<bool> oneCB(&oneChanged);
+  ArGlobalRetFunctor<bool> twoCB(&twoChanged);
+  ArGlobalRetFunctor<bool> anyCB(&anyChanged);
+  ArGlobalRetFunctor<bool> alwaysCB(&always);
+  config.addProcessFileCB(&oneCB, 40);
+  config.addProcessFileCB(&twoCB, 30);
+  config.addProcessFileCB(&anyCB, 20);
+  config.addProcessFileCB(&alwaysCB, 10);
+  assert(config.addProcessFileCBDependency(&oneCB, "One", "A"));
+  assert(config.addProcessFileCBDependency(&oneCB, "One", "B"));
+  assert(config.addProcessFileCBDependency(&twoCB, "Two", "B"));
+  assert(config.addProcessFileCBDependency(&anyCB, "Two"));
+  ArGlobalRetFunctor<bool> notAdded(&always);
+  assert(!config.addProcessFileCBDependency(&notAdded, "One"));
+
+  // everything is called the first time
+  assert(parse("Section One\nA 10\n"));
+  assert(oneA == 10);
+  assert(oneCalls == 1 && twoCalls == 1 && anyCalls == 1 && alwaysCalls == 1);
+  assert(!config.hasChangedSinceProcessFile("One", "A"));
+
+  // the same values again change nothing
+  assert(parse("Section One\nA 10\nB 2\nSection Two\nA 3\nB 4\n"));
+  assert(oneCalls == 1 && twoCalls == 1 && anyCalls == 1 && alwaysCalls == 2);
+
+  // a change in section two but not to B
+  assert(parse("Section two\na 30\n"));
+  assert(twoA == 30);
+  assert(oneCalls == 1 && twoCalls == 1 && anyCalls == 2 && alwaysCalls == 3);
+  // the callback could see what changed, but once it has run that's forgotten
+  assert(twoAChanged);
+  assert(!config.hasChangedSinceProcessFile("Two", "A"));
+
+  // B in section two changes
+  assert(parse("Section Two\nB 40.5\n"));
+  assert(twoB == 40.5);
+  assert(oneCalls == 1 && twoCalls == 2 && anyCalls == 3 && alwaysCalls == 4);
+  assert(!twoAChanged);
+
+  // B in section one changes (A in section two has the same name but
+  // doesn't count)
+  assert(parse("Section One\nb 20\n"));
+  assert(oneB == 20);
+  assert(oneCalls == 2 && twoCalls == 2 && anyCalls == 3 && alwaysCalls == 5);
+
+  // removing the callback and adding it back clears its dependencies
+  config.remProcessFileCB(&oneCB);
+  config.addProcessFileCB(&oneCB, 40);
+  assert(parse("Section Two\nA 31\n"));
+  assert(oneCalls == 3);
+
+  // a callback that fails stops the ones after it when not continuing on
+  // errors, and those still run once it works, even though the change
+  // they depend on was parsed before
+  ArGlobalRetFunctor<bool> failCB(&mayFail);
+  config.addProcessFileCB(&failCB, 50);
+  assert(config.addProcessFileCBDependency(&failCB, "One", "C"));
+  assert(parse("Section One\nC 5\n"));
+  assert(failCalls == 1);
+  int oneBefore = oneCalls, twoBefore = twoCalls, anyBefore = anyCalls;
+  failOne = true;
+  assert(!parse("Section One\nC 6\nB 21\nSection Two\nB 41\n", false));
+  assert(oneC == 6 && oneB == 21 && twoB == 41);
+  assert(failCalls == 2);
+  assert(oneCalls == oneBefore && twoCalls == twoBefore && anyCalls == anyBefore);
+  failOne = false;
+  assert(parse("Section One\nC 6\n", false));
+  assert(failCalls == 3);
+  assert(oneCalls == oneBefore + 1 && twoCalls == twoBefore + 1 && 
+         anyCalls == anyBefore + 1);
+  // and after that they're back to only running on changes
+  assert(parse("Section One\nC 6\n", false));
+  assert(failCalls == 3 && twoCalls == twoBefore + 1 && anyCalls == anyBefore + 1);
+
+  printf("configChangeTest: all tests passed\n");
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArDataLogger.h"
+#include "Aria/ArRobot.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+  Tests the Binary DataLogFormat of ArDataLogger: records are written
+  through the logger (without a robot connection) and then converted back
+  to CSV with ArDataLogger::convertBinaryLog(), and changing between the
+  text and binary formats doesn't mix them in one file.
+*/
+
+const char *logFileName = "dataLoggerBinaryTest.dat";
+int counter = 0;
+
+void counterString(char *buf, size_t len)
+{
+  snprintf(buf, len, "n,%d", counter);
+}
+
+// Exposes the settings normally set through ArConfig
+class TestDataLogger : public ArDataLogger
+{
+public:
+  explicit TestDataLogger(ArRobot *robot, const char *fileName = NULL) : 
+    ArDataLogger(robot, fileName) {}
+  void setup()
+  {
+    myConfigFileName = logFileName;
+    myConfigLogFormat = "Binary";
+    myLogPose = true;
+    myLogTransVel = true;
+    myLogFlags = true;
+  }
+  void setFormat(const char *format) { myConfigLogFormat = format; }
+  void enableStrings() { *(myStringsEnabled[0]) = true; }
+  void cycle() { userTask(); }
+};
+
+std::vector<std::string> readLines(FILE *file)
+{
+  std::vector<std::string> lines;
+  char line[1024];
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    line[strcspn(line, "\n")] = '\0';
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// converts a binary log and returns how many lines of text it made,
+// or -1 if it couldn't be converted
+int binaryLogLines(const char *fileName)
+{
+  FILE *in = ArUtil::fopen(fileName, "rb");
+  if (in == NULL)
+    return -1;
+  FILE *out = tmpfile();
+  assert(out);
+  const bool converted = ArDataLogger::convertBinaryLog(in, out, ',');
+  fclose(in);
+  rewind(out);
+  std::vector<std::string> lines = readLines(out);
+  fclose(out);
+  return converted ? (int)lines.size() : -1;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  ArRobot robot;
+  robot.moveTo(ArPose(1000, -250, 90));
+
+  {
+    ArGlobalFunctor2<char *, size_t> counterCB(&counterString);
+    TestDataLogger logger(&robot);
+    logger.addString("Counter", 8, &counterCB);
+    logger.setup();
+    logger.startLogging(0);
+    assert(logger.getOpenLogFileName() != NULL);
+    for (counter = 0; counter < 3; ++counter)
+      logger.cycle();
+    logger.writeComment("a comment");
+
+    // a reconfiguration writes a new schema
+    logger.enableStrings();
+    logger.startLogging(0);
+    for (; counter < 5; ++counter)
+      logger.cycle();
+    logger.stopLogging();
+    assert(logger.getOpenLogFileName() == NULL);
+  }
+
+  FILE *in = ArUtil::fopen(logFileName, "rb");
+  assert(in);
+  FILE *out = tmpfile();
+  assert(out);
+  assert(ArDataLogger::convertBinaryLog(in, out, ','));
+  fclose(in);
+  rewind(out);
+  std::vector<std::string> lines = readLines(out);
+  fclose(out);
+  for (size_t i = 0; i < lines.size(); ++i)
+    printf("%s\n", lines[i].c_str());
+
+  assert(lines.size() == 8);
+  assert(lines[0] == ";Time,X,Y,Th,TransV,Flags");
+  for (size_t i = 1; i <= 3; ++i)
+  {
+    // time varies, the rest matches what the CSV format would write
+    assert(lines[i].find(",1000,-250,90,0,0000000000000000") != std::string::npos);
+    assert(lines[i].find(',') == lines[i].find('.') + 5);
+  }
+  assert(lines[4].find("; ") == 0);
+  assert(lines[4].find(" a comment") != std::string::npos);
+  assert(lines[5] == ";Time,Counter,X,Y,Th,TransV,Flags");
+  // the separator is replaced in string values, like the text formats do
+  assert(lines[6].find(",n 3,1000,") != std::string::npos);
+  assert(lines[7].find(",n 4,1000,") != std::string::npos);
+
+  // text that isn't a binary log is rejected
+  FILE *bad = tmpfile();
+  fputs(";Time,X\n1.0,2\n", bad);
+  rewind(bad);
+  FILE *ignored = tmpfile();
+  assert(!ArDataLogger::convertBinaryLog(bad, ignored, ','));
+  fclose(bad);
+  fclose(ignored);
+
+  // changing between text and binary starts the file over, whether or
+  // not it's open at the time
+  {
+    TestDataLogger logger(&robot);
+    logger.setup();
+    logger.setFormat("TSV");
+    logger.startLogging(0);
+    logger.cycle();
+    logger.cycle();
+    logger.setFormat("Binary");
+    logger.startLogging(0);
+    logger.cycle();
+    logger.cycle();
+    logger.stopLogging();
+    assert(binaryLogLines(logFileName) == 3);
+
+    logger.startLogging(0);
+    logger.cycle();
+    logger.setFormat("TSV");
+    logger.startLogging(0);
+    logger.cycle();
+    logger.cycle();
+    logger.cycle();
+    logger.stopLogging();
+    in = ArUtil::fopen(logFileName, "r");
+    assert(in);
+    lines = readLines(in);
+    fclose(in);
+    assert(lines.size() == 4);
+    assert(lines[0].find(";Time\tX\tY\tTh\tTransV\tFlags") == 0);
+    for (size_t i = 1; i < lines.size(); ++i)
+      assert(lines[i].find("ArDLBin1") == std::string::npos);
+  }
+  remove(logFileName);
+
+  // a permanent file is appended to, so binary logging rolls to a new
+  // file rather than adding to a text log
+  const char *permanentName = "dataLoggerBinaryTestPermanent.log";
+  const std::string rolledName = std::string(permanentName) + ".1";
+  remove(rolledName.c_str());
+  FILE *text = ArUtil::fopen(permanentName, "w");
+  assert(text);
+  fputs(";Time\tX\n1.0\t2\n", text);
+  fclose(text);
+  {
+    TestDataLogger logger(&robot, permanentName);
+    logger.setup();
+    logger.startLogging(0);
+    assert(logger.getOpenLogFileName() != NULL);
+    assert(rolledName == logger.getOpenLogFileName());
+    logger.cycle();
+    logger.stopLogging();
+  }
+  assert(binaryLogLines(rolledName.c_str()) == 2);
+  in = ArUtil::fopen(permanentName, "r");
+  assert(in);
+  lines = readLines(in);
+  fclose(in);
+  assert(lines.size() == 2 && lines[1] == "1.0\t2");
+  remove(permanentName);
+  remove(rolledName.c_str());
+
+  remove(logFileName);
+  printf("dataLoggerBinaryTest: all tests passed\n");
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArDeviceConnectGroup.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+
+/*
+  Tests ArDeviceConnectGroup, which the laser, sonar, battery and LCD
+  connectors use to connect their devices concurrently: that devices
+  are connected at the same time, that retries and timeouts follow each
+  device's policy, and that the results say which devices came up.
+  The "devices" here just sleep and then succeed or fail.
+*/
+
+class FakeDevice
+{
+public:
+  FakeDevice(int connectMSecs, int failFirst) :
+    myConnectMSecs(connectMSecs), myFailFirst(failFirst), myAttempts(0) {}
+  bool blockingConnect()
+    {
+      ArUtil::sleep(myConnectMSecs);
+      myMutex.lock();
+      int attempt = ++myAttempts;
+      myMutex.unlock();
+      return myFailFirst >= 0 && attempt > myFailFirst;
+    }
+  ArRetFunctor<bool> *newConnectFunctor()
+    { return new ArRetFunctorC<bool, FakeDevice>(this, &FakeDevice::blockingConnect); }
+  int myConnectMSecs;
+  // fail this many attempts then connect, or never connect if negative
+  int myFailFirst;
+  int myAttempts;
+  ArMutex myMutex;
+};
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+
+  // four slow devices connect in about the time of one
+  {
+    ArDeviceConnectGroup group("concurrent");
+    FakeDevice devices[4] = { {300, 0}, {300, 0}, {300, 0}, {100, 0} };
+    for (int i = 0; i < 4; i++)
+      group.addDevice("fake", i + 1, devices[i].newConnectFunctor());
+    assert(group.getConcurrent());
+    assert(group.connectAll());
+    group.logResults();
+    assert(group.getResults().size() == 4);
+    for (int i = 0; i < 4; i++)
+    {
+      assert(group.getResults()[(size_t)i].number == i + 1);
+      assert(group.getResults()[(size_t)i].connected);
+      assert(group.getResults()[(size_t)i].attempts == 1);
+      assert(group.wasConnected(i + 1));
+    }
+    assert(group.getElapsedMSecs() >= 250);
+    assert(group.getElapsedMSecs() < 800);
+    printf("concurrent ok (%lld ms)\n", group.getElapsedMSecs());
+
+    // and one at a time takes the sum
+    group.clear();
+    assert(group.getResults().empty());
+    group.setConcurrent(false);
+    for (int i = 0; i < 4; i++)
+      group.addDevice("fake", i + 1, devices[i].newConnectFunctor());
+    assert(group.connectAll());
+    assert(group.getElapsedMSecs() >= 900);
+    printf("one at a time ok (%lld ms)\n", group.getElapsedMSecs());
+  }
+
+  // retries, timeouts and failures follow each device's policy
+  {
+    ArDeviceConnectGroup group("policies");
+    ArDeviceConnectGroup::ConnectPolicy retry;
+    retry.retries = 3;
+    retry.retryDelayMSecs = 50;
+    ArDeviceConnectGroup::ConnectPolicy timeout;
+    timeout.retries = 100;
+    timeout.retryDelayMSecs = 100;
+    timeout.timeoutMSecs = 450;
+    group.setPolicy(2, retry);
+    group.setPolicy(3, timeout);
+    assert(group.getPolicy(2).retries == 3);
+    assert(group.getPolicy(7).retries == 0);
+
+    FakeDevice noRetries(10, 1);
+    FakeDevice retried(10, 2);
+    FakeDevice neverConnects(10, -1);
+    group.addDevice("noRetries", 1, noRetries.newConnectFunctor());
+    group.addDevice("retried", 2, retried.newConnectFunctor());
+    group.addDevice("neverConnects", 3, neverConnects.newConnectFunctor());
+    assert(!group.connectAll());
+    group.logResults();
+
+    const std::vector<ArDeviceConnectGroup::ConnectResult> &results = 
+      group.getResults();
+    assert(results.size() == 3);
+    assert(!results[0].connected && results[0].attempts == 1);
+    assert(!results[0].timedOut);
+    assert(results[1].connected && results[1].attempts == 3);
+    assert(!results[2].connected && results[2].timedOut);
+    // 4 attempts fit before 450 ms with 110 ms between their starts
+    assert(results[2].attempts >= 3 && results[2].attempts <= 5);
+    assert(results[2].mSecs < 600);
+    assert(!group.wasConnected(1) && group.wasConnected(2));
+    assert(!group.wasConnected(3) && !group.wasConnected(4));
+    printf("policies ok\n");
+  }
+
+  // one device doesn't need any threads
+  {
+    ArDeviceConnectGroup group("single");
+    FakeDevice device(0, 0);
+    group.addDevice("only", 5, device.newConnectFunctor());
+    assert(group.connectAll());
+    assert(group.wasConnected(5));
+    assert(group.connectAll());
+    assert(device.myAttempts == 2);
+    assert(group.getResults().size() == 1);
+  }
+
+  printf("All deviceConnectGroupTest tests passed\n");
+  return 0;
+}
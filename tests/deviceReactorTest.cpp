@@ -0,0 +1,577 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArDeviceReactor.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ArGPS.h"
+#include "Aria/ArLMS1XX.h"
+#include "Aria/ArSonarMTX.h"
+#include "Aria/ArRobotPacket.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+  Tests ArDeviceReactor: several pipe backed "devices" are added to one
+  reactor, and we check that each one's callback is called with its
+  data, that idle callbacks happen, that connections can be removed
+  (also from their own callbacks), and that ArGPS reads from one with
+  setReactor().  Then some ArLMS1XX lasers (talking to a fake laser)
+  and ArSonarMTX boards are connected first with their own threads and
+  then with a reactor, checking that the reactor saves those threads.
+*/
+
+/// Device connection that reads from the read end of a pipe
+class PipeConnection : public ArDeviceConnection
+{
+public:
+  PipeConnection(const char *name)
+  {
+    int fds[2];
+    int ret = pipe(fds);
+    assert(ret == 0);
+    myReadFD = fds[0];
+    myWriteFD = fds[1];
+    fcntl(myReadFD, F_SETFL, O_NONBLOCK);
+    setDeviceName(name);
+    setPortName(name);
+  }
+  virtual ~PipeConnection() 
+  { 
+    if (myReadFD >= 0) ::close(myReadFD);
+    if (myWriteFD >= 0) ::close(myWriteFD);
+  }
+  virtual int read(const char *data, unsigned int size, unsigned int) override
+  {
+    ssize_t n = ::read(myReadFD, const_cast<char *>(data), size);
+    if (n < 0)
+      return (errno == EAGAIN) ? 0 : -1;
+    // end of file, the writer hung up
+    if (n == 0 && size > 0)
+      return -1;
+    return (int)n;
+  }
+  virtual int write(const char *, unsigned int) override { return -1; }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+  virtual int getFD() const override { return myReadFD; }
+
+  /// What the "device" sends
+  void send(const char *str)
+  {
+    ssize_t n = ::write(myWriteFD, str, strlen(str));
+    assert(n == (ssize_t)strlen(str));
+  }
+  /// The "device" goes away
+  void hangUp() { ::close(myWriteFD); myWriteFD = -1; }
+  int getWriteFD() const { return myWriteFD; }
+protected:
+  int myReadFD;
+  int myWriteFD;
+};
+
+/// Reads what a PipeConnection has and remembers it
+class Reader
+{
+public:
+  Reader(ArDeviceReactor *reactor = NULL, size_t removeAfter = 0) : 
+    myReactor(reactor), myRemoveAfter(removeAfter),
+    myReadCB(this, &Reader::readable), myIdleCB(this, &Reader::idle) {}
+  void readable(ArDeviceConnection *conn)
+  {
+    char buf[256];
+    int n;
+    // check that one connection's callbacks don't overlap
+    assert(myInCallback.tryLock() == 0);
+    while ((n = conn->read(buf, sizeof(buf), 0)) > 0)
+    {
+      myMutex.lock();
+      myData.append(buf, (size_t)n);
+      myMutex.unlock();
+    }
+    if (n < 0)
+      myHungUp = true;
+    ArUtil::sleep(2);
+    myInCallback.unlock();
+    if (myRemoveAfter > 0 && getData().size() >= myRemoveAfter)
+      assert(myReactor->remConnection(conn));
+  }
+  void idle(ArDeviceConnection *) { myIdles++; }
+  std::string getData() 
+  { 
+    myMutex.lock(); 
+    std::string ret = myData; 
+    myMutex.unlock(); 
+    return ret; 
+  }
+
+  ArDeviceReactor *myReactor;
+  size_t myRemoveAfter;
+  ArMutex myMutex;
+  ArMutex myInCallback;
+  std::string myData;
+  bool myHungUp = false;
+  int myIdles = 0;
+  ArFunctor1C<Reader, ArDeviceConnection *> myReadCB;
+  ArFunctor1C<Reader, ArDeviceConnection *> myIdleCB;
+};
+
+/// Device connection on one end of a socket pair, the test is the device
+class SocketPairConnection : public ArDeviceConnection
+{
+public:
+  SocketPairConnection(const char *name)
+  {
+    int fds[2];
+    int ret = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    assert(ret == 0);
+    myFD = fds[0];
+    myDeviceFD = fds[1];
+    setDeviceName(name);
+    setPortName(name);
+  }
+  virtual ~SocketPairConnection() 
+  { 
+    ::close(myFD);
+    ::close(myDeviceFD);
+  }
+  virtual int read(const char *data, unsigned int size, 
+		   unsigned int msWait) override
+  {
+    struct pollfd pfd = { myFD, POLLIN, 0 };
+    if (poll(&pfd, 1, (int)msWait) <= 0)
+      return 0;
+    ssize_t n = ::read(myFD, const_cast<char *>(data), size);
+    if (n < 0)
+      return (errno == EAGAIN) ? 0 : -1;
+    if (n == 0 && size > 0)
+      return -1;
+    return (int)n;
+  }
+  virtual int write(const char *data, unsigned int size) override
+    { return (int)::write(myFD, data, size); }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+  virtual int getFD() const override { return myFD; }
+  int getDeviceFD() const { return myDeviceFD; }
+protected:
+  int myFD;
+  int myDeviceFD;
+};
+
+/// Plays an LMS1xx: answers the connection commands, then sends scans
+class FakeLMS1XX
+{
+public:
+  FakeLMS1XX(const char *name) : myConn(name) {}
+  /// Reads and answers whatever the laser sent
+  void serve()
+  {
+    char buf[512];
+    ssize_t n = ::recv(myConn.getDeviceFD(), buf, sizeof(buf), MSG_DONTWAIT);
+    if (n > 0)
+      myRequests.append(buf, (size_t)n);
+    size_t start;
+    size_t end;
+    while ((start = myRequests.find('\002')) != std::string::npos &&
+	   (end = myRequests.find('\003', start)) != std::string::npos)
+    {
+      handle(myRequests.substr(start + 1, end - start - 1));
+      myRequests.erase(0, end + 1);
+    }
+  }
+  /// Sends a scan of 5 readings 100 mm away, if the laser has asked for them
+  void sendScan()
+  {
+    if (myScanning)
+      send("sSN LMDscandata 1 1 89A27F 0 0 1 2 3 4 0 0 0 0 0 1388 168 0 1 "
+	   "DIST1 3F800000 00000000 FFF92230 1388 5 64 64 64 64 64 0 0 0 0 0");
+  }
+  SocketPairConnection myConn;
+protected:
+  void handle(const std::string &request)
+  {
+    // "sMN SetAccessMode 3 F4724744" and so on, answer by command name
+    size_t end = request.find(' ', 4);
+    std::string name = request.substr(4, end == std::string::npos ? 
+				      std::string::npos : end - 4);
+    if (name == "SetAccessMode")
+      send("sAN SetAccessMode 1");
+    else if (name == "mLMPsetscancfg")
+      send("sAN mLMPsetscancfg 0");
+    else if (name == "LMDscandatacfg")
+      send("sWA LMDscandatacfg");
+    else if (name == "Run")
+      send("sAN Run 1");
+    else if (name == "LMDscandata")
+    {
+      send("sEA LMDscandata 1");
+      myScanning = true;
+    }
+  }
+  void send(const std::string &str)
+  {
+    std::string packet = "\002" + str + "\003";
+    ssize_t n = ::send(myConn.getDeviceFD(), packet.c_str(), packet.size(), 
+		       MSG_NOSIGNAL);
+    assert(n == (ssize_t)packet.size());
+  }
+  std::string myRequests;
+  std::atomic<bool> myScanning{false};
+};
+
+size_t numThreads()
+{
+  size_t n = 0;
+  DIR *dir = opendir("/proc/self/task");
+  assert(dir != NULL);
+  while (struct dirent *ent = readdir(dir))
+    if (ent->d_name[0] != '.')
+      n++;
+  closedir(dir);
+  return n;
+}
+
+// waits for threads that are exiting to be gone from /proc
+size_t settledNumThreads()
+{
+  size_t n = numThreads();
+  ArTime same;
+  ArTime start;
+  while (same.mSecSince() < 50 && start.mSecSince() < 3000)
+  {
+    ArUtil::sleep(2);
+    size_t now = numThreads();
+    if (now != n)
+    {
+      n = now;
+      same.setToNow();
+    }
+  }
+  return n;
+}
+
+/**
+   Connects two lasers and two sonar boards, with @a reactor if it isn't
+   NULL, and checks they get data.  Returns how many more threads the
+   process had while they were connected.
+**/
+size_t connectDrivers(ArDeviceReactor *reactor)
+{
+  int i;
+  FakeLMS1XX fakeLaser1("fakeLaser1");
+  FakeLMS1XX fakeLaser2("fakeLaser2");
+  FakeLMS1XX *fakeLasers[2] = { &fakeLaser1, &fakeLaser2 };
+  PipeConnection sonarConn0("sonar0");
+  PipeConnection sonarConn1("sonar1");
+  PipeConnection *sonarConns[2] = { &sonarConn0, &sonarConn1 };
+  std::atomic<bool> playing{true};
+  // the fake lasers, with a scan every 20 ms like a real one
+  std::thread player([&fakeLasers, &playing] {
+      while (playing)
+      {
+	for (FakeLMS1XX *fake : fakeLasers)
+	{
+	  fake->serve();
+	  fake->sendScan();
+	}
+	ArUtil::sleep(20);
+      }
+    });
+  ArLMS1XX *lasers[2];
+  ArSonarMTX *sonars[2];
+  size_t before = settledNumThreads();
+
+  for (i = 0; i < 2; i++)
+  {
+    lasers[i] = new ArLMS1XX(i + 1, "lms1xx", ArLMS1XX::LMS1XX);
+    lasers[i]->setDeviceConnection(&fakeLasers[i]->myConn);
+    assert(lasers[i]->setReactor(reactor));
+    // the second one connects from its own thread, which with a reactor
+    // exits once it's connected
+    if (i == 0)
+      assert(lasers[i]->blockingConnect());
+    else
+      assert(lasers[i]->asyncConnect());
+    sonars[i] = new ArSonarMTX(i, "sonar", sonarConns[i]);
+    assert(sonars[i]->setReactor(reactor));
+    assert(sonars[i]->fakeConnect());
+  }
+  // can't be changed while connected
+  assert(!lasers[0]->setReactor(NULL));
+  assert(!sonars[0]->setReactor(NULL));
+
+  for (int tries = 0; tries < 200 && !lasers[1]->isConnected(); tries++)
+    ArUtil::sleep(10);
+  assert(lasers[1]->isConnected());
+
+  ArTime start;
+  ArUtil::sleep(2);
+  ArRobotPacket sonarPacket(0xfa, 0xf5);
+  sonarPacket.setID(0x01);
+  sonarPacket.uByte2ToBuf(0);
+  sonarPacket.uByte2ToBuf(100);
+  sonarPacket.finalizePacket();
+  for (i = 0; i < 2; i++)
+  {
+    ssize_t n = ::write(sonarConns[i]->getWriteFD(), sonarPacket.getBuf(),
+			sonarPacket.getLength());
+    assert(n == sonarPacket.getLength());
+  }
+  bool gotAll = false;
+  for (int tries = 0; tries < 200 && !gotAll; tries++)
+  {
+    gotAll = true;
+    for (i = 0; i < 2; i++)
+      // got something since start
+      if (lasers[i]->getLastReadingTime().mSecSince() >= start.mSecSince() ||
+	  sonars[i]->getLastReadingTime().mSecSince() >= start.mSecSince())
+	gotAll = false;
+    if (!gotAll)
+      ArUtil::sleep(10);
+  }
+  assert(gotAll);
+  for (i = 0; i < 2; i++)
+    assert(lasers[i]->isConnected() && sonars[i]->isConnected());
+
+  size_t during = settledNumThreads();
+  printf("%lu threads before connecting, %lu while connected\n",
+	 (unsigned long)before, (unsigned long)during);
+
+  for (i = 0; i < 2; i++)
+  {
+    // stop their own threads, if they have them, before deleting them
+    lasers[i]->stopRunning();
+    sonars[i]->stopRunning();
+  }
+  settledNumThreads();
+  for (i = 0; i < 2; i++)
+  {
+    sonars[i]->disconnect();
+    delete lasers[i];
+    delete sonars[i];
+  }
+  playing = false;
+  player.join();
+  return during - before;
+}
+
+bool waitFor(Reader *reader, size_t size)
+{
+  for (int i = 0; i < 200 && reader->getData().size() < size; i++)
+    ArUtil::sleep(10);
+  return reader->getData().size() >= size;
+}
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  int i;
+
+  puts("Several devices, two worker threads...");
+  {
+    ArDeviceReactor reactor("testReactor");
+    PipeConnection conns[4] = { PipeConnection("dev0"), PipeConnection("dev1"),
+				PipeConnection("dev2"), PipeConnection("dev3") };
+    Reader readers[4];
+    for (i = 0; i < 4; i++)
+      assert(reactor.addConnection(&conns[i], &readers[i].myReadCB));
+    // twice is refused
+    assert(!reactor.addConnection(&conns[0], &readers[0].myReadCB));
+    assert(reactor.getNumConnections() == 4);
+    assert(reactor.start(2));
+    assert(reactor.isRunning());
+
+    // lots of little writes, so callbacks come while others are running
+    for (int round = 0; round < 50; round++)
+      for (i = 0; i < 4; i++)
+	conns[i].send(i % 2 == 0 ? "ab" : "xyz");
+    for (i = 0; i < 4; i++)
+    {
+      assert(waitFor(&readers[i], i % 2 == 0 ? 100 : 150));
+      assert(readers[i].getData().size() == (i % 2 == 0 ? 100u : 150u));
+    }
+    std::string expect;
+    for (int round = 0; round < 50; round++)
+      expect += "xyz";
+    assert(readers[1].getData() == expect);
+
+    // the stats are updated once the last callbacks (which sleep after
+    // reading) return
+    ArUtil::sleep(50);
+    std::vector<ArDeviceReactor::ConnectionStats> stats = reactor.getStats();
+    assert(stats.size() == 4);
+    for (i = 0; i < 4; i++)
+    {
+      assert(stats[(size_t)i].wakeups > 0);
+      assert(stats[(size_t)i].callbackUSecs > 0);
+      assert(!stats[(size_t)i].hungUp);
+    }
+    assert(stats[2].name == "dev2");
+    reactor.logStats();
+
+    // removed, so we don't hear about it anymore
+    assert(reactor.remConnection(&conns[3]));
+    assert(!reactor.remConnection(&conns[3]));
+    conns[3].send("more");
+    conns[2].send("more");
+    assert(waitFor(&readers[2], 104));
+    ArUtil::sleep(50);
+    assert(readers[3].getData().size() == 150);
+
+    // a hang up is noticed
+    conns[2].hangUp();
+    for (i = 0; i < 100 && !readers[2].myHungUp; i++)
+      ArUtil::sleep(10);
+    assert(readers[2].myHungUp);
+    ArUtil::sleep(20);
+    stats = reactor.getStats();
+    assert(stats.size() == 3);
+    assert(stats[2].hungUp);
+
+    reactor.stop();
+    assert(!reactor.isRunning());
+    // can be started again
+    assert(reactor.start(1));
+    conns[0].send("zz");
+    assert(waitFor(&readers[0], 102));
+  }
+  puts("OK");
+
+  puts("Removing a connection from its own callback...");
+  {
+    ArDeviceReactor reactor;
+    PipeConnection conn("self");
+    Reader reader(&reactor, 5);
+    assert(reactor.addConnection(&conn, &reader.myReadCB));
+    assert(reactor.start());
+    conn.send("hello");
+    assert(waitFor(&reader, 5));
+    for (i = 0; i < 100 && reactor.getNumConnections() != 0; i++)
+      ArUtil::sleep(10);
+    assert(reactor.getNumConnections() == 0);
+    conn.send("again");
+    ArUtil::sleep(50);
+    assert(reader.getData() == "hello");
+  }
+  puts("OK");
+
+  puts("Idle callbacks...");
+  {
+    ArDeviceReactor reactor;
+    PipeConnection quiet("quiet");
+    PipeConnection chatty("chatty");
+    Reader quietReader;
+    Reader chattyReader;
+    assert(reactor.addConnection(&quiet, &quietReader.myReadCB, 
+				 100, &quietReader.myIdleCB));
+    assert(reactor.addConnection(&chatty, &chattyReader.myReadCB, 
+				 100, &chattyReader.myIdleCB));
+    assert(reactor.start());
+    ArTime started;
+    while (started.mSecSince() < 450)
+    {
+      chatty.send("x");
+      ArUtil::sleep(20);
+    }
+    printf("quiet had %d idle callbacks, chatty had %d\n", 
+	   quietReader.myIdles, chattyReader.myIdles);
+    assert(quietReader.myIdles >= 2);
+    assert(chattyReader.myIdles == 0);
+    reactor.logStats();
+  }
+  puts("OK");
+
+  puts("ArGPS reading with a reactor...");
+  {
+    ArDeviceReactor reactor;
+    PipeConnection conn("gps");
+    ArGPS gps;
+    // no connection yet
+    assert(!gps.setReactor(&reactor));
+    gps.setDeviceConnection(&conn);
+    gps.setIgnoreChecksum(true);
+    assert(gps.setReactor(&reactor));
+    assert(gps.getReactor() == &reactor);
+    assert(reactor.start());
+    conn.send("$GPRMC,1.1,A,4248.32544,N,7234.293016,E,0*00\r\n");
+    bool got = false;
+    for (i = 0; i < 200 && !got; i++)
+    {
+      gps.lock();
+      got = gps.havePosition();
+      gps.unlock();
+      if (!got)
+	ArUtil::sleep(10);
+    }
+    assert(got);
+    gps.lock();
+    printf("lat=%f lon=%f\n", gps.getLatitude(), gps.getLongitude());
+    assert(fabs(gps.getLatitude() - 42.805424) < 0.0001);
+    assert(fabs(gps.getLongitude() - 72.571550) < 0.0001);
+    gps.unlock();
+    assert(gps.setReactor(NULL));
+    assert(reactor.getNumConnections() == 0);
+  }
+  puts("OK");
+
+  puts("Laser and sonar drivers with and without a reactor...");
+  {
+    // a thread for each laser and sonar
+    size_t withThreads = connectDrivers(NULL);
+    assert(withThreads == 4);
+    ArDeviceReactor reactor("driverReactor");
+    assert(reactor.start());
+    // none of their own with a reactor
+    size_t withReactor = connectDrivers(&reactor);
+    assert(withReactor == 0);
+    assert(reactor.getNumConnections() == 0);
+    printf("%lu driver threads without a reactor, %lu with one\n",
+	   (unsigned long)withThreads, (unsigned long)withReactor);
+  }
+  puts("OK");
+
+  puts("All tests passed.");
+  return 0;
+}
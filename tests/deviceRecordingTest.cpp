@@ -0,0 +1,241 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRecordingDeviceConnection.h"
+#include "Aria/ArReplayDeviceConnection.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+  Tests ArRecordingDeviceConnection and ArReplayDeviceConnection: a fake
+  device's reads and writes are recorded, then played back as fast as
+  possible and at the original speed, checking that the same data comes
+  back in the same chunks, that the timing is kept, and that writes are
+  compared with the recording.
+*/
+
+/// Device that returns scripted chunks of data, some time apart
+class ScriptedConnection : public ArDeviceConnection
+{
+public:
+  ScriptedConnection() { setPortName("scripted"); }
+  void add(const char *chunk, unsigned int delayMSecs) 
+  { 
+    myChunks.push_back(chunk); 
+    myDelays.push_back(delayMSecs);
+  }
+  virtual int read(const char *data, unsigned int size, unsigned int) override
+  {
+    if (myNext >= myChunks.size())
+      return 0;
+    if (myDelays[myNext] > 0)
+      ArUtil::sleep(myDelays[myNext]);
+    if (myChunks[myNext] == NULL)
+    {
+      myNext++;
+      return -1;
+    }
+    unsigned int len = (unsigned int)strlen(myChunks[myNext]);
+    assert(len <= size);
+    memcpy(const_cast<char *>(data), myChunks[myNext], len);
+    myNext++;
+    return (int)len;
+  }
+  virtual int write(const char *, unsigned int size) override 
+  { return (int)size; }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+
+  std::vector<const char *> myChunks;
+  std::vector<unsigned int> myDelays;
+  size_t myNext = 0;
+};
+
+std::string readAll(ArReplayDeviceConnection *replay, unsigned int bufSize,
+		    std::vector<std::string> *chunks, int *errors)
+{
+  char buf[256];
+  std::string ret;
+  int n;
+  while (!replay->atEnd())
+  {
+    n = replay->read(buf, bufSize, 10);
+    if (n < 0)
+      (*errors)++;
+    else if (n > 0)
+    {
+      ret.append(buf, (size_t)n);
+      if (chunks != NULL)
+	chunks->push_back(std::string(buf, (size_t)n));
+    }
+  }
+  return ret;
+}
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  const char *fileName = "deviceRecordingTest.rec";
+  char buf[256];
+  int errors;
+  std::vector<std::string> chunks;
+
+  puts("Recording...");
+  {
+    ScriptedConnection device;
+    device.add("hello", 0);
+    device.add("world", 100);
+    device.add(NULL, 0);
+    device.add("a longer chunk of data", 100);
+    device.add("!", 0);
+    ArRecordingDeviceConnection recorder(&device);
+    assert(strcmp(recorder.getPortName(), "scripted") == 0);
+    assert(recorder.startRecording(fileName));
+    assert(recorder.isRecording());
+    assert(recorder.write("cmd1", 4) == 4);
+    assert(recorder.read(buf, sizeof(buf)) == 5);
+    assert(recorder.read(buf, sizeof(buf)) == 5);
+    assert(recorder.write("cmd2", 4) == 4);
+    assert(recorder.read(buf, sizeof(buf)) == -1);
+    assert(recorder.read(buf, sizeof(buf)) == 22);
+    assert(recorder.read(buf, sizeof(buf)) == 1);
+    // nothing there isn't recorded
+    assert(recorder.read(buf, sizeof(buf)) == 0);
+    assert(recorder.getNumRecords() == 7);
+    recorder.stopRecording();
+    assert(!recorder.isRecording());
+  }
+  puts("OK");
+
+  puts("Replaying as fast as possible...");
+  {
+    ArReplayDeviceConnection replay;
+    assert(replay.open(fileName) == 0);
+    assert(replay.getStatus() == ArDeviceConnection::STATUS_OPEN);
+    assert(replay.getNumRecords() == 7);
+    printf("recording is %lld usecs long\n", replay.getRecordingUSecs());
+    assert(replay.getRecordingUSecs() >= 150000);
+    replay.setSpeed(0);
+    ArTime started;
+    errors = 0;
+    chunks.clear();
+    std::string data = readAll(&replay, sizeof(buf), &chunks, &errors);
+    printf("took %lld ms\n", started.mSecSinceLL());
+    assert(started.mSecSinceLL() < 50);
+    assert(data == "helloworlda longer chunk of data!");
+    assert(errors == 1);
+    // the same chunks as they were read
+    assert(chunks.size() == 4);
+    assert(chunks[2] == "a longer chunk of data");
+    assert(replay.read(buf, sizeof(buf)) == 0);
+
+    // the same writes
+    assert(replay.write("cmd1", 4) == 4);
+    assert(replay.write("cmd2", 4) == 4);
+    assert(replay.getNumWrites() == 2);
+    assert(replay.getNumWriteMismatches() == 0);
+    assert(replay.write("cmd3", 4) == 4);
+    assert(replay.getNumWriteMismatches() == 1);
+
+    // small reads split a chunk up
+    replay.rewind();
+    chunks.clear();
+    errors = 0;
+    data = readAll(&replay, 4, &chunks, &errors);
+    assert(data == "helloworlda longer chunk of data!");
+    assert(chunks[0] == "hell" && chunks[1] == "o");
+    assert(replay.write("cmd2", 4) == 4);
+    assert(replay.getNumWriteMismatches() == 2);
+  }
+  puts("OK");
+
+  puts("Replaying at the original speed...");
+  {
+    ArReplayDeviceConnection replay;
+    assert(replay.open(fileName) == 0);
+    ArTime started;
+    errors = 0;
+    // without waiting it's not time yet for the second chunk
+    assert(replay.read(buf, sizeof(buf), 0) == 5);
+    assert(replay.read(buf, sizeof(buf), 0) == 0);
+    std::string data = readAll(&replay, sizeof(buf), NULL, &errors);
+    printf("took %lld ms\n", started.mSecSinceLL());
+    assert(data == "worlda longer chunk of data!");
+    assert(started.mSecSinceLL() >= 150);
+    assert(started.mSecSinceLL() < 400);
+
+    // and twice as fast
+    replay.rewind();
+    replay.setSpeed(2);
+    started.setToNow();
+    data = readAll(&replay, sizeof(buf), NULL, &errors);
+    printf("took %lld ms at double speed\n", started.mSecSinceLL());
+    assert(data == "helloworlda longer chunk of data!");
+    assert(started.mSecSinceLL() >= 70);
+    assert(started.mSecSinceLL() < 200);
+
+    replay.close();
+    assert(replay.read(buf, sizeof(buf)) == -1);
+    assert(replay.openSimple());
+    assert(replay.getNumRecords() == 7);
+  }
+  puts("OK");
+
+  puts("Bad recordings...");
+  {
+    ArReplayDeviceConnection replay;
+    assert(replay.open("noSuchRecording.rec") == 
+	   ArReplayDeviceConnection::OPEN_FILE_NOT_FOUND);
+    FILE *file = fopen("deviceRecordingTestBad.rec", "wb");
+    fputs("not a recording", file);
+    fclose(file);
+    assert(replay.open("deviceRecordingTestBad.rec") == 
+	   ArReplayDeviceConnection::OPEN_BAD_FORMAT);
+    assert(replay.getStatus() == ArDeviceConnection::STATUS_OPEN_FAILED);
+
+    // cut off in the middle of the last record
+    file = fopen(fileName, "rb");
+    std::vector<char> contents(4096);
+    size_t len = fread(&contents[0], 1, contents.size(), file);
+    fclose(file);
+    file = fopen("deviceRecordingTestBad.rec", "wb");
+    fwrite(&contents[0], 1, len - 1, file);
+    fclose(file);
+    assert(replay.open("deviceRecordingTestBad.rec") == 0);
+    assert(replay.getNumRecords() == 6);
+    remove("deviceRecordingTestBad.rec");
+  }
+  puts("OK");
+
+  remove(fileName);
+  puts("All tests passed.");
+  return 0;
+}
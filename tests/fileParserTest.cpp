@@ -22,6 +22,9 @@ Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
 
 */
 #include "Aria/Aria.h"
+#include <assert.h>
+#include <string>
+#include <vector>
 
 /*
   This file tests the fileParser class and is a rudimentary example
@@ -77,8 +80,95 @@ bool argPrinter(ArArgumentBuilder *builder)
   return true;
 }
 
+// Records what each handler was given, for checking parsing with asserts
+std::vector<std::string> seen;
+ArFileParser *nestedParser = NULL;
+
+bool recorder(ArArgumentBuilder *builder)
+{
+  std::string entry = builder->getExtraString();
+  for (size_t i = 0; i < builder->getArgc(); i++)
+  {
+    entry += "|";
+    entry += builder->getArg(i);
+  }
+  seen.push_back(entry);
+  return true;
+}
+
+// Parses another line with the same parser while its builder is in use
+bool nester(ArArgumentBuilder *builder)
+{
+  char line[] = "second inner";
+  assert(nestedParser->parseLine(line));
+  // the outer builder must not have been disturbed by the nested parse
+  assert(builder->getArgc() == 2);
+  assert(strcmp(builder->getArg(0), "outer") == 0);
+  assert(strcmp(builder->getArg(1), "args") == 0);
+  return recorder(builder);
+}
+
+void testParsing()
+{
+  const char *fileName = "fileParserTestTmp.txt";
+  FILE *fp = ArUtil::fopen(fileName, "wb");
+  assert(fp);
+  fprintf(fp, "First one two ; comment\r\n");
+  fprintf(fp, "   # only a comment\n");
+  fprintf(fp, "\n");
+  fprintf(fp, "SECOND 3 4 5\n");
+  fprintf(fp, "nest outer args\n");
+  fprintf(fp, "unknown words here\n");
+  fprintf(fp, "first %s\n", std::string(12000, 'x').c_str());
+  fprintf(fp, "second last line without newline");
+  fclose(fp);
+
+  ArGlobalRetFunctor1<bool, ArArgumentBuilder *> recordFunctor(&recorder);
+  ArGlobalRetFunctor1<bool, ArArgumentBuilder *> nestFunctor(&nester);
+  ArFileParser parser("");
+  nestedParser = &parser;
+  parser.addHandler("first", &recordFunctor);
+  parser.addHandler("Second", &recordFunctor);
+  parser.addHandler("NEST", &nestFunctor);
+  // keywords are case insensitive
+  assert(!parser.addHandler("FIRST", &recordFunctor));
+
+  assert(parser.parseFile(fileName));
+  assert(seen.size() == 6);
+  assert(seen[0] == "first|one|two");
+  assert(seen[1] == "second|3|4|5");
+  assert(seen[2] == "second|inner");
+  assert(seen[3] == "nest|outer|args");
+  // lines longer than 9999 characters are handed over in pieces (the
+  // rest of this one has no handler)
+  assert(seen[4] == "first|" + std::string(9999 - 6, 'x'));
+  assert(seen[5] == "second|last|line|without|newline");
+
+  // the same through an open FILE
+  seen.clear();
+  fp = ArUtil::fopen(fileName, "r");
+  assert(fp);
+  char buffer[10000];
+  assert(parser.parseFile(fp, buffer, sizeof(buffer)));
+  fclose(fp);
+  assert(seen.size() == 6);
+  assert(seen[0] == "first|one|two");
+  assert(seen[4] == "first|" + std::string(9999 - 6, 'x'));
+  assert(seen[5] == "second|last|line|without|newline");
+
+  assert(parser.remHandler("FIRST"));
+  assert(!parser.remHandler("first", false));
+  seen.clear();
+  char line[] = "first one";
+  assert(parser.parseLine(line));
+  assert(seen.empty());
+  remove(fileName);
+}
+
 int main(int argc, char **argv)
 {
+  testParsing();
+
   ArGlobalRetFunctor1<bool, ArArgumentBuilder *> boolFunctor(&boolPrinter);
   ArGlobalRetFunctor1<bool, ArArgumentBuilder *> intFunctor(&intPrinter);
   ArGlobalRetFunctor1<bool, ArArgumentBuilder *> doubleFunctor(&doublePrinter);
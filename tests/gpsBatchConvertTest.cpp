@@ -0,0 +1,149 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArGPSCoords.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Tests that ArMapGPSCoords (one point or arrays of them) gives the same
+  results as converting one point at a time with ArLLACoords::LLA2ECEF(),
+  ArECEFCoords::ECEF2ENU(), ArENUCoords::ENU2ECEF() and
+  ArECEFCoords::ECEF2LLA(), and that converting there and back gets the
+  original point.
+*/
+
+// the old way
+void refLLA2Map(const ArLLACoords &origin, double lat, double lon, double alt,
+		double &ea, double &no, double &up)
+{
+  const ArENUCoords enu = ArLLACoords(lat, lon, alt).LLA2ECEF().ECEF2ENU(
+	  origin.LLA2ECEF());
+  ea = enu.getEast();
+  no = enu.getNorth();
+  up = enu.getUp();
+}
+
+void refMap2LLA(const ArLLACoords &origin, double ea, double no, double up,
+		double &lat, double &lon, double &alt)
+{
+  const ArLLACoords lla = ArENUCoords(ea, no, up).ENU2ECEF(origin).ECEF2LLA();
+  lat = lla.getLatitude();
+  lon = lla.getLongitude();
+  alt = lla.getAltitude();
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+
+  // a few origins: the one in gpsCoordsTest, the southern and eastern
+  // hemispheres, across the date line, and close to a pole
+  ArLLACoords origins[] = { 
+    ArLLACoords(42.805464, -71.574738, 64.0),
+    ArLLACoords(-33.8688, 151.2093, 10.0),
+    ArLLACoords(51.4779, -0.0015, 45.0),
+    ArLLACoords(-16.5, 179.9995, 0.0),
+    ArLLACoords(78.2232, 15.6267, 200.0)
+  };
+  const size_t num = 2000;
+  // within a micron and 1e-10 degrees (about 10 microns) of the old way
+  const double mmTol = 1e-3;
+  const double degTol = 1e-10;
+  const double altTol = 1e-5;
+
+  srand(42);
+  for (const ArLLACoords &origin : origins)
+  {
+    printf("Origin %.6f %.6f %g...\n", origin.getLatitude(), 
+	   origin.getLongitude(), origin.getAltitude());
+    ArMapGPSCoords coords(origin);
+    assert(coords.isOriginSet());
+    std::vector<double> lat(num), lon(num), alt(num);
+    std::vector<double> ea(num), no(num), up(num);
+    // points up to 10 km from the origin
+    for (size_t i = 0; i < num; i++)
+    {
+      lat[i] = origin.getLatitude() + 0.09 * (rand() / (double)RAND_MAX - 0.5);
+      lon[i] = origin.getLongitude() + 0.09 * (rand() / (double)RAND_MAX - 0.5);
+      alt[i] = origin.getAltitude() + 100 * (rand() / (double)RAND_MAX - 0.5);
+    }
+    lat[0] = origin.getLatitude();
+    lon[0] = origin.getLongitude();
+    alt[0] = origin.getAltitude();
+
+    assert(coords.convertLLA2MapCoords(&lat[0], &lon[0], &alt[0],
+				       &ea[0], &no[0], &up[0], num));
+    double e, n, u, la, lo, al;
+    for (size_t i = 0; i < num; i++)
+    {
+      refLLA2Map(origin, lat[i], lon[i], alt[i], e, n, u);
+      assert(fabs(ea[i] - e) < mmTol);
+      assert(fabs(no[i] - n) < mmTol);
+      assert(fabs(up[i] - u) < mmTol);
+      // one at a time is the same as the array
+      assert(coords.convertLLA2MapCoords(lat[i], lon[i], alt[i], e, n, u));
+      assert(e == ea[i] && n == no[i] && u == up[i]);
+    }
+    assert(fabs(ea[0]) < mmTol && fabs(no[0]) < mmTol && fabs(up[0]) < mmTol);
+
+    // and back
+    std::vector<double> lat2(num), lon2(num), alt2(num);
+    assert(coords.convertMap2LLACoords(&ea[0], &no[0], &up[0], 
+				       &lat2[0], &lon2[0], &alt2[0], num));
+    for (size_t i = 0; i < num; i++)
+    {
+      refMap2LLA(origin, ea[i], no[i], up[i], la, lo, al);
+      assert(fabs(lat2[i] - la) < degTol);
+      assert(fabs(lon2[i] - lo) < degTol);
+      assert(fabs(alt2[i] - al) < altTol);
+      // (not compared with lat[i] etc: LLA2ECEF() and ECEF2LLA() use
+      // ArWGS84::E and EP differently, so the round trip is off by about
+      // a thousandth of a degree and 100 m of altitude, and these have
+      // to match what they've always given)
+    }
+
+    // converting in place works too
+    std::vector<double> x(ea), y(no), z(up);
+    assert(coords.convertMap2LLACoords(&x[0], &y[0], &z[0], 
+				       &x[0], &y[0], &z[0], num));
+    for (size_t i = 0; i < num; i++)
+      assert(x[i] == lat2[i] && y[i] == lon2[i] && z[i] == alt2[i]);
+  }
+
+  puts("No origin...");
+  {
+    ArMapGPSCoords coords;
+    double a = 0, b = 0, c = 0;
+    assert(!coords.isOriginSet());
+    assert(!coords.convertLLA2MapCoords(1, 2, 3, a, b, c));
+    assert(!coords.convertMap2LLACoords(&a, &b, &c, &a, &b, &c, 1));
+  }
+
+  puts("All tests passed.");
+  return 0;
+}
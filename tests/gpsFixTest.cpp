@@ -0,0 +1,285 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArGPS.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+  Tests ArGPS fix publication: getLatestFix() sequence numbers for new
+  positions and refreshes, waitForNextFix() with and without a timeout,
+  readers getting consistent fixes while read() is publishing, and the
+  fix and sentence statistics (including sentences dropped for a bad
+  checksum).
+*/
+
+/// Device that returns whatever NMEA text was given to it
+class FakeConnection : public ArDeviceConnection
+{
+public:
+  FakeConnection() { setPortName("fake"); }
+  virtual int read(const char *data, unsigned int size, unsigned int) override
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    unsigned int n = (unsigned int)myInput.size();
+    if (n > size)
+      n = size;
+    memcpy(const_cast<char *>(data), myInput.data(), n);
+    myInput.erase(0, n);
+    return (int)n;
+  }
+  virtual int write(const char *, unsigned int size) override { return (int)size; }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+
+  void add(const std::string &text)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myInput += text;
+  }
+
+  std::mutex myMutex;
+  std::string myInput;
+};
+
+/// Wrap @a body in '$', checksum and CRLF
+std::string sentence(const std::string &body, bool badChecksum = false)
+{
+  unsigned char sum = 0;
+  for (size_t i = 0; i < body.size(); i++)
+    sum = (unsigned char)(sum ^ body[i]);
+  if (badChecksum)
+    sum = (unsigned char)(sum ^ 0xFF);
+  char buf[8];
+  snprintf(buf, sizeof(buf), "*%02X\r\n", sum);
+  return "$" + body + buf;
+}
+
+/// GPRMC with the same whole number of degrees for latitude and longitude
+std::string rmc(int seconds, int degrees)
+{
+  char buf[128];
+  snprintf(buf, sizeof(buf), "GPRMC,1200%02d.00,A,%02d00.0000,N,%03d00.0000,E,1.0,0.0,190626,,",
+	   seconds % 60, degrees, degrees);
+  return sentence(buf);
+}
+
+void testSequence()
+{
+  FakeConnection conn;
+  ArGPS gps;
+  gps.setDeviceConnection(&conn);
+
+  ArGPS::Fix fix = gps.getLatestFix();
+  assert(fix.sequence == 0);
+  assert(!fix.havePosition);
+  assert(!gps.waitForNextFix(&fix, 0, 0));
+
+  conn.add(rmc(1, 42));
+  assert(gps.read() & ArGPS::ReadUpdated);
+  fix = gps.getLatestFix();
+  assert(fix.sequence == 1);
+  assert(fix.havePosition);
+  assert(fabs(fix.latitude - 42) < 1e-9 && fabs(fix.longitude - 42) < 1e-9);
+  assert(fix.haveSpeed);
+  assert(fix.receivedUSecs != 0);
+
+  // GGA adds fix type and satellites to the same fix
+  conn.add(sentence("GPGGA,120001.00,4200.0000,N,04200.0000,E,2,07,1.5,100.0,M,0.0,M,,"));
+  gps.read();
+  ArGPS::Fix refreshed = gps.getLatestFix();
+  assert(refreshed.sequence == 1);
+  assert(refreshed.receivedUSecs == fix.receivedUSecs);
+  assert(refreshed.fixType == ArGPS::DGPSFix);
+  assert(refreshed.numSatellitesTracked == 7);
+  assert(refreshed.haveHDOP && fabs(refreshed.HDOP - 1.5) < 1e-9);
+  assert(refreshed.haveAltitude && fabs(refreshed.altitude - 100) < 1e-9);
+
+  conn.add(rmc(2, 43));
+  gps.read();
+  fix = gps.getLatestFix();
+  assert(fix.sequence == 2);
+  assert(fabs(fix.latitude - 43) < 1e-9);
+  assert(fix.receivedUSecs >= refreshed.receivedUSecs);
+
+  assert(gps.waitForNextFix(&fix, 1, 0));
+  assert(fix.sequence == 2);
+  assert(!gps.waitForNextFix(&fix, 2, 0));
+}
+
+void testWait()
+{
+  FakeConnection conn;
+  ArGPS gps;
+  gps.setDeviceConnection(&conn);
+
+  ArTime started;
+  ArGPS::Fix fix;
+  assert(!gps.waitForNextFix(&fix, 0, 50));
+  assert(started.mSecSince() >= 45);
+
+  std::thread reader([&] {
+    ArUtil::sleep(20);
+    conn.add(rmc(1, 10));
+    gps.read();
+  });
+  assert(gps.waitForNextFix(&fix, 0, 5000));
+  assert(fix.sequence == 1);
+  assert(fabs(fix.latitude - 10) < 1e-9);
+  reader.join();
+
+  // refreshes don't wake waiters
+  std::thread refresher([&] {
+    conn.add(sentence("GPGGA,120001.00,1000.0000,N,01000.0000,E,1,05,1.0,5.0,M,0.0,M,,"));
+    gps.read();
+  });
+  assert(!gps.waitForNextFix(&fix, 1, 50));
+  refresher.join();
+  assert(gps.getLatestFix().numSatellitesTracked == 5);
+}
+
+void testConcurrentReaders()
+{
+  FakeConnection conn;
+  ArGPS gps;
+  gps.setDeviceConnection(&conn);
+
+  const int numFixes = 2000;
+  std::atomic<bool> done(false);
+  std::thread writer([&] {
+    for (int i = 1; i <= numFixes; i++)
+    {
+      conn.add(rmc(i, i % 80));
+      gps.read();
+    }
+    done = true;
+  });
+
+  unsigned long long last = 0;
+  unsigned long numRead = 0;
+  while (!done)
+  {
+    ArGPS::Fix fix = gps.getLatestFix();
+    // latitude and longitude come from the same sentence, never mixed
+    assert(fix.latitude == fix.longitude);
+    assert(fix.sequence >= last);
+    last = fix.sequence;
+    numRead++;
+  }
+  writer.join();
+  ArGPS::Fix fix = gps.getLatestFix();
+  assert(fix.sequence == numFixes);
+  assert(fabs(fix.latitude - numFixes % 80) < 1e-9);
+  printf("gpsFixTest: %lu fixes read while %d were published\n", numRead, numFixes);
+}
+
+void testStats()
+{
+  FakeConnection conn;
+  ArGPS gps;
+  gps.setDeviceConnection(&conn);
+
+  ArGPS::FixStats stats = gps.getFixStats();
+  assert(stats.numFixes == 0 && stats.numParses == 0 && stats.numSentences == 0);
+
+  for (int i = 0; i < 5; i++)
+  {
+    conn.add(rmc(i, 20 + i));
+    gps.read();
+    ArUtil::sleep(10);
+  }
+  conn.add(sentence("GPRMC,120010.00,A,3000.0000,N,03000.0000,E,,,190626,,", true));
+  gps.read();
+  conn.add(sentence("GPXXX,unhandled"));
+  gps.read();
+
+  stats = gps.getFixStats();
+  assert(stats.numFixes == 5);
+  assert(stats.numParses == 5); // the dropped and unhandled sentences updated nothing
+  assert(stats.numSentences == 7);
+  assert(stats.numDroppedSentences == 1);
+  assert(stats.numHandledSentences == 5);
+  assert(stats.minFixIntervalMSecs >= 9);
+  assert(stats.maxFixIntervalMSecs >= stats.meanFixIntervalMSecs);
+  assert(stats.meanFixIntervalMSecs >= stats.minFixIntervalMSecs);
+  assert(stats.fixIntervalJitterMSecs >= 0);
+  assert(stats.maxParseUSecs >= 0 && stats.meanParseUSecs <= (double)stats.maxParseUSecs);
+  assert(gps.getLatestFix().sequence == 5);
+  gps.logFixStats();
+
+  gps.resetFixStats();
+  stats = gps.getFixStats();
+  assert(stats.numFixes == 0 && stats.numSentences == 0 && stats.numDroppedSentences == 0);
+  conn.add(rmc(20, 40));
+  gps.read();
+  conn.add(rmc(21, 41));
+  gps.read();
+  stats = gps.getFixStats();
+  assert(stats.numFixes == 2);
+  assert(stats.numSentences == 2);
+  assert(stats.maxFixIntervalMSecs > 0 && stats.minFixIntervalMSecs == stats.maxFixIntervalMSecs);
+
+  // stats can be read from another thread while read() is counting
+  std::atomic<bool> done(false);
+  std::thread statsReader([&gps, &done]() {
+    unsigned long lastSentences = 0;
+    while (!done)
+    {
+      const ArGPS::FixStats s = gps.getFixStats();
+      assert(s.numSentences >= lastSentences);
+      assert(s.numHandledSentences + s.numDroppedSentences <= s.numSentences);
+      lastSentences = s.numSentences;
+    }
+  });
+  for (int i = 0; i < 200; i++)
+  {
+    conn.add(rmc(i % 80, 42 + i));
+    gps.read();
+  }
+  done = true;
+  statsReader.join();
+  assert(gps.getFixStats().numSentences == 202);
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  testSequence();
+  testWait();
+  testConcurrentReaders();
+  testStats();
+  puts("gpsFixTest: all tests passed");
+  return 0;
+}
@@ -0,0 +1,188 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArLaser.h"
+#include "Aria/ArSensorReading.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Tests the per beam table lasers use to fill in their raw readings
+  (ArLaser::laserSetBeams() and laserFillBeams()) against setting up
+  each ArSensorReading with resetSensorPosition() and newData(), and
+  that the table is only rebuilt when the scan's geometry changes.
+*/
+
+class TestLaser : public ArLaser
+{
+public:
+  TestLaser() : ArLaser(1, "test", 30000, false, false) {}
+  virtual bool blockingConnect() override { return true; }
+  virtual bool asyncConnect() override { return true; }
+  virtual bool disconnect() override { return true; }
+  virtual bool isConnected() override { return true; }
+  virtual bool isTryingToConnect() override { return false; }
+  virtual void *runThread(void *) override { return NULL; }
+
+  bool setBeams(size_t num, double start, double increment)
+  { return laserSetBeams(num, start, increment); }
+
+  void moveBeam(size_t beam, double x, double y, double th)
+  { laserMoveBeam(beam, x, y, th); }
+
+  void fill(const std::vector<unsigned int> &ranges, const ArPose &pose,
+	    unsigned int counter, const ArTime &time, size_t firstBeam = 0)
+  {
+    for (size_t i = firstBeam; i < ranges.size(); i++)
+    {
+      myBeamRanges[i] = ranges[i];
+      myBeamIgnore[i] = (i % 7 == 0);
+      myBeamExtraInts[i] = (int)(i % 256);
+    }
+    laserFillBeams(pose, pose, ArTransform(pose), counter, time, firstBeam);
+  }
+};
+
+double randomIn(double low, double high)
+{
+  return low + (high - low) * (double)rand() / (double)RAND_MAX;
+}
+
+// checks the laser's readings against ones set up the old way
+void checkScan(TestLaser &laser, const std::vector<unsigned int> &ranges,
+	       double start, double increment, const ArPose &pose,
+	       unsigned int counter, const ArTime &time)
+{
+  const std::list<ArSensorReading *> *raw = laser.getRawReadings();
+  assert(raw->size() == ranges.size());
+  ArSensorReading expected;
+  size_t i = 0;
+  for (auto it = raw->begin(); it != raw->end(); ++it, ++i)
+  {
+    const ArSensorReading *reading = (*it);
+    expected.resetSensorPosition(
+	    ArMath::roundInt(laser.getSensorPositionX()),
+	    ArMath::roundInt(laser.getSensorPositionY()),
+	    ArMath::fixAngle(start + increment * (double)i));
+    expected.newData(ranges[i], pose, pose, ArTransform(pose), counter, time,
+		     i % 7 == 0, (int)(i % 256));
+    assert(reading->getSensorTh() == expected.getSensorTh());
+    assert(reading->getSensorX() == expected.getSensorX());
+    assert(reading->getSensorY() == expected.getSensorY());
+    assert(reading->getRange() == expected.getRange());
+    assert(reading->getLocalX() == expected.getLocalX());
+    assert(reading->getLocalY() == expected.getLocalY());
+    assert(reading->getX() == expected.getX());
+    assert(reading->getY() == expected.getY());
+    assert(reading->getPose().getTh() == expected.getPose().getTh());
+    assert(reading->getPoseTaken() == expected.getPoseTaken());
+    assert(reading->getCounterTaken() == counter);
+    assert(reading->getIgnoreThisReading() == expected.getIgnoreThisReading());
+    assert(reading->getExtraInt() == expected.getExtraInt());
+  }
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse);
+  srand(1);
+
+  TestLaser laser;
+  laser.setSensorPosition(150.4, -20.6, 10);
+  std::vector<unsigned int> ranges;
+  ArTime time;
+
+  // the first call sets everything up, after that the same geometry
+  // doesn't rebuild
+  assert(laser.setBeams(541, -125, 0.5));
+  assert(!laser.setBeams(541, -125, 0.5));
+  const ArSensorReading *first = laser.getRawReadings()->front();
+
+  unsigned int counter = 1;
+  for (int scan = 0; scan < 50; scan++, counter++)
+  {
+    ranges.resize(541);
+    for (size_t i = 0; i < ranges.size(); i++)
+      ranges[i] = (unsigned int)randomIn(0, 30000);
+    const ArPose pose(randomIn(-10000, 10000), randomIn(-10000, 10000),
+		      randomIn(-180, 180));
+    assert(!laser.setBeams(541, -125, 0.5));
+    laser.fill(ranges, pose, counter, time);
+    checkScan(laser, ranges, -125, 0.5, pose, counter, time);
+  }
+  // the readings were reused the whole time
+  assert(laser.getRawReadings()->front() == first);
+
+  // changing the increment, the start or the sensor position rebuilds
+  assert(laser.setBeams(541, -125, 0.25));
+  assert(laser.setBeams(541, -100, 0.25));
+  laser.setSensorPosition(0, 0, 0);
+  assert(laser.setBeams(541, -100, 0.25));
+  assert(!laser.setBeams(541, -100, 0.25));
+  ranges.assign(541, 1000);
+  laser.fill(ranges, ArPose(100, 200, 300), counter, time);
+  checkScan(laser, ranges, -100, 0.25, ArPose(100, 200, 300), counter, time);
+  counter++;
+
+  // and so does the number of beams, both up and down, without
+  // replacing the readings that are already there
+  assert(laser.setBeams(1081, 135, -0.25));
+  assert(laser.getRawReadings()->size() == 1081);
+  assert(laser.getRawReadings()->front() == first);
+  ranges.assign(1081, 2500);
+  laser.fill(ranges, ArPose(-50, 75, -170), counter, time);
+  checkScan(laser, ranges, 135, -0.25, ArPose(-50, 75, -170), counter, time);
+  counter++;
+  assert(laser.setBeams(181, -90, 1));
+  assert(laser.getRawReadings()->size() == 181);
+  assert(laser.getRawReadings()->front() == first);
+  ranges.assign(181, 800);
+  laser.fill(ranges, ArPose(), counter, time);
+  checkScan(laser, ranges, -90, 1, ArPose(), counter, time);
+
+  // filling in from a later beam leaves the earlier ones alone
+  const unsigned int oldCounter = counter;
+  counter++;
+  laser.fill(ranges, ArPose(), counter, time, 100);
+  size_t i = 0;
+  for (auto it = laser.getRawReadings()->begin(); 
+       it != laser.getRawReadings()->end(); ++it, ++i)
+    assert((*it)->getCounterTaken() == (i < 100 ? oldCounter : counter));
+
+  // moving readings (like interpolating does) keeps the table, and the
+  // next fill puts them back
+  for (i = 0; i < 181; i += 2)
+    laser.moveBeam(i, 10, -10, 45);
+  assert(laser.getRawReadings()->front()->getSensorTh() == 45);
+  assert(!laser.setBeams(181, -90, 1));
+  counter++;
+  laser.fill(ranges, ArPose(20, 30, 40), counter, time);
+  checkScan(laser, ranges, -90, 1, ArPose(20, 30, 40), counter, time);
+
+  printf("All tests passed\n");
+  return 0;
+}
@@ -0,0 +1,228 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+
+#include "Aria/ArLaser.h"
+#include "Aria/ArLaserFilter.h"
+#include <cassert>
+#include <vector>
+
+// Laser that just hands out whatever scan it was last given
+class TestLaser : public ArLaser
+{
+public:
+  TestLaser() : ArLaser(1, "test", 30000, false, false)
+  {
+    myRawReadings = new std::list<ArSensorReading *>;
+    setCurrentDrawingData(new ArDrawingData("polyDots", ArColor(0, 0, 0), 80, 75), true);
+    setCumulativeDrawingData(new ArDrawingData("polyDots", ArColor(0, 0, 0), 100, 60), true);
+  }
+  virtual bool blockingConnect() override { return true; }
+  virtual bool asyncConnect() override { return true; }
+  virtual bool disconnect() override { return true; }
+  virtual bool isConnected() override { return true; }
+  virtual bool isTryingToConnect() override { return false; }
+  virtual void *runThread(void *) override { return NULL; }
+
+  void setScan(const std::vector<unsigned int> &ranges, 
+	       const std::vector<int> &intensities,
+	       double startAngle, double increment)
+  {
+    while (myRawReadings->size() < ranges.size())
+      myRawReadings->push_back(new ArSensorReading);
+    while (myRawReadings->size() > ranges.size())
+    {
+      delete myRawReadings->back();
+      myRawReadings->pop_back();
+    }
+    ArTransform trans;
+    ArTime now;
+    std::list<ArSensorReading *>::iterator it = myRawReadings->begin();
+    for (size_t i = 0; i < ranges.size(); i++, it++)
+    {
+      (*it)->resetSensorPosition(0, 0, startAngle + increment * (double)i);
+      (*it)->newData(ranges[i], ArPose(), ArPose(), trans, myCounter, now, 
+		     false, intensities.empty() ? 0 : intensities[i]);
+    }
+    myCounter++;
+  }
+protected:
+  unsigned int myCounter = 1;
+};
+
+// Lets us call processReadings directly instead of from a robot task
+class TestLaserFilter : public ArLaserFilter
+{
+public:
+  TestLaserFilter(ArLaser *laser) : ArLaserFilter(laser) {}
+  void process() { processReadings(); }
+  std::vector<bool> getIgnored() 
+  {
+    std::vector<bool> ret;
+    for (std::list<ArSensorReading *>::const_iterator it = getRawReadings()->begin();
+	 it != getRawReadings()->end(); ++it)
+      ret.push_back((*it)->getIgnoreThisReading());
+    return ret;
+  }
+};
+
+static int countIgnored(const std::vector<bool> &ignored)
+{
+  int ret = 0;
+  for (size_t i = 0; i < ignored.size(); i++)
+    if (ignored[i])
+      ret++;
+  return ret;
+}
+
+static int stageCalls = 0;
+static void countingStage(ArLaserFilter::Scan *scan)
+{
+  ++stageCalls;
+  assert(scan->size() == scan->angles.size());
+  // ignore the first reading
+  if (scan->size() > 0)
+    scan->ignore[0] = 1;
+}
+
+int main()
+{
+  TestLaser laser;
+  TestLaserFilter filter(&laser);
+
+  // a flat wall with one spike in the middle, at half degree increments
+  std::vector<unsigned int> ranges(181, 2000);
+  std::vector<int> intensities(181, 100);
+  ranges[90] = 6000;
+  intensities[45] = 10;
+
+  puts("No filtering, nothing should be ignored.");
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  assert(filter.getRawReadings()->size() == 181);
+  assert(countIgnored(filter.getIgnored()) == 0);
+
+  puts("All neighbor factor should remove the spike only.");
+  filter.setAngleToCheck(1);
+  filter.setAllFactor(1.5);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  std::vector<bool> ignored = filter.getIgnored();
+  assert(countIgnored(ignored) == 1);
+  assert(ignored[90]);
+  filter.setAllFactor(-1);
+
+  puts("Any neighbor factor should remove the spike only.");
+  filter.setAnyFactor(1.5);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  assert(countIgnored(ignored) == 1);
+  assert(ignored[90]);
+  filter.setAnyFactor(-1);
+
+  puts("Any neighbor min range should remove readings near a close one.");
+  std::vector<unsigned int> closeRanges(ranges);
+  closeRanges[20] = 100;
+  filter.setAnyMinRange(200);
+  filter.setAnyMinRangeAngles(0, 180);
+  laser.setScan(closeRanges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  // the reading itself plus two on either side (1 degree at 0.5 increment)
+  assert(countIgnored(ignored) == 5);
+  assert(ignored[18] && ignored[19] && ignored[20] && ignored[21] && ignored[22]);
+  filter.setAnyMinRange(-1);
+
+  puts("Range clamp.");
+  filter.setClampRange(-1, 5000);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  assert(countIgnored(ignored) == 1);
+  assert(ignored[90]);
+  filter.setClampRange(2500, -1);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  assert(countIgnored(filter.getIgnored()) == 180);
+  filter.setClampRange(-1, -1);
+
+  puts("Median.");
+  filter.setMedian(2, 500);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  assert(countIgnored(ignored) == 1);
+  assert(ignored[90]);
+  filter.setMedian(0, -1);
+
+  puts("Intensity threshold.");
+  filter.setMinIntensity(50);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  assert(countIgnored(ignored) == 1);
+  assert(ignored[45]);
+
+  puts("Chained stages, including one added with addStage.");
+  ArGlobalFunctor1<ArLaserFilter::Scan *> stageCB(&countingStage);
+  filter.addStage(&stageCB);
+  filter.setAllFactor(1.5);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  ignored = filter.getIgnored();
+  assert(stageCalls == 1);
+  assert(countIgnored(ignored) == 3);
+  assert(ignored[0] && ignored[45] && ignored[90]);
+  filter.remStage(&stageCB);
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  assert(stageCalls == 1);
+  assert(countIgnored(filter.getIgnored()) == 2);
+  filter.setAllFactor(-1);
+
+  puts("The filter keeps one reading per reading of the laser, and reuses them.");
+  const ArSensorReading *first = filter.getRawReadings()->front();
+  std::vector<unsigned int> fewerRanges(ranges.begin(), ranges.begin() + 91);
+  std::vector<int> fewerIntensities(intensities.begin(), intensities.begin() + 91);
+  laser.setScan(fewerRanges, fewerIntensities, -45, 0.5);
+  filter.process();
+  assert(filter.getRawReadings()->size() == 91);
+  assert(filter.getRawReadings()->front() == first);
+  std::list<ArSensorReading *>::const_iterator rdIt = laser.getRawReadings()->begin();
+  for (std::list<ArSensorReading *>::const_iterator it = filter.getRawReadings()->begin();
+       it != filter.getRawReadings()->end(); ++it, ++rdIt)
+  {
+    assert((*it)->getRange() == (*rdIt)->getRange());
+    assert((*it)->getSensorTh() == (*rdIt)->getSensorTh());
+    assert((*it)->getX() == (*rdIt)->getX() && (*it)->getY() == (*rdIt)->getY());
+    assert((*it)->getExtraInt() == (*rdIt)->getExtraInt());
+  }
+  laser.setScan(ranges, intensities, -45, 0.5);
+  filter.process();
+  assert(filter.getRawReadings()->size() == 181);
+  assert(filter.getRawReadings()->front() == first);
+
+  puts("ok test successful");
+  return 0;
+}
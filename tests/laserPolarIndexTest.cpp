@@ -0,0 +1,191 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArLaser.h"
+#include "Aria/ArRobot.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Tests ArLaser::currentReadingPolar(), which searches an index of the
+  current buffer sorted by angle, against searching the buffer itself
+  with ArRangeBuffer::getClosestPolar() (which is what
+  ArRangeDevice::currentReadingPolar() does), and that the index only
+  gets rebuilt when the scan or the robot pose changes.  No robot
+  connection is needed.
+*/
+
+// Laser that just hands out whatever scan it was last given
+class TestLaser : public ArLaser
+{
+public:
+  TestLaser() : ArLaser(1, "test", 30000, false, false)
+  {
+    myRawReadings = new std::list<ArSensorReading *>;
+  }
+  virtual bool blockingConnect() override { return true; }
+  virtual bool asyncConnect() override { return true; }
+  virtual bool disconnect() override { return true; }
+  virtual bool isConnected() override { return true; }
+  virtual bool isTryingToConnect() override { return false; }
+  virtual void *runThread(void *) override { return NULL; }
+
+  // ranges start at startAngle and go counterclockwise by increment,
+  // taken with the robot at robotPose
+  void setScan(const std::vector<unsigned int> &ranges, double startAngle,
+	       double increment, const ArPose &robotPose)
+  {
+    while (myRawReadings->size() < ranges.size())
+      myRawReadings->push_back(new ArSensorReading);
+    while (myRawReadings->size() > ranges.size())
+    {
+      delete myRawReadings->back();
+      myRawReadings->pop_back();
+    }
+    ArTransform trans(robotPose);
+    ArTime now;
+    std::list<ArSensorReading *>::iterator it = myRawReadings->begin();
+    for (size_t i = 0; i < ranges.size(); i++, it++)
+    {
+      (*it)->resetSensorPosition(0, 0, startAngle + increment * (double)i);
+      (*it)->newData(ranges[i], robotPose, robotPose, trans, myCounter, now);
+    }
+    myCounter++;
+    laserProcessReadings();
+  }
+protected:
+  unsigned int myCounter = 1;
+};
+
+double randomIn(double low, double high)
+{
+  return low + (high - low) * (double)rand() / (double)RAND_MAX;
+}
+
+int numChecked = 0;
+int numFound = 0;
+
+void check(TestLaser &laser, const ArPose &pose, double start, double end)
+{
+  double angle = -999, expectedAngle = -999;
+  const double dist = laser.currentReadingPolar(start, end, &angle);
+  const double expected = laser.getCurrentRangeBuffer().getClosestPolar(
+	  start, end, pose, laser.getMaxRange(), &expectedAngle);
+  if (dist != expected || angle != expectedAngle)
+  {
+    printf("Mismatch for %g to %g at %.2f,%.2f,%.2f: got %.6f at %.6f, expected %.6f at %.6f\n",
+	   start, end, pose.getX(), pose.getY(), pose.getTh(),
+	   dist, angle, expected, expectedAngle);
+    assert(dist == expected);
+    assert(angle == expectedAngle);
+  }
+  numChecked++;
+  if (dist < laser.getMaxRange())
+    numFound++;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse);
+  srand(1);
+
+  ArRobot robot;
+  TestLaser laser;
+  laser.setRobot(&robot);
+  laser.setMaxRange(10000);
+
+  const double increments[] = { 0.25, 0.5, 1.0 };
+  std::vector<unsigned int> ranges;
+  for (int scan = 0; scan < 60; scan++)
+  {
+    const double increment = increments[scan % 3];
+    const size_t numReadings = (size_t)(270 / increment) + 1;
+    ArPose pose(randomIn(-5000, 5000), randomIn(-5000, 5000),
+		randomIn(-180, 180));
+    // some scans with the robot pointing right along the wrap at 180
+    if (scan % 10 == 0)
+      pose.setTh(180);
+    robot.moveTo(pose);
+
+    ranges.resize(numReadings);
+    for (size_t i = 0; i < numReadings; i++)
+    {
+      ranges[i] = (unsigned int)randomIn(200, 12000);
+      // a few duplicate ranges for ties, and a few right at the robot
+      if (rand() % 20 == 0)
+	ranges[i] = 3000;
+      if (rand() % 100 == 0)
+	ranges[i] = 0;
+    }
+    laser.setScan(ranges, -135, increment, pose);
+
+    const unsigned long long builds = laser.getPolarIndexBuilds();
+    for (int q = 0; q < 200; q++)
+    {
+      double start = randomIn(-200, 200);
+      double end = randomIn(-200, 200);
+      // sectors that start or end exactly on a beam
+      if (q % 4 == 0)
+	start = -135 + increment * (double)(rand() % (int)numReadings);
+      if (q % 8 == 0)
+	end = -135 + increment * (double)(rand() % (int)numReadings);
+      check(laser, pose, start, end);
+    }
+    check(laser, pose, 10, 10);
+    check(laser, pose, -180, 180);
+    check(laser, pose, 180, -180);
+    check(laser, pose, 179.9, -179.9);
+    check(laser, pose, -179.9, 179.9);
+    check(laser, pose, 0, 360);
+    // everything above is one scan at one pose, so one index
+    assert(laser.getPolarIndexBuilds() == builds + 1);
+
+    // moving the robot needs a new index even with the same scan
+    pose.setX(pose.getX() + 100);
+    robot.moveTo(pose);
+    check(laser, pose, -90, 90);
+    check(laser, pose, 90, -90);
+    assert(laser.getPolarIndexBuilds() == builds + 2);
+
+    // and so does transforming the buffer
+    laser.applyTransform(ArTransform(ArPose(10, 20, 5)));
+    check(laser, pose, -45, 45);
+    assert(laser.getPolarIndexBuilds() == builds + 3);
+  }
+
+  // nothing in the buffer
+  laser.setScan(std::vector<unsigned int>(100, 20000), -50, 1, ArPose());
+  robot.moveTo(ArPose());
+  check(laser, ArPose(), -90, 90);
+  assert(laser.getCurrentRangeBuffer().getBuffer().empty());
+  assert(laser.currentReadingPolar(-90, 90) == laser.getMaxRange());
+
+  printf("%d sectors checked (%d with a reading in them), all matched\n",
+	 numChecked, numFound);
+  printf("All tests passed\n");
+  return 0;
+}
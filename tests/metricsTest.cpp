@@ -0,0 +1,318 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArMetrics.h"
+#include "Aria/ArRangeDevice.h"
+#include "Aria/ArSocket.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+  Tests ArMetrics: counters added to from several threads, gauges,
+  histogram buckets, callback gauges (including the range device
+  buffer gauges), the Prometheus text and JSON output, and fetching
+  them from ArMetricsServer over a local socket.
+*/
+
+const ArMetrics::Sample *findSample(const std::vector<ArMetrics::Sample> &samples,
+				    const std::string &name, 
+				    const std::string &labels)
+{
+  for (size_t i = 0; i < samples.size(); i++)
+    if (samples[i].name == name && samples[i].labels == labels)
+      return &samples[i];
+  return NULL;
+}
+
+bool contains(const std::string &str, const std::string &part)
+{
+  return str.find(part) != std::string::npos;
+}
+
+void testCounter()
+{
+  ArMetricCounter *counter = ArMetrics::getCounter("test_counter_total", "A test counter");
+  assert(counter != NULL);
+  // the same name and labels give the same counter
+  assert(ArMetrics::getCounter("test_counter_total") == counter);
+  assert(ArMetrics::getCounter("test_counter_total", "", "a=\"1\"") != counter);
+  // a name can only be one type
+  assert(ArMetrics::getGauge("test_counter_total") == NULL);
+  assert(ArMetrics::getHistogram("test_counter_total", "", "b=\"2\"") == NULL);
+
+  const int numThreads = 8;
+  const int numAdds = 100000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++)
+    threads.push_back(std::thread([counter]() {
+	  for (int i = 0; i < numAdds; i++)
+	    counter->add();
+	}));
+  for (size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  assert(counter->get() == (unsigned long long)numThreads * numAdds);
+  counter->add(5);
+  assert(counter->get() == (unsigned long long)numThreads * numAdds + 5);
+  counter->reset();
+  assert(counter->get() == 0);
+  counter->add(3);
+}
+
+void testGauge()
+{
+  ArMetricGauge *gauge = ArMetrics::getGauge("test_gauge", "A test gauge");
+  assert(gauge != NULL && gauge->get() == 0);
+  gauge->set(2.5);
+  gauge->add(-1);
+  assert(gauge->get() == 1.5);
+}
+
+void testHistogram()
+{
+  ArMetricHistogram *histogram = ArMetrics::getHistogram(
+	  "test_latency_msecs", "A test histogram", "", {1, 10, 100});
+  assert(histogram != NULL);
+  assert(histogram->getBounds().size() == 3);
+  histogram->observe(0.5);
+  histogram->observe(1); // bounds are inclusive
+  histogram->observe(5);
+  histogram->observe(100);
+  histogram->observe(1000);
+  std::vector<unsigned long long> counts = histogram->getBucketCounts();
+  assert(counts.size() == 4);
+  assert(counts[0] == 2 && counts[1] == 1 && counts[2] == 1 && counts[3] == 1);
+  assert(histogram->getCount() == 5);
+  assert(histogram->getSum() == 1106.5);
+
+  // the default bounds, and the bounds are kept from the first time
+  ArMetricHistogram *defaultHistogram = ArMetrics::getHistogram("test_default_msecs");
+  assert(defaultHistogram->getBounds() == ArMetrics::getDefaultMSecBounds());
+  assert(ArMetrics::getHistogram("test_latency_msecs", "", "", {7}) == histogram);
+}
+
+double theCallbackValue = 42;
+double getCallbackValue() { return theCallbackValue; }
+
+class TestRangeDevice : public ArRangeDevice
+{
+public:
+  TestRangeDevice() : ArRangeDevice(10, 20, "test device", 5000) {}
+  void addCurrent(double x, double y) { myCurrentBuffer.addReading(x, y); }
+  // like ArLaser::laserSetName() 
+  void rename(const char *name) { myName = name; registerMetrics(); }
+};
+
+void testCallbackGauges()
+{
+  ArGlobalRetFunctor<double> callback(&getCallbackValue);
+  ArMetrics::addCallbackGauge("test_callback", "A callback gauge", 
+			      ArMetrics::makeLabels("source", "test"), &callback);
+  std::vector<ArMetrics::Sample> samples = ArMetrics::getSnapshot();
+  const ArMetrics::Sample *sample = findSample(samples, "test_callback", "source=\"test\"");
+  assert(sample != NULL && sample->type == ArMetrics::GAUGE && sample->value == 42);
+  theCallbackValue = 7;
+  samples = ArMetrics::getSnapshot();
+  assert(findSample(samples, "test_callback", "source=\"test\"")->value == 7);
+  ArMetrics::remCallbackGauge(&callback);
+  samples = ArMetrics::getSnapshot();
+  assert(findSample(samples, "test_callback", "source=\"test\"") == NULL);
+
+  // range devices report their buffer sizes (spaces in names become _)
+  {
+    TestRangeDevice device;
+    device.addCurrent(1, 2);
+    device.addCurrent(3, 4);
+    samples = ArMetrics::getSnapshot();
+    sample = findSample(samples, "aria_range_device_current_readings", 
+			"device=\"test_device\"");
+    assert(sample != NULL && sample->value == 2);
+    sample = findSample(samples, "aria_range_device_cumulative_readings", 
+			"device=\"test_device\"");
+    assert(sample != NULL && sample->value == 0);
+  }
+  samples = ArMetrics::getSnapshot();
+  assert(findSample(samples, "aria_range_device_current_readings", 
+		    "device=\"test_device\"") == NULL);
+
+  // renaming a device (as lasers do after construction) moves its gauges
+  {
+    TestRangeDevice device;
+    device.rename("test_device_1");
+    device.addCurrent(1, 2);
+    samples = ArMetrics::getSnapshot();
+    assert(findSample(samples, "aria_range_device_current_readings", 
+		      "device=\"test_device\"") == NULL);
+    sample = findSample(samples, "aria_range_device_current_readings", 
+			"device=\"test_device_1\"");
+    assert(sample != NULL && sample->value == 1);
+  }
+
+  // the same name and labels can't be registered twice
+  ArGlobalRetFunctor<double> other(&getCallbackValue);
+  assert(ArMetrics::addCallbackGauge("test_callback", "", 
+				     ArMetrics::makeLabels("source", "test"), 
+				     &callback));
+  assert(!ArMetrics::addCallbackGauge("test_callback", "", 
+				      ArMetrics::makeLabels("source", "test"), 
+				      &other));
+  assert(ArMetrics::addCallbackGauge("test_callback", "", 
+				     ArMetrics::makeLabels("source", "other"), 
+				     &other));
+  samples = ArMetrics::getSnapshot();
+  size_t found = 0;
+  for (size_t i = 0; i < samples.size(); i++)
+    if (samples[i].name == "test_callback")
+      found++;
+  assert(found == 2);
+  ArMetrics::remCallbackGauge(&callback);
+  ArMetrics::remCallbackGauge(&other);
+}
+
+void testLabels()
+{
+  assert(ArMetrics::makeLabels("a", "b") == "a=\"b\"");
+  assert(ArMetrics::makeLabels("a", "q\"b\\s\nn") == "a=\"q\\\"b\\\\s\\nn\"");
+  assert(ArMetrics::makeLabels("a", "1", "b", "2") == "a=\"1\",b=\"2\"");
+}
+
+void testText()
+{
+  std::vector<ArMetrics::Sample> samples = ArMetrics::getSnapshot();
+  // sorted by name and then labels
+  for (size_t i = 1; i < samples.size(); i++)
+    assert(samples[i - 1].name < samples[i].name || 
+	   (samples[i - 1].name == samples[i].name && 
+	    samples[i - 1].labels <= samples[i].labels));
+
+  std::string text = ArMetrics::toPrometheusText(samples);
+  assert(contains(text, "# HELP test_counter_total A test counter\n"
+		  "# TYPE test_counter_total counter\n"
+		  "test_counter_total 3\n"
+		  "test_counter_total{a=\"1\"} 0\n"));
+  assert(contains(text, "# TYPE test_gauge gauge\ntest_gauge 1.5\n"));
+  assert(contains(text, "# TYPE test_latency_msecs histogram\n"
+		  "test_latency_msecs_bucket{le=\"1\"} 2\n"
+		  "test_latency_msecs_bucket{le=\"10\"} 3\n"
+		  "test_latency_msecs_bucket{le=\"100\"} 4\n"
+		  "test_latency_msecs_bucket{le=\"+Inf\"} 5\n"
+		  "test_latency_msecs_sum 1106.5\n"
+		  "test_latency_msecs_count 5\n"));
+
+  std::string json = ArMetrics::toJSON(samples);
+  assert(json.compare(0, 12, "{\"metrics\":[") == 0);
+  assert(contains(json, "{\"name\":\"test_counter_total\",\"type\":\"counter\","
+		  "\"labels\":{\"a\":\"1\"},\"help\":\"A test counter\",\"value\":0}"));
+  assert(contains(json, "{\"name\":\"test_gauge\",\"type\":\"gauge\",\"labels\":{},"
+		  "\"help\":\"A test gauge\",\"value\":1.5}"));
+  assert(contains(json, "\"count\":5,\"sum\":1106.5,\"buckets\":[{\"le\":1,\"count\":2},"
+		  "{\"le\":10,\"count\":1},{\"le\":100,\"count\":1},{\"le\":null,\"count\":1}]"));
+
+  // labels are unescaped into JSON strings
+  ArMetrics::getGauge("test_escaped", "", ArMetrics::makeLabels("k", "x\"y", "l", "z"));
+  json = ArMetrics::getJSON();
+  assert(contains(json, "\"labels\":{\"k\":\"x\\\"y\",\"l\":\"z\"}"));
+
+  ArMetrics::reset();
+  samples = ArMetrics::getSnapshot();
+  assert(findSample(samples, "test_counter_total", "")->value == 0);
+  assert(findSample(samples, "test_latency_msecs", "")->count == 0);
+}
+
+std::string fetch(int port, const char *request)
+{
+  ArSocket sock;
+  sock.setDoClose(true);
+  if (!sock.connect("127.0.0.1", port, ArSocket::TCP))
+    return "";
+  sock.write(request, strlen(request));
+  std::string response;
+  char buf[4096];
+  ArTime started;
+  while (started.mSecSince() < 5000)
+  {
+    int ret = sock.read(buf, sizeof(buf), 500);
+    if (ret <= 0 && response.find("\r\n\r\n") != std::string::npos)
+      break;
+    if (ret > 0)
+      response.append(buf, (size_t)ret);
+  }
+  return response;
+}
+
+void testServer()
+{
+  ArMetricsServer server;
+  int port;
+  for (port = 19464; port < 19564; port++)
+    if (server.open(port))
+      break;
+  assert(server.isOpen());
+  server.runAsync();
+
+  ArMetrics::getCounter("test_counter_total")->add(9);
+  std::string response = fetch(port, "GET /metrics HTTP/1.0\r\n\r\n");
+  assert(response.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+  assert(contains(response, "Content-Type: text/plain"));
+  assert(contains(response, "\ntest_counter_total 9\n"));
+
+  response = fetch(port, "GET /metrics.json HTTP/1.1\r\nHost: localhost\r\n\r\n");
+  assert(response.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+  assert(contains(response, "Content-Type: application/json"));
+  assert(contains(response, "\r\n\r\n{\"metrics\":["));
+
+  response = fetch(port, "GET /nothing HTTP/1.0\r\n\r\n");
+  assert(response.compare(0, 12, "HTTP/1.0 404") == 0);
+  response = fetch(port, "POST /metrics HTTP/1.0\r\n\r\n");
+  assert(response.compare(0, 12, "HTTP/1.0 405") == 0);
+  assert(server.getNumRequests() == 4);
+
+  // a client that connects and goes away without asking doesn't stop it
+  {
+    ArSocket sock;
+    sock.setDoClose(true);
+    assert(sock.connect("127.0.0.1", port, ArSocket::TCP));
+  }
+  response = fetch(port, "GET /metrics HTTP/1.0\r\n\r\n");
+  assert(response.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Terse);
+  ArSocket::init();
+  testCounter();
+  testGauge();
+  testHistogram();
+  testCallbackGauges();
+  testLabels();
+  testText();
+  testServer();
+  puts("metricsTest: all tests passed");
+  return 0;
+}
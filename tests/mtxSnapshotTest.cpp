@@ -0,0 +1,153 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArMTXIO.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <vector>
+
+/*
+  Tests ArMTXIO register snapshots without MTX hardware: how the
+  snapshot registers are grouped into device reads, changing the set of
+  registers, and reading named registers back from a snapshot.
+*/
+
+class TestMTXIO : public ArMTXIO
+{
+public:
+  TestMTXIO() : ArMTXIO("/nonexistent/mtx") {}
+  using ArMTXIO::SnapshotRead;
+  using ArMTXIO::planSnapshotReads;
+};
+
+std::vector<TestMTXIO::SnapshotRead> plan(std::vector<unsigned short> regs)
+{
+  bool flags[ArMTXIO::SNAPSHOT_NUM_REGS] = {};
+  for (size_t i = 0; i < regs.size(); i++)
+    flags[regs[i]] = true;
+  return TestMTXIO::planSnapshotReads(flags, ArMTXIO::SNAPSHOT_NUM_REGS);
+}
+
+void testPlan()
+{
+  assert(plan({}).empty());
+
+  std::vector<TestMTXIO::SnapshotRead> reads = plan({0x21});
+  assert(reads.size() == 1 && reads[0].reg == 0x21 && reads[0].size == 1);
+
+  // an aligned run of 4 is one read
+  reads = plan({0x20, 0x21, 0x22, 0x23});
+  assert(reads.size() == 1 && reads[0].reg == 0x20 && reads[0].size == 4);
+
+  // unaligned runs are split so that wider reads are aligned
+  reads = plan({0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28});
+  assert(reads.size() == 4);
+  assert(reads[0].reg == 0x21 && reads[0].size == 1);
+  assert(reads[1].reg == 0x22 && reads[1].size == 2);
+  assert(reads[2].reg == 0x24 && reads[2].size == 4);
+  assert(reads[3].reg == 0x28 && reads[3].size == 1);
+
+  // gaps aren't read
+  reads = plan({0x30, 0x31, 0x34});
+  assert(reads.size() == 2);
+  assert(reads[0].reg == 0x30 && reads[0].size == 2);
+  assert(reads[1].reg == 0x34 && reads[1].size == 1);
+
+  // the last register
+  reads = plan({ArMTXIO::SNAPSHOT_NUM_REGS - 1});
+  assert(reads.size() == 1 && reads[0].reg == ArMTXIO::SNAPSHOT_NUM_REGS - 1);
+}
+
+void testRegisters()
+{
+  TestMTXIO mtx;
+  assert(!mtx.isEnabled());
+
+  // the 19 default registers take 10 reads
+  assert(mtx.getNumSnapshotReads() == 10);
+  mtx.clearSnapshotRegisters();
+  assert(mtx.getNumSnapshotReads() == 0);
+  assert(mtx.addSnapshotRegister(0x40));
+  assert(mtx.addSnapshotRegister(0x41));
+  assert(mtx.getNumSnapshotReads() == 1);
+  assert(!mtx.addSnapshotRegister(ArMTXIO::SNAPSHOT_NUM_REGS));
+  mtx.remSnapshotRegister(0x40);
+  assert(mtx.getNumSnapshotReads() == 1);
+  mtx.remSnapshotRegister(0x41);
+  assert(mtx.getNumSnapshotReads() == 0);
+  mtx.setDefaultSnapshotRegisters();
+  assert(mtx.getNumSnapshotReads() == 10);
+
+  // no device, no snapshot
+  assert(!mtx.takeSnapshot());
+  assert(!mtx.getTakeSnapshotCB()->invokeR());
+  ArMTXIO::Snapshot snapshot = mtx.getSnapshot();
+  assert(snapshot.number == 0);
+  unsigned char val;
+  assert(!snapshot.getDigitalBankInputs(0, &val));
+}
+
+void testSnapshotAccessors()
+{
+  ArMTXIO::Snapshot snapshot;
+  for (unsigned short reg = 0x20; reg < 0x3a; reg++)
+  {
+    snapshot.values[reg] = (unsigned char)reg;
+    snapshot.have[reg] = true;
+  }
+  unsigned char val = 0;
+  assert(snapshot.getDigitalBankInputs(0, &val) && val == 0x20);
+  assert(snapshot.getDigitalBankInputs(1, &val) && val == 0x21);
+  assert(!snapshot.getDigitalBankInputs(2, &val));
+  assert(snapshot.getDigitalBankOutputs(2, &val) && val == 0x30);
+  assert(snapshot.getDigitalBankOutputs(3, &val) && val == 0x31);
+  assert(!snapshot.getDigitalBankOutputs(0, &val));
+  assert(snapshot.getPeripheralPowerBankOutputs(0, &val) && val == 0x34);
+  assert(snapshot.getPeripheralPowerBankOutputs(2, &val) && val == 0x36);
+  assert(!snapshot.getPeripheralPowerBankOutputs(3, &val));
+  assert(snapshot.getDigitalIOOutputMon(2, &val) && val == 0x23);
+  assert(snapshot.getBumperInput(&val) && val == 0x24);
+  assert(snapshot.getPowerStatus(1, &val) && val == 0x28);
+  assert(snapshot.getLIDARSafety(&val) && val == 0x2a);
+  assert(snapshot.getESTOPStatus(4, &val) && val == 0x2f);
+  assert(!snapshot.getESTOPStatus(5, &val));
+  assert(snapshot.getLightPole(&val) && val == 0x32);
+  assert(snapshot.getMotionPowerStatus(&val) && val == 0x39);
+
+  // registers that weren't read
+  snapshot.have[0x2c] = false;
+  assert(!snapshot.getESTOPStatus(1, &val));
+  assert(!snapshot.getRegValue(0x40, &val));
+  assert(!snapshot.getRegValue(ArMTXIO::SNAPSHOT_NUM_REGS, &val));
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Terse);
+  testPlan();
+  testRegisters();
+  testSnapshotAccessors();
+  puts("mtxSnapshotTest: all tests passed");
+  return 0;
+}
@@ -0,0 +1,175 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArMutex.h"
+#include "Aria/ArSharedMutex.h"
+#include "Aria/ArThread.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+  Tests the ArMutex contention profiler: counts of locks and contended
+  locks, wait and hold times, which thread held a mutex longest,
+  grouping by name, and that nothing is counted while it's off.
+  ArSharedMutex locks are counted in the same totals.
+*/
+
+static const ArMutex::ProfileStats *find(
+	const std::vector<ArMutex::ProfileStats> &stats, const char *name)
+{
+  for (auto it = stats.begin(); it != stats.end(); ++it)
+    if (it->name == name)
+      return &(*it);
+  return NULL;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdErr, ArLog::Terse);
+  ArThread::init();
+  ArThread::self()->setThreadName("holder");
+
+  ArMutex busy;
+  busy.setLogName("profileTest::busy");
+  ArMutex quiet;
+  quiet.setLogName("profileTest::quiet");
+  ArMutex quiet2;
+  quiet2.setLogName("profileTest::quiet");
+
+  // nothing is counted with the profiler off
+  assert(!ArMutex::getProfiling());
+  busy.lock();
+  busy.unlock();
+  assert(find(ArMutex::getProfileStats(), "profileTest::busy") == NULL);
+
+  ArMutex::setProfiling(true);
+  assert(ArMutex::getProfiling());
+
+  // uncontended locks, including a recursive one and a tryLock, and
+  // two mutexes with the same name adding up together
+  quiet.lock();
+  quiet.lock();
+  quiet.unlock();
+  quiet.unlock();
+  assert(quiet.tryLock() == 0);
+  quiet.unlock();
+  quiet2.lock();
+  quiet2.unlock();
+
+  // another thread holds busy for a while, and we wait for it
+  busy.lock();
+  std::thread waiter([&busy]() {
+      busy.lock();
+      busy.unlock();
+    });
+  ArUtil::sleep(100);
+  busy.unlock();
+  waiter.join();
+
+  std::vector<ArMutex::ProfileStats> stats = ArMutex::getProfileStats();
+  const ArMutex::ProfileStats *q = find(stats, "profileTest::quiet");
+  const ArMutex::ProfileStats *b = find(stats, "profileTest::busy");
+  assert(q != NULL && b != NULL);
+  printf("quiet: %llu locks %llu contended, busy: %llu locks %llu contended, waited %llu usecs, held %llu usecs (max %llu by %s)\n",
+	 q->locks, q->contendedLocks, b->locks, b->contendedLocks,
+	 b->totalWaitUSecs, b->totalHoldUSecs, b->maxHoldUSecs,
+	 b->maxHoldThread.c_str());
+  assert(q->locks == 4);
+  assert(q->contendedLocks == 0);
+  assert(q->totalWaitUSecs == 0);
+  assert(b->locks == 2);
+  assert(b->contendedLocks == 1);
+  // the waiter waited for most of the sleep, and the main thread held it
+  // for all of it
+  assert(b->totalWaitUSecs >= 50000);
+  assert(b->maxWaitUSecs == b->totalWaitUSecs);
+  assert(b->maxHoldUSecs >= 80000);
+  assert(b->totalHoldUSecs >= b->maxHoldUSecs);
+  assert(b->maxHoldThread == "holder");
+  // the most waited for mutex comes first
+  assert(stats[0].name == "profileTest::busy");
+
+  std::string report = ArMutex::getProfileReport();
+  assert(report.find("profileTest::busy") != std::string::npos);
+  assert(report.find("profileTest::busy") < report.find("profileTest::quiet"));
+  ArMutex::logProfile();
+
+  // turning it off stops counting, and reset clears the totals
+  ArMutex::setProfiling(false);
+  busy.lock();
+  busy.unlock();
+  stats = ArMutex::getProfileStats();
+  b = find(stats, "profileTest::busy");
+  assert(b->locks == 2);
+  ArMutex::resetProfile();
+  stats = ArMutex::getProfileStats();
+  b = find(stats, "profileTest::busy");
+  assert(b->locks == 0 && b->maxHoldUSecs == 0 && b->maxHoldThread.empty());
+
+  // renaming a mutex counts it under its new name
+  ArMutex::setProfiling(true);
+  busy.setLogName("profileTest::renamed");
+  busy.lock();
+  busy.unlock();
+  stats = ArMutex::getProfileStats();
+  assert(find(stats, "profileTest::renamed")->locks == 1);
+  assert(find(stats, "profileTest::busy")->locks == 0);
+
+  // shared mutexes count both kinds of locks, and readers wait for a writer
+  ArSharedMutex shared;
+  shared.setLogName("profileTest::shared");
+  shared.lock();
+  std::thread reader([&shared]() {
+      shared.lockShared();
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      shared.unlockShared();
+    });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  shared.unlock();
+  reader.join();
+  shared.lockShared();
+  shared.lockShared();
+  shared.unlockShared();
+  shared.unlockShared();
+  assert(shared.tryLock() == 0);
+  shared.unlock();
+  stats = ArMutex::getProfileStats();
+  const ArMutex::ProfileStats *s = find(stats, "profileTest::shared");
+  assert(s != NULL);
+  assert(s->locks == 5);
+  assert(s->contendedLocks == 1);
+  assert(s->totalWaitUSecs > 0 && s->maxWaitUSecs == s->totalWaitUSecs);
+  // held 50 ms exclusively and 20 ms shared
+  assert(s->maxHoldUSecs >= 45000);
+  assert(s->totalHoldUSecs >= 65000);
+  ArMutex::setProfiling(false);
+
+  printf("All tests passed\n");
+  return 0;
+}
@@ -42,6 +42,21 @@ static void onHDM(ArNMEAParser::Message msg)
   lastFields = *msg.message;
 }
 
+static int viewHandlerCalls = 0;
+static std::vector<std::string> lastViewFields;
+static std::string lastViewId;
+static std::string lastViewPrefix;
+
+static void onViewMessage(const ArNMEAParser::ViewMessage *msg)
+{
+  ++viewHandlerCalls;
+  lastViewId = msg->id.str();
+  lastViewPrefix = msg->prefix.str();
+  lastViewFields.clear();
+  for (size_t i = 0; i < msg->size(); ++i)
+    lastViewFields.push_back((*msg)[i].str());
+}
+
 static void onGGA(ArNMEAParser::Message msg)
 {
   ++ggaHandlerCalls;
@@ -50,6 +65,29 @@ static void onGGA(ArNMEAParser::Message msg)
   lastFields = *msg.message;
 }
 
+// removes itself and adds lots of other handlers (so the handler table
+// is rebuilt and reallocated) while it's being called
+static ArNMEAParser *changingParser = NULL;
+static ArFunctor1<const ArNMEAParser::ViewMessage *> *otherViewCb = NULL;
+
+static void onViewRemoveSelf(const ArNMEAParser::ViewMessage *msg)
+{
+  onViewMessage(msg);
+  changingParser->removeViewHandler("GGA");
+  char id[8];
+  for (int i = 0; i < 40; ++i)
+  {
+    snprintf(id, sizeof(id), "Y%02d", i);
+    changingParser->addViewHandler(id, otherViewCb);
+  }
+}
+
+static void onGGARemoveSelf(ArNMEAParser::Message msg)
+{
+  onGGA(msg);
+  changingParser->removeHandler("GGA");
+}
+
 int main(int argc, char **argv) {
 
   ArNMEAParser nmeaParser;
@@ -254,6 +292,121 @@ int main(int argc, char **argv) {
     assert(lastFields[0] == "GNGGA");
   }
 
+  puts("");
+  puts("Testing view handlers (fields given in place).");
+  {
+    ArNMEAParser viewParser;
+    ArGlobalFunctor1<const ArNMEAParser::ViewMessage *> viewCb(&onViewMessage);
+    ArGlobalFunctor1<ArNMEAParser::Message> ggaCb(&onGGA);
+    viewParser.addViewHandler("GGA", &viewCb);
+    viewHandlerCalls = 0;
+    ggaHandlerCalls = 0;
+
+    const char *gpgga =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    result = viewParser.parse(gpgga, strlen(gpgga));
+    assert(!(result & ArNMEAParser::ParseError));
+    assert(result & ArNMEAParser::ParseUpdated);
+    assert(viewHandlerCalls == 1);
+    assert(lastViewId == "GGA");
+    assert(lastViewPrefix == "GP");
+    assert(lastViewFields.size() == 15);
+    assert(lastViewFields[0] == "GPGGA");
+    assert(lastViewFields[2] == "4807.038");
+    assert(lastViewFields[13] == "");
+    assert(lastViewFields[14] == "");
+
+    // both kinds of handler for the same message, split across three parse() calls
+    viewParser.addHandler("GGA", &ggaCb);
+    result = viewParser.parse(gpgga, 10);
+    assert(!(result & ArNMEAParser::ParseUpdated));
+    result = viewParser.parse(gpgga + 10, 30);
+    assert(!(result & ArNMEAParser::ParseUpdated));
+    result = viewParser.parse(gpgga + 40, strlen(gpgga) - 40);
+    assert(result & ArNMEAParser::ParseUpdated);
+    assert(viewHandlerCalls == 2);
+    assert(ggaHandlerCalls == 1);
+    assert(lastViewFields.size() == 15);
+    assert(lastViewFields[9] == "545.4");
+
+    // removing the view handler leaves the other one
+    viewParser.removeViewHandler("GGA");
+    result = viewParser.parse(gpgga, strlen(gpgga));
+    assert(result & ArNMEAParser::ParseUpdated);
+    assert(viewHandlerCalls == 2);
+    assert(ggaHandlerCalls == 2);
+
+    // bad checksum is caught in the same pass
+    viewParser.addViewHandler("GGA", &viewCb);
+    const char *badgga =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n";
+    result = viewParser.parse(badgga, strlen(badgga));
+    assert(result & ArNMEAParser::ParseError);
+    assert(!(result & ArNMEAParser::ParseUpdated));
+    assert(viewHandlerCalls == 2);
+
+    // Field conversions
+    ArNMEAParser::Field f;
+    f.data = "4807.038,N";
+    f.size = 8;
+    assert(f.equals("4807.038"));
+    assert(!f.equals("4807.03"));
+    assert(f.toDouble() == 4807.038);
+    assert(f.toInt() == 4807);
+  }
+
+  puts("");
+  puts("Testing many handlers (handler table growth).");
+  {
+    ArNMEAParser manyParser;
+    ArGlobalFunctor1<const ArNMEAParser::ViewMessage *> viewCb(&onViewMessage);
+    char id[8];
+    for (int i = 0; i < 40; ++i)
+    {
+      snprintf(id, sizeof(id), "X%02d", i);
+      manyParser.addViewHandler(id, &viewCb);
+    }
+    manyParser.addViewHandler("HDM", &viewCb);
+    viewHandlerCalls = 0;
+    const char *hdm = "$HCHDM,123.4,M*2D\r\n";
+    result = manyParser.parse(hdm, strlen(hdm));
+    assert(result & ArNMEAParser::ParseUpdated);
+    assert(viewHandlerCalls == 1);
+    assert(lastViewId == "HDM");
+    assert(manyParser.getViewHandlersRef().size() == 41);
+  }
+
+  puts("");
+  puts("Testing handlers that remove themselves.");
+  {
+    ArNMEAParser parser;
+    changingParser = &parser;
+    ArGlobalFunctor1<const ArNMEAParser::ViewMessage *> viewCb(&onViewMessage);
+    ArGlobalFunctor1<const ArNMEAParser::ViewMessage *> removeViewCb(&onViewRemoveSelf);
+    ArGlobalFunctor1<ArNMEAParser::Message> removeCb(&onGGARemoveSelf);
+    otherViewCb = &viewCb;
+    parser.addViewHandler("GGA", &removeViewCb);
+    parser.addHandler("GGA", &removeCb);
+    viewHandlerCalls = 0;
+    ggaHandlerCalls = 0;
+    const char *gpgga =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    // both were looked up before either was called, so both are called
+    result = parser.parse(gpgga, strlen(gpgga));
+    assert(result & ArNMEAParser::ParseUpdated);
+    assert(viewHandlerCalls == 1);
+    assert(ggaHandlerCalls == 1);
+    assert(lastId == "GGA");
+    assert(parser.getViewHandlersRef().size() == 40);
+    assert(parser.getHandlersRef().empty());
+    // and neither is called again
+    result = parser.parse(gpgga, strlen(gpgga));
+    assert(!(result & ArNMEAParser::ParseUpdated));
+    assert(viewHandlerCalls == 1);
+    assert(ggaHandlerCalls == 1);
+    changingParser = NULL;
+  }
+
   puts("");
   puts("Done.");
   return 0;
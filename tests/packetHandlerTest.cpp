@@ -0,0 +1,201 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRobot.h"
+#include "Aria/ArRobotPacket.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+  Tests that ArRobot only offers packets to the handlers registered for
+  their ID (plus catch-all handlers), in handler list order, and keeps
+  per-handler statistics. Packets are given to ArRobot::handlePacket()
+  directly, no robot connection is needed.
+*/
+
+std::string calls;
+
+bool catchAll(ArRobotPacket *)
+{
+  calls += "A";
+  return false;
+}
+
+bool handle50(ArRobotPacket *packet)
+{
+  assert(packet->getID() == 0x50);
+  calls += "B";
+  return true;
+}
+
+bool see51(ArRobotPacket *packet)
+{
+  assert(packet->getID() == 0x51);
+  calls += "C";
+  return false;
+}
+
+ArRobot *theRobot = NULL;
+ArRetFunctor1<bool, ArRobotPacket *> *removeSelfCB = NULL;
+
+bool removeSelf(ArRobotPacket *)
+{
+  calls += "R";
+  theRobot->remPacketHandler(removeSelfCB);
+  return false;
+}
+
+// counts the packets it sees, and can add another handler the first time
+struct CountingHandler
+{
+  CountingHandler() : cb(this, &CountingHandler::handle) {}
+  bool handle(ArRobotPacket *)
+  {
+    count++;
+    if (toAdd != NULL)
+    {
+      theRobot->addPacketHandler(toAdd);
+      toAdd = NULL;
+    }
+    return false;
+  }
+  int count = 0;
+  ArRetFunctor1<bool, ArRobotPacket *> *toAdd = NULL;
+  ArRetFunctor1C<bool, CountingHandler, ArRobotPacket *> cb;
+};
+
+void sendPacket(ArRobot *robot, unsigned char id)
+{
+  ArRobotPacket packet;
+  packet.setID(id);
+  packet.finalizePacket();
+  robot->handlePacket(&packet);
+}
+
+const ArRobot::PacketHandlerStats *findStats(
+	const std::vector<ArRobot::PacketHandlerStats> &stats, const char *name)
+{
+  for (size_t i = 0; i < stats.size(); ++i)
+    if (stats[i].name == name)
+      return &stats[i];
+  return NULL;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  ArRobot robot;
+  theRobot = &robot;
+
+  ArGlobalRetFunctor1<bool, ArRobotPacket *> catchAllCB(&catchAll);
+  catchAllCB.setName("catchAll");
+  ArGlobalRetFunctor1<bool, ArRobotPacket *> handle50CB(&handle50);
+  handle50CB.setName("handle50");
+  ArGlobalRetFunctor1<bool, ArRobotPacket *> see51CB(&see51);
+  see51CB.setName("see51");
+
+  robot.addPacketHandler(&catchAllCB);
+  robot.addPacketHandler(&handle50CB, {0x50});
+  robot.addPacketHandler(&see51CB, {0x51}, ArListPos::FIRST);
+
+  calls = "";
+  sendPacket(&robot, 0x50);
+  assert(calls == "AB");
+
+  calls = "";
+  sendPacket(&robot, 0x51);
+  assert(calls == "CA");
+
+  calls = "";
+  sendPacket(&robot, 0x52);
+  assert(calls == "A");
+
+  std::vector<ArRobot::PacketHandlerStats> stats = robot.getPacketHandlerStats();
+  const ArRobot::PacketHandlerStats *s = findStats(stats, "catchAll");
+  assert(s && s->invoked == 3 && s->handled == 0);
+  s = findStats(stats, "handle50");
+  assert(s && s->invoked == 1 && s->handled == 1);
+  s = findStats(stats, "see51");
+  assert(s && s->invoked == 1 && s->handled == 0);
+  // ArRobot's own handlers never saw these packets
+  s = findStats(stats, "ArRobot::processMotorPacket");
+  assert(s == NULL || s->invoked == 0);
+  robot.logPacketHandlerStats();
+
+  robot.resetPacketHandlerStats();
+  stats = robot.getPacketHandlerStats();
+  for (size_t i = 0; i < stats.size(); ++i)
+    assert(stats[i].invoked == 0 && stats[i].handled == 0 && stats[i].usecs == 0);
+
+  robot.remPacketHandler(&handle50CB);
+  calls = "";
+  sendPacket(&robot, 0x50);
+  assert(calls == "A");
+
+  // a handler may remove itself while it is being called
+  ArGlobalRetFunctor1<bool, ArRobotPacket *> removeSelfFunctor(&removeSelf);
+  removeSelfCB = &removeSelfFunctor;
+  robot.addPacketHandler(&removeSelfFunctor, {0x53}, ArListPos::FIRST);
+  calls = "";
+  sendPacket(&robot, 0x53);
+  assert(calls == "RA");
+  calls = "";
+  sendPacket(&robot, 0x53);
+  assert(calls == "A");
+
+  // with lots of handlers, one that adds a handler (rebuilding the
+  // table) doesn't get any of them the packet twice, and its own call
+  // still counts
+  std::vector<CountingHandler> many(40);
+  for (size_t i = 0; i < many.size(); ++i)
+    robot.addPacketHandler(&many[i].cb);
+  CountingHandler adder;
+  adder.cb.setName("adder");
+  CountingHandler added;
+  adder.toAdd = &added.cb;
+  robot.addPacketHandler(&adder.cb, {0x54});
+  robot.resetPacketHandlerStats();
+  calls = "";
+  sendPacket(&robot, 0x54);
+  assert(calls == "A");
+  for (size_t i = 0; i < many.size(); ++i)
+    assert(many[i].count == 1);
+  assert(adder.count == 1);
+  assert(added.count == 1);
+  stats = robot.getPacketHandlerStats();
+  s = findStats(stats, "adder");
+  assert(s && s->invoked == 1);
+  s = findStats(stats, "catchAll");
+  assert(s && s->invoked == 1);
+  for (size_t i = 0; i < many.size(); ++i)
+    robot.remPacketHandler(&many[i].cb);
+  robot.remPacketHandler(&adder.cb);
+  robot.remPacketHandler(&added.cb);
+
+  printf("packetHandlerTest: all tests passed\n");
+  return 0;
+}
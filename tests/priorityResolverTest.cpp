@@ -0,0 +1,212 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArPriorityResolver.h"
+#include "Aria/ArAction.h"
+#include "Aria/ArActionDesired.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+/*
+  Tests ArPriorityResolver: that higher priority actions win, that the
+  same priority actions are averaged, that actions see what the higher
+  priority ones wanted, that the sorted action array follows changes to
+  the action map, and the per action trace. No robot is needed.
+*/
+
+std::string fired;
+
+class TestAction : public ArAction
+{
+public:
+  TestAction(const char *name, char tag, double vel, double strength) :
+    ArAction(name), myTag(tag), myVel(vel), myStrength(strength),
+    mySeenVel(0), mySeenStrength(0) {}
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired) override
+    {
+      fired += myTag;
+      mySeenVel = currentDesired.getVel();
+      mySeenStrength = currentDesired.getVelStrength();
+      if (myStrength <= 0)
+        return NULL;
+      myDesired.reset();
+      myDesired.setVel(myVel, myStrength);
+      return &myDesired;
+    }
+  char myTag;
+  double myVel;
+  double myStrength;
+  double mySeenVel;
+  double mySeenStrength;
+  ArActionDesired myDesired;
+};
+
+bool close(double a, double b)
+{
+  return fabs(a - b) < .0001;
+}
+
+int main(int, char **)
+{
+  ArPriorityResolver resolver;
+  ArResolver::ActionMap actions;
+  ArActionDesired *result;
+
+  TestAction high("high", 'H', 200, .5);
+  TestAction midA("midA", 'a', 100, .25);
+  TestAction midB("midB", 'b', 300, .25);
+  TestAction low("low", 'L', 500, 1);
+
+  actions.insert(ArResolver::ActionMap::value_type{10, &low});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midA});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midB});
+  actions.insert(ArResolver::ActionMap::value_type{90, &high});
+
+  // high gets half the strength, the two mids average to 200 and use
+  // up the rest, so low is fired but doesn't change anything
+  fired = "";
+  result = resolver.resolve(&actions, NULL);
+  assert(result != NULL);
+  assert(fired.size() == 4 && fired[0] == 'H' && fired[3] == 'L');
+  assert(close(result->getVel(), 200));
+  assert(close(result->getVelStrength(), 1));
+  // lower priority actions see what was resolved before them
+  assert(close(high.mySeenStrength, ArActionDesiredChannel::NO_STRENGTH));
+  assert(close(midA.mySeenVel, 200) && close(midA.mySeenStrength, .5));
+  assert(close(low.mySeenStrength, 1));
+  printf("priority and averaging ok\n");
+
+  // no trace unless asked for
+  assert(!resolver.getTracing());
+  assert(resolver.getTrace().empty());
+
+  // deactivated actions aren't fired, and adding to the map is noticed
+  // without telling the resolver
+  midB.deactivate();
+  TestAction lowest("lowest", 'Z', 0, 0);
+  actions.insert(ArResolver::ActionMap::value_type{1, &lowest});
+  fired = "";
+  result = resolver.resolve(&actions, NULL);
+  assert(fired == "HaLZ");
+  // high .5 at 200, then midA .25 at 100, then low tops it up to 1
+  assert(close(result->getVel(), (200 * .5 + 100 * .25 + 500 * .25)));
+  midB.activate();
+  printf("deactivate and map change ok\n");
+
+  // actionsChanged makes it rebuild
+  actions.clear();
+  actions.insert(ArResolver::ActionMap::value_type{90, &low});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midA});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midB});
+  actions.insert(ArResolver::ActionMap::value_type{10, &high});
+  actions.insert(ArResolver::ActionMap::value_type{1, &lowest});
+  resolver.actionsChanged();
+  fired = "";
+  result = resolver.resolve(&actions, NULL);
+  assert(fired[0] == 'L' && fired[3] == 'H' && fired[4] == 'Z');
+  assert(close(result->getVel(), 500));
+  printf("actionsChanged ok\n");
+
+  // but changing priorities in place is noticed without it too, like
+  // when the map is edited through ArRobot::getActionMap()
+  actions.clear();
+  actions.insert(ArResolver::ActionMap::value_type{10, &low});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midA});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midB});
+  actions.insert(ArResolver::ActionMap::value_type{90, &high});
+  actions.insert(ArResolver::ActionMap::value_type{1, &lowest});
+  fired = "";
+  result = resolver.resolve(&actions, NULL);
+  assert(fired.size() == 5 && fired[0] == 'H' && fired[3] == 'L');
+  assert(close(result->getVel(), 200));
+  // and so is swapping one action for another at the same priority
+  actions.erase(actions.find(1));
+  TestAction other1("other1", 'Y', 0, 0);
+  actions.insert(ArResolver::ActionMap::value_type{1, &other1});
+  fired = "";
+  resolver.resolve(&actions, NULL);
+  assert(fired.size() == 5 && fired[4] == 'Y');
+  // and putting things back the way they were
+  actions.clear();
+  actions.insert(ArResolver::ActionMap::value_type{90, &low});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midA});
+  actions.insert(ArResolver::ActionMap::value_type{50, &midB});
+  actions.insert(ArResolver::ActionMap::value_type{10, &high});
+  actions.insert(ArResolver::ActionMap::value_type{1, &lowest});
+  fired = "";
+  result = resolver.resolve(&actions, NULL);
+  assert(fired[0] == 'L' && fired[3] == 'H' && fired[4] == 'Z');
+  assert(close(result->getVel(), 500));
+  printf("same size map change ok\n");
+
+  // a different map is noticed too
+  ArResolver::ActionMap other;
+  other.insert(ArResolver::ActionMap::value_type{5, &midB});
+  fired = "";
+  result = resolver.resolve(&other, NULL);
+  assert(fired == "b");
+  assert(close(result->getVel(), 300));
+  assert(resolver.resolve(NULL, NULL) == NULL);
+  printf("other map ok\n");
+
+  // tracing records each active action, up to the buffer size
+  resolver.setTracing(true, 3);
+  assert(resolver.getTracing());
+  fired = "";
+  resolver.resolve(&actions, NULL);
+  assert(fired.size() == 5);
+  const std::vector<ArPriorityResolver::TraceEntry> &trace = 
+    resolver.getTrace();
+  assert(trace.size() == 3);
+  assert(strcmp(trace[0].actionName, "low") == 0);
+  assert(trace[0].priority == 90);
+  assert(trace[0].fired);
+  assert(close(trace[0].vel, 500) && close(trace[0].velStrength, 1));
+  assert(trace[0].usecs >= 0);
+  assert(trace[1].priority == 50 && trace[2].priority == 50);
+  assert(resolver.getLastResolveUSecs() >= 0);
+  resolver.logTrace(ArLog::Terse);
+
+  // the buffer isn't reallocated from cycle to cycle
+  resolver.setTracing(true, 10);
+  resolver.resolve(&actions, NULL);
+  const ArPriorityResolver::TraceEntry *data = resolver.getTrace().data();
+  for (int i = 0; i < 100; i++)
+    resolver.resolve(&actions, NULL);
+  assert(resolver.getTrace().data() == data);
+  assert(resolver.getTrace().size() == 5);
+  assert(!resolver.getTrace()[4].fired);
+  assert(strcmp(resolver.getTrace()[4].actionName, "lowest") == 0);
+
+  resolver.setTracing(false);
+  resolver.resolve(&actions, NULL);
+  assert(resolver.getTrace().empty());
+  printf("tracing ok\n");
+
+  printf("All priorityResolverTest tests passed\n");
+  return 0;
+}
@@ -0,0 +1,368 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArPTZ.h"
+#include "Aria/ArRVisionPTZ.h"
+#include "Aria/ArDeviceConnection.h"
+#include "Aria/ArBasePacket.h"
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArFunctor.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+  Tests the ArPTZ command pipeline: commands given while the device is
+  busy are queued without blocking, superseded absolute moves are
+  dropped, the queue is bounded, and (with ArRVisionPTZ, whose VISCA
+  replies are read back from a fake connection) no more than the
+  allowed number of commands wait for an answer, unanswered ones time
+  out and disabling the pipeline cancels what's left.
+*/
+
+/// Device whose writes can be held up, and whose replies are scripted
+class FakeConnection : public ArDeviceConnection
+{
+public:
+  FakeConnection() { setPortName("fake"); }
+  virtual int read(const char *data, unsigned int size, unsigned int) override
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    unsigned int n = (unsigned int)myReplies.size();
+    if (n > size)
+      n = size;
+    memcpy(const_cast<char *>(data), myReplies.data(), n);
+    myReplies.erase(0, n);
+    return (int)n;
+  }
+  virtual int write(const char *data, unsigned int size) override 
+  { 
+    std::unique_lock<std::mutex> lock(myMutex);
+    myBlocked = !myOpen;
+    myCond.notify_all();
+    myCond.wait(lock, [this] { return myOpen; });
+    myBlocked = false;
+    myWrites.push_back(std::string(data, size));
+    return (int)size; 
+  }
+  virtual int getStatus() override { return STATUS_OPEN; }
+  virtual bool openSimple() override { return true; }
+  virtual const char *getOpenMessage(int) override { return ""; }
+  virtual ArTime getTimeRead(int) override { return ArTime(); }
+  virtual bool isTimeStamping() override { return false; }
+
+  // hold up writes until open(true)
+  void open(bool open)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myOpen = open;
+    myCond.notify_all();
+  }
+  // wait for a write to be held up
+  void waitBlocked()
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myCond.wait(lock, [this] { return myBlocked; });
+  }
+  void reply(const char *bytes, size_t len)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myReplies.append(bytes, len);
+  }
+  std::vector<std::string> writes()
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    return myWrites;
+  }
+
+  std::mutex myMutex;
+  std::condition_variable myCond;
+  bool myOpen = true;
+  bool myBlocked = false;
+  std::vector<std::string> myWrites;
+  std::string myReplies;
+};
+
+/// Sends pan and tilt as text commands, "P<deg>" and "T<deg>"
+class TextPTZ : public ArPTZ
+{
+public:
+  TextPTZ() : ArPTZ(NULL), myPacket(32) { }
+  virtual bool init() override { return true; }
+  virtual const char *getTypeName() override { return "text"; }
+  virtual bool canZoom() const override { return false; }
+protected:
+  bool send(char axis, double deg)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%c%g;", axis, deg);
+    myPacket.empty();
+    myPacket.strNToBuf(buf, strlen(buf));
+    return sendPacket(&myPacket);
+  }
+  virtual bool pan_i(double deg) override { myPan = deg; return send('P', deg); }
+  virtual bool panRel_i(double deg) override { return pan_i(myPan + deg); }
+  virtual bool tilt_i(double deg) override { myTilt = deg; return send('T', deg); }
+  virtual bool tiltRel_i(double deg) override { return tilt_i(myTilt + deg); }
+  virtual bool panTilt_i(double p, double t) override 
+    { return pan_i(p) && tilt_i(t); }
+  virtual bool panTiltRel_i(double p, double t) override 
+    { return panTilt_i(myPan + p, myTilt + t); }
+  virtual double getPan_i() const override { return myPan; }
+  virtual double getTilt_i() const override { return myTilt; }
+  ArBasePacket myPacket;
+  double myPan = 0;
+  double myTilt = 0;
+};
+
+/// Remembers what happened to each command
+class Recorder
+{
+public:
+  Recorder() : myCB(*this, &Recorder::done) {}
+  void done(ArPTZ::CommandId id, ArPTZ::CommandStatus status)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    assert(myStatus.find(id) == myStatus.end());
+    myStatus[id] = status;
+    myCounts[status]++;
+  }
+  int count(ArPTZ::CommandStatus status)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    return myCounts[status];
+  }
+  bool has(ArPTZ::CommandId id, ArPTZ::CommandStatus status)
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    std::map<ArPTZ::CommandId, ArPTZ::CommandStatus>::iterator it = 
+      myStatus.find(id);
+    return it != myStatus.end() && (*it).second == status;
+  }
+  std::mutex myMutex;
+  std::map<ArPTZ::CommandId, ArPTZ::CommandStatus> myStatus;
+  std::map<ArPTZ::CommandStatus, int> myCounts;
+  ArFunctor2C<Recorder, ArPTZ::CommandId, ArPTZ::CommandStatus> myCB;
+};
+
+void testDirect()
+{
+  puts("Without the pipeline, commands are written right away...");
+  FakeConnection conn;
+  TextPTZ ptz;
+  ptz.setDeviceConnection(&conn, false);
+  assert(!ptz.isCommandPipelineEnabled());
+  assert(ptz.panTilt(10, 20));
+  assert(conn.writes().size() == 2);
+  assert(conn.writes()[0] == "P10;");
+  assert(conn.writes()[1] == "T20;");
+  assert(ptz.getLastCommandId() == 0);
+  assert(!ptz.enableCommandPipeline(0, 1));
+  assert(!ptz.isCommandPipelineEnabled());
+}
+
+void testCoalesce(ArThreadPool *pool)
+{
+  puts("Superseded moves are dropped while the device is busy...");
+  FakeConnection conn;
+  TextPTZ ptz;
+  Recorder rec;
+  ptz.setDeviceConnection(&conn, false);
+  assert(ptz.enableCommandPipeline(4, 2, 500, pool));
+  ptz.setCommandCallback(&rec.myCB);
+
+  conn.open(false);
+  assert(ptz.pan(1));
+  const ArPTZ::CommandId first = ptz.getLastCommandId();
+  assert(first != 0);
+  conn.waitBlocked();
+
+  // none of these may wait on the held up write
+  ArTime start;
+  std::vector<ArPTZ::CommandId> pans;
+  for (int i = 2; i <= 50; i++)
+  {
+    assert(ptz.pan(i));
+    pans.push_back(ptz.getLastCommandId());
+  }
+  assert(ptz.tilt(5));
+  const ArPTZ::CommandId tilt = ptz.getLastCommandId();
+  assert(ptz.getNumQueuedCommands() == 2);
+  assert(ptz.panTilt(7, 8));
+  const ArPTZ::CommandId panTilt = ptz.getLastCommandId();
+  assert(ptz.getNumQueuedCommands() == 1);
+  // going nowhere new doesn't queue anything
+  assert(ptz.zoom(3) == false);
+  printf("Gave %lu commands in %ld ms while the device was busy\n",
+	 (unsigned long)pans.size() + 2, start.mSecSince());
+  assert(start.mSecSince() < 250);
+
+  conn.open(true);
+  assert(ptz.waitForCommands(2000));
+  std::vector<std::string> writes = conn.writes();
+  assert(writes.size() == 2);
+  assert(writes[0] == "P1;");
+  assert(writes[1] == "P7;T8;");
+  assert(rec.has(first, ArPTZ::COMMAND_DONE));
+  assert(rec.has(panTilt, ArPTZ::COMMAND_DONE));
+  assert(rec.has(tilt, ArPTZ::COMMAND_SUPERSEDED));
+  for (size_t i = 0; i < pans.size(); i++)
+    assert(rec.has(pans[i], ArPTZ::COMMAND_SUPERSEDED));
+  assert(rec.count(ArPTZ::COMMAND_SUPERSEDED) == (int)pans.size() + 1);
+  assert(rec.count(ArPTZ::COMMAND_DONE) == 2);
+}
+
+void testBounded(ArThreadPool *pool)
+{
+  puts("Relative moves are kept, and the queue is bounded...");
+  FakeConnection conn;
+  TextPTZ ptz;
+  Recorder rec;
+  ptz.setDeviceConnection(&conn, false);
+  assert(ptz.enableCommandPipeline(3, 1, 500, pool));
+  ptz.setCommandCallback(&rec.myCB);
+
+  conn.open(false);
+  assert(ptz.panRel(1));
+  conn.waitBlocked();
+  assert(ptz.panRel(1));
+  assert(ptz.panRel(1));
+  assert(ptz.panRel(1));
+  assert(ptz.getNumQueuedCommands() == 3);
+  assert(!ptz.panRel(1));
+  const ArPTZ::CommandId dropped = ptz.getLastCommandId();
+  assert(rec.has(dropped, ArPTZ::COMMAND_DROPPED));
+  // an absolute move only replaces another absolute move
+  assert(!ptz.pan(20));
+  conn.open(true);
+  assert(ptz.waitForCommands(2000));
+  std::vector<std::string> writes = conn.writes();
+  assert(writes.size() == 4);
+  assert(writes[0] == "P1;");
+  assert(writes[3] == "P4;");
+  assert(rec.count(ArPTZ::COMMAND_DONE) == 4);
+  assert(rec.count(ArPTZ::COMMAND_DROPPED) == 2);
+}
+
+void reply(FakeConnection *conn, unsigned char type, unsigned char socket)
+{
+  const char bytes[3] = { (char)0x90, (char)(type | socket), (char)0xff };
+  conn->reply(bytes, sizeof(bytes));
+}
+
+bool waitFor(ArPTZ *ptz, size_t inFlight, size_t queued)
+{
+  ArTime start;
+  while (start.mSecSince() < 2000)
+  {
+    if (ptz->getNumInFlightCommands() == inFlight && 
+	ptz->getNumQueuedCommands() == queued)
+      return true;
+    ArUtil::sleep(1);
+  }
+  return false;
+}
+
+void testResponses(ArThreadPool *pool)
+{
+  puts("VISCA replies complete commands and let queued ones go out...");
+  FakeConnection conn;
+  ArRVisionPTZ ptz(NULL);
+  Recorder rec;
+  ptz.setDeviceConnection(&conn, false);
+  assert(ptz.enableCommandPipeline(8, 2, 300, pool));
+  ptz.setCommandCallback(&rec.myCB);
+
+  // wait for each to go out, so the last one doesn't supersede the first
+  assert(ptz.panTilt(10, 0));
+  const ArPTZ::CommandId a = ptz.getLastCommandId();
+  assert(waitFor(&ptz, 1, 0));
+  assert(ptz.zoom(100));
+  const ArPTZ::CommandId b = ptz.getLastCommandId();
+  assert(waitFor(&ptz, 2, 0));
+  assert(ptz.panTilt(20, 0));
+  const ArPTZ::CommandId c = ptz.getLastCommandId();
+  // two wait for an answer, the third waits for room
+  assert(waitFor(&ptz, 2, 1));
+  assert(conn.writes().size() == 2);
+
+  reply(&conn, 0x40, 1);
+  reply(&conn, 0x40, 2);
+  // sockets can complete out of order
+  reply(&conn, 0x50, 2);
+  assert(waitFor(&ptz, 2, 0));
+  assert(conn.writes().size() == 3);
+  assert(rec.has(b, ArPTZ::COMMAND_DONE));
+  reply(&conn, 0x50, 1);
+  reply(&conn, 0x40, 1);
+  reply(&conn, 0x60, 1);
+  assert(ptz.waitForCommands(2000));
+  assert(rec.has(a, ArPTZ::COMMAND_DONE));
+  assert(rec.has(c, ArPTZ::COMMAND_FAILED));
+
+  puts("Unanswered commands time out...");
+  ArTime start;
+  assert(ptz.panTilt(30, 0));
+  const ArPTZ::CommandId d = ptz.getLastCommandId();
+  assert(ptz.waitForCommands(2000));
+  printf("Timed out after %ld ms\n", start.mSecSince());
+  assert(start.mSecSince() >= 290);
+  assert(rec.has(d, ArPTZ::COMMAND_TIMED_OUT));
+
+  puts("Disabling the pipeline cancels what's left...");
+  assert(ptz.panTilt(40, 0));
+  const ArPTZ::CommandId e = ptz.getLastCommandId();
+  assert(ptz.zoom(200));
+  assert(ptz.tilt(10));
+  const ArPTZ::CommandId f = ptz.getLastCommandId();
+  assert(waitFor(&ptz, 2, 1));
+  ptz.disableCommandPipeline();
+  assert(!ptz.isCommandPipelineEnabled());
+  assert(rec.has(e, ArPTZ::COMMAND_CANCELED));
+  assert(rec.has(f, ArPTZ::COMMAND_CANCELED));
+  assert(rec.count(ArPTZ::COMMAND_CANCELED) == 3);
+  // and commands are written directly again
+  const size_t before = conn.writes().size();
+  assert(ptz.panTilt(50, 0));
+  assert(conn.writes().size() == before + 1);
+}
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  ArThreadPool pool("ptzPipelineTest", 2);
+
+  testDirect();
+  testCoalesce(&pool);
+  testBounded(&pool);
+  testResponses(&pool);
+  puts("All tests passed.");
+  return 0;
+}
@@ -0,0 +1,215 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRangeBuffer.h"
+#include "Aria/ArTransform.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Tests the array transforms in ArTransform and the getClosestPolar()
+  and getClosestBox() searches in ArRangeBuffer (which run over arrays
+  of coordinates and don't use trig per point) against the simple way
+  of doing the same thing, one ArPose at a time with angles.
+*/
+
+// What getClosestPolar() used to do
+double refClosestPolar(const std::list<ArPoseWithTime> &buffer,
+		       double startAngle, double endAngle, 
+		       const ArPose &startPos, unsigned int maxRange,
+		       double *angle)
+{
+  double closest = 0;
+  bool foundOne = false;
+  double closeTh = 0;
+  double dist;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it)
+  {
+    const double th = ArMath::subAngle(startPos.findAngleTo(*it), 
+				       startPos.getTh());
+    if (ArMath::angleBetween(th, startAngle, endAngle))
+    {
+      dist = it->findDistanceTo(startPos);
+      if (!foundOne || dist < closest)
+      {
+	closeTh = th;
+	closest = dist;
+	foundOne = true;
+      }
+    }
+  }
+  if (!foundOne)
+    return maxRange;
+  *angle = closeTh;
+  return closest > maxRange ? maxRange : closest;
+}
+
+// What getClosestBox() used to do
+double refClosestBox(const std::list<ArPoseWithTime> &buffer,
+		     double x1, double y1, double x2, double y2,
+		     const ArPose &startPos, unsigned int maxRange, 
+		     ArPose *readingPos, ArPose targetPose)
+{
+  double closest = maxRange;
+  ArPose closestPos;
+  ArTransform trans(startPos, ArPose(0, 0, 0));
+  if (x1 >= x2)
+    std::swap(x1, x2);
+  if (y1 >= y2)
+    std::swap(y1, y2);
+  for (auto it = buffer.begin(); it != buffer.end(); ++it)
+  {
+    const ArPoseWithTime pose = trans.doTransform(*it);
+    if (pose.getX() >= x1 && pose.getX() <= x2 &&
+	pose.getY() >= y1 && pose.getY() <= y2)
+    {
+      double dist = pose.findDistanceTo(targetPose);
+      if (dist < closest)
+      {
+	closest = dist;
+	closestPos = pose;
+      }
+    }
+  }
+  *readingPos = closestPos;
+  return closest > maxRange ? maxRange : closest;
+}
+
+double randomIn(double low, double high)
+{
+  return low + (high - low) * ((double)rand() / (double)RAND_MAX);
+}
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  srand(1234);
+  size_t i;
+  int t;
+
+  puts("Array transforms...");
+  {
+    std::vector<double> xs(1000), ys(1000), outXs(1000), outYs(1000);
+    for (i = 0; i < xs.size(); i++)
+    {
+      xs[i] = randomIn(-10000, 10000);
+      ys[i] = randomIn(-10000, 10000);
+    }
+    ArTransform trans(ArPose(100, -250, 37));
+    trans.doTransform(xs.data(), ys.data(), outXs.data(), outYs.data(), 
+		      xs.size());
+    for (i = 0; i < xs.size(); i++)
+    {
+      ArPose p = trans.doTransform(ArPose(xs[i], ys[i]));
+      assert(p.getX() == outXs[i] && p.getY() == outYs[i]);
+    }
+    // and back, in place
+    trans.doInvTransform(outXs.data(), outYs.data(), outXs.data(), 
+			 outYs.data(), outXs.size());
+    for (i = 0; i < xs.size(); i++)
+    {
+      assert(fabs(outXs[i] - xs[i]) < 1e-6);
+      assert(fabs(outYs[i] - ys[i]) < 1e-6);
+    }
+  }
+  puts("OK");
+
+  ArRangeBuffer buffer(5000);
+  for (i = 0; i < 5000; i++)
+  {
+    ArPoseWithTime p(randomIn(-5000, 5000), randomIn(-5000, 5000), 
+		     randomIn(-180, 180));
+    buffer.addReading(p);
+  }
+  // one right on the robot
+  buffer.addReading(ArPoseWithTime(300, 400, 0));
+
+  puts("getClosestPolar...");
+  const double sectors[][2] = { {-30, 30}, {0, 90}, {90, 0}, {170, -170},
+				{-170, 170}, {45, 44}, {-90, 90}, {90, -90},
+				{10, 10}, {135, -135}, {-1, 1} };
+  for (t = 0; t < 200; t++)
+  {
+    ArPose pos(randomIn(-4000, 4000), randomIn(-4000, 4000), 
+	       randomIn(-180, 180));
+    if (t == 0)
+      pos.setPose(300, 400, 0);
+    for (const double *sector : sectors)
+    {
+      double refAngle = -1000, angle = -1000;
+      unsigned int maxRange = t % 2 == 0 ? 30000 : 500;
+      double ref = refClosestPolar(buffer.getBuffer(), sector[0], sector[1],
+				   pos, maxRange, &refAngle);
+      double got = buffer.getClosestPolar(sector[0], sector[1], pos, 
+					  maxRange, &angle);
+      if (ref != got || refAngle != angle)
+	printf("pos %.1f %.1f %.1f sector %g %g: ref %f at %f, got %f at %f\n",
+	       pos.getX(), pos.getY(), pos.getTh(), sector[0], sector[1],
+	       ref, refAngle, got, angle);
+      assert(ref == got);
+      assert(refAngle == angle);
+    }
+  }
+  puts("OK");
+
+  puts("getClosestBox...");
+  for (t = 0; t < 500; t++)
+  {
+    ArPose pos(randomIn(-4000, 4000), randomIn(-4000, 4000), 
+	       randomIn(-180, 180));
+    double x1 = randomIn(-3000, 3000), x2 = randomIn(-3000, 3000);
+    double y1 = randomIn(-3000, 3000), y2 = randomIn(-3000, 3000);
+    ArPose target = t % 3 == 0 ? ArPose(randomIn(-500, 500), 0) : ArPose();
+    unsigned int maxRange = t % 2 == 0 ? 30000 : 1000;
+    ArPose refPos(1, 2, 3), gotPos(4, 5, 6);
+    double ref = refClosestBox(buffer.getBuffer(), x1, y1, x2, y2, pos, 
+			       maxRange, &refPos, target);
+    double got = buffer.getClosestBox(x1, y1, x2, y2, pos, maxRange, 
+				      &gotPos, target);
+    assert(ref == got);
+    assert(refPos.getX() == gotPos.getX());
+    assert(refPos.getY() == gotPos.getY());
+    assert(fabs(ArMath::subAngle(refPos.getTh(), gotPos.getTh())) < 1e-9);
+  }
+  puts("OK");
+
+  puts("Empty buffer...");
+  {
+    ArRangeBuffer empty(10);
+    double angle = 5;
+    ArPose readingPos(1, 1, 1);
+    assert(empty.getClosestPolar(-90, 90, ArPose(), 4000, &angle) == 4000);
+    assert(angle == 5);
+    assert(empty.getClosestBox(0, -500, 1000, 500, ArPose(), 4000, 
+			       &readingPos) == 4000);
+    assert(readingPos.getX() == 0 && readingPos.getY() == 0);
+  }
+  puts("OK");
+
+  puts("All tests passed.");
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArRobot.h"
+#include "Aria/ArASyncTask.h"
+#include "Aria/ArThread.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <stdio.h>
+
+/*
+  Tests ArRobot::getStateSnapshot(): a reader thread copies snapshots
+  without locking the robot while the main thread keeps publishing new
+  state (through moveTo()), and must never see a torn snapshot or a
+  sequence number going backwards.
+*/
+
+const int numMoves = 20000;
+
+class SnapshotReader : public ArASyncTask
+{
+public:
+  explicit SnapshotReader(ArRobot *robot) : 
+    myRobot(robot), myReads(0), myNewData(0) {}
+  virtual void *runThread(void *) override
+  {
+    unsigned long last = 0;
+    while (getRunning())
+    {
+      ArRobot::StateSnapshot s = myRobot->getStateSnapshot();
+      // every published pose has y == -x and th == x mod 180
+      assert(s.pose.getY() == -s.pose.getX());
+      assert(s.pose.getTh() == ArMath::fixAngle(s.pose.getX()));
+      assert(s.sequence >= last);
+      if (s.sequence > last)
+	myNewData++;
+      last = s.sequence;
+      myReads++;
+    }
+    return NULL;
+  }
+  ArRobot *myRobot;
+  unsigned long myReads;
+  unsigned long myNewData;
+};
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  ArRobot robot;
+
+  unsigned long start = robot.getStateSnapshotSequence();
+  robot.moveTo(ArPose(0, 0, 0));
+  assert(robot.getStateSnapshotSequence() == start + 1);
+  ArRobot::StateSnapshot s = robot.getStateSnapshot();
+  assert(s.sequence == start + 1);
+  assert(s.pose.getX() == 0 && s.pose.getY() == 0);
+
+  robot.moveTo(ArPose(10, -10, 10));
+  s = robot.getStateSnapshot();
+  assert(s.sequence == start + 2);
+  assert(s.pose.getX() == 10 && s.pose.getY() == -10 && s.pose.getTh() == 10);
+  assert(s.vel == robot.getVel() && s.flags == robot.getFlags());
+
+  SnapshotReader reader(&robot);
+  reader.runAsync();
+  for (int i = 0; i < numMoves; ++i)
+  {
+    robot.lock();
+    robot.moveTo(ArPose(i, -i, i));
+    robot.unlock();
+    // let the reader in while moves are still being published
+    if (i % 100 == 0)
+      ArThread::yieldProcessor();
+  }
+  reader.stopRunning();
+  reader.join();
+
+  assert(robot.getStateSnapshotSequence() == start + 2 + numMoves);
+  printf("robotStateSnapshotTest: %lu snapshot reads, %lu saw new data\n",
+	 reader.myReads, reader.myNewData);
+  printf("robotStateSnapshotTest: all tests passed\n");
+  return 0;
+}
@@ -52,7 +52,7 @@ public:
   // destructor, its just empty, we don't need to do anything
   virtual ~ActionGo() {};
   // fire, this is what the resolver calls to figure out what this action wants
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   // sets the robot pointer, also gets the sonar device
   virtual void setRobot(ArRobot *robot);
 protected:
@@ -75,7 +75,7 @@ public:
   // destructor, its just empty, we don't need to do anything
   virtual ~ActionTurn() {};
   // fire, this is what the resolver calls to figure out what this action wants
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   // sets the robot pointer, also gets the sonar device
   virtual void setRobot(ArRobot *robot);
 protected:
@@ -124,7 +124,7 @@ void ActionGo::setRobot(ArRobot *robot)
 /*
   This fire is the whole point of the action.
 */
-ArActionDesired *ActionGo::fire(ArActionDesired currentDesired)
+ArActionDesired *ActionGo::fire(const ArActionDesired &currentDesired)
 {
   double range;
   double speed;
@@ -193,7 +193,7 @@ void ActionTurn::setRobot(ArRobot *robot)
 /*
   This is the guts of the action.
 */
-ArActionDesired *ActionTurn::fire(ArActionDesired currentDesired)
+ArActionDesired *ActionTurn::fire(const ArActionDesired &currentDesired)
 {
   double leftRange, rightRange;
 
@@ -28,7 +28,7 @@ class ActionTest : public ArAction
 public:
   ActionTest(double turnAmount, double speed);
   virtual ~ActionTest() {}
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   
 protected:
   ArActionDesired myActionDesired;
@@ -43,7 +43,7 @@ ActionTest::ActionTest(double turnAmount, double speed) :
   mySpeed = speed;
 }
 
-ArActionDesired *ActionTest::fire(ArActionDesired currentDesired)
+ArActionDesired *ActionTest::fire(const ArActionDesired &currentDesired)
 {
   myActionDesired.reset();
   if (fabs(mySpeed) > 1)
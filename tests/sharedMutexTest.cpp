@@ -0,0 +1,239 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArSharedMutex.h"
+#include "Aria/ArMutex.h"
+#include "Aria/ArRobot.h"
+#include "Aria/ArSonarDevice.h"
+#include "Aria/ArThread.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+
+/*
+  Tests ArSharedMutex: that readers share it and writers don't, that a
+  waiting writer goes ahead of new readers, the recursive cases (which
+  must not deadlock), and the shared locks on ArRangeDevice and ArRobot.
+*/
+
+// holds a shared lock from another thread until told to let go
+class Reader
+{
+public:
+  Reader(ArSharedMutex &mutex) : myMutex(mutex) {}
+  void start()
+    {
+      myThread = std::thread([this]() {
+	  myMutex.lockShared();
+	  myLocked = true;
+	  while (!myRelease)
+	    ArUtil::sleep(1);
+	  myMutex.unlockShared();
+	});
+      while (!myLocked)
+	ArUtil::sleep(1);
+    }
+  void release() { myRelease = true; myThread.join(); }
+  ArSharedMutex &myMutex;
+  std::thread myThread;
+  std::atomic<bool> myLocked{false};
+  std::atomic<bool> myRelease{false};
+};
+
+// waits up to ms for a thread to say it's done, and joins it if it is
+static bool finishesWithin(std::thread &thread, std::atomic<bool> &done, 
+			   int ms)
+{
+  for (int i = 0; i < ms && !done; i++)
+    ArUtil::sleep(1);
+  if (done)
+    thread.join();
+  return done;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdErr, ArLog::Normal);
+  ArThread::init();
+
+  ArSharedMutex mutex;
+  mutex.setLogName("sharedMutexTest::mutex");
+
+  puts("Readers share, writers don't...");
+  {
+    Reader reader(mutex);
+    reader.start();
+    // a second reader gets it while the first has it
+    assert(mutex.lockShared() == 0);
+    assert(mutex.getSharedCount() == 2);
+    // a writer can't get it
+    std::atomic<int> tried{-1};
+    std::thread writer([&]() { tried = mutex.tryLock(); });
+    writer.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    assert(mutex.unlockShared() == 0);
+    reader.release();
+    assert(mutex.getSharedCount() == 0);
+
+    // and readers can't get it while a writer has it
+    assert(mutex.lock() == 0);
+    assert(mutex.isLockedExclusive());
+    std::thread reader2([&]() { tried = mutex.tryLockShared(); });
+    reader2.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    std::thread writer2([&]() { tried = mutex.tryLock(); });
+    writer2.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    assert(mutex.unlock() == 0);
+    assert(!mutex.isLockedExclusive());
+  }
+
+  puts("A waiting writer goes before new readers...");
+  {
+    Reader reader(mutex);
+    reader.start();
+    std::atomic<bool> writerDone{false};
+    std::atomic<bool> writerLocked{false};
+    std::thread writer([&]() {
+	mutex.lock();
+	writerLocked = true;
+	ArUtil::sleep(50);
+	writerDone = true;
+	mutex.unlock();
+      });
+    ArUtil::sleep(50);
+    assert(!writerLocked);
+    // the writer is waiting for the first reader, so new readers wait
+    // for the writer
+    std::atomic<int> tried{-1};
+    std::thread tryReader([&]() { tried = mutex.tryLockShared(); });
+    tryReader.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    std::atomic<bool> readerSawWriter{false};
+    std::atomic<bool> readerDone{false};
+    std::thread lateReader([&]() {
+	mutex.lockShared();
+	readerSawWriter = (bool)writerDone;
+	mutex.unlockShared();
+	readerDone = true;
+      });
+    ArUtil::sleep(20);
+    assert(!readerDone);
+    reader.release();
+    writer.join();
+    assert(finishesWithin(lateReader, readerDone, 1000));
+    assert(readerSawWriter);
+  }
+
+  puts("Recursive locks...");
+  {
+    // exclusive, exclusive again, and shared inside exclusive
+    assert(mutex.lock() == 0);
+    assert(mutex.lock() == 0);
+    assert(mutex.lockShared() == 0);
+    assert(mutex.tryLockShared() == 0);
+    assert(mutex.tryLock() == 0);
+    assert(mutex.getSharedCount() == 0);
+    assert(mutex.unlock() == 0);
+    assert(mutex.unlockShared() == 0);
+    assert(mutex.unlockShared() == 0);
+    assert(mutex.unlock() == 0);
+    assert(mutex.isLockedExclusive());
+    assert(mutex.unlock() == 0);
+    assert(!mutex.isLockedExclusive());
+    // unlocking what we don't hold fails
+    assert(mutex.unlock() == ArMutex::STATUS_FAILED);
+    assert(mutex.unlockShared() == ArMutex::STATUS_FAILED);
+
+    // a reader can lock shared again even with a writer waiting
+    assert(mutex.lockShared() == 0);
+    std::atomic<bool> writerDone{false};
+    std::thread writer([&]() {
+	mutex.lock();
+	mutex.unlock();
+	writerDone = true;
+      });
+    ArUtil::sleep(50);
+    assert(!writerDone);
+    assert(mutex.lockShared() == 0);
+    assert(mutex.tryLockShared() == 0);
+    assert(mutex.getSharedCount() == 3);
+    // but can't upgrade to exclusive
+    assert(mutex.lock() == ArMutex::STATUS_FAILED);
+    assert(mutex.tryLock() == ArMutex::STATUS_FAILED);
+    assert(mutex.unlockShared() == 0);
+    assert(mutex.unlockShared() == 0);
+    ArUtil::sleep(20);
+    assert(!writerDone);
+    assert(mutex.unlockShared() == 0);
+    assert(finishesWithin(writer, writerDone, 1000));
+    assert(mutex.getSharedCount() == 0);
+  }
+
+  puts("Range devices and the robot...");
+  {
+    ArRobot robot;
+    ArSonarDevice sonar;
+    robot.addRangeDevice(&sonar);
+    // readers of a device share it, and the device's writer waits
+    assert(sonar.lockDeviceShared() == 0);
+    std::atomic<int> tried{-1};
+    std::thread reader([&]() {
+	tried = sonar.tryLockDeviceShared();
+	if (tried == 0)
+	  sonar.unlockDeviceShared();
+      });
+    reader.join();
+    assert(tried == 0);
+    std::thread writer([&]() { tried = sonar.tryLockDevice(); });
+    writer.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    // checking the devices from the robot shares them too
+    robot.checkRangeDevicesCurrentPolar(-90, 90);
+    assert(sonar.unlockDeviceShared() == 0);
+    assert(sonar.tryLockDevice() == 0);
+    assert(sonar.unlockDevice() == 0);
+
+    assert(robot.lockShared() == 0);
+    std::thread robotReader([&]() {
+	tried = robot.tryLockShared();
+	if (tried == 0)
+	  robot.unlockShared();
+      });
+    robotReader.join();
+    assert(tried == 0);
+    std::thread robotWriter([&]() { tried = robot.tryLock(); });
+    robotWriter.join();
+    assert(tried == ArMutex::STATUS_ALREADY_LOCKED);
+    assert(robot.unlockShared() == 0);
+    assert(robot.lock() == 0);
+    assert(robot.unlock() == 0);
+    robot.remRangeDevice(&sonar);
+  }
+
+  puts("All sharedMutexTest tests passed");
+  return 0;
+}
@@ -0,0 +1,141 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArSonarDevice.h"
+#include "Aria/ArRobot.h"
+#include "Aria/ariaUtil.h"
+#include "Aria/ArLog.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/*
+  Tests adding batches of sonar readings with ArSonarDevice::addReadings()
+  (what processReadings() does each cycle) against adding them one at a
+  time with addReading(), and ignore regions.  No robot connection is
+  needed, the robot just sits at 0,0.
+*/
+
+double randomIn(double low, double high)
+{
+  return low + (high - low) * ((double)rand() / (double)RAND_MAX);
+}
+
+bool sameReadings(const ArRangeBuffer &a, const ArRangeBuffer &b)
+{
+  if (a.getBuffer().size() != b.getBuffer().size())
+    return false;
+  auto bit = b.getBegin();
+  for (auto ait = a.getBegin(); ait != a.getEnd(); ++ait, ++bit)
+    if (ait->getX() != bit->getX() || ait->getY() != bit->getY())
+      return false;
+  return true;
+}
+
+int main(int, char **)
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  srand(99);
+  ArRobot robot;
+  int cycle;
+  size_t i;
+
+  // nothing has come in
+  assert(robot.getNewSonarReadings().empty());
+
+  puts("Batches against one at a time...");
+  {
+    // big enough that nothing falls off the end
+    ArSonarDevice batched(10000, 10000);
+    ArSonarDevice single(10000, 10000);
+    batched.setRobot(&robot);
+    single.setRobot(&robot);
+    std::vector<double> xs, ys;
+    for (cycle = 0; cycle < 300; cycle++)
+    {
+      xs.clear();
+      ys.clear();
+      size_t num = (size_t)(rand() % 32);
+      for (i = 0; i < num; i++)
+      {
+	// some of them close to each other, some out of range
+	if (i > 0 && rand() % 4 == 0)
+	{
+	  xs.push_back(xs[i - 1] + randomIn(-60, 60));
+	  ys.push_back(ys[i - 1] + randomIn(-60, 60));
+	}
+	else
+	{
+	  xs.push_back(randomIn(-6000, 6000));
+	  ys.push_back(randomIn(-6000, 6000));
+	}
+      }
+      batched.lockDevice();
+      batched.addReadings(xs.data(), ys.data(), xs.size());
+      batched.unlockDevice();
+      single.lockDevice();
+      for (i = 0; i < xs.size(); i++)
+	single.addReading(xs[i], ys[i]);
+      single.unlockDevice();
+      assert(sameReadings(batched.getCurrentRangeBuffer(), 
+			  single.getCurrentRangeBuffer()));
+      assert(sameReadings(batched.getCumulativeRangeBuffer(), 
+			  single.getCumulativeRangeBuffer()));
+    }
+    printf("%lu current and %lu cumulative readings\n", 
+	   (unsigned long)batched.getCurrentRangeBuffer().getBuffer().size(),
+	   (unsigned long)batched.getCumulativeRangeBuffer().getBuffer().size());
+    assert(batched.getCumulativeRangeBuffer().getBuffer().size() > 100);
+  }
+  puts("OK");
+
+  puts("Ignore regions...");
+  {
+    ArSonarDevice sonar(100, 100);
+    sonar.setRobot(&robot);
+    sonar.addIgnoreRegion(1000, 1000, 0, 0);
+    sonar.addIgnoreRegion(-500, -500, -200, -200);
+    assert(sonar.getNumIgnoreRegions() == 2);
+    const double xs[] = { 500, 1500, -300, -300, 999, 1000 };
+    const double ys[] = { 500, 500, -300, 300, 1, 1000 };
+    sonar.lockDevice();
+    sonar.addReadings(xs, ys, 6);
+    sonar.unlockDevice();
+    const std::list<ArPoseWithTime> &current = 
+      sonar.getCurrentRangeBuffer().getBuffer();
+    assert(current.size() == 2);
+    // newest first
+    assert(current.front().getX() == -300 && current.front().getY() == 300);
+    assert(current.back().getX() == 1500);
+    sonar.clearIgnoreRegions();
+    sonar.lockDevice();
+    sonar.addReadings(xs, ys, 1);
+    sonar.unlockDevice();
+    assert(current.size() == 3);
+  }
+  puts("OK");
+
+  puts("All tests passed.");
+  return 0;
+}
@@ -51,7 +51,7 @@ class JoydriveAction : public ArAction
 public:
   JoydriveAction();
   virtual ~JoydriveAction() {};
-  virtual ArActionDesired *fire(ArActionDesired currentDesired);
+  virtual ArActionDesired *fire(const ArActionDesired &currentDesired);
   bool joystickInited();
 protected:
   ArActionDesired myDesired;
@@ -70,7 +70,7 @@ bool JoydriveAction::joystickInited()
   return myJoyHandler.haveJoystick();
 }
 
-ArActionDesired *JoydriveAction::fire(ArActionDesired currentDesired)
+ArActionDesired *JoydriveAction::fire(const ArActionDesired &currentDesired)
 {
   int rot, trans;
 
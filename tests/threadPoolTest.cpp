@@ -0,0 +1,317 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+#include "Aria/ArThreadPool.h"
+#include "Aria/ArRecurrentTask.h"
+#include "Aria/ArFunctorASyncTask.h"
+#include "Aria/ArSystemStatus.h"
+#include "Aria/ArThread.h"
+#include "Aria/ArLog.h"
+#include "Aria/ariaUtil.h"
+#include <assert.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+  Tests ArThreadPool: that submitted tasks run in order, that delayed
+  and periodic tasks run when they're due, cancel(), and the pooled
+  modes of ArRecurrentTask and ArFunctorASyncTask.
+*/
+
+// waits up to ms for a flag (or count) to be reached
+template <class Pred>
+bool waitFor(Pred pred, int ms)
+{
+  ArTime start;
+  while (!pred())
+  {
+    if (start.mSecSince() > ms)
+      return false;
+    ArUtil::sleep(1);
+  }
+  return true;
+}
+
+// how many threads this process has
+size_t numThreads()
+{
+  size_t n = 0;
+  DIR *dir = opendir("/proc/self/task");
+  assert(dir != NULL);
+  while (struct dirent *ent = readdir(dir))
+    if (ent->d_name[0] != '.')
+      n++;
+  closedir(dir);
+  return n;
+}
+
+// how many threads this process has once threads that are exiting (such
+// as a pool that was just destroyed) are gone from /proc
+size_t settledNumThreads()
+{
+  size_t n = numThreads();
+  ArTime same;
+  ArTime start;
+  while (same.mSecSince() < 20 && start.mSecSince() < 2000)
+  {
+    ArUtil::sleep(1);
+    size_t now = numThreads();
+    if (now != n)
+    {
+      n = now;
+      same.setToNow();
+    }
+  }
+  return n;
+}
+
+std::mutex orderMutex;
+std::vector<int> order;
+
+void record(int i)
+{
+  std::lock_guard<std::mutex> lock(orderMutex);
+  order.push_back(i);
+}
+
+std::atomic<int> ticks{0};
+void tick() { ticks++; }
+
+std::atomic<bool> slowStarted{false};
+std::atomic<bool> slowRelease{false};
+std::atomic<bool> slowFinished{false};
+void slow()
+{
+  slowStarted = true;
+  while (!slowRelease)
+    ArUtil::sleep(1);
+  slowFinished = true;
+}
+
+class CountingTask : public ArRecurrentTask
+{
+public:
+  CountingTask(ArThreadPool *pool) : ArRecurrentTask(pool) {}
+  virtual void task() override
+    {
+      ArUtil::sleep(20);
+      myRuns++;
+    }
+  std::atomic<int> myRuns{0};
+};
+
+ArFunctorASyncTask *pooledTask = NULL;
+std::atomic<bool> pooledLooping{false};
+void *pooledLoop(void *)
+{
+  pooledLooping = true;
+  while (pooledTask->getRunning())
+    ArUtil::sleep(1);
+  return NULL;
+}
+
+int main()
+{
+  ArLog::init(ArLog::StdOut, ArLog::Normal);
+  size_t threadsBefore;
+
+  puts("Pool size...");
+  {
+    ArThreadPool pool("testPool", 3);
+    assert(pool.getNumThreads() == 3);
+    assert(pool.isRunning());
+    // one pool worker per thread, no matter how many tasks
+    std::vector<ArGlobalFunctor *> functors;
+    threadsBefore = settledNumThreads();
+    for (int i = 0; i < 100; i++)
+    {
+      functors.push_back(new ArGlobalFunctor(&tick));
+      assert(pool.submit(functors.back()) != 0);
+    }
+    assert(waitFor([]() { return ticks == 100; }, 2000));
+    assert(numThreads() == threadsBefore);
+    assert(pool.getNumRun() == 100);
+    assert(waitFor([&]() { return pool.getNumPending() == 0; }, 1000));
+    for (size_t i = 0; i < functors.size(); i++)
+      delete functors[i];
+  }
+
+  puts("Ordering and delays...");
+  {
+    // one worker, so everything runs in the order it's due
+    ArThreadPool pool("orderPool", 1);
+    ArGlobalFunctor1<int> r1(&record, 1), r2(&record, 2), r3(&record, 3),
+      r4(&record, 4);
+    order.clear();
+    pool.schedule(&r4, 80);
+    pool.schedule(&r3, 40);
+    pool.submit(&r1);
+    pool.submit(&r2);
+    assert(waitFor([]() { 
+	  std::lock_guard<std::mutex> lock(orderMutex);
+	  return order.size() == 4; }, 2000));
+    assert(order[0] == 1 && order[1] == 2 && order[2] == 3 && order[3] == 4);
+
+    // a delayed task doesn't run early
+    ArTime start;
+    order.clear();
+    ArGlobalFunctor1<int> r5(&record, 5);
+    pool.schedule(&r5, 100);
+    ArUtil::sleep(50);
+    {
+      std::lock_guard<std::mutex> lock(orderMutex);
+      assert(order.empty());
+    }
+    assert(waitFor([]() { 
+	  std::lock_guard<std::mutex> lock(orderMutex);
+	  return order.size() == 1; }, 2000));
+    assert(start.mSecSince() >= 100);
+  }
+
+  puts("Periodic tasks and cancel...");
+  {
+    ArThreadPool pool("periodicPool", 2);
+    ArGlobalFunctor tickCB(&tick);
+    ticks = 0;
+    ArThreadPool::TaskId id = pool.schedulePeriodic(&tickCB, 10);
+    assert(id != 0);
+    assert(waitFor([]() { return ticks >= 5; }, 2000));
+    assert(pool.isPending(id));
+    assert(pool.cancel(id));
+    assert(!pool.isPending(id));
+    int after = ticks;
+    ArUtil::sleep(50);
+    assert(ticks == after);
+    // already canceled, and ids that don't exist
+    assert(!pool.cancel(id));
+    assert(!pool.cancel(12345));
+    assert(pool.schedulePeriodic(&tickCB, 0) == 0);
+
+    // canceling something that hasn't run yet means it never runs
+    ticks = 0;
+    id = pool.schedule(&tickCB, 50);
+    assert(pool.cancel(id));
+    ArUtil::sleep(100);
+    assert(ticks == 0);
+
+    // canceling something running waits for it to finish
+    ArGlobalFunctor slowCB(&slow);
+    id = pool.submit(&slowCB);
+    assert(waitFor([]() { return slowStarted.load(); }, 2000));
+    std::thread releaser([]() { ArUtil::sleep(50); slowRelease = true; });
+    assert(pool.cancel(id, true));
+    assert(slowFinished);
+    releaser.join();
+  }
+
+  puts("Stopping...");
+  {
+    ArThreadPool pool("stopPool", 2);
+    ArGlobalFunctor tickCB(&tick);
+    ticks = 0;
+    pool.schedule(&tickCB, 100);
+    pool.stop();
+    assert(!pool.isRunning());
+    assert(pool.getNumPending() == 0);
+    assert(pool.submit(&tickCB) == 0);
+    ArUtil::sleep(150);
+    assert(ticks == 0);
+  }
+
+  puts("ArRecurrentTask in a pool...");
+  {
+    ArThreadPool pool("recurrentPool", 2);
+    threadsBefore = settledNumThreads();
+    CountingTask task(&pool);
+    // no thread of its own
+    assert(numThreads() == threadsBefore);
+    assert(task.done() == 1);
+    task.go();
+    assert(task.done() == 0);
+    assert(waitFor([&]() { return task.done() == 1; }, 2000));
+    assert(task.myRuns == 1);
+    // going again while it runs runs it once more afterwards
+    task.go();
+    task.go();
+    task.go();
+    assert(waitFor([&]() { return task.done() == 1; }, 2000));
+    assert(task.myRuns == 3);
+    // reset while running marks it killed
+    task.go();
+    task.reset();
+    assert(task.done() == 2);
+    assert(waitFor([&]() { return task.myRuns == 4; }, 2000));
+    task.go();
+    assert(waitFor([&]() { return task.done() == 1; }, 2000));
+    assert(task.myRuns == 5);
+  }
+
+  puts("ArFunctorASyncTask in a pool...");
+  {
+    ArThreadPool pool("functorPool", 2);
+    ArGlobalRetFunctor1<void *, void *> loopCB(&pooledLoop);
+    ArFunctorASyncTask task(&loopCB);
+    pooledTask = &task;
+    threadsBefore = settledNumThreads();
+    assert(task.runInPool(&pool));
+    assert(waitFor([]() { return pooledLooping.load(); }, 2000));
+    assert(task.getRunning());
+    assert(numThreads() == threadsBefore);
+    // can't run it twice at once
+    assert(!task.runInPool(&pool));
+    task.stopRunning();
+    assert(waitFor([&]() { return pool.getNumPending() == 0; }, 2000));
+
+    // stopping the pool stops it too
+    pooledLooping = false;
+    assert(task.runInPool(&pool));
+    assert(waitFor([]() { return pooledLooping.load(); }, 2000));
+    pool.stop();
+    assert(waitFor([&]() { return !task.getRunning(); }, 2000));
+  }
+
+  puts("ArSystemStatus periodic update on the shared pool...");
+  {
+    threadsBefore = settledNumThreads();
+    ArThreadPool *shared = ArThreadPool::getShared();
+    assert(shared == ArThreadPool::getShared());
+    // a couple of threads, not one per processor
+    assert(shared->getNumThreads() == 2);
+    assert(settledNumThreads() <= threadsBefore + 2);
+    size_t pending = shared->getNumPending();
+    ArSystemStatus::startPeriodicUpdate(20);
+    assert(shared->getNumPending() == pending + 1);
+    ArSystemStatus::startPeriodicUpdate(50);
+    assert(shared->getNumPending() == pending + 1);
+    ArSystemStatus::getCPU();
+    ArSystemStatus::stopPeriodicUpdate();
+    assert(shared->getNumPending() == pending);
+  }
+
+  puts("All tests passed.");
+  return 0;
+}
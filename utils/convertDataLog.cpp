@@ -0,0 +1,89 @@
+/*
+Adept MobileRobots Robotics Interface for Applications (ARIA)
+Copyright (C) 2004-2005 ActivMedia Robotics LLC
+Copyright (C) 2006-2010 MobileRobots Inc.
+Copyright (C) 2011-2015 Adept Technology, Inc.
+Copyright (C) 2016-2018 Omron Adept Technologies, Inc.
+
+     This program is free software; you can redistribute it and/or modify
+     it under the terms of the GNU General Public License as published by
+     the Free Software Foundation; either version 2 of the License, or
+     (at your option) any later version.
+
+     This program is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with this program; if not, write to the Free Software
+     Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+*/
+
+#include "Aria/Aria.h"
+
+/* This program converts a data log written by ArDataLogger with the 
+   DataLogFormat parameter set to Binary into CSV (or TSV) text.
+
+   Usage:
+      ./convertDataLog [-h|--help] [-tsv] [logfile] [outputfile]
+   [logfile] and [outputfile] are optional. If omitted, then stdin and stdout
+   are used instead.
+*/
+
+int main(int argc, char **argv)
+{
+  Aria::init();
+  ArLog::init(ArLog::StdErr, ArLog::Normal, "", false, false, false);
+
+  char sep = ',';
+  int arg = 1;
+  if (arg < argc && (!strcmp(argv[arg], "-h") || !strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-help")))
+  {
+    ArLog::log(ArLog::Normal, "Usage:\n\t%s [-tsv] [logfile] [outputfile]", argv[0]);
+    ArLog::log(ArLog::Normal, "Converts a binary ArDataLogger log to CSV, or TSV with -tsv. [logfile] and [outputfile] are optional. If omitted, then stdin and stdout are used instead.");
+    Aria::exit(1);
+  }
+  if (arg < argc && !strcmp(argv[arg], "-tsv"))
+  {
+    sep = '\t';
+    ++arg;
+  }
+  if (argc - arg > 2)
+  {
+    ArLog::log(ArLog::Normal, "Usage:\n\t%s [-tsv] [logfile] [outputfile]", argv[0]);
+    Aria::exit(1);
+  }
+
+  FILE *in = stdin;
+  FILE *out = stdout;
+  if (arg < argc)
+  {
+    in = ArUtil::fopen(argv[arg], "rb");
+    if (in == NULL)
+    {
+      ArLog::logErrorFromOS(ArLog::Terse, "Could not open %s", argv[arg]);
+      Aria::exit(2);
+    }
+    ++arg;
+  }
+  if (arg < argc)
+  {
+    out = ArUtil::fopen(argv[arg], "w");
+    if (out == NULL)
+    {
+      ArLog::logErrorFromOS(ArLog::Terse, "Could not open %s", argv[arg]);
+      Aria::exit(2);
+    }
+  }
+
+  bool ok = ArDataLogger::convertBinaryLog(in, out, sep);
+  if (in != stdin)
+    fclose(in);
+  if (out != stdout)
+    fclose(out);
+  Aria::exit(ok ? 0 : 3);
+  return 0;
+}